@@ -0,0 +1,430 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file athena_bench.cpp
+//! \brief Standalone performance benchmark for the main physics kernels.
+//!
+//! Runs fixed-size Hydro, MHD, GR-MHD, radiation and Z4c problems in-process, sweeping
+//! every compiled reconstruction x Riemann solver combination of each module.  For each
+//! configuration the individual kernels (fluxes, update, C2P, ...) are timed by calling
+//! the corresponding task functions directly, and a complete cycle is timed by executing
+//! the task lists exactly as Driver::Execute() does.  Results are written as a
+//! whitespace-separated table (one row per kernel) with the zone-cycles per second,
+//! the time per call, and an estimate of the achieved memory bandwidth.
+//!
+//! The bandwidth estimate counts only the compulsory traffic of each kernel, i.e. the
+//! number of cell-centered arrays (including ghost zones) read or written once, so it is
+//! a lower bound on the true traffic.  Only built-in problem generators are used, so the
+//! executable is only available when compiled with PROBLEM=built_in_pgens.
+//!
+//! Usage: athena_bench [-n nx] [-b nmb] [-r nrep] [-y ncycle] [-l nlevel]
+//!                     [-m module[,module...]] [-o file]
+
+// C/C++ headers
+#include <cstdio>    // sscanf
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Athena headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "utils/utils.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "driver/driver.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "radiation/radiation.hpp"
+#include "z4c/z4c.hpp"
+#include "pgen/pgen.hpp"
+
+// MPI headers
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \struct BenchOptions
+//! \brief parameters controlling the size and duration of each benchmark
+
+struct BenchOptions {
+  int nx = 32;          // number of active cells per MeshBlock in each direction
+  int nmb = 8;          // number of MeshBlocks in the (single) MeshBlockPack
+  int nrep = 10;        // number of repetitions of each kernel
+  int ncycle = 5;       // number of full cycles to time
+  int nlevel = 1;       // level of geodesic grid used for radiation
+  int nghost = 4;       // ghost zones (4 supports all reconstruction methods + FOFC)
+  std::vector<std::string> modules = {"hydro", "mhd", "grmhd", "radiation", "z4c"};
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct BenchKernel
+//! \brief a single timed kernel: task function wrapped in lambda, and the number of
+//! cell-centered arrays (with ghost zones) it must read or write at least once.
+
+struct BenchKernel {
+  std::string name;
+  std::function<void()> func;
+  int narrays;
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct BenchCase
+//! \brief one module/reconstruction/Riemann-solver combination
+
+struct BenchCase {
+  std::string module, recon, rsolver;
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string MeshInput()
+//! \brief returns <mesh>, <meshblock>, <time> blocks of input file common to all cases.
+//! MeshBlocks are stacked along x1 so that all of them fit in one MeshBlockPack.
+
+std::string MeshInput(const BenchOptions &opt, Real xmin, Real xmax,
+                      const std::string &bc, const std::string &integrator) {
+  std::ostringstream s;
+  Real x1max = xmin + opt.nmb*(xmax - xmin);
+  s << "<job>\nbasename = bench\n"
+    << "<mesh>\nnghost = " << opt.nghost << "\n"
+    << "nx1 = " << opt.nx*opt.nmb << "\nx1min = " << xmin << "\nx1max = " << x1max
+    << "\nix1_bc = " << bc << "\nox1_bc = " << bc << "\n"
+    << "nx2 = " << opt.nx << "\nx2min = " << xmin << "\nx2max = " << xmax
+    << "\nix2_bc = " << bc << "\nox2_bc = " << bc << "\n"
+    << "nx3 = " << opt.nx << "\nx3min = " << xmin << "\nx3max = " << xmax
+    << "\nix3_bc = " << bc << "\nox3_bc = " << bc << "\n"
+    << "<meshblock>\nnx1 = " << opt.nx << "\nnx2 = " << opt.nx << "\nnx3 = " << opt.nx
+    << "\n<time>\nevolution = dynamic\nintegrator = " << integrator
+    << "\ncfl_number = 0.3\nnlim = -1\ntlim = 1.0\nndiag = 1\n";
+  return s.str();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string CaseInput()
+//! \brief returns complete input file for one benchmark case, based on the input files
+//! used by the regression tests in inputs/tests/
+
+std::string CaseInput(const BenchCase &bc, const BenchOptions &opt) {
+  std::ostringstream s;
+  if (bc.module == "hydro" || bc.module == "mhd") {
+    s << MeshInput(opt, 0.0, 1.0, "periodic", "rk2")
+      << "<" << bc.module << ">\neos = ideal\nreconstruct = " << bc.recon
+      << "\nrsolver = " << bc.rsolver << "\ngamma = 1.66666666667\n"
+      << "<problem>\npgen_name = linear_wave\nwave_flag = 0\namp = 1.0e-6\n"
+      << "along_x1 = true\n";
+  } else if (bc.module == "grmhd") {
+    s << MeshInput(opt, -10.0, 10.0, "user", "rk2")
+      << "<coord>\ngeneral_rel = true\na = 0.5\nexcise = true\n"
+      << "dexcise = 1.0e-4\npexcise = 0.333e-6\n"
+      << "<mhd>\neos = ideal\nreconstruct = " << bc.recon << "\nrsolver = "
+      << bc.rsolver << "\ngamma = 1.3333333333333\ndfloor = 1.0e-6\n"
+      << "pfloor = 0.333e-8\nfofc = true\ngamma_max = 10.0\n"
+      << "<problem>\npgen_name = gr_monopole\n";
+  } else if (bc.module == "radiation") {
+    s << MeshInput(opt, 0.0, 1.0, "periodic", "rk2")
+      << "<coord>\ngeneral_rel = true\nminkowski = true\n"
+      << "<hydro>\neos = ideal\nreconstruct = " << bc.recon << "\nrsolver = "
+      << bc.rsolver << "\ngamma = 1.6666666666666667\n"
+      << "<radiation>\nnlevel = " << opt.nlevel << "\nrotate_geo = false\n"
+      << "angular_fluxes = false\nreconstruct = " << bc.recon << "\nkappa_a = 10.0\n"
+      << "kappa_s = 10.0\nkappa_p = 0.0\narad = 19.253382731290966\n"
+      << "<problem>\npgen_name = rad_linear_wave\nalong_x1 = true\nrho = 1.0\n"
+      << "pgas = 2.497687326549491e-01\nerad = 7.493061979648474e-02\n"
+      << "delta = 1.0e-6\nomega_real = 3.1488157526582414e+00\n"
+      << "omega_imag = -2.6190006385782953e-02\n"
+      << "drho_real = 8.3877889167048014e-01\ndrho_imag = 0.0\n"
+      << "dpgas_real = 3.2084488925731219e-01\ndpgas_imag = -9.9134535607493107e-03\n"
+      << "dux_real = 4.2035369927276667e-01\ndux_imag = -3.4962560317943620e-03\n"
+      << "derad_real = 1.2904189937790903e-01\nderad_imag = 1.5203926879094193e-03\n"
+      << "dfxrad_real = 1.3260665610966586e-03\ndfxrad_imag = -6.7017329068802516e-03\n";
+  } else if (bc.module == "z4c") {
+    s << MeshInput(opt, 0.0, 1.0, "periodic", "rk4")
+      << "<z4c>\ndiss = 1\n"
+      << "<problem>\npgen_name = z4c_linear_wave\namp = 1.0e-8\n"
+      << "kx1 = 1\nkx2 = 1\nkx3 = 1\n";
+  }
+  return s.str();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<BenchCase> BuildCases()
+//! \brief returns list of all reconstruction x Riemann solver combinations for each
+//! requested module.  Lists must be kept consistent with the options parsed in the
+//! constructors of each physics module.
+
+std::vector<BenchCase> BuildCases(const BenchOptions &opt) {
+  const std::vector<std::string> recon = {"dc", "plm", "ppm4", "ppmx", "wenoz"};
+  std::vector<BenchCase> cases;
+  for (auto &mod : opt.modules) {
+    std::vector<std::string> rsolvers;
+    if (mod == "hydro") {
+      rsolvers = {"llf", "hlle", "hllc", "roe"};
+    } else if (mod == "mhd") {
+      rsolvers = {"llf", "hlle", "hlld"};
+    } else if (mod == "grmhd" || mod == "radiation") {
+      rsolvers = {"llf", "hlle"};
+    } else if (mod == "z4c") {
+      // Z4c uses finite differences, so only one configuration
+      cases.push_back({mod, "-", "-"});
+      continue;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "benchmark module '" << mod << "' not implemented. "
+                << "Valid choices are [hydro,mhd,grmhd,radiation,z4c]" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    for (auto &rv : recon) {
+      for (auto &fv : rsolvers) {
+        cases.push_back({mod, rv, fv});
+      }
+    }
+  }
+  return cases;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<BenchKernel> BuildKernels()
+//! \brief returns list of kernels to be timed for given case.  Each RK register is first
+//! copied so that repeated calls to the update kernels at stage=1 are idempotent.
+
+std::vector<BenchKernel> BuildKernels(const BenchCase &bc, MeshBlockPack *pmbp,
+                                      Driver *pdrive) {
+  std::vector<BenchKernel> kernels;
+  if (bc.module == "hydro") {
+    hydro::Hydro *phyd = pmbp->phydro;
+    int nv = phyd->nhydro + phyd->nscalars;
+    (void) phyd->CopyCons(pdrive, 1);
+    kernels.push_back({"fluxes", [=]() {(void) phyd->Fluxes(pdrive, 1);}, 4*nv});
+    kernels.push_back({"update", [=]() {(void) phyd->RKUpdate(pdrive, 1);}, 5*nv});
+    kernels.push_back({"c2p", [=]() {(void) phyd->ConToPrim(pdrive, 1);}, 2*nv});
+  } else if (bc.module == "mhd" || bc.module == "grmhd") {
+    mhd::MHD *pmhd = pmbp->pmhd;
+    int nv = pmhd->nmhd + pmhd->nscalars;
+    (void) pmhd->CopyCons(pdrive, 1);
+    kernels.push_back({"fluxes", [=]() {(void) pmhd->Fluxes(pdrive, 1);}, 4*nv + 9});
+    kernels.push_back({"update", [=]() {(void) pmhd->RKUpdate(pdrive, 1);}, 5*nv});
+    kernels.push_back({"corner_e", [=]() {(void) pmhd->CornerE(pdrive, 1);}, nv + 12});
+    kernels.push_back({"ct", [=]() {(void) pmhd->CT(pdrive, 1);}, 9});
+    kernels.push_back({"c2p", [=]() {(void) pmhd->ConToPrim(pdrive, 1);}, 2*nv + 6});
+  } else if (bc.module == "radiation") {
+    radiation::Radiation *prad = pmbp->prad;
+    hydro::Hydro *phyd = pmbp->phydro;
+    int na = prad->nfrang;
+    int nv = phyd->nhydro + phyd->nscalars;
+    (void) prad->CopyCons(pdrive, 1);
+    (void) phyd->CopyCons(pdrive, 1);
+    kernels.push_back({"rad_fluxes", [=]() {(void) prad->CalculateFluxes(pdrive, 1);},
+                       4*na});
+    kernels.push_back({"rad_update", [=]() {(void) prad->RKUpdate(pdrive, 1);}, 5*na});
+    kernels.push_back({"rad_source",
+                       [=]() {(void) prad->AddRadiationSourceTerm(pdrive, 1);},
+                       2*na + 2*nv});
+    kernels.push_back({"hyd_fluxes", [=]() {(void) phyd->Fluxes(pdrive, 1);}, 4*nv});
+  } else if (bc.module == "z4c") {
+    z4c::Z4c *pz4c = pmbp->pz4c;
+    int nv = static_cast<int>(z4c::Z4c::nz4c);
+    int ng = pmbp->pmesh->mb_indcs.ng;
+    (void) pz4c->CopyU(pdrive, 1);
+    kernels.push_back({"calc_rhs", [=]() {
+      if (ng == 2) {
+        (void) pz4c->CalcRHS<2>(pdrive, 1);
+      } else if (ng == 3) {
+        (void) pz4c->CalcRHS<3>(pdrive, 1);
+      } else {
+        (void) pz4c->CalcRHS<4>(pdrive, 1);
+      }}, 2*nv});
+    kernels.push_back({"update", [=]() {(void) pz4c->ExpRKUpdate(pdrive, 1);}, 4*nv});
+    kernels.push_back({"z4c_to_adm",
+                       [=]() {(void) pz4c->ConvertZ4cToADM(pdrive, 1);}, nv + 17});
+  }
+  return kernels;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RunCase()
+//! \brief sets up Mesh, physics and Driver for one case exactly as in main(), times
+//! each kernel and a complete cycle, and writes results to output stream.
+
+void RunCase(const BenchCase &bc, const BenchOptions &opt, std::ostream &os) {
+  ParameterInput *pin = new ParameterInput;
+  std::istringstream is(CaseInput(bc, opt));
+  pin->LoadFromStream(is);
+
+  Kokkos::Timer wall_clock;
+  Mesh *pmesh = new Mesh(pin);
+  pmesh->BuildTreeFromScratch(pin);
+  pmesh->AddCoordinatesAndPhysics(pin);
+  pmesh->pgen = std::make_unique<ProblemGenerator>(pin, pmesh);
+  Driver *pdrive = new Driver(pin, pmesh, 0.0, &wall_clock);
+  Outputs *pout = new Outputs(pin, pmesh);
+  pdrive->Initialize(pmesh, pin, pout, false);
+
+  MeshBlockPack *pmbp = pmesh->pmb_pack;
+  auto &indcs = pmesh->mb_indcs;
+  // zones updated per call (active cells only) and cells touched (including ghosts)
+  double nzones = static_cast<double>(pmesh->nmb_total)*pmesh->NumberOfMeshBlockCells();
+  double ncells = static_cast<double>(pmbp->nmb_thispack)*(indcs.nx1 + 2*indcs.ng)*
+                  (indcs.nx2 + 2*indcs.ng)*(indcs.nx3 + 2*indcs.ng);
+
+  auto write_row = [&](const std::string &kname, double tcall, int narrays) {
+    double zcps = nzones/tcall;
+    double gbps = (narrays > 0) ?
+                  (narrays*ncells*sizeof(Real))/(tcall*1.0e9) : 0.0;
+    if (global_variable::my_rank == 0) {
+      os << std::left << std::setw(10) << bc.module << " " << std::setw(6) << bc.recon
+         << " " << std::setw(6) << bc.rsolver << " " << std::setw(11) << kname
+         << std::right << " " << std::setw(5) << pmesh->nmb_total << " "
+         << std::setw(5) << opt.nx << std::scientific << std::setprecision(5)
+         << " " << std::setw(12) << tcall << " " << std::setw(12) << zcps << " "
+         << std::setw(12) << gbps << std::defaultfloat << std::endl;
+    }
+  };
+
+  // time individual kernels (one warm-up call each)
+  auto kernels = BuildKernels(bc, pmbp, pdrive);
+  for (auto &kern : kernels) {
+    kern.func();
+    Kokkos::fence();
+    Kokkos::Timer timer;
+    for (int n=0; n<opt.nrep; ++n) {
+      kern.func();
+    }
+    Kokkos::fence();
+    write_row(kern.name, timer.seconds()/static_cast<double>(opt.nrep), kern.narrays);
+  }
+
+  // time complete cycles through all task lists, as in Driver::Execute()
+  pdrive->InitBoundaryValuesAndPrimitives(pmesh);
+  auto cycle = [&]() {
+    pdrive->ExecuteTaskList(pmesh, "before_timeintegrator", 0);
+    for (int stage=1; stage<=(pdrive->nexp_stages); ++stage) {
+      pdrive->ExecuteTaskList(pmesh, "before_stagen", stage);
+      pdrive->ExecuteTaskList(pmesh, "stagen", stage);
+      pdrive->ExecuteTaskList(pmesh, "after_stagen", stage);
+    }
+    pdrive->ExecuteTaskList(pmesh, "after_timeintegrator", 1);
+    pmesh->time += pmesh->dt;
+    pmesh->ncycle++;
+  };
+  cycle();
+  Kokkos::fence();
+#if MPI_PARALLEL_ENABLED
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+  Kokkos::Timer timer;
+  for (int n=0; n<opt.ncycle; ++n) {
+    cycle();
+  }
+  Kokkos::fence();
+#if MPI_PARALLEL_ENABLED
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+  write_row("cycle", timer.seconds()/static_cast<double>(opt.ncycle), 0);
+
+  // clean up.  Note anything containing a Kokkos::view must be deleted here.
+  delete pout;
+  delete pdrive;
+  delete pmesh;
+  delete pin;
+  return;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn int main(int argc, char *argv[])
+//! \brief athena_bench main program
+
+int main(int argc, char *argv[]) {
+#if MPI_PARALLEL_ENABLED
+  if (MPI_SUCCESS != MPI_Init(&argc, &argv)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "MPI Initialization failed." << std::endl;
+    return(0);
+  }
+  MPI_Comm_rank(MPI_COMM_WORLD, &(global_variable::my_rank));
+  MPI_Comm_size(MPI_COMM_WORLD, &global_variable::nranks);
+#else
+  global_variable::my_rank = 0;
+  global_variable::nranks  = 1;
+#endif
+  Kokkos::initialize(argc, argv);
+
+  // parse command line options
+  BenchOptions opt;
+  std::string out_file;
+  for (int i=1; i<argc; i++) {
+    if (*argv[i] != '-' || *(argv[i]+1) == '\0' || *(argv[i]+2) != '\0') continue;
+    char opt_letter = *(argv[i]+1);
+    if (opt_letter != 'h' && (i+1 >= argc)) {
+      opt_letter = 'h';
+    }
+    switch(opt_letter) {
+      case 'n': opt.nx = std::atoi(argv[++i]); break;
+      case 'b': opt.nmb = std::atoi(argv[++i]); break;
+      case 'r': opt.nrep = std::atoi(argv[++i]); break;
+      case 'y': opt.ncycle = std::atoi(argv[++i]); break;
+      case 'l': opt.nlevel = std::atoi(argv[++i]); break;
+      case 'o': out_file.assign(argv[++i]); break;
+      case 'm': {
+          opt.modules.clear();
+          std::stringstream ms(argv[++i]);
+          std::string mod;
+          while (std::getline(ms, mod, ',')) {opt.modules.push_back(mod);}
+        }
+        break;
+      case 'h':
+      default:
+        if (global_variable::my_rank == 0) {
+          std::cout << "Usage: " << argv[0] << " [options]\n"
+                    << "  -n <nx>       cells per MeshBlock in each direction [32]\n"
+                    << "  -b <nmb>      number of MeshBlocks in the pack [8]\n"
+                    << "  -r <nrep>     repetitions of each kernel [10]\n"
+                    << "  -y <ncycle>   number of full cycles timed [5]\n"
+                    << "  -l <nlevel>   geodesic grid level for radiation [1]\n"
+                    << "  -m <list>     comma-separated modules "
+                    << "[hydro,mhd,grmhd,radiation,z4c]\n"
+                    << "  -o <file>     write table to file [stdout]\n"
+                    << "  -h            this help\n";
+          ShowConfig();
+        }
+        Kokkos::finalize();
+#if MPI_PARALLEL_ENABLED
+        MPI_Finalize();
+#endif
+        return(0);
+    }
+  }
+
+  std::ofstream ofs;
+  if (!out_file.empty() && global_variable::my_rank == 0) {ofs.open(out_file);}
+  std::ostream &os = (ofs.is_open())? ofs : std::cout;
+  if (global_variable::my_rank == 0) {
+    os << "# athena_bench: nx=" << opt.nx << " nmb=" << opt.nmb << " nrep=" << opt.nrep
+       << " ncycle=" << opt.ncycle << " sizeof(Real)=" << sizeof(Real)
+       << " exec_space=" << DevExeSpace::name() << std::endl
+       << "# module    recon  rsolver kernel        nmb    nx    time/call"
+       << "    zone-cyc/s   GB/s(est)" << std::endl;
+  }
+
+  for (auto &bc : BuildCases(opt)) {
+    RunCase(bc, opt, os);
+  }
+
+  if (ofs.is_open()) {ofs.close();}
+  Kokkos::finalize();
+#if MPI_PARALLEL_ENABLED
+  MPI_Finalize();
+#endif
+  return(0);
+}
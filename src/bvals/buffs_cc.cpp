@@ -28,7 +28,7 @@
 void MeshBoundaryValuesCC::InitSendIndices(MeshBoundaryBuffer &buf,
                                           int ox1, int ox2, int ox3, int f1, int f2) {
   auto &mb_indcs  = pmy_pack->pmesh->mb_indcs;
-  int ng  = mb_indcs.ng;
+  int ng  = nghost;  // number of ghost zones exchanged (may be < mb_indcs.ng)
   int ng1 = ng - 1;
 
   // set indices for sends to neighbors on SAME level
@@ -164,7 +164,7 @@ void MeshBoundaryValuesCC::InitSendIndices(MeshBoundaryBuffer &buf,
 void MeshBoundaryValuesCC::InitRecvIndices(MeshBoundaryBuffer &buf,
                                            int ox1, int ox2, int ox3, int f1, int f2) {
   auto &mb_indcs  = pmy_pack->pmesh->mb_indcs;
-  int ng = mb_indcs.ng;
+  int ng = nghost;   // number of ghost zones exchanged (may be < mb_indcs.ng)
 
   // set indices for receives from neighbors on SAME level
   // Formulae taken from SetBoundarySameLevel() in src/bvals/cc/bvals_cc.cpp
@@ -360,7 +360,7 @@ void MeshBoundaryValuesCC::InitRecvIndices(MeshBoundaryBuffer &buf,
   // Formulae taken from ProlongateBoundaries() in src/bvals/bvals_refine.cpp
   // Identical to receives from coarser level, except ng --> ng/2
   {auto &iprol = buf.iprol[0];   // indices for prolongation
-  int cn = mb_indcs.ng/2;      // nghost must be multiple of 2 with SMR/AMR
+  int cn = nghost/2;      // nghost must be multiple of 2 with SMR/AMR
   if (ox1 == 0) {
     iprol.bis = mb_indcs.cis;          iprol.bie = mb_indcs.cie;
     if (f1 == 0) {
@@ -29,7 +29,7 @@
 void MeshBoundaryValuesFC::InitSendIndices(MeshBoundaryBuffer &buf,
                                            int ox1, int ox2, int ox3, int f1, int f2) {
   auto &mb_indcs  = pmy_pack->pmesh->mb_indcs;
-  int ng  = mb_indcs.ng;
+  int ng  = nghost;  // number of ghost zones exchanged (may be < mb_indcs.ng)
   int ng1 = ng - 1;
 
   // set indices for sends to neighbors on SAME level
@@ -388,7 +388,7 @@ void MeshBoundaryValuesFC::InitSendIndices(MeshBoundaryBuffer &buf,
 void MeshBoundaryValuesFC::InitRecvIndices(MeshBoundaryBuffer &buf,
                                            int ox1, int ox2, int ox3, int f1, int f2) {
   auto &mb_indcs  = pmy_pack->pmesh->mb_indcs;
-  int ng = mb_indcs.ng;
+  int ng = nghost;   // number of ghost zones exchanged (may be < mb_indcs.ng)
 
   // set indices for receives from neighbors on SAME level
   // Formulae same as in SetBoundarySameLevel() in src/bvals/fc/bvals_fc.cpp
@@ -684,7 +684,7 @@ void MeshBoundaryValuesFC::InitRecvIndices(MeshBoundaryBuffer &buf,
   // latter sends face fields on edges of MeshBlock, but prolongation only occurs within
   // ghost cells (and NOT for B1 at [is;ie+1], B2 at [js;je+1], B3 at [ke;ke+1])
   {auto &iprol = buf.iprol;   // indices for prolongation
-  int cn = mb_indcs.ng/2;   // nghost must be multiple of 2 with SMR/AMR
+  int cn = nghost/2;   // nghost must be multiple of 2 with SMR/AMR
   if (ox1 == 0) {
     iprol[0].bis = mb_indcs.cis;          iprol[0].bie = mb_indcs.cie + 1;
     iprol[1].bis = mb_indcs.cis;          iprol[1].bie = mb_indcs.cie;
@@ -9,6 +9,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <string>
 #include <utility>
 #include <algorithm> // max
 
@@ -18,17 +19,23 @@
 #include "mesh/nghbr_index.hpp"
 #include "mesh/mesh.hpp"
 #include "particles/particles.hpp"
+#include "utils/memory_usage.hpp"
 #include "bvals.hpp"
 
 //----------------------------------------------------------------------------------------
 // MeshBoundaryValues constructor:
 
 MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, bool z4c) :
-  pmy_pack(pp),
-  is_z4c_(z4c),
   u_in("uin",1,1),
   b_in("bin",1,1),
-  i_in("iin",1,1) {
+  i_in("iin",1,1),
+  nghost(pp->pmesh->mb_indcs.ng),
+  shm_enabled(false),
+  shm_lrank("shm_lrank",1,1),
+  shm_lid("shm_lid",1,1),
+  pmy_pack(pp),
+  is_z4c_(z4c),
+  shm_recvd_(false) {
   // allocate vector of status flags and MPI requests (if needed)
   int nnghbr = pmy_pack->pmb->nnghbr;
 
@@ -69,6 +76,12 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
   // create unique communicators for variables and fluxes in this BoundaryValues object
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_vars);
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_flux);
+
+  // exchange vars with other ranks on same node through shared memory (if requested),
+  // windows are allocated in InitializeBuffers() once sizes of buffers are known
+  shm_enabled = pin->GetOrAddBoolean("mesh", "shared_memory_bvals", false);
+  shm_flag = nullptr;
+  shm_nmb = 0;
 #endif
 }
 
@@ -84,6 +97,13 @@ MeshBoundaryValues::~MeshBoundaryValues() {
     delete [] recvbuf[n].vars_req;
     delete [] recvbuf[n].flux_req;
   }
+  if (shm_enabled && shm_flag != nullptr) {
+    MPI_Win_unlock_all(win_vars);
+    MPI_Win_unlock_all(win_flag);
+    MPI_Win_free(&win_vars);
+    MPI_Win_free(&win_flag);
+    MPI_Comm_free(&comm_node);
+  }
 #endif
 }
 
@@ -95,8 +115,11 @@ MeshBoundaryValues::~MeshBoundaryValues() {
 //! order of boundaries in nghbr vector
 //! NOTE2: work here cannot be done in MeshBoundaryValues constructor since it calls pure
 //! virtual functions that only get instantiated when the derived classes are constructed
+//! NOTE3: if ng>0, only ng ghost zones are communicated.  Default is <mesh>/nghost.
+
+void MeshBoundaryValues::InitializeBuffers(const int nvar, const int ng) {
+  if (ng > 0) {nghost = ng;}
 
-void MeshBoundaryValues::InitializeBuffers(const int nvar) {
   // allocate memory for inflow BCs (but only if domain not strictly periodic)
   if (!(pmy_pack->pmesh->strictly_periodic)) {
     Kokkos::realloc(u_in, nvar, 6);
@@ -218,9 +241,60 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
     }
   }
 
+  // move recv buffers into shared memory windows
+  if (shm_enabled) {InitSharedMemory();}
+
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn std::size_t MeshBoundaryValues::MemoryUsage
+//! \brief returns bytes of memory used by send/recv buffers and inflow states.  Used by
+//! physics modules to register their boundary buffers with memory_usage::Track().
+
+std::size_t MeshBoundaryValues::MemoryUsage() {
+  std::size_t nbytes = memory_usage::Bytes(u_in) + memory_usage::Bytes(b_in) +
+                       memory_usage::Bytes(i_in);
+  for (int n=0; n<56; ++n) {
+    nbytes += memory_usage::Bytes(sendbuf[n].vars) + memory_usage::Bytes(sendbuf[n].flux);
+    nbytes += memory_usage::Bytes(recvbuf[n].vars) + memory_usage::Bytes(recvbuf[n].flux);
+  }
+  return nbytes;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int MeshBoundaryValues::GhostDepth
+//! \brief returns number of ghost zones to be exchanged for variables of the physics in
+//! input block <block>, set by <block>/nghost (default <mesh>/nghost).  Whether this is
+//! enough for the stencils of that physics (e.g. reconstruction) is checked by caller.
+
+int MeshBoundaryValues::GhostDepth(MeshBlockPack *pp, ParameterInput *pin,
+                                   std::string block) {
+  int ng = pp->pmesh->mb_indcs.ng;
+  int nghost = pin->GetOrAddInteger(block, "nghost", ng);
+  if (nghost < 1 || nghost > ng) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << block << ">/nghost=" << nghost << " must be "
+              << "between 1 and <mesh>/nghost=" << ng << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // prolongation uses nghost/2 coarse ghost zones
+  if (pp->pmesh->multilevel && (nghost % 2) != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << block << ">/nghost must be a multiple of 2 with "
+              << "SMR/AMR" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // orbital advection and shearing box BCs remap the full ghost zones
+  if (nghost < ng && pin->DoesBlockExist("shearing_box")) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << block << ">/nghost must equal <mesh>/nghost with "
+              << "shearing box" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  return nghost;
+}
+
 //----------------------------------------------------------------------------------------
 // ParticlesBoundaryValues constructor:
 
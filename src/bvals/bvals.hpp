@@ -20,12 +20,14 @@ enum class BoundaryFlag {undef=-1,block, reflect, inflow, outflow, diode, user,
                          shear_periodic, vacuum};
 
 #include <algorithm>
+#include <string>
 #include <vector>
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "coordinates/coordinates.hpp"
 #include "tasklist/task_list.hpp"
+#include "utils/first_touch.hpp"
 //#include "particles/particles.hpp"
 
 // Forward declarations
@@ -77,6 +79,9 @@ struct MeshBoundaryBuffer {
 
   // 2D Views that store buffer data on device, dimensioned (nmb, ndata)
   DvceArray2D<Real> vars, flux;
+  // recv buffers for vars of all ranks on this node when they are exchanged through
+  // shared memory, dimensioned (nranks_node, nmb, ndata). vars aliases own element.
+  DvceArray3D<Real> shm_vars;
 
 #if MPI_PARALLEL_ENABLED
   // vectors of length (number of MBs) to hold MPI requests
@@ -90,13 +95,13 @@ struct MeshBoundaryBuffer {
     // With Z4c, buffers may contain BOTH same and coarse data
     if (is_z4c) {
       int nmax = std::max(isame_z4c_ndat, std::max(icoar_ndat, ifine_ndat) );
-      Kokkos::realloc(vars, nmb, (nvars*nmax));
+      ReallocFirstTouch(vars, nmb, (nvars*nmax));
     } else {
       int nmax = std::max(isame_ndat, std::max(icoar_ndat, ifine_ndat) );
-      Kokkos::realloc(vars, nmb, (nvars*nmax));
+      ReallocFirstTouch(vars, nmb, (nvars*nmax));
     }
     int nmax = std::max(iflxs_ndat, iflxc_ndat);
-    Kokkos::realloc(flux, nmb, (nvars*nmax));
+    ReallocFirstTouch(flux, nmb, (nvars*nmax));
   }
 };
 
@@ -120,15 +125,42 @@ class MeshBoundaryValues {
   // constant inflow states at each face, initialized in problem generator
   DualArray2D<Real> u_in, b_in, i_in;
 
+  // number of ghost zones exchanged, prolongated, and set by physical BCs.  Can be less
+  // than <mesh>/nghost when other physics need wider stencils (e.g. MHD with Z4c), but
+  // arrays are always allocated with <mesh>/nghost ghost zones.
+  int nghost;
+
 #if MPI_PARALLEL_ENABLED
   // unique MPI communicators for each case (variables/fluxes)
   MPI_Comm comm_vars, comm_flux;
 #endif
 
+  // data for exchange of vars with MeshBlocks on other ranks of the same node through
+  // MPI-3 shared memory windows (instead of MPI_Isend/Irecv).  See bvals_shm.cpp
+  bool shm_enabled;
+  DualArray2D<int> shm_lrank;  // node rank of neighbor (m,n) if exchanged via shm, or -1
+  DualArray2D<int> shm_lid;    // local ID of neighbor (m,n) on its rank
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm comm_node;
+  MPI_Win win_vars, win_flag;
+  int *shm_flag;                  // flags in shared memory, [node rank][buffer][MB]
+  int shm_nmb;                    // number of MBs per rank in shared buffers
+  std::vector<int> shm_noderank;  // node rank of each rank, or -1 if on another node
+#endif
+
   //functions
   virtual void InitSendIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
   virtual void InitRecvIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
-  void InitializeBuffers(const int nvar);
+  void InitializeBuffers(const int nvar, const int ng=0);
+  std::size_t MemoryUsage();
+  static int GhostDepth(MeshBlockPack *pp, ParameterInput *pin, std::string block);
+
+  // functions for exchange of vars through shared memory on node
+  void InitSharedMemory();
+  void WaitSharedSend();
+  void PostSharedSend();
+  bool TestSharedRecv();
+  void ClearSharedRecv();
 
   TaskStatus InitRecv(const int nvar);
   virtual TaskStatus InitFluxRecv(const int nvar)=0;
@@ -137,10 +169,11 @@ class MeshBoundaryValues {
   TaskStatus ClearFluxRecv();
   TaskStatus ClearFluxSend();
 
-  // BCs associated with various physics modules
-  static void HydroBCs(MeshBlockPack *pp, DualArray2D<Real> uin, DvceArray5D<Real> u0);
-  static void BFieldBCs(MeshBlockPack *pp, DualArray2D<Real> bin, DvceFaceFld4D<Real> b0);
-  static void RadiationBCs(MeshBlockPack *pp,DualArray2D<Real> iin,DvceArray5D<Real> i0);
+  // BCs associated with various physics modules (applied to nghost ghost zones)
+  void HydroBCs(MeshBlockPack *pp, DualArray2D<Real> uin, DvceArray5D<Real> u0);
+  void BFieldBCs(MeshBlockPack *pp, DualArray2D<Real> bin, DvceFaceFld4D<Real> b0);
+  void RadiationBCs(MeshBlockPack *pp,DualArray2D<Real> iin,DvceArray5D<Real> i0);
+  void M1BCs(MeshBlockPack *pp, DualArray2D<Real> uin, DvceArray5D<Real> u0, int nmom);
   static void Z4cBCs(MeshBlockPack *pp, DualArray2D<Real> uin, DvceArray5D<Real> u0,
                      DvceArray5D<Real> coarse_u0);
 
@@ -149,6 +182,7 @@ class MeshBoundaryValues {
   // many types (Hydro, MHD, Radiation, Z4c, etc.)
   MeshBlockPack* pmy_pack;
   bool is_z4c_;   // flag to denote if this BoundaryValues is for Z4c module
+  bool shm_recvd_;  // flag to denote shm recvs of current exchange have been unpacked
 };
 
 //----------------------------------------------------------------------------------------
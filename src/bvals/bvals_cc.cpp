@@ -45,6 +45,9 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
   int nnghbr = pmy_pack->pmb->nnghbr;
   int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
 
+  // wait until neighbors on other ranks of this node have unpacked previous data
+  if (shm_enabled) {WaitSharedSend();}
+
   {int my_rank = global_variable::my_rank;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &mbgid = pmy_pack->pmb->mb_gid;
@@ -53,6 +56,9 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
   auto &rbuf = recvbuf;
   auto &is_z4c = is_z4c_;
   auto &multilevel = pmy_pack->pmesh->multilevel;
+  bool shm = shm_enabled;
+  auto &shm_lr = shm_lrank;
+  auto &shm_id = shm_lid;
   // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
   int nmnv = nmb*nnghbr*nvar;
   Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
@@ -98,6 +104,12 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
       // in MeshBlockPacks, so array index equals (target_id - first_id)
       int dm = nghbr.d_view(m,n).gid - mbgid.d_view(0);
       int dn = nghbr.d_view(m,n).dest;
+      // node rank and local ID of recv'ing MB if it is on another rank of this node
+      int lr = -1;
+      if (shm) {
+        lr = shm_lr.d_view(m,n);
+        if (lr >= 0) {dm = shm_id.d_view(m,n);}
+      }
 
       // Middle loop over k,j
       Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
@@ -125,6 +137,24 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
             tmember.team_barrier();
           }
 
+        // copy directly into shared recv buffer if MeshBlocks on same node
+        } else if (lr >= 0) {
+          if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
+            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+            [&](const int i) {
+              rbuf[dn].shm_vars(lr,dm, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) =
+                  a(m,v,k,j,i);
+            });
+            tmember.team_barrier();
+          } else {
+            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+            [&](const int i) {
+              rbuf[dn].shm_vars(lr,dm, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) =
+                  ca(m,v,k,j,i);
+            });
+            tmember.team_barrier();
+          }
+
         // else copy into send buffer for MPI communication below
 
         } else {
@@ -175,6 +205,11 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
         // in MeshBlockPacks, so array index equals (target_id - first_id)
         int dm = nghbr.d_view(m,n).gid - mbgid.d_view(0);
         int dn = nghbr.d_view(m,n).dest;
+        int lr = -1;
+        if (shm) {
+          lr = shm_lr.d_view(m,n);
+          if (lr >= 0) {dm = shm_id.d_view(m,n);}
+        }
 
         // Middle loop over k,j
         Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
@@ -192,6 +227,15 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
             });
             tmember.team_barrier();
 
+          // copy directly into shared recv buffer if MeshBlocks on same node
+          } else if (lr >= 0) {
+            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
+            [&](const int i) {
+              rbuf[dn].shm_vars(lr,dm,ndat+ (i-il + ni*(j-jl + nj*(k-kl + nk*v)))) =
+                  ca(m,v,k,j,i);
+            });
+            tmember.team_barrier();
+
           // else copy into send buffer for MPI communication below
           } else {
             // load data from coarse_u0
@@ -220,7 +264,7 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
         // index and rank of destination Neighbor
         int dn = nghbr.h_view(m,n).dest;
         int drank = nghbr.h_view(m,n).rank;
-        if (drank != my_rank) {
+        if ((drank != my_rank) && !(shm_enabled && shm_noderank[drank] >= 0)) {
           // create tag using local ID and buffer index of *receiving* MeshBlock
           int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
           int tag = CreateBvals_MPI_Tag(lid, dn);
@@ -253,6 +297,8 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
        << std::endl << "MPI error in posting sends" << std::endl;
     std::exit(EXIT_FAILURE);
   }
+  // signal neighbors on this node that data is in their recv buffers
+  if (shm_enabled) {PostSharedSend();}
 #endif
   return TaskStatus::complete;
 }
@@ -296,6 +342,10 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
               << std::endl;
     std::exit(EXIT_FAILURE);
   }
+  // test flags of recv buffers filled by neighbors on this node through shared memory
+  if (shm_enabled && !(bflag)) {
+    bflag = !(TestSharedRecv());
+  }
   // exit if recv boundary buffer communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
 #endif
@@ -411,5 +461,12 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
     }  // end if-neighbor-exists block
   });  // end par_for_outer
 
+#if MPI_PARALLEL_ENABLED
+  // free recv buffers in shared memory for next exchange
+  if (shm_enabled) {
+    Kokkos::fence();
+    ClearSharedRecv();
+  }
+#endif
   return TaskStatus::complete;
 }
@@ -43,12 +43,18 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
+  // wait until neighbors on other ranks of this node have unpacked previous data
+  if (shm_enabled) {WaitSharedSend();}
+
   {int my_rank = global_variable::my_rank;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &mbgid = pmy_pack->pmb->mb_gid;
   auto &mblev = pmy_pack->pmb->mb_lev;
   auto &sbuf = sendbuf;
   auto &rbuf = recvbuf;
+  bool shm = shm_enabled;
+  auto &shm_lr = shm_lrank;
+  auto &shm_id = shm_lid;
 
   // Outer loop over (# of MeshBlocks)*(# of buffers)*(three field components)
   int nmnv = 3*nmb;
@@ -100,6 +106,12 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
         // indices of recv'ing MB and buffer: assumes MB IDs are stored sequentially
         int dm = nghbr.d_view(m,n).gid - mbgid.d_view(0);
         int dn = nghbr.d_view(m,n).dest;
+        // node rank and local ID of recv'ing MB if it is on another rank of this node
+        int lr = -1;
+        if (shm) {
+          lr = shm_lr.d_view(m,n);
+          if (lr >= 0) {dm = shm_id.d_view(m,n);}
+        }
 
         // copy field components directly into recv buffer if MeshBlocks on same rank
         if (nghbr.d_view(m,n).rank == my_rank) {
@@ -141,6 +153,47 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
             tmember.team_barrier();
           }
 
+        // copy field components directly into shared recv buffer if MBs on same node
+        } else if (lr >= 0) {
+          auto rvars = Kokkos::subview(rbuf[dn].shm_vars, lr, dm, Kokkos::ALL);
+          // if neighbor is at same or finer level, load data from b0
+          if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
+            Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji),
+            [&](const int idx) {
+              int k = (idx)/nji;
+              int j = (idx - k*nji)/ni;
+              int i = (idx - k*nji - j*ni) + il;
+              k += kl;
+              j += jl;
+              if (v==0) {
+                rvars(i-il + ni*(j-jl + nj*(k-kl))) = b.x1f(m,k,j,i);
+              } else if (v==1) {
+                rvars(ndat*v + i-il + ni*(j-jl + nj*(k-kl))) = b.x2f(m,k,j,i);
+              } else if (v==2) {
+                rvars(ndat*v + i-il + ni*(j-jl + nj*(k-kl))) = b.x3f(m,k,j,i);
+              }
+            });
+            tmember.team_barrier();
+          // if neighbor is at coarser level, load data from coarse_b0
+          } else {
+            Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkji),
+            [&](const int idx) {
+              int k = (idx)/nji;
+              int j = (idx - k*nji)/ni;
+              int i = (idx - k*nji - j*ni) + il;
+              k += kl;
+              j += jl;
+              if (v==0) {
+                rvars(i-il + ni*(j-jl + nj*(k-kl))) = cb.x1f(m,k,j,i);
+              } else if (v==1) {
+                rvars(ndat*v + i-il + ni*(j-jl + nj*(k-kl))) = cb.x2f(m,k,j,i);
+              } else if (v==2) {
+                rvars(ndat*v + i-il + ni*(j-jl + nj*(k-kl))) = cb.x3f(m,k,j,i);
+              }
+            });
+            tmember.team_barrier();
+          }
+
         // else copy field components into send buffer for MPI communication below
         } else {
           // if neighbor is at same or finer level, load data from b0
@@ -198,7 +251,7 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
         // index and rank of destination Neighbor
         int dn = nghbr.h_view(m,n).dest;
         int drank = nghbr.h_view(m,n).rank;
-        if (drank != my_rank) {
+        if ((drank != my_rank) && !(shm_enabled && shm_noderank[drank] >= 0)) {
           // create tag using local ID and buffer index of *receiving* MeshBlock
           int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
           int tag = CreateBvals_MPI_Tag(lid, dn);
@@ -227,6 +280,8 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
        << std::endl << "MPI error in posting sends" << std::endl;
     std::exit(EXIT_FAILURE);
   }
+  // signal neighbors on this node that data is in their recv buffers
+  if (shm_enabled) {PostSharedSend();}
 #endif
   return TaskStatus::complete;
 }
@@ -268,6 +323,10 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b,
               << std::endl;
     std::exit(EXIT_FAILURE);
   }
+  // test flags of recv buffers filled by neighbors on this node through shared memory
+  if (shm_enabled && !(bflag)) {
+    bflag = !(TestSharedRecv());
+  }
   // exit if recv boundary buffer communications have not completed
   if (bflag) {return TaskStatus::incomplete;}
 #endif
@@ -361,5 +420,12 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b,
     }
   });  // end par_for_outer
 
+#if MPI_PARALLEL_ENABLED
+  // free recv buffers in shared memory for next exchange
+  if (shm_enabled) {
+    Kokkos::fence();
+    ClearSharedRecv();
+  }
+#endif
   return TaskStatus::complete;
 }
@@ -0,0 +1,252 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file bvals_shm.cpp
+//! \brief functions to exchange boundary buffers of Mesh variables with MeshBlocks on
+//! other ranks of the same node through MPI-3 shared memory windows.
+//!
+//! With <mesh>/shared_memory_bvals=true, the recv buffers (vars only) of all ranks on a
+//! node are allocated in a single shared memory window.  PackAndSendCC/FC() then pack
+//! data for MeshBlocks on other ranks of the node directly into the recv buffers of
+//! those ranks (exactly as for MeshBlocks on the same rank), and set a flag in a second
+//! shared window instead of calling MPI_Isend().  RecvAndUnpackCC/FC() test these flags
+//! along with the MPI requests of neighbors on other nodes, which are unchanged.
+//!
+//! Flags are 0 (buffer free) or 1 (buffer filled).  The sender waits for the receiver
+//! to unpack (and clear) the data of the previous exchange before packing new data.
+//! This is only possible if device memory is accessible from the host (CPU builds).
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals.hpp"
+
+#if MPI_PARALLEL_ENABLED
+namespace {
+// flags in shared memory are read and written with atomic acquire/release operations,
+// MPI_Win_sync() makes data written through the window visible to other ranks
+inline int LoadFlag(int *flag) {return __atomic_load_n(flag, __ATOMIC_ACQUIRE);}
+inline void StoreFlag(int *flag, int val) {__atomic_store_n(flag, val, __ATOMIC_RELEASE);}
+} // namespace
+#endif
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::InitSharedMemory
+//! \brief allocates recv buffers of vars and flags of all ranks on this node in shared
+//! memory windows, and re-points vars of recv buffers on this rank to the window.
+//! Collective over all ranks, so must be called in the same order on every rank.
+
+void MeshBoundaryValues::InitSharedMemory() {
+#if MPI_PARALLEL_ENABLED
+  if (!(Kokkos::SpaceAccessibility<Kokkos::HostSpace, DevMemSpace>::accessible)) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "<mesh>/shared_memory_bvals requires device memory that is accessible"
+                << " from host, boundary values will be exchanged with MPI" << std::endl;
+    }
+    shm_enabled = false;
+    return;
+  }
+
+  // free windows if buffers are re-initialized
+  if (shm_flag != nullptr) {
+    MPI_Win_unlock_all(win_vars);
+    MPI_Win_unlock_all(win_flag);
+    MPI_Win_free(&win_vars);
+    MPI_Win_free(&win_flag);
+    MPI_Comm_free(&comm_node);
+  }
+
+  // communicator of ranks on this node, and node rank of every rank (-1 if off node)
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                      MPI_INFO_NULL, &comm_node);
+  int nrank_node, node_rank;
+  MPI_Comm_size(comm_node, &nrank_node);
+  MPI_Comm_rank(comm_node, &node_rank);
+  std::vector<int> world_rank(nrank_node);
+  MPI_Allgather(&(global_variable::my_rank), 1, MPI_INT, world_rank.data(), 1, MPI_INT,
+                comm_node);
+  shm_noderank.assign(global_variable::nranks, -1);
+  for (int r=0; r<nrank_node; ++r) {
+    if (world_rank[r] != global_variable::my_rank) {shm_noderank[world_rank[r]] = r;}
+  }
+
+  // size of recv buffers must be the same on all ranks of the node
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  std::vector<int> ndat(nnghbr+1);
+  for (int n=0; n<nnghbr; ++n) {
+    ndat[n] = recvbuf[n].vars.extent_int(1);
+  }
+  ndat[nnghbr] = recvbuf[0].vars.extent_int(0);
+  MPI_Allreduce(MPI_IN_PLACE, ndat.data(), nnghbr+1, MPI_INT, MPI_MAX, comm_node);
+  shm_nmb = ndat[nnghbr];
+  std::size_t nreal = 0;
+  for (int n=0; n<nnghbr; ++n) {
+    nreal += static_cast<std::size_t>(nrank_node)*shm_nmb*ndat[n];
+  }
+  std::size_t nflag = static_cast<std::size_t>(nrank_node)*nnghbr*shm_nmb;
+
+  // windows are allocated by first rank on node, so that buffers of each neighbor index
+  // are contiguous across ranks and can be addressed as 3D arrays
+  bool leader = (node_rank == 0);
+  Real *vars_base;
+  int *flag_base;
+  MPI_Win_allocate_shared((leader? nreal*sizeof(Real) : 0), sizeof(Real), MPI_INFO_NULL,
+                          comm_node, &vars_base, &win_vars);
+  MPI_Win_allocate_shared((leader? nflag*sizeof(int) : 0), sizeof(int), MPI_INFO_NULL,
+                          comm_node, &flag_base, &win_flag);
+  MPI_Aint wsize;
+  int disp;
+  MPI_Win_shared_query(win_vars, 0, &wsize, &disp, &vars_base);
+  MPI_Win_shared_query(win_flag, 0, &wsize, &disp, &flag_base);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, win_vars);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, win_flag);
+  shm_flag = flag_base;
+
+  std::size_t offset = 0;
+  for (int n=0; n<nnghbr; ++n) {
+    recvbuf[n].shm_vars = DvceArray3D<Real>(vars_base + offset, nrank_node, shm_nmb,
+                                            ndat[n]);
+    recvbuf[n].vars = Kokkos::subview(recvbuf[n].shm_vars, node_rank, Kokkos::ALL,
+                                      Kokkos::ALL);
+    offset += static_cast<std::size_t>(nrank_node)*shm_nmb*ndat[n];
+  }
+
+  // all buffers start out free
+  if (leader) {
+    for (std::size_t i=0; i<nflag; ++i) {shm_flag[i] = 0;}
+  }
+  MPI_Win_sync(win_flag);
+  MPI_Barrier(comm_node);
+  MPI_Win_sync(win_flag);
+
+  Kokkos::realloc(shm_lrank, shm_nmb, nnghbr);
+  Kokkos::realloc(shm_lid, shm_nmb, nnghbr);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::WaitSharedSend
+//! \brief finds neighbors on other ranks of this node (which can change with AMR and
+//! load balancing), and waits until they have unpacked data of the previous exchange.
+//! Receivers have always finished the previous stage, so this cannot deadlock.
+
+void MeshBoundaryValues::WaitSharedSend() {
+#if MPI_PARALLEL_ENABLED
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &gids_eachrank = pmy_pack->pmesh->gids_eachrank;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      shm_lrank.h_view(m,n) = -1;
+      if (nghbr.h_view(m,n).gid >= 0) {
+        int drank = nghbr.h_view(m,n).rank;
+        if (drank != global_variable::my_rank) {
+          shm_lrank.h_view(m,n) = shm_noderank[drank];
+          shm_lid.h_view(m,n) = nghbr.h_view(m,n).gid - gids_eachrank[drank];
+        }
+      }
+    }
+  }
+  shm_lrank.template modify<HostMemSpace>();
+  shm_lid.template modify<HostMemSpace>();
+  shm_lrank.template sync<DevExeSpace>();
+  shm_lid.template sync<DevExeSpace>();
+
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      int lr = shm_lrank.h_view(m,n);
+      if (lr >= 0) {
+        int dn = nghbr.h_view(m,n).dest;
+        int *flag = &shm_flag[(lr*nnghbr + dn)*shm_nmb + shm_lid.h_view(m,n)];
+        while (LoadFlag(flag) != 0) {
+          MPI_Win_sync(win_flag);
+        }
+      }
+    }
+  }
+  MPI_Win_sync(win_vars);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::PostSharedSend
+//! \brief sets flags of recv buffers on other ranks of this node once data is packed.
+//! Must be called after kernels that pack buffers have completed (Kokkos::fence()).
+
+void MeshBoundaryValues::PostSharedSend() {
+#if MPI_PARALLEL_ENABLED
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  MPI_Win_sync(win_vars);
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      int lr = shm_lrank.h_view(m,n);
+      if (lr >= 0) {
+        int dn = nghbr.h_view(m,n).dest;
+        StoreFlag(&shm_flag[(lr*nnghbr + dn)*shm_nmb + shm_lid.h_view(m,n)], 1);
+      }
+    }
+  }
+  MPI_Win_sync(win_flag);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MeshBoundaryValues::TestSharedRecv
+//! \brief returns true if data from all neighbors on other ranks of this node has been
+//! packed into recv buffers on this rank
+
+bool MeshBoundaryValues::TestSharedRecv() {
+#if MPI_PARALLEL_ENABLED
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  int node_rank;
+  MPI_Comm_rank(comm_node, &node_rank);
+  MPI_Win_sync(win_flag);
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (shm_lrank.h_view(m,n) >= 0) {
+        if (LoadFlag(&shm_flag[(node_rank*nnghbr + n)*shm_nmb + m]) != 1) {return false;}
+      }
+    }
+  }
+  MPI_Win_sync(win_vars);
+#endif
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::ClearSharedRecv
+//! \brief clears flags of recv buffers on this rank so neighbors can send new data.
+//! Must be called after kernels that unpack buffers have completed (Kokkos::fence()).
+
+void MeshBoundaryValues::ClearSharedRecv() {
+#if MPI_PARALLEL_ENABLED
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  int node_rank;
+  MPI_Comm_rank(comm_node, &node_rank);
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (shm_lrank.h_view(m,n) >= 0) {
+        StoreFlag(&shm_flag[(node_rank*nnghbr + n)*shm_nmb + m], 0);
+      }
+    }
+  }
+  MPI_Win_sync(win_flag);
+#endif
+  shm_recvd_ = true;
+  return;
+}
@@ -42,8 +42,10 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
         // rank of destination buffer
         int drank = nghbr.h_view(m,n).rank;
 
-        // post non-blocking receive if neighboring MeshBlock on a different rank
-        if (drank != global_variable::my_rank) {
+        // post non-blocking receive if neighboring MeshBlock on a different rank, unless
+        // data are exchanged through shared memory on this node
+        if ((drank != global_variable::my_rank) &&
+            !(shm_enabled && shm_noderank[drank] >= 0)) {
           // create tag using local ID and buffer index of *receiving* MeshBlock
           int tag = CreateBvals_MPI_Tag(m, n);
 
@@ -77,6 +79,7 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
     std::exit(EXIT_FAILURE);
   }
 #endif
+  shm_recvd_ = false;
   return TaskStatus::complete;
 }
 
@@ -102,6 +105,10 @@ TaskStatus MeshBoundaryValues::ClearRecv() {
       }
     }
   }
+  // wait for data from ranks on this node, unless it has already been unpacked
+  if (shm_enabled && !(shm_recvd_)) {
+    while (!(TestSharedRecv())) {}
+  }
   // Quit if MPI error detected
   if (!(no_errors)) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
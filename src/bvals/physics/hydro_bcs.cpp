@@ -25,272 +25,293 @@ void MeshBoundaryValues::HydroBCs(MeshBlockPack *ppack, DualArray2D<Real> u_in,
   auto &pm = ppack->pmesh;
   auto &indcs = ppack->pmesh->mb_indcs;
   int &ng = indcs.ng;
+  int ngbc = nghost;  // number of ghost zones set by BCs
   auto &mb_bcs = ppack->pmb->mb_bcs;
 
   int n1 = indcs.nx1 + 2*ng;
   int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
   int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
   int nvar = u0.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
-  int nmb = ppack->nmb_thispack;
+  // compact lists of MeshBlocks with physical boundaries at each face
+  auto &bcs_list = ppack->pmb->bcs_list;
+  auto &nbcs = ppack->pmb->nbcs_list;
+  int nin, nl;  // number of MeshBlocks in list for inner face, and for both faces
 
-  // only apply BCs unless periodic or shear_periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::periodic &&
-      pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::shear_periodic) {
+  // only apply BCs to MeshBlocks with physical (not periodic) boundaries in x1
+  nin = nbcs[BoundaryFace::inner_x1];
+  nl = nin + nbcs[BoundaryFace::outer_x1];
+  if (nl > 0) {
     int &is = indcs.is;
     int &ie = indcs.ie;
-    par_for("hydrobc_x1", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n2-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int j) {
-      // apply physical boundaries to inner_x1
-      switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
-        case BoundaryFlag::reflect:
-          for (int i=0; i<ng; ++i) {
-            if (n==(IVX)) {
-              u0(m,n,k,j,is-i-1) = -u0(m,n,k,j,is+i);
-            } else {
-              u0(m,n,k,j,is-i-1) =  u0(m,n,k,j,is+i);
+    par_for("hydrobc_x1", DevExeSpace(), 0,(nl-1),0,(nvar-1),0,(n3-1),0,(n2-1),
+    KOKKOS_LAMBDA(int l, int n, int k, int j) {
+      if (l < nin) {
+        int m = bcs_list.d_view(BoundaryFace::inner_x1,l);
+        // apply physical boundaries to inner_x1
+        switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
+          case BoundaryFlag::reflect:
+            for (int i=0; i<ngbc; ++i) {
+              if (n==(IVX)) {
+                u0(m,n,k,j,is-i-1) = -u0(m,n,k,j,is+i);
+              } else {
+                u0(m,n,k,j,is-i-1) =  u0(m,n,k,j,is+i);
+              }
             }
-          }
-          break;
-        case BoundaryFlag::outflow:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,is-i-1) = u0(m,n,k,j,is);
-          }
-          break;
-        case BoundaryFlag::inflow:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,is-i-1) = u_in.d_view(n,BoundaryFace::inner_x1);
-          }
-          break;
-        case BoundaryFlag::diode:
-          for (int i=0; i<ng; ++i) {
-            if (n==(IVX)) {
-              u0(m,n,k,j,is-i-1) = fmin(0.0,u0(m,n,k,j,is));
-            } else {
-              u0(m,n  ,k,j,is-i-1) = u0(m,n,k,j,is);
+            break;
+          case BoundaryFlag::outflow:
+            for (int i=0; i<ngbc; ++i) {
+              u0(m,n,k,j,is-i-1) = u0(m,n,k,j,is);
             }
-          }
-          break;
-        case BoundaryFlag::vacuum:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,is-i-1) = 0.0;
-          }
-          break;
-        default:
-          break;
-      }
-
-      // apply physical boundaries to outer_x1
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
-        case BoundaryFlag::reflect:
-          for (int i=0; i<ng; ++i) {
-            if (n==(IVX)) {  // reflect 1-velocity
-              u0(m,n,k,j,ie+i+1) = -u0(m,n,k,j,ie-i);
-            } else {
-              u0(m,n,k,j,ie+i+1) =  u0(m,n,k,j,ie-i);
+            break;
+          case BoundaryFlag::inflow:
+            for (int i=0; i<ngbc; ++i) {
+              u0(m,n,k,j,is-i-1) = u_in.d_view(n,BoundaryFace::inner_x1);
             }
-          }
-          break;
-        case BoundaryFlag::outflow:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,ie+i+1) = u0(m,n,k,j,ie);
-          }
-          break;
-        case BoundaryFlag::inflow:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,ie+i+1) = u_in.d_view(n,BoundaryFace::outer_x1);
-          }
-          break;
-        case BoundaryFlag::diode:
-          for (int i=0; i<ng; ++i) {
-            if (n==(IVX)) {
-              u0(m,n,k,j,ie+i+1) = fmax(0.0,u0(m,n,k,j,ie));
-            } else {
-              u0(m,n  ,k,j,ie+i+1) = u0(m,n,k,j,ie);
+            break;
+          case BoundaryFlag::diode:
+            for (int i=0; i<ngbc; ++i) {
+              if (n==(IVX)) {
+                u0(m,n,k,j,is-i-1) = fmin(0.0,u0(m,n,k,j,is));
+              } else {
+                u0(m,n  ,k,j,is-i-1) = u0(m,n,k,j,is);
+              }
             }
-          }
-          break;
-        case BoundaryFlag::vacuum:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,ie+i+1) = 0.0;
-          }
-          break;
-        default:
-          break;
+            break;
+          case BoundaryFlag::vacuum:
+            for (int i=0; i<ngbc; ++i) {
+              u0(m,n,k,j,is-i-1) = 0.0;
+            }
+            break;
+          default:
+            break;
+        }
+      } else {
+        int m = bcs_list.d_view(BoundaryFace::outer_x1,l-nin);
+        // apply physical boundaries to outer_x1
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
+          case BoundaryFlag::reflect:
+            for (int i=0; i<ngbc; ++i) {
+              if (n==(IVX)) {  // reflect 1-velocity
+                u0(m,n,k,j,ie+i+1) = -u0(m,n,k,j,ie-i);
+              } else {
+                u0(m,n,k,j,ie+i+1) =  u0(m,n,k,j,ie-i);
+              }
+            }
+            break;
+          case BoundaryFlag::outflow:
+            for (int i=0; i<ngbc; ++i) {
+              u0(m,n,k,j,ie+i+1) = u0(m,n,k,j,ie);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int i=0; i<ngbc; ++i) {
+              u0(m,n,k,j,ie+i+1) = u_in.d_view(n,BoundaryFace::outer_x1);
+            }
+            break;
+          case BoundaryFlag::diode:
+            for (int i=0; i<ngbc; ++i) {
+              if (n==(IVX)) {
+                u0(m,n,k,j,ie+i+1) = fmax(0.0,u0(m,n,k,j,ie));
+              } else {
+                u0(m,n  ,k,j,ie+i+1) = u0(m,n,k,j,ie);
+              }
+            }
+            break;
+          case BoundaryFlag::vacuum:
+            for (int i=0; i<ngbc; ++i) {
+              u0(m,n,k,j,ie+i+1) = 0.0;
+            }
+            break;
+          default:
+            break;
+        }
       }
     });
   }
 
   if (pm->one_d) return;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x2] != BoundaryFlag::periodic) {
+  // only apply BCs to MeshBlocks with physical (not periodic) boundaries in x2
+  nin = nbcs[BoundaryFace::inner_x2];
+  nl = nin + nbcs[BoundaryFace::outer_x2];
+  if (nl > 0) {
     int &js = indcs.js;
     int &je = indcs.je;
-    par_for("hydrobc_x2", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n1-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int i) {
-      // apply physical boundaries to inner_x2
-      switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
+    par_for("hydrobc_x2", DevExeSpace(), 0,(nl-1),0,(nvar-1),0,(n3-1),0,(n1-1),
+    KOKKOS_LAMBDA(int l, int n, int k, int i) {
+      if (l < nin) {
+        int m = bcs_list.d_view(BoundaryFace::inner_x2,l);
+        // apply physical boundaries to inner_x2
+        switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
+          case BoundaryFlag::reflect:
+            for (int j=0; j<ngbc; ++j) {
+              if (n==(IVY)) {  // reflect 2-velocity
+                u0(m,n,k,js-j-1,i) = -u0(m,n,k,js+j,i);
+              } else {
+                u0(m,n,k,js-j-1,i) =  u0(m,n,k,js+j,i);
+              }
+            }
+            break;
+          case BoundaryFlag::outflow:
+            for (int j=0; j<ngbc; ++j) {
+              u0(m,n,k,js-j-1,i) = u0(m,n,k,js,i);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int j=0; j<ngbc; ++j) {
+              u0(m,n,k,js-j-1,i) = u_in.d_view(n,BoundaryFace::inner_x2);
+            }
+            break;
+          case BoundaryFlag::diode:
+            for (int j=0; j<ngbc; ++j) {
+              if (n==(IVY)) {
+                u0(m,n,k,js-j-1,i) = fmin(0.0,u0(m,n,k,js,i));
+              } else {
+                u0(m,n,k,js-j-1,i) = u0(m,n,k,js,i);
+              }
+            }
+            break;
+          case BoundaryFlag::vacuum:
+            for (int j=0; j<ngbc; ++j) {
+              u0(m,n,k,js-j-1,i) = 0.0;
+            }
+            break;
+          default:
+            break;
+        }
+      } else {
+        int m = bcs_list.d_view(BoundaryFace::outer_x2,l-nin);
+        // apply physical boundaries to outer_x2
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
+          case BoundaryFlag::reflect:
+            for (int j=0; j<ngbc; ++j) {
+              if (n==(IVY)) {  // reflect 2-velocity
+                u0(m,n,k,je+j+1,i) = -u0(m,n,k,je-j,i);
+              } else {
+                u0(m,n,k,je+j+1,i) =  u0(m,n,k,je-j,i);
+              }
+            }
+            break;
+          case BoundaryFlag::outflow:
+            for (int j=0; j<ngbc; ++j) {
+              u0(m,n,k,je+j+1,i) = u0(m,n,k,je,i);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int j=0; j<ngbc; ++j) {
+              u0(m,n,k,je+j+1,i) = u_in.d_view(n,BoundaryFace::outer_x2);
+            }
+            break;
+          case BoundaryFlag::diode:
+            for (int j=0; j<ngbc; ++j) {
+              if (n==(IVY)) {
+                u0(m,n,k,je+j+1,i) = fmax(0.0,u0(m,n,k,je,i));
+              } else {
+                u0(m,n,k,je+j+1,i) = u0(m,n,k,je,i);
+              }
+            }
+            break;
+          case BoundaryFlag::vacuum:
+            for (int j=0; j<ngbc; ++j) {
+              u0(m,n,k,je+j+1,i) = 0.0;
+            }
+            break;
+          default:
+            break;
+        }
+      }
+    });
+  }
+  if (pm->two_d) return;
+
+  // only apply BCs to MeshBlocks with physical (not periodic) boundaries in x3
+  nin = nbcs[BoundaryFace::inner_x3];
+  nl = nin + nbcs[BoundaryFace::outer_x3];
+  if (nl == 0) return;
+  int &ks = indcs.ks;
+  int &ke = indcs.ke;
+  par_for("hydrobc_x3", DevExeSpace(), 0,(nl-1),0,(nvar-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int l, int n, int j, int i) {
+    if (l < nin) {
+      int m = bcs_list.d_view(BoundaryFace::inner_x3,l);
+      // apply physical boundaries to inner_x3
+      switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
         case BoundaryFlag::reflect:
-          for (int j=0; j<ng; ++j) {
-            if (n==(IVY)) {  // reflect 2-velocity
-              u0(m,n,k,js-j-1,i) = -u0(m,n,k,js+j,i);
+          for (int k=0; k<ngbc; ++k) {
+            if (n==(IVZ)) {  // reflect 3-velocity
+              u0(m,n,ks-k-1,j,i) = -u0(m,n,ks+k,j,i);
             } else {
-              u0(m,n,k,js-j-1,i) =  u0(m,n,k,js+j,i);
+              u0(m,n,ks-k-1,j,i) =  u0(m,n,ks+k,j,i);
             }
           }
           break;
         case BoundaryFlag::outflow:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,js-j-1,i) = u0(m,n,k,js,i);
+          for (int k=0; k<ngbc; ++k) {
+            u0(m,n,ks-k-1,j,i) = u0(m,n,ks,j,i);
           }
           break;
         case BoundaryFlag::inflow:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,js-j-1,i) = u_in.d_view(n,BoundaryFace::inner_x2);
+          for (int k=0; k<ngbc; ++k) {
+            u0(m,n,ks-k-1,j,i) = u_in.d_view(n,BoundaryFace::inner_x3);
           }
           break;
         case BoundaryFlag::diode:
-          for (int j=0; j<ng; ++j) {
-            if (n==(IVY)) {
-              u0(m,n,k,js-j-1,i) = fmin(0.0,u0(m,n,k,js,i));
+          for (int k=0; k<ngbc; ++k) {
+            if (n==(IVZ)) {
+              u0(m,n,ks-k-1,j,i) = fmin(0.0,u0(m,n,ks,j,i));
             } else {
-              u0(m,n,k,js-j-1,i) = u0(m,n,k,js,i);
+              u0(m,n,ks-k-1,j,i) = u0(m,n,ks,j,i);
             }
           }
           break;
         case BoundaryFlag::vacuum:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,js-j-1,i) = 0.0;
+          for (int k=0; k<ngbc; ++k) {
+            u0(m,n,ks-k-1,j,i) = 0.0;
           }
           break;
         default:
           break;
       }
-
-      // apply physical boundaries to outer_x2
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
+    } else {
+      int m = bcs_list.d_view(BoundaryFace::outer_x3,l-nin);
+      // apply physical boundaries to outer_x3
+      switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
         case BoundaryFlag::reflect:
-          for (int j=0; j<ng; ++j) {
-            if (n==(IVY)) {  // reflect 2-velocity
-              u0(m,n,k,je+j+1,i) = -u0(m,n,k,je-j,i);
+          for (int k=0; k<ngbc; ++k) {
+            if (n==(IVZ)) {  // reflect 3-velocity
+              u0(m,n,ke+k+1,j,i) = -u0(m,n,ke-k,j,i);
             } else {
-              u0(m,n,k,je+j+1,i) =  u0(m,n,k,je-j,i);
+              u0(m,n,ke+k+1,j,i) =  u0(m,n,ke-k,j,i);
             }
           }
           break;
         case BoundaryFlag::outflow:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,je+j+1,i) = u0(m,n,k,je,i);
+          for (int k=0; k<ngbc; ++k) {
+            u0(m,n,ke+k+1,j,i) = u0(m,n,ke,j,i);
           }
           break;
         case BoundaryFlag::inflow:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,je+j+1,i) = u_in.d_view(n,BoundaryFace::outer_x2);
+          for (int k=0; k<ngbc; ++k) {
+            u0(m,n,ke+k+1,j,i) = u_in.d_view(n,BoundaryFace::outer_x3);
           }
           break;
         case BoundaryFlag::diode:
-          for (int j=0; j<ng; ++j) {
-            if (n==(IVY)) {
-              u0(m,n,k,je+j+1,i) = fmax(0.0,u0(m,n,k,je,i));
+          for (int k=0; k<ngbc; ++k) {
+            if (n==(IVZ)) {
+              u0(m,n,ke+k+1,j,i) = fmax(0.0,u0(m,n,ke,j,i));
             } else {
-              u0(m,n,k,je+j+1,i) = u0(m,n,k,je,i);
+              u0(m,n,ke+k+1,j,i) = u0(m,n,ke,j,i);
             }
           }
           break;
         case BoundaryFlag::vacuum:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,je+j+1,i) = 0.0;
+          for (int k=0; k<ngbc; ++k) {
+            u0(m,n,ke+k+1,j,i) = 0.0;
           }
           break;
         default:
           break;
       }
-    });
-  }
-  if (pm->two_d) return;
-
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic) return;
-  int &ks = indcs.ks;
-  int &ke = indcs.ke;
-  par_for("hydrobc_x3", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n2-1),0,(n1-1),
-  KOKKOS_LAMBDA(int m, int n, int j, int i) {
-    // apply physical boundaries to inner_x3
-    switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
-      case BoundaryFlag::reflect:
-        for (int k=0; k<ng; ++k) {
-          if (n==(IVZ)) {  // reflect 3-velocity
-            u0(m,n,ks-k-1,j,i) = -u0(m,n,ks+k,j,i);
-          } else {
-            u0(m,n,ks-k-1,j,i) =  u0(m,n,ks+k,j,i);
-          }
-        }
-        break;
-      case BoundaryFlag::outflow:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ks-k-1,j,i) = u0(m,n,ks,j,i);
-        }
-        break;
-      case BoundaryFlag::inflow:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ks-k-1,j,i) = u_in.d_view(n,BoundaryFace::inner_x3);
-        }
-        break;
-      case BoundaryFlag::diode:
-        for (int k=0; k<ng; ++k) {
-          if (n==(IVZ)) {
-            u0(m,n,ks-k-1,j,i) = fmin(0.0,u0(m,n,ks,j,i));
-          } else {
-            u0(m,n,ks-k-1,j,i) = u0(m,n,ks,j,i);
-          }
-        }
-        break;
-      case BoundaryFlag::vacuum:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ks-k-1,j,i) = 0.0;
-        }
-        break;
-      default:
-        break;
-    }
-
-    // apply physical boundaries to outer_x3
-    switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
-      case BoundaryFlag::reflect:
-        for (int k=0; k<ng; ++k) {
-          if (n==(IVZ)) {  // reflect 3-velocity
-            u0(m,n,ke+k+1,j,i) = -u0(m,n,ke-k,j,i);
-          } else {
-            u0(m,n,ke+k+1,j,i) =  u0(m,n,ke-k,j,i);
-          }
-        }
-        break;
-      case BoundaryFlag::outflow:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ke+k+1,j,i) = u0(m,n,ke,j,i);
-        }
-        break;
-      case BoundaryFlag::inflow:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ke+k+1,j,i) = u_in.d_view(n,BoundaryFace::outer_x3);
-        }
-        break;
-      case BoundaryFlag::diode:
-        for (int k=0; k<ng; ++k) {
-          if (n==(IVZ)) {
-            u0(m,n,ke+k+1,j,i) = fmax(0.0,u0(m,n,ke,j,i));
-          } else {
-            u0(m,n,ke+k+1,j,i) = u0(m,n,ke,j,i);
-          }
-        }
-        break;
-      case BoundaryFlag::vacuum:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ke+k+1,j,i) = 0.0;
-        }
-        break;
-      default:
-        break;
     }
   });
 
@@ -136,206 +136,226 @@ void BCHelper(MeshBlockPack *ppack, DualArray2D<Real> u_in, DvceArray5D<Real> u0
   auto &mb_bcs = ppack->pmb->mb_bcs;
 
   int nvar = u0.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
-  int nmb = ppack->nmb_thispack;
+  // compact lists of MeshBlocks with physical boundaries at each face
+  auto &bcs_list = ppack->pmb->bcs_list;
+  auto &nbcs = ppack->pmb->nbcs_list;
+  int nin, nl;  // number of MeshBlocks in list for inner face, and for both faces
 
-  // only apply BCs unless periodic or shear_periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::periodic
-      && pm->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::shear_periodic) {
-    par_for("z4cbc_x1", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n2-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int j) {
-      // apply physical boundaries to inner_x1
-      switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
-        case BoundaryFlag::reflect:
-          for (int i=0; i<ng; ++i) {
-            if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GXZ ||
-                n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AXZ ||
-                n==z4c::Z4c::I_Z4C_GAMX || n==z4c::Z4c::I_Z4C_BETAX) {
-              u0(m,n,k,j,is-i-1) = -u0(m,n,k,j,is+i);
-            } else {
-              u0(m,n,k,j,is-i-1) =  u0(m,n,k,j,is+i);
+  // only apply BCs to MeshBlocks with physical (not periodic) boundaries in x1
+  nin = nbcs[BoundaryFace::inner_x1];
+  nl = nin + nbcs[BoundaryFace::outer_x1];
+  if (nl > 0) {
+    par_for("z4cbc_x1", DevExeSpace(), 0,(nl-1),0,(nvar-1),0,(n3-1),0,(n2-1),
+    KOKKOS_LAMBDA(int l, int n, int k, int j) {
+      if (l < nin) {
+        int m = bcs_list.d_view(BoundaryFace::inner_x1,l);
+        // apply physical boundaries to inner_x1
+        switch (mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
+          case BoundaryFlag::reflect:
+            for (int i=0; i<ng; ++i) {
+              if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GXZ ||
+                  n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AXZ ||
+                  n==z4c::Z4c::I_Z4C_GAMX || n==z4c::Z4c::I_Z4C_BETAX) {
+                u0(m,n,k,j,is-i-1) = -u0(m,n,k,j,is+i);
+              } else {
+                u0(m,n,k,j,is-i-1) =  u0(m,n,k,j,is+i);
+              }
             }
-          }
-          break;
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-        case BoundaryFlag::vacuum:
-          for (int i=0; i<ng; ++i) {
-            //u0(m,n,k,j,is-i-1) = u0(m,n,k,j,is);
-            u0(m,n,k,j,is-i-1) = Extrapolate<order>(u0,m,n,k,j,is,0,0,1,i+1);
-          }
-          break;
-        case BoundaryFlag::inflow:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,is-i-1) = u_in.d_view(n,BoundaryFace::inner_x1);
-          }
-          break;
-        default:
-          break;
-      }
-
-      // apply physical boundaries to outer_x1
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
-        case BoundaryFlag::reflect:
-          for (int i=0; i<ng; ++i) {
-            if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GXZ ||
-                n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AXZ ||
-                n==z4c::Z4c::I_Z4C_GAMX || n==z4c::Z4c::I_Z4C_BETAX) {
-              u0(m,n,k,j,ie+i+1) = -u0(m,n,k,j,ie-i);
-            } else {
-              u0(m,n,k,j,ie+i+1) =  u0(m,n,k,j,ie-i);
+            break;
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
+          case BoundaryFlag::vacuum:
+            for (int i=0; i<ng; ++i) {
+              //u0(m,n,k,j,is-i-1) = u0(m,n,k,j,is);
+              u0(m,n,k,j,is-i-1) = Extrapolate<order>(u0,m,n,k,j,is,0,0,1,i+1);
             }
-          }
-          break;
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-        case BoundaryFlag::vacuum:
-          for (int i=0; i<ng; ++i) {
-            //u0(m,n,k,j,ie+i+1) = u0(m,n,k,j,ie);
-            u0(m,n,k,j,ie+i+1) = Extrapolate<order>(u0,m,n,k,j,ie,0,0,-1,i+1);
-          }
-          break;
-        case BoundaryFlag::inflow:
-          for (int i=0; i<ng; ++i) {
-            u0(m,n,k,j,ie+i+1) = u_in.d_view(n,BoundaryFace::outer_x1);
-          }
-          break;
-        default:
-          break;
+            break;
+          case BoundaryFlag::inflow:
+            for (int i=0; i<ng; ++i) {
+              u0(m,n,k,j,is-i-1) = u_in.d_view(n,BoundaryFace::inner_x1);
+            }
+            break;
+          default:
+            break;
+        }
+      } else {
+        int m = bcs_list.d_view(BoundaryFace::outer_x1,l-nin);
+        // apply physical boundaries to outer_x1
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
+          case BoundaryFlag::reflect:
+            for (int i=0; i<ng; ++i) {
+              if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GXZ ||
+                  n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AXZ ||
+                  n==z4c::Z4c::I_Z4C_GAMX || n==z4c::Z4c::I_Z4C_BETAX) {
+                u0(m,n,k,j,ie+i+1) = -u0(m,n,k,j,ie-i);
+              } else {
+                u0(m,n,k,j,ie+i+1) =  u0(m,n,k,j,ie-i);
+              }
+            }
+            break;
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
+          case BoundaryFlag::vacuum:
+            for (int i=0; i<ng; ++i) {
+              //u0(m,n,k,j,ie+i+1) = u0(m,n,k,j,ie);
+              u0(m,n,k,j,ie+i+1) = Extrapolate<order>(u0,m,n,k,j,ie,0,0,-1,i+1);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int i=0; i<ng; ++i) {
+              u0(m,n,k,j,ie+i+1) = u_in.d_view(n,BoundaryFace::outer_x1);
+            }
+            break;
+          default:
+            break;
+        }
       }
     });
   }
 
   if (pm->one_d) return;
 
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x2] != BoundaryFlag::periodic) {
-    par_for("z4cbc_x2", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n3-1),0,(n1-1),
-    KOKKOS_LAMBDA(int m, int n, int k, int i) {
-      // apply physical boundaries to inner_x2
-      switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
+  // only apply BCs to MeshBlocks with physical (not periodic) boundaries in x2
+  nin = nbcs[BoundaryFace::inner_x2];
+  nl = nin + nbcs[BoundaryFace::outer_x2];
+  if (nl > 0) {
+    par_for("z4cbc_x2", DevExeSpace(), 0,(nl-1),0,(nvar-1),0,(n3-1),0,(n1-1),
+    KOKKOS_LAMBDA(int l, int n, int k, int i) {
+      if (l < nin) {
+        int m = bcs_list.d_view(BoundaryFace::inner_x2,l);
+        // apply physical boundaries to inner_x2
+        switch (mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
+          case BoundaryFlag::reflect:
+            for (int j=0; j<ng; ++j) {
+              if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GYZ ||
+                  n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AYZ ||
+                  n==z4c::Z4c::I_Z4C_GAMY || n==z4c::Z4c::I_Z4C_BETAY) {
+                u0(m,n,k,js-j-1,i) = -u0(m,n,k,js+j,i);
+              } else {
+                u0(m,n,k,js-j-1,i) =  u0(m,n,k,js+j,i);
+              }
+            }
+            break;
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
+          case BoundaryFlag::vacuum:
+            for (int j=0; j<ng; ++j) {
+              //u0(m,n,k,js-j-1,i) = u0(m,n,k,js,i);
+              u0(m,n,k,js-j-1,i) = Extrapolate<order>(u0,m,n,k,js,i,0,1,0,j+1);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int j=0; j<ng; ++j) {
+              u0(m,n,k,js-j-1,i) = u_in.d_view(n,BoundaryFace::inner_x2);
+            }
+            break;
+          default:
+            break;
+        }
+      } else {
+        int m = bcs_list.d_view(BoundaryFace::outer_x2,l-nin);
+        // apply physical boundaries to outer_x2
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
+          case BoundaryFlag::reflect:
+            for (int j=0; j<ng; ++j) {
+              if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GYZ ||
+                  n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AYZ ||
+                  n==z4c::Z4c::I_Z4C_GAMY || n==z4c::Z4c::I_Z4C_BETAY) {
+                u0(m,n,k,je+j+1,i) = -u0(m,n,k,je-j,i);
+              } else {
+                u0(m,n,k,je+j+1,i) =  u0(m,n,k,je-j,i);
+              }
+            }
+            break;
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
+          case BoundaryFlag::vacuum:
+            for (int j=0; j<ng; ++j) {
+              //u0(m,n,k,je+j+1,i) = u0(m,n,k,je,i);
+              u0(m,n,k,je+j+1,i) = Extrapolate<order>(u0,m,n,k,je,i,0,-1,0,j+1);
+            }
+            break;
+          case BoundaryFlag::inflow:
+            for (int j=0; j<ng; ++j) {
+              u0(m,n,k,je+j+1,i) = u_in.d_view(n,BoundaryFace::outer_x2);
+            }
+            break;
+          default:
+            break;
+        }
+      }
+    });
+  }
+  if (pm->two_d) return;
+
+  // only apply BCs to MeshBlocks with physical (not periodic) boundaries in x3
+  nin = nbcs[BoundaryFace::inner_x3];
+  nl = nin + nbcs[BoundaryFace::outer_x3];
+  if (nl == 0) return;
+  par_for("z4cbc_x3", DevExeSpace(), 0,(nl-1),0,(nvar-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int l, int n, int j, int i) {
+    if (l < nin) {
+      int m = bcs_list.d_view(BoundaryFace::inner_x3,l);
+      // apply physical boundaries to inner_x3
+      switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
         case BoundaryFlag::reflect:
-          for (int j=0; j<ng; ++j) {
-            if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GYZ ||
-                n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AYZ ||
-                n==z4c::Z4c::I_Z4C_GAMY || n==z4c::Z4c::I_Z4C_BETAY) {
-              u0(m,n,k,js-j-1,i) = -u0(m,n,k,js+j,i);
+          for (int k=0; k<ng; ++k) {
+            if (n==z4c::Z4c::I_Z4C_GXZ || n==z4c::Z4c::I_Z4C_GYZ ||
+                n==z4c::Z4c::I_Z4C_AXZ || n==z4c::Z4c::I_Z4C_AYZ ||
+                n==z4c::Z4c::I_Z4C_GAMZ || n==z4c::Z4c::I_Z4C_BETAZ) {
+              u0(m,n,ks-k-1,j,i) = -u0(m,n,ks+k,j,i);
             } else {
-              u0(m,n,k,js-j-1,i) =  u0(m,n,k,js+j,i);
+              u0(m,n,ks-k-1,j,i) =  u0(m,n,ks+k,j,i);
             }
           }
           break;
         case BoundaryFlag::diode:
         case BoundaryFlag::outflow:
         case BoundaryFlag::vacuum:
-          for (int j=0; j<ng; ++j) {
-            //u0(m,n,k,js-j-1,i) = u0(m,n,k,js,i);
-            u0(m,n,k,js-j-1,i) = Extrapolate<order>(u0,m,n,k,js,i,0,1,0,j+1);
+          for (int k=0; k<ng; ++k) {
+            //u0(m,n,ks-k-1,j,i) = u0(m,n,ks,j,i);
+            u0(m,n,ks-k-1,j,i) = Extrapolate<order>(u0,m,n,ks,j,i,1,0,0,k+1);
           }
           break;
         case BoundaryFlag::inflow:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,js-j-1,i) = u_in.d_view(n,BoundaryFace::inner_x2);
+          for (int k=0; k<ng; ++k) {
+            u0(m,n,ks-k-1,j,i) = u_in.d_view(n,BoundaryFace::inner_x3);
           }
           break;
         default:
           break;
       }
-
-      // apply physical boundaries to outer_x2
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
+    } else {
+      int m = bcs_list.d_view(BoundaryFace::outer_x3,l-nin);
+      // apply physical boundaries to outer_x3
+      switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
         case BoundaryFlag::reflect:
-          for (int j=0; j<ng; ++j) {
-            if (n==z4c::Z4c::I_Z4C_GXY || n==z4c::Z4c::I_Z4C_GYZ ||
-                n==z4c::Z4c::I_Z4C_AXY || n==z4c::Z4c::I_Z4C_AYZ ||
-                n==z4c::Z4c::I_Z4C_GAMY || n==z4c::Z4c::I_Z4C_BETAY) {
-              u0(m,n,k,je+j+1,i) = -u0(m,n,k,je-j,i);
+          for (int k=0; k<ng; ++k) {
+            if (n==z4c::Z4c::I_Z4C_GXZ || n==z4c::Z4c::I_Z4C_GYZ ||
+                n==z4c::Z4c::I_Z4C_AXZ || n==z4c::Z4c::I_Z4C_AYZ ||
+                n==z4c::Z4c::I_Z4C_GAMZ || n==z4c::Z4c::I_Z4C_BETAZ) {
+              u0(m,n,ke+k+1,j,i) = -u0(m,n,ke-k,j,i);
             } else {
-              u0(m,n,k,je+j+1,i) =  u0(m,n,k,je-j,i);
+              u0(m,n,ke+k+1,j,i) =  u0(m,n,ke-k,j,i);
             }
           }
           break;
         case BoundaryFlag::diode:
         case BoundaryFlag::outflow:
         case BoundaryFlag::vacuum:
-          for (int j=0; j<ng; ++j) {
-            //u0(m,n,k,je+j+1,i) = u0(m,n,k,je,i);
-            u0(m,n,k,je+j+1,i) = Extrapolate<order>(u0,m,n,k,je,i,0,-1,0,j+1);
+          for (int k=0; k<ng; ++k) {
+            //u0(m,n,ke+k+1,j,i) = u0(m,n,ke,j,i);
+            u0(m,n,ke+k+1,j,i) = Extrapolate<order>(u0,m,n,ke,j,i,-1,0,0,k+1);
           }
           break;
         case BoundaryFlag::inflow:
-          for (int j=0; j<ng; ++j) {
-            u0(m,n,k,je+j+1,i) = u_in.d_view(n,BoundaryFace::outer_x2);
+          for (int k=0; k<ng; ++k) {
+            u0(m,n,ke+k+1,j,i) = u_in.d_view(n,BoundaryFace::outer_x3);
           }
           break;
         default:
           break;
       }
-    });
-  }
-  if (pm->two_d) return;
-
-  // only apply BCs if not periodic
-  if (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic) return;
-  par_for("z4cbc_x3", DevExeSpace(), 0,(nmb-1),0,(nvar-1),0,(n2-1),0,(n1-1),
-  KOKKOS_LAMBDA(int m, int n, int j, int i) {
-    // apply physical boundaries to inner_x3
-    switch (mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
-      case BoundaryFlag::reflect:
-        for (int k=0; k<ng; ++k) {
-          if (n==z4c::Z4c::I_Z4C_GXZ || n==z4c::Z4c::I_Z4C_GYZ ||
-              n==z4c::Z4c::I_Z4C_AXZ || n==z4c::Z4c::I_Z4C_AYZ ||
-              n==z4c::Z4c::I_Z4C_GAMZ || n==z4c::Z4c::I_Z4C_BETAZ) {
-            u0(m,n,ks-k-1,j,i) = -u0(m,n,ks+k,j,i);
-          } else {
-            u0(m,n,ks-k-1,j,i) =  u0(m,n,ks+k,j,i);
-          }
-        }
-        break;
-      case BoundaryFlag::diode:
-      case BoundaryFlag::outflow:
-      case BoundaryFlag::vacuum:
-        for (int k=0; k<ng; ++k) {
-          //u0(m,n,ks-k-1,j,i) = u0(m,n,ks,j,i);
-          u0(m,n,ks-k-1,j,i) = Extrapolate<order>(u0,m,n,ks,j,i,1,0,0,k+1);
-        }
-        break;
-      case BoundaryFlag::inflow:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ks-k-1,j,i) = u_in.d_view(n,BoundaryFace::inner_x3);
-        }
-        break;
-      default:
-        break;
-    }
-
-    // apply physical boundaries to outer_x3
-    switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
-      case BoundaryFlag::reflect:
-        for (int k=0; k<ng; ++k) {
-          if (n==z4c::Z4c::I_Z4C_GXZ || n==z4c::Z4c::I_Z4C_GYZ ||
-              n==z4c::Z4c::I_Z4C_AXZ || n==z4c::Z4c::I_Z4C_AYZ ||
-              n==z4c::Z4c::I_Z4C_GAMZ || n==z4c::Z4c::I_Z4C_BETAZ) {
-            u0(m,n,ke+k+1,j,i) = -u0(m,n,ke-k,j,i);
-          } else {
-            u0(m,n,ke+k+1,j,i) =  u0(m,n,ke-k,j,i);
-          }
-        }
-        break;
-      case BoundaryFlag::diode:
-      case BoundaryFlag::outflow:
-      case BoundaryFlag::vacuum:
-        for (int k=0; k<ng; ++k) {
-          //u0(m,n,ke+k+1,j,i) = u0(m,n,ke,j,i);
-          u0(m,n,ke+k+1,j,i) = Extrapolate<order>(u0,m,n,ke,j,i,-1,0,0,k+1);
-        }
-        break;
-      case BoundaryFlag::inflow:
-        for (int k=0; k<ng; ++k) {
-          u0(m,n,ke+k+1,j,i) = u_in.d_view(n,BoundaryFace::outer_x3);
-        }
-        break;
-      default:
-        break;
     }
   });
 
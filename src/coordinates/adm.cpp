@@ -13,6 +13,8 @@
 #include "mesh/mesh.hpp"
 #include "mesh/meshblock_pack.hpp"
 #include "z4c/z4c.hpp"
+#include "coordinates/superposed_ks.hpp"
+#include "utils/memory_usage.hpp"
 
 namespace adm {
 char const * const ADM::ADM_names[ADM::nadm] = {
@@ -47,11 +49,23 @@ ADM::ADM(MeshBlockPack *ppack, ParameterInput *pin):
   adm.psi4.InitWithShallowSlice(u_adm, I_ADM_PSI4);
   adm.g_dd.InitWithShallowSlice(u_adm, I_ADM_GXX, I_ADM_GZZ);
   adm.vK_dd.InitWithShallowSlice(u_adm, I_ADM_KXX, I_ADM_KZZ);
+
+  // register arrays for memory accounting
+  memory_usage::TrackArrays("ADM", u_adm);
+
+  // analytic spacetime of a black hole binary, evaluated at the current time so that it
+  // is available to the problem generator
+  if (pin->GetOrAddBoolean("adm", "superposed_ks", false)) {
+    psks = new SuperposedKS(ppack, pin);
+    psks->SetMetric(ppack->pmesh->time);
+  }
 }
 
 //----------------------------------------------------------------------------------------
 // destructor
-ADM::~ADM() {}
+ADM::~ADM() {
+  if (psks != nullptr) {delete psks;}
+}
 
 } // namespace adm
 
@@ -19,6 +19,8 @@
 class MeshBlockPack;
 
 namespace adm {
+class SuperposedKS;
+
 //! \class ADM
 class ADM {
  public:
@@ -56,6 +58,9 @@ class ADM {
 
   DvceArray5D<Real> u_adm;                                   // adm variables
 
+  // analytic binary spacetime set in ADM variables (only with <adm>/superposed_ks)
+  SuperposedKS *psks = nullptr;
+
   // TODO(Francesco): handle regridding
 
  private:
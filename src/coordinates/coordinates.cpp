@@ -16,6 +16,7 @@
 #include "cell_locations.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
+#include "utils/memory_usage.hpp"
 
 //----------------------------------------------------------------------------------------
 // constructor, initializes coordinates data
@@ -89,6 +90,7 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
       if (coord_data.excision_scheme == ExcisionScheme::fixed) {
         SetExcisionMasks(excision_floor, excision_flux);
       }
+      memory_usage::TrackArrays("Coordinates", excision_floor, excision_flux);
     }
   }
 }
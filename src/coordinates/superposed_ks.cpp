@@ -0,0 +1,217 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file superposed_ks.cpp
+//! \brief implementation of SuperposedKS class, which fills the ADM variables with the
+//! approximate spacetime of a black hole binary
+
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/mesh_refinement.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/coordinates.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "coordinates/adm.hpp"
+#include "coordinates/superposed_ks.hpp"
+#include "tasklist/numerical_relativity.hpp"
+
+namespace adm {
+
+//----------------------------------------------------------------------------------------
+// constructor: reads parameters of binary from <adm> block
+
+SuperposedKS::SuperposedKS(MeshBlockPack *ppack, ParameterInput *pin) :
+    pmy_pack(ppack),
+    tstage(0.0),
+    nmb_changed(0) {
+  if (ppack->pz4c != nullptr || !(pin->DoesBlockExist("mhd"))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<adm>/superposed_ks requires an <mhd> block and cannot "
+              << "be used with <z4c>" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  bin.m[0] = pin->GetOrAddReal("adm", "bh_mass1", 0.5);
+  bin.m[1] = pin->GetOrAddReal("adm", "bh_mass2", 0.5);
+  Real chi1 = pin->GetOrAddReal("adm", "bh_spin1", 0.0);
+  Real chi2 = pin->GetOrAddReal("adm", "bh_spin2", 0.0);
+  if (bin.m[0] <= 0.0 || bin.m[1] <= 0.0 || fabs(chi1) >= 1.0 || fabs(chi2) >= 1.0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Black hole masses must be positive and spins must "
+              << "satisfy |bh_spin| < 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  bin.a[0] = chi1*bin.m[0];
+  bin.a[1] = chi2*bin.m[1];
+  Real mtot = bin.m[0] + bin.m[1];
+  bin.sep0 = pin->GetReal("adm", "bh_separation");
+  bin.phase0 = pin->GetOrAddReal("adm", "bh_phase", 0.0);
+
+  std::string orbit = pin->GetOrAddString("adm", "orbit", "circular");
+  if (orbit.compare("circular") == 0) {
+    bin.inspiral = false;
+  } else if (orbit.compare("inspiral") == 0) {
+    bin.inspiral = true;
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<adm>/orbit = '" << orbit << "' not implemented, "
+              << "use circular or inspiral" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  bin.sep_min = pin->GetOrAddReal("adm", "bh_min_separation", 2.0*mtot);
+  bin.sep_min = std::min(bin.sep_min, bin.sep0);
+  Real bcoef = 12.8*bin.m[0]*bin.m[1]*mtot;
+  bin.t_min = (SQR(SQR(bin.sep0)) - SQR(SQR(bin.sep_min)))/(4.0*bcoef);
+
+  // excision radii from <coord> are in units of the mass of each hole
+  auto &coord = ppack->pcoord->coord_data;
+  bin.rexcise = (coord.bh_excise)? coord.rexcise : 0.0;
+
+  // step for finite differences of metric, small compared to mass of each hole
+  fd_step = pin->GetOrAddReal("adm", "fd_step", 1.0e-3*std::min(bin.m[0], bin.m[1]));
+
+  if (global_variable::my_rank == 0) {
+    std::cout << "Superposed Kerr-Schild binary: masses " << bin.m[0] << ", " << bin.m[1]
+              << ", separation " << bin.sep0 << ", " << orbit << " orbit" << std::endl;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SuperposedKS::QueueSuperposedKSTasks
+//! \brief queue tasks that evaluate the metric.  The metric is set at the time of the
+//! updated state after the source terms (which use the metric at the start of the
+//! stage) have been added, and before the conserved variables are inverted.
+
+void SuperposedKS::QueueSuperposedKSTasks() {
+  using namespace numrel;  // NOLINT(build/namespaces)
+  NumericalRelativity *pnr = pmy_pack->pnr;
+  pnr->QueueTask(&SuperposedKS::CheckMetric, this, ADM_CheckMetric, "ADM_CheckMetric",
+                 Task_Start);
+  pnr->QueueTask(&SuperposedKS::UpdateMetric, this, ADM_SetMetric, "ADM_SetMetric",
+                 Task_Run, {MHD_AddSrc});
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus SuperposedKS::CheckMetric
+//! \brief re-evaluates the metric at the start of a cycle if the MeshBlocks in the pack
+//! have changed since it was last set (i.e. after AMR or load balancing)
+
+TaskStatus SuperposedKS::CheckMetric(Driver *pdrive, int stage) {
+  if (stage == 1) {
+    tstage = 0.0;
+    Mesh *pm = pmy_pack->pmesh;
+    if (pm->adaptive) {
+      int nchanged = pm->pmr->nmb_created + pm->pmr->nmb_deleted;
+      if (nchanged != nmb_changed) {
+        SetMetric(pm->time);
+      }
+    }
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus SuperposedKS::UpdateMetric
+//! \brief sets metric at time of updated state in this stage.  In units of dt this time
+//! obeys the same recursion as the state itself, with u1 at the start of the cycle.
+
+TaskStatus SuperposedKS::UpdateMetric(Driver *pdrive, int stage) {
+  tstage = pdrive->gam0[stage-1]*tstage + pdrive->beta[stage-1];
+  Mesh *pm = pmy_pack->pmesh;
+  SetMetric(pm->time + tstage*(pm->dt));
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SuperposedKS::SetMetric
+//! \brief fills ADM variables in all cells (including ghost zones) with the metric at the
+//! given time, and moves the excision masks with the holes
+
+void SuperposedKS::SetMetric(Real time) {
+  Mesh *pm = pmy_pack->pmesh;
+  ADM *padm = pmy_pack->padm;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &indcs = pm->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+
+  // number of MeshBlocks in pack may have grown with AMR
+  if (padm->u_adm.extent_int(0) < nmb) {
+    Kokkos::realloc(padm->u_adm, nmb, ADM::nadm, n3, n2, n1);
+    padm->adm.alpha.InitWithShallowSlice(padm->u_adm, ADM::I_ADM_ALPHA);
+    padm->adm.beta_u.InitWithShallowSlice(padm->u_adm, ADM::I_ADM_BETAX,
+                                          ADM::I_ADM_BETAZ);
+    padm->adm.psi4.InitWithShallowSlice(padm->u_adm, ADM::I_ADM_PSI4);
+    padm->adm.g_dd.InitWithShallowSlice(padm->u_adm, ADM::I_ADM_GXX, ADM::I_ADM_GZZ);
+    padm->adm.vK_dd.InitWithShallowSlice(padm->u_adm, ADM::I_ADM_KXX, ADM::I_ADM_KZZ);
+  }
+  if (pm->adaptive) {
+    nmb_changed = pm->pmr->nmb_created + pm->pmr->nmb_deleted;
+  }
+
+  // capture variables for kernel
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &adm = padm->adm;
+  auto bin_ = bin;
+  Real h = fd_step;
+  auto &coord = pmy_pack->pcoord->coord_data;
+  bool excise_fixed = (coord.bh_excise &&
+                       coord.excision_scheme == ExcisionScheme::fixed);
+  Real rexcise = bin.rexcise;
+  Real rexcise_flux = coord.flux_excise_r;
+  auto &floor = pmy_pack->pcoord->excision_floor;
+  auto &flux = pmy_pack->pcoord->excision_flux;
+
+  par_for("superposed_ks", DevExeSpace(), 0, (nmb-1), 0, (n3-1), 0, (n2-1), 0, (n1-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max);
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real x2v = CellCenterX(j-js, nx2, x2min, x2max);
+
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, nx3, x3min, x3max);
+
+    Real alp, beta_u[3], g_dd[3][3], k_dd[3][3], psi4, rmin;
+    SuperposedKSADM(bin_, time, x1v, x2v, x3v, h, alp, beta_u, g_dd, k_dd, psi4, rmin);
+
+    adm.alpha(m,k,j,i) = alp;
+    adm.psi4(m,k,j,i) = psi4;
+    for (int a=0; a<3; ++a) {
+      adm.beta_u(m,a,k,j,i) = beta_u[a];
+      for (int b=a; b<3; ++b) {
+        adm.g_dd(m,a,b,k,j,i) = g_dd[a][b];
+        adm.vK_dd(m,a,b,k,j,i) = k_dd[a][b];
+      }
+    }
+    if (excise_fixed && m < floor.extent_int(0)) {
+      floor(m,k,j,i) = (rmin <= rexcise);
+      flux(m,k,j,i) = (rmin <= rexcise_flux);
+    }
+  });
+
+  // lapse-based excision follows the holes through the updated lapse
+  if (coord.bh_excise && coord.excision_scheme == ExcisionScheme::lapse) {
+    pmy_pack->pcoord->UpdateExcisionMasks();
+  }
+  return;
+}
+
+} // namespace adm
@@ -0,0 +1,282 @@
+#ifndef COORDINATES_SUPERPOSED_KS_HPP_
+#define COORDINATES_SUPERPOSED_KS_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file superposed_ks.hpp
+//! \brief Approximate spacetime of a black hole binary, constructed by superposing two
+//! boosted Kerr-Schild black holes (e.g. Combi et al. 2021, Ruiz et al. 2023):
+//!    g_ab = eta_ab + 2 H_1 l1_a l1_b + 2 H_2 l2_a l2_b
+//! where H_n and l_n are the Kerr-Schild scalar and null covector of hole n, evaluated in
+//! its rest frame and Lorentz-boosted with its instantaneous orbital velocity.  Holes
+//! move on circular orbits in the x-y plane, optionally shrinking by gravitational-wave
+//! emission at the rate of Peters (1964).  Spins are aligned with the z-axis.
+//!
+//! The metric is evaluated on the fly inside kernels and stored in the ADM variables, so
+//! that it is used by dynamical GRMHD exactly as an evolved metric.  Derivatives needed
+//! for the extrinsic curvature are computed with centered finite differences of the
+//! analytic metric.
+//!
+//! Input parameters in <adm> block:
+//!   superposed_ks = true        enables this spacetime (requires <mhd>, not <z4c>)
+//!   bh_mass1, bh_mass2          masses of the holes (default 0.5 each)
+//!   bh_spin1, bh_spin2          dimensionless spins along z (default 0)
+//!   bh_separation               initial separation (coordinate distance)
+//!   bh_phase                    initial orbital phase of hole 1 (default 0)
+//!   orbit                       circular (default) or inspiral
+//!   bh_min_separation           inspiral stops shrinking here (default 2*(m1+m2))
+//!   fd_step                     step of finite differences (default 1e-3*min(m1,m2))
+//! With <coord>/excise = true and the fixed excision scheme, cells are excised inside
+//! the Kerr-Schild radius <coord>/rexcise (flux_excise_r for the flux mask) of either
+//! hole, in units of its mass.  Problem generators should leave the ADM variables as
+//! set here, since they are already evaluated when the ProblemGenerator is called.
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
+#include "coordinates/adm.hpp"
+
+// forward declarations
+class MeshBlockPack;
+class Driver;
+
+namespace adm {
+
+//----------------------------------------------------------------------------------------
+//! \struct BinaryKSData
+//! \brief container for parameters of binary needed inside kernels
+
+struct BinaryKSData {
+  Real m[2];        // masses
+  Real a[2];        // spin parameters (a = chi*m)
+  Real sep0;        // initial separation
+  Real phase0;      // initial orbital phase
+  bool inspiral;    // separation shrinks by GW emission
+  Real sep_min;     // minimum separation during inspiral
+  Real t_min;       // time at which sep_min is reached
+  Real rexcise;     // excision radius in units of mass
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void BinaryOrbit
+//! \brief positions and velocities of both holes at time t.  For the inspiral the
+//! separation s obeys ds/dt = -B/s^3, B = (64/5) m1 m2 M, with orbital frequency
+//! sqrt(M/s^3), which can be integrated analytically for s and the phase.
+
+KOKKOS_INLINE_FUNCTION
+void BinaryOrbit(const BinaryKSData &bin, const Real t, Real pos[2][3], Real vel[2][3]) {
+  Real mtot = bin.m[0] + bin.m[1];
+  Real sep = bin.sep0, dsep = 0.0, phase;
+  if (bin.inspiral) {
+    Real bcoef = 12.8*bin.m[0]*bin.m[1]*mtot;
+    Real tt = fmin(t, bin.t_min);
+    sep = sqrt(sqrt(SQR(SQR(bin.sep0)) - 4.0*bcoef*tt));
+    phase = bin.phase0 + 0.4*sqrt(mtot)*(pow(bin.sep0, 2.5) - pow(sep, 2.5))/bcoef;
+    if (t > bin.t_min) {
+      phase += sqrt(mtot/(sep*SQR(sep)))*(t - bin.t_min);
+    } else {
+      dsep = -bcoef/(sep*SQR(sep));
+    }
+  } else {
+    phase = bin.phase0 + sqrt(mtot/(sep*SQR(sep)))*t;
+  }
+  Real omega = sqrt(mtot/(sep*SQR(sep)));
+  Real cp = cos(phase), sp = sin(phase);
+  for (int n=0; n<2; ++n) {
+    // hole 1 at +m2/M*sep, hole 2 at -m1/M*sep along direction of phase
+    Real frac = (n == 0)? (bin.m[1]/mtot) : -(bin.m[0]/mtot);
+    pos[n][0] = frac*sep*cp;
+    pos[n][1] = frac*sep*sp;
+    pos[n][2] = 0.0;
+    vel[n][0] = frac*(dsep*cp - sep*omega*sp);
+    vel[n][1] = frac*(dsep*sp + sep*omega*cp);
+    vel[n][2] = 0.0;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BoostedKS
+//! \brief Kerr-Schild scalar H and null covector l_a (lab frame) of a hole of mass m and
+//! spin a moving with velocity v, at displacement dx from the hole.  Also returns the
+//! Kerr-Schild radius in the rest frame of the hole.
+
+KOKKOS_INLINE_FUNCTION
+void BoostedKS(const Real m, const Real a, const Real dx[3], const Real v[3],
+               Real &hks, Real l_d[4], Real &rks) {
+  // coordinates in rest frame of hole (instantaneous boost, no time dilation of orbit)
+  Real v2 = SQR(v[0]) + SQR(v[1]) + SQR(v[2]);
+  Real gam = 1.0/sqrt(1.0 - v2);
+  Real vdx = v[0]*dx[0] + v[1]*dx[1] + v[2]*dx[2];
+  Real fac = (v2 > 0.0)? (gam - 1.0)*vdx/v2 : 0.0;
+  Real x = dx[0] + fac*v[0];
+  Real y = dx[1] + fac*v[1];
+  Real z = dx[2] + fac*v[2];
+
+  // Kerr-Schild scalar and null covector in rest frame (see cartesian_ks.hpp)
+  Real rad = sqrt(SQR(x) + SQR(y) + SQR(z));
+  Real r = sqrt((SQR(rad)-SQR(a)+sqrt(SQR(SQR(rad)-SQR(a))+4.0*SQR(a)*SQR(z)))/2.0);
+  Real eps = 1e-6*m;
+  if (r < eps) {
+    r = 0.5*(eps + r*r/eps);
+  }
+  rks = r;
+  hks = m*SQR(r)*r/(SQR(SQR(r)) + SQR(a)*SQR(z));
+  Real lp[3];
+  lp[0] = (r*x + a*y)/(SQR(r) + SQR(a));
+  lp[1] = (r*y - a*x)/(SQR(r) + SQR(a));
+  lp[2] = z/r;
+
+  // transform covector (1,lp) to lab frame with inverse boost
+  Real vlp = v[0]*lp[0] + v[1]*lp[1] + v[2]*lp[2];
+  Real facl = (v2 > 0.0)? (gam - 1.0)*vlp/v2 : 0.0;
+  l_d[0] = gam*(1.0 - vlp);
+  for (int i=0; i<3; ++i) {
+    l_d[i+1] = lp[i] + facl*v[i] - gam*v[i];
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SuperposedKSMetric
+//! \brief covariant components of spacetime metric at (t,x,y,z).  Also returns the
+//! smallest of the rest-frame Kerr-Schild radii (in units of mass) of the two holes
+
+KOKKOS_INLINE_FUNCTION
+void SuperposedKSMetric(const BinaryKSData &bin, const Real t, const Real x,
+                        const Real y, const Real z, Real g[4][4], Real &rmin) {
+  Real pos[2][3], vel[2][3];
+  BinaryOrbit(bin, t, pos, vel);
+  for (int a=0; a<4; ++a) {
+    for (int b=0; b<4; ++b) {
+      g[a][b] = 0.0;
+    }
+    g[a][a] = (a == 0)? -1.0 : 1.0;
+  }
+  rmin = 1.0e30;
+  for (int n=0; n<2; ++n) {
+    Real dx[3] = {x - pos[n][0], y - pos[n][1], z - pos[n][2]};
+    Real hks, l_d[4], rks;
+    BoostedKS(bin.m[n], bin.a[n], dx, vel[n], hks, l_d, rks);
+    for (int a=0; a<4; ++a) {
+      for (int b=0; b<4; ++b) {
+        g[a][b] += 2.0*hks*l_d[a]*l_d[b];
+      }
+    }
+    rmin = fmin(rmin, rks/bin.m[n]);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SuperposedKSADM
+//! \brief ADM variables of superposed spacetime at (t,x,y,z).  The extrinsic curvature
+//!   K_ij = (D_i beta_j + D_j beta_i - d_t gamma_ij)/(2 alpha)
+//! uses centered differences of the analytic metric with step h in space and time.
+
+KOKKOS_INLINE_FUNCTION
+void SuperposedKSADM(const BinaryKSData &bin, const Real t, const Real x, const Real y,
+                     const Real z, const Real h, Real &alp, Real beta_u[3],
+                     Real g_dd[3][3], Real k_dd[3][3], Real &psi4, Real &rmin) {
+  Real g[4][4];
+  SuperposedKSMetric(bin, t, x, y, z, g, rmin);
+  Real beta_d[3];
+  for (int a=0; a<3; ++a) {
+    beta_d[a] = g[0][a+1];
+    for (int b=0; b<3; ++b) {
+      g_dd[a][b] = g[a+1][b+1];
+    }
+  }
+  Real det = SpatialDet(g_dd[0][0], g_dd[0][1], g_dd[0][2],
+                        g_dd[1][1], g_dd[1][2], g_dd[2][2]);
+  Real uxx, uxy, uxz, uyy, uyz, uzz;
+  SpatialInv(1.0/det, g_dd[0][0], g_dd[0][1], g_dd[0][2], g_dd[1][1], g_dd[1][2],
+             g_dd[2][2], &uxx, &uxy, &uxz, &uyy, &uyz, &uzz);
+  Real g_uu[3][3] = {{uxx, uxy, uxz}, {uxy, uyy, uyz}, {uxz, uyz, uzz}};
+  Real bsq = 0.0;
+  for (int a=0; a<3; ++a) {
+    beta_u[a] = 0.0;
+    for (int b=0; b<3; ++b) {
+      beta_u[a] += g_uu[a][b]*beta_d[b];
+    }
+    bsq += beta_u[a]*beta_d[a];
+  }
+  alp = sqrt(fmax(bsq - g[0][0], 1.0e-12));
+  psi4 = pow(det, 1.0/3.0);
+
+  // derivatives of spatial metric and covariant shift: dg[c][a][b] = d_c g_ab
+  Real dg[3][3][3], dbeta[3][3], dtg[3][3];
+  for (int c=0; c<3; ++c) {
+    Real xp[3] = {x, y, z}, xm[3] = {x, y, z};
+    xp[c] += h;
+    xm[c] -= h;
+    Real gp[4][4], gm[4][4], rdum;
+    SuperposedKSMetric(bin, t, xp[0], xp[1], xp[2], gp, rdum);
+    SuperposedKSMetric(bin, t, xm[0], xm[1], xm[2], gm, rdum);
+    for (int a=0; a<3; ++a) {
+      dbeta[c][a] = (gp[0][a+1] - gm[0][a+1])/(2.0*h);
+      for (int b=0; b<3; ++b) {
+        dg[c][a][b] = (gp[a+1][b+1] - gm[a+1][b+1])/(2.0*h);
+      }
+    }
+  }
+  {
+    Real gp[4][4], gm[4][4], rdum;
+    SuperposedKSMetric(bin, t + h, x, y, z, gp, rdum);
+    SuperposedKSMetric(bin, t - h, x, y, z, gm, rdum);
+    for (int a=0; a<3; ++a) {
+      for (int b=0; b<3; ++b) {
+        dtg[a][b] = (gp[a+1][b+1] - gm[a+1][b+1])/(2.0*h);
+      }
+    }
+  }
+
+  // Christoffel symbols of spatial metric, covariant derivative of shift, and K_ij
+  Real dbeta_cov[3][3];
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      dbeta_cov[a][b] = dbeta[a][b];
+      for (int c=0; c<3; ++c) {
+        Real gam_cab = 0.0;
+        for (int d=0; d<3; ++d) {
+          gam_cab += 0.5*g_uu[c][d]*(dg[a][b][d] + dg[b][a][d] - dg[d][a][b]);
+        }
+        dbeta_cov[a][b] -= gam_cab*beta_d[c];
+      }
+    }
+  }
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      k_dd[a][b] = (dbeta_cov[a][b] + dbeta_cov[b][a] - dtg[a][b])/(2.0*alp);
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \class SuperposedKS
+//! \brief sets ADM variables (and excision masks) from superposed spacetime
+
+class SuperposedKS {
+ public:
+  SuperposedKS(MeshBlockPack *ppack, ParameterInput *pin);
+  ~SuperposedKS() {}
+
+  BinaryKSData bin;
+  Real fd_step;          // step used for finite-difference derivatives of metric
+
+  void QueueSuperposedKSTasks();
+  TaskStatus CheckMetric(Driver *pdrive, int stage);
+  TaskStatus UpdateMetric(Driver *pdrive, int stage);
+  void SetMetric(Real time);
+
+ private:
+  MeshBlockPack* pmy_pack;
+  Real tstage;           // time of updated state in current stage, in units of dt
+  int nmb_changed;       // MeshBlocks created+deleted by AMR when metric was last set
+};
+
+} // namespace adm
+#endif // COORDINATES_SUPERPOSED_KS_HPP_
@@ -5,8 +5,10 @@
 //========================================================================================
 //! \file conduction.cpp
 //! \brief Implements functions for Conduction class. This includes isotropic thermal
-//! conduction, in which heat flux is proportional to negative local temperature gradient.
-//! Conduction may be added to Hydro and/or MHD independently.
+//! conduction, in which heat flux is proportional to negative local temperature gradient,
+//! and anisotropic conduction in MHD, in which heat only flows along field lines.
+//! Conduction may be added to Hydro and/or MHD independently.  The RKL2 super
+//! time-stepping integrator is implemented in conduction_sts.cpp.
 
 #include <float.h>
 #include <algorithm>
@@ -38,6 +40,19 @@ Real VL4Limiter(const Real a, const Real b, const Real c, const Real d) {
   return VanLeerLimiter(VanLeerLimiter(a,b),VanLeerLimiter(c,d));
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Real CellTemp()
+//! \brief Temperature in cell (m,k,j,i) from primitive variables
+KOKKOS_INLINE_FUNCTION
+Real CellTemp(const DvceArray5D<Real> &w0, const bool use_e, const Real gm1,
+              const int m, const int k, const int j, const int i) {
+  if (use_e) {
+    return w0(m,IEN,k,j,i)/w0(m,IDN,k,j,i)*gm1;
+  } else {
+    return w0(m,ITM,k,j,i);
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn Real KappaTemp()
 //! \brief Temperature-dependent conductivity given by Parker (1953) and Spitzer (1962)
@@ -81,6 +96,37 @@ Conduction::Conduction(std::string block, MeshBlockPack *pp, ParameterInput *pin
   kappa_ceiling = pin->GetOrAddReal(block,"cond_ceiling",
                   static_cast<Real>(std::numeric_limits<float>::max()));
   sat_hflux = pin->GetOrAddBoolean(block,"sat_hflux",false);
+  is_mhd = (block.compare("mhd") == 0);
+
+  // anisotropic conduction requires magnetic field
+  aniso = pin->GetOrAddBoolean(block,"cond_aniso",false);
+  if (aniso && !(is_mhd)) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "Anisotropic thermal conduction (cond_aniso) only works with MHD"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // choice of integrator: explicit in each stage, or operator-split RKL2
+  std::string integrator = pin->GetOrAddString(block,"cond_integrator","explicit");
+  if (integrator.compare("explicit") == 0) {
+    use_sts = false;
+  } else if (integrator.compare("rkl2") == 0) {
+    use_sts = true;
+  } else {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "cond_integrator = '" << integrator << "' not implemented, "
+              << "use 'explicit' or 'rkl2'" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  sts_max_stages = pin->GetOrAddInteger(block,"cond_sts_max_stages",50);
+  if (use_sts && sts_max_stages < 2) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "cond_sts_max_stages must be at least 2" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  sts_nstages = 0;
+  dt_expl = static_cast<Real>(std::numeric_limits<float>::max());
 }
 
 //----------------------------------------------------------------------------------------
@@ -399,13 +445,206 @@ void Conduction::TempDependentHeatFlux(const DvceArray5D<Real> &w0, const EOS_Da
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void AddHeatFlux()
+//! \brief Adds heat flux to face-centered fluxes of conserved variables in MHD, either
+//! along magnetic field lines or isotropic.
+
+void Conduction::AddHeatFlux(const DvceArray5D<Real> &w0, const DvceFaceFld4D<Real> &b0,
+  const DvceArray5D<Real> &bcc, const EOS_Data &eos, DvceFaceFld5D<Real> &flx) {
+  if (aniso) {
+    if (tdep_kappa || kappa > 0.0) {
+      AnisotropicHeatFlux(w0, b0, bcc, eos, flx);
+    }
+  } else {
+    AddHeatFlux(w0, eos, flx);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void AnisotropicHeatFlux()
+//! \brief Adds heat flux along magnetic field lines, q = -kappa b (b.grad T), to
+//! face-centered fluxes of conserved variables.  The normal component of B is the
+//! face-centered field, transverse components are averages of the cell-centered field.
+//! Transverse temperature gradients at faces are computed with the monotonized
+//! (van Leer) limiter of Sharma & Hammett (2007), which ensures heat never flows from
+//! cold to hot.  Conductivity may be constant or temperature dependent, and the flux may
+//! be saturated.
+
+void Conduction::AnisotropicHeatFlux(const DvceArray5D<Real> &w0,
+  const DvceFaceFld4D<Real> &b0, const DvceArray5D<Real> &bcc, const EOS_Data &eos,
+  DvceFaceFld5D<Real> &flx) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto size = pmy_pack->pmb->mb_size;
+  const bool use_e = eos.use_e;
+  const bool sat_hflux_ = sat_hflux;
+  const bool tdepkappa = tdep_kappa;
+  const bool multi_d = pmy_pack->pmesh->multi_d;
+  const bool three_d = pmy_pack->pmesh->three_d;
+  Real gm1 = eos.gamma-1.0;
+  Real kappa0 = kappa;
+  Real kappaceil = kappa_ceiling;
+  Real temp_unit = pmy_pack->punit->temperature_cgs();
+  Real kappa_unit = pmy_pack->punit->pressure_cgs()*pmy_pack->punit->velocity_cgs()*
+                    pmy_pack->punit->length_cgs()/pmy_pack->punit->temperature_cgs();
+
+  //--------------------------------------------------------------------------------------
+  // fluxes in x1-direction
+
+  auto &flx1 = flx.x1f;
+  auto &b1 = b0.x1f;
+
+  par_for("aconduct1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real temp_l = CellTemp(w0, use_e, gm1, m, k, j, i-1);
+    Real temp_r = CellTemp(w0, use_e, gm1, m, k, j, i);
+    Real dtempdx1 = (temp_r - temp_l)/size.d_view(m).dx1;
+    Real dtempdx2 = 0.0, dtempdx3 = 0.0;
+    Real bx = b1(m,k,j,i);
+    Real by = 0.5*(bcc(m,IBY,k,j,i-1) + bcc(m,IBY,k,j,i));
+    Real bz = 0.5*(bcc(m,IBZ,k,j,i-1) + bcc(m,IBZ,k,j,i));
+    if (multi_d) {
+      dtempdx2 = VL4Limiter(CellTemp(w0, use_e, gm1, m, k, j+1, i) - temp_r,
+                            temp_r - CellTemp(w0, use_e, gm1, m, k, j-1, i),
+                            CellTemp(w0, use_e, gm1, m, k, j+1, i-1) - temp_l,
+                            temp_l - CellTemp(w0, use_e, gm1, m, k, j-1, i-1))
+                 /size.d_view(m).dx2;
+    }
+    if (three_d) {
+      dtempdx3 = VL4Limiter(CellTemp(w0, use_e, gm1, m, k+1, j, i) - temp_r,
+                            temp_r - CellTemp(w0, use_e, gm1, m, k-1, j, i),
+                            CellTemp(w0, use_e, gm1, m, k+1, j, i-1) - temp_l,
+                            temp_l - CellTemp(w0, use_e, gm1, m, k-1, j, i-1))
+                 /size.d_view(m).dx3;
+    }
+    Real bsq = SQR(bx) + SQR(by) + SQR(bz);
+    if (bsq > 0.0) {
+      Real kappaf = kappa0;
+      if (tdepkappa) {
+        kappaf = 0.5*(KappaTemp(temp_unit*temp_l,kappaceil)+
+                 KappaTemp(temp_unit*temp_r,kappaceil))/kappa_unit;
+      }
+      Real bdotgradt = bx*dtempdx1 + by*dtempdx2 + bz*dtempdx3;
+      Real hflx = kappaf*bx*bdotgradt/bsq;
+      if (sat_hflux_) {
+        Real pres_l = w0(m,IDN,k,j,i-1)*temp_l;
+        Real pres_r = w0(m,IDN,k,j,i)*temp_r;
+        Real pres_cs = 0.5*(pres_l*sqrt(temp_l)+pres_r*sqrt(temp_r));
+        hflx /= (1.0 + kappaf*fabs(bdotgradt)/sqrt(bsq)/(1.5*pres_cs));
+      }
+      flx1(m,IEN,k,j,i) -= hflx;
+    }
+  });
+  if (pmy_pack->pmesh->one_d) {return;}
+
+  //--------------------------------------------------------------------------------------
+  // fluxes in x2-direction
+
+  auto &flx2 = flx.x2f;
+  auto &b2 = b0.x2f;
+
+  par_for("aconduct2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real temp_l = CellTemp(w0, use_e, gm1, m, k, j-1, i);
+    Real temp_r = CellTemp(w0, use_e, gm1, m, k, j, i);
+    Real dtempdx2 = (temp_r - temp_l)/size.d_view(m).dx2;
+    Real dtempdx1 = 0.0, dtempdx3 = 0.0;
+    Real bx = 0.5*(bcc(m,IBX,k,j-1,i) + bcc(m,IBX,k,j,i));
+    Real by = b2(m,k,j,i);
+    Real bz = 0.5*(bcc(m,IBZ,k,j-1,i) + bcc(m,IBZ,k,j,i));
+    dtempdx1 = VL4Limiter(CellTemp(w0, use_e, gm1, m, k, j, i+1) - temp_r,
+                          temp_r - CellTemp(w0, use_e, gm1, m, k, j, i-1),
+                          CellTemp(w0, use_e, gm1, m, k, j-1, i+1) - temp_l,
+                          temp_l - CellTemp(w0, use_e, gm1, m, k, j-1, i-1))
+               /size.d_view(m).dx1;
+    if (three_d) {
+      dtempdx3 = VL4Limiter(CellTemp(w0, use_e, gm1, m, k+1, j, i) - temp_r,
+                            temp_r - CellTemp(w0, use_e, gm1, m, k-1, j, i),
+                            CellTemp(w0, use_e, gm1, m, k+1, j-1, i) - temp_l,
+                            temp_l - CellTemp(w0, use_e, gm1, m, k-1, j-1, i))
+                 /size.d_view(m).dx3;
+    }
+    Real bsq = SQR(bx) + SQR(by) + SQR(bz);
+    if (bsq > 0.0) {
+      Real kappaf = kappa0;
+      if (tdepkappa) {
+        kappaf = 0.5*(KappaTemp(temp_unit*temp_l,kappaceil)+
+                 KappaTemp(temp_unit*temp_r,kappaceil))/kappa_unit;
+      }
+      Real bdotgradt = bx*dtempdx1 + by*dtempdx2 + bz*dtempdx3;
+      Real hflx = kappaf*by*bdotgradt/bsq;
+      if (sat_hflux_) {
+        Real pres_l = w0(m,IDN,k,j-1,i)*temp_l;
+        Real pres_r = w0(m,IDN,k,j,i)*temp_r;
+        Real pres_cs = 0.5*(pres_l*sqrt(temp_l)+pres_r*sqrt(temp_r));
+        hflx /= (1.0 + kappaf*fabs(bdotgradt)/sqrt(bsq)/(1.5*pres_cs));
+      }
+      flx2(m,IEN,k,j,i) -= hflx;
+    }
+  });
+  if (pmy_pack->pmesh->two_d) {return;}
+
+  //--------------------------------------------------------------------------------------
+  // fluxes in x3-direction
+
+  auto &flx3 = flx.x3f;
+  auto &b3 = b0.x3f;
+
+  par_for("aconduct3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real temp_l = CellTemp(w0, use_e, gm1, m, k-1, j, i);
+    Real temp_r = CellTemp(w0, use_e, gm1, m, k, j, i);
+    Real dtempdx3 = (temp_r - temp_l)/size.d_view(m).dx3;
+    Real bx = 0.5*(bcc(m,IBX,k-1,j,i) + bcc(m,IBX,k,j,i));
+    Real by = 0.5*(bcc(m,IBY,k-1,j,i) + bcc(m,IBY,k,j,i));
+    Real bz = b3(m,k,j,i);
+    Real dtempdx1 = VL4Limiter(CellTemp(w0, use_e, gm1, m, k, j, i+1) - temp_r,
+                               temp_r - CellTemp(w0, use_e, gm1, m, k, j, i-1),
+                               CellTemp(w0, use_e, gm1, m, k-1, j, i+1) - temp_l,
+                               temp_l - CellTemp(w0, use_e, gm1, m, k-1, j, i-1))
+                    /size.d_view(m).dx1;
+    Real dtempdx2 = VL4Limiter(CellTemp(w0, use_e, gm1, m, k, j+1, i) - temp_r,
+                               temp_r - CellTemp(w0, use_e, gm1, m, k, j-1, i),
+                               CellTemp(w0, use_e, gm1, m, k-1, j+1, i) - temp_l,
+                               temp_l - CellTemp(w0, use_e, gm1, m, k-1, j-1, i))
+                    /size.d_view(m).dx2;
+    Real bsq = SQR(bx) + SQR(by) + SQR(bz);
+    if (bsq > 0.0) {
+      Real kappaf = kappa0;
+      if (tdepkappa) {
+        kappaf = 0.5*(KappaTemp(temp_unit*temp_l,kappaceil)+
+                 KappaTemp(temp_unit*temp_r,kappaceil))/kappa_unit;
+      }
+      Real bdotgradt = bx*dtempdx1 + by*dtempdx2 + bz*dtempdx3;
+      Real hflx = kappaf*bz*bdotgradt/bsq;
+      if (sat_hflux_) {
+        Real pres_l = w0(m,IDN,k-1,j,i)*temp_l;
+        Real pres_r = w0(m,IDN,k,j,i)*temp_r;
+        Real pres_cs = 0.5*(pres_l*sqrt(temp_l)+pres_r*sqrt(temp_r));
+        hflx /= (1.0 + kappaf*fabs(bdotgradt)/sqrt(bsq)/(1.5*pres_cs));
+      }
+      flx3(m,IEN,k,j,i) -= hflx;
+    }
+  });
+
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Conduction::NewTimeStep()
-//! \brief Compute new time step for thermal conduction.
+//! \brief Compute new time step for thermal conduction.  The explicit (parabolic) limit
+//! is stored in dt_expl.  With RKL2 super time-stepping the time step is instead limited
+//! by the stability of sts_max_stages stages, dt < dt_expl*(s^2 + s - 2)/4.
 
 void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_data) {
   if (sat_hflux == true) {
     dtnew = static_cast<Real>(std::numeric_limits<float>::max());
+    dt_expl = dtnew;
     return;
   }
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -471,6 +710,11 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   }, Kokkos::Min<Real>(dtnew));
 
   dtnew *= fac;
+  dt_expl = dtnew;
+  if (use_sts) {
+    Real smax = static_cast<Real>(sts_max_stages);
+    dtnew = dt_expl*(SQR(smax) + smax - 2.0)/4.0;
+  }
 
   return;
 }
@@ -7,12 +7,30 @@
 //========================================================================================
 //! \file conduction.hpp
 //! \brief Contains data and functions that implement various formulations for conduction.
-//  Currently only isotropic conduction implemented
+//  Implements isotropic conduction (Hydro and MHD), and anisotropic conduction along
+//  magnetic field lines (MHD only) with limited transverse temperature gradients
+//  following Sharma & Hammett (2007), JCP 227, 123.  Conductivity may be constant or
+//  temperature dependent, and the heat flux may be saturated.
+//
+//  Heat fluxes are either added to the fluid fluxes in each stage (explicit, limited by
+//  the parabolic time step), or applied in an operator-split step before the main time
+//  integrator with the second-order Runge-Kutta-Legendre super time-stepping method
+//  (RKL2) of Meyer, Balsara & Aslam (2014), JCP 257, 594.
+//
+//  Input parameters in <hydro> or <mhd> block, in addition to conductivity etc.:
+//    cond_aniso           true for conduction only along field lines (MHD, default false)
+//    cond_integrator      explicit (default) or rkl2
+//    cond_sts_max_stages  maximum number of RKL2 stages per time step (default 50); the
+//                         time step is limited so that this is not exceeded
 
 #include <string>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
+
+// forward declarations
+class Driver;
 
 //----------------------------------------------------------------------------------------
 //! \class Conduction
@@ -29,6 +47,11 @@ class Conduction {
   bool tdep_kappa;    // temperature-dependent conductivity
   Real kappa_ceiling; // ceiling of thermal conductivity
   bool sat_hflux;     // saturtion of heat flux
+  bool aniso;         // conduction only along magnetic field lines
+  bool use_sts;       // operator-split RKL2 super time-stepping
+  int sts_max_stages; // maximum number of RKL2 stages
+  int sts_nstages;    // number of RKL2 stages used in last time step
+  Real dt_expl;       // explicit (parabolic) stability limit on time step
 
   // function to add heat fluxes to Hydro and/or MHD fluxes
   void AddHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
@@ -37,9 +60,22 @@ class Conduction {
                          DvceFaceFld5D<Real> &f);
   void TempDependentHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
                              DvceFaceFld5D<Real> &f);
+  void AddHeatFlux(const DvceArray5D<Real> &w, const DvceFaceFld4D<Real> &b,
+                   const DvceArray5D<Real> &bcc, const EOS_Data &eos,
+                   DvceFaceFld5D<Real> &f);
+  void AnisotropicHeatFlux(const DvceArray5D<Real> &w, const DvceFaceFld4D<Real> &b,
+                           const DvceArray5D<Real> &bcc, const EOS_Data &eos,
+                           DvceFaceFld5D<Real> &f);
   void NewTimeStep(const DvceArray5D<Real> &w, const EOS_Data &eos_data);
+  TaskStatus SuperTimeStep(Driver *pdrive, int stage);
 
  private:
   MeshBlockPack* pmy_pack;
+  bool is_mhd;                // true if this Conduction belongs to MHD
+  DvceArray5D<Real> sts_u;    // energy at start of step, dt*L(Y0), and Y_{j-2} for RKL2
+
+  void STSHeatFlux();
+  void STSUpdate(const int j, const Real dt, const Real mu, const Real nu,
+                 const Real mu_tilde, const Real gamma_tilde);
 };
 #endif // DIFFUSION_CONDUCTION_HPP_
@@ -0,0 +1,139 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file conduction_sts.cpp
+//! \brief Operator-split update of the total energy by thermal conduction using the
+//! second-order Runge-Kutta-Legendre super time-stepping method (RKL2) of Meyer, Balsara
+//! & Aslam (2014), JCP 257, 594.  With s stages, the scheme is stable for time steps up
+//! to dt_expl*(s^2 + s - 2)/4, so the number of stages grows only as sqrt(dt/dt_expl).
+//! Ghost cells and primitive variables are updated after every stage.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "conduction.hpp"
+#include "rkl2.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Conduction::SuperTimeStep()
+//! \brief Advances the total energy by thermal conduction over the full time step dt with
+//! the RKL2 method.  Added to the "before_timeintegrator" task list when
+//! cond_integrator = rkl2.  Every stage requires a complete exchange of ghost cells, so
+//! this task blocks until all communications are finished.
+
+TaskStatus Conduction::SuperTimeStep(Driver *pdrive, int stage) {
+  Real dt = pmy_pack->pmesh->dt;
+  int s = rkl2::NumberOfStages(dt, dt_expl);
+  sts_nstages = s;
+
+  // (re)allocate scratch array, since number of MeshBlocks may change with AMR
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int nmb = pmy_pack->nmb_thispack;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  if (static_cast<int>(sts_u.extent(0)) != nmb) {
+    Kokkos::realloc(sts_u, nmb, 3, ncells3, ncells2, ncells1);
+  }
+
+  rkl2::Integrate(s, [&](const int j, const Real mu, const Real nu,
+                          const Real mu_tilde, const Real gamma_tilde) {
+    STSHeatFlux();
+    STSUpdate(j, dt, mu, nu, mu_tilde, gamma_tilde);
+    if (is_mhd) {
+      rkl2::UpdateGhostCells(pmy_pack->pmhd, pdrive);
+    } else {
+      rkl2::UpdateGhostCells(pmy_pack->phydro, pdrive);
+    }
+  });
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Conduction::STSHeatFlux()
+//! \brief Sets energy component of fluxes in Hydro or MHD to heat flux only
+
+void Conduction::STSHeatFlux() {
+  if (is_mhd) {
+    auto pmhd = pmy_pack->pmhd;
+    auto &flx = pmhd->uflx;
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x1f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x2f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x3f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    AddHeatFlux(pmhd->w0, pmhd->b0, pmhd->bcc0, pmhd->peos->eos_data, flx);
+  } else {
+    auto phydro = pmy_pack->phydro;
+    auto &flx = phydro->uflx;
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x1f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x2f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x3f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    AddHeatFlux(phydro->w0, phydro->peos->eos_data, flx);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Conduction::STSUpdate()
+//! \brief Stage j of the RKL2 method for the total energy E, with L(E) = -div(q):
+//!   Y_1 = Y_0 + mu_tilde_1 dt L(Y_0)
+//!   Y_j = mu Y_{j-1} + nu Y_{j-2} + (1 - mu - nu) Y_0 + mu_tilde dt L(Y_{j-1})
+//!         + gamma_tilde dt L(Y_0)
+//! Y_0, dt L(Y_0), and Y_{j-2} are stored in sts_u.
+
+void Conduction::STSUpdate(const int j, const Real dt, const Real mu, const Real nu,
+                           const Real mu_tilde, const Real gamma_tilde) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto u0 = (is_mhd)? pmy_pack->pmhd->u0 : pmy_pack->phydro->u0;
+  auto flx1 = (is_mhd)? pmy_pack->pmhd->uflx.x1f : pmy_pack->phydro->uflx.x1f;
+  auto flx2 = (is_mhd)? pmy_pack->pmhd->uflx.x2f : pmy_pack->phydro->uflx.x2f;
+  auto flx3 = (is_mhd)? pmy_pack->pmhd->uflx.x3f : pmy_pack->phydro->uflx.x3f;
+  auto sts_u_ = sts_u;
+
+  par_for("cond_sts", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j_, const int i) {
+    Real divq = (flx1(m,IEN,k,j_,i+1) - flx1(m,IEN,k,j_,i))/size.d_view(m).dx1;
+    if (multi_d) {
+      divq += (flx2(m,IEN,k,j_+1,i) - flx2(m,IEN,k,j_,i))/size.d_view(m).dx2;
+    }
+    if (three_d) {
+      divq += (flx3(m,IEN,k+1,j_,i) - flx3(m,IEN,k,j_,i))/size.d_view(m).dx3;
+    }
+    Real ydt = -dt*divq;
+    Real y1 = u0(m,IEN,k,j_,i);
+    if (j == 1) {
+      sts_u_(m,0,k,j_,i) = y1;
+      sts_u_(m,1,k,j_,i) = ydt;
+      sts_u_(m,2,k,j_,i) = y1;
+      u0(m,IEN,k,j_,i) = y1 + mu_tilde*ydt;
+    } else {
+      Real y0 = sts_u_(m,0,k,j_,i);
+      u0(m,IEN,k,j_,i) = mu*y1 + nu*sts_u_(m,2,k,j_,i) + (1.0 - mu - nu)*y0
+                         + mu_tilde*ydt + gamma_tilde*sts_u_(m,1,k,j_,i);
+      sts_u_(m,2,k,j_,i) = y1;
+    }
+  });
+  return;
+}
@@ -9,11 +9,13 @@
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <string>
 
 // Athena++ headers
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
 #include "resistivity.hpp"
 #include "current_density.hpp"
 
@@ -21,12 +23,56 @@
 // ctor: also calls Resistivity base class constructor
 
 Resistivity::Resistivity(MeshBlockPack *pp, ParameterInput *pin) :
-  pmy_pack(pp) {
-  // Read parameters for Ohmic diffusion (if any)
-  eta_ohm = pin->GetReal("mhd","ohmic_resistivity");
+  pmy_pack(pp),
+  jedge("jedge",1,1,1,1),
+  e_ni("e_ni",1,1,1,1),
+  sts_b("sts_b",1,1,1,1,1),
+  sts_e("sts_e",1,1,1,1,1) {
+  // Read parameters for Ohmic diffusion, Hall effect, and ambipolar diffusion (if any)
+  eta_ohm = pin->GetOrAddReal("mhd","ohmic_resistivity",0.0);
+  q_hall = pin->GetOrAddReal("mhd","hall_coeff",0.0);
+  q_ambi = pin->GetOrAddReal("mhd","ambipolar_coeff",0.0);
+  ion_coeff = pin->GetOrAddReal("mhd","ion_coeff",1.0);
+  ion_index = pin->GetOrAddReal("mhd","ion_index",1.0);
+  if ((q_hall != 0.0 || q_ambi != 0.0) && (ion_coeff <= 0.0)) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "ion_coeff must be positive with Hall effect or ambipolar diffusion"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if ((q_hall != 0.0 || q_ambi != 0.0) &&
+      (pp->pcoord->is_special_relativistic || pp->pcoord->is_general_relativistic)) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "Hall effect and ambipolar diffusion only work in non-relativistic MHD"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // choice of integrators: explicit in each stage, or operator-split
+  std::string integrator = pin->GetOrAddString("mhd","ambipolar_integrator","explicit");
+  if (integrator.compare("explicit") == 0) {
+    ambi_sts = false;
+  } else if (integrator.compare("rkl2") == 0) {
+    ambi_sts = (q_ambi > 0.0);
+  } else {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "ambipolar_integrator = '" << integrator << "' not implemented, "
+              << "use 'explicit' or 'rkl2'" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  ambi_max_stages = pin->GetOrAddInteger("mhd","ambipolar_sts_max_stages",50);
+  if (ambi_sts && ambi_max_stages < 2) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "ambipolar_sts_max_stages must be at least 2" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  ambi_nstages = 0;
+  dt_hall = static_cast<Real>(std::numeric_limits<float>::max());
+  dt_ambi = dt_hall;
 
-  // resistive timestep on MeshBlock(s) in this pack
-  dtnew = std::numeric_limits<float>::max();
+  // Ohmic timestep on MeshBlock(s) in this pack (Hall and ambipolar timesteps depend on
+  // the solution, and are computed in NewTimeStep())
+  dt_ohm = std::numeric_limits<float>::max();
   auto size = pmy_pack->pmb->mb_size;
   Real fac;
   if (pp->pmesh->three_d) {
@@ -36,11 +82,18 @@ Resistivity::Resistivity(MeshBlockPack *pp, ParameterInput *pin) :
   } else {
     fac = 0.5;
   }
-  for (int m=0; m<(pp->nmb_thispack); ++m) {
-    dtnew = std::min(dtnew, fac*SQR(size.h_view(m).dx1)/eta_ohm);
-    if (pp->pmesh->multi_d) {dtnew = std::min(dtnew,fac*SQR(size.h_view(m).dx2)/eta_ohm);}
-    if (pp->pmesh->three_d) {dtnew = std::min(dtnew,fac*SQR(size.h_view(m).dx3)/eta_ohm);}
+  if (eta_ohm > 0.0) {
+    for (int m=0; m<(pp->nmb_thispack); ++m) {
+      dt_ohm = std::min(dt_ohm, fac*SQR(size.h_view(m).dx1)/eta_ohm);
+      if (pp->pmesh->multi_d) {
+        dt_ohm = std::min(dt_ohm, fac*SQR(size.h_view(m).dx2)/eta_ohm);
+      }
+      if (pp->pmesh->three_d) {
+        dt_ohm = std::min(dt_ohm, fac*SQR(size.h_view(m).dx3)/eta_ohm);
+      }
+    }
   }
+  dtnew = dt_ohm;
 }
 
 //----------------------------------------------------------------------------------------
@@ -49,6 +102,74 @@ Resistivity::Resistivity(MeshBlockPack *pp, ParameterInput *pin) :
 Resistivity::~Resistivity() {
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Resistivity::NewTimeStep()
+//! \brief Compute new time step for non-ideal MHD.  The explicit limits from the Hall
+//! effect and ambipolar diffusion, dx^2/eta, are stored in dt_hall and dt_ambi.  With
+//! the operator-split RKL2 integrator for ambipolar diffusion, its limit is instead set
+//! by the stability of ambipolar_sts_max_stages RKL2 stages in each half time step.
+
+void Resistivity::NewTimeStep(const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc) {
+  dtnew = dt_ohm;
+  if (q_hall == 0.0 && q_ambi == 0.0) {return;}
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &multi_d = pmy_pack->pmesh->multi_d;
+  auto &three_d = pmy_pack->pmesh->three_d;
+  auto &size = pmy_pack->pmb->mb_size;
+  Real qh = fabs(q_hall), qa = q_ambi;
+  Real ci = ion_coeff, ai = ion_index;
+  Real fac;
+  if (pmy_pack->pmesh->three_d) {
+    fac = 1.0/6.0;
+  } else if (pmy_pack->pmesh->two_d) {
+    fac = 0.25;
+  } else {
+    fac = 0.5;
+  }
+
+  Real dth = static_cast<Real>(std::numeric_limits<float>::max());
+  Real dta = dth;
+  Kokkos::parallel_reduce("resist_newdt", Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &min_dth, Real &min_dta) {
+    // compute m,k,j,i indices of thread and call function
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+
+    Real dx2 = SQR(size.d_view(m).dx1);
+    if (multi_d) {dx2 = fmin(dx2, SQR(size.d_view(m).dx2));}
+    if (three_d) {dx2 = fmin(dx2, SQR(size.d_view(m).dx3));}
+    Real dens = w(m,IDN,k,j,i);
+    Real rhoi = ci*pow(dens, ai);
+    Real b2 = SQR(bcc(m,IBX,k,j,i)) + SQR(bcc(m,IBY,k,j,i)) + SQR(bcc(m,IBZ,k,j,i));
+    Real eta_h = qh*sqrt(b2)/rhoi;
+    Real eta_a = qa*b2/(dens*rhoi);
+    if (eta_h > 0.0) {min_dth = fmin(min_dth, dx2/eta_h);}
+    if (eta_a > 0.0) {min_dta = fmin(min_dta, dx2/eta_a);}
+  }, Kokkos::Min<Real>(dth), Kokkos::Min<Real>(dta));
+
+  dt_hall = fac*dth;
+  dt_ambi = fac*dta;
+  dtnew = std::min(dtnew, dt_hall);
+  if (ambi_sts) {
+    Real smax = static_cast<Real>(ambi_max_stages);
+    dtnew = std::min(dtnew, dt_ambi*(SQR(smax) + smax - 2.0)/2.0);
+  } else {
+    dtnew = std::min(dtnew, dt_ambi);
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn OhmicEField()
 //  \brief Adds electric field from Ohmic resistivity to corner-centered electric field
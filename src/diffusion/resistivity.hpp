@@ -7,11 +7,29 @@
 //========================================================================================
 //! \file resistivity.hpp
 //  \brief Contains data and functions that implement various non-ideal MHD (resistive)
-//  processes, such as Ohmic diffusion. TODO(@user): add ambipolar diffusion, Hall effect
+//  processes: Ohmic diffusion, the Hall effect, and ambipolar diffusion.  In Ohm's law
+//    E = -(v X B) + eta_O J + eta_H (J X b) - eta_A (J X b) X b,     b = B/|B|
+//  with the Hall and ambipolar diffusivities depending on density, field strength, and
+//  ionization through the ion density rho_i = ion_coeff*rho^ion_index:
+//    eta_H = hall_coeff*|B|/rho_i,   eta_A = ambipolar_coeff*B^2/(rho*rho_i)
+//
+//  The Hall term is always added to the EMF in each stage of the main integrator, so
+//  the time step is limited by the explicit Hall limit dx^2/eta_H (use rk3, whose
+//  stability region contains part of the imaginary axis, for the undamped whistler
+//  modes).  Ambipolar diffusion is either added in the same way, or Strang split around
+//  the main integrator and advanced with RKL2 super time-stepping (as for conduction).
+//
+//  Input parameters in <mhd> block, in addition to coefficients above:
+//    ambipolar_integrator      explicit (default) or rkl2
+//    ambipolar_sts_max_stages  maximum number of RKL2 stages per half step (default 50)
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/meshblock.hpp"
+#include "tasklist/task_list.hpp"
+
+// forward declarations
+class Driver;
 
 //----------------------------------------------------------------------------------------
 //! \class Resistivity
@@ -25,13 +43,36 @@ class Resistivity {
   // data
   Real dtnew;
   Real eta_ohm;
+  Real q_hall;             // coefficient of Hall diffusivity
+  Real q_ambi;             // coefficient of ambipolar diffusivity
+  Real ion_coeff;          // ion density rho_i = ion_coeff*rho^ion_index
+  Real ion_index;
+  bool ambi_sts;           // operator-split RKL2 update of ambipolar diffusion
+  int ambi_max_stages;     // maximum number of RKL2 stages
+  int ambi_nstages;        // number of RKL2 stages used in last half step
+  Real dt_hall;            // explicit stability limit on time step from Hall effect
+  Real dt_ambi;            // explicit stability limit from ambipolar diffusion
 
   // functions to add resistive E-Field and energy flux
   void OhmicEField(const DvceFaceFld4D<Real> &b0, DvceEdgeFld4D<Real> &efld);
   void OhmicEnergyFlux(const DvceFaceFld4D<Real> &b, DvceFaceFld5D<Real> &flx);
+  void NonIdealEField(const DvceArray5D<Real> &w, const DvceFaceFld4D<Real> &b,
+                      const DvceArray5D<Real> &bcc, const bool hall, const bool ambi);
+  void AddNonIdealEField(DvceEdgeFld4D<Real> &efld);
+  void NonIdealEnergyFlux(const DvceArray5D<Real> &bcc, DvceFaceFld5D<Real> &flx);
+  void NewTimeStep(const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc);
+  TaskStatus AmbipolarSuperTimeStep(Driver *pdrive, int stage);
 
  private:
   MeshBlockPack* pmy_pack;
+  Real dt_ohm;                // explicit stability limit from Ohmic diffusion
+  DvceEdgeFld4D<Real> jedge;  // current density at cell edges
+  DvceEdgeFld4D<Real> e_ni;   // Hall and/or ambipolar E-field at cell edges
+  DvceFaceFld5D<Real> sts_b;  // B at start of step, dt*L(B0), and B_{j-2}
+  DvceArray5D<Real> sts_e;    // same for total energy
+
+  void SplitUpdate(const bool first, const Real dt, const Real c0, const Real c1,
+                   const Real c2, const Real c3, const Real c4);
 };
 
 #endif // DIFFUSION_RESISTIVITY_HPP_
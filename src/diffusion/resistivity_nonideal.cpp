@@ -0,0 +1,247 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file resistivity_nonideal.cpp
+//! \brief Electric fields and Poynting fluxes from the Hall effect and ambipolar
+//! diffusion.  The current density is computed at cell edges (where it is centered like
+//! the EMF), and the other two components of J, the cell-centered B, and the density are
+//! averaged to each edge, so that the non-ideal EMF can be added to the corner-centered
+//! electric field used in the CT update.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "resistivity.hpp"
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn Real NonIdealE()
+//! \brief Component n of the Hall plus ambipolar electric field at a point,
+//!   E_H = (q_H/rho_i) (J X B),   E_A = (q_A/(rho rho_i)) (B^2 J - (J.B) B)
+//! which is E_H = eta_H (J X b) and E_A = -eta_A (J X b) X b, but is well defined at B=0
+
+KOKKOS_INLINE_FUNCTION
+Real NonIdealE(const int n, const Real jj[3], const Real bb[3], const Real dens,
+               const Real qh, const Real qa, const Real ci, const Real ai) {
+  int n1 = (n + 1) % 3, n2 = (n + 2) % 3;
+  Real rhoi = ci*pow(dens, ai);
+  Real e = (qh/rhoi)*(jj[n1]*bb[n2] - jj[n2]*bb[n1]);
+  if (qa > 0.0) {
+    Real b2 = bb[0]*bb[0] + bb[1]*bb[1] + bb[2]*bb[2];
+    Real jdotb = jj[0]*bb[0] + jj[1]*bb[1] + jj[2]*bb[2];
+    e += qa/(dens*rhoi)*(b2*jj[n] - jdotb*bb[n]);
+  }
+  return e;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Resistivity::NonIdealEField()
+//! \brief Computes the Hall (if hall=true) and/or ambipolar (if ambi=true) electric field
+//! at all edges of the active zones, and stores it in e_ni.  Edges in the ignorable
+//! directions of 1D/2D problems are set to the same values (as in OhmicEField()).
+
+void Resistivity::NonIdealEField(const DvceArray5D<Real> &w, const DvceFaceFld4D<Real> &b,
+                                 const DvceArray5D<Real> &bcc, const bool hall,
+                                 const bool ambi) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb = pmy_pack->nmb_thispack;
+  int nmb1 = nmb - 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  // (re)allocate edge arrays, since number of MeshBlocks may change with AMR
+  if (static_cast<int>(jedge.x1e.extent(0)) != nmb) {
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(jedge.x1e, nmb, ncells3+1, ncells2+1, ncells1);
+    Kokkos::realloc(jedge.x2e, nmb, ncells3+1, ncells2, ncells1+1);
+    Kokkos::realloc(jedge.x3e, nmb, ncells3, ncells2+1, ncells1+1);
+    Kokkos::realloc(e_ni.x1e, nmb, ncells3+1, ncells2+1, ncells1);
+    Kokkos::realloc(e_ni.x2e, nmb, ncells3+1, ncells2, ncells1+1);
+    Kokkos::realloc(e_ni.x3e, nmb, ncells3, ncells2+1, ncells1+1);
+  }
+
+  // capture class variables for the kernels
+  auto j1 = jedge.x1e;
+  auto j2 = jedge.x2e;
+  auto j3 = jedge.x3e;
+  auto e1 = e_ni.x1e;
+  auto e2 = e_ni.x2e;
+  auto e3 = e_ni.x3e;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  Real qh = (hall)? q_hall : 0.0;
+  Real qa = (ambi)? q_ambi : 0.0;
+  Real ci = ion_coeff, ai = ion_index;
+  int dj = (multi_d)? 1 : 0;
+  int dk = (three_d)? 1 : 0;
+
+  // current density at edges, including one layer of ghost edges for the averages below
+  int jl = js - dj, ju = je + dj;
+  int kl = ks - dk, ku = ke + dk;
+  par_for("jedge", DevExeSpace(), 0, nmb1, kl, ku, jl, ju, is-1, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real idx1 = 1.0/mbsize.d_view(m).dx1;
+    j1(m,k,j,i) = 0.0;
+    j2(m,k,j,i) = -(b.x3f(m,k,j,i) - b.x3f(m,k,j,i-1))*idx1;
+    j3(m,k,j,i) =  (b.x2f(m,k,j,i) - b.x2f(m,k,j,i-1))*idx1;
+    if (multi_d) {
+      Real idx2 = 1.0/mbsize.d_view(m).dx2;
+      j1(m,k,j,i) += (b.x3f(m,k,j,i) - b.x3f(m,k,j-1,i))*idx2;
+      j3(m,k,j,i) -= (b.x1f(m,k,j,i) - b.x1f(m,k,j-1,i))*idx2;
+    }
+    if (three_d) {
+      Real idx3 = 1.0/mbsize.d_view(m).dx3;
+      j1(m,k,j,i) -= (b.x2f(m,k,j,i) - b.x2f(m,k-1,j,i))*idx3;
+      j2(m,k,j,i) += (b.x1f(m,k,j,i) - b.x1f(m,k-1,j,i))*idx3;
+    }
+  });
+
+  // E1 at (i, j-1/2, k-1/2)
+  par_for("e_ni1", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int kc = (three_d)? k : ks;
+    int jc = (multi_d)? j : js;
+    Real jj[3], bb[3];
+    jj[0] = j1(m,kc,jc,i);
+    jj[1] = 0.25*(j2(m,kc,jc,i) + j2(m,kc,jc,i+1) +
+                  j2(m,kc,jc-dj,i) + j2(m,kc,jc-dj,i+1));
+    jj[2] = 0.25*(j3(m,kc,jc,i) + j3(m,kc,jc,i+1) +
+                  j3(m,kc-dk,jc,i) + j3(m,kc-dk,jc,i+1));
+    for (int n=0; n<3; ++n) {
+      bb[n] = 0.25*(bcc(m,n,kc,jc,i) + bcc(m,n,kc,jc-dj,i) + bcc(m,n,kc-dk,jc,i) +
+                    bcc(m,n,kc-dk,jc-dj,i));
+    }
+    Real dens = 0.25*(w(m,IDN,kc,jc,i) + w(m,IDN,kc,jc-dj,i) + w(m,IDN,kc-dk,jc,i) +
+                      w(m,IDN,kc-dk,jc-dj,i));
+    e1(m,k,j,i) = NonIdealE(0, jj, bb, dens, qh, qa, ci, ai);
+  });
+
+  // E2 at (i-1/2, j, k-1/2)
+  par_for("e_ni2", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int kc = (three_d)? k : ks;
+    Real jj[3], bb[3];
+    jj[0] = 0.25*(j1(m,kc,j,i) + j1(m,kc,j,i-1) + j1(m,kc,j+dj,i) + j1(m,kc,j+dj,i-1));
+    jj[1] = j2(m,kc,j,i);
+    jj[2] = 0.25*(j3(m,kc,j,i) + j3(m,kc,j+dj,i) + j3(m,kc-dk,j,i) + j3(m,kc-dk,j+dj,i));
+    for (int n=0; n<3; ++n) {
+      bb[n] = 0.25*(bcc(m,n,kc,j,i) + bcc(m,n,kc,j,i-1) + bcc(m,n,kc-dk,j,i) +
+                    bcc(m,n,kc-dk,j,i-1));
+    }
+    Real dens = 0.25*(w(m,IDN,kc,j,i) + w(m,IDN,kc,j,i-1) + w(m,IDN,kc-dk,j,i) +
+                      w(m,IDN,kc-dk,j,i-1));
+    e2(m,k,j,i) = NonIdealE(1, jj, bb, dens, qh, qa, ci, ai);
+  });
+
+  // E3 at (i-1/2, j-1/2, k)
+  par_for("e_ni3", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int jc = (multi_d)? j : js;
+    Real jj[3], bb[3];
+    jj[0] = 0.25*(j1(m,k,jc,i) + j1(m,k,jc,i-1) + j1(m,k+dk,jc,i) + j1(m,k+dk,jc,i-1));
+    jj[1] = 0.25*(j2(m,k,jc,i) + j2(m,k,jc-dj,i) + j2(m,k+dk,jc,i) + j2(m,k+dk,jc-dj,i));
+    jj[2] = j3(m,k,jc,i);
+    for (int n=0; n<3; ++n) {
+      bb[n] = 0.25*(bcc(m,n,k,jc,i) + bcc(m,n,k,jc,i-1) + bcc(m,n,k,jc-dj,i) +
+                    bcc(m,n,k,jc-dj,i-1));
+    }
+    Real dens = 0.25*(w(m,IDN,k,jc,i) + w(m,IDN,k,jc,i-1) + w(m,IDN,k,jc-dj,i) +
+                      w(m,IDN,k,jc-dj,i-1));
+    e3(m,k,j,i) = NonIdealE(2, jj, bb, dens, qh, qa, ci, ai);
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Resistivity::AddNonIdealEField()
+//! \brief Adds Hall and/or ambipolar electric field stored in e_ni (computed with the
+//! same b0, w0 and bcc0 in MHD::Fluxes()) to corner-centered electric field
+
+void Resistivity::AddNonIdealEField(DvceEdgeFld4D<Real> &efld) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto e1 = efld.x1e;
+  auto e2 = efld.x2e;
+  auto e3 = efld.x3e;
+  auto eni1 = e_ni.x1e;
+  auto eni2 = e_ni.x2e;
+  auto eni3 = e_ni.x3e;
+
+  par_for("add_eni", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    if (i <= ie) {e1(m,k,j,i) += eni1(m,k,j,i);}
+    if (j <= je) {e2(m,k,j,i) += eni2(m,k,j,i);}
+    if (k <= ke) {e3(m,k,j,i) += eni3(m,k,j,i);}
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Resistivity::NonIdealEnergyFlux()
+//! \brief Adds Poynting flux (E X B) of the electric field stored in e_ni to the energy
+//! flux.  E is averaged from edges and B from cell centers to each face.
+
+void Resistivity::NonIdealEnergyFlux(const DvceArray5D<Real> &bcc,
+                                     DvceFaceFld5D<Real> &flx) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto e1 = e_ni.x1e;
+  auto e2 = e_ni.x2e;
+  auto e3 = e_ni.x3e;
+
+  //------------------------------
+  // energy fluxes in x1-direction: F1 = E2*B3 - E3*B2
+
+  auto &flx1 = flx.x1f;
+  par_for("eni_heat1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real ef2 = 0.5*(e2(m,k,j,i) + e2(m,k+1,j,i));
+    Real ef3 = 0.5*(e3(m,k,j,i) + e3(m,k,j+1,i));
+    Real bf2 = 0.5*(bcc(m,IBY,k,j,i-1) + bcc(m,IBY,k,j,i));
+    Real bf3 = 0.5*(bcc(m,IBZ,k,j,i-1) + bcc(m,IBZ,k,j,i));
+    flx1(m,IEN,k,j,i) += ef2*bf3 - ef3*bf2;
+  });
+  if (pmy_pack->pmesh->one_d) {return;}
+
+  //------------------------------
+  // energy fluxes in x2-direction: F2 = E3*B1 - E1*B3
+
+  auto &flx2 = flx.x2f;
+  par_for("eni_heat2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real ef3 = 0.5*(e3(m,k,j,i) + e3(m,k,j,i+1));
+    Real ef1 = 0.5*(e1(m,k,j,i) + e1(m,k+1,j,i));
+    Real bf1 = 0.5*(bcc(m,IBX,k,j-1,i) + bcc(m,IBX,k,j,i));
+    Real bf3 = 0.5*(bcc(m,IBZ,k,j-1,i) + bcc(m,IBZ,k,j,i));
+    flx2(m,IEN,k,j,i) += ef3*bf1 - ef1*bf3;
+  });
+  if (pmy_pack->pmesh->two_d) {return;}
+
+  //------------------------------
+  // energy fluxes in x3-direction: F3 = E1*B2 - E2*B1
+
+  auto &flx3 = flx.x3f;
+  par_for("eni_heat3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real ef1 = 0.5*(e1(m,k,j,i) + e1(m,k,j+1,i));
+    Real ef2 = 0.5*(e2(m,k,j,i) + e2(m,k,j,i+1));
+    Real bf1 = 0.5*(bcc(m,IBX,k-1,j,i) + bcc(m,IBX,k,j,i));
+    Real bf2 = 0.5*(bcc(m,IBY,k-1,j,i) + bcc(m,IBY,k,j,i));
+    flx3(m,IEN,k,j,i) += ef1*bf2 - ef2*bf1;
+  });
+
+  return;
+}
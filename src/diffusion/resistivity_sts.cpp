@@ -0,0 +1,192 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file resistivity_sts.cpp
+//! \brief Operator-split update of the magnetic field (and total energy) by ambipolar
+//! diffusion.  This is Strang split: half of the time step is applied before, and half
+//! after, the main time integrator, with the RKL2 super time-stepping method of Meyer,
+//! Balsara & Aslam (2014), JCP 257, 594, as for thermal conduction (see
+//! conduction_sts.cpp).  Each stage is a CT update, B -> B - dt Curl(E), so div(B) is
+//! preserved, and ghost cells and primitive variables are updated after every stage.
+//! The Hall effect is not operator split (see resistivity.hpp).
+
+#include <algorithm>
+#include <cmath>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "mhd/mhd.hpp"
+#include "resistivity.hpp"
+#include "rkl2.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Resistivity::AmbipolarSuperTimeStep()
+//! \brief Advances B and E by ambipolar diffusion over half the time step, dt/2, with
+//! the RKL2 method.  Added to both the "before_timeintegrator" and
+//! "after_timeintegrator" task lists when ambipolar_integrator = rkl2.
+
+TaskStatus Resistivity::AmbipolarSuperTimeStep(Driver *pdrive, int stage) {
+  Real dt = 0.5*(pmy_pack->pmesh->dt);
+  int s = rkl2::NumberOfStages(dt, dt_ambi);
+  ambi_nstages = s;
+
+  rkl2::Integrate(s, [&](const int j, const Real mu, const Real nu,
+                          const Real mu_tilde, const Real gamma_tilde) {
+    SplitUpdate((j == 1), dt, (1.0 - mu - nu), mu, mu_tilde, nu, gamma_tilde);
+    rkl2::UpdateGhostCells(pmy_pack->pmhd, pdrive);
+  });
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Resistivity::SplitUpdate()
+//! \brief One stage of an operator-split update of the face-centered B and total energy
+//! Y with the ambipolar electric field, where L(Y) = (-Curl(E), -Div(E X B)).  RKL2
+//! stages are of the form
+//!   Y_new = c0 Y_0 + c1 Y + c2 dt L(Y) + c3 Y_{j-2} + c4 dt L(Y_0)
+//! On the first stage (first=true), Y_0, dt L(Y_0), and Y_{j-2} are set from Y.  They are
+//! stored in sts_b and sts_e.
+
+void Resistivity::SplitUpdate(const bool first, const Real dt, const Real c0,
+                              const Real c1, const Real c2, const Real c3,
+                              const Real c4) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb = pmy_pack->nmb_thispack;
+  int nmb1 = nmb - 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  mhd::MHD *pmhd = pmy_pack->pmhd;
+  bool is_ideal = pmhd->peos->eos_data.is_ideal;
+
+  // (re)allocate scratch arrays, since number of MeshBlocks may change with AMR
+  if (static_cast<int>(sts_b.x1f.extent(0)) != nmb) {
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(sts_b.x1f, nmb, 3, ncells3, ncells2, ncells1+1);
+    Kokkos::realloc(sts_b.x2f, nmb, 3, ncells3, ncells2+1, ncells1);
+    Kokkos::realloc(sts_b.x3f, nmb, 3, ncells3+1, ncells2, ncells1);
+    if (is_ideal) {
+      Kokkos::realloc(sts_e, nmb, 3, ncells3, ncells2, ncells1);
+    }
+  }
+
+  // E-field from current B, and energy flux if needed
+  NonIdealEField(pmhd->w0, pmhd->b0, pmhd->bcc0, false, true);
+  auto &flx = pmhd->uflx;
+  if (is_ideal) {
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x1f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x2f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    Kokkos::deep_copy(DevExeSpace(), Kokkos::subview(flx.x3f, Kokkos::ALL, IEN,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), 0.0);
+    NonIdealEnergyFlux(pmhd->bcc0, flx);
+  }
+
+  // capture class variables for the kernels
+  auto e1 = e_ni.x1e;
+  auto e2 = e_ni.x2e;
+  auto e3 = e_ni.x3e;
+
+  //---- update B1 (only for 2D/3D problems)
+  if (multi_d) {
+    auto bx1f = pmhd->b0.x1f;
+    auto sb1 = sts_b.x1f;
+    par_for("ni_b1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real ydt = -dt*(e3(m,k,j+1,i) - e3(m,k,j,i))/mbsize.d_view(m).dx2;
+      if (three_d) {
+        ydt += dt*(e2(m,k+1,j,i) - e2(m,k,j,i))/mbsize.d_view(m).dx3;
+      }
+      Real y1 = bx1f(m,k,j,i);
+      if (first) {
+        sb1(m,0,k,j,i) = y1;
+        sb1(m,1,k,j,i) = ydt;
+        sb1(m,2,k,j,i) = y1;
+      }
+      bx1f(m,k,j,i) = c0*sb1(m,0,k,j,i) + c1*y1 + c2*ydt + c3*sb1(m,2,k,j,i)
+                      + c4*sb1(m,1,k,j,i);
+      sb1(m,2,k,j,i) = y1;
+    });
+  }
+
+  //---- update B2 (curl terms in 1D and 3D problems)
+  auto bx2f = pmhd->b0.x2f;
+  auto sb2 = sts_b.x2f;
+  par_for("ni_b2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real ydt = dt*(e3(m,k,j,i+1) - e3(m,k,j,i))/mbsize.d_view(m).dx1;
+    if (three_d) {
+      ydt -= dt*(e1(m,k+1,j,i) - e1(m,k,j,i))/mbsize.d_view(m).dx3;
+    }
+    Real y1 = bx2f(m,k,j,i);
+    if (first) {
+      sb2(m,0,k,j,i) = y1;
+      sb2(m,1,k,j,i) = ydt;
+      sb2(m,2,k,j,i) = y1;
+    }
+    bx2f(m,k,j,i) = c0*sb2(m,0,k,j,i) + c1*y1 + c2*ydt + c3*sb2(m,2,k,j,i)
+                    + c4*sb2(m,1,k,j,i);
+    sb2(m,2,k,j,i) = y1;
+  });
+
+  //---- update B3 (curl terms in 1D and 2D/3D problems)
+  auto bx3f = pmhd->b0.x3f;
+  auto sb3 = sts_b.x3f;
+  par_for("ni_b3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real ydt = -dt*(e2(m,k,j,i+1) - e2(m,k,j,i))/mbsize.d_view(m).dx1;
+    if (multi_d) {
+      ydt += dt*(e1(m,k,j+1,i) - e1(m,k,j,i))/mbsize.d_view(m).dx2;
+    }
+    Real y1 = bx3f(m,k,j,i);
+    if (first) {
+      sb3(m,0,k,j,i) = y1;
+      sb3(m,1,k,j,i) = ydt;
+      sb3(m,2,k,j,i) = y1;
+    }
+    bx3f(m,k,j,i) = c0*sb3(m,0,k,j,i) + c1*y1 + c2*ydt + c3*sb3(m,2,k,j,i)
+                    + c4*sb3(m,1,k,j,i);
+    sb3(m,2,k,j,i) = y1;
+  });
+
+  //---- update total energy
+  if (is_ideal) {
+    auto u0 = pmhd->u0;
+    auto flx1 = flx.x1f;
+    auto flx2 = flx.x2f;
+    auto flx3 = flx.x3f;
+    auto se = sts_e;
+    par_for("ni_en", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real divf = (flx1(m,IEN,k,j,i+1) - flx1(m,IEN,k,j,i))/mbsize.d_view(m).dx1;
+      if (multi_d) {
+        divf += (flx2(m,IEN,k,j+1,i) - flx2(m,IEN,k,j,i))/mbsize.d_view(m).dx2;
+      }
+      if (three_d) {
+        divf += (flx3(m,IEN,k+1,j,i) - flx3(m,IEN,k,j,i))/mbsize.d_view(m).dx3;
+      }
+      Real ydt = -dt*divf;
+      Real y1 = u0(m,IEN,k,j,i);
+      if (first) {
+        se(m,0,k,j,i) = y1;
+        se(m,1,k,j,i) = ydt;
+        se(m,2,k,j,i) = y1;
+      }
+      u0(m,IEN,k,j,i) = c0*se(m,0,k,j,i) + c1*y1 + c2*ydt + c3*se(m,2,k,j,i)
+                        + c4*se(m,1,k,j,i);
+      se(m,2,k,j,i) = y1;
+    });
+  }
+  return;
+}
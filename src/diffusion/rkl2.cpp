@@ -0,0 +1,84 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file rkl2.cpp
+//! \brief Number of stages and blocking exchange of ghost cells for RKL2 super
+//! time-stepping (see rkl2.hpp)
+
+#include <algorithm>
+#include <cmath>
+
+#include "athena.hpp"
+#include "driver/driver.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "rkl2.hpp"
+
+namespace rkl2 {
+//----------------------------------------------------------------------------------------
+//! \fn int NumberOfStages()
+//! \brief Returns the number of RKL2 stages (at least 2) needed for a stable update over
+//! dt, given the explicit time step dt_expl.  The minimum of dt_expl over all ranks is
+//! used, since the number of stages must be the same on all ranks.
+
+int NumberOfStages(const Real dt, const Real dt_expl) {
+  Real dtexp = dt_expl;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &dtexp, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  int s = static_cast<int>(std::ceil(0.5*(std::sqrt(9.0 + 16.0*dt/dtexp) - 1.0)));
+  return std::max(s, 2);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void UpdateGhostCells()
+//! \brief Sets ghost cells of conserved variables and computes primitives after each
+//! RKL2 stage, with same sequence of functions used on initialization.  Blocks until all
+//! communications are finished.
+
+void UpdateGhostCells(hydro::Hydro *phydro, Driver *pdrive) {
+  (void) phydro->RestrictU(pdrive, 0);
+  (void) phydro->InitRecv(pdrive, -1);  // stage < 0 suppresses InitFluxRecv
+  (void) phydro->SendU(pdrive, 0);
+  (void) phydro->ClearSend(pdrive, -1);
+  (void) phydro->ClearRecv(pdrive, -1);
+  (void) phydro->RecvU(pdrive, 0);
+  (void) phydro->SendU_Shr(pdrive, 0);
+  (void) phydro->ClearSend(pdrive, -4);
+  (void) phydro->ClearRecv(pdrive, -4);
+  (void) phydro->RecvU_Shr(pdrive, 0);
+  (void) phydro->ApplyPhysicalBCs(pdrive, 0);
+  (void) phydro->Prolongate(pdrive, 0);
+  (void) phydro->ConToPrim(pdrive, 0);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void UpdateGhostCells()
+//! \brief Same as above for MHD, also setting ghost cells of the face-centered B and
+//! computing cell-centered B
+
+void UpdateGhostCells(mhd::MHD *pmhd, Driver *pdrive) {
+  (void) pmhd->RestrictU(pdrive, 0);
+  (void) pmhd->RestrictB(pdrive, 0);
+  (void) pmhd->InitRecv(pdrive, -1);  // stage < 0 suppresses InitFluxRecv
+  (void) pmhd->SendU(pdrive, 0);
+  (void) pmhd->SendB(pdrive, 0);
+  (void) pmhd->ClearSend(pdrive, -1);
+  (void) pmhd->ClearRecv(pdrive, -1);
+  (void) pmhd->RecvU(pdrive, 0);
+  (void) pmhd->RecvB(pdrive, 0);
+  (void) pmhd->SendU_Shr(pdrive, 0);
+  (void) pmhd->SendB_Shr(pdrive, 0);
+  (void) pmhd->ClearSend(pdrive, -4);
+  (void) pmhd->ClearRecv(pdrive, -4);
+  (void) pmhd->RecvU_Shr(pdrive, 0);
+  (void) pmhd->RecvB_Shr(pdrive, 0);
+  (void) pmhd->ApplyPhysicalBCs(pdrive, 0);
+  (void) pmhd->Prolongate(pdrive, 0);
+  (void) pmhd->ConToPrim(pdrive, 0);
+  return;
+}
+} // namespace rkl2
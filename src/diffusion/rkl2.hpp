@@ -0,0 +1,63 @@
+#ifndef DIFFUSION_RKL2_HPP_
+#define DIFFUSION_RKL2_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file rkl2.hpp
+//  \brief Functions shared by the operator-split updates that use the second-order
+//  Runge-Kutta-Legendre super time-stepping method (RKL2) of Meyer, Balsara & Aslam
+//  (2014), JCP 257, 594: thermal conduction (conduction_sts.cpp) and ambipolar diffusion
+//  (resistivity_sts.cpp).  With s stages the scheme is stable for time steps up to
+//  dt_expl*(s^2 + s - 2)/4.  The physics module supplies the update of a single stage,
+//  and the ghost cells are exchanged (blocking) after every stage.
+
+#include <cmath>
+
+#include "athena.hpp"
+
+// forward declarations
+class Driver;
+namespace hydro {class Hydro;}
+namespace mhd {class MHD;}
+
+namespace rkl2 {
+//----------------------------------------------------------------------------------------
+//! \fn Real CoeffB()
+//! \brief coefficients b_j of the RKL2 method
+
+inline Real CoeffB(const int j) {
+  if (j <= 2) {return 1.0/3.0;}
+  return static_cast<Real>(j*j + j - 2)/static_cast<Real>(2*j*(j + 1));
+}
+
+int NumberOfStages(const Real dt, const Real dt_expl);
+void UpdateGhostCells(hydro::Hydro *phydro, Driver *pdrive);
+void UpdateGhostCells(mhd::MHD *pmhd, Driver *pdrive);
+
+//----------------------------------------------------------------------------------------
+//! \fn void Integrate()
+//! \brief Calls stage(j, mu, nu, mu_tilde, gamma_tilde) for stages j = 1,...,s, which
+//! must set
+//!   Y_j = mu Y_{j-1} + nu Y_{j-2} + (1 - mu - nu) Y_0 + mu_tilde dt L(Y_{j-1})
+//!         + gamma_tilde dt L(Y_0)
+//! and update the ghost cells.  For the first stage mu = 1 and nu = gamma_tilde = 0, so
+//! that Y_1 = Y_0 + mu_tilde dt L(Y_0).
+
+template <typename StageFunction>
+void Integrate(const int s, const StageFunction &stage) {
+  Real w1 = 4.0/static_cast<Real>(s*s + s - 2);
+  stage(1, 1.0, 0.0, CoeffB(1)*w1, 0.0);
+  for (int j=2; j<=s; ++j) {
+    Real bj = CoeffB(j), bj1 = CoeffB(j-1), bj2 = CoeffB(j-2);
+    Real mu = (2.0*j - 1.0)/static_cast<Real>(j)*bj/bj1;
+    Real nu = -(j - 1.0)/static_cast<Real>(j)*bj/bj2;
+    Real mu_tilde = mu*w1;
+    Real gamma_tilde = -(1.0 - bj1)*mu_tilde;
+    stage(j, mu, nu, mu_tilde, gamma_tilde);
+  }
+}
+} // namespace rkl2
+
+#endif // DIFFUSION_RKL2_HPP_
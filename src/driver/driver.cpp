@@ -17,12 +17,18 @@
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs/outputs.hpp"
+#include "eos/eos.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "z4c/z4c.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
 #include "ion-neutral/ion-neutral.hpp"
 #include "radiation/radiation.hpp"
+#include "m1/m1.hpp"
+#include "gravity/gravity.hpp"
+#include "utils/memory_usage.hpp"
+#include "utils/signal_handler.hpp"
+#include "utils/timers.hpp"
 #include "driver.hpp"
 
 #if MPI_PARALLEL_ENABLED
@@ -59,11 +65,16 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
   tlim(-1.0),
   nlim(-1),
   ndiag(1),
+  ntimers(0),
   nmb_updated_(0),
   npart_updated_(0),
   lb_efficiency_(0),
+  stop_signal_(0),
+  wall_time_stop_(false),
   pwall_clock_(ptimer),
   wall_time(wtlim),
+  wall_time_safety(1.2),
+  wall_time_write_rate(100.0),
   impl_src("ru",1,1,1,1,1,1) {
   // set time-evolution option (no default)
   {
@@ -81,12 +92,24 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
     }
   } // extra brace to limit scope of string
 
+  // read <timers> parameters controlling hierarchical wall-clock timers (if any)
+  if (pin->DoesBlockExist("timers")) {
+    bool enable = pin->GetOrAddBoolean("timers", "enable", true);
+    bool precise = pin->GetOrAddBoolean("timers", "precise", false);
+    ntimers = pin->GetOrAddInteger("timers", "dcycle", 0);
+    timers::Initialize(enable, precise);
+  }
+
   // read <time> parameters controlling driver if run requires time-evolution
   if (time_evolution != TimeEvolution::tstatic) {
     integrator = pin->GetOrAddString("time", "integrator", "rk2");
     tlim = pin->GetReal("time", "tlim");
     nlim = pin->GetOrAddInteger("time", "nlim", -1);
     ndiag = pin->GetOrAddInteger("time", "ndiag", 1);
+    if (wall_time > 0.) {
+      wall_time_safety = pin->GetOrAddReal("time", "wall_time_safety", 1.2);
+      wall_time_write_rate = pin->GetOrAddReal("time", "wall_time_write_rate", 100.0);
+    }
 
     if (integrator == "rk1") {
       // RK1: first-order Runge-Kutta / the forward Euler (FE) method
@@ -262,6 +285,25 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
       exit(EXIT_FAILURE);
     }
   }
+
+  // allocate memory for stiff source terms with ImEx integrators
+  // only implemented for ion-neutral two fluid for now
+  ion_neutral::IonNeutral *pionn = pmesh->pmb_pack->pionn;
+  if (pionn != nullptr) {
+    if (nimp_stages == 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "IonNetral MHD can only be run with ImEx integrators."
+          << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    int nmb = std::max((pmesh->pmb_pack->nmb_thispack), (pmesh->nmb_maxperrank));
+    auto &indcs = pmesh->mb_indcs;
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(impl_src, nimp_stages, nmb, 8, ncells3, ncells2, ncells1);
+    memory_usage::TrackArrays("Driver", impl_src);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -271,6 +313,7 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
 //! these tasks are to be performed, e.g. which stage of a multi-stage RK integrator.
 
 void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
+  timers::Start(tl);
   MeshBlockPack* pmbp = pm->pmb_pack;
   for (int p=0; p<(pm->nmb_packs_thisrank); ++p) {
     if (!(pmbp->tl_map[tl]->Empty())) {pmbp->tl_map[tl]->Reset();}
@@ -286,6 +329,7 @@ void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
       }
     }
   }
+  timers::Stop();
   return;
 }
 
@@ -295,6 +339,7 @@ void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
 //  outputting ICs, and computing initial time step
 
 void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool res_flag) {
+  timers::Start("Initialize");
   //---- Step 1.  Set conserved variables in ghost zones for all physics
   InitBoundaryValuesAndPrimitives(pmesh);
 
@@ -313,6 +358,9 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
     if (prad != nullptr) {
       (void) pmesh->pmb_pack->prad->NewTimeStep(this, nexp_stages);
     }
+    if (pmesh->pmb_pack->pm1 != nullptr) {
+      (void) pmesh->pmb_pack->pm1->NewTimeStep(this, nexp_stages);
+    }
     if (pz4c != nullptr) {
       (void) pmesh->pmb_pack->pz4c->NewTimeStep(this, nexp_stages);
     }
@@ -321,34 +369,27 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
   }
 
   //---- Step 3.  Cycle through output Types and load data / write files.
+  // Time taken to write each output is stored to predict time needed for final outputs
+  tout_.assign(pout->pout_list.size(), 0.0);
   if (!res_flag) { // only write outputs at the beginning of the run
-    for (auto &out : pout->pout_list) {
+    timers::Start("Outputs");
+    for (std::size_t n=0; n<pout->pout_list.size(); ++n) {
+      auto &out = pout->pout_list[n];
+      timers::Start(out->out_params.block_name);
+      Real tstart = pwall_clock_->seconds();
       out->LoadOutputData(pmesh);
       out->WriteOutputFile(pmesh, pin);
+      tout_[n] = pwall_clock_->seconds() - tstart;
+      timers::Stop();
     }
+    timers::Stop();
   }
 
   //---- Step 4.  Initialize various counters, timers, etc.
   run_time_.reset();
   nmb_updated_ = 0;
 
-  // allocate memory for stiff source terms with ImEx integrators
-  // only implemented for ion-neutral two fluid for now
-  ion_neutral::IonNeutral *pionn = pmesh->pmb_pack->pionn;
-  if (pionn != nullptr) {
-    if (nimp_stages == 0) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "IonNetral MHD can only be run with ImEx integrators."
-          << std::endl;
-      std::exit(EXIT_FAILURE);
-    }
-    int nmb = std::max((pmesh->pmb_pack->nmb_thispack), (pmesh->nmb_maxperrank));
-    auto &indcs = pmesh->mb_indcs;
-    int ncells1 = indcs.nx1 + 2*(indcs.ng);
-    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
-    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(impl_src, nimp_stages, nmb, 8, ncells3, ncells2, ncells1);
-  }
+  timers::Stop();
 
   return;
 }
@@ -372,9 +413,13 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
     if (wall_time > 0.) {
       elapsed_time = UpdateWallClock();
     }
+    Real start_time = elapsed_time;
+    int ncycle_start = pmesh->ncycle;
+    bool stop_run = false;
     while ((pmesh->time < tlim) && (pmesh->ncycle < nlim || nlim < 0) &&
-           (elapsed_time < wall_time)) {
+           (elapsed_time < wall_time) && !stop_run) {
       if (global_variable::my_rank == 0) {OutputCycleDiagnostics(pmesh);}
+      timers::Start("Cycle");
 
       // Execute TaskLists
       // Work before time integrator indicated by "0" in stage
@@ -395,6 +440,13 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
       pmesh->time = pmesh->time + pmesh->dt;
       pmesh->ncycle++;
       nmb_updated_ += pmesh->nmb_total;
+      // store number of C2P failures/floors in each MeshBlock in this cycle (if mapped)
+      if (pmesh->pmb_pack->phydro != nullptr) {
+        pmesh->pmb_pack->phydro->peos->SummarizeEvents();
+      }
+      if (pmesh->pmb_pack->pmhd != nullptr) {
+        pmesh->pmb_pack->pmhd->peos->SummarizeEvents();
+      }
       npart_updated_ += pmesh->nprtcl_total;
       // load balancing efficiency
       if (global_variable::nranks > 1) {
@@ -407,7 +459,9 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
       }
 
       // Test for/make outputs
-      for (auto &out : pout->pout_list) {
+      timers::Start("Outputs");
+      for (std::size_t n=0; n<pout->pout_list.size(); ++n) {
+        auto &out = pout->pout_list[n];
         // compare at floating point (32-bit) precision to reduce effect of round off
         float time_32 = static_cast<float>(pmesh->time);
         float next_32 = static_cast<float>(out->out_params.last_time+out->out_params.dt);
@@ -416,20 +470,48 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
 
         if (((out->out_params.dt > 0.0) && ((time_32 >= next_32) && (time_32<tlim_32))) ||
             ((dcycle_ > 0) && ((pmesh->ncycle)%(dcycle_) == 0)) ) {
+          timers::Start(out->out_params.block_name);
+          Real tstart = pwall_clock_->seconds();
           out->LoadOutputData(pmesh);
           out->WriteOutputFile(pmesh, pin);
+          tout_[n] = pwall_clock_->seconds() - tstart;
+          timers::Stop();
         }
       }
+      timers::Stop();
 
       // AMR
-      if (pmesh->adaptive) {pmesh->pmr->AdaptiveMeshRefinement(this, pin);}
+      if (pmesh->adaptive) {
+        timers::Start("AdaptiveMeshRefinement");
+        pmesh->pmr->AdaptiveMeshRefinement(this, pin);
+        timers::Stop();
+        memory_usage::Sample();
+      }
       // compute new timestep AFTER all Meshblocks refined/derefined
+      timers::Start("NewTimeStep");
       pmesh->NewTimeStep(tlim);
+      timers::Stop();
+      timers::Stop();  // end of "Cycle"
+
+      // Output timers every 'ntimers' cycles, if requested
+      if ((ntimers > 0) && ((pmesh->ncycle)%(ntimers) == 0)) {timers::Report();}
 
-      // Update wall clock time if needed.
+      // Update wall clock time if needed, and stop early if next cycle plus final
+      // outputs are predicted to exceed the wall clock limit.
       if (wall_time > 0.) {
+        Real last_time = elapsed_time;
         elapsed_time = UpdateWallClock();
+        Real tcycle = std::max(elapsed_time - last_time,
+            (elapsed_time - start_time)/static_cast<Real>(pmesh->ncycle - ncycle_start));
+        if (PredictWallTimeLimit(pmesh, pout, elapsed_time, tcycle)) {
+          wall_time_stop_ = true;
+          stop_run = true;
+        }
       }
+
+      // Stop at end of this cycle if a signal was caught on any rank.
+      stop_signal_ = signal_handler::Check();
+      if (stop_signal_ != 0) {stop_run = true;}
     }  // end while
   }    // end of (time_evolution != tstatic) clause
   return;
@@ -441,17 +523,26 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
 //!  and printing diagnostic messages
 
 void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
+  timers::Start("Finalize");
   // cycle through output Types and load data / write files
   //  This design allows for asynchronous outputs to implemented in the future.
-  for (auto &out : pout->pout_list) {
+  timers::Start("Outputs");
+  for (std::size_t n=0; n<pout->pout_list.size(); ++n) {
+    auto &out = pout->pout_list[n];
+    timers::Start(out->out_params.block_name);
+    Real tstart = pwall_clock_->seconds();
     out->LoadOutputData(pmesh);
     out->WriteOutputFile(pmesh, pin);
+    tout_[n] = pwall_clock_->seconds() - tstart;
+    timers::Stop();
   }
+  timers::Stop();
 
   // call any problem specific functions to do work after main loop
   if (pmesh->pgen->pgen_final_func != nullptr) {
     (pmesh->pgen->pgen_final_func)(pin, pmesh);
   }
+  timers::Stop();
 
   float exe_time = run_time_.seconds();
 
@@ -470,6 +561,11 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
         std::cout << std::endl << "Terminating on cycle limit" << std::endl;
       } else if (pmesh->time >= tlim) {
         std::cout << std::endl << "Terminating on time limit" << std::endl;
+      } else if (stop_signal_ != 0) {
+        std::cout << std::endl << "Terminating on signal " << stop_signal_ << std::endl;
+      } else if (wall_time_stop_) {
+        std::cout << std::endl << "Terminating on predicted wall clock limit"
+                  << std::endl;
       } else {
         std::cout << std::endl << "Terminating on wall clock limit" << std::endl;
       }
@@ -500,6 +596,10 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
       std::cout << "particle-updates/cpu_second = " << pups << std::endl;
     }
   }
+
+  // Output memory usage and table of timers (collective over all ranks)
+  memory_usage::Report(pmesh, false);
+  timers::Report();
   return;
 }
 
@@ -538,6 +638,34 @@ Real Driver::UpdateWallClock() {
   return tnow;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Driver::PredictWallTimeLimit()
+//! \brief Returns true if the next cycle (with predicted duration tcycle) followed by the
+//! final outputs written in Finalize() would exceed the wall clock limit, so that the run
+//! must be stopped now for the final outputs (including restarts) to complete in time.
+//! The time for the final outputs is the sum of the most recently measured write time of
+//! each output type, taken as the maximum over ranks so all ranks make the same decision.
+//! Restart files not yet written in this run (e.g. after restarting) are estimated from
+//! the size of the file and <time>/wall_time_write_rate (in MB/s).
+
+bool Driver::PredictWallTimeLimit(Mesh *pm, Outputs *pout, Real elapsed, Real tcycle) {
+  Real tfinal = 0.0;
+  for (std::size_t n=0; n<tout_.size(); ++n) {
+    if ((tout_[n] == 0.0) &&
+        (pout->pout_list[n]->out_params.file_type.compare("rst") == 0)) {
+      Real nbytes = static_cast<Real>(pm->nmb_total)*
+                    static_cast<Real>(RestartOutput::MeshBlockDataSize(pm));
+      tfinal += nbytes/(1.0e6*wall_time_write_rate);
+    } else {
+      tfinal += tout_[n];
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &tfinal, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  return (elapsed + wall_time_safety*(tcycle + tfinal) >= wall_time);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn Driver::InitBoundaryValuesAndPrimitives()
 //! \brief Sets boundary conditions on conserved and initializes primitives.  Used both
@@ -626,5 +754,24 @@ void Driver::InitBoundaryValuesAndPrimitives(Mesh *pm) {
     (void) prad->Prolongate(this, 0);
   }
 
+  // Initialize M1: ghost zones of moments (everywhere)
+  m1::M1 *pm1 = pm->pmb_pack->pm1;
+  if (pm1 != nullptr) {
+    (void) pm1->RestrictU(this, 0);
+    (void) pm1->InitRecv(this, -1);  // stage < 0 suppresses InitFluxRecv
+    (void) pm1->SendU(this, 0);
+    (void) pm1->ClearSend(this, -1);
+    (void) pm1->ClearRecv(this, -1);
+    (void) pm1->RecvU(this, 0);
+    (void) pm1->ApplyPhysicalBCs(this, 0);
+    (void) pm1->Prolongate(this, 0);
+  }
+
+  // Initialize self-gravity: potential of initial density (everywhere)
+  gravity::Gravity *pgrav = pm->pmb_pack->pgrav;
+  if (pgrav != nullptr) {
+    pgrav->Solve();
+  }
+
   return;
 }
@@ -15,6 +15,7 @@
 #include <ctime>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "parameter_input.hpp"
 #include "outputs/outputs.hpp"
@@ -36,6 +37,7 @@ class Driver {
   Real tlim;      // stopping time
   int nlim;       // cycle-limit
   int ndiag;      // cycles between output of diagnostic information
+  int ntimers;    // cycles between output of timers (0 = only at end of run)
   // variables for various SSP and ImEx RK integrators
   std::string integrator;          // integrator name (rk1, rk2, rk3)
   int nimp_stages;                 // number of implicit stages (ImEx only)
@@ -46,6 +48,8 @@ class Driver {
   Real cfl_limit;                  // maximum CFL number for integrator
   Kokkos::Timer* pwall_clock_;     // timer for tracking the wall clock
   Real wall_time;
+  Real wall_time_safety;  // safety factor for predicted time of next cycle + final output
+  Real wall_time_write_rate;  // MB/s assumed for restart files before one is written
 
   // functions
   void ExecuteTaskList(Mesh *pm, std::string tl, int stage);
@@ -59,7 +63,11 @@ class Driver {
   std::uint64_t nmb_updated_;   // running total of MB updated during run
   std::uint64_t npart_updated_; // running total of particles updated during run
   float lb_efficiency_;         // measure of how efficient was load balancing
+  int stop_signal_;             // signal that terminated run (0 if none)
+  bool wall_time_stop_;         // true if run terminated early to fit final output
+  std::vector<Real> tout_;      // wall time of most recent write of each output type
   void OutputCycleDiagnostics(Mesh *pm);
   Real UpdateWallClock();
+  bool PredictWallTimeLimit(Mesh *pm, Outputs *pout, Real elapsed, Real tcycle);
 };
 #endif // DRIVER_DRIVER_HPP_
@@ -148,6 +148,10 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
     // Note b0 and w0 passed to function, but not used/changed.
     eos.ConsToPrim(utest_, pmy_pack->pmhd->b0, bcctest_,
                            pmy_pack->pmhd->w0, il, iu, jl, ju, kl, ku, true);
+
+    // Also flag all cells in MeshBlocks with many C2P failures/floors in last cycle
+    auto peos = pmy_pack->pmhd->peos;
+    peos->FlagFOFCFromEvents(pmy_pack->pmhd->fofc, il, iu, jl, ju, kl, ku);
   }
 
   auto &use_fofc_ = pmy_pack->pmhd->use_fofc;
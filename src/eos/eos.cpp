@@ -7,12 +7,14 @@
 //! \brief implements constructor and some fns for EquationOfState abstract base class
 
 #include <float.h>
+#include <algorithm>
 #include <string>
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 #include "eos/eos.hpp"
+#include "utils/memory_usage.hpp"
 
 //----------------------------------------------------------------------------------------
 // EquationOfState constructor
@@ -23,6 +25,74 @@ EquationOfState::EquationOfState(std::string bk, MeshBlockPack* pp, ParameterInp
   eos_data.pfloor = pin->GetOrAddReal(bk,"pfloor",(FLT_MIN));
   eos_data.tfloor = pin->GetOrAddReal(bk,"tfloor",(FLT_MIN));
   eos_data.sfloor = pin->GetOrAddReal(bk,"sfloor",(FLT_MIN));
+
+  // optional maps of C2P failures and floors
+  events.enabled = pin->GetOrAddBoolean(bk,"event_map",false);
+  fofc_event_threshold = pin->GetOrAddInteger(bk,"fofc_event_threshold",-1);
+  if (events.enabled) {
+    auto &indcs = pp->pmesh->mb_indcs;
+    events.is = indcs.is; events.ie = indcs.ie;
+    events.js = indcs.js; events.je = indcs.je;
+    events.ks = indcs.ks; events.ke = indcs.ke;
+    int nmb = std::max((pp->nmb_thispack), (pp->pmesh->nmb_maxperrank));
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(events.map, nmb, N_EOS_EVENTS, ncells3, ncells2, ncells1);
+    Kokkos::realloc(events.count, nmb, N_EOS_EVENTS);
+    Kokkos::realloc(event_summary, nmb, N_EOS_EVENTS);
+    ResetEvents();
+    std::string module = (bk.compare("mhd") == 0)? "MHD" : "Hydro";
+    memory_usage::TrackArrays(module, events.map);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void EquationOfState::SummarizeEvents()
+//! \brief Stores number of each event in each MeshBlock during the cycle just completed
+//! in event_summary (on both device and host), and resets counters for the next cycle.
+//! Called by the Driver once per cycle, before outputs and AMR.
+
+void EquationOfState::SummarizeEvents() {
+  if (!(events.enabled)) {return;}
+  Kokkos::deep_copy(event_summary.d_view, events.count);
+  Kokkos::deep_copy(events.count, 0);
+  event_summary.template modify<DevExeSpace>();
+  event_summary.template sync<HostMemSpace>();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void EquationOfState::ResetEvents()
+//! \brief Zeroes maps and counters of events.  Called at startup and when MeshBlocks
+//! change with AMR, since data in maps is then no longer associated with right cells.
+
+void EquationOfState::ResetEvents() {
+  if (!(events.enabled)) {return;}
+  Kokkos::deep_copy(events.map, 0.0);
+  Kokkos::deep_copy(events.count, 0);
+  Kokkos::deep_copy(event_summary.d_view, 0);
+  Kokkos::deep_copy(event_summary.h_view, 0);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void EquationOfState::FlagFOFCFromEvents()
+//! \brief Sets FOFC flag in all cells in range of any MeshBlock in which the total
+//! number of C2P failures and floors in the last cycle exceeded fofc_event_threshold, so
+//! that fluxes in problem MeshBlocks fall back to first-order.
+
+void EquationOfState::FlagFOFCFromEvents(DvceArray4D<bool> &fofc, const int il,
+                                         const int iu, const int jl, const int ju,
+                                         const int kl, const int ku) {
+  if (!(events.enabled) || fofc_event_threshold < 0) {return;}
+  int nmb = pmy_pack->nmb_thispack;
+  auto summ = event_summary.d_view;
+  int thresh = fofc_event_threshold;
+  par_for("fofc_events", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    int nev = 0;
+    for (int n=0; n<N_EOS_EVENTS; ++n) {nev += summ(m,n);}
+    if (nev > thresh) {fofc(m,k,j,i) = true;}
+  });
 }
 
 //----------------------------------------------------------------------------------------
@@ -191,6 +191,32 @@ struct EOS_Data {
   }
 };
 
+//----------------------------------------------------------------------------------------
+//! \struct EOS_Events
+//! \brief optional maps of C2P failures and floor/ceiling activations, enabled with
+//! <hydro>/event_map or <mhd>/event_map.  Filled inside C2P kernels by calling Record().
+//! The cell map counts events in each cell since the start of the run (or since the
+//! MeshBlocks last changed with AMR).  MeshBlock counts are summed over each cycle.
+//! Only events in active cells are recorded, since C2P is also called in ghost zones.
+
+enum EOSEvents {I_EV_DFLOOR, I_EV_EFLOOR, I_EV_TFLOOR, I_EV_VCEIL, I_EV_FAIL,
+                N_EOS_EVENTS};
+
+struct EOS_Events {
+  bool enabled = false;
+  DvceArray5D<Real> map;     // number of each event in each cell
+  DvceArray2D<int> count;    // number of each event in each MeshBlock this cycle
+  int is, ie, js, je, ks, ke;  // indices of active cells
+
+  KOKKOS_INLINE_FUNCTION
+  void Record(const int ev, const int m, const int k, const int j, const int i) const {
+    if (enabled && (i >= is && i <= ie) && (j >= js && j <= je) && (k >= ks && k <= ke)) {
+      Kokkos::atomic_add(&map(m,ev,k,j,i), static_cast<Real>(1.0));
+      Kokkos::atomic_add(&count(m,ev), 1);
+    }
+  }
+};
+
 //----------------------------------------------------------------------------------------
 //! \class EquationOfState
 //! \brief Abstract base class for EOS.
@@ -202,6 +228,14 @@ class EquationOfState {
 
   MeshBlockPack* pmy_pack;
   EOS_Data eos_data;
+  EOS_Events events;               // maps of C2P failures and floors (if enabled)
+  DualArray2D<int> event_summary;  // number of each event in each MeshBlock last cycle
+  int fofc_event_threshold;        // use FOFC in MeshBlocks with more events than this
+
+  void SummarizeEvents();
+  void ResetEvents();
+  void FlagFOFCFromEvents(DvceArray4D<bool> &fofc, const int il, const int iu,
+                          const int jl, const int ju, const int kl, const int ku);
 
   // virtual functions to convert cons to prim in either Hydro or MHD (depending on
   // arguments), overwritten in derived eos classes
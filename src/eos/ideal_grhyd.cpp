@@ -48,6 +48,7 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   int &nscal = pmy_pack->phydro->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->phydro->fofc;
+  auto &events_ = events;
   auto eos = eos_data;
   Real gm1 = eos_data.gamma - 1.0;
 
@@ -159,6 +160,10 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
       if (efloor_used) {sume++;}
       if (vceiling_used) {sumv++;}
       if (c2p_failure) {sumf++;}
+      if (dfloor_used) {events_.Record(I_EV_DFLOOR, m, k, j, i);}
+      if (efloor_used) {events_.Record(I_EV_EFLOOR, m, k, j, i);}
+      if (vceiling_used) {events_.Record(I_EV_VCEIL, m, k, j, i);}
+      if (c2p_failure) {events_.Record(I_EV_FAIL, m, k, j, i);}
       max_it = (iter_used > max_it) ? iter_used : max_it;
 
       // store primitive state in 3D array
@@ -37,6 +37,7 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   int &nmb = pmy_pack->nmb_thispack;
   auto &eos = eos_data;
   auto &fofc_ = pmy_pack->phydro->fofc;
+  auto &events_ = events;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -75,6 +76,9 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
       }
     } else {
       // update counter, reset conserved if floor was hit
+      if (dfloor_used) {events_.Record(I_EV_DFLOOR, m, k, j, i);}
+      if (efloor_used) {events_.Record(I_EV_EFLOOR, m, k, j, i);}
+      if (tfloor_used) {events_.Record(I_EV_TFLOOR, m, k, j, i);}
       if (dfloor_used) {
         cons(m,IDN,k,j,i) = u.d;
         sumd++;
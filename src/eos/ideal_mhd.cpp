@@ -38,6 +38,7 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
   int &nmb = pmy_pack->nmb_thispack;
   auto &eos = eos_data;
   auto &fofc_ = pmy_pack->pmhd->fofc;
+  auto &events_ = events;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -89,6 +90,9 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
       }
     } else {
       // update counter, reset conserved if floor was hit
+      if (dfloor_used) {events_.Record(I_EV_DFLOOR, m, k, j, i);}
+      if (efloor_used) {events_.Record(I_EV_EFLOOR, m, k, j, i);}
+      if (tfloor_used) {events_.Record(I_EV_TFLOOR, m, k, j, i);}
       if (dfloor_used) {
         cons(m,IDN,k,j,i) = u.d;
         sumd++;
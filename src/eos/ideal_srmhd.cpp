@@ -60,6 +60,7 @@ void IdealSRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
   int &nmb = pmy_pack->nmb_thispack;
   auto eos = eos_data;
   auto &fofc_ = pmy_pack->pmhd->fofc;
+  auto &events_ = events;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -131,6 +132,10 @@ void IdealSRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
       if (efloor_used) {sume++;}
       if (vceiling_used) {sumv++;}
       if (c2p_failure) {sumf++;}
+      if (dfloor_used) {events_.Record(I_EV_DFLOOR, m, k, j, i);}
+      if (efloor_used) {events_.Record(I_EV_EFLOOR, m, k, j, i);}
+      if (vceiling_used) {events_.Record(I_EV_VCEIL, m, k, j, i);}
+      if (c2p_failure) {events_.Record(I_EV_FAIL, m, k, j, i);}
       max_it = (iter_used > max_it) ? iter_used : max_it;
 
       // store primitive state in 3D array
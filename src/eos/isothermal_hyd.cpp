@@ -73,6 +73,7 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
   int &nscal = pmy_pack->phydro->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->phydro->fofc;
+  auto &events_ = events;
   Real dfloor = eos_data.dfloor;
 
   const int ni   = (iu - il + 1);
@@ -111,6 +112,7 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
     if (only_testfloors) {
       if (dfloor_used) {fofc_(m,k,j,i) = true;}
     } else {
+      if (dfloor_used) {events_.Record(I_EV_DFLOOR, m, k, j, i);}
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
       prim(m,IVX,k,j,i) = w.vx;
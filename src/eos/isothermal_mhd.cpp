@@ -76,6 +76,7 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
   int &nscal = pmy_pack->pmhd->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->pmhd->fofc;
+  auto &events_ = events;
   Real dfloor = eos_data.dfloor;
 
   const int ni   = (iu - il + 1);
@@ -120,6 +121,7 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
     if (only_testfloors) {
       if (dfloor_used) {fofc_(m,k,j,i) = true;}
     } else {
+      if (dfloor_used) {events_.Record(I_EV_DFLOOR, m, k, j, i);}
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
       prim(m,IVX,k,j,i) = w.vx;
@@ -34,6 +34,7 @@
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 #include "coordinates/adm.hpp"
+#include "eos/eos.hpp"
 #include "mhd/mhd.hpp"
 #include "coordinates/coordinates.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -277,6 +278,7 @@ class PrimitiveSolverHydro {
     int &nscal = pmy_pack->pmhd->nscalars;
     int &nmb = pmy_pack->nmb_thispack;
     auto &fofc_ = pmy_pack->pmhd->fofc;
+    auto &events_ = pmy_pack->pmhd->peos->events;
 
     // Some problem-specific parameters
     auto &excise = pmy_pack->pcoord->coord_data.bh_excise;
@@ -405,6 +407,11 @@ class PrimitiveSolverHydro {
       if (result.error != Primitive::Error::SUCCESS && floors_only) {
         fofc_(m,k,j,i) = true;
       } else if (!floors_only) {
+        if (result.error != Primitive::Error::SUCCESS) {
+          events_.Record(I_EV_FAIL, m, k, j, i);
+        } else if (result.cons_floor || result.prim_floor) {
+          events_.Record(I_EV_DFLOOR, m, k, j, i);
+        }
         if (result.error != Primitive::Error::SUCCESS && (nerrs_ + sumerrs < errcap_)) {
           // TODO(JF): put in a proper error response here.
           sumerrs++;
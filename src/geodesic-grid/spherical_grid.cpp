@@ -94,6 +94,7 @@ void SphericalGrid::SetInterpolationCoordinates() {
 
 void SphericalGrid::SetInterpolationIndices() {
   auto &size = pmy_pack->pmb->mb_size;
+  auto &msize = pmy_pack->pmesh->mesh_size;
   int nmb1 = pmy_pack->nmb_thispack - 1;
   int nang1 = nangles - 1;
 
@@ -120,10 +121,17 @@ void SphericalGrid::SetInterpolationIndices() {
       Real &dx3 = size.h_view(m).dx3;
 
       // save MeshBlock and zone indicies for nearest position to spherical patch center
-      // if this angle position resides in this MeshBlock
-      if ((rcoord.h_view(n,0) >= x1min && rcoord.h_view(n,0) <= x1max) &&
-          (rcoord.h_view(n,1) >= x2min && rcoord.h_view(n,1) <= x2max) &&
-          (rcoord.h_view(n,2) >= x3min && rcoord.h_view(n,2) <= x3max)) {
+      // if this angle position resides in this MeshBlock.  Upper bounds are excluded so
+      // that points on faces shared by MeshBlocks are owned by exactly one of them, and
+      // are not counted twice in sums over ranks, except on the outer Mesh boundary
+      // (where x?max is set exactly to the Mesh bounds) which no other MeshBlock owns.
+      bool in_x1 = (rcoord.h_view(n,0) >= x1min) && (rcoord.h_view(n,0) < x1max ||
+                   (x1max == msize.x1max && rcoord.h_view(n,0) == x1max));
+      bool in_x2 = (rcoord.h_view(n,1) >= x2min) && (rcoord.h_view(n,1) < x2max ||
+                   (x2max == msize.x2max && rcoord.h_view(n,1) == x2max));
+      bool in_x3 = (rcoord.h_view(n,2) >= x3min) && (rcoord.h_view(n,2) < x3max ||
+                   (x3max == msize.x3max && rcoord.h_view(n,2) == x3max));
+      if (in_x1 && in_x2 && in_x3) {
         iindcs.h_view(n,0) = m;
         iindcs.h_view(n,1) = static_cast<int>(std::floor((rcoord.h_view(n,0)-
                                                           (x1min+dx1/2.0))/dx1));
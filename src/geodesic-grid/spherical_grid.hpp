@@ -29,13 +29,16 @@ class SphericalGrid: public GeodesicGrid {
     DualArray2D<Real> interp_vals;   // container for data interpolated to sphere
     void InterpolateToSphere(int nvars, DvceArray5D<Real> &val);  // interpolate to sphere
 
- private:
-    MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
+    // indices and weights are public so that several SphericalGrids can be interpolated
+    // to in a single kernel (e.g. by SurfaceFluxOutput)
     DualArray2D<int> interp_indcs;   // indices of MeshBlock and zones therein for interp
     DualArray3D<Real> interp_wghts;  // weights for interpolation
-    void SetInterpolationCoordinates();  // set indexing for interpolation
     void SetInterpolationIndices();      // set indexing for interpolation
     void SetInterpolationWeights();      // set weights for interpolation
+
+ private:
+    MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
+    void SetInterpolationCoordinates();  // set indexing for interpolation
 };
 
 #endif // GEODESIC_GRID_SPHERICAL_GRID_HPP_
@@ -0,0 +1,456 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file gravity.cpp
+//  \brief implementation of Gravity class: source and boundary conditions for the
+//  Poisson equation solved by the MultigridSolver
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "driver/driver.hpp"
+#include "multigrid/multigrid.hpp"
+#include "utils/memory_usage.hpp"
+#include "gravity.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace gravity {
+//----------------------------------------------------------------------------------------
+// constructor, initializes data structures and parameters
+
+Gravity::Gravity(MeshBlockPack *ppack, ParameterInput *pin) :
+    pmy_pack(ppack),
+    mp_coeff("mp_coeff",1),
+    disk_sigma(0.0),
+    disk_zc(0.0),
+    disk_coeff("disk_coeff",1) {
+  Mesh *pm = ppack->pmesh;
+  four_pi_G = pin->GetReal("gravity", "four_pi_G");
+  lmax = pin->GetOrAddInteger("gravity", "lmax", 4);
+  mp_x1 = pin->GetOrAddReal("gravity", "mp_x1", 0.0);
+  mp_x2 = pin->GetOrAddReal("gravity", "mp_x2", 0.0);
+  mp_x3 = pin->GetOrAddReal("gravity", "mp_x3", 0.0);
+  if (lmax < 0 || lmax > GRAVITY_MAX_LMAX) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<gravity>/lmax must be between 0 and " << GRAVITY_MAX_LMAX << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  disk_nmodes = pin->GetOrAddInteger("gravity", "disk_nmodes", 4);
+  if (disk_nmodes < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<gravity>/disk_nmodes must be non-negative" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // boundary conditions, and check they are consistent with Mesh
+  bool per[3];
+  for (int d=0; d<3; ++d) {
+    per[d] = (pm->mesh_bcs[2*d] == BoundaryFlag::periodic);
+  }
+  std::string bc_name = pin->GetOrAddString("gravity", "bc", "periodic");
+  if (bc_name.compare("periodic") == 0) {
+    bc = GravityBC::periodic;
+    if (!(pm->strictly_periodic)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<gravity>/bc = periodic requires periodic boundaries "
+                << "on all faces of the Mesh" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  } else if (bc_name.compare("isolated") == 0) {
+    bc = GravityBC::isolated;
+    if (!(pm->three_d) || per[0] || per[1] || per[2]) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<gravity>/bc = isolated requires a 3D Mesh with no "
+                << "periodic boundaries" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  } else if (bc_name.compare("disk") == 0) {
+    bc = GravityBC::disk;
+    if (!(pm->three_d) || !(per[0]) || !(per[1]) || per[2]) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<gravity>/bc = disk requires a 3D Mesh periodic in x1 "
+                << "and x2 only" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "<gravity>/bc = '" << bc_name << "' not implemented" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  pmg = new MultigridSolver(ppack, pin, "gravity", "Gravity");
+  phi = pmg->u;
+  Kokkos::deep_copy(phi, 0.0);
+  if (bc != GravityBC::periodic) {
+    pmg->physical_bcs = [this](DvceArray5D<Real> &u) {SetBoundaryPotential(u);};
+  }
+  Kokkos::realloc(mp_coeff, (lmax+1)*(lmax+1));
+  // cos and sin coefficients at inner and outer x3 faces for each mode
+  int ndisk = (2*disk_nmodes + 1)*(2*disk_nmodes + 1) - 1;
+  Kokkos::realloc(disk_coeff, std::max(2*ndisk, 1));
+  memory_usage::TrackArrays("Gravity", mp_coeff, disk_coeff);
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+Gravity::~Gravity() {
+  delete pmg;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::IncludeSolveTask()
+//! \brief Includes task that solves for the potential in the "before_stagen" task list,
+//! so that the potential is consistent with the fluid at the start of each stage.
+
+void Gravity::IncludeSolveTask(std::shared_ptr<TaskList> tl, TaskID start) {
+  tl->AddTask(&Gravity::SolvePoisson, this, start, "Gravity::SolvePoisson");
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Gravity::SolvePoisson()
+//! \brief Task wrapper around Solve()
+
+TaskStatus Gravity::SolvePoisson(Driver *pdrive, int stage) {
+  Solve();
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::Solve()
+//! \brief Computes gravitational potential of the current conserved density.  The
+//! previous potential is used as the initial guess.  Must be called by all ranks.
+
+void Gravity::Solve() {
+  SetSource();
+  if (bc == GravityBC::isolated) {
+    ComputeMultipoles();
+  } else if (bc == GravityBC::disk) {
+    ComputeDiskMoments();
+  }
+  pmg->Solve();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::SetSource()
+//! \brief Sets source term four_pi_G*rho of Poisson equation, subtracting mean density
+//! with periodic boundaries.
+
+void Gravity::SetSource() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, ie = indcs.ie, nx1 = indcs.nx1;
+  int js = indcs.js, je = indcs.je, nx2 = indcs.nx2;
+  int ks = indcs.ks, ke = indcs.ke, nx3 = indcs.nx3;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto &u0 = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->u0 : pmy_pack->pmhd->u0;
+
+  Real rho_mean = 0.0;
+  if (bc == GravityBC::periodic) {
+    const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+    const int nkji = nx3*nx2*nx1;
+    const int nji  = nx2*nx1;
+    auto &size = pmy_pack->pmb->mb_size;
+    Kokkos::parallel_reduce("grav_mean",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &sum) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+      sum += vol*u0(m,IDN,k,j,i);
+    }, Kokkos::Sum<Real>(rho_mean));
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &rho_mean, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    auto &msize = pm->mesh_size;
+    rho_mean /= (msize.x1max - msize.x1min)*(msize.x2max - msize.x2min)*
+                (msize.x3max - msize.x3min);
+  }
+
+  Real fpg = four_pi_G;
+  auto &src = pmg->src;
+  par_for("grav_src", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    src(m,0,k,j,i) = fpg*(u0(m,IDN,k,j,i) - rho_mean);
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::ComputeMultipoles()
+//! \brief Computes coefficients of the multipole expansion of the potential outside the
+//! mass distribution, used to set the potential in ghost cells at the faces of the Mesh.
+//! Moments are summed in groups of NREDUCTION_VARIABLES.  Must be called by all ranks.
+
+void Gravity::ComputeMultipoles() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &u0 = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->u0 : pmy_pack->pmhd->u0;
+  int lmax_ = lmax;
+  int ncoeff = (lmax+1)*(lmax+1);
+  Real x0 = mp_x1, y0 = mp_x2, z0 = mp_x3;
+
+  for (int n0=0; n0<ncoeff; n0+=NREDUCTION_VARIABLES) {
+    array_sum::GlobalSum sum_this_rank;
+    Kokkos::parallel_reduce("grav_mp",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      Real x = size.d_view(m).x1min + (i - is + 0.5)*size.d_view(m).dx1 - x0;
+      Real y = size.d_view(m).x2min + (j - js + 0.5)*size.d_view(m).dx2 - y0;
+      Real z = size.d_view(m).x3min + (k - ks + 0.5)*size.d_view(m).dx3 - z0;
+      Real dm = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3*
+                u0(m,IDN,k,j,i);
+      Real b[(GRAVITY_MAX_LMAX+1)*(GRAVITY_MAX_LMAX+1)];
+      SolidHarmonics(lmax_, x, y, z, b);
+      array_sum::GlobalSum mvars;
+      for (int n=0; n<NREDUCTION_VARIABLES && n0+n<ncoeff; ++n) {
+        mvars.the_array[n] = dm*b[n0+n];
+      }
+      mb_sum += mvars;
+    }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_rank));
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, sum_this_rank.the_array, NREDUCTION_VARIABLES,
+                  MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    for (int n=0; n<NREDUCTION_VARIABLES && n0+n<ncoeff; ++n) {
+      mp_coeff.h_view(n0+n) = sum_this_rank.the_array[n];
+    }
+  }
+
+  // fold -G (2 - delta_m0) (l-m)!/(l+m)! into coefficients
+  Real grav_const = four_pi_G/(4.0*M_PI);
+  for (int l=0; l<=lmax; ++l) {
+    mp_coeff.h_view(l*l) *= -grav_const;
+    for (int m=1; m<=l; ++m) {
+      Real fac = 2.0;
+      for (int n=l-m+1; n<=l+m; ++n) {fac /= static_cast<Real>(n);}
+      mp_coeff.h_view(l*l + 2*m - 1) *= -grav_const*fac;
+      mp_coeff.h_view(l*l + 2*m    ) *= -grav_const*fac;
+    }
+  }
+  mp_coeff.template modify<HostMemSpace>();
+  mp_coeff.template sync<DevExeSpace>();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::ComputeDiskMoments()
+//! \brief Computes surface density and center of mass in x3 of the fluid, used to set
+//! the potential of the equivalent infinite sheet (k=0 mode) at the x3 faces of the Mesh,
+//! and coefficients of Fourier modes k = 2 pi (n1/Lx1, n2/Lx2) of the potential outside
+//! the mass at each x3 face
+//!   phi_k = -(four_pi_G/2|k|) int rho_k(z') exp(-|k| |z - z'|) dz'
+//! Modes k and -k are combined, so only half of the (n1,n2) plane is summed.  Distances
+//! are measured from the face so that the exponentials are at most one.  Moments are
+//! summed in groups of NREDUCTION_VARIABLES.  Must be called by all ranks.
+
+void Gravity::ComputeDiskMoments() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &u0 = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->u0 : pmy_pack->pmhd->u0;
+  auto &msize = pm->mesh_size;
+  Real kx = 2.0*M_PI/(msize.x1max - msize.x1min);
+  Real ky = 2.0*M_PI/(msize.x2max - msize.x2min);
+  Real zmin = msize.x3min, zmax = msize.x3max;
+  int nmax = disk_nmodes;
+  int nmodes = ((2*nmax + 1)*(2*nmax + 1) - 1)/2;
+  // mass, mass*z, then (cos,sin) at (inner,outer) face for each mode
+  int ncoeff = 2 + 4*nmodes;
+  Real mass = 0.0, mass_z = 0.0;
+
+  for (int n0=0; n0<ncoeff; n0+=NREDUCTION_VARIABLES) {
+    array_sum::GlobalSum sum_this_rank;
+    Kokkos::parallel_reduce("grav_disk",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      Real x = size.d_view(m).x1min + (i - is + 0.5)*size.d_view(m).dx1;
+      Real y = size.d_view(m).x2min + (j - js + 0.5)*size.d_view(m).dx2;
+      Real z = size.d_view(m).x3min + (k - ks + 0.5)*size.d_view(m).dx3;
+      Real dm = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3*
+                u0(m,IDN,k,j,i);
+      array_sum::GlobalSum dvars;
+      for (int n=0; n<NREDUCTION_VARIABLES && n0+n<ncoeff; ++n) {
+        int nc = n0 + n;
+        if (nc == 0) {
+          dvars.the_array[n] = dm;
+        } else if (nc == 1) {
+          dvars.the_array[n] = dm*z;
+        } else {
+          int q = (nc - 2)/4, face = ((nc - 2)/2)%2, is_sin = (nc - 2)%2;
+          int n1, n2;
+          DiskMode(q, nmax, n1, n2);
+          Real k1 = n1*kx, k2 = n2*ky;
+          Real kmag = sqrt(k1*k1 + k2*k2);
+          Real w = (face == 0)? exp(-kmag*(z - zmin)) : exp(-kmag*(zmax - z));
+          Real phase = k1*x + k2*y;
+          dvars.the_array[n] = dm*w*((is_sin == 1)? sin(phase) : cos(phase));
+        }
+      }
+      mb_sum += dvars;
+    }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_rank));
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, sum_this_rank.the_array, NREDUCTION_VARIABLES,
+                  MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    for (int n=0; n<NREDUCTION_VARIABLES && n0+n<ncoeff; ++n) {
+      int nc = n0 + n;
+      if (nc == 0) {
+        mass = sum_this_rank.the_array[n];
+      } else if (nc == 1) {
+        mass_z = sum_this_rank.the_array[n];
+      } else {
+        disk_coeff.h_view(nc-2) = sum_this_rank.the_array[n];
+      }
+    }
+  }
+
+  Real area = (msize.x1max - msize.x1min)*(msize.x2max - msize.x2min);
+  disk_sigma = mass/area;
+  disk_zc = (mass > 0.0)? mass_z/mass : 0.0;
+  // fold -four_pi_G/(|k| area) into coefficients (factor 2 for modes k and -k included)
+  for (int q=0; q<nmodes; ++q) {
+    int n1, n2;
+    DiskMode(q, nmax, n1, n2);
+    Real kmag = std::sqrt(SQR(n1*kx) + SQR(n2*ky));
+    for (int n=4*q; n<4*q+4; ++n) {
+      disk_coeff.h_view(n) *= -four_pi_G/(kmag*area);
+    }
+  }
+  disk_coeff.template modify<HostMemSpace>();
+  disk_coeff.template sync<DevExeSpace>();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Gravity::SetBoundaryPotential()
+//! \brief Sets potential in all ghost cells at the non-periodic faces of the Mesh, using
+//! the compact lists of MeshBlocks with physical boundaries at each face.
+
+void Gravity::SetBoundaryPotential(DvceArray5D<Real> &u) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &bcs_list = pmy_pack->pmb->bcs_list;
+  auto &nbcs = pmy_pack->pmb->nbcs_list;
+  bool isolated = (bc == GravityBC::isolated);
+  int lmax_ = lmax;
+  Real x0 = mp_x1, y0 = mp_x2, z0 = mp_x3;
+  auto &coeff = mp_coeff;
+  Real sheet = 0.5*four_pi_G*disk_sigma;
+  Real zc = disk_zc;
+  auto &msize = pmy_pack->pmesh->mesh_size;
+  Real kx = 2.0*M_PI/(msize.x1max - msize.x1min);
+  Real ky = 2.0*M_PI/(msize.x2max - msize.x2min);
+  Real zmin = msize.x3min, zmax = msize.x3max;
+  int nmax = disk_nmodes;
+  int nmodes = ((2*nmax + 1)*(2*nmax + 1) - 1)/2;
+  auto &dcoeff = disk_coeff;
+
+  // loop over x1, x2, x3 faces; ghost slabs span all cells in transverse directions
+  for (int d=0; d<3; ++d) {
+    int nin = nbcs[2*d];
+    int nl = nin + nbcs[2*d+1];
+    if (nl == 0) continue;
+    int nt1 = (d == 0)? n2 : n1;
+    int nt2 = (d == 2)? n2 : n3;
+    par_for("grav_bc", DevExeSpace(), 0, (nl-1), 0, (ng-1), 0, (nt2-1), 0, (nt1-1),
+    KOKKOS_LAMBDA(int l, int g, int t2, int t1) {
+      int face = (l < nin)? 2*d : 2*d+1;
+      int m = (l < nin)? bcs_list.d_view(face,l) : bcs_list.d_view(face,l-nin);
+      int i, j, k;
+      if (d == 0) {
+        i = (l < nin)? is - g - 1 : ie + g + 1; j = t1; k = t2;
+      } else if (d == 1) {
+        i = t1; j = (l < nin)? js - g - 1 : je + g + 1; k = t2;
+      } else {
+        i = t1; j = t2; k = (l < nin)? ks - g - 1 : ke + g + 1;
+      }
+      Real z = size.d_view(m).x3min + (k - ks + 0.5)*size.d_view(m).dx3;
+      if (isolated) {
+        Real x = size.d_view(m).x1min + (i - is + 0.5)*size.d_view(m).dx1 - x0;
+        Real y = size.d_view(m).x2min + (j - js + 0.5)*size.d_view(m).dx2 - y0;
+        z -= z0;
+        Real b[(GRAVITY_MAX_LMAX+1)*(GRAVITY_MAX_LMAX+1)];
+        SolidHarmonics(lmax_, x, y, z, b);
+        Real rinv2 = 1.0/(x*x + y*y + z*z);
+        Real rfac = sqrt(rinv2);     // r^-(2l+1)
+        Real pot = 0.0;
+        for (int ll=0; ll<=lmax_; ++ll) {
+          for (int n=ll*ll; n<(ll+1)*(ll+1); ++n) {
+            pot += coeff.d_view(n)*b[n]*rfac;
+          }
+          rfac *= rinv2;
+        }
+        u(m,0,k,j,i) = pot;
+      } else {
+        // modes decay away from face into the ghost cells
+        Real x = size.d_view(m).x1min + (i - is + 0.5)*size.d_view(m).dx1;
+        Real y = size.d_view(m).x2min + (j - js + 0.5)*size.d_view(m).dx2;
+        int face = (l < nin)? 0 : 1;
+        Real dz = (face == 0)? (zmin - z) : (z - zmax);
+        Real pot = sheet*fabs(z - zc);
+        for (int q=0; q<nmodes; ++q) {
+          int n1, n2;
+          DiskMode(q, nmax, n1, n2);
+          Real k1 = n1*kx, k2 = n2*ky;
+          Real phase = k1*x + k2*y;
+          Real cc = dcoeff.d_view(4*q + 2*face), cs = dcoeff.d_view(4*q + 2*face + 1);
+          pot += exp(-sqrt(k1*k1 + k2*k2)*dz)*(cc*cos(phase) + cs*sin(phase));
+        }
+        u(m,0,k,j,i) = pot;
+      }
+    });
+  }
+  return;
+}
+
+} // namespace gravity
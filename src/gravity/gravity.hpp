@@ -0,0 +1,152 @@
+#ifndef GRAVITY_GRAVITY_HPP_
+#define GRAVITY_GRAVITY_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file gravity.hpp
+//  \brief self-gravity of the fluid (Hydro or MHD).  The gravitational potential is
+//  found from Lap(phi) = four_pi_G rho with the MultigridSolver at the start of every
+//  stage, and the resulting acceleration is added as a source term in SourceTerms.
+//
+//  Input parameters in the <gravity> block:
+//    four_pi_G   4 pi times gravitational constant in code units (required)
+//    bc          boundary conditions on phi: periodic (default), isolated, or disk
+//                  periodic: strictly periodic Mesh, mean density is subtracted (Jeans
+//                            swindle) and phi has zero mean
+//                  isolated: 3D Mesh with no periodic faces, phi at the faces of the Mesh
+//                            is given by a multipole expansion of the density about
+//                            (mp_x1,mp_x2,mp_x3) up to l = lmax
+//                  disk:     3D Mesh periodic in x1 and x2 only, phi at the x3 faces is
+//                            that of the density expanded in Fourier modes in x1 and x2,
+//                            each of which decays as exp(-|k| dz) away from the mass,
+//                            plus the infinite sheet with the same surface density (k=0)
+//    lmax        maximum l of multipole expansion (default 4, at most 8)
+//    mp_x1, mp_x2, mp_x3  center of multipole expansion (default 0)
+//    disk_nmodes maximum |n1|, |n2| of Fourier modes k = 2 pi (n1/Lx1, n2/Lx2) used with
+//                bc = disk (default 4, 0 retains only the sheet).  Higher modes are set
+//                to zero at the faces, which is accurate if they decay over the distance
+//                between the mass and the faces.
+//    mg_*        parameters of the multigrid solver, see multigrid/multigrid.hpp
+
+#include <memory>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+class MultigridSolver;
+class Driver;
+
+#define GRAVITY_MAX_LMAX 8
+
+namespace gravity {
+
+//! \enum GravityBC
+//! \brief boundary conditions on the potential at non-periodic faces of the Mesh
+enum class GravityBC {periodic, isolated, disk};
+
+//----------------------------------------------------------------------------------------
+//! \class Gravity
+//! \brief gravitational potential of the fluid and functions to compute it
+
+class Gravity {
+ public:
+  Gravity(MeshBlockPack *ppack, ParameterInput *pin);
+  ~Gravity();
+
+  // data
+  Real four_pi_G;            // 4 pi times gravitational constant
+  GravityBC bc;
+  MultigridSolver *pmg;      // solver, owns potential and source arrays
+  DvceArray5D<Real> phi;     // potential (same memory as pmg->u), including ghosts
+
+  // functions
+  void IncludeSolveTask(std::shared_ptr<TaskList> tl, TaskID start);
+  TaskStatus SolvePoisson(Driver *pdrive, int stage);
+  void Solve();
+
+ private:
+  MeshBlockPack *pmy_pack;   // ptr to MeshBlockPack containing this Gravity
+  int lmax;                  // max l of multipole expansion
+  Real mp_x1, mp_x2, mp_x3;  // center of multipole expansion
+  DualArray1D<Real> mp_coeff;   // coefficients of multipole expansion of phi
+  Real disk_sigma, disk_zc;     // surface density and center of mass in x3 (disk BC)
+  int disk_nmodes;              // max |n1|, |n2| of Fourier modes (disk BC)
+  DualArray1D<Real> disk_coeff; // cos and sin coefficients of modes at x3 faces
+
+  void SetSource();
+  void ComputeMultipoles();
+  void ComputeDiskMoments();
+  void SetBoundaryPotential(DvceArray5D<Real> &u);
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void SolidHarmonics()
+//! \brief Computes r^l P_l^m(cos(theta)) cos(m phi) and r^l P_l^m(cos(theta)) sin(m phi)
+//! for all 0 <= m <= l <= lmax, at position (x,y,z) relative to the expansion center.
+//! Associated Legendre functions exclude the Condon-Shortley phase.  Results are stored
+//! in b[l*l] (m=0), b[l*l + 2m - 1] (cos), and b[l*l + 2m] (sin) for m>0.
+
+KOKKOS_INLINE_FUNCTION
+void SolidHarmonics(const int lmax, const Real x, const Real y, const Real z,
+                    Real b[(GRAVITY_MAX_LMAX+1)*(GRAVITY_MAX_LMAX+1)]) {
+  // cos(m phi) and sin(m phi), times (r sin(theta))^m = rho_cyl^m
+  Real cm = 1.0, sm = 0.0;        // rho_cyl^m cos(m phi), rho_cyl^m sin(m phi)
+  Real pmm = 1.0;                  // (2m-1)!!
+  Real r2 = x*x + y*y + z*z;
+  for (int m=0; m<=lmax; ++m) {
+    // r^l P_l^m / rho_cyl^m satisfies a recursion in l using only z and r^2
+    Real p0 = pmm;                               // l = m
+    Real p1 = z*(2*m + 1)*pmm;                   // l = m+1
+    for (int l=m; l<=lmax; ++l) {
+      Real val;
+      if (l == m) {
+        val = p0;
+      } else if (l == m+1) {
+        val = p1;
+      } else {
+        Real p2 = ((2*l - 1)*z*p1 - (l + m - 1)*r2*p0)/static_cast<Real>(l - m);
+        p0 = p1;
+        p1 = p2;
+        val = p2;
+      }
+      if (m == 0) {
+        b[l*l] = val;
+      } else {
+        b[l*l + 2*m - 1] = val*cm;
+        b[l*l + 2*m    ] = val*sm;
+      }
+    }
+    // advance to m+1
+    Real cn = cm*x - sm*y;
+    Real sn = sm*x + cm*y;
+    cm = cn;
+    sm = sn;
+    pmm *= static_cast<Real>(2*m + 1);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void DiskMode()
+//! \brief Returns integers (n1,n2) of Fourier mode q = 0,...,((2 nmax + 1)^2 - 3)/2 used
+//! with disk boundary conditions.  Only half of the (n1,n2) plane is needed since the
+//! density is real: n2 = 0 with n1 > 0, then n2 > 0 with -nmax <= n1 <= nmax.
+
+KOKKOS_INLINE_FUNCTION
+void DiskMode(const int q, const int nmax, int &n1, int &n2) {
+  if (q < nmax) {
+    n1 = q + 1;
+    n2 = 0;
+  } else {
+    n1 = (q - nmax)%(2*nmax + 1) - nmax;
+    n2 = (q - nmax)/(2*nmax + 1) + 1;
+  }
+}
+
+} // namespace gravity
+
+#endif // GRAVITY_GRAVITY_HPP_
@@ -0,0 +1,59 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file gravity_srcterms.cpp
+//! \brief Implements self-gravity source terms.  All functions are members of the
+//! SourceTerm class
+
+#include <iostream>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "gravity/gravity.hpp"
+#include "srcterms/srcterms.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn SourceTerms::SelfGravity
+//! \brief Self-gravity source terms in the momentum and energy equations, using the
+//! potential computed by the Gravity class at the start of the stage.  The same function
+//! is used for Hydro and MHD.
+//! Note: srcterms must be computed using primitive (w0) and NOT conserved (u0) vars
+
+void SourceTerms::SelfGravity(const DvceArray5D<Real> &w0, const EOS_Data &eos_data,
+                              const Real bdt, DvceArray5D<Real> &u0) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &phi = pmy_pack->pgrav->phi;
+
+  par_for("self_grav", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real den = w0(m,IDN,k,j,i);
+    // centered differences of potential
+    Real src1 = -bdt*den*(phi(m,0,k,j,i+1) - phi(m,0,k,j,i-1))/(2.0*size.d_view(m).dx1);
+    Real src2 = 0.0, src3 = 0.0;
+    if (multi_d) {
+      src2 = -bdt*den*(phi(m,0,k,j+1,i) - phi(m,0,k,j-1,i))/(2.0*size.d_view(m).dx2);
+    }
+    if (three_d) {
+      src3 = -bdt*den*(phi(m,0,k+1,j,i) - phi(m,0,k-1,j,i))/(2.0*size.d_view(m).dx3);
+    }
+    u0(m,IM1,k,j,i) += src1;
+    u0(m,IM2,k,j,i) += src2;
+    u0(m,IM3,k,j,i) += src3;
+    if (eos_data.is_ideal) {
+      u0(m,IEN,k,j,i) += src1*w0(m,IVX,k,j,i) + src2*w0(m,IVY,k,j,i) +
+                         src3*w0(m,IVZ,k,j,i);
+    }
+  });
+
+  return;
+}
@@ -19,6 +19,8 @@
 #include "srcterms/srcterms.hpp"
 #include "shearing_box/shearing_box.hpp"
 #include "bvals/bvals.hpp"
+#include "utils/memory_usage.hpp"
+#include "utils/first_touch.hpp"
 #include "hydro/hydro.hpp"
 
 namespace hydro {
@@ -101,8 +103,8 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(u0, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-    Kokkos::realloc(w0, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+    ReallocFirstTouch(u0, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+    ReallocFirstTouch(w0, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
   }
 
   // allocate memory for conserved variables on coarse mesh
@@ -116,8 +118,13 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
   }
 
   // allocate boundary buffers for conserved (cell-centered) variables
+  int nghost = MeshBoundaryValues::GhostDepth(ppack, pin, "hydro");
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
-  pbval_u->InitializeBuffers((nhydro+nscalars));
+  pbval_u->InitializeBuffers((nhydro+nscalars), nghost);
+
+  // register arrays and boundary buffers for memory accounting
+  memory_usage::TrackArrays("Hydro", u0, w0, coarse_u0, coarse_w0, u1, uflx, fofc, utest);
+  memory_usage::Track("Hydro", [this]() {return pbval_u->MemoryUsage();});
 
   // Orbital advection and shearing box BCs (if requested in input file)
   if (pin->DoesBlockExist("shearing_box")) {
@@ -139,30 +146,35 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       recon_method = ReconstructionMethod::dc;
     } else if (xorder.compare("plm") == 0) {
       recon_method = ReconstructionMethod::plm;
+      // check that nghost > 1
+      if (nghost < 2) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << xorder << " reconstruction requires at least 2 ghost zones, "
+          << "but <hydro>/nghost=" << nghost << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
       // check that nghost > 2 with PLM+FOFC
-      auto &indcs = pmy_pack->pmesh->mb_indcs;
-      if (use_fofc && indcs.ng < 3) {
+      if (use_fofc && nghost < 3) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "FOFC and " << xorder << " reconstruction requires at "
-          << "least 3 ghost zones, but <mesh>/nghost=" << indcs.ng << std::endl;
+          << "least 3 ghost zones, but <hydro>/nghost=" << nghost << std::endl;
         std::exit(EXIT_FAILURE);
       }
     } else if (xorder.compare("ppm4") == 0 ||
                xorder.compare("ppmx") == 0 ||
                xorder.compare("wenoz") == 0) {
       // check that nghost > 2
-      auto &indcs = pmy_pack->pmesh->mb_indcs;
-      if (indcs.ng < 3) {
+      if (nghost < 3) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << xorder << " reconstruction requires at least 3 ghost zones, "
-          << "but <mesh>/nghost=" << indcs.ng << std::endl;
+          << "but <hydro>/nghost=" << nghost << std::endl;
         std::exit(EXIT_FAILURE);
       }
       // check that nghost > 3 with PPM4(or PPMX or WENOZ)+FOFC
-      if (use_fofc && indcs.ng < 4) {
+      if (use_fofc && nghost < 4) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "FOFC and " << xorder << " reconstruction requires at "
-          << "least 4 ghost zones, but <mesh>/nghost=" << indcs.ng << std::endl;
+          << "least 4 ghost zones, but <hydro>/nghost=" << nghost << std::endl;
         std::exit(EXIT_FAILURE);
       }
       if (xorder.compare("ppm4") == 0) {
@@ -272,10 +284,10 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       int ncells1 = indcs.nx1 + 2*(indcs.ng);
       int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
       int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-      Kokkos::realloc(u1,       nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x1f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x2f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(uflx.x3f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      ReallocFirstTouch(u1,       nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      ReallocFirstTouch(uflx.x1f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      ReallocFirstTouch(uflx.x2f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      ReallocFirstTouch(uflx.x3f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
 
       // allocate array of flags used with FOFC
       if (use_fofc) {
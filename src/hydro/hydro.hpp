@@ -37,6 +37,7 @@ enum class Hydro_RSolver {advect, llf, hlle, hllc, roe,    // non-relativistic
 //  \brief container to hold TaskIDs of all hydro tasks
 
 struct HydroTaskIDs {
+  TaskID cond_sts;
   TaskID irecv;
   TaskID copyu;
   TaskID flux;
@@ -80,6 +80,9 @@ void Hydro::FOFC(Driver *pdriver, int stage) {
     // Test whether conversion to primitives requires floors
     // Note b0 and w0 passed to function, but not used/changed.
     peos->ConsToPrim(utest_, w0, true, il, iu, jl, ju, kl, ku);
+
+    // Also flag all cells in MeshBlocks with many C2P failures/floors in last cycle
+    peos->FlagFOFCFromEvents(fofc, il, iu, jl, ju, kl, ku);
   }
 
   auto &coord = pmy_pack->pcoord->coord_data;
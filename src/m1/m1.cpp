@@ -0,0 +1,190 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1.cpp
+//! \brief implementation of M1 class constructor and destructor
+
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals/bvals.hpp"
+#include "coordinates/coordinates.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
+#include "utils/memory_usage.hpp"
+#include "m1/m1.hpp"
+
+namespace m1 {
+//----------------------------------------------------------------------------------------
+// constructor, initializes data structures and parameters
+
+M1::M1(MeshBlockPack *ppack, ParameterInput *pin) :
+    pmy_pack(ppack),
+    lepton("m1_lepton",1),
+    u0("m1_u0",1,1,1,1,1),
+    coarse_u0("m1_cu0",1,1,1,1,1),
+    u1("m1_u1",1,1,1,1,1),
+    uflx("m1_uflx",1,1,1,1,1),
+    fcc("m1_fcc",1,1,1,1,1),
+    pcl("m1_pcl",1,1,1,1,1),
+    kap_a("m1_kap_a",1,1,1,1,1),
+    kap_s("m1_kap_s",1,1,1,1,1),
+    eta("m1_eta",1,1,1,1,1),
+    kap_n("m1_kap_n",1,1,1,1,1),
+    eta_n("m1_eta_n",1,1,1,1,1) {
+  // Check for AMR and exit if enabled.
+  // TODO(@user): Extend AMR and load balancing to work with M1
+  if (pmy_pack->pmesh->adaptive) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "M1 does not yet work with AMR" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // In GR the 3+1 metric is taken from the ADM variables (set by the problem generator
+  // for stationary spacetimes, or evolved by Z4c).  Otherwise space is flat.
+  if (pmy_pack->pcoord->is_general_relativistic && pmy_pack->padm == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "M1 in general relativity requires an <adm> or <z4c> block in "
+      << "input file" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // The radiation field only couples to the fluid evolved with dynamical GRMHD
+  if (pmy_pack->phydro != nullptr ||
+      (pmy_pack->pmhd != nullptr && pmy_pack->pdyngr == nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "M1 only couples to fluid evolved with dynamical GRMHD (<mhd> "
+      << "with <adm> or <z4c> blocks)" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  nspecies = pin->GetOrAddInteger("m1","nspecies",1);
+  evolve_number = pin->GetOrAddBoolean("m1","evolve_number",false);
+  nvars = (evolve_number)? 5 : 4;
+  if (nspecies < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<m1> nspecies = " << nspecies << " must be >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // select analytic closure (default Minerbo)
+  {std::string clos = pin->GetOrAddString("m1","closure","minerbo");
+    if (clos.compare("minerbo") == 0) {
+      closure = M1Closure::minerbo;
+    } else if (clos.compare("levermore") == 0) {
+      closure = M1Closure::levermore;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<m1> closure = '" << clos << "' not implemented"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  closure_iter = pin->GetOrAddInteger("m1","closure_iter",10);
+  ap_correction = pin->GetOrAddBoolean("m1","ap_correction",true);
+  e_floor = pin->GetOrAddReal("m1","e_floor",1.0e-15);
+
+  // select reconstruction method (default PLM)
+  {std::string xorder = pin->GetOrAddString("m1","reconstruct","plm");
+    if (xorder.compare("dc") == 0) {
+      recon_method = ReconstructionMethod::dc;
+    } else if (xorder.compare("plm") == 0) {
+      recon_method = ReconstructionMethod::plm;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<m1> recon = '" << xorder << "' not implemented"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  // radiation-matter coupling.  Feedback on fluid is enabled by default when the fluid
+  // is evolved, and the lepton number of each species is used to update Y_e (the first
+  // passive scalar) when number densities are evolved.
+  rad_source = pin->GetOrAddBoolean("m1","rad_source",true);
+  if (pmy_pack->pdyngr != nullptr) {
+    affect_fluid = pin->GetOrAddBoolean("m1","affect_fluid",true);
+    mb = pmy_pack->pdyngr->GetBaryonMass();
+  } else {
+    affect_fluid = false;
+    mb = 1.0;
+  }
+  Kokkos::realloc(lepton, nspecies);
+  for (int s=0; s<nspecies; ++s) {
+    lepton.h_view(s) = pin->GetOrAddReal("m1","lepton_"+std::to_string(s),0.0);
+  }
+  lepton.template modify<HostMemSpace>();
+  lepton.template sync<DevExeSpace>();
+  if (affect_fluid && evolve_number && pmy_pack->pmhd->nscalars < 1) {
+    bool carries_lepton = false;
+    for (int s=0; s<nspecies; ++s) {
+      if (lepton.h_view(s) != 0.0) {carries_lepton = true;}
+    }
+    if (carries_lepton) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "M1 species carry lepton number, but <mhd> has no "
+                << "passive scalar to store Y_e" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  int nmb = ppack->nmb_thispack;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmom = nspecies*nvars;
+
+  // allocate memory for moments and closure
+  Kokkos::realloc(u0, nmb, nmom, ncells3, ncells2, ncells1);
+  Kokkos::realloc(u1, nmb, nmom, ncells3, ncells2, ncells1);
+  Kokkos::realloc(fcc, nmb, nmom, ncells3, ncells2, ncells1);
+  Kokkos::realloc(pcl, nmb, 6*nspecies, ncells3, ncells2, ncells1);
+  Kokkos::realloc(uflx.x1f, nmb, nmom, ncells3, ncells2, ncells1);
+  Kokkos::realloc(uflx.x2f, nmb, nmom, ncells3, ncells2, ncells1);
+  Kokkos::realloc(uflx.x3f, nmb, nmom, ncells3, ncells2, ncells1);
+
+  // allocate memory for moments on coarse mesh
+  if (ppack->pmesh->multilevel) {
+    int nccells1 = indcs.cnx1 + 2*(indcs.ng);
+    int nccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
+    int nccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(coarse_u0, nmb, nmom, nccells3, nccells2, nccells1);
+  }
+
+  // allocate opacities and emissivities, and initialize to constant values
+  Kokkos::realloc(kap_a, nmb, nspecies, ncells3, ncells2, ncells1);
+  Kokkos::realloc(kap_s, nmb, nspecies, ncells3, ncells2, ncells1);
+  Kokkos::realloc(eta, nmb, nspecies, ncells3, ncells2, ncells1);
+  Kokkos::deep_copy(kap_a, pin->GetOrAddReal("m1","kappa_a",0.0));
+  Kokkos::deep_copy(kap_s, pin->GetOrAddReal("m1","kappa_s",0.0));
+  Kokkos::deep_copy(eta, pin->GetOrAddReal("m1","eta",0.0));
+  if (evolve_number) {
+    Kokkos::realloc(kap_n, nmb, nspecies, ncells3, ncells2, ncells1);
+    Kokkos::realloc(eta_n, nmb, nspecies, ncells3, ncells2, ncells1);
+    Kokkos::deep_copy(kap_n, pin->GetOrAddReal("m1","kappa_n",0.0));
+    Kokkos::deep_copy(eta_n, pin->GetOrAddReal("m1","eta_n",0.0));
+  }
+
+  // allocate boundary buffers for cell-centered variables
+  pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
+  pbval_u->InitializeBuffers(nmom);
+
+  // register arrays for memory accounting
+  memory_usage::TrackArrays("M1", u0, coarse_u0, u1, uflx.x1f, uflx.x2f, uflx.x3f, fcc,
+                            pcl, kap_a, kap_s, eta, kap_n, eta_n);
+  memory_usage::Track("M1", [this]() {return pbval_u->MemoryUsage();});
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+M1::~M1() {
+  delete pbval_u;
+}
+
+} // namespace m1
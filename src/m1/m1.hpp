@@ -0,0 +1,138 @@
+#ifndef M1_M1_HPP_
+#define M1_M1_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1.hpp
+//! \brief definitions for M1 class, which evolves the energy-integrated (gray) zeroth and
+//! first moments of the radiation (photon or neutrino) distribution function with an
+//! analytic closure.  A much cheaper alternative to the discrete-ordinates Radiation
+//! module when only angle-integrated quantities are needed.
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
+#include "bvals/bvals.hpp"
+
+// forward declarations
+class Driver;
+
+//----------------------------------------------------------------------------------------
+//! \struct M1TaskIDs
+//! \brief container to hold TaskIDs of all M1 tasks
+
+struct M1TaskIDs {
+  TaskID irecv;
+  TaskID copyu;
+  TaskID clos;
+  TaskID flux;
+  TaskID sendf;
+  TaskID recvf;
+  TaskID rkupdt;
+  TaskID restu;
+  TaskID sendu;
+  TaskID recvu;
+  TaskID bcs;
+  TaskID prol;
+  TaskID newdt;
+  TaskID csend;
+  TaskID crecv;
+  TaskID src;
+};
+
+namespace m1 {
+
+// indices of the evolved moments of each species, stored at u0(m,s*nvars+n,k,j,i).
+// All are densitized by sqrt(gamma): E = sqrt(g) E, F_i = sqrt(g) F_i, N = sqrt(g) N
+enum M1Variables {IRE=0, IRFX=1, IRFY=2, IRFZ=3, IRN=4};
+
+// analytic closures
+enum class M1Closure {minerbo, levermore};
+
+//----------------------------------------------------------------------------------------
+//! \class M1
+
+class M1 {
+ public:
+  M1(MeshBlockPack *ppack, ParameterInput *pin);
+  ~M1();
+
+  int nspecies;            // number of independently evolved species
+  int nvars;               // number of moments per species (4, or 5 if evolving number)
+  bool evolve_number;      // evolve number density N in addition to E and F_i
+  M1Closure closure;       // analytic closure used for pressure tensor
+  int closure_iter;        // max number of fixed-point iterations for closure in moving
+                           // fluid (Eddington factor depends on fluid-frame flux)
+  bool ap_correction;      // reduce numerical diffusion in optically thick cells
+  Real e_floor;            // floor on (densitized) energy density
+
+  // coupling to fluid
+  bool rad_source;         // flag to enable/disable radiation-matter source terms
+  bool affect_fluid;       // flag to enable/disable feedback of radiation on fluid
+  Real mb;                 // baryon mass (converts lepton number to D*Y)
+  DualArray1D<Real> lepton;  // lepton number carried by each species (+1, -1, or 0)
+
+  // conserved moments and fluxes
+  DvceArray5D<Real> u0;         // moments
+  DvceArray5D<Real> coarse_u0;  // moments on 2x coarser grid (for SMR)
+  DvceArray5D<Real> u1;         // moments at intermediate step
+  DvceFaceFld5D<Real> uflx;     // fluxes of moments on zone faces
+  DvceArray5D<Real> fcc;        // cell-centered fluxes (scratch)
+
+  // closure P^{ij}, six components per species: xx,xy,xz,yy,yz,zz (densitized)
+  DvceArray5D<Real> pcl;
+
+  // emissivities and opacities of each species (fluid frame).  Set to constant values
+  // from the input file, or every step by user-enrolled function in problem generator
+  DvceArray5D<Real> kap_a;      // absorption opacity (energy)
+  DvceArray5D<Real> kap_s;      // scattering opacity
+  DvceArray5D<Real> eta;        // energy emissivity
+  DvceArray5D<Real> kap_n;      // absorption opacity (number)
+  DvceArray5D<Real> eta_n;      // number emissivity
+
+  // Boundary communication buffers and functions for u
+  MeshBoundaryValuesCC *pbval_u;
+
+  // reconstruction method
+  ReconstructionMethod recon_method;
+
+  Real dtnew;
+
+  // container to hold names of TaskIDs
+  M1TaskIDs id;
+
+  // functions...
+  void AssembleM1Tasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  // ...in "before_stagen_tl" task list
+  TaskStatus InitRecv(Driver *d, int stage);
+  // ...in "stagen_tl" task list
+  TaskStatus CopyCons(Driver *d, int stage);
+  TaskStatus CalculateClosure(Driver *d, int stage);
+  TaskStatus CalculateFluxes(Driver *d, int stage);
+  TaskStatus SendFlux(Driver *d, int stage);
+  TaskStatus RecvFlux(Driver *d, int stage);
+  TaskStatus RKUpdate(Driver *d, int stage);
+  TaskStatus RestrictU(Driver *d, int stage);
+  TaskStatus SendU(Driver *d, int stage);
+  TaskStatus RecvU(Driver *d, int stage);
+  TaskStatus ApplyPhysicalBCs(Driver* pdrive, int stage);
+  TaskStatus Prolongate(Driver* pdrive, int stage);
+  TaskStatus NewTimeStep(Driver *d, int stage);
+  // ...in "after_stagen_tl" task list
+  TaskStatus ClearSend(Driver *d, int stage);
+  TaskStatus ClearRecv(Driver *d, int stage);
+  // ...in "after_timeintegrator" task list
+  TaskStatus ImplicitSources(Driver *d, int stage);
+
+ private:
+  MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this M1
+};
+
+} // namespace m1
+#endif // M1_M1_HPP_
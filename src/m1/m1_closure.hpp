@@ -0,0 +1,282 @@
+#ifndef M1_M1_CLOSURE_HPP_
+#define M1_M1_CLOSURE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1_closure.hpp
+//! \brief Inline functions used by M1 kernels: the 3+1 metric at a cell, the analytic
+//! closure for the pressure tensor, the moments in the fluid frame, and a small linear
+//! solver for the implicit source terms.  The closure interpolates between the optically
+//! thin and thick limits following Shibata et al. (2011), PTP 125, 1255, and Foucart et
+//! al. (2015), PRD 91, 124021:
+//!   P^{ij} = (3 chi - 1)/2 P_thin^{ij} + 3 (1 - chi)/2 P_thick^{ij}
+//! with Eddington factor chi(xi) evaluated with the fluid-frame flux factor xi = |H|/J.
+
+#include "athena.hpp"
+#include "coordinates/adm.hpp"
+#include "m1/m1.hpp"
+
+namespace m1 {
+//----------------------------------------------------------------------------------------
+//! \fn void M1Metric()
+//! \brief Lapse, shift, spatial metric and its inverse, and sqrt(det g) at a cell center.
+//! Flat space in Cartesian coordinates is used when no ADM variables exist.
+
+KOKKOS_INLINE_FUNCTION
+void M1Metric(const adm::ADM::ADM_vars &adm, const bool flat,
+              const int m, const int k, const int j, const int i,
+              Real &alpha, Real beta_u[3], Real g_dd[3][3], Real g_uu[3][3],
+              Real &sdetg) {
+  if (flat) {
+    alpha = 1.0;
+    sdetg = 1.0;
+    for (int a=0; a<3; ++a) {
+      beta_u[a] = 0.0;
+      for (int b=0; b<3; ++b) {
+        g_dd[a][b] = (a == b)? 1.0 : 0.0;
+        g_uu[a][b] = g_dd[a][b];
+      }
+    }
+    return;
+  }
+  alpha = adm.alpha(m,k,j,i);
+  for (int a=0; a<3; ++a) {
+    beta_u[a] = adm.beta_u(m,a,k,j,i);
+    for (int b=0; b<3; ++b) {
+      g_dd[a][b] = adm.g_dd(m,a,b,k,j,i);
+    }
+  }
+  Real detg = adm::SpatialDet(g_dd[0][0], g_dd[0][1], g_dd[0][2],
+                              g_dd[1][1], g_dd[1][2], g_dd[2][2]);
+  sdetg = sqrt(detg);
+  adm::SpatialInv(1.0/detg, g_dd[0][0], g_dd[0][1], g_dd[0][2],
+                  g_dd[1][1], g_dd[1][2], g_dd[2][2],
+                  &g_uu[0][0], &g_uu[0][1], &g_uu[0][2],
+                  &g_uu[1][1], &g_uu[1][2], &g_uu[2][2]);
+  g_uu[1][0] = g_uu[0][1];
+  g_uu[2][0] = g_uu[0][2];
+  g_uu[2][1] = g_uu[1][2];
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void M1FluidVelocity()
+//! \brief Lorentz factor W and 3-velocity v^i of the fluid in the Eulerian frame, from
+//! the primitive velocity W v^i stored by dynamical GRMHD.  Fluid is at rest otherwise.
+
+KOKKOS_INLINE_FUNCTION
+void M1FluidVelocity(const DvceArray5D<Real> &w0, const bool moving,
+                     const Real g_dd[3][3], const int m, const int k, const int j,
+                     const int i, Real &w, Real v_u[3]) {
+  if (!(moving)) {
+    w = 1.0;
+    v_u[0] = 0.0; v_u[1] = 0.0; v_u[2] = 0.0;
+    return;
+  }
+  Real u_u[3] = {w0(m,IVX,k,j,i), w0(m,IVY,k,j,i), w0(m,IVZ,k,j,i)};
+  Real usq = 0.0;
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      usq += g_dd[a][b]*u_u[a]*u_u[b];
+    }
+  }
+  w = sqrt(1.0 + usq);
+  for (int a=0; a<3; ++a) {
+    v_u[a] = u_u[a]/w;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real EddingtonFactor()
+//! \brief Eddington factor chi as a function of flux factor xi, 0 <= xi <= 1.  Both
+//! closures give chi=1/3 in the diffusion limit (xi=0) and chi=1 for free streaming.
+
+KOKKOS_INLINE_FUNCTION
+Real EddingtonFactor(const M1Closure closure, const Real xi) {
+  if (closure == M1Closure::levermore) {
+    return (3.0 + 4.0*xi*xi)/(5.0 + 2.0*sqrt(fmax(4.0 - 3.0*xi*xi, 0.0)));
+  }
+  return 1.0/3.0 + xi*xi*(6.0 - 2.0*xi + 6.0*xi*xi)/15.0;   // Minerbo
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PressureTensor()
+//! \brief Computes P^{ij} = dthin E nn^{ij} + dthick P_thick^{ij}(E,F_i), where nn^{ij}
+//! is the unit tensor F^iF^j/F^2 and P_thick is the isotropic pressure in the fluid
+//! frame.  For fixed weights and nn^{ij} the pressure is linear in (E,F_i), which is
+//! used to linearize the implicit source terms.
+
+KOKKOS_INLINE_FUNCTION
+void PressureTensor(const Real dthin, const Real dthick, const Real nn[3][3],
+                    const Real e, const Real f_d[3], const Real g_uu[3][3],
+                    const Real w, const Real v_u[3], Real p_uu[3][3]) {
+  Real w2 = w*w;
+  Real fv = f_d[0]*v_u[0] + f_d[1]*v_u[1] + f_d[2]*v_u[2];
+  Real jt = 3.0/(2.0*w2 + 1.0)*((2.0*w2 - 1.0)*e - 2.0*w2*fv);
+  Real coef = w/(2.0*w2 + 1.0)*((4.0*w2 + 1.0)*fv - 4.0*w2*e);
+  Real ht_u[3];
+  for (int a=0; a<3; ++a) {
+    ht_u[a] = (g_uu[a][0]*f_d[0] + g_uu[a][1]*f_d[1] + g_uu[a][2]*f_d[2])/w
+              + coef*v_u[a];
+  }
+  for (int a=0; a<3; ++a) {
+    for (int b=a; b<3; ++b) {
+      Real pthick = (4.0/3.0)*jt*w2*v_u[a]*v_u[b] + w*(ht_u[a]*v_u[b] + v_u[a]*ht_u[b])
+                    + jt*g_uu[a][b]/3.0;
+      p_uu[a][b] = dthin*e*nn[a][b] + dthick*pthick;
+      p_uu[b][a] = p_uu[a][b];
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void FluidFrameMoments()
+//! \brief Energy density J, spatial projection of the flux H_i, and its normal
+//! component hn = n^a H_a, all measured in the fluid frame, from the Eulerian moments.
+//! Fluid 4-velocity is u^a = W(n^a + v^a).
+
+KOKKOS_INLINE_FUNCTION
+void FluidFrameMoments(const Real e, const Real f_d[3], const Real p_uu[3][3],
+                       const Real g_dd[3][3], const Real w, const Real v_u[3],
+                       Real &j, Real h_d[3], Real &hn) {
+  Real v_d[3];
+  for (int a=0; a<3; ++a) {
+    v_d[a] = g_dd[a][0]*v_u[0] + g_dd[a][1]*v_u[1] + g_dd[a][2]*v_u[2];
+  }
+  Real fv = f_d[0]*v_u[0] + f_d[1]*v_u[1] + f_d[2]*v_u[2];
+  Real pv_u[3];
+  Real pvv = 0.0;
+  for (int a=0; a<3; ++a) {
+    pv_u[a] = p_uu[a][0]*v_d[0] + p_uu[a][1]*v_d[1] + p_uu[a][2]*v_d[2];
+    pvv += pv_u[a]*v_d[a];
+  }
+  j = w*w*(e - 2.0*fv + pvv);
+  for (int a=0; a<3; ++a) {
+    Real pv_d = g_dd[a][0]*pv_u[0] + g_dd[a][1]*pv_u[1] + g_dd[a][2]*pv_u[2];
+    h_d[a] = w*(f_d[a] - pv_d) - w*v_d[a]*j;
+  }
+  hn = w*(j - e + fv);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ClosureWeights()
+//! \brief Sets weights of optically thin and thick pressure tensors for flux factor xi
+
+KOKKOS_INLINE_FUNCTION
+void ClosureWeights(const M1Closure closure, const Real xi, Real &dthin, Real &dthick) {
+  Real chi = EddingtonFactor(closure, xi);
+  dthin = 1.5*chi - 0.5;
+  dthick = 1.5*(1.0 - chi);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ComputeClosure()
+//! \brief Computes pressure tensor P^{ij} from (E,F_i).  In a static fluid the flux
+//! factor is simply |F|/E.  In a moving fluid it is the fluid-frame value |H|/J, which
+//! itself depends on P^{ij}, and is found with (at most maxiter) fixed-point iterations.
+//! Returns the weights and unit tensor nn^{ij} so the closure can be frozen later.
+
+KOKKOS_INLINE_FUNCTION
+void ComputeClosure(const M1Closure closure, const int maxiter, const Real e,
+                    const Real f_d[3], const Real g_dd[3][3], const Real g_uu[3][3],
+                    const Real w, const Real v_u[3], Real p_uu[3][3], Real nn[3][3],
+                    Real &dthin, Real &dthick) {
+  Real f_u[3];
+  for (int a=0; a<3; ++a) {
+    f_u[a] = g_uu[a][0]*f_d[0] + g_uu[a][1]*f_d[1] + g_uu[a][2]*f_d[2];
+  }
+  Real f2 = f_u[0]*f_d[0] + f_u[1]*f_d[1] + f_u[2]*f_d[2];
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      nn[a][b] = (f2 > 0.0)? f_u[a]*f_u[b]/f2 : g_uu[a][b]/3.0;
+    }
+  }
+  Real xi = (e > 0.0)? fmin(sqrt(f2)/e, 1.0) : 0.0;
+  ClosureWeights(closure, xi, dthin, dthick);
+  PressureTensor(dthin, dthick, nn, e, f_d, g_uu, w, v_u, p_uu);
+  if (w <= 1.0 + 1.0e-12) return;
+
+  for (int it=0; it<maxiter; ++it) {
+    Real j, h_d[3], hn;
+    FluidFrameMoments(e, f_d, p_uu, g_dd, w, v_u, j, h_d, hn);
+    Real h2 = -hn*hn;
+    for (int a=0; a<3; ++a) {
+      for (int b=0; b<3; ++b) {
+        h2 += g_uu[a][b]*h_d[a]*h_d[b];
+      }
+    }
+    Real xin = (j > 0.0)? fmin(sqrt(fmax(h2, 0.0))/j, 1.0) : 0.0;
+    bool converged = (fabs(xin - xi) < 1.0e-8);
+    xi = xin;
+    ClosureWeights(closure, xi, dthin, dthick);
+    PressureTensor(dthin, dthick, nn, e, f_d, g_uu, w, v_u, p_uu);
+    if (converged) break;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ApplyM1Floors()
+//! \brief Enforces E >= floor, and causality of the flux, F_i F^i <= E^2, by rescaling F
+
+KOKKOS_INLINE_FUNCTION
+void ApplyM1Floors(const Real efloor, const Real g_uu[3][3], Real &e, Real f_d[3]) {
+  e = fmax(e, efloor);
+  Real f2 = 0.0;
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      f2 += g_uu[a][b]*f_d[a]*f_d[b];
+    }
+  }
+  if (f2 > e*e) {
+    Real fac = e/sqrt(f2);
+    for (int a=0; a<3; ++a) {
+      f_d[a] *= fac;
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SolveLinear4()
+//! \brief Solves the 4x4 linear system A x = b by Gaussian elimination with partial
+//! pivoting.  Solution is returned in b.
+
+KOKKOS_INLINE_FUNCTION
+void SolveLinear4(Real a[4][4], Real b[4]) {
+  for (int c=0; c<4; ++c) {
+    int piv = c;
+    for (int r=c+1; r<4; ++r) {
+      if (fabs(a[r][c]) > fabs(a[piv][c])) {piv = r;}
+    }
+    if (piv != c) {
+      for (int n=0; n<4; ++n) {
+        Real tmp = a[c][n]; a[c][n] = a[piv][n]; a[piv][n] = tmp;
+      }
+      Real tmp = b[c]; b[c] = b[piv]; b[piv] = tmp;
+    }
+    for (int r=c+1; r<4; ++r) {
+      Real fac = a[r][c]/a[c][c];
+      for (int n=c; n<4; ++n) {
+        a[r][n] -= fac*a[c][n];
+      }
+      b[r] -= fac*b[c];
+    }
+  }
+  for (int r=3; r>=0; --r) {
+    for (int n=r+1; n<4; ++n) {
+      b[r] -= a[r][n]*b[n];
+    }
+    b[r] /= a[r][r];
+  }
+  return;
+}
+
+} // namespace m1
+#endif // M1_M1_CLOSURE_HPP_
@@ -0,0 +1,216 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1_fluxes.cpp
+//! \brief Calculates the closure and the spatial fluxes of the M1 moments.  Fluxes are
+//! computed with a Lax-Friedrichs (LLF) solver applied to the reconstructed cell-centered
+//! fluxes and moments.  In optically thick cells the dissipative part of the flux is
+//! reduced by the asymptotic-preserving factor A = min(1, 1/(dx kappa)), so that the
+//! diffusion limit is captured on grids that do not resolve the mean free path (Audit
+//! et al. 2002; O'Connor & Ott 2013).
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/adm.hpp"
+#include "mhd/mhd.hpp"
+#include "reconstruct/plm.hpp"
+#include "m1/m1.hpp"
+#include "m1/m1_closure.hpp"
+
+namespace m1 {
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::CalculateClosure
+//! \brief Computes the pressure tensor P^{ij} of every species in all cells (including
+//! ghost cells) from the current moments.
+
+TaskStatus M1::CalculateClosure(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nspec = nspecies, nv = nvars;
+  auto closure_ = closure;
+  int maxiter = closure_iter;
+
+  // metric and fluid velocity (flat space and static fluid when not evolved)
+  bool flat = (pmy_pack->padm == nullptr);
+  adm::ADM::ADM_vars adm;
+  if (!(flat)) {adm = pmy_pack->padm->adm;}
+  bool moving = (pmy_pack->pmhd != nullptr);
+  DvceArray5D<Real> w0;
+  if (moving) {w0 = pmy_pack->pmhd->w0;}
+  auto &u0_ = u0;
+  auto &pcl_ = pcl;
+
+  par_for("m1_closure", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real alpha, beta_u[3], g_dd[3][3], g_uu[3][3], sdetg;
+    M1Metric(adm, flat, m, k, j, i, alpha, beta_u, g_dd, g_uu, sdetg);
+    Real w, v_u[3];
+    M1FluidVelocity(w0, moving, g_dd, m, k, j, i, w, v_u);
+
+    for (int s=0; s<nspec; ++s) {
+      Real e = u0_(m,s*nv+IRE,k,j,i);
+      Real f_d[3] = {u0_(m,s*nv+IRFX,k,j,i), u0_(m,s*nv+IRFY,k,j,i),
+                     u0_(m,s*nv+IRFZ,k,j,i)};
+      Real p_uu[3][3], nn[3][3], dthin, dthick;
+      ComputeClosure(closure_, maxiter, e, f_d, g_dd, g_uu, w, v_u, p_uu, nn,
+                     dthin, dthick);
+      pcl_(m,6*s  ,k,j,i) = p_uu[0][0];
+      pcl_(m,6*s+1,k,j,i) = p_uu[0][1];
+      pcl_(m,6*s+2,k,j,i) = p_uu[0][2];
+      pcl_(m,6*s+3,k,j,i) = p_uu[1][1];
+      pcl_(m,6*s+4,k,j,i) = p_uu[1][2];
+      pcl_(m,6*s+5,k,j,i) = p_uu[2][2];
+    }
+  });
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::CalculateFluxes
+//! \brief Computes fluxes of the densitized moments in each direction d:
+//!   F(E)   = alpha F^d - beta^d E
+//!   F(F_a) = alpha P^d_a - beta^d F_a
+//!   F(N)   = alpha N/Gamma (W v^d + H^d/J) - beta^d N
+//! First at cell centers (stored in fcc), then at faces with the LLF solver.
+
+TaskStatus M1::CalculateFluxes(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nspec = nspecies, nv = nvars;
+  bool use_plm = (recon_method == ReconstructionMethod::plm);
+  bool ap_corr = ap_correction;
+
+  bool flat = (pmy_pack->padm == nullptr);
+  adm::ADM::ADM_vars adm;
+  if (!(flat)) {adm = pmy_pack->padm->adm;}
+  bool moving = (pmy_pack->pmhd != nullptr);
+  DvceArray5D<Real> w0;
+  if (moving) {w0 = pmy_pack->pmhd->w0;}
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &u0_ = u0;
+  auto &pcl_ = pcl;
+  auto &fcc_ = fcc;
+  auto &kap_a_ = kap_a;
+  auto &kap_s_ = kap_s;
+
+  int ndir = 1;
+  if (pmy_pack->pmesh->multi_d) {ndir = 2;}
+  if (pmy_pack->pmesh->three_d) {ndir = 3;}
+  for (int d=0; d<ndir; ++d) {
+    //------------------------------------------------------------------------------------
+    // cell-centered fluxes in direction d
+    par_for("m1_fcc", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real alpha, beta_u[3], g_dd[3][3], g_uu[3][3], sdetg;
+      M1Metric(adm, flat, m, k, j, i, alpha, beta_u, g_dd, g_uu, sdetg);
+      Real w, v_u[3];
+      M1FluidVelocity(w0, moving, g_dd, m, k, j, i, w, v_u);
+
+      for (int s=0; s<nspec; ++s) {
+        Real e = u0_(m,s*nv+IRE,k,j,i);
+        Real f_d[3] = {u0_(m,s*nv+IRFX,k,j,i), u0_(m,s*nv+IRFY,k,j,i),
+                       u0_(m,s*nv+IRFZ,k,j,i)};
+        Real p_uu[3][3];
+        p_uu[0][0] = pcl_(m,6*s  ,k,j,i);
+        p_uu[0][1] = pcl_(m,6*s+1,k,j,i);
+        p_uu[0][2] = pcl_(m,6*s+2,k,j,i);
+        p_uu[1][1] = pcl_(m,6*s+3,k,j,i);
+        p_uu[1][2] = pcl_(m,6*s+4,k,j,i);
+        p_uu[2][2] = pcl_(m,6*s+5,k,j,i);
+        p_uu[1][0] = p_uu[0][1];
+        p_uu[2][0] = p_uu[0][2];
+        p_uu[2][1] = p_uu[1][2];
+
+        Real f_u = g_uu[d][0]*f_d[0] + g_uu[d][1]*f_d[1] + g_uu[d][2]*f_d[2];
+        fcc_(m,s*nv+IRE,k,j,i) = alpha*f_u - beta_u[d]*e;
+        for (int a=0; a<3; ++a) {
+          Real p_ud = p_uu[d][0]*g_dd[0][a] + p_uu[d][1]*g_dd[1][a]
+                    + p_uu[d][2]*g_dd[2][a];
+          fcc_(m,s*nv+IRFX+a,k,j,i) = alpha*p_ud - beta_u[d]*f_d[a];
+        }
+        if (nv > IRN) {
+          Real n = u0_(m,s*nv+IRN,k,j,i);
+          Real jj, h_d[3], hn;
+          FluidFrameMoments(e, f_d, p_uu, g_dd, w, v_u, jj, h_d, hn);
+          Real fv = f_d[0]*v_u[0] + f_d[1]*v_u[1] + f_d[2]*v_u[2];
+          Real h_u = g_uu[d][0]*h_d[0] + g_uu[d][1]*h_d[1] + g_uu[d][2]*h_d[2];
+          Real flx = 0.0;
+          if (jj > 0.0 && (e - fv) > 0.0) {
+            Real gam = w*(e - fv)/jj;
+            flx = alpha*n/gam*(w*v_u[d] + h_u/jj);
+          } else {
+            flx = alpha*n*v_u[d];
+          }
+          fcc_(m,s*nv+IRN,k,j,i) = flx - beta_u[d]*n;
+        }
+      }
+    });
+
+    //------------------------------------------------------------------------------------
+    // fluxes at faces in direction d (face index refers to left face of cell)
+    int il = is, iu = ie, jl = js, ju = je, kl = ks, ku = ke;
+    int di = 0, dj = 0, dk = 0;
+    if (d == 0) {iu = ie + 1; di = 1;}
+    if (d == 1) {ju = je + 1; dj = 1;}
+    if (d == 2) {ku = ke + 1; dk = 1;}
+    auto flx = (d == 0)? uflx.x1f : ((d == 1)? uflx.x2f : uflx.x3f);
+
+    par_for("m1_flux", DevExeSpace(), 0, nmb1, kl, ku, jl, ju, il, iu,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      // maximum characteristic speed of both adjacent cells
+      Real alpha, beta_u[3], g_dd[3][3], g_uu[3][3], sdetg;
+      M1Metric(adm, flat, m, k-dk, j-dj, i-di, alpha, beta_u, g_dd, g_uu, sdetg);
+      Real cmax = alpha*sqrt(g_uu[d][d]) + fabs(beta_u[d]);
+      M1Metric(adm, flat, m, k, j, i, alpha, beta_u, g_dd, g_uu, sdetg);
+      cmax = fmax(cmax, alpha*sqrt(g_uu[d][d]) + fabs(beta_u[d]));
+      Real dx = (d == 0)? size.d_view(m).dx1 :
+                ((d == 1)? size.d_view(m).dx2 : size.d_view(m).dx3);
+
+      for (int s=0; s<nspec; ++s) {
+        Real afac = 1.0;
+        if (ap_corr) {
+          Real kap = 0.5*(kap_a_(m,s,k-dk,j-dj,i-di) + kap_s_(m,s,k-dk,j-dj,i-di)
+                        + kap_a_(m,s,k,j,i) + kap_s_(m,s,k,j,i));
+          if (kap*dx > 1.0) {afac = 1.0/(kap*dx);}
+        }
+        for (int v=0; v<nv; ++v) {
+          int n = s*nv + v;
+          Real fl, fr, ul, ur;
+          if (use_plm) {
+            Real tmp;
+            PLM(fcc_(m,n,k-2*dk,j-2*dj,i-2*di), fcc_(m,n,k-dk,j-dj,i-di),
+                fcc_(m,n,k,j,i), fl, tmp);
+            PLM(fcc_(m,n,k-dk,j-dj,i-di), fcc_(m,n,k,j,i),
+                fcc_(m,n,k+dk,j+dj,i+di), tmp, fr);
+            PLM(u0_(m,n,k-2*dk,j-2*dj,i-2*di), u0_(m,n,k-dk,j-dj,i-di),
+                u0_(m,n,k,j,i), ul, tmp);
+            PLM(u0_(m,n,k-dk,j-dj,i-di), u0_(m,n,k,j,i),
+                u0_(m,n,k+dk,j+dj,i+di), tmp, ur);
+          } else {
+            fl = fcc_(m,n,k-dk,j-dj,i-di);
+            fr = fcc_(m,n,k,j,i);
+            ul = u0_(m,n,k-dk,j-dj,i-di);
+            ur = u0_(m,n,k,j,i);
+          }
+          flx(m,n,k,j,i) = 0.5*(fl + fr) - 0.5*afac*cmax*(ur - ul);
+        }
+      }
+    });
+  }
+
+  return TaskStatus::complete;
+}
+
+} // namespace m1
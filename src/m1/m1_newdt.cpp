@@ -0,0 +1,77 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1_newdt.cpp
+//! \brief function to compute M1 timestep across all MeshBlock(s) in a MeshBlockPack
+
+#include <limits>
+#include <algorithm> // min
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/adm.hpp"
+#include "m1/m1.hpp"
+#include "m1/m1_closure.hpp"
+
+namespace m1 {
+//----------------------------------------------------------------------------------------
+//! \fn void M1::NewTimeStep()
+//! \brief calculate the minimum timestep within a MeshBlockPack, set by the maximum
+//! characteristic speed alpha sqrt(g^{dd}) + |beta^d| of the moment equations.  The
+//! radiation-matter interaction is implicit and does not limit the timestep.
+
+TaskStatus M1::NewTimeStep(Driver *pdrive, int stage) {
+  if (stage != (pdrive->nexp_stages)) {
+    return TaskStatus::complete; // only execute last stage
+  }
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
+
+  // capture class variables for kernel
+  bool flat = (pmy_pack->padm == nullptr);
+  adm::ADM::ADM_vars adm;
+  if (!(flat)) {adm = pmy_pack->padm->adm;}
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+
+  Kokkos::parallel_reduce("M1Nudt",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
+    // compute m,k,j,i indices of thread and call function
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+
+    Real alpha, beta_u[3], g_dd[3][3], g_uu[3][3], sdetg;
+    M1Metric(adm, flat, m, k, j, i, alpha, beta_u, g_dd, g_uu, sdetg);
+    Real max_dv1 = alpha*sqrt(g_uu[0][0]) + fabs(beta_u[0]);
+    Real max_dv2 = alpha*sqrt(g_uu[1][1]) + fabs(beta_u[1]);
+    Real max_dv3 = alpha*sqrt(g_uu[2][2]) + fabs(beta_u[2]);
+    min_dt1 = fmin((mbsize.d_view(m).dx1/max_dv1), min_dt1);
+    min_dt2 = fmin((mbsize.d_view(m).dx2/max_dv2), min_dt2);
+    min_dt3 = fmin((mbsize.d_view(m).dx3/max_dv3), min_dt3);
+  }, Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2),Kokkos::Min<Real>(dt3));
+
+  // compute minimum of dt1/dt2/dt3 for 1D/2D/3D problems
+  dtnew = dt1;
+  if (pmy_pack->pmesh->multi_d) { dtnew = std::min(dtnew, dt2); }
+  if (pmy_pack->pmesh->three_d) { dtnew = std::min(dtnew, dt3); }
+
+  return TaskStatus::complete;
+}
+
+} // namespace m1
@@ -0,0 +1,169 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1_source.cpp
+//! \brief Operator-split, implicit (backward Euler) update of the radiation-matter
+//! interaction for the M1 moments.  In the fluid frame the radiation 4-force is
+//!   G^a = (eta - kappa_a J) u^a - (kappa_a + kappa_s) H^a
+//! whose Eulerian projections give the sources of E and F_i.  With the closure frozen at
+//! the start of the update (weights and direction of the optically-thin part) the sources
+//! are linear in (E,F_i), so each cell requires the solution of a single 4x4 system.
+//! The exchanged energy, momentum and lepton number are removed from the fluid.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/adm.hpp"
+#include "mhd/mhd.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
+#include "pgen/pgen.hpp"
+#include "m1/m1.hpp"
+#include "m1/m1_closure.hpp"
+
+namespace m1 {
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::ImplicitSources
+//! \brief Adds radiation-matter source terms over the full time step dt.  Applied in all
+//! cells including ghost cells (which contain the same data as their neighbors), so no
+//! boundary communication is needed afterwards.  Opacities are first updated by the
+//! user-enrolled function, if any.
+
+TaskStatus M1::ImplicitSources(Driver *pdrive, int stage) {
+  if (pmy_pack->pmesh->pgen->user_m1_opacity_func != nullptr) {
+    (pmy_pack->pmesh->pgen->user_m1_opacity_func)(pmy_pack->pmesh);
+  }
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*(indcs.ng);
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nspec = nspecies, nv = nvars;
+  auto closure_ = closure;
+  int maxiter = closure_iter;
+  Real efloor = e_floor;
+  Real dt = pmy_pack->pmesh->dt;
+
+  bool flat = (pmy_pack->padm == nullptr);
+  adm::ADM::ADM_vars adm;
+  if (!(flat)) {adm = pmy_pack->padm->adm;}
+  bool moving = (pmy_pack->pmhd != nullptr);
+  DvceArray5D<Real> w0, ufl;
+  int nmhd = 0, nscal = 0;
+  if (moving) {
+    w0 = pmy_pack->pmhd->w0;
+    ufl = pmy_pack->pmhd->u0;
+    nmhd = pmy_pack->pmhd->nmhd;
+    nscal = pmy_pack->pmhd->nscalars;
+  }
+  bool feedback = affect_fluid;
+  Real mb_ = mb;
+  auto &lepton_ = lepton;
+  auto &u0_ = u0;
+  auto &kap_a_ = kap_a;
+  auto &kap_s_ = kap_s;
+  auto &eta_ = eta;
+  auto &kap_n_ = kap_n;
+  auto &eta_n_ = eta_n;
+
+  par_for("m1_src", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real alpha, beta_u[3], g_dd[3][3], g_uu[3][3], sdetg;
+    M1Metric(adm, flat, m, k, j, i, alpha, beta_u, g_dd, g_uu, sdetg);
+    Real w, v_u[3];
+    M1FluidVelocity(w0, moving, g_dd, m, k, j, i, w, v_u);
+    Real v_d[3];
+    for (int a=0; a<3; ++a) {
+      v_d[a] = g_dd[a][0]*v_u[0] + g_dd[a][1]*v_u[1] + g_dd[a][2]*v_u[2];
+    }
+
+    // energy, momentum and lepton number given to radiation in this cell
+    Real du[4] = {0.0, 0.0, 0.0, 0.0};
+    Real dyl = 0.0;
+
+    for (int s=0; s<nspec; ++s) {
+      Real ka = kap_a_(m,s,k,j,i);
+      Real kt = ka + kap_s_(m,s,k,j,i);
+      Real em = sdetg*eta_(m,s,k,j,i);
+      Real ustar[4] = {u0_(m,s*nv+IRE,k,j,i), u0_(m,s*nv+IRFX,k,j,i),
+                       u0_(m,s*nv+IRFY,k,j,i), u0_(m,s*nv+IRFZ,k,j,i)};
+
+      // freeze closure at current state
+      Real p_uu[3][3], nn[3][3], dthin, dthick;
+      ComputeClosure(closure_, maxiter, ustar[0], &ustar[1], g_dd, g_uu, w, v_u,
+                     p_uu, nn, dthin, dthick);
+
+      // linear operator of homogeneous part of sources, column by column
+      Real amat[4][4], rhs[4];
+      for (int c=0; c<4; ++c) {
+        Real uc[4] = {0.0, 0.0, 0.0, 0.0};
+        uc[c] = 1.0;
+        Real pc[3][3], jc, hc_d[3], hnc;
+        PressureTensor(dthin, dthick, nn, uc[0], &uc[1], g_uu, w, v_u, pc);
+        FluidFrameMoments(uc[0], &uc[1], pc, g_dd, w, v_u, jc, hc_d, hnc);
+        Real sc[4];
+        sc[0] = alpha*(-w*ka*jc + kt*hnc);
+        for (int a=0; a<3; ++a) {
+          sc[1+a] = alpha*(-w*v_d[a]*ka*jc - kt*hc_d[a]);
+        }
+        for (int r=0; r<4; ++r) {
+          amat[r][c] = ((r == c)? 1.0 : 0.0) - dt*sc[r];
+        }
+      }
+      rhs[0] = ustar[0] + dt*alpha*w*em;
+      for (int a=0; a<3; ++a) {
+        rhs[1+a] = ustar[1+a] + dt*alpha*w*v_d[a]*em;
+      }
+      SolveLinear4(amat, rhs);
+
+      Real e = rhs[0];
+      Real f_d[3] = {rhs[1], rhs[2], rhs[3]};
+      ApplyM1Floors(efloor*sdetg, g_uu, e, f_d);
+      u0_(m,s*nv+IRE,k,j,i) = e;
+      u0_(m,s*nv+IRFX,k,j,i) = f_d[0];
+      u0_(m,s*nv+IRFY,k,j,i) = f_d[1];
+      u0_(m,s*nv+IRFZ,k,j,i) = f_d[2];
+      du[0] += e - ustar[0];
+      for (int a=0; a<3; ++a) {
+        du[1+a] += f_d[a] - ustar[1+a];
+      }
+
+      // number density, with Gamma = W(E - F.v)/J evaluated at new state
+      if (nv > IRN) {
+        Real pn[3][3], jn, hn_d[3], hnn;
+        PressureTensor(dthin, dthick, nn, e, f_d, g_uu, w, v_u, pn);
+        FluidFrameMoments(e, f_d, pn, g_dd, w, v_u, jn, hn_d, hnn);
+        Real fv = f_d[0]*v_u[0] + f_d[1]*v_u[1] + f_d[2]*v_u[2];
+        Real gam = (jn > 0.0 && (e - fv) > 0.0)? w*(e - fv)/jn : w;
+        Real nstar = u0_(m,s*nv+IRN,k,j,i);
+        Real nnew = (nstar + dt*alpha*sdetg*eta_n_(m,s,k,j,i))/
+                    (1.0 + dt*alpha*kap_n_(m,s,k,j,i)/gam);
+        nnew = fmax(nnew, 0.0);
+        u0_(m,s*nv+IRN,k,j,i) = nnew;
+        dyl += lepton_.d_view(s)*(nnew - nstar);
+      }
+    }
+
+    // remove exchanged energy, momentum, and lepton number from fluid
+    if (feedback) {
+      ufl(m,IEN,k,j,i) -= du[0];
+      ufl(m,IM1,k,j,i) -= du[1];
+      ufl(m,IM2,k,j,i) -= du[2];
+      ufl(m,IM3,k,j,i) -= du[3];
+      if (nscal > 0) {
+        ufl(m,nmhd,k,j,i) -= mb_*dyl;
+      }
+    }
+  });
+
+  // update primitives of fluid in all cells
+  if (affect_fluid) {
+    (void) pmy_pack->pdyngr->ConToPrim(pdrive, 0);
+  }
+
+  return TaskStatus::complete;
+}
+
+} // namespace m1
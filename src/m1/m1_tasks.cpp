@@ -0,0 +1,236 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1_tasks.cpp
+//! \brief functions that control M1 tasks stored in tasklists in MeshBlockPack
+
+#include <map>
+#include <memory>
+#include <string>
+#include <iostream>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "tasklist/task_list.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals/bvals.hpp"
+#include "pgen/pgen.hpp"
+#include "m1/m1.hpp"
+
+namespace m1 {
+//----------------------------------------------------------------------------------------
+//! \fn  void M1::AssembleM1Tasks
+//! \brief Adds M1 tasks to appropriate task lists used by time integrators.  Called by
+//! MeshBlockPack::AddPhysics() function directly after M1 constructor.  Transport is
+//! integrated with the same explicit RK stages as the fluid, while the (stiff)
+//! radiation-matter interaction is applied implicitly once per time step.
+
+void M1::AssembleM1Tasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
+  TaskID none(0);
+
+  // assemble "before_stagen" task list
+  id.irecv  = tl["before_stagen"]->AddTask(&M1::InitRecv, this, none, "M1::InitRecv");
+
+  // assemble "stagen" task list
+  id.copyu  = tl["stagen"]->AddTask(&M1::CopyCons, this, none, "M1::CopyCons");
+  id.clos   = tl["stagen"]->AddTask(&M1::CalculateClosure, this, id.copyu,
+                                    "M1::CalculateClosure");
+  id.flux   = tl["stagen"]->AddTask(&M1::CalculateFluxes, this, id.clos,
+                                    "M1::CalculateFluxes");
+  id.sendf  = tl["stagen"]->AddTask(&M1::SendFlux, this, id.flux, "M1::SendFlux");
+  id.recvf  = tl["stagen"]->AddTask(&M1::RecvFlux, this, id.sendf, "M1::RecvFlux");
+  id.rkupdt = tl["stagen"]->AddTask(&M1::RKUpdate, this, id.recvf, "M1::RKUpdate");
+  id.restu  = tl["stagen"]->AddTask(&M1::RestrictU, this, id.rkupdt, "M1::RestrictU");
+  id.sendu  = tl["stagen"]->AddTask(&M1::SendU, this, id.restu, "M1::SendU");
+  id.recvu  = tl["stagen"]->AddTask(&M1::RecvU, this, id.sendu, "M1::RecvU");
+  id.bcs    = tl["stagen"]->AddTask(&M1::ApplyPhysicalBCs, this, id.recvu,
+                                    "M1::ApplyPhysicalBCs");
+  id.prol   = tl["stagen"]->AddTask(&M1::Prolongate, this, id.bcs, "M1::Prolongate");
+  id.newdt  = tl["stagen"]->AddTask(&M1::NewTimeStep, this, id.prol, "M1::NewTimeStep");
+
+  // assemble "after_stagen" task list
+  id.csend  = tl["after_stagen"]->AddTask(&M1::ClearSend, this, none, "M1::ClearSend");
+  // although RecvFlux/U functions check that all recvs complete, add ClearRecv to
+  // task list anyways to catch potential bugs in MPI communication logic
+  id.crecv  = tl["after_stagen"]->AddTask(&M1::ClearRecv, this, id.csend,
+                                          "M1::ClearRecv");
+
+  // assemble "after_timeintegrator" task list
+  if (rad_source) {
+    id.src  = tl["after_timeintegrator"]->AddTask(&M1::ImplicitSources, this, none,
+                                                  "M1::ImplicitSources");
+  }
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void M1::InitRecv
+//! \brief function to post non-blocking receives (with MPI), and initialize all boundary
+//! receive status flags to waiting (with or without MPI) for M1 variables.
+
+TaskStatus M1::InitRecv(Driver *pdrive, int stage) {
+  // post receives for U
+  TaskStatus tstat = pbval_u->InitRecv(nspecies*nvars);
+  if (tstat != TaskStatus::complete) return tstat;
+
+  // do not post receives for fluxes when stage < 0 (i.e. ICs)
+  if (stage >= 0) {
+    // with SMR, post receives for fluxes of U
+    if (pmy_pack->pmesh->multilevel) {
+      tstat = pbval_u->InitFluxRecv(nspecies*nvars);
+      if (tstat != TaskStatus::complete) return tstat;
+    }
+  }
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void M1::CopyCons
+//! \brief  copy u0 --> u1 in first stage
+
+TaskStatus M1::CopyCons(Driver *pdrive, int stage) {
+  if (stage == 1) {
+    Kokkos::deep_copy(DevExeSpace(), u1, u0);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::SendFlux
+//! \brief Wrapper task list function to pack/send restricted values of fluxes of
+//! moments at fine/coarse boundaries
+
+TaskStatus M1::SendFlux(Driver *pdrive, int stage) {
+  TaskStatus tstat = TaskStatus::complete;
+  // Only execute BoundaryValues function with SMR
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->PackAndSendFluxCC(uflx);
+  }
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::RecvFlux
+//! \brief Wrapper task list function to recv/unpack restricted values of fluxes of
+//! moments at fine/coarse boundaries
+
+TaskStatus M1::RecvFlux(Driver *pdrive, int stage) {
+  TaskStatus tstat = TaskStatus::complete;
+  // Only execute BoundaryValues function with SMR
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->RecvAndUnpackFluxCC(uflx);
+  }
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::RestrictU
+//! \brief Wrapper task list function to restrict moments
+
+TaskStatus M1::RestrictU(Driver *pdrive, int stage) {
+  // Only execute Mesh function with SMR
+  if (pmy_pack->pmesh->multilevel) {
+    pmy_pack->pmesh->pmr->RestrictCC(u0, coarse_u0);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::SendU
+//! \brief Wrapper task list function to pack/send moments
+
+TaskStatus M1::SendU(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->PackAndSendCC(u0, coarse_u0);
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::RecvU
+//! \brief Wrapper task list function to receive/unpack moments
+
+TaskStatus M1::RecvU(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->RecvAndUnpackCC(u0, coarse_u0);
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::ApplyPhysicalBCs
+//! \brief Wrapper task list function to call funtions that set physical and user BCs
+
+TaskStatus M1::ApplyPhysicalBCs(Driver *pdrive, int stage) {
+  // do not apply BCs if domain is strictly periodic
+  if (pmy_pack->pmesh->strictly_periodic) return TaskStatus::complete;
+
+  // physical BCs on moments
+  pbval_u->M1BCs((pmy_pack), (pbval_u->u_in), u0, nvars);
+
+  // user BCs
+  if (pmy_pack->pmesh->pgen->user_bcs) {
+    (pmy_pack->pmesh->pgen->user_bcs_func)(pmy_pack->pmesh);
+  }
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList M1::Prolongate
+//! \brief Wrapper task list function to prolongate moments at fine/coarse bundaries
+//! with SMR
+
+TaskStatus M1::Prolongate(Driver *pdrive, int stage) {
+  if (pmy_pack->pmesh->multilevel) {  // only prolongate with SMR
+    pbval_u->FillCoarseInBndryCC(u0, coarse_u0);
+    pbval_u->ProlongateCC(u0, coarse_u0);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::ClearSend
+//! \brief Wrapper task list function that checks all MPI sends have completed.
+
+TaskStatus M1::ClearSend(Driver *pdrive, int stage) {
+  // check sends of U complete
+  TaskStatus tstat = pbval_u->ClearSend();
+  if (tstat != TaskStatus::complete) return tstat;
+
+  // do not check flux send for ICs (stage < 0)
+  if (stage >= 0) {
+    // with SMR check sends of restricted fluxes of U complete
+    if (pmy_pack->pmesh->multilevel) {
+      tstat = pbval_u->ClearFluxSend();
+      if (tstat != TaskStatus::complete) return tstat;
+    }
+  }
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus M1::ClearRecv
+//! \brief Wrapper task list function that checks all MPI receives have completed.
+//! Needed in Driver::Initialize to set ghost zones in ICs.
+
+TaskStatus M1::ClearRecv(Driver *pdrive, int stage) {
+  // check receives of U complete
+  TaskStatus tstat = pbval_u->ClearRecv();
+  if (tstat != TaskStatus::complete) return tstat;
+
+  // do not check flux receives when stage < 0 (i.e. ICs)
+  if (stage >= 0) {
+    // with SMR check receives of restricted fluxes of U complete
+    if (pmy_pack->pmesh->multilevel) {
+      tstat = pbval_u->ClearFluxRecv();
+      if (tstat != TaskStatus::complete) return tstat;
+    }
+  }
+
+  return TaskStatus::complete;
+}
+
+} // namespace m1
@@ -0,0 +1,151 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1_update.cpp
+//! \brief Performs update of M1 moments (u0) for each stage of explicit SSP RK
+//! integrators (e.g. RK1, RK2, RK3). Update uses weighted average and partial time step
+//! appropriate to stage.  Geometric source terms in curved spacetimes are included in
+//! this update; radiation-matter interaction is applied implicitly in ImplicitSources().
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "coordinates/adm.hpp"
+#include "m1/m1.hpp"
+#include "m1/m1_closure.hpp"
+
+namespace m1 {
+//----------------------------------------------------------------------------------------
+//! \fn  void M1::RKUpdate
+//! \brief Explicit RK update of flux divergence and geometric source terms
+//!   S(E)   = alpha P^{ij} K_ij - F^i d_i alpha
+//!   S(F_i) = -E d_i alpha + F_k d_i beta^k + (alpha/2) P^{jk} d_i g_jk
+//! with metric derivatives computed by second-order centered differences.
+
+TaskStatus M1::RKUpdate(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nspec = nspecies, nv = nvars;
+  Real efloor = e_floor;
+
+  auto &mbsize  = pmy_pack->pmb->mb_size;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+
+  bool flat = (pmy_pack->padm == nullptr);
+  adm::ADM::ADM_vars adm;
+  if (!(flat)) {adm = pmy_pack->padm->adm;}
+  auto &u0_ = u0;
+  auto &u1_ = u1;
+  auto &pcl_ = pcl;
+  auto &flx1 = uflx.x1f;
+  auto &flx2 = uflx.x2f;
+  auto &flx3 = uflx.x3f;
+
+  par_for("m1_update",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real alpha, beta_u[3], g_dd[3][3], g_uu[3][3], sdetg;
+    M1Metric(adm, flat, m, k, j, i, alpha, beta_u, g_dd, g_uu, sdetg);
+
+    // derivatives of lapse, shift and metric (zero in flat space)
+    Real da[3] = {0.0, 0.0, 0.0};
+    Real dbeta[3][3] = {{0.0}};   // dbeta[i][k] = d_i beta^k
+    Real dg[3][3][3] = {{{0.0}}}; // dg[i][a][b] = d_i g_ab
+    Real kdd[3][3] = {{0.0}};
+    if (!(flat)) {
+      int ndim = (three_d)? 3 : ((multi_d)? 2 : 1);
+      for (int d=0; d<ndim; ++d) {
+        int di = (d == 0)? 1 : 0, dj = (d == 1)? 1 : 0, dk = (d == 2)? 1 : 0;
+        Real dx = (d == 0)? mbsize.d_view(m).dx1 :
+                  ((d == 1)? mbsize.d_view(m).dx2 : mbsize.d_view(m).dx3);
+        Real idx2 = 0.5/dx;
+        da[d] = (adm.alpha(m,k+dk,j+dj,i+di) - adm.alpha(m,k-dk,j-dj,i-di))*idx2;
+        for (int a=0; a<3; ++a) {
+          dbeta[d][a] = (adm.beta_u(m,a,k+dk,j+dj,i+di)
+                       - adm.beta_u(m,a,k-dk,j-dj,i-di))*idx2;
+          for (int b=0; b<3; ++b) {
+            dg[d][a][b] = (adm.g_dd(m,a,b,k+dk,j+dj,i+di)
+                         - adm.g_dd(m,a,b,k-dk,j-dj,i-di))*idx2;
+          }
+        }
+      }
+      for (int a=0; a<3; ++a) {
+        for (int b=0; b<3; ++b) {
+          kdd[a][b] = adm.vK_dd(m,a,b,k,j,i);
+        }
+      }
+    }
+
+    for (int s=0; s<nspec; ++s) {
+      // geometric source terms evaluated with moments at start of stage
+      Real src[4] = {0.0, 0.0, 0.0, 0.0};
+      if (!(flat)) {
+        Real e = u0_(m,s*nv+IRE,k,j,i);
+        Real f_d[3] = {u0_(m,s*nv+IRFX,k,j,i), u0_(m,s*nv+IRFY,k,j,i),
+                       u0_(m,s*nv+IRFZ,k,j,i)};
+        Real p_uu[3][3];
+        p_uu[0][0] = pcl_(m,6*s  ,k,j,i);
+        p_uu[0][1] = pcl_(m,6*s+1,k,j,i);
+        p_uu[0][2] = pcl_(m,6*s+2,k,j,i);
+        p_uu[1][1] = pcl_(m,6*s+3,k,j,i);
+        p_uu[1][2] = pcl_(m,6*s+4,k,j,i);
+        p_uu[2][2] = pcl_(m,6*s+5,k,j,i);
+        p_uu[1][0] = p_uu[0][1];
+        p_uu[2][0] = p_uu[0][2];
+        p_uu[2][1] = p_uu[1][2];
+        for (int a=0; a<3; ++a) {
+          Real f_u = g_uu[a][0]*f_d[0] + g_uu[a][1]*f_d[1] + g_uu[a][2]*f_d[2];
+          src[0] -= f_u*da[a];
+          src[1+a] -= e*da[a];
+          for (int b=0; b<3; ++b) {
+            src[0] += alpha*p_uu[a][b]*kdd[a][b];
+            src[1+a] += f_d[b]*dbeta[a][b];
+            for (int c=0; c<3; ++c) {
+              src[1+a] += 0.5*alpha*p_uu[b][c]*dg[a][b][c];
+            }
+          }
+        }
+      }
+
+      for (int v=0; v<nv; ++v) {
+        int n = s*nv + v;
+        Real divf = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+        if (multi_d) {
+          divf += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+        }
+        if (three_d) {
+          divf += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+        }
+        Real srcv = (v < 4)? src[v] : 0.0;
+        u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i)
+                         - beta_dt*(divf - srcv);
+      }
+
+      // apply floors
+      Real e = u0_(m,s*nv+IRE,k,j,i);
+      Real f_d[3] = {u0_(m,s*nv+IRFX,k,j,i), u0_(m,s*nv+IRFY,k,j,i),
+                     u0_(m,s*nv+IRFZ,k,j,i)};
+      ApplyM1Floors(efloor*sdetg, g_uu, e, f_d);
+      u0_(m,s*nv+IRE,k,j,i) = e;
+      u0_(m,s*nv+IRFX,k,j,i) = f_d[0];
+      u0_(m,s*nv+IRFY,k,j,i) = f_d[1];
+      u0_(m,s*nv+IRFZ,k,j,i) = f_d[2];
+      if (nv > IRN) {
+        u0_(m,s*nv+IRN,k,j,i) = fmax(u0_(m,s*nv+IRN,k,j,i), 0.0);
+      }
+    }
+  });
+
+  return TaskStatus::complete;
+}
+
+} // namespace m1
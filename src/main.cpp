@@ -34,6 +34,8 @@
 #include "athena.hpp"
 #include "globals.hpp"
 #include "utils/utils.hpp"
+#include "utils/memory_usage.hpp"
+#include "utils/signal_handler.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs/outputs.hpp"
@@ -220,6 +222,10 @@ int main(int argc, char *argv[]) {
     return(0);
   }
 
+  // Catch SIGTERM/SIGUSR1 sent by batch schedulers, so that the run is terminated (with
+  // final outputs, including restarts) at the end of the current cycle
+  signal_handler::Install();
+
   // Start the wall clock timer. This is done here rather than in the Driver to ensure
   // that the time taken in ProblemGenerator is also captured.
   Kokkos::Timer timer;
@@ -287,6 +293,14 @@ int main(int argc, char *argv[]) {
   // is fully constructed.
 
   pmesh->AddCoordinatesAndPhysics(pinput);
+  // Driver is constructed here so that its arrays (e.g. stiff source terms with ImEx
+  // integrators) are included in the report of memory used below.
+  Driver* pdriver = new Driver(pinput, pmesh, wtlim, &timer);
+  // report memory used by physics modules, and check it is within budget (if any)
+  memory_usage::Initialize(pinput);
+  memory_usage::Report(pmesh, true);
+  // report binding of OpenMP threads to cores (needed for NUMA-aware first touch)
+  ReportThreadBinding();
   if (!res_flag) {
     // set ICs using ProblemGenerator constructor for new runs
     pmesh->pgen = std::make_unique<ProblemGenerator>(pinput, pmesh);
@@ -297,11 +311,10 @@ int main(int argc, char *argv[]) {
   }
 
   //--- Step 6. --------------------------------------------------------------------------
-  // Construct Driver and Outputs. Actual outputs (including initial conditions) are made
-  // in Driver.Initialize(). Add wall clock timer to Driver if necessary.
+  // Construct Outputs (Driver was constructed in Step 5). Actual outputs (including
+  // initial conditions) are made in Driver.Initialize().
 
   ChangeRunDir(run_dir);
-  Driver* pdriver = new Driver(pinput, pmesh, wtlim, &timer);
   Outputs* pout = new Outputs(pinput, pmesh);
 
   //--- Step 7. --------------------------------------------------------------------------
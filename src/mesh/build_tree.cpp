@@ -74,157 +74,7 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
       std::exit(EXIT_FAILURE);
     }
 
-    // cycle through ParameterInput list and find "refinement" blocks (SMR), extract data
-    // Expand MeshBlockTree to include "refinement" regions specified in input file:
-    for (auto it = pin->block.begin(); it != pin->block.end(); ++it) {
-      if (it->block_name.compare(0, 10, "refinement") == 0) {
-        RegionSize ref_size;
-        ref_size.x1min = pin->GetReal(it->block_name, "x1min");
-        ref_size.x1max = pin->GetReal(it->block_name, "x1max");
-        if (multi_d) {
-          ref_size.x2min = pin->GetReal(it->block_name, "x2min");
-          ref_size.x2max = pin->GetReal(it->block_name, "x2max");
-        } else {
-          ref_size.x2min = mesh_size.x2min;
-          ref_size.x2max = mesh_size.x2max;
-        }
-        if (three_d) {
-          ref_size.x3min = pin->GetReal(it->block_name, "x3min");
-          ref_size.x3max = pin->GetReal(it->block_name, "x3max");
-        } else {
-          ref_size.x3min = mesh_size.x3min;
-          ref_size.x3max = mesh_size.x3max;
-        }
-        int phy_ref_lev = pin->GetInteger(it->block_name, "level");
-        int log_ref_lev = phy_ref_lev + root_level;
-        if (log_ref_lev > current_level) current_level = log_ref_lev;
-
-        // error check parameters in "refinement" blocks
-        if (phy_ref_lev < 1) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "Refinement level must be larger than 0 (root level = 0)"
-              << std::endl;
-          std::exit(EXIT_FAILURE);
-        }
-        if (log_ref_lev > max_level) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "Refinement level exceeds maximum allowed ("
-              << max_level << ")" << std::endl << "Reduce/specify 'num_levels' in "
-              << "<mesh_refinement> input block if using AMR" << std::endl;
-          std::exit(EXIT_FAILURE);
-        }
-        if (   ref_size.x1min > ref_size.x1max
-            || ref_size.x2min > ref_size.x2max
-            || ref_size.x3min > ref_size.x3max)  {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "Invalid refinement region (xmax < xmin in one direction)."
-              << std::endl;
-          std::exit(EXIT_FAILURE);
-        }
-        if (   ref_size.x1min < mesh_size.x1min || ref_size.x1max > mesh_size.x1max
-            || ref_size.x2min < mesh_size.x2min || ref_size.x2max > mesh_size.x2max
-            || ref_size.x3min < mesh_size.x3min || ref_size.x3max > mesh_size.x3max) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl << "Refinement region must be fully contained within root mesh"
-              << std::endl;
-          std::exit(EXIT_FAILURE);
-        }
-
-        // note: if following is too slow, it could be replaced with bi-section search.
-        // Suppose entire root domain is tiled with MeshBlocks at the desired refinement
-        // level. Find range of x1-integer indices of such MeshBlocks that cover the
-        // refinement region
-        std::int32_t lx1min = 0, lx1max = 0;
-        std::int32_t lx2min = 0, lx2max = 0;
-        std::int32_t lx3min = 0, lx3max = 0;
-        std::int32_t lxmax = nmb_rootx1*(1<<phy_ref_lev);
-        for (lx1min=0; lx1min<lxmax; lx1min++) {
-          if (LeftEdgeX(lx1min+1,lxmax,mesh_size.x1min,mesh_size.x1max) > ref_size.x1min)
-            break;
-        }
-        for (lx1max=lx1min; lx1max<lxmax; lx1max++) {
-          if (LeftEdgeX(lx1max+1,lxmax,mesh_size.x1min,mesh_size.x1max) >= ref_size.x1max)
-            break;
-        }
-        if (lx1min % 2 == 1) lx1min--;
-        if (lx1max % 2 == 0) lx1max++;
-
-        // Find range of x2-indices of such MeshBlocks that cover the refinement region
-        if (multi_d) { // 2D or 3D
-          lxmax = nmb_rootx2*(1<<phy_ref_lev);
-          for (lx2min=0; lx2min<lxmax; lx2min++) {
-            if (LeftEdgeX(lx2min+1, lxmax, mesh_size.x2min, mesh_size.x2max) >
-                ref_size.x2min)
-            break;
-          }
-          for (lx2max=lx2min; lx2max<lxmax; lx2max++) {
-            if (LeftEdgeX(lx2max+1, lxmax, mesh_size.x2min, mesh_size.x2max) >=
-                ref_size.x2max)
-            break;
-          }
-          if (lx2min % 2 == 1) lx2min--;
-          if (lx2max % 2 == 0) lx2max++;
-        }
-
-        // Find range of x3-indices of such MeshBlocks that cover the refinement region
-        if (three_d) { // 3D
-          lxmax = nmb_rootx3*(1<<phy_ref_lev);
-          for (lx3min=0; lx3min<lxmax; lx3min++) {
-            if (LeftEdgeX(lx3min+1, lxmax, mesh_size.x3min, mesh_size.x3max) >
-                ref_size.x3min)
-            break;
-          }
-          for (lx3max=lx3min; lx3max<lxmax; lx3max++) {
-            if (LeftEdgeX(lx3max+1, lxmax, mesh_size.x3min, mesh_size.x3max) >=
-                ref_size.x3max)
-            break;
-          }
-          if (lx3min % 2 == 1) lx3min--;
-          if (lx3max % 2 == 0) lx3max++;
-        }
-
-        // Now add nodes to the MeshBlockTree corresponding to these MeshBlocks
-        if (one_d) {  // 1D
-          for (std::int32_t i=lx1min; i<lx1max; i+=2) {
-            LogicalLocation nlloc;
-            nlloc.level = log_ref_lev;
-            nlloc.lx1 = i;
-            nlloc.lx2 = 0;
-            nlloc.lx3 = 0;
-            int nnew;
-            ptree->AddNode(nlloc, nnew);
-          }
-        }
-        if (two_d) {  // 2D
-          for (std::int32_t j=lx2min; j<lx2max; j+=2) {
-            for (std::int32_t i=lx1min; i<lx1max; i+=2) {
-              LogicalLocation nlloc;
-              nlloc.level = log_ref_lev;
-              nlloc.lx1 = i;
-              nlloc.lx2 = j;
-              nlloc.lx3 = 0;
-              int nnew;
-              ptree->AddNode(nlloc, nnew);
-            }
-          }
-        }
-        if (three_d) {  // 3D
-          for (std::int32_t k=lx3min; k<lx3max; k+=2) {
-            for (std::int32_t j=lx2min; j<lx2max; j+=2) {
-              for (std::int32_t i=lx1min; i<lx1max; i+=2) {
-                LogicalLocation nlloc;
-                nlloc.level = log_ref_lev;
-                nlloc.lx1 = i;
-                nlloc.lx2 = j;
-                nlloc.lx3 = k;
-                int nnew;
-                ptree->AddNode(nlloc, nnew);
-              }
-            }
-          }
-        }
-      }
-    }
+    AddRefinementRegions(pin, current_level);
   } // if (multilevel)
 
   if (!adaptive) max_level = current_level;
@@ -310,6 +160,167 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::AddRefinementRegions():
+//! Expands MeshBlockTree to include the static refinement regions specified in
+//! "refinement" blocks in the input file.  Used when building the tree for new runs, and
+//! when a restart is remeshed.
+
+void Mesh::AddRefinementRegions(ParameterInput *pin, int &current_level) {
+  // cycle through ParameterInput list and find "refinement" blocks (SMR), extract data
+  // Expand MeshBlockTree to include "refinement" regions specified in input file:
+  for (auto it = pin->block.begin(); it != pin->block.end(); ++it) {
+    if (it->block_name.compare(0, 10, "refinement") == 0) {
+      RegionSize ref_size;
+      ref_size.x1min = pin->GetReal(it->block_name, "x1min");
+      ref_size.x1max = pin->GetReal(it->block_name, "x1max");
+      if (multi_d) {
+        ref_size.x2min = pin->GetReal(it->block_name, "x2min");
+        ref_size.x2max = pin->GetReal(it->block_name, "x2max");
+      } else {
+        ref_size.x2min = mesh_size.x2min;
+        ref_size.x2max = mesh_size.x2max;
+      }
+      if (three_d) {
+        ref_size.x3min = pin->GetReal(it->block_name, "x3min");
+        ref_size.x3max = pin->GetReal(it->block_name, "x3max");
+      } else {
+        ref_size.x3min = mesh_size.x3min;
+        ref_size.x3max = mesh_size.x3max;
+      }
+      int phy_ref_lev = pin->GetInteger(it->block_name, "level");
+      int log_ref_lev = phy_ref_lev + root_level;
+      if (log_ref_lev > current_level) current_level = log_ref_lev;
+
+      // error check parameters in "refinement" blocks
+      if (phy_ref_lev < 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "Refinement level must be larger than 0 (root level = 0)"
+            << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (log_ref_lev > max_level) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "Refinement level exceeds maximum allowed ("
+            << max_level << ")" << std::endl << "Reduce/specify 'num_levels' in "
+            << "<mesh_refinement> input block if using AMR" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (   ref_size.x1min > ref_size.x1max
+          || ref_size.x2min > ref_size.x2max
+          || ref_size.x3min > ref_size.x3max)  {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "Invalid refinement region (xmax < xmin in one direction)."
+            << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (   ref_size.x1min < mesh_size.x1min || ref_size.x1max > mesh_size.x1max
+          || ref_size.x2min < mesh_size.x2min || ref_size.x2max > mesh_size.x2max
+          || ref_size.x3min < mesh_size.x3min || ref_size.x3max > mesh_size.x3max) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "Refinement region must be fully contained within root mesh"
+            << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+
+      // note: if following is too slow, it could be replaced with bi-section search.
+      // Suppose entire root domain is tiled with MeshBlocks at the desired refinement
+      // level. Find range of x1-integer indices of such MeshBlocks that cover the
+      // refinement region
+      std::int32_t lx1min = 0, lx1max = 0;
+      std::int32_t lx2min = 0, lx2max = 0;
+      std::int32_t lx3min = 0, lx3max = 0;
+      std::int32_t lxmax = nmb_rootx1*(1<<phy_ref_lev);
+      for (lx1min=0; lx1min<lxmax; lx1min++) {
+        if (LeftEdgeX(lx1min+1,lxmax,mesh_size.x1min,mesh_size.x1max) > ref_size.x1min)
+          break;
+      }
+      for (lx1max=lx1min; lx1max<lxmax; lx1max++) {
+        if (LeftEdgeX(lx1max+1,lxmax,mesh_size.x1min,mesh_size.x1max) >= ref_size.x1max)
+          break;
+      }
+      if (lx1min % 2 == 1) lx1min--;
+      if (lx1max % 2 == 0) lx1max++;
+
+      // Find range of x2-indices of such MeshBlocks that cover the refinement region
+      if (multi_d) { // 2D or 3D
+        lxmax = nmb_rootx2*(1<<phy_ref_lev);
+        for (lx2min=0; lx2min<lxmax; lx2min++) {
+          if (LeftEdgeX(lx2min+1, lxmax, mesh_size.x2min, mesh_size.x2max) >
+              ref_size.x2min)
+          break;
+        }
+        for (lx2max=lx2min; lx2max<lxmax; lx2max++) {
+          if (LeftEdgeX(lx2max+1, lxmax, mesh_size.x2min, mesh_size.x2max) >=
+              ref_size.x2max)
+          break;
+        }
+        if (lx2min % 2 == 1) lx2min--;
+        if (lx2max % 2 == 0) lx2max++;
+      }
+
+      // Find range of x3-indices of such MeshBlocks that cover the refinement region
+      if (three_d) { // 3D
+        lxmax = nmb_rootx3*(1<<phy_ref_lev);
+        for (lx3min=0; lx3min<lxmax; lx3min++) {
+          if (LeftEdgeX(lx3min+1, lxmax, mesh_size.x3min, mesh_size.x3max) >
+              ref_size.x3min)
+          break;
+        }
+        for (lx3max=lx3min; lx3max<lxmax; lx3max++) {
+          if (LeftEdgeX(lx3max+1, lxmax, mesh_size.x3min, mesh_size.x3max) >=
+              ref_size.x3max)
+          break;
+        }
+        if (lx3min % 2 == 1) lx3min--;
+        if (lx3max % 2 == 0) lx3max++;
+      }
+
+      // Now add nodes to the MeshBlockTree corresponding to these MeshBlocks
+      if (one_d) {  // 1D
+        for (std::int32_t i=lx1min; i<lx1max; i+=2) {
+          LogicalLocation nlloc;
+          nlloc.level = log_ref_lev;
+          nlloc.lx1 = i;
+          nlloc.lx2 = 0;
+          nlloc.lx3 = 0;
+          int nnew;
+          ptree->AddNode(nlloc, nnew);
+        }
+      }
+      if (two_d) {  // 2D
+        for (std::int32_t j=lx2min; j<lx2max; j+=2) {
+          for (std::int32_t i=lx1min; i<lx1max; i+=2) {
+            LogicalLocation nlloc;
+            nlloc.level = log_ref_lev;
+            nlloc.lx1 = i;
+            nlloc.lx2 = j;
+            nlloc.lx3 = 0;
+            int nnew;
+            ptree->AddNode(nlloc, nnew);
+          }
+        }
+      }
+      if (three_d) {  // 3D
+        for (std::int32_t k=lx3min; k<lx3max; k+=2) {
+          for (std::int32_t j=lx2min; j<lx2max; j+=2) {
+            for (std::int32_t i=lx1min; i<lx1max; i+=2) {
+              LogicalLocation nlloc;
+              nlloc.level = log_ref_lev;
+              nlloc.lx1 = i;
+              nlloc.lx2 = j;
+              nlloc.lx3 = k;
+              int nnew;
+              ptree->AddNode(nlloc, nnew);
+            }
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Mesh::BuildTreeFromRestart():
 //! Constructs MeshBlockTree, creates MeshBlockPack (containing the physics modules), and
@@ -341,6 +352,11 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
   MPI_Bcast(headerdata, headersize, MPI_CHAR, 0, MPI_COMM_WORLD);
 #endif
 
+  // Save Mesh and MeshBlock dimensions set from input file in Mesh constructor, which are
+  // used if the restart is remeshed onto different MeshBlocks
+  RegionIndcs new_mesh_indcs = mesh_indcs;
+  RegionIndcs new_mb_indcs = mb_indcs;
+
   // Now copy mesh data read from restart file into Mesh variables. Order of variables
   // set by Write()'s in restart.cpp
   // Note this overwrites size and indices initialized in Mesh constructor.
@@ -437,6 +453,20 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
     }
   }
 
+  // Remesh if dimensions of Mesh or MeshBlocks in input file differ from those in restart
+  // file, or if requested with <mesh>/restart_remesh (e.g. to add refinement regions).
+  // Flag is reset so that later restart files are not remeshed again.
+  bool remesh = pin->GetOrAddBoolean("mesh", "restart_remesh", false);
+  if (new_mesh_indcs.nx1 != mesh_indcs.nx1 || new_mb_indcs.nx1 != mb_indcs.nx1 ||
+      new_mesh_indcs.nx2 != mesh_indcs.nx2 || new_mb_indcs.nx2 != mb_indcs.nx2 ||
+      new_mesh_indcs.nx3 != mesh_indcs.nx3 || new_mb_indcs.nx3 != mb_indcs.nx3) {
+    remesh = true;
+  }
+  if (remesh) {
+    RemeshTree(pin, new_mesh_indcs, new_mb_indcs, current_level);
+    pin->SetBoolean("mesh", "restart_remesh", false);
+  }
+
 #ifdef MPI_PARALLEL_ENABLED
   // check there is at least one MeshBlock per MPI rank
   if (nmb_total < global_variable::nranks) {
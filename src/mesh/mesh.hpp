@@ -14,6 +14,7 @@
 #include <cstdint>  // int32_t
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 
@@ -74,6 +75,21 @@ struct EventCounters {
                     neos_vceil(0), neos_fail(0), maxit_c2p(0) {}
 };
 
+//----------------------------------------------------------------------------------------
+//! \struct RestartMeshData
+//! \brief dimensions and MeshBlocks of the Mesh stored in a restart file, saved when a
+//! restart is remeshed onto different MeshBlocks (see remesh_restart.cpp)
+
+struct RestartMeshData {
+  int nmb_total;                 // number of MeshBlocks in restart file
+  int root_level;                // logical level of root grid in restart file
+  int nlevels;                   // number of levels by which root grid is refined
+  RegionIndcs mesh_indcs;        // indices of cells in Mesh in restart file
+  RegionIndcs mb_indcs;          // indices of cells in MeshBlocks in restart file
+  std::vector<LogicalLocation> lloc_eachmb;
+  Real tolerance;                // max change in conserved totals and div(B) allowed
+};
+
 // Forward declarations required due to recursive definitions amongst mesh classes
 class MeshBlock;
 class MeshBlockPack;
@@ -99,6 +115,8 @@ class Mesh {
   friend class MeshRefinement;
   // needs to access tree to find target MB offset by shear
   friend class ShearingBoxBoundary;
+  // needs to access tree to find MeshBlocks of particles in remeshed restarts
+  friend class ProblemGenerator;
 
  public:
   explicit Mesh(ParameterInput *pin);
@@ -146,10 +164,13 @@ class Mesh {
   MeshBlockPack* pmb_pack;                 // container for MeshBlocks on this rank
   std::unique_ptr<ProblemGenerator> pgen;  // class containing functions to set ICs
   MeshRefinement *pmr=nullptr;             // mesh refinement data/functions (if needed)
+  std::unique_ptr<RestartMeshData> prst_mesh;  // Mesh in restart file (if remeshed)
 
   // functions
   void BuildTreeFromScratch(ParameterInput *pin);
   void BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile);
+  void RemeshRestartData(IOWrapper &resfile, IOWrapperSizeT headeroffset,
+                         IOWrapperSizeT data_size);
   void PrintMeshDiagnostics();
   void WriteMeshStructure();
   void NewTimeStep(const Real tlim);
@@ -176,5 +197,8 @@ class Mesh {
  private:
   std::unique_ptr<MeshBlockTree> ptree;  // pointer to root node in binary/quad/oct-tree
   void LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb);
+  void AddRefinementRegions(ParameterInput *pin, int &current_level);
+  void RemeshTree(ParameterInput *pin, const RegionIndcs &new_mesh_indcs,
+                  const RegionIndcs &new_mb_indcs, int &current_level);
 };
 #endif  // MESH_MESH_HPP_
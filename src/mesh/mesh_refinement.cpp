@@ -22,10 +22,12 @@
 #include "mesh_refinement.hpp"
 
 #include "hydro/hydro.hpp"
+#include "eos/eos.hpp"
 #include "mhd/mhd.hpp"
 #include "radiation/radiation.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
+#include "utils/timers.hpp"
 #include "prolongation.hpp"
 #include "restriction.hpp"
 
@@ -51,6 +53,7 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
   dd_threshold_(0.0),
   dp_threshold_(0.0),
   dv_threshold_(0.0),
+  ev_threshold_(-1),
   check_cons_(false) {
   if (pin->DoesBlockExist("mesh_refinement")) {
     // read interval (in cycles) between check of AMR and derefinement
@@ -77,6 +80,9 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
       dd_threshold_ = pin->GetReal("mesh_refinement", "dvel_max");
       check_cons_ = true;
     }
+    if (pin->DoesParameterExist("mesh_refinement", "eos_events_max")) {
+      ev_threshold_ = pin->GetInteger("mesh_refinement", "eos_events_max");
+    }
   }
 
   if (pm->adaptive) {  // allocate arrays for AMR
@@ -121,15 +127,21 @@ MeshRefinement::~MeshRefinement() {
 
 void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin) {
   // first check refinement criteria
+  timers::Start("CheckForRefinement");
   CheckForRefinement(pmy_mesh->pmb_pack);
+  timers::Stop();
 
   // then update mesh tree if MeshBlock anywhere (on any rank) is flagged for refinement
   int nnew = 0, ndel = 0;
+  timers::Start("UpdateMeshBlockTree");
   UpdateMeshBlockTree(nnew, ndel);
+  timers::Stop();
 
   // Refine/derefine mesh and evolved data, set boundary conditions/timestep on new mesh
   if (nnew != 0 || ndel != 0) { // at least one (de)refinement flagged
+    timers::Start("RedistAndRefineMeshBlocks");
     RedistAndRefineMeshBlocks(pin, nnew, ndel);
+    timers::Stop();
     pdriver->InitBoundaryValuesAndPrimitives(pmy_mesh);
 
     MeshBlockPack* pmbp = pmy_mesh->pmb_pack;
@@ -162,6 +174,8 @@ void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin
 //!   (3) gradient of pressure above a threshold value (hydro/MHD)
 //!   TODO(@user) (4) shear of velocity above a threshold value (hydro/MHD)
 //!   TODO(@user) (5) current density above a threshold (MHD)
+//!   (6) number of C2P failures and floors in last cycle above a threshold (requires
+//!       <hydro>/event_map or <mhd>/event_map)
 //! These are controlled by input parameters in the <mesh_refinement> block.
 //! User-defined refinement conditions can also be enrolled by setting the *usr_ref_func
 //! pointer in the problem generator.
@@ -271,6 +285,27 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   refine_flag.template modify<DevExeSpace>();
   refine_flag.template sync<HostMemSpace>();
 
+  // Check (on host) number of C2P failures and floors in each MeshBlock in last cycle
+  if (ev_threshold_ >= 0) {
+    EquationOfState *peos = nullptr;
+    if (pmbp->pmhd != nullptr) {
+      peos = pmbp->pmhd->peos;
+    } else if (pmbp->phydro != nullptr) {
+      peos = pmbp->phydro->peos;
+    }
+    if (peos == nullptr || !(peos->events.enabled)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mesh_refinement>/eos_events_max requires Hydro or MHD "
+                << "with event_map = true" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    for (int m=0; m<nmb; ++m) {
+      int nev = 0;
+      for (int n=0; n<N_EOS_EVENTS; ++n) {nev += peos->event_summary.h_view(m,n);}
+      if (nev > ev_threshold_) {refine_flag.h_view(m+mbs) = 1;}
+    }
+  }
+
   // Check (on host) for MeshBlocks at max/root level flagged for refine/derefine
   for (int m=0; m<nmb; ++m) {
     if (pmy_mesh->lloc_eachmb[m+mbs].level == pmy_mesh->max_level) {
@@ -514,8 +549,10 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   new_nmb_eachrank = new int[global_variable::nranks];
 
   for (int i=0; i<new_nmb; i++) {new_cost_eachmb[i] = 1.0;}
+  timers::Start("LoadBalance");
   pm->LoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank, new_nmb_eachrank,
                   new_nmb_total);
+  timers::Stop();
   if (new_nmb_eachrank[global_variable::my_rank] > pm->nmb_maxperrank) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Number of MeshBlocks in this rank on new tree = "
@@ -673,6 +710,10 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   pm->pmb_pack->AddCoordinates(pin);
   pm->pmb_pack->pmb->SetNeighbors(pm->ptree, pm->rank_eachmb);
 
+  // maps of C2P failures and floors no longer refer to the right MeshBlocks
+  if (phydro != nullptr) {phydro->peos->ResetEvents();}
+  if (pmhd != nullptr) {pmhd->peos->ResetEvents();}
+
   // clean-up and return
   delete [] newtoold;
   delete [] oldtonew;
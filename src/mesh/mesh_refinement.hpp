@@ -132,6 +132,7 @@ class MeshRefinement {
   // data
   Mesh *pmy_mesh;
   Real d_threshold_, dd_threshold_, dp_threshold_, dv_threshold_, chi_threshold_;
+  int ev_threshold_;  // max number of C2P failures/floors per MeshBlock per cycle
   bool check_cons_;
 };
 #endif // MESH_MESH_REFINEMENT_HPP_
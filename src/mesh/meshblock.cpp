@@ -19,15 +19,16 @@
 
 //----------------------------------------------------------------------------------------
 // MeshBlock constructor:
-// Initializes mb_gid, mb_lev, mb_size, mb_bcs arrays.  The nghbrs array is initialized
-// by SetNeighbors function called by BuildTree***() functions.
+// Initializes mb_gid, mb_lev, mb_size, mb_bcs, bcs_list arrays.  The nghbrs array is
+// initialized by SetNeighbors function called by BuildTree***() functions.
 
 MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
   pmy_pack(ppack),
   mb_gid("mb_gid",nmb),
   mb_lev("mb_lev",nmb),
   mb_size("mbsize",nmb),
-  mb_bcs("mbbcs",nmb,6) {
+  mb_bcs("mbbcs",nmb,6),
+  bcs_list("bcs_list",6,nmb) {
   Mesh* pm = pmy_pack->pmesh;
   auto &ms = pm->mesh_size;
 
@@ -121,16 +122,32 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
     mb_size.h_view(m).idx3 = 1./mb_size.h_view(m).dx3;
   }
 
+  // build lists of MeshBlocks with physical boundaries at each face.  Since MeshBlocks
+  // are reconstructed after every regrid with AMR, so are these lists.
+  for (int f=0; f<6; ++f) {
+    nbcs_list[f] = 0;
+    for (int m=0; m<nmb; ++m) {
+      BoundaryFlag bc = mb_bcs.h_view(m,f);
+      if (bc != BoundaryFlag::block && bc != BoundaryFlag::periodic &&
+          bc != BoundaryFlag::shear_periodic) {
+        bcs_list.h_view(f,nbcs_list[f]) = m;
+        nbcs_list[f]++;
+      }
+    }
+  }
+
   // For each DualArray: mark host views as modified, and then sync to device array
   mb_gid.template modify<HostMemSpace>();
   mb_lev.template modify<HostMemSpace>();
   mb_size.template modify<HostMemSpace>();
   mb_bcs.template modify<HostMemSpace>();
+  bcs_list.template modify<HostMemSpace>();
 
   mb_gid.template sync<DevExeSpace>();
   mb_lev.template sync<DevExeSpace>();
   mb_size.template sync<DevExeSpace>();
   mb_bcs.template sync<DevExeSpace>();
+  bcs_list.template sync<DevExeSpace>();
 }
 
 //----------------------------------------------------------------------------------------
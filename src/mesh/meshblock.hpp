@@ -42,6 +42,12 @@ class MeshBlock {
   DualArray2D<BoundaryFlag> mb_bcs;  // boundary conditions at 6 faces of each MeshBlock
   DualArray2D<NeighborBlock> nghbr;  // data on all (up to 56) neighbors for each MB
 
+  // compact lists of indices of MeshBlocks with physical boundaries (i.e. not block,
+  // periodic, or shear_periodic) at each of 6 faces, so that kernels applying BCs can
+  // skip interior MeshBlocks.  Entries [0,nbcs_list[f]) of bcs_list(f,...) are valid.
+  DualArray2D<int> bcs_list;
+  int nbcs_list[6];
+
   // function to set data describing neighbors
   void SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist);
 
@@ -28,7 +28,10 @@
 #include "radiation/radiation.hpp"
 #include "srcterms/turb_driver.hpp"
 #include "particles/particles.hpp"
+#include "gravity/gravity.hpp"
+#include "m1/m1.hpp"
 #include "units/units.hpp"
+#include "utils/memory_usage.hpp"
 #include "meshblock_pack.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -51,6 +54,8 @@ MeshBlockPack::MeshBlockPack(Mesh *pm, int igids, int igide) :
 // MeshBlock destructor
 
 MeshBlockPack::~MeshBlockPack() {
+  // arrays tracked for memory usage are about to be deleted
+  memory_usage::Clear();
   delete pcoord;
   if (phydro != nullptr) {delete phydro;}
   if (pmhd   != nullptr) {delete pmhd;}
@@ -63,6 +68,8 @@ MeshBlockPack::~MeshBlockPack() {
   if (punit  != nullptr) {delete punit;}
   if (pz4c   != nullptr) {delete pz4c;}
   if (ppart  != nullptr) {delete ppart;}
+  if (pgrav  != nullptr) {delete pgrav;}
+  if (pm1    != nullptr) {delete pm1;}
   // must be last, since it calls ~BoundaryValues() which (MPI) uses pmy_pack->pmb->nnghbr
   delete pmb;
 }
@@ -224,6 +231,33 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
     ppart = nullptr;
   }
 
+  // (9) SELF-GRAVITY
+  // Potential of the fluid is computed at the start of each stage.  Source terms are
+  // added to the fluid by SourceTerms (which checks for the <gravity> block).
+  if (pin->DoesBlockExist("gravity")) {
+    if ((phydro == nullptr && pmhd == nullptr) || pionn != nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<gravity> requires exactly one of <hydro> or <mhd> "
+                << "blocks in input file" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    pgrav = new gravity::Gravity(this, pin);
+    pgrav->IncludeSolveTask(tl_map["before_stagen"], none);
+  } else {
+    pgrav = nullptr;
+  }
+
+  // (10) M1 RADIATION TRANSPORT
+  // Gray two-moment transport.  Created last, since it couples to dynamical GRMHD and
+  // reads the metric from the ADM variables.
+  if (pin->DoesBlockExist("m1")) {
+    pm1 = new m1::M1(this, pin);
+    nphysics++;
+    pm1->AssembleM1Tasks(tl_map);
+  } else {
+    pm1 = nullptr;
+  }
+
   // Check that at least ONE is requested and initialized.
   // Error if there are no physics blocks in the input file.
   if (nphysics == 0) {
@@ -33,6 +33,8 @@ namespace radiation {class Radiation;}
 namespace z4c {class Z4c;}
 namespace adm {class ADM;}
 namespace particles {class Particles;}
+namespace gravity {class Gravity;}
+namespace m1 {class M1;}
 namespace units {class Units;}
 
 //----------------------------------------------------------------------------------------
@@ -72,6 +74,8 @@ class MeshBlockPack {
   TurbulenceDriver *pturb=nullptr;
   radiation::Radiation *prad=nullptr;
   particles::Particles *ppart=nullptr;
+  gravity::Gravity *pgrav=nullptr;
+  m1::M1 *pm1=nullptr;
 
   // units (needed to convert code units to cgs for, e.g., cooling or radiation)
   units::Units *punit=nullptr;
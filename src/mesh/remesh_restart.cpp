@@ -0,0 +1,1012 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file remesh_restart.cpp
+//! \brief Functions to restart onto a different Mesh than the one stored in the restart
+//! file.  A restart is remeshed when the number of cells in the <meshblock> or <mesh>
+//! blocks of the input file differs from that in the restart file, or when
+//! <mesh>/restart_remesh=true (for example to add new <refinement> regions):
+//!  - MeshBlocks can be of any (allowed) size, the data is regrouped into the new blocks
+//!  - the number of cells in the root grid can be 2^n times that in the restart file, in
+//!    which case every MeshBlock is refined by n levels
+//!  - static refinement regions in <refinement> blocks are added to the tree
+//! Every region of the new Mesh is at least as refined as it was in the restart file, so
+//! data is only ever prolongated, using the same operators as in SMR/AMR: piecewise-
+//! linear for cell-centered variables, and the divergence-preserving operator of Toth &
+//! Roe (2002) for face-centered fields.  Each rank reads the data it needs directly from
+//! the restart file, so no communication is required.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh.hpp"
+#include "prolongation.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "coordinates/adm.hpp"
+#include "z4c/z4c.hpp"
+#include "radiation/radiation.hpp"
+#include "m1/m1.hpp"
+#include "srcterms/turb_driver.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::RemeshTree()
+//! \brief Replaces the MeshBlockTree read from the restart file with one built using the
+//! Mesh and MeshBlock dimensions in the input file.  Every MeshBlock in the restart file
+//! is covered by new MeshBlocks at the same level relative to the root grid.  The old
+//! structure is saved in prst_mesh so the data can be read in RemeshRestartData().
+
+void Mesh::RemeshTree(ParameterInput *pin, const RegionIndcs &new_mesh_indcs,
+                      const RegionIndcs &new_mb_indcs, int &current_level) {
+  prst_mesh = std::make_unique<RestartMeshData>();
+  RestartMeshData &old = *prst_mesh;
+  old.nmb_total = nmb_total;
+  old.root_level = root_level;
+  old.mesh_indcs = mesh_indcs;
+  old.mb_indcs = mb_indcs;
+  old.lloc_eachmb.assign(lloc_eachmb, lloc_eachmb + nmb_total);
+  old.tolerance = pin->GetOrAddReal("mesh", "remesh_tolerance", 1.0e-10);
+
+  // number of levels by which root grid is refined
+  int nadd = 0;
+  while ((mesh_indcs.nx1 << nadd) < new_mesh_indcs.nx1) {nadd++;}
+  if (((mesh_indcs.nx1 << nadd) != new_mesh_indcs.nx1) ||
+      ((mesh_indcs.nx2 << nadd) != new_mesh_indcs.nx2 && multi_d) ||
+      ((mesh_indcs.nx3 << nadd) != new_mesh_indcs.nx3 && three_d)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "When remeshing a restart, number of cells in <mesh> must be 2^n times "
+              << "the number in restart file (" << mesh_indcs.nx1 << "," << mesh_indcs.nx2
+              << "," << mesh_indcs.nx3 << ") in every direction, n>=0" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (new_mesh_indcs.ng != mesh_indcs.ng) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Number of ghost zones cannot be changed when remeshing a restart"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  old.nlevels = nadd;
+
+  // Mesh and MeshBlock dimensions from input file.  Physical size is that in restart file
+  mesh_indcs = new_mesh_indcs;
+  mb_indcs = new_mb_indcs;
+  mesh_size.dx1 = (mesh_size.x1max-mesh_size.x1min)/static_cast<Real>(mesh_indcs.nx1);
+  mesh_size.dx2 = (mesh_size.x2max-mesh_size.x2min)/static_cast<Real>(mesh_indcs.nx2);
+  mesh_size.dx3 = (mesh_size.x3max-mesh_size.x3min)/static_cast<Real>(mesh_indcs.nx3);
+  nmb_rootx1 = mesh_indcs.nx1/mb_indcs.nx1;
+  nmb_rootx2 = mesh_indcs.nx2/mb_indcs.nx2;
+  nmb_rootx3 = mesh_indcs.nx3/mb_indcs.nx3;
+  int nmbmax = (nmb_rootx1 > nmb_rootx2) ? nmb_rootx1 : nmb_rootx2;
+  nmbmax = (nmbmax > nmb_rootx3) ? nmbmax : nmb_rootx3;
+  for (root_level=0; ((1<<root_level) < nmbmax); root_level++) {}
+  current_level = root_level;
+  if (adaptive) {
+    max_level = pin->GetOrAddInteger("mesh_refinement", "num_levels", 1) + root_level - 1;
+  } else {
+    max_level = 31;
+  }
+
+  ptree = std::make_unique<MeshBlockTree>(this);
+  ptree->CreateRootGrid();
+
+  // Add nodes covering each MeshBlock in restart file.  In each direction its cells,
+  // refined by nadd levels, span [lx*nx_old, (lx+1)*nx_old)*2^nadd at its new level.
+  int nbo[3] = {old.mb_indcs.nx1, old.mb_indcs.nx2, old.mb_indcs.nx3};
+  int nbn[3] = {mb_indcs.nx1, mb_indcs.nx2, mb_indcs.nx3};
+  bool active[3] = {true, multi_d, three_d};
+  for (int n=0; n<old.nmb_total; ++n) {
+    const LogicalLocation &lloc = old.lloc_eachmb[n];
+    int lev = lloc.level - old.root_level + root_level;
+    if (lev == root_level) continue;
+    if (lev > max_level) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Remeshed restart requires more levels than allowed by "
+                << "<mesh_refinement>/num_levels" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (lev > current_level) current_level = lev;
+    std::int64_t lx[3] = {lloc.lx1, lloc.lx2, lloc.lx3};
+    std::int64_t lmin[3] = {0, 0, 0}, lmax[3] = {0, 0, 0};
+    for (int d=0; d<3; ++d) {
+      if (active[d]) {
+        lmin[d] = ((lx[d]*nbo[d]) << nadd)/nbn[d];
+        lmax[d] = ((((lx[d] + 1)*nbo[d]) << nadd) - 1)/nbn[d];
+      }
+    }
+    for (std::int64_t k=lmin[2]; k<=lmax[2]; ++k) {
+      for (std::int64_t j=lmin[1]; j<=lmax[1]; ++j) {
+        for (std::int64_t i=lmin[0]; i<=lmax[0]; ++i) {
+          LogicalLocation nlloc;
+          nlloc.level = lev;
+          nlloc.lx1 = static_cast<std::int32_t>(i);
+          nlloc.lx2 = static_cast<std::int32_t>(j);
+          nlloc.lx3 = static_cast<std::int32_t>(k);
+          int nnew;
+          ptree->AddNode(nlloc, nnew);
+        }
+      }
+    }
+  }
+
+  // add any static refinement regions in input file
+  if (multilevel) {
+    AddRefinementRegions(pin, current_level);
+  } else if (current_level > root_level) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Restart file contains refined MeshBlocks, but mesh refinement is not "
+              << "enabled in <mesh_refinement> block" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (!adaptive) max_level = current_level;
+
+  // replace lists of MeshBlocks read from restart file with those of new tree
+  ptree->CountMeshBlocks(nmb_total);
+  delete [] cost_eachmb;
+  delete [] rank_eachmb;
+  delete [] lloc_eachmb;
+  cost_eachmb = new float[nmb_total];
+  rank_eachmb = new int[nmb_total];
+  lloc_eachmb = new LogicalLocation[nmb_total];
+  ptree->CreateZOrderedLLList(lloc_eachmb, nullptr, nmb_total);
+  for (int i=0; i<nmb_total; i++) {cost_eachmb[i] = 1.0;}
+
+  if (global_variable::my_rank == 0) {
+    std::cout << "Remeshing restart: " << old.nmb_total << " MeshBlocks of "
+              << old.mb_indcs.nx1 << "x" << old.mb_indcs.nx2 << "x" << old.mb_indcs.nx3
+              << " cells onto " << nmb_total << " MeshBlocks of " << mb_indcs.nx1 << "x"
+              << mb_indcs.nx2 << "x" << mb_indcs.nx3 << " cells, root grid refined by "
+              << nadd << " level(s)" << std::endl;
+  }
+  return;
+}
+
+// Anonymous namespace for data structures and functions used only in this file
+namespace {
+//----------------------------------------------------------------------------------------
+//! \struct BlockExtent
+//! \brief range of cells [lo,hi) spanned by a MeshBlock in each direction, counted at the
+//! level of its data relative to the root grid of the new Mesh.  For MeshBlocks in the
+//! restart file this level is negative if the root grid has been refined.  Inactive
+//! directions span the single cell [0,1).
+
+struct BlockExtent {
+  int level;
+  std::int64_t lo[3], hi[3];
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct CCPatch, FCPatch
+//! \brief cell- or face-centered data on cells [lo,lo+n) at one level, stored in arrays
+//! with a single MeshBlock so that the prolongation operators can be applied directly
+
+struct CCPatch {
+  int level;
+  std::int64_t lo[3];
+  int n[3];
+  DvceArray5D<Real> a;
+};
+
+struct FCPatch {
+  int level;
+  std::int64_t lo[3];
+  int n[3];
+  DvceFaceFld4D<Real> b;
+  FCPatch() : b("rmsh-fc", 1, 1, 1, 1) {}
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct FineNeighbor
+//! \brief a MeshBlock in the restart file one level finer than, and sharing a face with,
+//! another MeshBlock.  Its field on the shared face is used when prolongating the coarser
+//! MeshBlock, so that the result is divergence-free.
+
+struct FineNeighbor {
+  int n;                // index of MeshBlock in restart file
+  int dir;              // direction normal to shared face
+  std::int64_t plane;   // location of face at level of fine MeshBlock
+  std::int64_t shift;   // offset of fine MeshBlock across periodic boundaries
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct RemeshGrid
+//! \brief dimensions of old (restart file) and new MeshBlocks
+
+struct RemeshGrid {
+  bool active[3], periodic[3];
+  bool multi_d, three_d;
+  int ng;                             // number of ghost zones (same in old and new)
+  int nout[3];                        // old MeshBlock cells including ghost zones
+  int is[3];                          // index of first active cell in new MeshBlocks
+  std::int64_t nroot[3];              // number of cells in new root grid
+  IOWrapperSizeT headeroffset, data_size;
+  int nbo[3];                         // old MeshBlock cells (without ghost zones)
+  Real len[3];                        // length of Mesh in each direction
+  std::vector<BlockExtent> old_ext;   // extents of MeshBlocks in restart file
+  std::vector<BlockExtent> new_ext;   // extents of new MeshBlocks on this rank
+};
+
+std::int64_t Shift(std::int64_t x, int p) {
+  return (p >= 0)? (x << p) : (x >> (-p));
+}
+
+std::int64_t FloorHalf(std::int64_t x) {
+  return (x >= 0)? (x/2) : -((1 - x)/2);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ReadCCPatch()
+//! \brief reads nvar cell-centered variables (including ghost zones) of MeshBlock n in
+//! restart file, stored at byte offset varoffset within the data of each MeshBlock
+
+CCPatch ReadCCPatch(IOWrapper &resfile, const RemeshGrid &g, int n,
+                    IOWrapperSizeT varoffset, int nvar) {
+  HostArray5D<Real> h("rmsh-ccin", 1, nvar, g.nout[2], g.nout[1], g.nout[0]);
+  IOWrapperSizeT offset = g.headeroffset + g.data_size*n + varoffset;
+  if (resfile.Read_Reals_at(h.data(), h.size(), offset) != h.size()) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "CC data not read correctly from rst file, restart file is broken."
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  CCPatch p;
+  p.level = g.old_ext[n].level;
+  for (int d=0; d<3; ++d) {
+    p.lo[d] = g.old_ext[n].lo[d] - ((g.active[d])? g.ng : 0);
+    p.n[d] = g.nout[d];
+  }
+  p.a = DvceArray5D<Real>("rmsh-cc", 1, nvar, p.n[2], p.n[1], p.n[0]);
+  Kokkos::deep_copy(p.a, h);
+  return p;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ReadFCPatch()
+//! \brief reads face-centered field (including ghost zones) of MeshBlock n
+
+FCPatch ReadFCPatch(IOWrapper &resfile, const RemeshGrid &g, int n,
+                    IOWrapperSizeT varoffset) {
+  HostFaceFld4D<Real> h("rmsh-fcin", 1, g.nout[2], g.nout[1], g.nout[0]);
+  IOWrapperSizeT offset = g.headeroffset + g.data_size*n + varoffset;
+  bool ok = (resfile.Read_Reals_at(h.x1f.data(), h.x1f.size(), offset) == h.x1f.size());
+  offset += h.x1f.size()*sizeof(Real);
+  ok = ok && (resfile.Read_Reals_at(h.x2f.data(), h.x2f.size(), offset) == h.x2f.size());
+  offset += h.x2f.size()*sizeof(Real);
+  ok = ok && (resfile.Read_Reals_at(h.x3f.data(), h.x3f.size(), offset) == h.x3f.size());
+  if (!(ok)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "FC data not read correctly from rst file, restart file is broken."
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  FCPatch p;
+  p.level = g.old_ext[n].level;
+  for (int d=0; d<3; ++d) {
+    p.lo[d] = g.old_ext[n].lo[d] - ((g.active[d])? g.ng : 0);
+    p.n[d] = g.nout[d];
+  }
+  p.b = DvceFaceFld4D<Real>("rmsh-fc", 1, p.n[2], p.n[1], p.n[0]);
+  Kokkos::deep_copy(p.b.x1f, h.x1f);
+  Kokkos::deep_copy(p.b.x2f, h.x2f);
+  Kokkos::deep_copy(p.b.x3f, h.x3f);
+  return p;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn NeededRange()
+//! \brief range of cells [lo,hi) at level s needed to prolongate cells [lo,hi) at level
+//! s+1: their parents plus one cell on either side for the limited slopes.
+
+void NeededRange(const RemeshGrid &g, std::int64_t lo[3], std::int64_t hi[3]) {
+  for (int d=0; d<3; ++d) {
+    if (g.active[d]) {
+      lo[d] = FloorHalf(lo[d]) - 1;
+      hi[d] = FloorHalf(hi[d] - 1) + 2;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CheckRange()
+//! \brief error check that cells [lo,hi) are contained in a patch
+
+void CheckRange(const std::int64_t plo[3], const int pn[3], const std::int64_t lo[3],
+                const std::int64_t hi[3]) {
+  for (int d=0; d<3; ++d) {
+    if (lo[d] < plo[d] || hi[d] > plo[d] + pn[d]) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Data needed to remesh restart not contained in "
+                << "MeshBlock and its ghost zones" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CropCC()
+//! \brief returns the part of a cell-centered patch on cells [lo,hi)
+
+CCPatch CropCC(const CCPatch &c, const std::int64_t lo[3], const std::int64_t hi[3]) {
+  CheckRange(c.lo, c.n, lo, hi);
+  CCPatch f;
+  f.level = c.level;
+  int o[3];
+  for (int d=0; d<3; ++d) {
+    f.lo[d] = lo[d];
+    f.n[d] = static_cast<int>(hi[d] - lo[d]);
+    o[d] = static_cast<int>(lo[d] - c.lo[d]);
+  }
+  int nvar = c.a.extent_int(1);
+  f.a = DvceArray5D<Real>("rmsh-cc", 1, nvar, f.n[2], f.n[1], f.n[0]);
+  auto ca = c.a, fa = f.a;
+  int oi = o[0], oj = o[1], ok = o[2];
+  par_for("rmsh-cropcc", DevExeSpace(), 0, nvar-1, 0, f.n[2]-1, 0, f.n[1]-1, 0, f.n[0]-1,
+  KOKKOS_LAMBDA(const int v, const int k, const int j, const int i) {
+    fa(0,v,k,j,i) = ca(0,v,k+ok,j+oj,i+oi);
+  });
+  return f;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CropFC()
+//! \brief returns the part of a face-centered patch on faces of cells [lo,hi)
+
+FCPatch CropFC(const FCPatch &c, const std::int64_t lo[3], const std::int64_t hi[3]) {
+  CheckRange(c.lo, c.n, lo, hi);
+  FCPatch f;
+  f.level = c.level;
+  int o[3];
+  for (int d=0; d<3; ++d) {
+    f.lo[d] = lo[d];
+    f.n[d] = static_cast<int>(hi[d] - lo[d]);
+    o[d] = static_cast<int>(lo[d] - c.lo[d]);
+  }
+  f.b = DvceFaceFld4D<Real>("rmsh-fc", 1, f.n[2], f.n[1], f.n[0]);
+  auto cb = c.b, fb = f.b;
+  int oi = o[0], oj = o[1], ok = o[2];
+  par_for("rmsh-cropfc1", DevExeSpace(), 0, f.n[2]-1, 0, f.n[1]-1, 0, f.n[0],
+  KOKKOS_LAMBDA(const int k, const int j, const int i) {
+    fb.x1f(0,k,j,i) = cb.x1f(0,k+ok,j+oj,i+oi);
+  });
+  par_for("rmsh-cropfc2", DevExeSpace(), 0, f.n[2]-1, 0, f.n[1], 0, f.n[0]-1,
+  KOKKOS_LAMBDA(const int k, const int j, const int i) {
+    fb.x2f(0,k,j,i) = cb.x2f(0,k+ok,j+oj,i+oi);
+  });
+  par_for("rmsh-cropfc3", DevExeSpace(), 0, f.n[2], 0, f.n[1]-1, 0, f.n[0]-1,
+  KOKKOS_LAMBDA(const int k, const int j, const int i) {
+    fb.x3f(0,k,j,i) = cb.x3f(0,k+ok,j+oj,i+oi);
+  });
+  return f;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ProlongCCPatch()
+//! \brief prolongates all cells of a patch except the outermost layer, which is only
+//! used for slopes, using same operator as SMR/AMR
+
+CCPatch ProlongCCPatch(const CCPatch &c, const RemeshGrid &g) {
+  CCPatch f;
+  f.level = c.level + 1;
+  int il[3], iu[3];
+  for (int d=0; d<3; ++d) {
+    if (g.active[d]) {
+      f.lo[d] = 2*(c.lo[d] + 1);
+      f.n[d] = 2*(c.n[d] - 2);
+      il[d] = 1;
+      iu[d] = c.n[d] - 2;
+    } else {
+      f.lo[d] = 0;
+      f.n[d] = 1;
+      il[d] = 0;
+      iu[d] = 0;
+    }
+  }
+  int nvar = c.a.extent_int(1);
+  f.a = DvceArray5D<Real>("rmsh-cc", 1, nvar, f.n[2], f.n[1], f.n[0]);
+  auto ca = c.a, fa = f.a;
+  bool multi_d = g.multi_d, three_d = g.three_d;
+  par_for("rmsh-prolcc", DevExeSpace(), 0, nvar-1, il[2], iu[2], il[1], iu[1],
+          il[0], iu[0],
+  KOKKOS_LAMBDA(const int v, const int k, const int j, const int i) {
+    int fi = 2*(i - 1);
+    int fj = (multi_d)? 2*(j - 1) : j;
+    int fk = (three_d)? 2*(k - 1) : k;
+    ProlongCC(0,v,k,j,i,fk,fj,fi,multi_d,three_d,ca,fa);
+  });
+  return f;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ProlongFCSharedPatch()
+//! \brief prolongates field on faces of coarse cells of a patch (except the outermost
+//! layer), the first step of divergence-preserving prolongation
+
+FCPatch ProlongFCSharedPatch(const FCPatch &c, const RemeshGrid &g) {
+  FCPatch f;
+  f.level = c.level + 1;
+  int il[3], iu[3];
+  for (int d=0; d<3; ++d) {
+    if (g.active[d]) {
+      f.lo[d] = 2*(c.lo[d] + 1);
+      f.n[d] = 2*(c.n[d] - 2);
+      il[d] = 1;
+      iu[d] = c.n[d] - 2;
+    } else {
+      f.lo[d] = 0;
+      f.n[d] = 1;
+      il[d] = 0;
+      iu[d] = 0;
+    }
+  }
+  f.b = DvceFaceFld4D<Real>("rmsh-fc", 1, f.n[2], f.n[1], f.n[0]);
+  auto cb = c.b, fb = f.b;
+  bool multi_d = g.multi_d, three_d = g.three_d;
+  par_for("rmsh-prolfc1", DevExeSpace(), il[2], iu[2], il[1], iu[1], il[0], iu[0]+1,
+  KOKKOS_LAMBDA(const int k, const int j, const int i) {
+    int fi = 2*(i - 1);
+    int fj = (multi_d)? 2*(j - 1) : j;
+    int fk = (three_d)? 2*(k - 1) : k;
+    ProlongFCSharedX1Face(0,k,j,i,fk,fj,fi,multi_d,three_d,cb.x1f,fb.x1f);
+  });
+  par_for("rmsh-prolfc2", DevExeSpace(), il[2], iu[2], il[1], iu[1]+1, il[0], iu[0],
+  KOKKOS_LAMBDA(const int k, const int j, const int i) {
+    int fi = 2*(i - 1);
+    int fj = (multi_d)? 2*(j - 1) : j;
+    int fk = (three_d)? 2*(k - 1) : k;
+    ProlongFCSharedX2Face(0,k,j,i,fk,fj,fi,three_d,cb.x2f,fb.x2f);
+  });
+  par_for("rmsh-prolfc3", DevExeSpace(), il[2], iu[2]+1, il[1], iu[1], il[0], iu[0],
+  KOKKOS_LAMBDA(const int k, const int j, const int i) {
+    int fi = 2*(i - 1);
+    int fj = (multi_d)? 2*(j - 1) : j;
+    int fk = (three_d)? 2*(k - 1) : k;
+    ProlongFCSharedX3Face(0,k,j,i,fk,fj,fi,multi_d,cb.x3f,fb.x3f);
+  });
+  return f;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ProlongFCInternalPatch()
+//! \brief second step of divergence-preserving prolongation: sets field on faces internal
+//! to each coarse cell from the field on its (fine) shared faces
+
+void ProlongFCInternalPatch(FCPatch &f, const RemeshGrid &g) {
+  int nc[3];
+  for (int d=0; d<3; ++d) {
+    nc[d] = (g.active[d])? f.n[d]/2 : 1;
+  }
+  auto fb = f.b;
+  bool multi_d = g.multi_d, three_d = g.three_d;
+  par_for("rmsh-prolfc-int", DevExeSpace(), 0, nc[2]-1, 0, nc[1]-1, 0, nc[0]-1,
+  KOKKOS_LAMBDA(const int k, const int j, const int i) {
+    int fi = 2*i;
+    int fj = (multi_d)? 2*j : j;
+    int fk = (three_d)? 2*k : k;
+    if (!(multi_d)) {
+      fb.x1f(0,fk,fj,fi+1) = 0.5*(fb.x1f(0,fk,fj,fi) + fb.x1f(0,fk,fj,fi+2));
+    } else {
+      ProlongFCInternal(0,fk,fj,fi,three_d,fb);
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CopyFineFaces()
+//! \brief replaces the field on faces of a prolongated patch that are shared with a finer
+//! MeshBlock in the restart file by the values in that MeshBlock
+
+void CopyFineFaces(FCPatch &f, const FCPatch &nb, const BlockExtent &next,
+                   const FineNeighbor &fn, const RemeshGrid &g) {
+  int il[3], iu[3], o[3];
+  for (int d=0; d<3; ++d) {
+    std::int64_t lo, hi;
+    if (d == fn.dir) {
+      lo = fn.plane;
+      hi = fn.plane + 1;
+      o[d] = static_cast<int>(f.lo[d] - fn.shift - nb.lo[d]);
+    } else {
+      lo = std::max(f.lo[d], next.lo[d]);
+      hi = std::min(f.lo[d] + ((g.active[d])? f.n[d] : 1), next.hi[d]);
+      o[d] = static_cast<int>(f.lo[d] - nb.lo[d]);
+    }
+    if (hi <= lo) return;
+    if (d == fn.dir && (lo < f.lo[d] || lo > f.lo[d] + f.n[d])) return;
+    il[d] = static_cast<int>(lo - f.lo[d]);
+    iu[d] = static_cast<int>(hi - 1 - f.lo[d]);
+  }
+  auto fb = f.b, nbb = nb.b;
+  int oi = o[0], oj = o[1], ok = o[2];
+  if (fn.dir == 0) {
+    par_for("rmsh-fine1", DevExeSpace(), il[2], iu[2], il[1], iu[1], il[0], iu[0],
+    KOKKOS_LAMBDA(const int k, const int j, const int i) {
+      fb.x1f(0,k,j,i) = nbb.x1f(0,k+ok,j+oj,i+oi);
+    });
+  } else if (fn.dir == 1) {
+    par_for("rmsh-fine2", DevExeSpace(), il[2], iu[2], il[1], iu[1], il[0], iu[0],
+    KOKKOS_LAMBDA(const int k, const int j, const int i) {
+      fb.x2f(0,k,j,i) = nbb.x2f(0,k+ok,j+oj,i+oi);
+    });
+  } else {
+    par_for("rmsh-fine3", DevExeSpace(), il[2], iu[2], il[1], iu[1], il[0], iu[0],
+    KOKKOS_LAMBDA(const int k, const int j, const int i) {
+      fb.x3f(0,k,j,i) = nbb.x3f(0,k+ok,j+oj,i+oi);
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn FindFineNeighbors()
+//! \brief lists MeshBlocks in restart file one level finer than MeshBlock n that share
+//! one of its faces, including across periodic boundaries
+
+std::vector<FineNeighbor> FindFineNeighbors(const RemeshGrid &g, int n) {
+  std::vector<FineNeighbor> list;
+  const BlockExtent &ext = g.old_ext[n];
+  int nold = static_cast<int>(g.old_ext.size());
+  for (int o=0; o<nold; ++o) {
+    const BlockExtent &next = g.old_ext[o];
+    if (next.level != ext.level + 1) continue;
+    for (int dir=0; dir<3; ++dir) {
+      if (!(g.active[dir])) continue;
+      // check MeshBlocks overlap in transverse directions
+      bool overlap = true;
+      for (int d=0; d<3; ++d) {
+        if (d != dir && g.active[d] &&
+            (next.lo[d] >= 2*ext.hi[d] || next.hi[d] <= 2*ext.lo[d])) {
+          overlap = false;
+        }
+      }
+      if (!(overlap)) continue;
+      std::int64_t ndom = Shift(g.nroot[dir], next.level);
+      for (int side=0; side<2; ++side) {
+        FineNeighbor fn;
+        fn.n = o;
+        fn.dir = dir;
+        fn.plane = (side == 0)? 2*ext.lo[dir] : 2*ext.hi[dir];
+        fn.shift = 0;
+        std::int64_t nplane = (side == 0)? next.hi[dir] : next.lo[dir];
+        if (nplane != fn.plane) {
+          if (g.periodic[dir] && side == 0 && fn.plane == 0 && nplane == ndom) {
+            fn.shift = -ndom;
+          } else if (g.periodic[dir] && side == 1 && fn.plane == ndom && nplane == 0) {
+            fn.shift = ndom;
+          } else {
+            continue;
+          }
+        }
+        list.push_back(fn);
+      }
+    }
+  }
+  return list;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<int> OverlappingBlocks()
+//! \brief lists MeshBlocks in restart file overlapping a new MeshBlock, sorted by level
+
+std::vector<int> OverlappingBlocks(const RemeshGrid &g, const BlockExtent &next) {
+  std::vector<int> list;
+  int nold = static_cast<int>(g.old_ext.size());
+  for (int o=0; o<nold; ++o) {
+    const BlockExtent &ext = g.old_ext[o];
+    int p = next.level - ext.level;
+    bool overlap = true;
+    for (int d=0; d<3; ++d) {
+      if (g.active[d] &&
+          (Shift(ext.lo[d], p) >= next.hi[d] || Shift(ext.hi[d], p) <= next.lo[d])) {
+        overlap = false;
+      }
+    }
+    if (overlap) {
+      if (p < 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "New MeshBlock coarser than MeshBlock in restart file "
+                  << "it overlaps" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      list.push_back(o);
+    }
+  }
+  std::stable_sort(list.begin(), list.end(), [&g](int a, int b) {
+    return g.old_ext[a].level < g.old_ext[b].level;
+  });
+  return list;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TargetRange()
+//! \brief range of cells [lo,hi) of new MeshBlock (at its level) covered by old
+//! MeshBlock.  Returns the ranges of data needed at each level from that of the old
+//! MeshBlock to the new one in need[level - old level].
+
+void TargetRange(const RemeshGrid &g, const BlockExtent &next, const BlockExtent &ext,
+                 std::int64_t lo[3], std::int64_t hi[3],
+                 std::vector<std::pair<std::vector<std::int64_t>,
+                                       std::vector<std::int64_t>>> &need) {
+  int p = next.level - ext.level;
+  for (int d=0; d<3; ++d) {
+    if (g.active[d]) {
+      lo[d] = std::max(next.lo[d], ext.lo[d] << p);
+      hi[d] = std::min(next.hi[d], ext.hi[d] << p);
+    } else {
+      lo[d] = 0;
+      hi[d] = 1;
+    }
+  }
+  need.resize(p + 1);
+  std::int64_t nlo[3] = {lo[0], lo[1], lo[2]};
+  std::int64_t nhi[3] = {hi[0], hi[1], hi[2]};
+  for (int s=p; s>=0; --s) {
+    need[s].first.assign(nlo, nlo + 3);
+    need[s].second.assign(nhi, nhi + 3);
+    NeededRange(g, nlo, nhi);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn RemeshCC()
+//! \brief prolongates nvar cell-centered variables stored at varoffset in restart file
+//! into array u of the new MeshBlocks on this rank
+
+void RemeshCC(IOWrapper &resfile, const RemeshGrid &g, IOWrapperSizeT varoffset,
+              int nvar, DvceArray5D<Real> &u) {
+  int nmb = static_cast<int>(g.new_ext.size());
+  for (int m=0; m<nmb; ++m) {
+    std::vector<int> olist = OverlappingBlocks(g, g.new_ext[m]);
+    for (int n : olist) {
+      std::int64_t lo[3], hi[3];
+      std::vector<std::pair<std::vector<std::int64_t>, std::vector<std::int64_t>>> need;
+      TargetRange(g, g.new_ext[m], g.old_ext[n], lo, hi, need);
+      CCPatch p = ReadCCPatch(resfile, g, n, varoffset, nvar);
+      int np = static_cast<int>(need.size()) - 1;
+      for (int s=0; s<np; ++s) {
+        p = CropCC(p, need[s].first.data(), need[s].second.data());
+        p = ProlongCCPatch(p, g);
+      }
+      // copy cells covered by old MeshBlock into new MeshBlock
+      CheckRange(p.lo, p.n, lo, hi);
+      int il[3], iu[3], o[3];
+      for (int d=0; d<3; ++d) {
+        il[d] = static_cast<int>(lo[d] - g.new_ext[m].lo[d]) + g.is[d];
+        iu[d] = static_cast<int>(hi[d] - g.new_ext[m].lo[d]) + g.is[d] - 1;
+        o[d] = static_cast<int>(g.new_ext[m].lo[d] - p.lo[d]) - g.is[d];
+      }
+      auto pa = p.a;
+      int oi = o[0], oj = o[1], ok = o[2];
+      par_for("rmsh-copycc", DevExeSpace(), 0, nvar-1, il[2], iu[2], il[1], iu[1],
+              il[0], iu[0],
+      KOKKOS_LAMBDA(const int v, const int k, const int j, const int i) {
+        u(m,v,k,j,i) = pa(0,v,k+ok,j+oj,i+oi);
+      });
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn RemeshFC()
+//! \brief prolongates face-centered field stored at varoffset in restart file into b
+
+void RemeshFC(IOWrapper &resfile, const RemeshGrid &g, IOWrapperSizeT varoffset,
+              DvceFaceFld4D<Real> &b) {
+  int nmb = static_cast<int>(g.new_ext.size());
+  for (int m=0; m<nmb; ++m) {
+    std::vector<int> olist = OverlappingBlocks(g, g.new_ext[m]);
+    for (int n : olist) {
+      std::int64_t lo[3], hi[3];
+      std::vector<std::pair<std::vector<std::int64_t>, std::vector<std::int64_t>>> need;
+      TargetRange(g, g.new_ext[m], g.old_ext[n], lo, hi, need);
+      FCPatch p = ReadFCPatch(resfile, g, n, varoffset);
+      int np = static_cast<int>(need.size()) - 1;
+      std::vector<FineNeighbor> fine;
+      if (np > 0) {fine = FindFineNeighbors(g, n);}
+      for (int s=0; s<np; ++s) {
+        p = CropFC(p, need[s].first.data(), need[s].second.data());
+        p = ProlongFCSharedPatch(p, g);
+        // on first level use field on faces shared with finer MeshBlocks
+        if (s == 0) {
+          for (auto &fn : fine) {
+            FCPatch nb = ReadFCPatch(resfile, g, fn.n, varoffset);
+            CopyFineFaces(p, nb, g.old_ext[fn.n], fn, g);
+          }
+        }
+        ProlongFCInternalPatch(p, g);
+      }
+      // copy faces of cells covered by old MeshBlock into new MeshBlock
+      CheckRange(p.lo, p.n, lo, hi);
+      int il[3], iu[3], o[3];
+      for (int d=0; d<3; ++d) {
+        il[d] = static_cast<int>(lo[d] - g.new_ext[m].lo[d]) + g.is[d];
+        iu[d] = static_cast<int>(hi[d] - g.new_ext[m].lo[d]) + g.is[d] - 1;
+        o[d] = static_cast<int>(g.new_ext[m].lo[d] - p.lo[d]) - g.is[d];
+      }
+      auto pb = p.b;
+      int oi = o[0], oj = o[1], ok = o[2];
+      par_for("rmsh-copyfc1", DevExeSpace(), il[2], iu[2], il[1], iu[1], il[0], iu[0]+1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        b.x1f(m,k,j,i) = pb.x1f(0,k+ok,j+oj,i+oi);
+      });
+      par_for("rmsh-copyfc2", DevExeSpace(), il[2], iu[2], il[1], iu[1]+1, il[0], iu[0],
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        b.x2f(m,k,j,i) = pb.x2f(0,k+ok,j+oj,i+oi);
+      });
+      par_for("rmsh-copyfc3", DevExeSpace(), il[2], iu[2]+1, il[1], iu[1], il[0], iu[0],
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        b.x3f(m,k,j,i) = pb.x3f(0,k+ok,j+oj,i+oi);
+      });
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real ConservationError()
+//! \brief Returns maximum change in the volume-integrated total of any of nvar conserved
+//! variables stored at varoffset, relative to the integral of their absolute values.
+//! Totals over the MeshBlocks in the restart file are divided between ranks.
+
+Real ConservationError(IOWrapper &resfile, const RemeshGrid &g, MeshBlockPack *pmbp,
+                       IOWrapperSizeT varoffset, int nvar, const DvceArray5D<Real> &u) {
+  std::vector<Real> tot(3*nvar, 0.0);  // old total, old absolute total, new total
+  int nold = static_cast<int>(g.old_ext.size());
+  for (int n=global_variable::my_rank; n<nold; n+=global_variable::nranks) {
+    CCPatch p = ReadCCPatch(resfile, g, n, varoffset, nvar);
+    auto h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), p.a);
+    Real vol = 1.0;
+    for (int d=0; d<3; ++d) {
+      if (g.active[d]) {
+        vol *= g.len[d]/static_cast<Real>(Shift(g.nroot[d], g.old_ext[n].level));
+      } else {
+        vol *= g.len[d];
+      }
+    }
+    int ks = (g.three_d)? g.ng : 0, ke = ks + g.nbo[2] - 1;
+    int js = (g.multi_d)? g.ng : 0, je = js + g.nbo[1] - 1;
+    int is = g.ng, ie = is + g.nbo[0] - 1;
+    for (int v=0; v<nvar; ++v) {
+      for (int k=ks; k<=ke; ++k) {
+        for (int j=js; j<=je; ++j) {
+          for (int i=is; i<=ie; ++i) {
+            tot[v] += vol*h(0,v,k,j,i);
+            tot[nvar+v] += vol*std::abs(h(0,v,k,j,i));
+          }
+        }
+      }
+    }
+  }
+
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pmbp->pmb->mb_size;
+  for (int v=0; v<nvar; ++v) {
+    Real sum = 0.0;
+    Kokkos::parallel_reduce("rmsh-sum",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &sum_u) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+      sum_u += vol*u(m,v,k,j,i);
+    }, Kokkos::Sum<Real>(sum));
+    tot[2*nvar+v] = sum;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, tot.data(), 3*nvar, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+#endif
+  Real err = 0.0;
+  for (int v=0; v<nvar; ++v) {
+    if (tot[nvar+v] > 0.0) {
+      err = std::max(err, std::abs(tot[2*nvar+v] - tot[v])/tot[nvar+v]);
+    }
+  }
+  return err;
+}
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::RemeshRestartData()
+//! \brief Sets the data in the new MeshBlocks on this rank from the MeshBlocks stored in
+//! the restart file, when the restart has been remeshed in RemeshTree().  The order of
+//! the variables in the data of each MeshBlock must be the same as in restart.cpp.  Also
+//! checks that total of conserved fluid variables is unchanged, and that the magnetic
+//! field is divergence-free.
+
+void Mesh::RemeshRestartData(IOWrapper &resfile, IOWrapperSizeT headeroffset,
+                             IOWrapperSizeT data_size) {
+  RestartMeshData &old = *prst_mesh;
+  RemeshGrid g;
+  g.active[0] = true;
+  g.active[1] = multi_d;
+  g.active[2] = three_d;
+  g.periodic[0] = (mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::periodic);
+  g.periodic[1] = (mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic);
+  g.periodic[2] = (mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic);
+  g.multi_d = multi_d;
+  g.three_d = three_d;
+  g.ng = old.mb_indcs.ng;
+  int nbo[3] = {old.mb_indcs.nx1, old.mb_indcs.nx2, old.mb_indcs.nx3};
+  int nbn[3] = {mb_indcs.nx1, mb_indcs.nx2, mb_indcs.nx3};
+  g.nroot[0] = mesh_indcs.nx1;
+  g.nroot[1] = mesh_indcs.nx2;
+  g.nroot[2] = mesh_indcs.nx3;
+  g.len[0] = mesh_size.x1max - mesh_size.x1min;
+  g.len[1] = mesh_size.x2max - mesh_size.x2min;
+  g.len[2] = mesh_size.x3max - mesh_size.x3min;
+  for (int d=0; d<3; ++d) {
+    g.nbo[d] = nbo[d];
+    g.nout[d] = (g.active[d])? (nbo[d] + 2*g.ng) : 1;
+    g.is[d] = (g.active[d])? mb_indcs.ng : 0;
+  }
+  g.headeroffset = headeroffset;
+  g.data_size = data_size;
+  g.old_ext.resize(old.nmb_total);
+  for (int n=0; n<old.nmb_total; ++n) {
+    const LogicalLocation &lloc = old.lloc_eachmb[n];
+    std::int64_t lx[3] = {lloc.lx1, lloc.lx2, lloc.lx3};
+    g.old_ext[n].level = lloc.level - old.root_level - old.nlevels;
+    for (int d=0; d<3; ++d) {
+      g.old_ext[n].lo[d] = (g.active[d])? lx[d]*nbo[d] : 0;
+      g.old_ext[n].hi[d] = (g.active[d])? (lx[d] + 1)*nbo[d] : 1;
+    }
+  }
+  // extents of new MeshBlocks on this rank
+  int nmb = pmb_pack->nmb_thispack;
+  int gids = pmb_pack->gids;
+  g.new_ext.resize(nmb);
+  for (int m=0; m<nmb; ++m) {
+    const LogicalLocation &lloc = lloc_eachmb[gids + m];
+    std::int64_t lx[3] = {lloc.lx1, lloc.lx2, lloc.lx3};
+    g.new_ext[m].level = lloc.level - root_level;
+    for (int d=0; d<3; ++d) {
+      g.new_ext[m].lo[d] = (g.active[d])? lx[d]*nbn[d] : 0;
+      g.new_ext[m].hi[d] = (g.active[d])? (lx[d] + 1)*nbn[d] : 1;
+    }
+  }
+
+  // Read and prolongate data in the order it is written in restart.cpp
+  int ncells = g.nout[0]*g.nout[1]*g.nout[2];
+  IOWrapperSizeT offset = 0;
+  Real cons_err = -1.0, divb_err = -1.0;
+  hydro::Hydro* phydro = pmb_pack->phydro;
+  mhd::MHD* pmhd = pmb_pack->pmhd;
+  radiation::Radiation* prad = pmb_pack->prad;
+  m1::M1* pm1 = pmb_pack->pm1;
+  TurbulenceDriver* pturb = pmb_pack->pturb;
+  z4c::Z4c* pz4c = pmb_pack->pz4c;
+  adm::ADM* padm = pmb_pack->padm;
+  if (phydro != nullptr) {
+    int nvar = phydro->nhydro + phydro->nscalars;
+    RemeshCC(resfile, g, offset, nvar, phydro->u0);
+    cons_err = ConservationError(resfile, g, pmb_pack, offset, nvar, phydro->u0);
+    offset += ncells*nvar*sizeof(Real);
+  }
+  if (pmhd != nullptr) {
+    int nvar = pmhd->nmhd + pmhd->nscalars;
+    RemeshCC(resfile, g, offset, nvar, pmhd->u0);
+    cons_err = std::max(cons_err,
+                        ConservationError(resfile, g, pmb_pack, offset, nvar, pmhd->u0));
+    offset += ncells*nvar*sizeof(Real);
+    RemeshFC(resfile, g, offset, pmhd->b0);
+    offset += (g.nout[0]+1)*g.nout[1]*g.nout[2]*sizeof(Real);
+    offset += g.nout[0]*(g.nout[1]+1)*g.nout[2]*sizeof(Real);
+    offset += g.nout[0]*g.nout[1]*(g.nout[2]+1)*sizeof(Real);
+
+    // maximum of |div(B)| dx/|B| over new MeshBlocks
+    auto &indcs = mb_indcs;
+    int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+    int is = indcs.is, js = indcs.js, ks = indcs.ks;
+    const int nmkji = nmb*nx3*nx2*nx1;
+    const int nkji = nx3*nx2*nx1;
+    const int nji  = nx2*nx1;
+    auto &size = pmb_pack->pmb->mb_size;
+    auto &b0 = pmhd->b0;
+    bool multi_d_ = multi_d, three_d_ = three_d;
+    Real divb = 0.0, bmax = 0.0;
+    Kokkos::parallel_reduce("rmsh-divb",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &max_divb) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      Real dx = size.d_view(m).dx1;
+      Real div = (b0.x1f(m,k,j,i+1) - b0.x1f(m,k,j,i))/size.d_view(m).dx1;
+      if (multi_d_) {
+        div += (b0.x2f(m,k,j+1,i) - b0.x2f(m,k,j,i))/size.d_view(m).dx2;
+        dx = fmin(dx, size.d_view(m).dx2);
+      }
+      if (three_d_) {
+        div += (b0.x3f(m,k+1,j,i) - b0.x3f(m,k,j,i))/size.d_view(m).dx3;
+        dx = fmin(dx, size.d_view(m).dx3);
+      }
+      max_divb = fmax(max_divb, fabs(div)*dx);
+    }, Kokkos::Max<Real>(divb));
+    Kokkos::parallel_reduce("rmsh-bmax",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &max_b) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      max_b = fmax(max_b, fabs(b0.x1f(m,k,j,i)));
+      max_b = fmax(max_b, fabs(b0.x2f(m,k,j,i)));
+      max_b = fmax(max_b, fabs(b0.x3f(m,k,j,i)));
+    }, Kokkos::Max<Real>(bmax));
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &divb, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &bmax, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    divb_err = (bmax > 0.0)? divb/bmax : 0.0;
+  }
+  if (prad != nullptr) {
+    RemeshCC(resfile, g, offset, prad->nfrang, prad->i0);
+    offset += ncells*(prad->nfrang)*sizeof(Real);
+  }
+  if (pm1 != nullptr) {
+    int nvar = (pm1->nspecies)*(pm1->nvars);
+    RemeshCC(resfile, g, offset, nvar, pm1->u0);
+    offset += ncells*nvar*sizeof(Real);
+  }
+  if (pturb != nullptr) {
+    RemeshCC(resfile, g, offset, 3, pturb->force);
+    offset += ncells*3*sizeof(Real);
+  }
+  if (pz4c != nullptr) {
+    RemeshCC(resfile, g, offset, pz4c->nz4c, pz4c->u0);
+    offset += ncells*(pz4c->nz4c)*sizeof(Real);
+    pz4c->Z4cToADM(pmb_pack);
+  } else if (padm != nullptr) {
+    RemeshCC(resfile, g, offset, padm->nadm, padm->u_adm);
+    offset += ncells*(padm->nadm)*sizeof(Real);
+  }
+
+  // errors are reduced over all ranks, so every rank stops if tolerance is exceeded
+  Real tol = prst_mesh->tolerance;
+  if (global_variable::my_rank == 0) {
+    if (cons_err >= 0.0) {
+      std::cout << "Remeshed restart: max relative change in conserved totals = "
+                << cons_err << std::endl;
+    }
+    if (divb_err >= 0.0) {
+      std::cout << "Remeshed restart: max |div(B)| dx/|B| = " << divb_err << std::endl;
+    }
+  }
+  if (cons_err > tol || divb_err > tol) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Conserved variables changed or magnetic field not "
+                << "divergence-free after remeshing restart, errors exceed "
+                << "<mesh>/remesh_tolerance=" << tol << std::endl;
+    }
+    std::exit(EXIT_FAILURE);
+  }
+  return;
+}
@@ -20,6 +20,8 @@
 #include "srcterms/srcterms.hpp"
 #include "shearing_box/shearing_box.hpp"
 #include "bvals/bvals.hpp"
+#include "utils/memory_usage.hpp"
+#include "utils/first_touch.hpp"
 #include "mhd/mhd.hpp"
 
 namespace mhd {
@@ -99,7 +101,9 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
   }
 
   // Resistivity (only constructed if needed)
-  if (pin->DoesParameterExist("mhd","ohmic_resistivity")) {
+  if (pin->DoesParameterExist("mhd","ohmic_resistivity") ||
+      pin->DoesParameterExist("mhd","hall_coeff") ||
+      pin->DoesParameterExist("mhd","ambipolar_coeff")) {
     presist = new Resistivity(ppack, pin);
   } else {
     presist = nullptr;
@@ -128,14 +132,14 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(u0,   nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
-    Kokkos::realloc(w0,   nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
+    ReallocFirstTouch(u0,   nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
+    ReallocFirstTouch(w0,   nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
 
     // allocate memory for face-centered and cell-centered magnetic fields
-    Kokkos::realloc(bcc0,   nmb, 3, ncells3, ncells2, ncells1);
-    Kokkos::realloc(b0.x1f, nmb, ncells3, ncells2, ncells1+1);
-    Kokkos::realloc(b0.x2f, nmb, ncells3, ncells2+1, ncells1);
-    Kokkos::realloc(b0.x3f, nmb, ncells3+1, ncells2, ncells1);
+    ReallocFirstTouch(bcc0,   nmb, 3, ncells3, ncells2, ncells1);
+    ReallocFirstTouch(b0.x1f, nmb, ncells3, ncells2, ncells1+1);
+    ReallocFirstTouch(b0.x2f, nmb, ncells3, ncells2+1, ncells1);
+    ReallocFirstTouch(b0.x3f, nmb, ncells3+1, ncells2, ncells1);
   }
 
   // allocate memory for conserved variables on coarse mesh
@@ -152,10 +156,19 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
   }
 
   // allocate boundary buffers for conserved (cell-centered) and face-centered variables
+  int nghost = MeshBoundaryValues::GhostDepth(ppack, pin, "mhd");
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
-  pbval_u->InitializeBuffers((nmhd+nscalars));
+  pbval_u->InitializeBuffers((nmhd+nscalars), nghost);
   pbval_b = new MeshBoundaryValuesFC(ppack, pin);
-  pbval_b->InitializeBuffers(3);
+  pbval_b->InitializeBuffers(3, nghost);
+
+  // register arrays and boundary buffers for memory accounting
+  memory_usage::TrackArrays("MHD", u0, w0, b0, bcc0, coarse_u0, coarse_w0, coarse_b0,
+                            u1, b1, uflx, efld, e3x1, e2x1, e1x2, e3x2, e2x3, e1x3,
+                            e1_cc, e2_cc, e3_cc, wsaved, bccsaved, fofc, utest, bcctest);
+  memory_usage::Track("MHD", [this]() {
+    return pbval_u->MemoryUsage() + pbval_b->MemoryUsage();
+  });
 
   // Orbital advection and shearing box BCs (if requested in input file)
   if (pin->DoesBlockExist("shearing_box")) {
@@ -181,30 +194,35 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       recon_method = ReconstructionMethod::dc;
     } else if (xorder.compare("plm") == 0) {
       recon_method = ReconstructionMethod::plm;
+      // check that nghost > 1
+      if (nghost < 2) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << xorder << " reconstruction requires at least 2 ghost zones, "
+          << "but <mhd>/nghost=" << nghost << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
       // check that nghost > 2 with PLM+FOFC
-      auto &indcs = pmy_pack->pmesh->mb_indcs;
-      if (use_fofc && indcs.ng < 3) {
+      if (use_fofc && nghost < 3) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "FOFC and " << xorder << " reconstruction requires at "
-          << "least 3 ghost zones, but <mesh>/nghost=" << indcs.ng << std::endl;
+          << "least 3 ghost zones, but <mhd>/nghost=" << nghost << std::endl;
         std::exit(EXIT_FAILURE);
       }
     } else if (xorder.compare("ppm4") == 0 ||
                xorder.compare("ppmx") == 0 ||
                xorder.compare("wenoz") == 0) {
       // check that nghost > 2
-      auto &indcs = pmy_pack->pmesh->mb_indcs;
-      if (indcs.ng < 3) {
+      if (nghost < 3) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << xorder << " reconstruction requires at least 3 ghost zones, "
-          << "but <mesh>/nghost=" << indcs.ng << std::endl;
+          << "but <mhd>/nghost=" << nghost << std::endl;
         std::exit(EXIT_FAILURE);
       }
       // check that nghost > 3 with PPM4(or PPMX or WENOZ)+FOFC
-      if (use_fofc && indcs.ng < 4) {
+      if (use_fofc && nghost < 4) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "FOFC and " << xorder << " reconstruction requires at "
-          << "least 4 ghost zones, but <mesh>/nghost=" << indcs.ng << std::endl;
+          << "least 4 ghost zones, but <mhd>/nghost=" << nghost << std::endl;
         std::exit(EXIT_FAILURE);
       }
       if (xorder.compare("ppm4") == 0) {
@@ -304,18 +322,18 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       int ncells1 = indcs.nx1 + 2*(indcs.ng);
       int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
       int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-      Kokkos::realloc(u1,     nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
-      Kokkos::realloc(b1.x1f, nmb, ncells3, ncells2, ncells1+1);
-      Kokkos::realloc(b1.x2f, nmb, ncells3, ncells2+1, ncells1);
-      Kokkos::realloc(b1.x3f, nmb, ncells3+1, ncells2, ncells1);
+      ReallocFirstTouch(u1,     nmb, (nmhd+nscalars), ncells3, ncells2, ncells1);
+      ReallocFirstTouch(b1.x1f, nmb, ncells3, ncells2, ncells1+1);
+      ReallocFirstTouch(b1.x2f, nmb, ncells3, ncells2+1, ncells1);
+      ReallocFirstTouch(b1.x3f, nmb, ncells3+1, ncells2, ncells1);
 
       // allocate fluxes, electric fields
-      Kokkos::realloc(uflx.x1f, nmb, (nmhd+nscalars), ncells3, ncells2, ncells1+1);
-      Kokkos::realloc(uflx.x2f, nmb, (nmhd+nscalars), ncells3, ncells2+1, ncells1);
-      Kokkos::realloc(uflx.x3f, nmb, (nmhd+nscalars), ncells3+1, ncells2, ncells1);
-      Kokkos::realloc(efld.x1e, nmb, ncells3+1, ncells2+1, ncells1);
-      Kokkos::realloc(efld.x2e, nmb, ncells3+1, ncells2, ncells1+1);
-      Kokkos::realloc(efld.x3e, nmb, ncells3, ncells2+1, ncells1+1);
+      ReallocFirstTouch(uflx.x1f, nmb, (nmhd+nscalars), ncells3, ncells2, ncells1+1);
+      ReallocFirstTouch(uflx.x2f, nmb, (nmhd+nscalars), ncells3, ncells2+1, ncells1);
+      ReallocFirstTouch(uflx.x3f, nmb, (nmhd+nscalars), ncells3+1, ncells2, ncells1);
+      ReallocFirstTouch(efld.x1e, nmb, ncells3+1, ncells2+1, ncells1);
+      ReallocFirstTouch(efld.x2e, nmb, ncells3+1, ncells2, ncells1+1);
+      ReallocFirstTouch(efld.x3e, nmb, ncells3, ncells2+1, ncells1+1);
 
       // allocate scratch arrays for face- and cell-centered E used in CornerE
       Kokkos::realloc(e3x1, nmb, ncells3, ncells2, ncells1);
@@ -46,6 +46,9 @@ enum class MHD_RSolver {advect, llf, hlle, hlld, roe,   // non-relativistic
 
 struct MHDTaskIDs {
   TaskID savest;
+  TaskID cond_sts;
+  TaskID ambi_sts;
+  TaskID ambi_sts2;
   TaskID irecv;
   TaskID copyu;
   TaskID flux;
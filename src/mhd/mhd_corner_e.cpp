@@ -419,7 +419,11 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
     if (presist->eta_ohm > 0.0) {
       presist->OhmicEField(b0, efld);
     }
-    // TODO(@user): Add more resistive effects here
+    // Hall and ambipolar E-field computed in Fluxes() (ambipolar unless operator split)
+    if ((presist->q_hall != 0.0) ||
+        ((presist->q_ambi > 0.0) && !(presist->ambi_sts))) {
+      presist->AddNonIdealEField(efld);
+    }
   }
 
   return TaskStatus::complete;
@@ -17,6 +17,7 @@
 #include "driver/driver.hpp"
 #include "eos/eos.hpp"
 #include "mhd.hpp"
+#include "diffusion/resistivity.hpp"
 #include "diffusion/conduction.hpp"
 #include "srcterms/srcterms.hpp"
 
@@ -162,6 +163,9 @@ TaskStatus MHD::NewTimeStep(Driver *pdriver, int stage) {
   if (pcond != nullptr) {
     pcond->NewTimeStep(w0, peos->eos_data);
   }
+  if (presist != nullptr) {
+    presist->NewTimeStep(w0, bcc0);
+  }
   // compute source terms timestep
   psrc->NewTimeStep(w0, peos->eos_data);
 
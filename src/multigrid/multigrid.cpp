@@ -0,0 +1,782 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file multigrid.cpp
+//  \brief implementation of MultigridSolver class
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals/bvals.hpp"
+#include "utils/memory_usage.hpp"
+#include "multigrid.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void InterpIndex()
+//! \brief Given position x in units of cell spacing, with cell centers at integer values,
+//! returns index of cell center to the left of x and linear interpolation weight of the
+//! cell to the right.
+
+KOKKOS_INLINE_FUNCTION
+void InterpIndex(const Real x, int &i0, Real &w) {
+  Real f = floor(x);
+  i0 = static_cast<int>(f);
+  w = x - f;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// constructor, initializes data structures and parameters
+
+MultigridSolver::MultigridSolver(MeshBlockPack *ppack, ParameterInput *pin,
+                                 const std::string &block, const std::string &module) :
+    u("mg_u",1,1,1,1,1),
+    coarse_u("mg_cu",1,1,1,1,1),
+    src("mg_src",1,1,1,1,1),
+    ncycles(0),
+    residual(0.0),
+    pmy_pack(ppack),
+    block_avg_("mg_bavg",1),
+    root_corr_("mg_root",1,1,1) {
+  tolerance  = pin->GetOrAddReal(block, "mg_tolerance", 1.0e-8);
+  max_cycles = pin->GetOrAddInteger(block, "mg_max_cycles", 50);
+  npre       = pin->GetOrAddInteger(block, "mg_npre", 2);
+  npost      = pin->GetOrAddInteger(block, "mg_npost", 2);
+  nsmooth    = pin->GetOrAddInteger(block, "mg_nsmooth", 2);
+
+  Mesh *pm = ppack->pmesh;
+  int nmb = std::max((ppack->nmb_thispack), (pm->nmb_maxperrank));
+  auto &indcs = pm->mb_indcs;
+  {
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(u, nmb, 1, ncells3, ncells2, ncells1);
+    Kokkos::realloc(src, nmb, 1, ncells3, ncells2, ncells1);
+  }
+  if (pm->multilevel) {
+    int n_ccells1 = indcs.cnx1 + 2*(indcs.ng);
+    int n_ccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
+    int n_ccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(coarse_u, nmb, 1, n_ccells3, n_ccells2, n_ccells1);
+  }
+  pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
+  pbval_u->InitializeBuffers(1);
+
+  // levels inside MeshBlocks, coarsened by factors of two as long as number of cells in
+  // every direction is even.  Arrays on each level have one ghost cell (in multi-D only
+  // in active directions).
+  int n1 = indcs.nx1, n2 = indcs.nx2, n3 = indcs.nx3;
+  nlevels = 1;
+  nx1_.push_back(n1); nx2_.push_back(n2); nx3_.push_back(n3);
+  while ((n1%2 == 0) && (!(pm->multi_d) || (n2%2 == 0)) &&
+         (!(pm->three_d) || (n3%2 == 0))) {
+    n1 /= 2;
+    if (pm->multi_d) {n2 /= 2;}
+    if (pm->three_d) {n3 /= 2;}
+    nx1_.push_back(n1); nx2_.push_back(n2); nx3_.push_back(n3);
+    nlevels++;
+  }
+  int g2 = (pm->multi_d)? 1 : 0;
+  int g3 = (pm->three_d)? 1 : 0;
+  for (int l=0; l<nlevels; ++l) {
+    rhs_.emplace_back("mg_rhs", nmb, nx3_[l]+2*g3, nx2_[l]+2*g2, nx1_[l]+2);
+    if (l == 0) {
+      corr_.emplace_back("mg_corr", 1, 1, 1, 1);
+    } else {
+      corr_.emplace_back("mg_corr", nmb, nx3_[l]+2*g3, nx2_[l]+2*g2, nx1_[l]+2);
+    }
+  }
+  Kokkos::realloc(block_avg_, nmb);
+
+  // root grid
+  nroot1_ = pm->nmb_rootx1;
+  nroot2_ = pm->nmb_rootx2;
+  nroot3_ = pm->nmb_rootx3;
+  periodic_[0] = (pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::periodic);
+  periodic_[1] = (pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic);
+  periodic_[2] = (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic);
+  int nroot = nroot1_*nroot2_*nroot3_;
+  root_rhs_.assign(nroot, 0.0);
+  root_x_.assign(nroot, 0.0);
+  root_r_.assign(nroot, 0.0);
+  root_p_.assign(nroot, 0.0);
+  root_q_.assign(nroot, 0.0);
+  Kokkos::realloc(root_corr_, nroot3_+2*g3, nroot2_+2*g2, nroot1_+2);
+
+  // register arrays and boundary buffers for memory accounting
+  memory_usage::TrackArrays(module, u, coarse_u, src, block_avg_, root_corr_);
+  memory_usage::Track(module, [this]() {
+    std::size_t nbytes = pbval_u->MemoryUsage();
+    for (auto &a : rhs_) {nbytes += memory_usage::Bytes(a);}
+    for (auto &a : corr_) {nbytes += memory_usage::Bytes(a);}
+    return nbytes;
+  });
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+
+MultigridSolver::~MultigridSolver() {
+  delete pbval_u;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::Solve()
+//! \brief Iterates V-cycles until the L2 norm of the residual divided by the L2 norm of
+//! the source is below the tolerance.  The current contents of u are used as the initial
+//! guess.  Must be called by all ranks.
+
+void MultigridSolver::Solve() {
+  // L2 norm of source
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &src_ = src;
+  Real srcnorm = 0.0;
+  Kokkos::parallel_reduce("mg_srcnorm",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    sum += vol*SQR(src_(m,0,k,j,i));
+  }, Kokkos::Sum<Real>(srcnorm));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &srcnorm, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  srcnorm = std::sqrt(srcnorm);
+  if (srcnorm == 0.0) {srcnorm = 1.0;}
+
+  FillGhosts(u);
+  for (ncycles=0; ncycles<max_cycles; ++ncycles) {
+    residual = Residual()/srcnorm;
+    if (residual <= tolerance) break;
+    VCycle();
+  }
+  if (ncycles == max_cycles) {
+    residual = Residual()/srcnorm;
+    if (global_variable::my_rank == 0 && residual > tolerance) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Multigrid did not converge in " << max_cycles << " V-cycles, "
+                << "relative residual = " << residual << std::endl;
+    }
+  }
+
+  // with periodic boundaries solution is determined up to a constant
+  if (pmy_pack->pmesh->strictly_periodic) {
+    SubtractMean();
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::VCycle()
+//! \brief Performs one V-cycle.  On entry and exit ghost cells of u are up to date.
+
+void MultigridSolver::VCycle() {
+  for (int n=0; n<npre; ++n) {
+    Smooth(0);
+    FillGhosts(u);
+    Smooth(1);
+    FillGhosts(u);
+  }
+  (void) Residual();
+  for (int l=0; l<nlevels-1; ++l) {
+    Restrict(l);
+  }
+  SolveRoot();
+  if (nlevels > 1) {
+    RootToCoarse();
+    for (int l=nlevels-1; l>0; --l) {
+      if (l < nlevels-1) {ProlongateCoarse(l);}
+      for (int n=0; n<nsmooth; ++n) {
+        SmoothCoarse(l, 0);
+        SmoothCoarse(l, 1);
+      }
+    }
+  }
+  AddCorrection();
+  FillGhosts(u);
+  for (int n=0; n<npost; ++n) {
+    Smooth(0);
+    FillGhosts(u);
+    Smooth(1);
+    FillGhosts(u);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::FillGhosts()
+//! \brief Sets ghost cells of array on finest level (same layout as u) by exchanging
+//! data between MeshBlocks, restricting/prolongating at fine/coarse boundaries, and
+//! calling physical_bcs at non-periodic faces of the Mesh.  Must be called by all ranks.
+
+void MultigridSolver::FillGhosts(DvceArray5D<Real> &a) {
+  Mesh *pm = pmy_pack->pmesh;
+  if (pm->multilevel) {
+    pm->pmr->RestrictCC(a, coarse_u);
+  }
+  // Note: with MPI, sends on ALL MBs must be complete before receives execute
+  (void) pbval_u->InitRecv(1);
+  (void) pbval_u->PackAndSendCC(a, coarse_u);
+  (void) pbval_u->ClearSend();
+  (void) pbval_u->ClearRecv();
+  (void) pbval_u->RecvAndUnpackCC(a, coarse_u);
+  if (!(pm->strictly_periodic) && physical_bcs != nullptr) {
+    physical_bcs(a);
+  }
+  if (pm->multilevel) {
+    pbval_u->FillCoarseInBndryCC(a, coarse_u);
+    pbval_u->ProlongateCC(a, coarse_u);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::Smooth()
+//! \brief Red-black Gauss-Seidel half-sweep on finest level, updating cells with
+//! (i+j+k)%2 == color
+
+void MultigridSolver::Smooth(int color) {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &u_ = u;
+  auto &src_ = src;
+  par_for("mg_smooth", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    if (((i - is) + (j - js) + (k - ks))%2 != color) return;
+    Real a1 = 1.0/SQR(size.d_view(m).dx1);
+    Real a2 = (multi_d)? 1.0/SQR(size.d_view(m).dx2) : 0.0;
+    Real a3 = (three_d)? 1.0/SQR(size.d_view(m).dx3) : 0.0;
+    Real sum = a1*(u_(m,0,k,j,i-1) + u_(m,0,k,j,i+1));
+    if (multi_d) {sum += a2*(u_(m,0,k,j-1,i) + u_(m,0,k,j+1,i));}
+    if (three_d) {sum += a3*(u_(m,0,k-1,j,i) + u_(m,0,k+1,j,i));}
+    u_(m,0,k,j,i) = (sum - src_(m,0,k,j,i))/(2.0*(a1 + a2 + a3));
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::SmoothCoarse()
+//! \brief Red-black Gauss-Seidel half-sweep for correction on level l>0 inside
+//! MeshBlocks, with ghost cells held fixed
+
+void MultigridSolver::SmoothCoarse(int l, int color) {
+  Mesh *pm = pmy_pack->pmesh;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int jl = (multi_d)? 1 : 0, ju = (multi_d)? nx2_[l] : 0;
+  int kl = (three_d)? 1 : 0, ku = (three_d)? nx3_[l] : 0;
+  Real fac = static_cast<Real>(1 << l);
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &e = corr_[l];
+  auto &f = rhs_[l];
+  par_for("mg_smooth_c", DevExeSpace(), 0, nmb1, kl, ku, jl, ju, 1, nx1_[l],
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    if ((i + j + k)%2 != color) return;
+    Real a1 = 1.0/SQR(fac*size.d_view(m).dx1);
+    Real a2 = (multi_d)? 1.0/SQR(fac*size.d_view(m).dx2) : 0.0;
+    Real a3 = (three_d)? 1.0/SQR(fac*size.d_view(m).dx3) : 0.0;
+    Real sum = a1*(e(m,k,j,i-1) + e(m,k,j,i+1));
+    if (multi_d) {sum += a2*(e(m,k,j-1,i) + e(m,k,j+1,i));}
+    if (three_d) {sum += a3*(e(m,k-1,j,i) + e(m,k+1,j,i));}
+    e(m,k,j,i) = (sum - f(m,k,j,i))/(2.0*(a1 + a2 + a3));
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real MultigridSolver::Residual()
+//! \brief Computes residual f - Lap(u) on finest level and stores it in rhs_[0].  Returns
+//! L2 norm of residual over the whole Mesh.  Must be called by all ranks.
+
+Real MultigridSolver::Residual() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int g2 = (multi_d)? 1 : 0;
+  int g3 = (three_d)? 1 : 0;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &u_ = u;
+  auto &src_ = src;
+  auto &r = rhs_[0];
+  Real norm = 0.0;
+  Kokkos::parallel_reduce("mg_resid",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1);
+    int ii = i + is, jj = j + js, kk = k + ks;
+    Real lap = (u_(m,0,kk,jj,ii-1) - 2.0*u_(m,0,kk,jj,ii) + u_(m,0,kk,jj,ii+1))/
+               SQR(size.d_view(m).dx1);
+    if (multi_d) {
+      lap += (u_(m,0,kk,jj-1,ii) - 2.0*u_(m,0,kk,jj,ii) + u_(m,0,kk,jj+1,ii))/
+             SQR(size.d_view(m).dx2);
+    }
+    if (three_d) {
+      lap += (u_(m,0,kk-1,jj,ii) - 2.0*u_(m,0,kk,jj,ii) + u_(m,0,kk+1,jj,ii))/
+             SQR(size.d_view(m).dx3);
+    }
+    Real res = src_(m,0,kk,jj,ii) - lap;
+    r(m,k+g3,j+g2,i+1) = res;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    sum += vol*SQR(res);
+  }, Kokkos::Sum<Real>(norm));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &norm, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  return std::sqrt(norm);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::Restrict()
+//! \brief Restricts residual from level l to level l+1 inside MeshBlocks by averaging
+
+void MultigridSolver::Restrict(int l) {
+  Mesh *pm = pmy_pack->pmesh;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int jl = (multi_d)? 1 : 0, ju = (multi_d)? nx2_[l+1] : 0;
+  int kl = (three_d)? 1 : 0, ku = (three_d)? nx3_[l+1] : 0;
+  int nj = (multi_d)? 2 : 1;
+  int nk = (three_d)? 2 : 1;
+  Real fac = 1.0/static_cast<Real>(2*nj*nk);
+  auto &rf = rhs_[l];
+  auto &rc = rhs_[l+1];
+  par_for("mg_restrict", DevExeSpace(), 0, nmb1, kl, ku, jl, ju, 1, nx1_[l+1],
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    int fi = 2*i - 1;
+    int fj = (multi_d)? 2*j - 1 : 0;
+    int fk = (three_d)? 2*k - 1 : 0;
+    Real sum = 0.0;
+    for (int dk=0; dk<nk; ++dk) {
+      for (int dj=0; dj<nj; ++dj) {
+        sum += rf(m,fk+dk,fj+dj,fi) + rf(m,fk+dk,fj+dj,fi+1);
+      }
+    }
+    rc(m,k,j,i) = fac*sum;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::ProlongateCoarse()
+//! \brief Sets correction on level l (including ghost cells) by linear interpolation of
+//! correction on level l+1
+
+void MultigridSolver::ProlongateCoarse(int l) {
+  Mesh *pm = pmy_pack->pmesh;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int nj = (multi_d)? 2 : 1;
+  int nk = (three_d)? 2 : 1;
+  int n1 = nx1_[l] + 1;
+  int n2 = (multi_d)? nx2_[l] + 1 : 0;
+  int n3 = (three_d)? nx3_[l] + 1 : 0;
+  auto &ef = corr_[l];
+  auto &ec = corr_[l+1];
+  par_for("mg_prolong_c", DevExeSpace(), 0, nmb1, 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    int i0, j0 = 0, k0 = 0;
+    Real wi, wj = 0.0, wk = 0.0;
+    InterpIndex(0.5*(i - 1) - 0.25, i0, wi);
+    i0 += 1;
+    if (multi_d) {InterpIndex(0.5*(j - 1) - 0.25, j0, wj); j0 += 1;}
+    if (three_d) {InterpIndex(0.5*(k - 1) - 0.25, k0, wk); k0 += 1;}
+    Real val = 0.0;
+    for (int dk=0; dk<nk; ++dk) {
+      Real w3 = (nk == 1)? 1.0 : ((dk == 0)? 1.0 - wk : wk);
+      for (int dj=0; dj<nj; ++dj) {
+        Real w2 = (nj == 1)? 1.0 : ((dj == 0)? 1.0 - wj : wj);
+        val += w3*w2*((1.0 - wi)*ec(m,k0+dk,j0+dj,i0) + wi*ec(m,k0+dk,j0+dj,i0+1));
+      }
+    }
+    ef(m,k,j,i) = val;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::AddCorrection()
+//! \brief Adds correction to u in active cells on finest level, interpolated from level
+//! 1 inside MeshBlocks, or from the root grid if MeshBlocks cannot be coarsened
+
+void MultigridSolver::AddCorrection() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int nj = (multi_d)? 2 : 1;
+  int nk = (three_d)? 2 : 1;
+  auto &u_ = u;
+
+  if (nlevels > 1) {
+    auto &ec = corr_[1];
+    par_for("mg_correct", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      int i0, j0 = 0, k0 = 0;
+      Real wi, wj = 0.0, wk = 0.0;
+      InterpIndex(0.5*(i - is) - 0.25, i0, wi);
+      i0 += 1;
+      if (multi_d) {InterpIndex(0.5*(j - js) - 0.25, j0, wj); j0 += 1;}
+      if (three_d) {InterpIndex(0.5*(k - ks) - 0.25, k0, wk); k0 += 1;}
+      Real val = 0.0;
+      for (int dk=0; dk<nk; ++dk) {
+        Real w3 = (nk == 1)? 1.0 : ((dk == 0)? 1.0 - wk : wk);
+        for (int dj=0; dj<nj; ++dj) {
+          Real w2 = (nj == 1)? 1.0 : ((dj == 0)? 1.0 - wj : wj);
+          val += w3*w2*((1.0 - wi)*ec(m,k0+dk,j0+dj,i0) + wi*ec(m,k0+dk,j0+dj,i0+1));
+        }
+      }
+      u_(m,0,k,j,i) += val;
+    });
+  } else {
+    auto &size = pmy_pack->pmb->mb_size;
+    auto &msize = pm->mesh_size;
+    Real rdx1 = (msize.x1max - msize.x1min)/static_cast<Real>(nroot1_);
+    Real rdx2 = (msize.x2max - msize.x2min)/static_cast<Real>(nroot2_);
+    Real rdx3 = (msize.x3max - msize.x3min)/static_cast<Real>(nroot3_);
+    auto &root = root_corr_;
+    par_for("mg_correct_r", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      int i0, j0 = 0, k0 = 0;
+      Real wi, wj = 0.0, wk = 0.0;
+      Real x = size.d_view(m).x1min + (i - is + 0.5)*size.d_view(m).dx1;
+      InterpIndex((x - msize.x1min)/rdx1 - 0.5, i0, wi);
+      i0 += 1;
+      if (multi_d) {
+        Real y = size.d_view(m).x2min + (j - js + 0.5)*size.d_view(m).dx2;
+        InterpIndex((y - msize.x2min)/rdx2 - 0.5, j0, wj);
+        j0 += 1;
+      }
+      if (three_d) {
+        Real z = size.d_view(m).x3min + (k - ks + 0.5)*size.d_view(m).dx3;
+        InterpIndex((z - msize.x3min)/rdx3 - 0.5, k0, wk);
+        k0 += 1;
+      }
+      Real val = 0.0;
+      for (int dk=0; dk<nk; ++dk) {
+        Real w3 = (nk == 1)? 1.0 : ((dk == 0)? 1.0 - wk : wk);
+        for (int dj=0; dj<nj; ++dj) {
+          Real w2 = (nj == 1)? 1.0 : ((dj == 0)? 1.0 - wj : wj);
+          val += w3*w2*((1.0 - wi)*root.d_view(k0+dk,j0+dj,i0) +
+                        wi*root.d_view(k0+dk,j0+dj,i0+1));
+        }
+      }
+      u_(m,0,k,j,i) += val;
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::RootToCoarse()
+//! \brief Sets correction on coarsest level inside MeshBlocks (including ghost cells) by
+//! linear interpolation of correction on root grid.  Works for MeshBlocks on any level.
+
+void MultigridSolver::RootToCoarse() {
+  Mesh *pm = pmy_pack->pmesh;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int nj = (multi_d)? 2 : 1;
+  int nk = (three_d)? 2 : 1;
+  int l = nlevels - 1;
+  int n1 = nx1_[l] + 1;
+  int n2 = (multi_d)? nx2_[l] + 1 : 0;
+  int n3 = (three_d)? nx3_[l] + 1 : 0;
+  Real fac = static_cast<Real>(1 << l);
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &msize = pm->mesh_size;
+  Real rdx1 = (msize.x1max - msize.x1min)/static_cast<Real>(nroot1_);
+  Real rdx2 = (msize.x2max - msize.x2min)/static_cast<Real>(nroot2_);
+  Real rdx3 = (msize.x3max - msize.x3min)/static_cast<Real>(nroot3_);
+  auto &root = root_corr_;
+  auto &e = corr_[l];
+  par_for("mg_root2c", DevExeSpace(), 0, nmb1, 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    int i0, j0 = 0, k0 = 0;
+    Real wi, wj = 0.0, wk = 0.0;
+    Real x = size.d_view(m).x1min + (i - 0.5)*fac*size.d_view(m).dx1;
+    InterpIndex((x - msize.x1min)/rdx1 - 0.5, i0, wi);
+    i0 += 1;
+    if (multi_d) {
+      Real y = size.d_view(m).x2min + (j - 0.5)*fac*size.d_view(m).dx2;
+      InterpIndex((y - msize.x2min)/rdx2 - 0.5, j0, wj);
+      j0 += 1;
+    }
+    if (three_d) {
+      Real z = size.d_view(m).x3min + (k - 0.5)*fac*size.d_view(m).dx3;
+      InterpIndex((z - msize.x3min)/rdx3 - 0.5, k0, wk);
+      k0 += 1;
+    }
+    Real val = 0.0;
+    for (int dk=0; dk<nk; ++dk) {
+      Real w3 = (nk == 1)? 1.0 : ((dk == 0)? 1.0 - wk : wk);
+      for (int dj=0; dj<nj; ++dj) {
+        Real w2 = (nj == 1)? 1.0 : ((dj == 0)? 1.0 - wj : wj);
+        val += w3*w2*((1.0 - wi)*root.d_view(k0+dk,j0+dj,i0) +
+                      wi*root.d_view(k0+dk,j0+dj,i0+1));
+      }
+    }
+    e(m,k,j,i) = val;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::SolveRoot()
+//! \brief Sums average of residual in each MeshBlock into root grid, and solves for
+//! correction on root grid with conjugate gradients on every rank.  Correction (with
+//! ghost cells) is stored in root_corr_ on device.  Must be called by all ranks.
+
+void MultigridSolver::SolveRoot() {
+  Mesh *pm = pmy_pack->pmesh;
+  int nmb = pmy_pack->nmb_thispack;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  int g2 = (multi_d)? 1 : 0;
+  int g3 = (three_d)? 1 : 0;
+
+  // average of residual on coarsest level in each MeshBlock
+  int l = nlevels - 1;
+  int n1 = nx1_[l], n2 = nx2_[l], n3 = nx3_[l];
+  Real fac = 1.0/static_cast<Real>(n1*n2*n3);
+  auto &r = rhs_[l];
+  auto &bavg = block_avg_;
+  par_for("mg_bavg", DevExeSpace(), 0, (nmb-1),
+  KOKKOS_LAMBDA(int m) {
+    Real sum = 0.0;
+    for (int k=g3; k<n3+g3; ++k) {
+      for (int j=g2; j<n2+g2; ++j) {
+        for (int i=1; i<=n1; ++i) {
+          sum += r(m,k,j,i);
+        }
+      }
+    }
+    bavg.d_view(m) = fac*sum;
+  });
+  block_avg_.template modify<DevExeSpace>();
+  block_avg_.template sync<HostMemSpace>();
+
+  // sum volume-weighted averages into root grid
+  int ndim = 1 + g2 + g3;
+  std::fill(root_rhs_.begin(), root_rhs_.end(), 0.0);
+  for (int m=0; m<nmb; ++m) {
+    int gid = pmy_pack->pmb->mb_gid.h_view(m);
+    LogicalLocation &lloc = pm->lloc_eachmb[gid];
+    int shift = lloc.level - pm->root_level;
+    int i = lloc.lx1 >> shift;
+    int j = (multi_d)? (lloc.lx2 >> shift) : 0;
+    int k = (three_d)? (lloc.lx3 >> shift) : 0;
+    Real w = std::ldexp(1.0, -ndim*shift);
+    root_rhs_[i + nroot1_*(j + nroot2_*k)] += w*block_avg_.h_view(m);
+  }
+  int nroot = nroot1_*nroot2_*nroot3_;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, root_rhs_.data(), nroot, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+#endif
+
+  // conjugate gradient solution of -Lap(x) = -rhs on root grid (operator is positive)
+  for (int n=0; n<nroot; ++n) {root_r_[n] = -root_rhs_[n];}
+  if (pm->strictly_periodic) {
+    Real mean = 0.0;
+    for (int n=0; n<nroot; ++n) {mean += root_r_[n];}
+    mean /= static_cast<Real>(nroot);
+    for (int n=0; n<nroot; ++n) {root_r_[n] -= mean;}
+  }
+  std::fill(root_x_.begin(), root_x_.end(), 0.0);
+  root_p_ = root_r_;
+  Real rr = 0.0;
+  for (int n=0; n<nroot; ++n) {rr += root_r_[n]*root_r_[n];}
+  Real rr0 = rr;
+  for (int it=0; it<10*nroot+100 && rr > 1.0e-24*rr0; ++it) {
+    ApplyRootOperator(root_p_, root_q_);
+    Real pq = 0.0;
+    for (int n=0; n<nroot; ++n) {pq += root_p_[n]*root_q_[n];}
+    if (pq <= 0.0) break;
+    Real alpha = rr/pq;
+    Real rr_new = 0.0;
+    for (int n=0; n<nroot; ++n) {
+      root_x_[n] += alpha*root_p_[n];
+      root_r_[n] -= alpha*root_q_[n];
+      rr_new += root_r_[n]*root_r_[n];
+    }
+    Real beta = rr_new/rr;
+    for (int n=0; n<nroot; ++n) {root_p_[n] = root_r_[n] + beta*root_p_[n];}
+    rr = rr_new;
+  }
+
+  // copy into array with ghost cells.  Ghost cells are periodic images, or have opposite
+  // sign so that the correction vanishes at non-periodic faces of the Mesh
+  auto &rc = root_corr_.h_view;
+  for (int k=0; k<nroot3_; ++k) {
+    for (int j=0; j<nroot2_; ++j) {
+      for (int i=0; i<nroot1_; ++i) {
+        rc(k+g3,j+g2,i+1) = root_x_[i + nroot1_*(j + nroot2_*k)];
+      }
+    }
+  }
+  for (int k=g3; k<nroot3_+g3; ++k) {
+    for (int j=g2; j<nroot2_+g2; ++j) {
+      rc(k,j,0) = (periodic_[0])? rc(k,j,nroot1_) : -rc(k,j,1);
+      rc(k,j,nroot1_+1) = (periodic_[0])? rc(k,j,1) : -rc(k,j,nroot1_);
+    }
+  }
+  if (multi_d) {
+    for (int k=g3; k<nroot3_+g3; ++k) {
+      for (int i=0; i<nroot1_+2; ++i) {
+        rc(k,0,i) = (periodic_[1])? rc(k,nroot2_,i) : -rc(k,1,i);
+        rc(k,nroot2_+1,i) = (periodic_[1])? rc(k,1,i) : -rc(k,nroot2_,i);
+      }
+    }
+  }
+  if (three_d) {
+    for (int j=0; j<nroot2_+2; ++j) {
+      for (int i=0; i<nroot1_+2; ++i) {
+        rc(0,j,i) = (periodic_[2])? rc(nroot3_,j,i) : -rc(1,j,i);
+        rc(nroot3_+1,j,i) = (periodic_[2])? rc(1,j,i) : -rc(nroot3_,j,i);
+      }
+    }
+  }
+  root_corr_.template modify<HostMemSpace>();
+  root_corr_.template sync<DevExeSpace>();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::ApplyRootOperator()
+//! \brief Computes y = -Lap(x) on root grid on host
+
+void MultigridSolver::ApplyRootOperator(const std::vector<Real> &x,
+                                        std::vector<Real> &y) {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &msize = pm->mesh_size;
+  Real a1 = SQR(static_cast<Real>(nroot1_)/(msize.x1max - msize.x1min));
+  Real a2 = SQR(static_cast<Real>(nroot2_)/(msize.x2max - msize.x2min));
+  Real a3 = SQR(static_cast<Real>(nroot3_)/(msize.x3max - msize.x3min));
+  int n1 = nroot1_, n2 = nroot2_, n3 = nroot3_;
+  // value of neighbor at offset (i,j,k), which may be a ghost cell
+  auto nghbr = [&](int i, int j, int k, int ic) -> Real {
+    if (i < 0 || i >= n1) {
+      if (periodic_[0]) {i = (i + n1)%n1;} else {return -x[ic];}
+    }
+    if (j < 0 || j >= n2) {
+      if (periodic_[1]) {j = (j + n2)%n2;} else {return -x[ic];}
+    }
+    if (k < 0 || k >= n3) {
+      if (periodic_[2]) {k = (k + n3)%n3;} else {return -x[ic];}
+    }
+    return x[i + n1*(j + n2*k)];
+  };
+  for (int k=0; k<n3; ++k) {
+    for (int j=0; j<n2; ++j) {
+      for (int i=0; i<n1; ++i) {
+        int ic = i + n1*(j + n2*k);
+        Real lap = a1*(nghbr(i-1,j,k,ic) - 2.0*x[ic] + nghbr(i+1,j,k,ic));
+        if (pm->multi_d) {
+          lap += a2*(nghbr(i,j-1,k,ic) - 2.0*x[ic] + nghbr(i,j+1,k,ic));
+        }
+        if (pm->three_d) {
+          lap += a3*(nghbr(i,j,k-1,ic) - 2.0*x[ic] + nghbr(i,j,k+1,ic));
+        }
+        y[ic] = -lap;
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridSolver::SubtractMean()
+//! \brief Subtracts volume-weighted mean of u over the Mesh from u (including ghost
+//! cells).  Must be called by all ranks.
+
+void MultigridSolver::SubtractMean() {
+  Mesh *pm = pmy_pack->pmesh;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &u_ = u;
+  Real sum_this_rank = 0.0;
+  Kokkos::parallel_reduce("mg_mean",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    sum += vol*u_(m,0,k,j,i);
+  }, Kokkos::Sum<Real>(sum_this_rank));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &sum_this_rank, 1, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+#endif
+  auto &msize = pm->mesh_size;
+  Real mean = sum_this_rank/((msize.x1max - msize.x1min)*(msize.x2max - msize.x2min)*
+                             (msize.x3max - msize.x3min));
+
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int n1 = u.extent_int(4) - 1;
+  int n2 = u.extent_int(3) - 1;
+  int n3 = u.extent_int(2) - 1;
+  par_for("mg_submean", DevExeSpace(), 0, nmb1, 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    u_(m,0,k,j,i) -= mean;
+  });
+  return;
+}
@@ -0,0 +1,105 @@
+#ifndef MULTIGRID_MULTIGRID_HPP_
+#define MULTIGRID_MULTIGRID_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file multigrid.hpp
+//  \brief geometric multigrid solver for the Poisson equation Lap(u) = f on the
+//  MeshBlocks of a MeshBlockPack, with uniform grids, SMR, or AMR.  Second-order
+//  (7-point in 3D) Laplacian on each MeshBlock.  Each V-cycle consists of:
+//    (1) npre red-black Gauss-Seidel sweeps on the MeshBlocks, with ghost cells
+//        exchanged between half-sweeps using the same boundary communication,
+//        restriction and prolongation functions as other cell-centered variables
+//    (2) the residual is restricted inside each MeshBlock by factors of two, as long as
+//        the number of cells in each direction is even
+//    (3) block averages of the residual are summed into a "root grid" with one cell per
+//        MeshBlock at the root level, which is solved on every rank with conjugate
+//        gradients
+//    (4) the coarse correction is interpolated back up through the levels inside each
+//        MeshBlock, with nsmooth sweeps on each level.  Ghost cells of each level are
+//        interpolated from the next coarser level (or the root grid) and held fixed.
+//    (5) npost sweeps on the MeshBlocks as in (1)
+//  Since the finest-level residual is always computed with exact ghost cells, the
+//  iteration converges to the solution of the discrete problem on the whole Mesh.
+//  Ghost cells at non-periodic faces of the Mesh are set by the function physical_bcs,
+//  which must be supplied by the owner of the solver, and are treated as Dirichlet
+//  values; the coarse correction vanishes there.  With strictly periodic boundaries the
+//  mean of f must vanish, and the mean of u is set to zero.
+//
+//  Input parameters (in the block given to the constructor):
+//    mg_tolerance   convergence criterion on L2 norm of residual / norm of f (1e-8)
+//    mg_max_cycles  maximum number of V-cycles per solve (default 50)
+//    mg_npre        number of pre-smoothing sweeps on MeshBlocks (default 2)
+//    mg_npost       number of post-smoothing sweeps on MeshBlocks (default 2)
+//    mg_nsmooth     number of smoothing sweeps on coarser levels in MeshBlocks (2)
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+
+// Forward declarations
+class MeshBlockPack;
+class MeshBoundaryValuesCC;
+
+//----------------------------------------------------------------------------------------
+//! \class MultigridSolver
+//! \brief Solves Lap(u) = src for a single cell-centered variable on all MeshBlocks
+
+class MultigridSolver {
+ public:
+  MultigridSolver(MeshBlockPack *ppack, ParameterInput *pin, const std::string &block,
+                  const std::string &module);
+  ~MultigridSolver();
+
+  // data
+  DvceArray5D<Real> u;         // solution (and initial guess), including ghost cells
+  DvceArray5D<Real> coarse_u;  // solution on 2x coarser grid (for SMR/AMR)
+  DvceArray5D<Real> src;       // source term f (only active cells used)
+  MeshBoundaryValuesCC *pbval_u;
+
+  // function that sets u in ghost cells at non-periodic faces of the Mesh
+  std::function<void(DvceArray5D<Real> &u)> physical_bcs = nullptr;
+
+  Real tolerance;                // convergence criterion on relative residual
+  int max_cycles;                // max number of V-cycles per solve
+  int npre, npost, nsmooth;      // number of smoothing sweeps
+  int ncycles;                   // number of V-cycles used in last solve
+  Real residual;                 // relative residual at end of last solve
+
+  // functions
+  void Solve();
+  void FillGhosts(DvceArray5D<Real> &a);
+
+ private:
+  MeshBlockPack *pmy_pack;    // ptr to MeshBlockPack containing this solver
+  int nlevels;                // number of levels inside each MeshBlock (0 = finest)
+  std::vector<int> nx1_, nx2_, nx3_;  // number of active cells on each level
+  std::vector<DvceArray4D<Real>> rhs_;   // residual on each level (1 ghost cell)
+  std::vector<DvceArray4D<Real>> corr_;  // correction on levels >= 1 (1 ghost cell)
+  DualArray1D<Real> block_avg_;          // average of residual in each MeshBlock
+
+  // root grid with one cell per MeshBlock at root level, stored on host
+  int nroot1_, nroot2_, nroot3_;
+  bool periodic_[3];          // mesh is periodic in x1/x2/x3
+  std::vector<Real> root_rhs_, root_x_, root_r_, root_p_, root_q_;
+  DualArray3D<Real> root_corr_;  // correction on root grid (1 ghost cell)
+
+  void Smooth(int color);
+  void SmoothCoarse(int l, int color);
+  Real Residual();
+  void Restrict(int l);
+  void ProlongateCoarse(int l);
+  void AddCorrection();
+  void RootToCoarse();
+  void SolveRoot();
+  void ApplyRootOperator(const std::vector<Real> &x, std::vector<Real> &y);
+  void SubtractMean();
+  void VCycle();
+};
+
+#endif // MULTIGRID_MULTIGRID_HPP_
@@ -27,6 +27,8 @@
 #include "z4c/z4c.hpp"
 #include "srcterms/srcterms.hpp"
 #include "srcterms/turb_driver.hpp"
+#include "gravity/gravity.hpp"
+#include "m1/m1.hpp"
 #include "outputs.hpp"
 
 #if MPI_PARALLEL_ENABLED
@@ -46,7 +48,8 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
   if (out_params.file_type.compare("hst") == 0 ||
       out_params.file_type.compare("rst") == 0 ||
       out_params.file_type.compare("log") == 0 ||
-      out_params.file_type.compare("trk") == 0) {return;}
+      out_params.file_type.compare("trk") == 0 ||
+      out_params.file_type.compare("flux") == 0) {return;}
 
   // initialize vector containing number of output MBs per rank
   noutmbs.assign(global_variable::nranks, 0);
@@ -159,6 +162,30 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
        << std::endl << "Input file is likely missing corresponding block" << std::endl;
     exit(EXIT_FAILURE);
   }
+  if ((ivar==152 && (pm->pmb_pack->phydro == nullptr ||
+                     !(pm->pmb_pack->phydro->peos->events.enabled))) ||
+      (ivar==153 && (pm->pmb_pack->pmhd == nullptr ||
+                     !(pm->pmb_pack->pmhd->peos->events.enabled)))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+       << "Output of C2P event map requested in <output> block '"
+       << out_params.block_name << "' but Hydro/MHD object not constructed, or "
+       << "event_map = false in its block" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if ((ivar==154) && (pm->pmb_pack->pgrav == nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+       << "Output of gravitational potential requested in <output> block '"
+       << out_params.block_name << "' but no Gravity object has been constructed."
+       << std::endl << "Input file is likely missing a <gravity> block" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if ((ivar==155) && (pm->pmb_pack->pm1 == nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+       << "Output of M1 moments requested in <output> block '"
+       << out_params.block_name << "' but no M1 object has been constructed."
+       << std::endl << "Input file is likely missing a <m1> block" << std::endl;
+    exit(EXIT_FAILURE);
+  }
 
   // Now load STL vector of output variables
   outvars.clear();
@@ -679,6 +706,35 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
     outvars.emplace_back("pdens",0,&(derived_var));
   }
 
+  // number of C2P failures and floors in each cell
+  if (out_params.variable.compare("hydro_events") == 0 ||
+      out_params.variable.compare("mhd_events") == 0) {
+    auto peos = (out_params.variable.compare("hydro_events") == 0)?
+                pm->pmb_pack->phydro->peos : pm->pmb_pack->pmhd->peos;
+    outvars.emplace_back("ev_dfloor",I_EV_DFLOOR,&(peos->events.map));
+    outvars.emplace_back("ev_efloor",I_EV_EFLOOR,&(peos->events.map));
+    outvars.emplace_back("ev_tfloor",I_EV_TFLOOR,&(peos->events.map));
+    outvars.emplace_back("ev_vceil",I_EV_VCEIL,&(peos->events.map));
+    outvars.emplace_back("ev_fail",I_EV_FAIL,&(peos->events.map));
+  }
+
+  // gravitational potential
+  if (out_params.variable.compare("grav_phi") == 0) {
+    outvars.emplace_back("phi",0,&(pm->pmb_pack->pgrav->phi));
+  }
+
+  // M1 moments, named by variable and species
+  if (out_params.variable.compare("m1_u") == 0) {
+    m1::M1 *pm1 = pm->pmb_pack->pm1;
+    const char *m1_names[5] = {"m1_E_", "m1_Fx_", "m1_Fy_", "m1_Fz_", "m1_N_"};
+    for (int s=0; s<pm1->nspecies; ++s) {
+      for (int v=0; v<pm1->nvars; ++v) {
+        outvars.emplace_back(m1_names[v] + std::to_string(s), s*(pm1->nvars) + v,
+                             &(pm1->u0));
+      }
+    }
+  }
+
   // initialize vector containing number of output MBs per rank
   noutmbs.assign(global_variable::nranks, 0);
 }
@@ -1018,6 +1018,7 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
 
     // Radiation
     int nang1 = pm->pmb_pack->prad->prgeo->nangles - 1;
+    int nfreq = pm->pmb_pack->prad->nfreq;
     auto nh_c_ = pm->pmb_pack->prad->nh_c;
     auto tet_c_ = pm->pmb_pack->prad->tet_c;
     auto tetcov_c_ = pm->pmb_pack->prad->tetcov_c;
@@ -1065,8 +1066,10 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
               nmun2 += tet_c_   (m,d,n2,k,j,i)*nh_c_.d_view(n,d);
               n_0   += tetcov_c_(m,d,0, k,j,i)*nh_c_.d_view(n,d);
             }
-            dv(m,n12,k,j,i) += (nmun1*nmun2*(i0_(m,n,k,j,i)/(n0*n_0))*
-                                solid_angles_.d_view(n));
+            // frequency-integrated intensity
+            Real isum = 0.0;
+            for (int g=0; g<nfreq; ++g) {isum += i0_(m,g*(nang1+1)+n,k,j,i);}
+            dv(m,n12,k,j,i) += (nmun1*nmun2*(isum/(n0*n_0))*solid_angles_.d_view(n));
           }
         }
       }
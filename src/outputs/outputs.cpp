@@ -18,7 +18,7 @@
 //! Required parameters that must be specified in an <output[n]> block are:
 //!   - variable  = [list of currently implemented strings for specifing output variables
 //!                  is defined at start of outputs.hpp file]
-//!   - file_type = tab,vtk,hst,bin,rst
+//!   - file_type = tab,vtk,vtu,hst,bin,rst,flux
 //!   - dt        = problem time between outputs
 //!
 //! EXAMPLE of an <output[n]> block for a TAB dump:
@@ -92,7 +92,8 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       if (opar.file_type.compare("hst") != 0 &&
           opar.file_type.compare("rst") != 0 &&
           opar.file_type.compare("log") != 0 &&
-          opar.file_type.compare("trk") != 0) {
+          opar.file_type.compare("trk") != 0 &&
+          opar.file_type.compare("flux") != 0) {
         opar.variable = pin->GetString(opar.block_name, "variable");
         opar.file_id = pin->GetOrAddString(opar.block_name,"id",opar.variable);
       }
@@ -182,7 +183,8 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       // set output variable and optional file id (default is output variable name)
       if (opar.file_type.compare("hst") != 0 &&
           opar.file_type.compare("rst") != 0 &&
-          opar.file_type.compare("log") != 0) {
+          opar.file_type.compare("log") != 0 &&
+          opar.file_type.compare("flux") != 0) {
         opar.variable = pin->GetString(opar.block_name, "variable");
         opar.file_id = pin->GetOrAddString(opar.block_name,"id",opar.variable);
       }
@@ -235,6 +237,12 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
       } else if (opar.file_type.compare("vtk") == 0) {
         pnode = new MeshVTKOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("vtu") == 0) {
+        pnode = new MeshVTUOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("flux") == 0) {
+        pnode = new SurfaceFluxOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("pvtk") == 0) {
         pnode = new ParticleVTKOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
@@ -269,6 +277,18 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         }
         pnode = new PDFOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("ugrid") == 0) {
+        opar.resample_level = pin->GetOrAddInteger(opar.block_name, "level", 0);
+        opar.nslabs = pin->GetOrAddInteger(opar.block_name, "nslabs", 1);
+        auto &ms = pm->mesh_size;
+        opar.box_x1min = pin->GetOrAddReal(opar.block_name, "box_x1min", ms.x1min);
+        opar.box_x1max = pin->GetOrAddReal(opar.block_name, "box_x1max", ms.x1max);
+        opar.box_x2min = pin->GetOrAddReal(opar.block_name, "box_x2min", ms.x2min);
+        opar.box_x2max = pin->GetOrAddReal(opar.block_name, "box_x2max", ms.x2max);
+        opar.box_x3min = pin->GetOrAddReal(opar.block_name, "box_x3min", ms.x3min);
+        opar.box_x3max = pin->GetOrAddReal(opar.block_name, "box_x3max", ms.x3max);
+        pnode = new ResampledOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("bin") == 0) {
         pnode = new MeshBinaryOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
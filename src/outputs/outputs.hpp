@@ -8,6 +8,7 @@
 //! \file outputs.hpp
 //  \brief provides classes to handle ALL types of data output
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,13 +16,14 @@
 
 #include "athena.hpp"
 #include "io_wrapper.hpp"
+#include "geodesic-grid/spherical_grid.hpp"
 
 #define NHISTORY_VARIABLES 12
 #if NHISTORY_VARIABLES > NREDUCTION_VARIABLES
     #error NHISTORY > NREDUCTION in outputs.hpp
 #endif
 
-#define NOUTPUT_CHOICES 152
+#define NOUTPUT_CHOICES 156
 // choices for output variables used in <ouput> blocks in input file
 // TO ADD MORE CHOICES:
 //   - add more strings to array below, change NOUTPUT_CHOICES above appropriately
@@ -96,7 +98,16 @@ static const char *var_choice[NOUTPUT_CHOICES] = {
   "tmunu",
 
   // Particles (150-151)
-  "prtcl_all", "prtcl_d"
+  "prtcl_all", "prtcl_d",
+
+  // maps of C2P failures and floors (152-153)
+  "hydro_events", "mhd_events",
+
+  // self-gravity (154)
+  "grav_phi",
+
+  // M1 moments of all species (155)
+  "m1_u"
 };
 
 
@@ -141,6 +152,12 @@ struct OutputParameters {
   int nbin=0, nbin2=0;
   bool logscale=true, logscale2=true;
   bool mass_weighted=false;
+  // parameters for uniform-grid output resampled to a single level:
+  int resample_level;           // physical level of uniform grid (0 = root)
+  int nslabs;                   // number of slabs in x3 written one at a time
+  Real box_x1min, box_x1max;    // sub-box of Mesh to be output
+  Real box_x2min, box_x2max;
+  Real box_x3min, box_x3max;
 };
 
 //----------------------------------------------------------------------------------------
@@ -240,7 +257,7 @@ class BaseTypeOutput {
   // CC output data on host with dims (n,m,k,j,i) except
   // for restarts, where dims are (m,n,k,j,i)
   HostArray5D<Real> outarray;
-  HostArray5D<Real> outarray_hyd, outarray_mhd, outarray_rad,
+  HostArray5D<Real> outarray_hyd, outarray_mhd, outarray_rad, outarray_m1,
                     outarray_force, outarray_z4c, outarray_adm;
   HostFaceFld4D<Real> outfield;  // FC output field on host
   std::vector<int> noutmbs;   // with MPI, number of output MBs across all ranks
@@ -348,6 +365,56 @@ class MeshVTKOutput : public BaseTypeOutput {
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
 };
 
+//----------------------------------------------------------------------------------------
+//! \class MeshVTUOutput
+//  \brief derived BaseTypeOutput class for mesh data on all levels of SMR/AMR meshes in
+//  VTK XML UnstructuredGrid format
+
+class MeshVTUOutput : public BaseTypeOutput {
+ public:
+  MeshVTUOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class ResampledOutput
+//  \brief derived BaseTypeOutput class for data on SMR/AMR meshes resampled to a single
+//  uniform grid at a chosen level, written as one contiguous global array
+
+class ResampledOutput : public BaseTypeOutput {
+ public:
+  ResampledOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+ protected:
+  int nout1, nout2, nout3;      // number of cells in uniform grid over sub-box
+  int ois1, ois2, ois3;         // index of first cell of sub-box in uniform grid
+  DvceArray1D<float> dbuf;      // resampled data from this rank in current slab
+};
+
+//----------------------------------------------------------------------------------------
+//! \class SurfaceFluxOutput
+//  \brief derived BaseTypeOutput class for fluxes through any number of spherical shells
+
+class SurfaceFluxOutput : public BaseTypeOutput {
+ public:
+  SurfaceFluxOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+ protected:
+  int nshell, nflux, npts;    // number of shells, fluxes, and points on all shells
+  bool header_written;
+  std::vector<std::unique_ptr<SphericalGrid>> shells;
+  std::vector<std::string> flux_names;
+  std::vector<Real> flux_data;     // integrated fluxes, (shell,flux)
+  DualArray1D<int> flux_ids;       // flux computed in each column
+  DualArray2D<int> pt_indcs;       // interpolation indices of points on all shells
+  DualArray3D<Real> pt_wghts;      // interpolation weights of points on all shells
+  DualArray2D<Real> pt_geom;       // position, polar angles, and solid angle of points
+  DualArray2D<Real> pt_flux;       // integrands of fluxes at points on all shells
+  void SetPoints();
+};
+
 //----------------------------------------------------------------------------------------
 //! \class ParticleVTKOutput
 //  \brief derived BaseTypeOutput class for particle data in VTK (legacy) format
@@ -382,6 +449,10 @@ class RestartOutput : public BaseTypeOutput {
   RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+  static IOWrapperSizeT MeshBlockDataSize(Mesh *pm);
+ protected:
+  HostArray2D<Real> outpart_rdata;  // particle data on host
+  HostArray2D<int>  outpart_idata;
 };
 
 //----------------------------------------------------------------------------------------
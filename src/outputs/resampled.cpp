@@ -0,0 +1,426 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file resampled.cpp
+//! \brief writes data on SMR/AMR meshes resampled to a single uniform grid at a chosen
+//! physical level (0 = root), over the whole Mesh or a sub-box of it.  MeshBlocks on
+//! finer levels are restricted by volume averaging, and MeshBlocks on coarser levels are
+//! prolongated using piecewise-linear interpolation with minmod-limited slopes.  The
+//! resampling is done on the device, and the result is written as single precision
+//! floats into one contiguous global array (x1 fastest, then x2, x3, and variables) using
+//! collective MPI-IO.  Parameters in the <output> block (in addition to variable, dt):
+//!   level = L              physical level of uniform grid
+//!   nslabs = N             number of slabs in x3 into which the grid is divided.  Slabs
+//!                          are resampled and written one at a time, so that no rank
+//!                          ever holds more than its own part of one slab.
+//!   box_x1min, box_x1max   sub-box to be output (default entire Mesh)
+//!   (and similarly in x2, x3)
+//! Options for ghost zones, slicing, or single MeshBlocks are ignored.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>      // fwrite(), fclose(), fopen(), fseek(), snprintf()
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \struct ResampledRow
+//! \brief contiguous row of cells along x1 in uniform grid resampled from one MeshBlock
+
+struct ResampledRow {
+  std::int64_t disp;  // offset of first cell in global array of one variable
+  int len;            // number of cells in row
+  int box, k, j;      // MeshBlock (in list of MBs in slab) and indices of row
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn Real MinMod()
+//! \brief minmod limiter of two slopes
+
+KOKKOS_INLINE_FUNCTION
+Real MinMod(const Real dql, const Real dqr) {
+  if (dql*dqr <= 0.0) {return 0.0;}
+  return (fabs(dql) < fabs(dqr))? dql : dqr;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int GridSize()
+//! \brief number of cells in one direction of uniform grid at physical level lev, given
+//! number of cells nroot at root level
+
+int GridSize(const int nroot, const int lev) {
+  return (lev >= 0)? (nroot << lev) : (nroot >> (-lev));
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// ctor: also calls BaseTypeOutput base class constructor
+// Checks that level is compatible with MeshBlock size, and sets sub-box in uniform grid
+
+ResampledOutput::ResampledOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op),
+  dbuf("ugrid_buf",1) {
+  // create new directory for this output. Comments in binary.cpp constructor explain why
+  mkdir("ugrid",0775);
+
+  // every MeshBlock must contain an integer number of cells of the uniform grid, on all
+  // levels that may exist in the Mesh
+  auto &indcs = pm->mb_indcs;
+  int lev = out_params.resample_level;
+  int dmax = pm->max_level - pm->root_level - lev;
+  if (dmax > 0) {
+    int nmin = indcs.nx1;
+    if (pm->multi_d) {nmin = std::min(nmin, indcs.nx2);}
+    if (pm->three_d) {nmin = std::min(nmin, indcs.nx3);}
+    if (dmax >= 30 || (nmin % (1 << dmax)) != 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Output block '" << out_params.block_name << "' has level="
+          << lev << " which is too coarse for MeshBlocks with " << nmin << " cells on "
+          << "level " << (pm->max_level - pm->root_level) << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  if (lev < 0) {
+    bool ok = ((pm->mesh_indcs.nx1 % (1 << (-lev))) == 0);
+    if (pm->multi_d) {ok = ok && ((pm->mesh_indcs.nx2 % (1 << (-lev))) == 0);}
+    if (pm->three_d) {ok = ok && ((pm->mesh_indcs.nx3 % (1 << (-lev))) == 0);}
+    if (!ok) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Output block '" << out_params.block_name << "' has level="
+          << lev << " which does not divide root grid" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  if (out_params.nslabs < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output block '" << out_params.block_name << "' must have "
+        << "nslabs >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // set range of cells in uniform grid covered by sub-box, in each active direction
+  auto &ms = pm->mesh_size;
+  auto box_range = [](Real xmin, Real xmax, Real bmin, Real bmax, int n,
+                      int &is, int &nout) {
+    Real dx = (xmax - xmin)/static_cast<Real>(n);
+    Real eps = 1.0e-6;
+    int ie = static_cast<int>(std::ceil((bmax - xmin)/dx - eps)) - 1;
+    is = static_cast<int>(std::floor((bmin - xmin)/dx + eps));
+    is = std::max(is, 0);
+    ie = std::min(ie, n-1);
+    nout = ie - is + 1;
+  };
+  box_range(ms.x1min, ms.x1max, out_params.box_x1min, out_params.box_x1max,
+            GridSize(pm->mesh_indcs.nx1, lev), ois1, nout1);
+  ois2 = 0, nout2 = 1;
+  if (pm->multi_d) {
+    box_range(ms.x2min, ms.x2max, out_params.box_x2min, out_params.box_x2max,
+              GridSize(pm->mesh_indcs.nx2, lev), ois2, nout2);
+  }
+  ois3 = 0, nout3 = 1;
+  if (pm->three_d) {
+    box_range(ms.x3min, ms.x3max, out_params.box_x3min, out_params.box_x3max,
+              GridSize(pm->mesh_indcs.nx3, lev), ois3, nout3);
+  }
+  if (nout1 < 1 || nout2 < 1 || nout3 < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Sub-box in output block '" << out_params.block_name
+        << "' does not overlap the Mesh" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ResampledOutput::LoadOutputData()
+//! \brief Computes derived variables (if required).  Resampling is performed slab by
+//! slab in WriteOutputFile(), so no data is copied to the host here.
+
+void ResampledOutput::LoadOutputData(Mesh *pm) {
+  if (out_params.contains_derived) {
+    ComputeDerivedVariable(out_params.variable, pm);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ResampledOutput::WriteOutputFile()
+//! \brief For each slab, finds the rows of the uniform grid covered by MeshBlocks on this
+//! rank, resamples data into these rows on the device, and writes them with a single
+//! collective MPI-IO call using a file view built from the (sorted) rows.
+
+void ResampledOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // create filename: "ugrid/file_basename"."file_id"."XXXXX".ugrid
+  // where XXXXX = 5-digit file_number
+  std::string fname;
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+  fname.assign("ugrid/");
+  fname.append(out_params.file_basename);
+  fname.append(".");
+  fname.append(out_params.file_id);
+  fname.append(".");
+  fname.append(number);
+  fname.append(".ugrid");
+
+  // uniform grid spacing, and physical extent of sub-box
+  int lev = out_params.resample_level;
+  auto &ms = pm->mesh_size;
+  Real dx1 = (ms.x1max - ms.x1min)/static_cast<Real>(GridSize(pm->mesh_indcs.nx1, lev));
+  Real dx2 = ms.x2max - ms.x2min;
+  Real dx3 = ms.x3max - ms.x3min;
+  if (pm->multi_d) {dx2 /= static_cast<Real>(GridSize(pm->mesh_indcs.nx2, lev));}
+  if (pm->three_d) {dx3 /= static_cast<Real>(GridSize(pm->mesh_indcs.nx3, lev));}
+
+  // Header: text lines describing layout of data, ending with "end of header"
+  int nout_vars = outvars.size();
+  std::stringstream msg;
+  msg << "Athena uniform grid output version=1.0" << std::endl
+      << "  time=" << pm->time << std::endl
+      << "  cycle=" << pm->ncycle << std::endl
+      << "  level=" << lev << std::endl
+      << "  size of variable=" << sizeof(float) << std::endl
+      << "  number of variables=" << nout_vars << std::endl
+      << "  variables:  ";
+  for (int n=0; n<nout_vars; n++) {
+    msg << outvars[n].label.c_str() << "  ";
+  }
+  msg << std::endl
+      << "  nx1=" << nout1 << "  nx2=" << nout2 << "  nx3=" << nout3 << std::endl
+      << std::scientific << std::setprecision(std::numeric_limits<Real>::max_digits10 - 1)
+      << "  x1min=" << ms.x1min + ois1*dx1 << "  x1max=" << ms.x1min + (ois1+nout1)*dx1
+      << std::endl
+      << "  x2min=" << ms.x2min + ois2*dx2 << "  x2max=" << ms.x2min + (ois2+nout2)*dx2
+      << std::endl
+      << "  x3min=" << ms.x3min + ois3*dx3 << "  x3max=" << ms.x3min + (ois3+nout3)*dx3
+      << std::endl << "  end of header" << std::endl;
+  std::size_t header_size = msg.str().size();
+
+#if MPI_PARALLEL_ENABLED
+  MPI_File fh;
+  if (MPI_File_open(MPI_COMM_WORLD, fname.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                    MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (global_variable::my_rank == 0) {
+    MPI_File_write(fh, msg.str().c_str(), msg.str().size(), MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+#else
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(),"wb")) == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::fwrite(msg.str().c_str(), sizeof(char), msg.str().size(), pfile);
+#endif
+
+  // For each MeshBlock on this rank, the refinement factor (>1 for restriction) or
+  // prolongation factor (>1 for prolongation) in each direction, and the index in the
+  // sub-box of the first cell of the MeshBlock on the uniform grid.
+  auto &indcs = pm->mb_indcs;
+  int nmb = pm->pmb_pack->nmb_thispack;
+  int gids = pm->pmb_pack->gids;
+  std::vector<int> rfac(nmb), pfac(nmb), mbs1(nmb), mbs2(nmb), mbs3(nmb);
+  for (int m=0; m<nmb; ++m) {
+    LogicalLocation &lloc = pm->lloc_eachmb[gids + m];
+    int d = lloc.level - pm->root_level - lev;
+    rfac[m] = (d > 0)? (1 << d) : 1;
+    pfac[m] = (d < 0)? (1 << (-d)) : 1;
+    mbs1[m] = static_cast<int>(static_cast<std::int64_t>(lloc.lx1)*indcs.nx1*pfac[m]
+                               /rfac[m]) - ois1;
+    mbs2[m] = static_cast<int>(static_cast<std::int64_t>(lloc.lx2)*indcs.nx2*pfac[m]
+                               /rfac[m]) - ois2;
+    mbs3[m] = static_cast<int>(static_cast<std::int64_t>(lloc.lx3)*indcs.nx3*pfac[m]
+                               /rfac[m]) - ois3;
+  }
+  std::int64_t ncells = static_cast<std::int64_t>(nout1)*nout2*nout3;
+
+  int nslabs = std::min(out_params.nslabs, nout3);
+  for (int s=0; s<nslabs; ++s) {
+    int kslab_s = (s*nout3)/nslabs;
+    int kslab_e = ((s+1)*nout3)/nslabs - 1;
+
+    // find rows of cells in slab covered by each MeshBlock
+    std::vector<int> mbox, ibox_s, ibox_e, jbox_s, jbox_e, kbox_s, kbox_e, roff;
+    std::vector<ResampledRow> rows;
+    for (int m=0; m<nmb; ++m) {
+      int r1 = (pm->multi_d)? 1 : 0;
+      int r2 = (pm->three_d)? 1 : 0;
+      int nc1 = indcs.nx1*pfac[m]/rfac[m];
+      int nc2 = (r1 == 1)? indcs.nx2*pfac[m]/rfac[m] : 1;
+      int nc3 = (r2 == 1)? indcs.nx3*pfac[m]/rfac[m] : 1;
+      int is = std::max(mbs1[m], 0), ie = std::min(mbs1[m] + nc1, nout1) - 1;
+      int js = std::max(mbs2[m], 0), je = std::min(mbs2[m] + nc2, nout2) - 1;
+      int ks = std::max(mbs3[m], kslab_s), ke = std::min(mbs3[m] + nc3 - 1, kslab_e);
+      if (is > ie || js > je || ks > ke) {continue;}
+      int b = mbox.size();
+      roff.push_back(rows.size());
+      mbox.push_back(m);
+      ibox_s.push_back(is); ibox_e.push_back(ie);
+      jbox_s.push_back(js); jbox_e.push_back(je);
+      kbox_s.push_back(ks); kbox_e.push_back(ke);
+      for (int k=ks; k<=ke; ++k) {
+        for (int j=js; j<=je; ++j) {
+          std::int64_t disp = (static_cast<std::int64_t>(k)*nout2 + j)*nout1 + is;
+          rows.push_back({disp, ie - is + 1, b, k, j});
+        }
+      }
+    }
+
+    // sort rows into order in file, and set position of each row in output buffer
+    int nbox = mbox.size();
+    int nrows = rows.size();
+    std::sort(rows.begin(), rows.end(),
+              [](const ResampledRow &a, const ResampledRow &b) {return a.disp < b.disp;});
+    DualArray1D<int> rowpos("ugrid_rowpos", std::max(nrows, 1));
+    int nloc = 0;
+    for (auto &row : rows) {
+      int b = row.box;
+      int nj = jbox_e[b] - jbox_s[b] + 1;
+      rowpos.h_view(roff[b] + (row.k - kbox_s[b])*nj + (row.j - jbox_s[b])) = nloc;
+      nloc += row.len;
+    }
+    rowpos.template modify<HostMemSpace>();
+    rowpos.template sync<DevExeSpace>();
+
+    // resample each variable on each MeshBlock into output buffer on device
+    if (static_cast<int>(dbuf.extent(0)) < nout_vars*nloc) {
+      Kokkos::realloc(dbuf, nout_vars*nloc);
+    }
+    auto dbuf_ = dbuf;
+    auto rowpos_ = rowpos.d_view;
+    int cis = indcs.is, cie = indcs.ie;
+    int cjs = indcs.js, cje = indcs.je;
+    int cks = indcs.ks, cke = indcs.ke;
+    bool multi_d = pm->multi_d;
+    bool three_d = pm->three_d;
+    for (int n=0; n<nout_vars; ++n) {
+      auto q = *(outvars[n].data_ptr);
+      int nv = outvars[n].data_index;
+      for (int b=0; b<nbox; ++b) {
+        int m = mbox[b];
+        int rf1 = rfac[m], pf1 = pfac[m];
+        int rf2 = (multi_d)? rf1 : 1, pf2 = (multi_d)? pf1 : 1;
+        int rf3 = (three_d)? rf1 : 1, pf3 = (three_d)? pf1 : 1;
+        int b1 = mbs1[m], b2 = mbs2[m], b3 = mbs3[m];
+        int is = ibox_s[b], js = jbox_s[b], ks = kbox_s[b];
+        int nj = jbox_e[b] - js + 1;
+        int ro = roff[b];
+        int noff = n*nloc;
+        par_for("ugrid", DevExeSpace(), ks, kbox_e[b], js, jbox_e[b], is, ibox_e[b],
+        KOKKOS_LAMBDA(const int k, const int j, const int i) {
+          Real val = 0.0;
+          if (pf1 == 1) {
+            // restriction by volume average (or copy if on same level)
+            int fi = (i - b1)*rf1 + cis;
+            int fj = (j - b2)*rf2 + cjs;
+            int fk = (k - b3)*rf3 + cks;
+            for (int kk=0; kk<rf3; ++kk) {
+              for (int jj=0; jj<rf2; ++jj) {
+                for (int ii=0; ii<rf1; ++ii) {
+                  val += q(m,nv,fk+kk,fj+jj,fi+ii);
+                }
+              }
+            }
+            val /= static_cast<Real>(rf1*rf2*rf3);
+          } else {
+            // prolongation with minmod-limited linear slopes from active cells
+            int ci = (i - b1)/pf1 + cis;
+            int cj = (j - b2)/pf2 + cjs;
+            int ck = (k - b3)/pf3 + cks;
+            val = q(m,nv,ck,cj,ci);
+            Real x1 = (((i - b1) % pf1) + 0.5)/static_cast<Real>(pf1) - 0.5;
+            int im1 = (ci > cis)? ci-1 : ci, ip1 = (ci < cie)? ci+1 : ci;
+            Real dq1 = MinMod(val - q(m,nv,ck,cj,im1), q(m,nv,ck,cj,ip1) - val);
+            val += x1*dq1;
+            if (multi_d) {
+              Real x2 = (((j - b2) % pf2) + 0.5)/static_cast<Real>(pf2) - 0.5;
+              int jm1 = (cj > cjs)? cj-1 : cj, jp1 = (cj < cje)? cj+1 : cj;
+              Real q0 = q(m,nv,ck,cj,ci);
+              Real dq2 = MinMod(q0 - q(m,nv,ck,jm1,ci), q(m,nv,ck,jp1,ci) - q0);
+              val += x2*dq2;
+            }
+            if (three_d) {
+              Real x3 = (((k - b3) % pf3) + 0.5)/static_cast<Real>(pf3) - 0.5;
+              int km1 = (ck > cks)? ck-1 : ck, kp1 = (ck < cke)? ck+1 : ck;
+              Real q0 = q(m,nv,ck,cj,ci);
+              Real dq3 = MinMod(q0 - q(m,nv,km1,cj,ci), q(m,nv,kp1,cj,ci) - q0);
+              val += x3*dq3;
+            }
+          }
+          int pos = rowpos_(ro + (k - ks)*nj + (j - js)) + (i - is);
+          dbuf_(noff + pos) = static_cast<float>(val);
+        });
+      }
+    }
+    auto hbuf = Kokkos::create_mirror_view(dbuf);
+    Kokkos::deep_copy(hbuf, dbuf);
+
+#if MPI_PARALLEL_ENABLED
+    // set file view to sorted rows of all variables, then write collectively
+    MPI_Datatype rowtype = MPI_FLOAT;
+    if (nrows > 0) {
+      std::vector<int> blens(nout_vars*nrows);
+      std::vector<MPI_Aint> disps(nout_vars*nrows);
+      for (int n=0; n<nout_vars; ++n) {
+        for (int r=0; r<nrows; ++r) {
+          blens[n*nrows + r] = rows[r].len;
+          disps[n*nrows + r] = static_cast<MPI_Aint>((n*ncells + rows[r].disp)
+                                                     *sizeof(float));
+        }
+      }
+      MPI_Type_create_hindexed(nout_vars*nrows, blens.data(), disps.data(), MPI_FLOAT,
+                               &rowtype);
+      MPI_Type_commit(&rowtype);
+    }
+    MPI_File_set_view(fh, header_size, MPI_FLOAT, rowtype, "native", MPI_INFO_NULL);
+    MPI_File_write_all(fh, hbuf.data(), nout_vars*nloc, MPI_FLOAT, MPI_STATUS_IGNORE);
+    if (nrows > 0) {MPI_Type_free(&rowtype);}
+#else
+    for (int n=0; n<nout_vars; ++n) {
+      for (int r=0, pos=0; r<nrows; ++r) {
+        std::fseek(pfile, header_size + (n*ncells + rows[r].disp)*sizeof(float),
+                   SEEK_SET);
+        std::fwrite(&(hbuf(n*nloc + pos)), sizeof(float), rows[r].len, pfile);
+        pos += rows[r].len;
+      }
+    }
+#endif
+  }  // end loop over slabs
+
+#if MPI_PARALLEL_ENABLED
+  MPI_File_close(&fh);
+#else
+  std::fclose(pfile);
+#endif
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
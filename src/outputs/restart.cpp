@@ -16,6 +16,7 @@
 #include <sstream>
 #include <string>
 #include <utility> // make_pair
+#include <vector>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -28,6 +29,8 @@
 #include "z4c/compact_object_tracker.hpp"
 #include "z4c/z4c.hpp"
 #include "radiation/radiation.hpp"
+#include "m1/m1.hpp"
+#include "particles/particles.hpp"
 #include "srcterms/turb_driver.hpp"
 //#include "outputs.hpp"
 
@@ -59,8 +62,9 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   adm::ADM* padm = pm->pmb_pack->padm;
   z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
   radiation::Radiation* prad = pm->pmb_pack->prad;
+  m1::M1* pm1 = pm->pmb_pack->pm1;
   TurbulenceDriver* pturb=pm->pmb_pack->pturb;
-  int nhydro=0, nmhd=0, nrad=0, nforce=3, nadm=0, nz4c=0;
+  int nhydro=0, nmhd=0, nrad=0, nm1=0, nforce=3, nadm=0, nz4c=0;
   if (phydro != nullptr) {
     nhydro = phydro->nhydro + phydro->nscalars;
   }
@@ -74,7 +78,10 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   }
   // if the spacetime is evolved, we do not need to checkpoint/recover the ADM variables
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nfrang;
+  }
+  if (pm1 != nullptr) {
+    nm1 = (pm1->nspecies)*(pm1->nvars);
   }
 
   // Note for restarts, outarrays are dimensioned (m,n,k,j,i)
@@ -102,6 +109,11 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
     Kokkos::deep_copy(outarray_rad, Kokkos::subview(prad->i0, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   }
+  if (pm1 != nullptr) {
+    Kokkos::realloc(outarray_m1, nmb, nm1, nout3, nout2, nout1);
+    Kokkos::deep_copy(outarray_m1, Kokkos::subview(pm1->u0, std::make_pair(0,nmb),
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
+  }
   if (pturb != nullptr) {
     Kokkos::realloc(outarray_force, nmb, nforce, nout3, nout2, nout1);
     Kokkos::deep_copy(outarray_force, Kokkos::subview(pturb->force, std::make_pair(0,nmb),
@@ -117,6 +129,15 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   }
 
+  // particle data (arrays are always dimensioned to the number of particles)
+  particles::Particles* ppart = pm->pmb_pack->ppart;
+  if (ppart != nullptr) {
+    Kokkos::realloc(outpart_rdata, ppart->nrdata, ppart->prtcl_rdata.extent(1));
+    Kokkos::realloc(outpart_idata, ppart->nidata, ppart->prtcl_idata.extent(1));
+    Kokkos::deep_copy(outpart_rdata, ppart->prtcl_rdata);
+    Kokkos::deep_copy(outpart_idata, ppart->prtcl_idata);
+  }
+
   // calculate max/min number of MeshBlocks across all ranks
   noutmbs_max = pm->nmb_eachrank[0];
   noutmbs_min = pm->nmb_eachrank[0];
@@ -126,6 +147,55 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn IOWrapperSizeT RestartOutput::MeshBlockDataSize(Mesh *pm)
+//! \brief Returns size (in bytes) of cell-centered variables and face-centered fields
+//! written to restart files for each MeshBlock.  Also used by the Driver to estimate the
+//! time needed to write a restart file before any has been written.
+
+IOWrapperSizeT RestartOutput::MeshBlockDataSize(Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int nout1 = indcs.nx1 + 2*(indcs.ng);
+  int nout2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int nout3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  hydro::Hydro* phydro = pm->pmb_pack->phydro;
+  mhd::MHD* pmhd = pm->pmb_pack->pmhd;
+  radiation::Radiation* prad = pm->pmb_pack->prad;
+  m1::M1* pm1 = pm->pmb_pack->pm1;
+  TurbulenceDriver* pturb=pm->pmb_pack->pturb;
+  z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
+  adm::ADM* padm = pm->pmb_pack->padm;
+
+  IOWrapperSizeT data_size = 0;
+  if (phydro != nullptr) {
+    int nhydro = phydro->nhydro + phydro->nscalars;
+    data_size += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
+  }
+  if (pmhd != nullptr) {
+    int nmhd = pmhd->nmhd + pmhd->nscalars;
+    data_size += nout1*nout2*nout3*nmhd*sizeof(Real);   // mhd u0
+    data_size += (nout1+1)*nout2*nout3*sizeof(Real);    // mhd b0.x1f
+    data_size += nout1*(nout2+1)*nout3*sizeof(Real);    // mhd b0.x2f
+    data_size += nout1*nout2*(nout3+1)*sizeof(Real);    // mhd b0.x3f
+  }
+  if (prad != nullptr) {
+    data_size += nout1*nout2*nout3*(prad->nfrang)*sizeof(Real);   // radiation i0
+  }
+  if (pm1 != nullptr) {
+    int nm1 = (pm1->nspecies)*(pm1->nvars);
+    data_size += nout1*nout2*nout3*nm1*sizeof(Real);    // m1 u0
+  }
+  if (pturb != nullptr) {
+    data_size += nout1*nout2*nout3*3*sizeof(Real);      // forcing
+  }
+  if (pz4c != nullptr) {
+    data_size += nout1*nout2*nout3*(pz4c->nz4c)*sizeof(Real);     // z4c u0
+  } else if (padm != nullptr) {
+    data_size += nout1*nout2*nout3*(padm->nadm)*sizeof(Real);     // adm u_adm
+  }
+  return data_size;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void RestartOutput:::WriteOutputFile(Mesh *pm)
 //  \brief Cycles over all MeshBlocks and writes everything to a single restart file
@@ -139,10 +209,11 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   hydro::Hydro* phydro = pm->pmb_pack->phydro;
   mhd::MHD* pmhd = pm->pmb_pack->pmhd;
   radiation::Radiation* prad = pm->pmb_pack->prad;
+  m1::M1* pm1 = pm->pmb_pack->pm1;
   TurbulenceDriver* pturb=pm->pmb_pack->pturb;
   z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
   adm::ADM* padm = pm->pmb_pack->padm;
-  int nhydro=0, nmhd=0, nrad=0, nforce=3, nz4c=0, nadm=0, nco=0;
+  int nhydro=0, nmhd=0, nrad=0, nm1=0, nforce=3, nz4c=0, nadm=0, nco=0;
   if (phydro != nullptr) {
     nhydro = phydro->nhydro + phydro->nscalars;
   }
@@ -150,7 +221,10 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     nmhd = pmhd->nmhd + pmhd->nscalars;
   }
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nfrang;
+  }
+  if (pm1 != nullptr) {
+    nm1 = (pm1->nspecies)*(pm1->nvars);
   }
   if (pz4c != nullptr) {
     nz4c = pz4c->nz4c;
@@ -228,38 +302,18 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
         resfile.Write_any_type(pt.GetPos(), 3*sizeof(Real), "byte");
       }
     }
-    // turbulence driver internal RNG
+    // key of turbulence driver counter-based RNG
     if (pturb != nullptr) {
-      resfile.Write_any_type(&(pturb->rstate), sizeof(RNG_State), "byte");
+      resfile.Write_any_type(&(pturb->rkey), sizeof(RNG_Key), "byte");
     }
   }
 
   //--- STEP 4.  All ranks write data over all MeshBlocks (5D arrays) in parallel
   // This data read in ProblemGenerator constructor for restarts
 
-  // total size of all cell-centered variables and face-centered fields to be written by
-  // this rank
-  IOWrapperSizeT data_size = 0;
-  if (phydro != nullptr) {
-    data_size += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
-  }
-  if (pmhd != nullptr) {
-    data_size += nout1*nout2*nout3*nmhd*sizeof(Real);   // mhd u0
-    data_size += (nout1+1)*nout2*nout3*sizeof(Real);    // mhd b0.x1f
-    data_size += nout1*(nout2+1)*nout3*sizeof(Real);    // mhd b0.x2f
-    data_size += nout1*nout2*(nout3+1)*sizeof(Real);    // mhd b0.x3f
-  }
-  if (prad != nullptr) {
-    data_size += nout1*nout2*nout3*nrad*sizeof(Real);   // radiation i0
-  }
-  if (pturb != nullptr) {
-    data_size += nout1*nout2*nout3*nforce*sizeof(Real); // forcing
-  }
-  if (pz4c != nullptr) {
-    data_size += nout1*nout2*nout3*nz4c*sizeof(Real);   // z4c u0
-  } else if (padm != nullptr) {
-    data_size += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
-  }
+  // total size of all cell-centered variables and face-centered fields to be written for
+  // each MeshBlock
+  IOWrapperSizeT data_size = MeshBlockDataSize(pm);
   if (global_variable::my_rank == 0) {
     resfile.Write_any_type(&(data_size), sizeof(IOWrapperSizeT), "byte");
   }
@@ -271,7 +325,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
   IOWrapperSizeT step3size = 3*nco*sizeof(Real);
   if (pz4c != nullptr) step3size += sizeof(Real);
-  if (pturb != nullptr) step3size += sizeof(RNG_State);
+  if (pturb != nullptr) step3size += sizeof(RNG_Key);
 
   // write cell-centered variables in parallel
   IOWrapperSizeT offset_myrank  = step1size + step2size + step3size +
@@ -466,6 +520,41 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     myoffset = offset_myrank;
   }
 
+  if (pm1 != nullptr) {
+    for (int m=0;  m<noutmbs_max; ++m) {
+      // every rank has a MB to write, so write collectively
+      if (m < noutmbs_min) {
+        // get ptr to cell-centered MeshBlock data
+        auto mbptr = Kokkos::subview(outarray_m1, m, Kokkos::ALL, Kokkos::ALL,
+                                     Kokkos::ALL, Kokkos::ALL);
+        int mbcnt = mbptr.size();
+        if (resfile.Write_any_type_at_all(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "cell-centered m1 data not written correctly to rst file, "
+          << "restart file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        myoffset += data_size;
+
+      // some ranks are finished writing, so use non-collective write
+      } else if (m < pm->nmb_thisrank) {
+        // get ptr to MeshBlock data
+        auto mbptr = Kokkos::subview(outarray_m1, m, Kokkos::ALL, Kokkos::ALL,
+                                     Kokkos::ALL, Kokkos::ALL);
+        int mbcnt = mbptr.size();
+        if (resfile.Write_any_type_at(mbptr.data(),mbcnt,myoffset,"Real") != mbcnt) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "cell-centered m1 data not written correctly to rst file, "
+          << "restart file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        myoffset += data_size;
+      }
+    }
+    offset_myrank += nout1*nout2*nout3*nm1*sizeof(Real);    // m1 u0
+    myoffset = offset_myrank;
+  }
+
   if (pturb != nullptr) {
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to write, so write collectively
@@ -569,6 +658,66 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     myoffset = offset_myrank;
   }
 
+  //--- STEP 5.  Particles are written after the data over all MeshBlocks.  The root
+  // process writes the number of real and integer properties, the particle time step,
+  // and the index of the first particle on each rank.  Then all ranks write their
+  // particles in parallel, with each property stored contiguously over all particles.
+  // This data read in ProblemGenerator constructor for restarts
+  particles::Particles* ppart = pm->pmb_pack->ppart;
+  if (ppart != nullptr) {
+    int nranks = global_variable::nranks;
+    int npart = ppart->nprtcl_thispack;
+    std::vector<int> npart_eachrank(nranks, 0);
+    npart_eachrank[global_variable::my_rank] = npart;
+#if MPI_PARALLEL_ENABLED
+    MPI_Allgather(&npart, 1, MPI_INT, npart_eachrank.data(), 1, MPI_INT, MPI_COMM_WORLD);
+#endif
+    std::vector<IOWrapperSizeT> pindex(nranks+1, 0);
+    for (int n=0; n<nranks; ++n) {
+      pindex[n+1] = pindex[n] + npart_eachrank[n];
+    }
+    IOWrapperSizeT ntot = pindex[nranks];
+
+    IOWrapperSizeT offset_part = step1size + step2size + step3size +
+                                 sizeof(IOWrapperSizeT) + data_size*(pm->nmb_total);
+    if (global_variable::my_rank == 0) {
+      int pheader[3] = {ppart->nrdata, ppart->nidata, nranks};
+      resfile.Write_any_type_at(&(pheader[0]), 3, offset_part, "int");
+      resfile.Write_any_type_at(&(ppart->dtnew), 1, offset_part + 3*sizeof(int), "Real");
+      resfile.Write_any_type_at(pindex.data(), (nranks+1)*sizeof(IOWrapperSizeT),
+                                offset_part + 3*sizeof(int) + sizeof(Real), "byte");
+    }
+    offset_part += 3*sizeof(int) + sizeof(Real) + (nranks+1)*sizeof(IOWrapperSizeT);
+
+    int nrdata = ppart->nrdata, nidata = ppart->nidata;
+    bool no_errors = true;
+    for (int n=0; n<nrdata; ++n) {
+      IOWrapperSizeT myoff = offset_part +
+                             (n*ntot + pindex[global_variable::my_rank])*sizeof(Real);
+      Real *pdata = outpart_rdata.data() + n*outpart_rdata.extent(1);
+      std::size_t nwrite = resfile.Write_any_type_at_all(pdata, npart, myoff, "Real");
+      if (nwrite != static_cast<std::size_t>(npart)) {
+        no_errors = false;
+      }
+    }
+    offset_part += nrdata*ntot*sizeof(Real);
+    for (int n=0; n<nidata; ++n) {
+      IOWrapperSizeT myoff = offset_part +
+                             (n*ntot + pindex[global_variable::my_rank])*sizeof(int);
+      int *pdata = outpart_idata.data() + n*outpart_idata.extent(1);
+      std::size_t nwrite = resfile.Write_any_type_at_all(pdata, npart, myoff, "int");
+      if (nwrite != static_cast<std::size_t>(npart)) {
+        no_errors = false;
+      }
+    }
+    if (!(no_errors)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "particle data not written correctly to rst file, "
+                << "restart file is broken." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
   // close file, clean up
   resfile.Close();
 
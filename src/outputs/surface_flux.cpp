@@ -0,0 +1,515 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file surface_flux.cpp
+//! \brief writes fluxes of mass, energy, angular momentum, magnetic flux and radiation
+//! through any number of spherical shells to a single text file, with one column per
+//! (flux, shell).  Works with Hydro or MHD in Newtonian, SR, GR and dynamical GR, and
+//! with radiation.  Data are interpolated to the points on all shells and the integrands
+//! computed in a single device kernel, then summed over points and ranks.
+//!
+//! Parameters in the <output[n]> block are:
+//!   - file_type = flux
+//!   - nradii    = number of shells (default 1)
+//!   - radius_N  = radius of shell N = 1..nradii.  In GR this is the spherical
+//!                 Kerr-Schild radius, so shells are oblate spheroids when spin != 0
+//!   - nlev      = level of geodesic grid on each shell (default 10)
+//!   - fluxes    = comma-separated list of fluxes to compute, from
+//!                 mdot : mass accretion rate (positive for inflow)
+//!                 edot : total (fluid + EM) energy flux (in relativity, -T^r_t)
+//!                 ldot : flux of z-angular momentum (in relativity, T^r_phi)
+//!                 phi  : magnetic flux 0.5*|B^r| (MHD only)
+//!                 erad : radiation energy flux -R^r_t (radiation only)
+//!                 lrad : radiation angular momentum flux R^r_phi (radiation only)
+//!                 (default: all fluxes available for the enabled physics)
+//!   - id        = name used in output file <basename>.<id>.flx (default "flux")
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/adm.hpp"
+#include "coordinates/cartesian_ks.hpp"
+#include "coordinates/coordinates.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "radiation/radiation.hpp"
+#include "outputs.hpp"
+
+namespace {
+// indices of fluxes computed in kernel
+enum SurfaceFluxes {I_MDOT, I_EDOT, I_LDOT, I_PHI, I_ERAD, I_LRAD, N_SFLUX};
+const char *sflux_names[N_SFLUX] = {"mdot", "edot", "ldot", "phi", "erad", "lrad"};
+
+// indices of geometric data stored for each point
+enum PointGeometry {I_PX, I_PY, I_PZ, I_PR, I_PTH, I_PPH, I_DOM, N_PGEOM};
+
+//----------------------------------------------------------------------------------------
+//! \fn Real InterpolateToPoint()
+//! \brief Lagrange interpolation of variable v of array a to point n, using indices and
+//! weights computed by SphericalGrid
+
+KOKKOS_INLINE_FUNCTION
+Real InterpolateToPoint(const DvceArray5D<Real> &a, int v, int n, int ng,
+                        int is, int js, int ks, const DvceArray2D<int> &ind,
+                        const DvceArray3D<Real> &wgt) {
+  int m = ind(n,0);
+  Real val = 0.0;
+  for (int k=0; k<2*ng; k++) {
+    for (int j=0; j<2*ng; j++) {
+      for (int i=0; i<2*ng; i++) {
+        Real w = wgt(n,i,0)*wgt(n,j,1)*wgt(n,k,2);
+        val += w*a(m,v,ind(n,3)-(ng-k-ks)+1,ind(n,2)-(ng-j-js)+1,ind(n,1)-(ng-i-is)+1);
+      }
+    }
+  }
+  return val;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+SurfaceFluxOutput::SurfaceFluxOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
+  : BaseTypeOutput(pin, pm, op),
+    header_written(false),
+    flux_ids("flux_ids",1),
+    pt_indcs("pt_indcs",1,1),
+    pt_wghts("pt_wghts",1,1,1),
+    pt_geom("pt_geom",1,1),
+    pt_flux("pt_flux",1,1) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  if (!(pm->three_d)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Surface flux output in block '" << out_params.block_name
+              << "' only works in 3D" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  out_params.file_id = pin->GetOrAddString(out_params.block_name, "id", "flux");
+
+  // construct shells
+  nshell = pin->GetOrAddInteger(out_params.block_name, "nradii", 1);
+  int nlev = pin->GetOrAddInteger(out_params.block_name, "nlev", 10);
+  for (int n=1; n<=nshell; ++n) {
+    Real rad = pin->GetReal(out_params.block_name, "radius_" + std::to_string(n));
+    shells.push_back(std::make_unique<SphericalGrid>(pmbp, nlev, rad));
+  }
+
+  // fluxes available for enabled physics
+  bool has_fluid = (pmbp->phydro != nullptr || pmbp->pmhd != nullptr);
+  bool has_energy = false;
+  if (pmbp->pmhd != nullptr) {
+    has_energy = pmbp->pmhd->peos->eos_data.is_ideal;
+  } else if (pmbp->phydro != nullptr) {
+    has_energy = pmbp->phydro->peos->eos_data.is_ideal;
+  }
+  bool available[N_SFLUX] = {has_fluid, has_energy, has_fluid, (pmbp->pmhd != nullptr),
+                             (pmbp->prad != nullptr), (pmbp->prad != nullptr)};
+
+  // parse list of fluxes
+  std::vector<int> ids;
+  if (pin->DoesParameterExist(out_params.block_name, "fluxes")) {
+    std::stringstream list(pin->GetString(out_params.block_name, "fluxes"));
+    std::string name;
+    while (std::getline(list, name, ',')) {
+      name.erase(0, name.find_first_not_of(" \t"));
+      name.erase(name.find_last_not_of(" \t") + 1);
+      if (name.empty()) continue;
+      int id = -1;
+      for (int f=0; f<N_SFLUX; ++f) {
+        if (name.compare(sflux_names[f]) == 0) {id = f;}
+      }
+      if (id < 0 || !(available[id])) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Flux '" << name << "' in block '"
+                  << out_params.block_name << "' is not recognized, or cannot be "
+                  << "computed with the enabled physics" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      ids.push_back(id);
+    }
+  } else {
+    for (int f=0; f<N_SFLUX; ++f) {
+      if (available[f]) {ids.push_back(f);}
+    }
+  }
+  nflux = static_cast<int>(ids.size());
+  if (nflux == 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "No fluxes to compute in block '" << out_params.block_name << "'"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  Kokkos::realloc(flux_ids, nflux);
+  for (int f=0; f<nflux; ++f) {
+    flux_ids.h_view(f) = ids[f];
+    flux_names.push_back(sflux_names[ids[f]]);
+  }
+  flux_ids.template modify<HostMemSpace>();
+  flux_ids.template sync<DevExeSpace>();
+  flux_data.assign(nshell*nflux, 0.0);
+
+  // concatenate points on all shells
+  npts = 0;
+  for (auto &shell : shells) {npts += shell->nangles;}
+  int &ng = pm->mb_indcs.ng;
+  Kokkos::realloc(pt_indcs, npts, 4);
+  Kokkos::realloc(pt_wghts, npts, 2*ng, 3);
+  Kokkos::realloc(pt_geom, npts, static_cast<int>(N_PGEOM));
+  Kokkos::realloc(pt_flux, npts, nflux);
+  SetPoints();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SurfaceFluxOutput::SetPoints()
+//! \brief Copies positions, interpolation indices and weights of points on each shell
+//! into arrays spanning all shells, so they can be processed in a single kernel.
+
+void SurfaceFluxOutput::SetPoints() {
+  int nw = pt_wghts.h_view.extent_int(1);
+  int p = 0;
+  for (auto &shell : shells) {
+    for (int n=0; n<shell->nangles; ++n, ++p) {
+      for (int i=0; i<4; ++i) {
+        pt_indcs.h_view(p,i) = shell->interp_indcs.h_view(n,i);
+      }
+      for (int i=0; i<nw; ++i) {
+        for (int d=0; d<3; ++d) {
+          pt_wghts.h_view(p,i,d) = shell->interp_wghts.h_view(n,i,d);
+        }
+      }
+      pt_geom.h_view(p,I_PX) = shell->interp_coord.h_view(n,0);
+      pt_geom.h_view(p,I_PY) = shell->interp_coord.h_view(n,1);
+      pt_geom.h_view(p,I_PZ) = shell->interp_coord.h_view(n,2);
+      pt_geom.h_view(p,I_PR) = shell->radius;
+      pt_geom.h_view(p,I_PTH) = shell->polar_pos.h_view(n,0);
+      pt_geom.h_view(p,I_PPH) = shell->polar_pos.h_view(n,1);
+      pt_geom.h_view(p,I_DOM) = shell->solid_angles.h_view(n);
+    }
+  }
+  pt_indcs.template modify<HostMemSpace>();
+  pt_indcs.template sync<DevExeSpace>();
+  pt_wghts.template modify<HostMemSpace>();
+  pt_wghts.template sync<DevExeSpace>();
+  pt_geom.template modify<HostMemSpace>();
+  pt_geom.template sync<DevExeSpace>();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SurfaceFluxOutput::LoadOutputData()
+//! \brief Interpolates data to all points on all shells and computes the integrands of
+//! each flux in one kernel, then sums integrands on each shell over points and ranks.
+//! Shells are oblate spheroids x = (r cos(ph) - a sin(ph)) sin(th), y = (r sin(ph) +
+//! a cos(ph)) sin(th), z = r cos(th) (with a = 0 except in GR), so the flux of F^mu is
+//! the integral of sqrt(-g) F^i dr/dx^i (r^2 + a^2 cos^2(th)) over solid angle.
+
+void SurfaceFluxOutput::LoadOutputData(Mesh *pm) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+
+  // reset interpolation indices and weights if MeshBlocks have changed with AMR
+  if (pm->adaptive) {
+    for (auto &shell : shells) {
+      shell->SetInterpolationIndices();
+      shell->SetInterpolationWeights();
+    }
+    SetPoints();
+  }
+
+  // radiation moments in coordinate frame, stored in derived_var
+  bool use_rad = false;
+  for (auto &name : flux_names) {
+    if (name.compare("erad") == 0 || name.compare("lrad") == 0) {use_rad = true;}
+  }
+  if (use_rad) {
+    ComputeDerivedVariable("rad_coord", pm);
+  }
+  auto rmom = derived_var;
+
+  // select fluid, and how to compute internal energy from IEN primitive
+  DvceArray5D<Real> w0_, bcc0_;
+  EOS_Data eos;
+  bool is_mhd = false, has_fluid = false;
+  if (pmbp->pmhd != nullptr) {
+    w0_ = pmbp->pmhd->w0;
+    bcc0_ = pmbp->pmhd->bcc0;
+    eos = pmbp->pmhd->peos->eos_data;
+    is_mhd = true; has_fluid = true;
+  } else if (pmbp->phydro != nullptr) {
+    w0_ = pmbp->phydro->w0;
+    eos = pmbp->phydro->peos->eos_data;
+    has_fluid = true;
+  }
+  // IEN stores internal energy density, temperature, or (with DynGRMHD) pressure
+  int ien_type = (pmbp->pdyngr != nullptr)? 2 : ((eos.use_t)? 1 : 0);
+
+  // geometry
+  bool is_rel = (pmbp->pcoord->is_special_relativistic ||
+                 pmbp->pcoord->is_general_relativistic);
+  bool is_dyngr = pmbp->pcoord->is_dynamical_relativistic;
+  bool flat = (pmbp->pcoord->is_special_relativistic ||
+               pmbp->pcoord->coord_data.is_minkowski);
+  Real spin = (is_rel || is_dyngr)? pmbp->pcoord->coord_data.bh_spin : 0.0;
+  if (flat) {spin = 0.0;}
+  DvceArray5D<Real> adm_;
+  if (is_dyngr) {adm_ = pmbp->padm->u_adm;}
+
+  auto &indcs = pm->mb_indcs;
+  int ng = indcs.ng, is = indcs.is, js = indcs.js, ks = indcs.ks;
+  auto ind_ = pt_indcs.d_view;
+  auto wgt_ = pt_wghts.d_view;
+  auto geom_ = pt_geom.d_view;
+  auto ids_ = flux_ids.d_view;
+  auto flx_ = pt_flux.d_view;
+  int nflux_ = nflux;
+
+  par_for("sflux",DevExeSpace(),0,(npts-1),
+  KOKKOS_LAMBDA(int n) {
+    if (ind_(n,0) == -1) {  // point not on this rank
+      for (int f=0; f<nflux_; ++f) {flx_(n,f) = 0.0;}
+      return;
+    }
+    Real x = geom_(n,I_PX), y = geom_(n,I_PY), z = geom_(n,I_PZ);
+    Real r = geom_(n,I_PR), th = geom_(n,I_PTH), ph = geom_(n,I_PPH);
+    Real sth = sin(th), cth = cos(th), sph = sin(ph), cph = cos(ph);
+
+    // dr/dx^i, and dx^i/dphi, on oblate spheroid of radius r
+    Real a2 = SQR(spin);
+    Real rad2 = SQR(x) + SQR(y) + SQR(z);
+    Real drdx[3];
+    drdx[0] = r*x/(2.0*SQR(r) - rad2 + a2);
+    drdx[1] = r*y/(2.0*SQR(r) - rad2 + a2);
+    drdx[2] = (r*z + a2*z/r)/(2.0*SQR(r) - rad2 + a2);
+    Real dxdph[3] = {(-r*sph - spin*cph)*sth, (r*cph - spin*sph)*sth, 0.0};
+    Real jac = (SQR(r) + a2*SQR(cth))*geom_(n,I_DOM);
+
+    // metric
+    Real glower[4][4], gupper[4][4];
+    Real sqrtmg = 1.0;
+    if (is_dyngr) {
+      Real alp = InterpolateToPoint(adm_, adm::ADM::I_ADM_ALPHA, n, ng, is, js, ks,
+                                    ind_, wgt_);
+      Real beta[3], g3[6];
+      for (int d=0; d<3; ++d) {
+        beta[d] = InterpolateToPoint(adm_, adm::ADM::I_ADM_BETAX+d, n, ng, is, js, ks,
+                                     ind_, wgt_);
+      }
+      for (int d=0; d<6; ++d) {
+        g3[d] = InterpolateToPoint(adm_, adm::ADM::I_ADM_GXX+d, n, ng, is, js, ks,
+                                   ind_, wgt_);
+      }
+      Real g4[16], gu4[16];
+      adm::SpacetimeMetric(alp, beta[0], beta[1], beta[2],
+                           g3[0], g3[1], g3[2], g3[3], g3[4], g3[5], g4);
+      adm::SpacetimeUpperMetric(alp, beta[0], beta[1], beta[2],
+                                g3[0], g3[1], g3[2], g3[3], g3[4], g3[5], gu4);
+      for (int a=0; a<4; ++a) {
+        for (int b=0; b<4; ++b) {
+          glower[a][b] = g4[4*a+b];
+          gupper[a][b] = gu4[4*a+b];
+        }
+      }
+      sqrtmg = alp*sqrt(adm::SpatialDet(g3[0], g3[1], g3[2], g3[3], g3[4], g3[5]));
+    } else if (is_rel || use_rad) {
+      ComputeMetricAndInverse(x, y, z, flat, spin, glower, gupper);
+    }
+
+    Real f[N_SFLUX];
+    for (int i=0; i<N_SFLUX; ++i) {f[i] = 0.0;}
+
+    if (has_fluid) {
+      Real w[5];
+      w[0] = InterpolateToPoint(w0_, IDN, n, ng, is, js, ks, ind_, wgt_);
+      for (int d=1; d<4; ++d) {
+        w[d] = InterpolateToPoint(w0_, d, n, ng, is, js, ks, ind_, wgt_);
+      }
+      Real eint = 0.0, pgas = 0.0;
+      if (eos.is_ideal) {
+        w[4] = InterpolateToPoint(w0_, IEN, n, ng, is, js, ks, ind_, wgt_);
+        if (ien_type == 0) {
+          eint = w[4];
+          pgas = (eos.gamma - 1.0)*eint;
+        } else if (ien_type == 1) {
+          pgas = w[0]*w[4];
+          eint = pgas/(eos.gamma - 1.0);
+        } else {
+          pgas = w[4];
+          eint = pgas/(eos.gamma - 1.0);
+        }
+      } else {
+        pgas = w[0]*SQR(eos.iso_cs);
+      }
+      Real bcc[3] = {0.0, 0.0, 0.0};
+      if (is_mhd) {
+        for (int d=0; d<3; ++d) {
+          bcc[d] = InterpolateToPoint(bcc0_, IBX+d, n, ng, is, js, ks, ind_, wgt_);
+        }
+      }
+
+      if (is_rel || is_dyngr) {
+        // u^mu and b^mu from primitives
+        Real q = 0.0;
+        for (int a=1; a<4; ++a) {
+          for (int b=1; b<4; ++b) {q += glower[a][b]*w[a]*w[b];}
+        }
+        Real alpha = sqrt(-1.0/gupper[0][0]);
+        Real lor = sqrt(1.0 + q);
+        Real uu[4];
+        uu[0] = lor/alpha;
+        for (int d=1; d<4; ++d) {uu[d] = w[d] - alpha*lor*gupper[0][d];}
+        Real ul[4];
+        for (int a=0; a<4; ++a) {
+          ul[a] = 0.0;
+          for (int b=0; b<4; ++b) {ul[a] += glower[a][b]*uu[b];}
+        }
+        Real bu[4];
+        bu[0] = ul[1]*bcc[0] + ul[2]*bcc[1] + ul[3]*bcc[2];
+        for (int d=1; d<4; ++d) {bu[d] = (bcc[d-1] + bu[0]*uu[d])/uu[0];}
+        Real bl[4], bsq = 0.0;
+        for (int a=0; a<4; ++a) {
+          bl[a] = 0.0;
+          for (int b=0; b<4; ++b) {bl[a] += glower[a][b]*bu[b];}
+          bsq += bl[a]*bu[a];
+        }
+
+        // radial and azimuthal components
+        Real ur = 0.0, br = 0.0, u_ph = 0.0, b_ph = 0.0;
+        for (int d=0; d<3; ++d) {
+          ur += drdx[d]*uu[d+1];
+          br += drdx[d]*bu[d+1];
+          u_ph += dxdph[d]*ul[d+1];
+          b_ph += dxdph[d]*bl[d+1];
+        }
+        Real wtot = w[0] + eint + pgas + bsq;
+        f[I_MDOT] = -w[0]*ur;
+        f[I_EDOT] = -(wtot*ur*ul[0] - br*bl[0]);
+        f[I_LDOT] = wtot*ur*u_ph - br*b_ph;
+        f[I_PHI] = 0.5*fabs(br*uu[0] - bu[0]*ur);
+      } else {
+        Real vr = 0.0, bnr = 0.0, v_ph = 0.0, b_ph = 0.0, vdotb = 0.0, vsq = 0.0;
+        Real bsq = 0.0;
+        for (int d=0; d<3; ++d) {
+          vr += drdx[d]*w[d+1];
+          bnr += drdx[d]*bcc[d];
+          v_ph += dxdph[d]*w[d+1];
+          b_ph += dxdph[d]*bcc[d];
+          vdotb += w[d+1]*bcc[d];
+          vsq += SQR(w[d+1]);
+          bsq += SQR(bcc[d]);
+        }
+        f[I_MDOT] = -w[0]*vr;
+        f[I_EDOT] = (0.5*w[0]*vsq + eint + pgas + bsq)*vr - bnr*vdotb;
+        f[I_LDOT] = w[0]*vr*v_ph - bnr*b_ph;
+        f[I_PHI] = 0.5*fabs(bnr);
+      }
+    }
+
+    if (use_rad) {
+      // R^{mu nu} stored as r00,r01,r02,r03,r11,r12,r13,r22,r23,r33
+      Real rr[4][4];
+      for (int a=0, ab=0; a<4; ++a) {
+        for (int b=a; b<4; ++b, ++ab) {
+          rr[a][b] = InterpolateToPoint(rmom, ab, n, ng, is, js, ks, ind_, wgt_);
+          rr[b][a] = rr[a][b];
+        }
+      }
+      Real rt = 0.0, rph = 0.0;
+      for (int d=0; d<3; ++d) {
+        for (int b=0; b<4; ++b) {
+          rt += drdx[d]*rr[d+1][b]*glower[b][0];
+          for (int e=0; e<3; ++e) {
+            rph += drdx[d]*rr[d+1][b]*glower[b][e+1]*dxdph[e];
+          }
+        }
+      }
+      f[I_ERAD] = -rt;
+      f[I_LRAD] = rph;
+    }
+
+    for (int i=0; i<nflux_; ++i) {flx_(n,i) = f[ids_(i)]*sqrtmg*jac;}
+  });
+
+  // sum integrands on each shell over points, then over ranks
+  pt_flux.template modify<DevExeSpace>();
+  pt_flux.template sync<HostMemSpace>();
+  int p = 0;
+  for (int s=0; s<nshell; ++s) {
+    for (int i=0; i<nflux; ++i) {flux_data[s*nflux + i] = 0.0;}
+    for (int n=0; n<shells[s]->nangles; ++n, ++p) {
+      for (int i=0; i<nflux; ++i) {flux_data[s*nflux + i] += pt_flux.h_view(p,i);}
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, flux_data.data(), nshell*nflux, MPI_ATHENA_REAL, MPI_SUM,
+               0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(flux_data.data(), flux_data.data(), nshell*nflux, MPI_ATHENA_REAL,
+               MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SurfaceFluxOutput::WriteOutputFile()
+//! \brief Appends one line with fluxes through all shells to file.  There is no limit on
+//! number of columns.
+
+void SurfaceFluxOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(out_params.file_basename);
+    fname.append(".");
+    fname.append(out_params.file_id);
+    fname.append(".flx");
+
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // Write header, if it has not been written already
+    if (!(header_written)) {
+      int iout = 1;
+      std::fprintf(pfile,"# AthenaK surface flux data\n");
+      std::fprintf(pfile,"#  [%d]=time      ", iout++);
+      for (int s=0; s<nshell; ++s) {
+        for (int i=0; i<nflux; ++i) {
+          std::fprintf(pfile,"[%d]=%s_%g    ", iout++, flux_names[i].c_str(),
+                       shells[s]->radius);
+        }
+      }
+      std::fprintf(pfile,"\n");
+      header_written = true;
+    }
+
+    std::fprintf(pfile, out_params.data_format.c_str(), pm->time);
+    for (int n=0; n<nshell*nflux; ++n) {
+      std::fprintf(pfile, out_params.data_format.c_str(), flux_data[n]);
+    }
+    std::fprintf(pfile,"\n");
+    std::fclose(pfile);
+  }
+
+  // increment counters
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
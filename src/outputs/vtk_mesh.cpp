@@ -38,6 +38,14 @@ MeshVTKOutput::MeshVTKOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
   BaseTypeOutput(pin, pm, op) {
   // create new directory for this output. Comments in binary.cpp constructor explain why
   mkdir("vtk",0775);
+  // legacy format can only store a uniform grid, so MeshBlocks on finer levels are not
+  // placed correctly
+  if (pm->multilevel && out_params.gid < 0 && global_variable::my_rank == 0) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Output block '" << out_params.block_name << "' uses vtk file_type "
+              << "with a refined mesh, use vtu file_type to write all levels"
+              << std::endl;
+  }
 }
 
 //----------------------------------------------------------------------------------------
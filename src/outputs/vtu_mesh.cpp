@@ -0,0 +1,276 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file vtu_mesh.cpp
+//! \brief writes mesh data on all (possibly refined) MeshBlocks in VTK XML
+//! UnstructuredGrid (.vtu) format, which can be read directly by ParaView and VisIt.
+//!
+//! Every output cell is written as a VTK_VOXEL, so MeshBlocks at different levels of an
+//! SMR/AMR mesh are stored together in one file, along with the refinement level and
+//! gid of each cell.  All data is written as raw binary in the "appended" section of the
+//! file in the native byte order of the machine (given in the XML header), so no byte
+//! swapping is needed.  Since every MeshBlock contributes the same number of points and
+//! cells, the location of each MeshBlock in every array can be computed from the number
+//! of output MeshBlocks on lower ranks, and all ranks write their data in parallel to
+//! the same file with collective MPI-IO writes through the IOWrapper class.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>      // snprintf()
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+// ctor: also calls BaseTypeOutput base class constructor
+
+MeshVTUOutput::MeshVTUOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+  // create new directory for this output. Comments in binary.cpp constructor explain why
+  mkdir("vtk",0775);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshVTUOutput:::WriteOutputFile(Mesh *pm)
+//! \brief Writes output data on all MeshBlocks to a single VTK XML UnstructuredGrid file.
+//! The file consists of an XML header (written by rank 0) describing each array and its
+//! offset in the appended data, followed by the arrays themselves, each preceded by its
+//! size in bytes as a UInt64:
+//!  1. Points: coordinates of cell corners (each MeshBlock has its own set of points)
+//!  2. Cells: connectivity, offsets, and types of cells
+//!  3. CellData: refinement level, gid, and all output variables
+
+void MeshVTUOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // create filename: "vtk/file_basename"."file_id"."XXXXX".vtu
+  // where XXXXX = 5-digit file_number
+  std::string fname;
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+
+  fname.assign("vtk/");
+  fname.append(out_params.file_basename);
+  fname.append(".");
+  fname.append(out_params.file_id);
+  fname.append(".");
+  fname.append(number);
+  fname.append(".vtu");
+
+  // number of cells and points output on each MeshBlock (the same on all MeshBlocks),
+  // and MeshBlocks on all ranks, and before this rank
+  int nout_vars = outvars.size();
+  int nout_mbs = outmbs.size();
+  int nout1 = 0, nout2 = 0, nout3 = 0;
+  if (nout_mbs > 0) {
+    nout1 = outmbs[0].oie - outmbs[0].ois + 1;
+    nout2 = outmbs[0].oje - outmbs[0].ojs + 1;
+    nout3 = outmbs[0].oke - outmbs[0].oks + 1;
+  }
+#if MPI_PARALLEL_ENABLED
+  int nout[3] = {nout1, nout2, nout3};
+  MPI_Allreduce(MPI_IN_PLACE, nout, 3, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  nout1 = nout[0]; nout2 = nout[1]; nout3 = nout[2];
+#endif
+  std::int64_t ncells_mb = static_cast<std::int64_t>(nout1)*nout2*nout3;
+  std::int64_t npoints_mb = static_cast<std::int64_t>(nout1+1)*(nout2+1)*(nout3+1);
+  std::int64_t nmb_total = std::accumulate(noutmbs.begin(), noutmbs.end(), 0);
+  std::int64_t nmb_before = std::accumulate(noutmbs.begin(),
+                                           noutmbs.begin() + global_variable::my_rank, 0);
+  std::int64_t ncells = nmb_total*ncells_mb;
+  std::int64_t npoints = nmb_total*npoints_mb;
+  if (npoints > std::numeric_limits<std::int32_t>::max() ||
+      8*ncells > std::numeric_limits<std::int32_t>::max()) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Number of cells in output block '" << out_params.block_name
+              << "' too large for vtu file_type, use bin or slices instead" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Size (in bytes, not including UInt64 size header) and offset in appended data of
+  // each array.  Arrays are: points, connectivity, offsets, types, level, gid, then
+  // output variables.
+  int narrays = 6 + nout_vars;
+  std::vector<std::int64_t> elem_size = {3*sizeof(float), 8*sizeof(std::int32_t),
+                                         sizeof(std::int32_t), sizeof(std::uint8_t),
+                                         sizeof(std::int32_t), sizeof(std::int32_t)};
+  elem_size.resize(narrays, sizeof(float));
+  std::vector<std::int64_t> array_size(narrays), array_offset(narrays);
+  std::int64_t offset = 0;
+  for (int n=0; n<narrays; ++n) {
+    array_size[n] = elem_size[n]*((n == 0)? npoints : ncells);
+    array_offset[n] = offset;
+    offset += sizeof(std::uint64_t) + array_size[n];
+  }
+
+  // Create string with XML header
+  std::stringstream msg;
+  msg << "<?xml version=\"1.0\"?>" << std::endl
+      << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+      << (IsBigEndian()? "BigEndian" : "LittleEndian") << "\" header_type=\"UInt64\">"
+      << std::endl << "  <UnstructuredGrid>" << std::endl
+      << "    <FieldData>" << std::endl
+      << std::scientific << std::setprecision(std::numeric_limits<Real>::max_digits10 - 1)
+      << "      <DataArray type=\"Float64\" Name=\"TIME\" NumberOfTuples=\"1\" "
+      << "format=\"ascii\">" << pm->time << "</DataArray>" << std::endl
+      << "      <DataArray type=\"Int32\" Name=\"CYCLE\" NumberOfTuples=\"1\" "
+      << "format=\"ascii\">" << pm->ncycle << "</DataArray>" << std::endl
+      << "    </FieldData>" << std::endl
+      << "    <Piece NumberOfPoints=\"" << npoints << "\" NumberOfCells=\"" << ncells
+      << "\">" << std::endl
+      << "      <Points>" << std::endl
+      << "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" "
+      << "format=\"appended\" offset=\"" << array_offset[0] << "\"/>" << std::endl
+      << "      </Points>" << std::endl
+      << "      <Cells>" << std::endl
+      << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" "
+      << "offset=\"" << array_offset[1] << "\"/>" << std::endl
+      << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" "
+      << "offset=\"" << array_offset[2] << "\"/>" << std::endl
+      << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" "
+      << "offset=\"" << array_offset[3] << "\"/>" << std::endl
+      << "      </Cells>" << std::endl
+      << "      <CellData>" << std::endl
+      << "        <DataArray type=\"Int32\" Name=\"level\" format=\"appended\" "
+      << "offset=\"" << array_offset[4] << "\"/>" << std::endl
+      << "        <DataArray type=\"Int32\" Name=\"gid\" format=\"appended\" "
+      << "offset=\"" << array_offset[5] << "\"/>" << std::endl;
+  for (int n=0; n<nout_vars; ++n) {
+    msg << "        <DataArray type=\"Float32\" Name=\"" << outvars[n].label
+        << "\" format=\"appended\" offset=\"" << array_offset[6+n] << "\"/>" << std::endl;
+  }
+  msg << "      </CellData>" << std::endl
+      << "    </Piece>" << std::endl
+      << "  </UnstructuredGrid>" << std::endl
+      << "  <AppendedData encoding=\"raw\">" << std::endl << "   _";
+  std::string header = msg.str();
+  std::string footer = "\n  </AppendedData>\n</VTKFile>\n";
+  IOWrapperSizeT header_size = header.size();
+
+  IOWrapper vtufile;
+  vtufile.Open(fname.c_str(), IOWrapper::FileMode::write);
+
+  // rank 0 writes XML header, size of each array, and footer
+  if (global_variable::my_rank == 0) {
+    vtufile.Write_any_type_at(header.c_str(), header.size(), 0, "byte");
+    for (int n=0; n<narrays; ++n) {
+      std::uint64_t nbytes = array_size[n];
+      vtufile.Write_any_type_at(&nbytes, sizeof(nbytes), header_size + array_offset[n],
+                                "byte");
+    }
+    vtufile.Write_any_type_at(footer.c_str(), footer.size(), header_size + offset,
+                              "byte");
+  }
+
+  // buffer large enough to hold largest array on this rank
+  std::int64_t max_bytes = 0;
+  for (int n=0; n<narrays; ++n) {
+    max_bytes = std::max(max_bytes, elem_size[n]*((n == 0)? npoints_mb : ncells_mb));
+  }
+  std::vector<char> buffer(max_bytes*nout_mbs);
+  auto &indcs = pm->mb_indcs;
+  std::int32_t root_level = pm->root_level;
+
+  // fill buffer with data of each array on this rank, and write all ranks collectively
+  for (int n=0; n<narrays; ++n) {
+    std::int64_t nelem = (n == 0)? npoints_mb : ncells_mb;
+    for (int m=0; m<nout_mbs; ++m) {
+      auto &mb = outmbs[m];
+      char *pdata = &(buffer[m*nelem*elem_size[n]]);
+      // index of first cell and point of this MeshBlock in file
+      std::int64_t cell0 = (nmb_before + m)*ncells_mb;
+      std::int64_t point0 = (nmb_before + m)*npoints_mb;
+      if (n == 0) {
+        // points at corners of cells.  Indices ois,ojs,oks are relative to array
+        // including ghost zones, while mesh size refers to first active cell is,js,ks.
+        float *pts = reinterpret_cast<float*>(pdata);
+        Real dx1 = (mb.x1max - mb.x1min)/static_cast<Real>(indcs.nx1);
+        Real dx2 = (mb.x2max - mb.x2min)/static_cast<Real>(indcs.nx2);
+        Real dx3 = (mb.x3max - mb.x3min)/static_cast<Real>(indcs.nx3);
+        for (int k=0; k<=nout3; ++k) {
+          for (int j=0; j<=nout2; ++j) {
+            for (int i=0; i<=nout1; ++i) {
+              *pts++ = static_cast<float>(mb.x1min + (mb.ois + i - indcs.is)*dx1);
+              *pts++ = static_cast<float>(mb.x2min + (mb.ojs + j - indcs.js)*dx2);
+              *pts++ = static_cast<float>(mb.x3min + (mb.oks + k - indcs.ks)*dx3);
+            }
+          }
+        }
+      } else if (n == 1) {
+        // connectivity of voxels, in VTK_VOXEL order (i fastest, then j, then k)
+        std::int32_t *conn = reinterpret_cast<std::int32_t*>(pdata);
+        std::int32_t sj = nout1 + 1, sk = (nout1 + 1)*(nout2 + 1);
+        for (int k=0; k<nout3; ++k) {
+          for (int j=0; j<nout2; ++j) {
+            for (int i=0; i<nout1; ++i) {
+              std::int32_t p = static_cast<std::int32_t>(point0) + i + j*sj + k*sk;
+              *conn++ = p;
+              *conn++ = p + 1;
+              *conn++ = p + sj;
+              *conn++ = p + sj + 1;
+              *conn++ = p + sk;
+              *conn++ = p + sk + 1;
+              *conn++ = p + sk + sj;
+              *conn++ = p + sk + sj + 1;
+            }
+          }
+        }
+      } else if (n == 2) {
+        std::int32_t *offs = reinterpret_cast<std::int32_t*>(pdata);
+        for (std::int64_t c=0; c<ncells_mb; ++c) {
+          offs[c] = static_cast<std::int32_t>(8*(cell0 + c + 1));
+        }
+      } else if (n == 3) {
+        std::uint8_t *types = reinterpret_cast<std::uint8_t*>(pdata);
+        for (std::int64_t c=0; c<ncells_mb; ++c) {types[c] = 11;}  // VTK_VOXEL
+      } else if (n == 4 || n == 5) {
+        std::int32_t val = (n == 4)? (pm->lloc_eachmb[mb.mb_gid].level - root_level) :
+                                     mb.mb_gid;
+        std::int32_t *ival = reinterpret_cast<std::int32_t*>(pdata);
+        for (std::int64_t c=0; c<ncells_mb; ++c) {ival[c] = val;}
+      } else {
+        float *fval = reinterpret_cast<float*>(pdata);
+        for (int k=0; k<nout3; ++k) {
+          for (int j=0; j<nout2; ++j) {
+            for (int i=0; i<nout1; ++i) {
+              *fval++ = static_cast<float>(outarray(n-6,m,k,j,i));
+            }
+          }
+        }
+      }
+    }
+    IOWrapperSizeT myoffset = header_size + array_offset[n] + sizeof(std::uint64_t) +
+                              elem_size[n]*nelem*nmb_before;
+    IOWrapperSizeT nbytes = elem_size[n]*nelem*nout_mbs;
+    if (noutmbs_min > 0) {
+      vtufile.Write_any_type_at_all(buffer.data(), nbytes, myoffset, "byte");
+    } else if (nout_mbs > 0) {
+      vtufile.Write_any_type_at(buffer.data(), nbytes, myoffset, "byte");
+    }
+  }
+  vtufile.Close();
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
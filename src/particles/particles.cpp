@@ -9,12 +9,15 @@
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "bvals/bvals.hpp"
+#include "utils/memory_usage.hpp"
 #include "particles.hpp"
 
 namespace particles {
@@ -22,6 +25,7 @@ namespace particles {
 // constructor, initializes data structures and parameters
 
 Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
+    mflx("mflx",1,1,1,1),
     pmy_pack(ppack) {
   // check this is at least a 2D problem
   if (pmy_pack->pmesh->one_d) {
@@ -45,6 +49,8 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     std::string ptype = pin->GetString("particles","particle_type");
     if (ptype.compare("cosmic_ray") == 0) {
       particle_type = ParticleType::cosmic_ray;
+    } else if (ptype.compare("tracer") == 0) {
+      particle_type = ParticleType::tracer;
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "Particle type = '" << ptype << "' not recognized"
@@ -58,6 +64,10 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     std::string ppush = pin->GetString("particles","pusher");
     if (ppush.compare("drift") == 0) {
       pusher = ParticlesPusher::drift;
+    } else if (ppush.compare("lagrangian_tracer") == 0) {
+      pusher = ParticlesPusher::lagrangian_tracer;
+    } else if (ppush.compare("lagrangian_mc") == 0) {
+      pusher = ParticlesPusher::lagrangian_mc;
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "Particle pusher must be specified in <particles> block"
@@ -66,6 +76,22 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     }
   }
 
+  // tracer particles require tracer pushers and a fluid to follow
+  bool tracer_pusher = (pusher == ParticlesPusher::lagrangian_tracer ||
+                        pusher == ParticlesPusher::lagrangian_mc);
+  if ((particle_type == ParticleType::tracer) != tracer_pusher) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Pushers lagrangian_tracer and lagrangian_mc must be used with (only) "
+              << "particle_type = tracer" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (tracer_pusher && (pmy_pack->phydro == nullptr) && (pmy_pack->pmhd == nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Tracer particles require <hydro> or <mhd> block in input file"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
   // set dimensions of particle arrays. Note particles only work in 2D/3D
   if (pmy_pack->pmesh->one_d) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -81,14 +107,51 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
         nidata = 2;
         break;
       }
+    // tracers store position and velocity at start of step in 3D layout, even in 2D
+    case ParticleType::tracer:
+      {
+        nrdata = 6;
+        nidata = 2;
+        break;
+      }
     default:
       break;
   }
   Kokkos::realloc(prtcl_rdata, nrdata, nprtcl_thispack);
   Kokkos::realloc(prtcl_idata, nidata, nprtcl_thispack);
+  // time step is set by problem generator, or by the fluid for tracers
+  dtnew = static_cast<Real>(std::numeric_limits<float>::max());
+
+  // Monte Carlo tracers need mass fluxes across faces accumulated over all stages, and
+  // random numbers (with a different seed on each rank)
+  if (pusher == ParticlesPusher::lagrangian_mc) {
+    int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(mflx.x1f, nmb, ncells3, ncells2, ncells1);
+    Kokkos::realloc(mflx.x2f, nmb, ncells3, ncells2, ncells1);
+    Kokkos::realloc(mflx.x3f, nmb, ncells3, ncells2, ncells1);
+    // On restarts the seed also depends on the cycle number, since the state of the
+    // pool cannot be restored when the number of ranks or threads changes
+    int seed = pin->GetOrAddInteger("particles","random_seed",1);
+    uint64_t seed64 = static_cast<uint64_t>(seed + global_variable::my_rank) +
+                      static_cast<uint64_t>(global_variable::nranks)*
+                      static_cast<uint64_t>(pmy_pack->pmesh->ncycle);
+    rand_pool64 = Kokkos::Random_XorShift64_Pool<>(seed64);
+    memory_usage::TrackArrays("Particles", mflx);
+  }
 
   // allocate boundary object
   pbval_part = new ParticlesBoundaryValues(this, pin);
+
+  // register arrays for memory accounting
+  memory_usage::TrackArrays("Particles", prtcl_rdata, prtcl_idata, pbval_part->sendlist);
+#if MPI_PARALLEL_ENABLED
+  memory_usage::TrackArrays("Particles", pbval_part->prtcl_rsendbuf,
+                            pbval_part->prtcl_rrecvbuf, pbval_part->prtcl_isendbuf,
+                            pbval_part->prtcl_irecvbuf);
+#endif
 }
 
 //----------------------------------------------------------------------------------------
@@ -137,4 +200,56 @@ void Particles::CreateParticleTags(ParameterInput *pin) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::Redistribute()
+//! \brief Sends each particle to the rank that owns the MeshBlock with the GID stored in
+//! the particle.  Used on restarts, since particles are read from the restart file in
+//! equal chunks on each rank regardless of which MeshBlocks the rank owns.
+
+void Particles::Redistribute() {
+  Mesh *pm = pmy_pack->pmesh;
+#if MPI_PARALLEL_ENABLED
+  // load sendlist with all particles in MeshBlocks on other ranks
+  int &myrank = global_variable::my_rank;
+  auto idata_h = Kokkos::create_mirror_view(prtcl_idata);
+  Kokkos::deep_copy(idata_h, prtcl_idata);
+  int nsend = 0;
+  for (int p=0; p<nprtcl_thispack; ++p) {
+    if (pm->rank_eachmb[idata_h(PGID,p)] != myrank) {++nsend;}
+  }
+  auto &sendlist = pbval_part->sendlist;
+  Kokkos::realloc(sendlist, nsend);
+  int n = 0;
+  for (int p=0; p<nprtcl_thispack; ++p) {
+    int gid = idata_h(PGID,p);
+    if (pm->rank_eachmb[gid] != myrank) {
+      sendlist.h_view(n).prtcl_indx = p;
+      sendlist.h_view(n).dest_gid = gid;
+      sendlist.h_view(n).dest_rank = pm->rank_eachmb[gid];
+      ++n;
+    }
+  }
+  pbval_part->nprtcl_send = nsend;
+  sendlist.template modify<HostMemSpace>();
+  sendlist.template sync<DevExeSpace>();
+
+  // communicate particles with same functions used in particle task list
+  (void) pbval_part->CountSendsAndRecvs();
+  (void) pbval_part->InitPrtclRecv();
+  (void) pbval_part->PackAndSendPrtcls();
+  while (pbval_part->RecvAndUnpackPrtcls() == TaskStatus::incomplete) {}
+  (void) pbval_part->ClearPrtclSend();
+  (void) pbval_part->ClearPrtclRecv();
+#else
+  pm->nprtcl_thisrank = nprtcl_thispack;
+  pm->nprtcl_eachrank[0] = nprtcl_thispack;
+#endif
+
+  pm->nprtcl_total = 0;
+  for (int r=0; r<global_variable::nranks; ++r) {
+    pm->nprtcl_total += pm->nprtcl_eachrank[r];
+  }
+  return;
+}
+
 } // namespace particles
@@ -7,11 +7,23 @@
 //========================================================================================
 //! \file particles.hpp
 //  \brief definitions for Particles class
+//
+//  Tracer particles (particle_type = tracer) follow the Hydro or MHD fluid with either
+//    lagrangian_tracer: positions advanced with the fluid velocity interpolated (CIC) to
+//                       the particle, with the second-order (Heun) predictor-corrector
+//                       method using velocities at the start and end of the time step
+//    lagrangian_mc:     Monte Carlo tracers which jump to a neighboring cell with
+//                       probability equal to the fraction of the cell mass that flows
+//                       through each face in the time step (Genel et al. 2013, MNRAS 435,
+//                       1426), using the face mass fluxes of the fluid integrator
+//  Both are pushed in the "after_timeintegrator" task list, once the fluid is updated.
 
 #include <map>
 #include <memory>
 #include <string>
 
+#include <Kokkos_Random.hpp>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
@@ -23,13 +35,15 @@
 enum class ParticlesPusher {drift, leap_frog, lagrangian_tracer, lagrangian_mc};
 
 // constants that enumerate ParticleTypes
-enum class ParticleType {cosmic_ray};
+enum class ParticleType {cosmic_ray, tracer};
 
 //----------------------------------------------------------------------------------------
 //! \struct ParticlesTaskIDs
 //  \brief container to hold TaskIDs of all particles tasks
 
 struct ParticlesTaskIDs {
+  TaskID tvel;
+  TaskID mflux;
   TaskID push;
   TaskID newgid;
   TaskID count;
@@ -64,6 +78,10 @@ class Particles {
 
   ParticlesPusher pusher;
 
+  // face mass fluxes integrated over the time step, and random numbers (MC tracers)
+  DvceFaceFld4D<Real> mflx;
+  Kokkos::Random_XorShift64_Pool<> rand_pool64;
+
   // Boundary communication buffers and functions for particles
   ParticlesBoundaryValues *pbval_part;
 
@@ -72,7 +90,10 @@ class Particles {
 
   // functions...
   void CreateParticleTags(ParameterInput *pin);
+  void Redistribute();
   void AssembleTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
+  TaskStatus TracerVelocity(Driver *pdriver, int stage);
+  TaskStatus MassFlux(Driver *pdriver, int stage);
   TaskStatus Push(Driver *pdriver, int stage);
   TaskStatus NewGID(Driver *pdriver, int stage);
   TaskStatus SendCnt(Driver *pdriver, int stage);
@@ -84,6 +105,9 @@ class Particles {
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Particles
+
+  void PushLagrangianTracer();
+  void PushLagrangianMC();
 };
 
 } // namespace particles
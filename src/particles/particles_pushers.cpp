@@ -4,14 +4,66 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file particle_pushers.cpp
-//  \brief
+//  \brief functions that advance particle positions, including tracer particles that
+//  follow the Hydro or MHD fluid
+
+#include <Kokkos_Random.hpp>
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
 #include "particles.hpp"
 
 namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn Real InterpolateCC()
+//! \brief Cloud-in-cell (bi/trilinear) interpolation of cell-centered variable n in
+//! MeshBlock m to position (x1,x2,x3).  Uses ghost cells, so position may lie up to ng-1
+//! cells outside the MeshBlock.
+
+KOKKOS_INLINE_FUNCTION
+Real InterpolateCC(const DvceArray5D<Real> &a, const int m, const int n,
+                   const RegionSize &size, const RegionIndcs &indcs,
+                   const bool multi_d, const bool three_d,
+                   const Real x1, const Real x2, const Real x3) {
+  // lowest and highest index of lower-left cell of interpolation stencil
+  int ilo = indcs.is - indcs.ng, ihi = indcs.ie + indcs.ng - 1;
+  int jlo = indcs.js - indcs.ng, jhi = indcs.je + indcs.ng - 1;
+  int klo = indcs.ks - indcs.ng, khi = indcs.ke + indcs.ng - 1;
+
+  Real xi = (x1 - size.x1min)/size.dx1 - 0.5 + indcs.is;
+  int i0 = static_cast<int>(floor(xi));
+  i0 = (i0 < ilo)? ilo : ((i0 > ihi)? ihi : i0);
+  Real wx = fmin(fmax(xi - i0, 0.0), 1.0);
+
+  int j0 = indcs.js, j1 = indcs.js;
+  Real wy = 0.0;
+  if (multi_d) {
+    Real xj = (x2 - size.x2min)/size.dx2 - 0.5 + indcs.js;
+    j0 = static_cast<int>(floor(xj));
+    j0 = (j0 < jlo)? jlo : ((j0 > jhi)? jhi : j0);
+    j1 = j0 + 1;
+    wy = fmin(fmax(xj - j0, 0.0), 1.0);
+  }
+
+  int k0 = indcs.ks, k1 = indcs.ks;
+  Real wz = 0.0;
+  if (three_d) {
+    Real xk = (x3 - size.x3min)/size.dx3 - 0.5 + indcs.ks;
+    k0 = static_cast<int>(floor(xk));
+    k0 = (k0 < klo)? klo : ((k0 > khi)? khi : k0);
+    k1 = k0 + 1;
+    wz = fmin(fmax(xk - k0, 0.0), 1.0);
+  }
+
+  return (1.0-wz)*((1.0-wy)*((1.0-wx)*a(m,n,k0,j0,i0) + wx*a(m,n,k0,j0,i0+1)) +
+                        wy *((1.0-wx)*a(m,n,k0,j1,i0) + wx*a(m,n,k0,j1,i0+1))) +
+              wz *((1.0-wy)*((1.0-wx)*a(m,n,k1,j0,i0) + wx*a(m,n,k1,j0,i0+1)) +
+                        wy *((1.0-wx)*a(m,n,k1,j1,i0) + wx*a(m,n,k1,j1,i0+1)));
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  void Particles::ParticlesPush
 //  \brief
@@ -49,6 +101,12 @@ TaskStatus Particles::Push(Driver *pdriver, int stage) {
         }
       });
 
+    break;
+  case ParticlesPusher::lagrangian_tracer:
+    PushLagrangianTracer();
+    break;
+  case ParticlesPusher::lagrangian_mc:
+    PushLagrangianMC();
     break;
   default:
     break;
@@ -56,4 +114,202 @@ TaskStatus Particles::Push(Driver *pdriver, int stage) {
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Particles::TracerVelocity
+//  \brief Stores fluid velocity at position of each tracer at start of time step.  Called
+//  in "before_timeintegrator" task list.
+
+TaskStatus Particles::TracerVelocity(Driver *pdriver, int stage) {
+  auto indcs = pmy_pack->pmesh->mb_indcs;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto gids = pmy_pack->gids;
+  auto &w0 = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->w0 : pmy_pack->pmhd->w0;
+
+  par_for("tracer_vel",DevExeSpace(),0,(nprtcl_thispack-1),
+  KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - gids;
+    Real x1 = pr(IPX,p), x2 = pr(IPY,p), x3 = pr(IPZ,p);
+    pr(IPVX,p) = InterpolateCC(w0, m, IVX, mbsize.d_view(m), indcs, multi_d, three_d,
+                               x1, x2, x3);
+    pr(IPVY,p) = InterpolateCC(w0, m, IVY, mbsize.d_view(m), indcs, multi_d, three_d,
+                               x1, x2, x3);
+    pr(IPVZ,p) = InterpolateCC(w0, m, IVZ, mbsize.d_view(m), indcs, multi_d, three_d,
+                               x1, x2, x3);
+  });
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Particles::PushLagrangianTracer
+//  \brief Advances tracers with the velocity v0 stored at the start of the step, and the
+//  velocity at the end of the step interpolated to the predicted position:
+//    x* = x + dt v0(x),   x^{n+1} = x + 0.5 dt (v0(x) + v1(x*))
+
+void Particles::PushLagrangianTracer() {
+  auto indcs = pmy_pack->pmesh->mb_indcs;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto dt_ = (pmy_pack->pmesh->dt);
+  auto gids = pmy_pack->gids;
+  auto &w0 = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->w0 : pmy_pack->pmhd->w0;
+
+  par_for("tracer_push",DevExeSpace(),0,(nprtcl_thispack-1),
+  KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - gids;
+    // predictor
+    Real x1 = pr(IPX,p) + dt_*pr(IPVX,p);
+    Real x2 = (multi_d)? pr(IPY,p) + dt_*pr(IPVY,p) : pr(IPY,p);
+    Real x3 = (three_d)? pr(IPZ,p) + dt_*pr(IPVZ,p) : pr(IPZ,p);
+    // corrector
+    pr(IPX,p) += 0.5*dt_*(pr(IPVX,p) + InterpolateCC(w0, m, IVX, mbsize.d_view(m), indcs,
+                                                     multi_d, three_d, x1, x2, x3));
+    if (multi_d) {
+      pr(IPY,p) += 0.5*dt_*(pr(IPVY,p) + InterpolateCC(w0, m, IVY, mbsize.d_view(m),
+                                                       indcs, multi_d, three_d,
+                                                       x1, x2, x3));
+    }
+    if (three_d) {
+      pr(IPZ,p) += 0.5*dt_*(pr(IPVZ,p) + InterpolateCC(w0, m, IVZ, mbsize.d_view(m),
+                                                       indcs, multi_d, three_d,
+                                                       x1, x2, x3));
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Particles::MassFlux
+//  \brief Accumulates mass fluxes across faces over the stages of the time integrator,
+//  using same weights as the update of the conserved variables, so that after the last
+//  stage mflx holds the mass per unit area that crossed each face in the time step.
+
+TaskStatus Particles::MassFlux(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  Real gam0 = pdriver->gam0[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  auto &uflx = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->uflx :
+                                              pmy_pack->pmhd->uflx;
+  auto &flx1 = uflx.x1f;
+  auto &mflx1 = mflx.x1f;
+  par_for("mflx1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    mflx1(m,k,j,i) = gam0*mflx1(m,k,j,i) + beta_dt*flx1(m,IDN,k,j,i);
+  });
+  if (pmy_pack->pmesh->one_d) {return TaskStatus::complete;}
+
+  auto &flx2 = uflx.x2f;
+  auto &mflx2 = mflx.x2f;
+  par_for("mflx2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    mflx2(m,k,j,i) = gam0*mflx2(m,k,j,i) + beta_dt*flx2(m,IDN,k,j,i);
+  });
+  if (pmy_pack->pmesh->two_d) {return TaskStatus::complete;}
+
+  auto &flx3 = uflx.x3f;
+  auto &mflx3 = mflx.x3f;
+  par_for("mflx3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    mflx3(m,k,j,i) = gam0*mflx3(m,k,j,i) + beta_dt*flx3(m,IDN,k,j,i);
+  });
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Particles::PushLagrangianMC
+//  \brief Moves each Monte Carlo tracer to the center of a neighboring cell with
+//  probability equal to the fraction of the mass in its cell at the start of the step
+//  that left through each face.  The mass at the start of the step is recovered from the
+//  updated density and the net mass flux, so density source terms are not accounted for.
+
+void Particles::PushLagrangianMC() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  bool multi_d = pmy_pack->pmesh->multi_d;
+  bool three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto gids = pmy_pack->gids;
+  auto &u0 = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->u0 : pmy_pack->pmhd->u0;
+  auto &mflx1 = mflx.x1f;
+  auto &mflx2 = mflx.x2f;
+  auto &mflx3 = mflx.x3f;
+  auto rand_pool = rand_pool64;
+
+  par_for("mc_push",DevExeSpace(),0,(nprtcl_thispack-1),
+  KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - gids;
+    auto &size = mbsize.d_view(m);
+    int i = static_cast<int>(floor((pr(IPX,p) - size.x1min)/size.dx1)) + is;
+    int j = js, k = ks;
+    if (multi_d) {
+      j = static_cast<int>(floor((pr(IPY,p) - size.x2min)/size.dx2)) + js;
+    }
+    if (three_d) {
+      k = static_cast<int>(floor((pr(IPZ,p) - size.x3min)/size.dx3)) + ks;
+    }
+    i = (i < is)? is : ((i > ie)? ie : i);
+    j = (j < js)? js : ((j > je)? je : j);
+    k = (k < ks)? ks : ((k > ke)? ke : k);
+
+    // outgoing mass through each face, and density at start of step (per unit volume)
+    Real out[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    Real d_old = u0(m,IDN,k,j,i);
+    out[0] = fmax(-mflx1(m,k,j,i), 0.0)/size.dx1;
+    out[1] = fmax( mflx1(m,k,j,i+1), 0.0)/size.dx1;
+    d_old += (mflx1(m,k,j,i+1) - mflx1(m,k,j,i))/size.dx1;
+    if (multi_d) {
+      out[2] = fmax(-mflx2(m,k,j,i), 0.0)/size.dx2;
+      out[3] = fmax( mflx2(m,k,j+1,i), 0.0)/size.dx2;
+      d_old += (mflx2(m,k,j+1,i) - mflx2(m,k,j,i))/size.dx2;
+    }
+    if (three_d) {
+      out[4] = fmax(-mflx3(m,k,j,i), 0.0)/size.dx3;
+      out[5] = fmax( mflx3(m,k+1,j,i), 0.0)/size.dx3;
+      d_old += (mflx3(m,k+1,j,i) - mflx3(m,k,j,i))/size.dx3;
+    }
+    if (d_old <= 0.0) return;
+
+    // choose face (if any) with probabilities out[n]/d_old
+    auto rand_gen = rand_pool.get_state();
+    Real r = rand_gen.drand()*d_old;
+    rand_pool.free_state(rand_gen);
+    int face = -1;
+    Real sum = 0.0;
+    for (int n=0; n<6; ++n) {
+      sum += out[n];
+      if (r < sum) {
+        face = n;
+        break;
+      }
+    }
+
+    // move to center of neighboring cell
+    if (face == 0 || face == 1) {
+      int di = (face == 0)? -1 : 1;
+      pr(IPX,p) = size.x1min + (i - is + di + 0.5)*size.dx1;
+    } else if (face == 2 || face == 3) {
+      int dj = (face == 2)? -1 : 1;
+      pr(IPY,p) = size.x2min + (j - js + dj + 0.5)*size.dx2;
+    } else if (face == 4 || face == 5) {
+      int dk = (face == 4)? -1 : 1;
+      pr(IPZ,p) = size.x3min + (k - ks + dk + 0.5)*size.dx3;
+    }
+  });
+  return;
+}
 } // namespace particles
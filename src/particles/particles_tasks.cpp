@@ -17,6 +17,8 @@
 #include "tasklist/task_list.hpp"
 #include "mesh/mesh.hpp"
 #include "bvals/bvals.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
 #include "particles.hpp"
 
 namespace particles {
@@ -28,15 +30,38 @@ namespace particles {
 void Particles::AssembleTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
   TaskID none(0);
 
-  // particle integration done in "before_timeintegrator" task list
-  id.push   = tl["before_timeintegrator"]->AddTask(&Particles::Push, this, none);
-  id.newgid = tl["before_timeintegrator"]->AddTask(&Particles::NewGID, this, id.push);
-  id.count  = tl["before_timeintegrator"]->AddTask(&Particles::SendCnt, this, id.newgid);
-  id.irecv  = tl["before_timeintegrator"]->AddTask(&Particles::InitRecv, this, id.count);
-  id.sendp  = tl["before_timeintegrator"]->AddTask(&Particles::SendP, this, id.irecv);
-  id.recvp  = tl["before_timeintegrator"]->AddTask(&Particles::RecvP, this, id.sendp);
-  id.crecv  = tl["before_timeintegrator"]->AddTask(&Particles::ClearRecv, this, id.recvp);
-  id.csend  = tl["before_timeintegrator"]->AddTask(&Particles::ClearSend, this, id.crecv);
+  // tracers are pushed after fluid is updated, in "after_timeintegrator" task list.
+  // Velocity tracers store fluid velocity at start of step, and Monte Carlo tracers
+  // accumulate mass fluxes after they are computed (and corrected) in each stage.
+  std::string tl_push = "before_timeintegrator";
+  if (pusher == ParticlesPusher::lagrangian_tracer) {
+    tl_push = "after_timeintegrator";
+    id.tvel = tl["before_timeintegrator"]->AddTask(&Particles::TracerVelocity, this, none,
+                                                   "Particles::TracerVelocity");
+  } else if (pusher == ParticlesPusher::lagrangian_mc) {
+    tl_push = "after_timeintegrator";
+    TaskID &recvf = (pmy_pack->phydro != nullptr)? pmy_pack->phydro->id.recvf :
+                                                   pmy_pack->pmhd->id.recvf;
+    id.mflux = tl["stagen"]->AddTask(&Particles::MassFlux, this, recvf,
+                                     "Particles::MassFlux");
+  }
+
+  // particle integration done in "before_timeintegrator" task list (or after for tracers)
+  id.push   = tl[tl_push]->AddTask(&Particles::Push, this, none, "Particles::Push");
+  id.newgid = tl[tl_push]->AddTask(&Particles::NewGID, this, id.push,
+                                   "Particles::NewGID");
+  id.count  = tl[tl_push]->AddTask(&Particles::SendCnt, this, id.newgid,
+                                   "Particles::SendCnt");
+  id.irecv  = tl[tl_push]->AddTask(&Particles::InitRecv, this, id.count,
+                                   "Particles::InitRecv");
+  id.sendp  = tl[tl_push]->AddTask(&Particles::SendP, this, id.irecv,
+                                   "Particles::SendP");
+  id.recvp  = tl[tl_push]->AddTask(&Particles::RecvP, this, id.sendp,
+                                   "Particles::RecvP");
+  id.crecv  = tl[tl_push]->AddTask(&Particles::ClearRecv, this, id.recvp,
+                                   "Particles::ClearRecv");
+  id.csend  = tl[tl_push]->AddTask(&Particles::ClearSend, this, id.crecv,
+                                   "Particles::ClearSend");
 
   return;
 }
@@ -8,25 +8,68 @@
 //! Default constructor calls problem generator function, while  constructor for restarts
 //! reads data from restart file, as well as re-initializing problem-specific data.
 
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <utility>
 #include <algorithm>
+#include <vector>
 
 #include "athena.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
+#include "mesh/meshblock_tree.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "coordinates/adm.hpp"
 #include "z4c/compact_object_tracker.hpp"
 #include "z4c/z4c.hpp"
 #include "radiation/radiation.hpp"
+#include "m1/m1.hpp"
+#include "particles/particles.hpp"
 #include "srcterms/turb_driver.hpp"
 #include "pgen.hpp"
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn // logical index of position x among nx MeshBlocks spanning [xmin,xmax]
+std::int32_t LogicalIndex(Real x, Real xmin, Real xmax, std::int32_t nx) {
+  auto l = static_cast<std::int32_t>(std::floor(nx*(x - xmin)/(xmax - xmin)));
+  return std::min(std::max(l, 0), nx-1);
+}
+
+int FindParticleGID(Mesh *pm, MeshBlockTree *ptree, Real x1, Real x2, Real x3) {
+  auto &ms = pm->mesh_size;
+  for (int lev=pm->root_level; lev<=pm->max_level; ++lev) {
+    int shift = lev - pm->root_level;
+    LogicalLocation lloc;
+    lloc.level = lev;
+    lloc.lx1 = LogicalIndex(x1, ms.x1min, ms.x1max, pm->nmb_rootx1 << shift);
+    lloc.lx2 = 0;
+    lloc.lx3 = 0;
+    if (pm->multi_d) {
+      lloc.lx2 = LogicalIndex(x2, ms.x2min, ms.x2max, pm->nmb_rootx2 << shift);
+    }
+    if (pm->three_d) {
+      lloc.lx3 = LogicalIndex(x3, ms.x3min, ms.x3max, pm->nmb_rootx3 << shift);
+    }
+    // nodes above the leaf have gid=-1, nodes below it do not exist
+    MeshBlockTree *pnode = ptree->FindMeshBlock(lloc);
+    if (pnode == nullptr) break;
+    if (pnode->GetGID() >= 0) return pnode->GetGID();
+  }
+  std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+            << "No MeshBlock found containing particle at (" << x1 << "," << x2 << ","
+            << x3 << ") in remeshed restart" << std::endl;
+  std::exit(EXIT_FAILURE);
+  return -1;
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 // default constructor, calls pgen function.
 
@@ -58,6 +101,8 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
     AlfvenWave(pin, false);
   } else if (pgen_fun_name.compare("gr_bondi") == 0) {
     BondiAccretion(pin, false);
+  } else if (pgen_fun_name.compare("binary_ks") == 0) {
+    BinaryKS(pin, false);
   } else if (pgen_fun_name.compare("tetrad") == 0) {
     CheckOrthonormalTetrad(pin, false);
   } else if (pgen_fun_name.compare("hohlraum") == 0) {
@@ -72,14 +117,32 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm) :
     OrszagTang(pin, false);
   } else if (pgen_fun_name.compare("rad_linear_wave") == 0) {
     RadiationLinearWave(pin, false);
+  } else if (pgen_fun_name.compare("rad_relax") == 0) {
+    RadiationRelaxation(pin, false);
   } else if (pgen_fun_name.compare("shock_tube") == 0) {
     ShockTube(pin, false);
   } else if (pgen_fun_name.compare("z4c_linear_wave") == 0) {
     Z4cLinearWave(pin, false);
+  } else if (pgen_fun_name.compare("z4c_one_puncture") == 0) {
+    Z4cOnePuncture(pin, false);
   } else if (pgen_fun_name.compare("spherical_collapse") == 0) {
     SphericalCollapse(pin, false);
   } else if (pgen_fun_name.compare("diffusion") == 0) {
     Diffusion(pin, false);
+  } else if (pgen_fun_name.compare("jeans") == 0) {
+    JeansInstability(pin, false);
+  } else if (pgen_fun_name.compare("uniform_sphere") == 0) {
+    UniformSphere(pin, false);
+  } else if (pgen_fun_name.compare("disk_slab") == 0) {
+    DiskSlab(pin, false);
+  } else if (pgen_fun_name.compare("conduction_ring") == 0) {
+    ConductionRing(pin, false);
+  } else if (pgen_fun_name.compare("tracers") == 0) {
+    Tracers(pin, false);
+  } else if (pgen_fun_name.compare("m1_tests") == 0) {
+    M1Tests(pin, false);
+  } else if (pgen_fun_name.compare("nonideal_mhd") == 0) {
+    NonIdealMHD(pin, false);
   // else, name not set on command line or input file, print warning and quit
   } else {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -145,7 +208,9 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   user_hist = pin->GetOrAddBoolean("problem","user_hist",false);
 
   // get spatial dimensions of arrays, including ghost zones
-  auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
+  // When restart has been remeshed, data in file is stored in MeshBlocks of old size
+  bool remesh = (pm->prst_mesh != nullptr);
+  auto &indcs = (remesh)? pm->prst_mesh->mb_indcs : pm->pmb_pack->pmesh->mb_indcs;
   int nout1 = indcs.nx1 + 2*(indcs.ng);
   int nout2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
   int nout3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
@@ -156,8 +221,9 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   adm::ADM* padm = pm->pmb_pack->padm;
   z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
   radiation::Radiation* prad=pm->pmb_pack->prad;
+  m1::M1* pm1=pm->pmb_pack->pm1;
   TurbulenceDriver* pturb=pm->pmb_pack->pturb;
-  int nrad = 0, nhydro = 0, nmhd = 0, nforce = 3, nadm = 0, nz4c = 0;
+  int nrad = 0, nm1 = 0, nhydro = 0, nmhd = 0, nforce = 3, nadm = 0, nz4c = 0;
   if (phydro != nullptr) {
     nhydro = phydro->nhydro + phydro->nscalars;
   }
@@ -165,7 +231,10 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     nmhd = pmhd->nmhd + pmhd->nscalars;
   }
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nfrang;
+  }
+  if (pm1 != nullptr) {
+    nm1 = (pm1->nspecies)*(pm1->nvars);
   }
   if (pz4c != nullptr) {
     nz4c = pz4c->nz4c;
@@ -207,11 +276,11 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   }
 
   if (pturb != nullptr) {
-    // root process reads size the random seed
-    char *rng_data = new char[sizeof(RNG_State)];
+    // root process reads key of counter-based RNG
+    char *rng_data = new char[sizeof(RNG_Key)];
 
     if (global_variable::my_rank == 0) { // the master process reads the variables data
-      if (resfile.Read_bytes(rng_data, 1, sizeof(RNG_State)) != sizeof(RNG_State)) {
+      if (resfile.Read_bytes(rng_data, 1, sizeof(RNG_Key)) != sizeof(RNG_Key)) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                   << std::endl << "RNG data size read from restart file is incorrect, "
                   << "restart file is broken." << std::endl;
@@ -221,9 +290,9 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
 
 #if MPI_PARALLEL_ENABLED
     // then broadcast the RNG information
-    MPI_Bcast(rng_data, sizeof(RNG_State), MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(rng_data, sizeof(RNG_Key), MPI_CHAR, 0, MPI_COMM_WORLD);
 #endif
-    std::memcpy(&(pturb->rstate), &(rng_data[0]), sizeof(RNG_State));
+    std::memcpy(&(pturb->rkey), &(rng_data[0]), sizeof(RNG_Key));
   }
 
   // root process reads size of CC and FC data arrays from restart file
@@ -268,6 +337,9 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   if (prad != nullptr) {
     data_size_ += nout1*nout2*nout3*nrad*sizeof(Real);   // rad i0
   }
+  if (pm1 != nullptr) {
+    data_size_ += nout1*nout2*nout3*nm1*sizeof(Real);    // m1 u0
+  }
   if (pturb != nullptr) {
     data_size_ += nout1*nout2*nout3*nforce*sizeof(Real); // forcing
   }
@@ -285,6 +357,11 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     exit(EXIT_FAILURE);
   }
 
+  // prolongate and/or regroup data from MeshBlocks in restart file into new MeshBlocks
+  if (remesh) {
+    pm->RemeshRestartData(resfile, headeroffset, data_size);
+  }
+
   // read CC data into host array
   int mygids = pm->gids_eachrank[global_variable::my_rank];
   IOWrapperSizeT offset_myrank = headeroffset + data_size_*mygids;
@@ -301,7 +378,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     noutmbs_min = std::min(noutmbs_min,pm->nmb_eachrank[i]);
   }
 
-  if (phydro != nullptr) {
+  if (phydro != nullptr && !(remesh)) {
     Kokkos::realloc(ccin, nmb, nhydro, nout3, nout2, nout1);
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to read, so read collectively
@@ -339,7 +416,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     myoffset = offset_myrank;
   }
 
-  if (pmhd != nullptr) {
+  if (pmhd != nullptr && !(remesh)) {
     Kokkos::realloc(ccin, nmb, nmhd, nout3, nout2, nout1);
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to read, so read collectively
@@ -471,7 +548,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     myoffset = offset_myrank;
   }
 
-  if (prad != nullptr) {
+  if (prad != nullptr && !(remesh)) {
     Kokkos::realloc(ccin, nmb, nrad, nout3, nout2, nout1);
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to read, so read collectively
@@ -509,7 +586,45 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     myoffset = offset_myrank;
   }
 
-  if (pturb != nullptr) {
+  if (pm1 != nullptr && !(remesh)) {
+    Kokkos::realloc(ccin, nmb, nm1, nout3, nout2, nout1);
+    for (int m=0;  m<noutmbs_max; ++m) {
+      // every rank has a MB to read, so read collectively
+      if (m < noutmbs_min) {
+        // get ptr to cell-centered MeshBlock data
+        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
+                                     Kokkos::ALL);
+        int mbcnt = mbptr.size();
+        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "CC m1 data not read correctly from rst file, "
+                    << "restart file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        myoffset += data_size;
+
+      // some ranks are finished writing, so use non-collective write
+      } else if (m < pm->nmb_thisrank) {
+        // get ptr to MeshBlock data
+        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
+                                     Kokkos::ALL);
+        int mbcnt = mbptr.size();
+        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "CC m1 data not read correctly from rst file, "
+                    << "restart file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        myoffset += data_size;
+      }
+    }
+    Kokkos::deep_copy(Kokkos::subview(pm1->u0, std::make_pair(0,nmb), Kokkos::ALL,
+                      Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
+    offset_myrank += nout1*nout2*nout3*nm1*sizeof(Real);    // m1 u0
+    myoffset = offset_myrank;
+  }
+
+  if (pturb != nullptr && !(remesh)) {
     Kokkos::realloc(ccin, nmb, nforce, nout3, nout2, nout1);
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to read, so read collectively
@@ -547,7 +662,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     myoffset = offset_myrank;
   }
 
-  if (pz4c != nullptr) {
+  if (pz4c != nullptr && !(remesh)) {
     Kokkos::realloc(ccin, nmb, nz4c, nout3, nout2, nout1);
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to read, so read collectively
@@ -586,7 +701,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
 
     // We also need to reinitialize the ADM data.
     pz4c->Z4cToADM(pmy_mesh_->pmb_pack);
-  } else if (padm != nullptr) {
+  } else if (padm != nullptr && !(remesh)) {
     Kokkos::realloc(ccin, nmb, nadm, nout3, nout2, nout1);
     for (int m=0;  m<noutmbs_max; ++m) {
       // every rank has a MB to read, so read collectively
@@ -624,6 +739,96 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     myoffset = offset_myrank;
   }
 
+  // read particles stored after data over all MeshBlocks.  Each rank reads an equal
+  // chunk of every property, then particles are sent to the rank owning their MeshBlock
+  particles::Particles* ppart = pm->pmb_pack->ppart;
+  if (ppart != nullptr) {
+    int nmb_file = (remesh)? pm->prst_mesh->nmb_total : pm->nmb_total;
+    IOWrapperSizeT offset_part = headeroffset + data_size*nmb_file;
+    int nranks = global_variable::nranks;
+    // root process reads header and index, then broadcasts
+    int pheader[3];
+    Real pdtnew;
+    if (global_variable::my_rank == 0) {
+      if ((resfile.Read_bytes_at(&(pheader[0]), sizeof(int), 3, offset_part) != 3) ||
+          (resfile.Read_Reals_at(&pdtnew, 1, offset_part + 3*sizeof(int)) != 1)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Particle header not read correctly from rst file, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+#if MPI_PARALLEL_ENABLED
+    MPI_Bcast(&(pheader[0]), 3, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&pdtnew, 1, MPI_ATHENA_REAL, 0, MPI_COMM_WORLD);
+#endif
+    if (pheader[0] != ppart->nrdata || pheader[1] != ppart->nidata) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Number of particle properties in restart file ("
+                << pheader[0] << "," << pheader[1] << ") does not match input file ("
+                << ppart->nrdata << "," << ppart->nidata << ")" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    int nranks_old = pheader[2];
+    std::vector<IOWrapperSizeT> pindex(nranks_old+1);
+    offset_part += 3*sizeof(int) + sizeof(Real);
+    if (global_variable::my_rank == 0) {
+      if (resfile.Read_bytes_at(pindex.data(), sizeof(IOWrapperSizeT), nranks_old+1,
+                                offset_part) != static_cast<std::size_t>(nranks_old+1)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Particle index not read correctly from rst file, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+#if MPI_PARALLEL_ENABLED
+    MPI_Bcast(pindex.data(), (nranks_old+1)*sizeof(IOWrapperSizeT), MPI_CHAR, 0,
+              MPI_COMM_WORLD);
+#endif
+    offset_part += (nranks_old+1)*sizeof(IOWrapperSizeT);
+
+    // read properties of particles [pstart,pstart+npart) on this rank
+    IOWrapperSizeT ntot = pindex[nranks_old];
+    IOWrapperSizeT pstart = (ntot*global_variable::my_rank)/nranks;
+    int npart = static_cast<int>((ntot*(global_variable::my_rank + 1))/nranks - pstart);
+    int nrdata = ppart->nrdata, nidata = ppart->nidata;
+    HostArray2D<Real> prin("prtcl_rin", nrdata, npart);
+    HostArray2D<int>  piin("prtcl_iin", nidata, npart);
+    bool no_errors = true;
+    for (int n=0; n<nrdata; ++n) {
+      IOWrapperSizeT myoff = offset_part + (n*ntot + pstart)*sizeof(Real);
+      std::size_t nread = resfile.Read_Reals_at_all(prin.data() + n*npart, npart, myoff);
+      if (nread != static_cast<std::size_t>(npart)) {no_errors = false;}
+    }
+    offset_part += nrdata*ntot*sizeof(Real);
+    for (int n=0; n<nidata; ++n) {
+      IOWrapperSizeT myoff = offset_part + (n*ntot + pstart)*sizeof(int);
+      std::size_t nread = resfile.Read_bytes_at_all(piin.data() + n*npart, sizeof(int),
+                                                    npart, myoff);
+      if (nread != static_cast<std::size_t>(npart)) {no_errors = false;}
+    }
+    if (!(no_errors)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Particle data not read correctly from rst file, "
+                << "restart file is broken." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    // gids in restart file refer to old MeshBlocks, so find gids in the new tree
+    if (remesh) {
+      for (int p=0; p<npart; ++p) {
+        piin(PGID,p) = FindParticleGID(pm, pm->ptree.get(), prin(IPX,p), prin(IPY,p),
+                                       prin(IPZ,p));
+      }
+    }
+    Kokkos::realloc(ppart->prtcl_rdata, nrdata, npart);
+    Kokkos::realloc(ppart->prtcl_idata, nidata, npart);
+    Kokkos::deep_copy(ppart->prtcl_rdata, prin);
+    Kokkos::deep_copy(ppart->prtcl_idata, piin);
+    ppart->nprtcl_thispack = npart;
+    ppart->dtnew = pdtnew;
+    ppart->Redistribute();
+  }
+
   // call problem generator again to re-initialize data, fn ptrs, as needed
 #if USER_PROBLEM_ENABLED
   UserProblem(pin, true);
@@ -636,6 +841,8 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     AlfvenWave(pin, true);
   } else if (pgen_fun_name.compare("gr_bondi") == 0) {
     BondiAccretion(pin, true);
+  } else if (pgen_fun_name.compare("binary_ks") == 0) {
+    BinaryKS(pin, true);
   } else if (pgen_fun_name.compare("tetrad") == 0) {
     CheckOrthonormalTetrad(pin, true);
   } else if (pgen_fun_name.compare("hohlraum") == 0) {
@@ -650,14 +857,32 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     OrszagTang(pin, true);
   } else if (pgen_fun_name.compare("rad_linear_wave") == 0) {
     RadiationLinearWave(pin, true);
+  } else if (pgen_fun_name.compare("rad_relax") == 0) {
+    RadiationRelaxation(pin, true);
   } else if (pgen_fun_name.compare("shock_tube") == 0) {
     ShockTube(pin, true);
   } else if (pgen_fun_name.compare("z4c_linear_wave") == 0) {
     Z4cLinearWave(pin, true);
+  } else if (pgen_fun_name.compare("z4c_one_puncture") == 0) {
+    Z4cOnePuncture(pin, true);
   } else if (pgen_fun_name.compare("spherical_collapse") == 0) {
     SphericalCollapse(pin, true);
   } else if (pgen_fun_name.compare("diffusion") == 0) {
     Diffusion(pin, true);
+  } else if (pgen_fun_name.compare("jeans") == 0) {
+    JeansInstability(pin, true);
+  } else if (pgen_fun_name.compare("uniform_sphere") == 0) {
+    UniformSphere(pin, true);
+  } else if (pgen_fun_name.compare("disk_slab") == 0) {
+    DiskSlab(pin, true);
+  } else if (pgen_fun_name.compare("conduction_ring") == 0) {
+    ConductionRing(pin, true);
+  } else if (pgen_fun_name.compare("tracers") == 0) {
+    Tracers(pin, true);
+  } else if (pgen_fun_name.compare("m1_tests") == 0) {
+    M1Tests(pin, true);
+  } else if (pgen_fun_name.compare("nonideal_mhd") == 0) {
+    NonIdealMHD(pin, true);
   } else {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Problem generator name could not be found in <problem> block in input file"
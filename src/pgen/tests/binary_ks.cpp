@@ -0,0 +1,277 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file binary_ks.cpp
+//! \brief Problem generator for a static atmosphere in the superposed Kerr-Schild
+//! spacetime of a black hole binary (<adm>/superposed_ks = true), used by the regression
+//! test of that spacetime.  At the end of the run the following are appended to the
+//! file <basename>-errs.dat:
+//!  - max error of the lapse, shift, and spatial metric with respect to a single
+//!    Kerr-Schild hole of mass bh_mass1 and spin bh_spin1 at the position of hole 1
+//!    (cartesian_ks.hpp), which vanishes in the limit bh_mass2 -> 0,
+//!  - max error of the finite-difference K_ij with respect to the analytic K_ij of the
+//!    same single stationary hole,
+//!  - for each hole, the distance between the centroid of excised cells and the
+//!    position of the hole on its orbit, and the distance the hole has moved since t=0.
+//! Errors of the metric and K_ij are only computed at distances from hole 1 of at least
+//! <problem>/r_err (in units of bh_mass1), outside the excised region.
+
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <string>     // c_str()
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "coordinates/cartesian_ks.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "coordinates/adm.hpp"
+#include "coordinates/superposed_ks.hpp"
+#include "eos/eos.hpp"
+#include "mhd/mhd.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
+#include "pgen/pgen.hpp"
+
+// prototype for error function
+void BinaryKSErrors(ParameterInput *pin, Mesh *pm);
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::BinaryKS()
+//! \brief Sets a uniform atmosphere at rest, without magnetic fields.  The ADM variables
+//! and excision masks are already set by the SuperposedKS class.
+
+void ProblemGenerator::BinaryKS(ParameterInput *pin, const bool restart) {
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pdyngr == nullptr || pmbp->padm == nullptr || pmbp->padm->psks == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "binary_ks test requires DynGRMHD with <adm>/superposed_ks = true"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  pgen_final_func = BinaryKSErrors;
+  if (restart) return;
+
+  Real dens = pin->GetOrAddReal("problem", "dens", 1.0e-5);
+  Real pgas = pin->GetOrAddReal("problem", "pgas", 1.0e-8);
+
+  // capture variables for the kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb = pmbp->nmb_thispack;
+  auto &w0_ = pmbp->pmhd->w0;
+  auto &b0 = pmbp->pmhd->b0;
+  auto &bcc_ = pmbp->pmhd->bcc0;
+
+  par_for("pgen_binary_ks", DevExeSpace(), 0,(nmb-1),0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    w0_(m,IDN,k,j,i) = dens;
+    w0_(m,IPR,k,j,i) = pgas;
+    w0_(m,IVX,k,j,i) = 0.0;
+    w0_(m,IVY,k,j,i) = 0.0;
+    w0_(m,IVZ,k,j,i) = 0.0;
+  });
+  par_for("pgen_binary_ks_b", DevExeSpace(), 0,(nmb-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    b0.x1f(m,k,j,i) = b0.x2f(m,k,j,i) = b0.x3f(m,k,j,i) = 0.0;
+    bcc_(m,IBX,k,j,i) = bcc_(m,IBY,k,j,i) = bcc_(m,IBZ,k,j,i) = 0.0;
+    if (i==ie) {
+      b0.x1f(m,k,j,i+1) = 0.0;
+    }
+    if (j==je) {
+      b0.x2f(m,k,j+1,i) = 0.0;
+    }
+    if (k==ke) {
+      b0.x3f(m,k+1,j,i) = 0.0;
+    }
+  });
+
+  pmbp->pdyngr->PrimToConInit(0, n1-1, 0, n2-1, 0, n3-1);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BinaryKSErrors()
+//! \brief Computes errors of the superposed spacetime and of the excision masks, and
+//! appends them to <basename>-errs.dat
+
+void BinaryKSErrors(ParameterInput *pin, Mesh *pm) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  auto &indcs = pm->mb_indcs;
+  int &nx1 = indcs.nx1;
+  int &nx2 = indcs.nx2;
+  int &nx3 = indcs.nx3;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  auto &size = pmbp->pmb->mb_size;
+  auto &adm = pmbp->padm->adm;
+  auto &bin = pmbp->padm->psks->bin;
+
+  // positions of holes now and at t=0
+  Real pos[2][3], vel[2][3], pos0[2][3], vel0[2][3];
+  adm::BinaryOrbit(bin, pm->time, pos, vel);
+  adm::BinaryOrbit(bin, 0.0, pos0, vel0);
+  Real m1 = bin.m[0];
+  Real a1 = bin.a[0]/bin.m[0];
+  Real x1h = pos[0][0], y1h = pos[0][1], z1h = pos[0][2];
+  Real x2h = pos[1][0], y2h = pos[1][1], z2h = pos[1][2];
+  Real r_err = m1*pin->GetOrAddReal("problem", "r_err", 2.0);
+
+  const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+
+  // max errors of metric and extrinsic curvature with respect to single hole 1
+  Real err_metric = 0.0, err_k = 0.0;
+  Kokkos::parallel_reduce("binary_ks_errs",
+                          Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &max_g, Real &max_k) {
+    // compute m,k,j,i indices of thread
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max) - x1h;
+    Real y = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max) - y1h;
+    Real z = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max) - z1h;
+    if (SQR(x) + SQR(y) + SQR(z) < SQR(r_err)) return;
+
+    // cartesian_ks.hpp assumes unit mass, so evaluate in units of m1
+    Real alp, beta[3], psi4, g[6], kk[6];
+    ComputeADMDecomposition(x/m1, y/m1, z/m1, false, a1, &alp,
+                            &beta[0], &beta[1], &beta[2], &psi4,
+                            &g[0], &g[1], &g[2], &g[3], &g[4], &g[5],
+                            &kk[0], &kk[1], &kk[2], &kk[3], &kk[4], &kk[5]);
+    Real eg = fabs(adm.alpha(m,k,j,i) - alp);
+    for (int a=0; a<3; ++a) {
+      eg = fmax(eg, fabs(adm.beta_u(m,a,k,j,i) - beta[a]));
+    }
+    Real ek = 0.0;
+    int n = 0;
+    for (int a=0; a<3; ++a) {
+      for (int b=a; b<3; ++b) {
+        eg = fmax(eg, fabs(adm.g_dd(m,a,b,k,j,i) - g[n]));
+        ek = fmax(ek, fabs(adm.vK_dd(m,a,b,k,j,i) - kk[n]/m1));
+        ++n;
+      }
+    }
+    max_g = fmax(max_g, eg);
+    max_k = fmax(max_k, ek);
+  }, Kokkos::Max<Real>(err_metric), Kokkos::Max<Real>(err_k));
+
+  // number and centroids of excised cells, assigned to the nearest hole
+  array_sum::GlobalSum sum_excised;
+  auto &coord = pmbp->pcoord->coord_data;
+  if (coord.bh_excise && coord.excision_scheme == ExcisionScheme::fixed) {
+    auto &floor = pmbp->pcoord->excision_floor;
+    Kokkos::parallel_reduce("binary_ks_excise",
+                            Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+
+      array_sum::GlobalSum evars;
+      for (int n=0; n<NREDUCTION_VARIABLES; ++n) {
+        evars.the_array[n] = 0.0;
+      }
+      if (floor(m,k,j,i)) {
+        Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+        Real y = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+        Real z = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+        Real d1 = SQR(x - x1h) + SQR(y - y1h) + SQR(z - z1h);
+        Real d2 = SQR(x - x2h) + SQR(y - y2h) + SQR(z - z2h);
+        int n = (d1 <= d2)? 0 : 4;
+        evars.the_array[n] = 1.0;
+        evars.the_array[n+1] = x;
+        evars.the_array[n+2] = y;
+        evars.the_array[n+3] = z;
+      }
+      mb_sum += evars;
+    }, Kokkos::Sum<array_sum::GlobalSum>(sum_excised));
+  } else {
+    for (int n=0; n<NREDUCTION_VARIABLES; ++n) {
+      sum_excised.the_array[n] = 0.0;
+    }
+  }
+
+#if MPI_PARALLEL_ENABLED
+  Real max_errs[2] = {err_metric, err_k};
+  MPI_Allreduce(MPI_IN_PLACE, max_errs, 2, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+  err_metric = max_errs[0];
+  err_k = max_errs[1];
+  MPI_Allreduce(MPI_IN_PLACE, sum_excised.the_array, 8, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+#endif
+
+  // distance of centroid of excised cells from each hole (zero if no cells excised),
+  // and distance moved by each hole since t=0
+  Real nexcise[2], err_cen[2], moved[2];
+  for (int n=0; n<2; ++n) {
+    Real *s = &(sum_excised.the_array[4*n]);
+    nexcise[n] = s[0];
+    err_cen[n] = 0.0;
+    if (s[0] > 0.0) {
+      err_cen[n] = std::sqrt(SQR(s[1]/s[0] - pos[n][0]) + SQR(s[2]/s[0] - pos[n][1]) +
+                             SQR(s[3]/s[0] - pos[n][2]));
+    }
+    moved[n] = std::sqrt(SQR(pos[n][0] - pos0[n][0]) + SQR(pos[n][1] - pos0[n][1]) +
+                         SQR(pos[n][2] - pos0[n][2]));
+  }
+
+  // open output file and write out errors
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Nx2  Nx3   Ncycle  time          metric_err    ");
+      std::fprintf(pfile, "K_err         nexcise1      cen1_err      moved1        ");
+      std::fprintf(pfile, "nexcise2      cen2_err      moved2\n");
+    }
+
+    // write errors
+    std::fprintf(pfile, "%04d", pm->mesh_indcs.nx1);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx2);
+    std::fprintf(pfile, "  %04d", pm->mesh_indcs.nx3);
+    std::fprintf(pfile, "  %05d  %e  %e  %e", pm->ncycle, pm->time, err_metric, err_k);
+    for (int n=0; n<2; ++n) {
+      std::fprintf(pfile, "  %e  %e  %e", nexcise[n], err_cen[n], moved[n]);
+    }
+    std::fprintf(pfile, "\n");
+    std::fclose(pfile);
+  }
+  return;
+}
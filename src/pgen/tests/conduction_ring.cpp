@@ -0,0 +1,241 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file conduction_ring.cpp
+//! \brief Problem generator for the ring test of anisotropic thermal conduction in MHD.
+//! A hot patch in pressure equilibrium is placed in a circular magnetic field in 2D; heat
+//! should diffuse along the ring, but not across field lines, and no new temperature
+//! extrema should appear (Parrish & Stone 2005; Sharma & Hammett 2007, JCP 227, 123).
+//! This file also contains a function to compute diagnostics of the final state, called
+//! in Driver::Finalize().
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <limits>
+#include <string>     // c_str()
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "mhd/mhd.hpp"
+#include "diffusion/conduction.hpp"
+#include "pgen/pgen.hpp"
+
+// Prototype for function to compute diagnostics of solution at end of run
+void ConductionRingErrors(ParameterInput *pin, Mesh *pm);
+
+// Anonymous namespace used to prevent name collisions outside of this file
+namespace {
+struct RingVariables {
+  Real p0, t0, t1;          // pressure, ambient and patch temperature
+  Real r_in, r_out;         // radial extent of hot patch
+  Real phi_c, dphi;         // center and half-width of patch in azimuth
+};
+
+RingVariables rv;
+
+//----------------------------------------------------------------------------------------
+//! \fn Real RingA3()
+//! \brief 3-component of vector potential, A3 = B0 r, gives circular field of strength B0
+
+KOKKOS_INLINE_FUNCTION
+Real RingA3(const Real x1, const Real x2, const Real b0) {
+  return b0*sqrt(x1*x1 + x2*x2);
+}
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::ConductionRing()
+//! \brief Hot patch at r_in < r < r_out, |phi - phi_c| < dphi in circular B field.
+
+void ProblemGenerator::ConductionRing(ParameterInput *pin, const bool restart) {
+  pgen_final_func = ConductionRingErrors;
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pmhd == nullptr || pmbp->pmhd->pcond == nullptr ||
+      !(pmbp->pmhd->peos->eos_data.is_ideal)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Conduction ring test requires <mhd> block with ideal EOS and "
+              << "thermal conduction" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  Real b0_ = pin->GetOrAddReal("problem", "b0", 1.0e-3);
+  rv.p0 = pin->GetOrAddReal("problem", "p0", 10.0);
+  rv.t0 = pin->GetOrAddReal("problem", "t0", 10.0);
+  rv.t1 = pin->GetOrAddReal("problem", "t1", 12.0);
+  rv.r_in = pin->GetOrAddReal("problem", "r_in", 0.5);
+  rv.r_out = pin->GetOrAddReal("problem", "r_out", 0.7);
+  rv.phi_c = M_PI;
+  rv.dphi = M_PI/12.0;
+
+  // capture variables for the kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  EOS_Data &eos = pmbp->pmhd->peos->eos_data;
+  Real gm1 = eos.gamma - 1.0;
+  auto &u0 = pmbp->pmhd->u0;
+  auto &b0 = pmbp->pmhd->b0;
+  auto &size = pmbp->pmb->mb_size;
+  auto rv_ = rv;
+
+  par_for("pgen_ring1", DevExeSpace(), 0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    int nx1 = indcs.nx1;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max);
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    int nx2 = indcs.nx2;
+    Real x2v = CellCenterX(j-js, nx2, x2min, x2max);
+
+    Real rad = sqrt(x1v*x1v + x2v*x2v);
+    Real phi = atan2(x2v, x1v);
+    if (phi < 0.0) {phi += 2.0*M_PI;}
+    Real temp = rv_.t0;
+    if (rad > rv_.r_in && rad < rv_.r_out && fabs(phi - rv_.phi_c) < rv_.dphi) {
+      temp = rv_.t1;
+    }
+    u0(m,IDN,k,j,i) = rv_.p0/temp;
+    u0(m,IM1,k,j,i) = 0.0;
+    u0(m,IM2,k,j,i) = 0.0;
+    u0(m,IM3,k,j,i) = 0.0;
+
+    // Compute face-centered fields from curl(A).
+    Real x1f   = LeftEdgeX(i  -is, nx1, x1min, x1max);
+    Real x1fp1 = LeftEdgeX(i+1-is, nx1, x1min, x1max);
+    Real x2f   = LeftEdgeX(j  -js, nx2, x2min, x2max);
+    Real x2fp1 = LeftEdgeX(j+1-js, nx2, x2min, x2max);
+    Real dx1 = size.d_view(m).dx1;
+    Real dx2 = size.d_view(m).dx2;
+
+    b0.x1f(m,k,j,i) =  (RingA3(x1f,  x2fp1,b0_) - RingA3(x1f,x2f,b0_))/dx2;
+    b0.x2f(m,k,j,i) = -(RingA3(x1fp1,x2f  ,b0_) - RingA3(x1f,x2f,b0_))/dx1;
+    b0.x3f(m,k,j,i) = 0.0;
+
+    // Include extra face-component at edge of block in each direction
+    if (i==ie) {
+      b0.x1f(m,k,j,i+1) =  (RingA3(x1fp1,x2fp1,b0_) - RingA3(x1fp1,x2f,b0_))/dx2;
+    }
+    if (j==je) {
+      b0.x2f(m,k,j+1,i) = -(RingA3(x1fp1,x2fp1,b0_) - RingA3(x1f,x2fp1,b0_))/dx1;
+    }
+    if (k==ke) {
+      b0.x3f(m,k+1,j,i) = 0.0;
+    }
+  });
+
+  // initialize total energy (requires B to be defined across entire grid first)
+  Real p0_ = rv.p0;
+  par_for("pgen_ring2", DevExeSpace(), 0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    u0(m,IEN,k,j,i) = p0_/gm1 +
+          0.5*(SQR(0.5*(b0.x1f(m,k,j,i) + b0.x1f(m,k,j,i+1))) +
+               SQR(0.5*(b0.x2f(m,k,j,i) + b0.x2f(m,k,j+1,i))) +
+               SQR(0.5*(b0.x3f(m,k,j,i) + b0.x3f(m,k+1,j,i))));
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ConductionRingErrors()
+//! \brief Computes minimum and maximum temperature, the fraction of the excess heat
+//! |T - t0| that has leaked across field lines out of the annulus r_in < r < r_out, and
+//! the fraction that has spread along the ring outside the initial patch, and writes them
+//! to file.  Also reports the number of RKL2 stages used in the last time step.
+
+void ConductionRingErrors(ParameterInput *pin, Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &w0 = pm->pmb_pack->pmhd->w0;
+  EOS_Data &eos = pm->pmb_pack->pmhd->peos->eos_data;
+  const bool use_e = eos.use_e;
+  Real gm1 = eos.gamma - 1.0;
+  auto rv_ = rv;
+
+  array_sum::GlobalSum sum_this_rank;
+  Real tmin = static_cast<Real>(std::numeric_limits<float>::max());
+  Real tmax = -tmin;
+  Kokkos::parallel_reduce("ring_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum, Real &min_t, Real &max_t) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real y = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real rad = sqrt(x*x + y*y);
+    Real phi = atan2(y, x);
+    if (phi < 0.0) {phi += 2.0*M_PI;}
+    Real temp = (use_e)? w0(m,IEN,k,j,i)/w0(m,IDN,k,j,i)*gm1 : w0(m,ITM,k,j,i);
+    Real dheat = vol*w0(m,IDN,k,j,i)*fabs(temp - rv_.t0);
+    bool in_ring = (rad > rv_.r_in && rad < rv_.r_out);
+    array_sum::GlobalSum evars;
+    evars.the_array[0] = dheat;
+    evars.the_array[1] = (in_ring)? 0.0 : dheat;
+    evars.the_array[2] = (in_ring && fabs(phi - rv_.phi_c) >= rv_.dphi)? dheat : 0.0;
+    mb_sum += evars;
+    min_t = fmin(min_t, temp);
+    max_t = fmax(max_t, temp);
+  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_rank), Kokkos::Min<Real>(tmin),
+     Kokkos::Max<Real>(tmax));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, sum_this_rank.the_array, 3, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &tmin, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &tmax, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  Real total = sum_this_rank.the_array[0];
+  Real leak = (total > 0.0)? sum_this_rank.the_array[1]/total : 0.0;
+  Real spread = (total > 0.0)? sum_this_rank.the_array[2]/total : 0.0;
+
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Nx2  Ncycle  STS-stages  Tmin  Tmax  Leak  Spread\n");
+    }
+    std::fprintf(pfile, "%04d  %04d  %05d  %03d  %e  %e  %e  %e\n",
+                 pm->mesh_indcs.nx1, pm->mesh_indcs.nx2, pm->ncycle,
+                 pm->pmb_pack->pmhd->pcond->sts_nstages, tmin, tmax, leak, spread);
+    std::fclose(pfile);
+  }
+  return;
+}
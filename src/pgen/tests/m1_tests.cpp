@@ -0,0 +1,317 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file m1_tests.cpp
+//! \brief Problem generator for tests of the gray M1 radiation module in flat space with
+//! no fluid.  Test is selected by the <problem>/test parameter:
+//!  - diffusion: Gaussian pulse in a purely scattering medium (1D).  At large optical
+//!    depth the M1 equations reduce to dE/dt = D d^2E/dx^2 with D = 1/(3 kappa_s), which
+//!    has the analytic solution used to compute errors at the end of the run.
+//!  - shadow: plane-parallel free-streaming beam entering through the inner x1 face that
+//!    is absorbed by an opaque cloud, casting a shadow (2D).  Set kappa_cloud=0 to test
+//!    propagation of a beam.
+//! This file also contains functions to compute errors in the diffusion and shadow
+//! tests, called in Driver::Finalize().
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <string>     // c_str()
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "m1/m1.hpp"
+#include "pgen/pgen.hpp"
+
+// Prototypes for functions to compute errors in diffusion and shadow tests at end of run
+void M1DiffusionErrors(ParameterInput *pin, Mesh *pm);
+void M1ShadowErrors(ParameterInput *pin, Mesh *pm);
+
+// Anonymous namespace used to prevent name collisions outside of this file
+namespace {
+Real width, diff_coef;      // initial width of Gaussian, and diffusion coefficient
+Real e_beam, r_cloud, x1_cloud, x2_cloud;  // energy density of beam, and cloud
+
+//----------------------------------------------------------------------------------------
+//! \fn Real GaussianE()
+//! \brief Analytic solution of diffusion equation for initial Gaussian of unit amplitude
+
+KOKKOS_INLINE_FUNCTION
+Real GaussianE(const Real x, const Real t, const Real w, const Real d) {
+  Real w2t = w*w + 4.0*d*t;
+  return sqrt(w*w/w2t)*exp(-x*x/w2t);
+}
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::M1Tests()
+//! \brief Sets initial conditions for M1 diffusion and shadow tests
+
+void ProblemGenerator::M1Tests(ParameterInput *pin, const bool restart) {
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pm1 == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "M1 tests require <m1> block in input file" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  m1::M1 *pm1 = pmbp->pm1;
+  std::string test = pin->GetOrAddString("problem", "test", "diffusion");
+
+  // capture variables for the kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int &is = indcs.is;
+  int &js = indcs.js;
+  int nmb1 = (pmbp->nmb_thispack-1);
+  int nspec = pm1->nspecies, nv = pm1->nvars;
+  auto &size = pmbp->pmb->mb_size;
+  auto &u0 = pm1->u0;
+
+  if (test.compare("diffusion") == 0) {
+    pgen_final_func = M1DiffusionErrors;
+    width = pin->GetOrAddReal("problem", "width", 0.1);
+    Real kap_s = pin->GetReal("m1", "kappa_s");
+    if (kap_s <= 0.0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "M1 diffusion test requires kappa_s > 0" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    diff_coef = 1.0/(3.0*kap_s);
+    if (restart) return;
+
+    Real w_ = width, d_ = diff_coef;
+    par_for("pgen_m1diff", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real x1v = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+      Real e = GaussianE(x1v, 0.0, w_, d_);
+      for (int s=0; s<nspec; ++s) {
+        // diffusive flux F = -D dE/dx
+        u0(m,s*nv+m1::IRE,k,j,i) = e;
+        u0(m,s*nv+m1::IRFX,k,j,i) = 2.0*d_*x1v*e/(w_*w_);
+        u0(m,s*nv+m1::IRFY,k,j,i) = 0.0;
+        u0(m,s*nv+m1::IRFZ,k,j,i) = 0.0;
+        if (nv > m1::IRN) {
+          u0(m,s*nv+m1::IRN,k,j,i) = e;
+        }
+      }
+    });
+
+  } else if (test.compare("shadow") == 0) {
+    pgen_final_func = M1ShadowErrors;
+    // set free-streaming inflow state in BoundaryValues, sync to device
+    Real ebeam = pin->GetOrAddReal("problem", "e_beam", 1.0);
+    Real eamb = pin->GetOrAddReal("problem", "e_ambient", 1.0e-10);
+    auto &u_in = pm1->pbval_u->u_in;
+    for (int s=0; s<nspec; ++s) {
+      for (int v=0; v<nv; ++v) {
+        u_in.h_view(s*nv+v,BoundaryFace::inner_x1) = 0.0;
+      }
+      u_in.h_view(s*nv+m1::IRE,BoundaryFace::inner_x1) = ebeam;
+      u_in.h_view(s*nv+m1::IRFX,BoundaryFace::inner_x1) = ebeam;
+    }
+    u_in.template modify<HostMemSpace>();
+    u_in.template sync<DevExeSpace>();
+
+    // absorption opacity of cloud is not stored in restart files, so always set it
+    Real kcloud = pin->GetOrAddReal("problem", "kappa_cloud", 1.0e3);
+    Real rcloud = pin->GetOrAddReal("problem", "r_cloud", 0.2);
+    Real xc = pin->GetOrAddReal("problem", "x1_cloud", 0.0);
+    Real yc = pin->GetOrAddReal("problem", "x2_cloud", 0.0);
+    e_beam = ebeam;
+    r_cloud = rcloud;
+    x1_cloud = xc;
+    x2_cloud = yc;
+    auto &kap_a = pm1->kap_a;
+    par_for("pgen_m1cloud", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real x1v = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+      Real x2v = CellCenterX(j-js, indcs.nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+      if (SQR(x1v - xc) + SQR(x2v - yc) < SQR(rcloud)) {
+        for (int s=0; s<nspec; ++s) {
+          kap_a(m,s,k,j,i) = kcloud;
+        }
+      }
+    });
+    if (restart) return;
+
+    par_for("pgen_m1shadow", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      for (int s=0; s<nspec; ++s) {
+        for (int v=0; v<nv; ++v) {
+          u0(m,s*nv+v,k,j,i) = 0.0;
+        }
+        u0(m,s*nv+m1::IRE,k,j,i) = eamb;
+      }
+    });
+
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "M1 test '" << test << "' not recognized; choose 'diffusion' or "
+              << "'shadow'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void M1DiffusionErrors()
+//! \brief Computes L1 error in energy density of first species compared to analytic
+//! solution of diffusion equation, and writes it to file.
+
+void M1DiffusionErrors(ParameterInput *pin, Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &u0 = pm->pmb_pack->pm1->u0;
+  Real w_ = width, d_ = diff_coef;
+  Real t = pm->time;
+
+  Real l1_err = 0.0, emax = 0.0;
+  Kokkos::parallel_reduce("m1diff_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum_err, Real &max_e) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real e = u0(m,m1::IRE,k,j,i);
+    sum_err += vol*fabs(e - GaussianE(x, t, w_, d_));
+    max_e = fmax(max_e, e);
+  }, Kokkos::Sum<Real>(l1_err), Kokkos::Max<Real>(emax));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &l1_err, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &emax, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  // normalize by volume of mesh
+  auto &ms = pm->mesh_size;
+  l1_err /= (ms.x1max - ms.x1min)*(ms.x2max - ms.x2min)*(ms.x3max - ms.x3min);
+
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Ncycle  L1-Error  Emax  Emax-exact\n");
+    }
+    std::fprintf(pfile, "%04d  %05d  %e  %e  %e\n", pm->mesh_indcs.nx1, pm->ncycle,
+                 l1_err, emax, GaussianE(0.0, t, w_, d_));
+    std::fclose(pfile);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void M1ShadowErrors()
+//! \brief Computes, for the first species, the L1 error in energy density and flux of
+//! the beam (E = F_x = e_beam) in the region |x2-x2_cloud| > 1.5 r_cloud that is not
+//! shadowed by the cloud, and the mean energy density in the core of the shadow
+//! |x2-x2_cloud| < 0.5 r_cloud, x1 > x1_cloud + 1.5 r_cloud, and writes them to file.
+//! Both are normalized by e_beam.
+
+void M1ShadowErrors(ParameterInput *pin, Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &u0 = pm->pmb_pack->pm1->u0;
+  Real eb = e_beam, rc = r_cloud, xc = x1_cloud, yc = x2_cloud;
+
+  Real l1_err = 0.0, vol_lit = 0.0, e_shadow = 0.0, vol_shadow = 0.0;
+  Kokkos::parallel_reduce("m1shadow_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum_err, Real &sum_lit, Real &sum_e,
+                Real &sum_shadow) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real y = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real e = u0(m,m1::IRE,k,j,i);
+    if (fabs(y - yc) > 1.5*rc) {
+      sum_err += vol*(fabs(e - eb) + fabs(u0(m,m1::IRFX,k,j,i) - eb))/eb;
+      sum_lit += vol;
+    } else if (fabs(y - yc) < 0.5*rc && x > xc + 1.5*rc) {
+      sum_e += vol*e/eb;
+      sum_shadow += vol;
+    }
+  }, Kokkos::Sum<Real>(l1_err), Kokkos::Sum<Real>(vol_lit), Kokkos::Sum<Real>(e_shadow),
+     Kokkos::Sum<Real>(vol_shadow));
+#if MPI_PARALLEL_ENABLED
+  Real sums[4] = {l1_err, vol_lit, e_shadow, vol_shadow};
+  MPI_Allreduce(MPI_IN_PLACE, sums, 4, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+  l1_err = sums[0];
+  vol_lit = sums[1];
+  e_shadow = sums[2];
+  vol_shadow = sums[3];
+#endif
+  // normalize by volume of each region
+  if (vol_lit > 0.0) {l1_err /= vol_lit;}
+  if (vol_shadow > 0.0) {e_shadow /= vol_shadow;}
+
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Nx2  Ncycle  Beam-L1-Error  E-shadow\n");
+    }
+    std::fprintf(pfile, "%04d  %04d  %05d  %e  %e\n", pm->mesh_indcs.nx1,
+                 pm->mesh_indcs.nx2, pm->ncycle, l1_err, e_shadow);
+    std::fclose(pfile);
+  }
+  return;
+}
@@ -0,0 +1,357 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file nonideal_mhd.cpp
+//! \brief Problem generator for 1D tests of the Hall effect and ambipolar diffusion.
+//! Test is selected by the <problem>/test parameter:
+//!  - whistler: circularly polarized wave propagating along B in Hall MHD.  For the
+//!    right-hand polarization the dispersion relation is
+//!      omega = eta k^2/2 + sqrt((eta k^2/2)^2 + k^2 v_A^2),  eta = hall_coeff*B0/rho_i
+//!    which tends to the whistler branch omega = eta k^2 at short wavelength.  Since
+//!    J is parallel to the perturbed field, this is an exact nonlinear solution.
+//!  - cshock: steady, isothermal C-type shock with transverse field in the shock frame,
+//!    with the ion density rho_i = ion_coeff*rho^ion_index (Mac Low et al. 1995, ApJ
+//!    442, 726).  The analytic profile is found by integrating the ODE for B, with the
+//!    density given by conservation of momentum.
+//! This file also contains a function to compute L1 errors at the end of the run, called
+//! in Driver::Finalize().
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <string>     // c_str()
+#include <vector>
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "mhd/mhd.hpp"
+#include "diffusion/resistivity.hpp"
+#include "pgen/pgen.hpp"
+
+// Prototype for function to compute errors at end of run
+void NonIdealMHDErrors(ParameterInput *pin, Mesh *pm);
+
+// Anonymous namespace used to prevent name collisions outside of this file
+namespace {
+struct NonIdealVariables {
+  bool cshock;
+  Real d0, p0, b0;          // background density, pressure, and parallel B
+  Real amp, k, omega, vamp; // whistler: amplitude of B and v, wavenumber, frequency
+  Real mach, mach_a, v0;    // C-shock: sonic and Alfvenic Mach numbers, inflow speed
+  Real bf, x0, h;           // C-shock: downstream B/B0, start and spacing of profile
+};
+
+NonIdealVariables nv;
+std::vector<Real> bprof;    // analytic profile of B/B0 in C-shock
+
+//----------------------------------------------------------------------------------------
+//! \fn Real CShockD()
+//! \brief Density rho/rho0 in C-shock for field b=B/B0, from conservation of momentum
+//!   1/D + D/M^2 + b^2/(2 M_A^2) = 1 + 1/M^2 + 1/(2 M_A^2)
+//! on the branch through the upstream state D=1 at b=1.
+
+KOKKOS_INLINE_FUNCTION
+Real CShockD(const Real b, const Real mach, const Real mach_a) {
+  Real im2 = 1.0/(mach*mach);
+  Real kk = 1.0 + im2 + 0.5*(1.0 - b*b)/(mach_a*mach_a);
+  return 0.5*(kk - sqrt(fmax(kk*kk - 4.0*im2, 0.0)))/im2;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real CShockB()
+//! \brief Linear interpolation of analytic C-shock profile b(x) stored at n points
+
+KOKKOS_INLINE_FUNCTION
+Real CShockB(const Real x, const DvceArray1D<Real> &prof, const int n,
+             const NonIdealVariables &v) {
+  Real s = (x - v.x0)/v.h;
+  if (s <= 0.0) {return 1.0;}
+  if (s >= static_cast<Real>(n - 1)) {return v.bf;}
+  int l = static_cast<int>(s);
+  Real f = s - static_cast<Real>(l);
+  return (1.0 - f)*prof(l) + f*prof(l+1);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CShockProfile()
+//! \brief Integrates steady-state induction equation with ambipolar diffusion,
+//!   db/dx = D^ion_index (b - D)/(L_A b^2),   L_A = q_A B0^2/(v0 ion_coeff rho0^(1+a))
+//! with RK4 from b = 1 + 1e-6, and stores the result in bprof.  The profile is shifted
+//! so that b is midway between upstream and downstream values at x=0.
+
+void CShockProfile(const Real l_a, const Real ai) {
+  // downstream state, where b = D, by bisection
+  Real im2 = 1.0/SQR(nv.mach), ima2 = 1.0/SQR(nv.mach_a);
+  Real rhs = 1.0 + im2 + 0.5*ima2;
+  Real lo = 1.0 + 1.0e-8, hi = std::sqrt(2.0*rhs/ima2);
+  for (int n=0; n<200; ++n) {
+    Real mid = 0.5*(lo + hi);
+    if (1.0/mid + mid*im2 + 0.5*mid*mid*ima2 > rhs) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  nv.bf = 0.5*(lo + hi);
+
+  auto dbdx = [=](Real b) {
+    Real d = CShockD(b, nv.mach, nv.mach_a);
+    return std::pow(d, ai)*(b - d)/(l_a*b*b);
+  };
+  nv.h = 1.0e-3*l_a;
+  bprof.clear();
+  Real b = 1.0 + 1.0e-6;
+  while ((nv.bf - b) > 1.0e-10*nv.bf && bprof.size() < 10000000) {
+    bprof.push_back(b);
+    Real k1 = dbdx(b);
+    Real k2 = dbdx(b + 0.5*nv.h*k1);
+    Real k3 = dbdx(b + 0.5*nv.h*k2);
+    Real k4 = dbdx(b + nv.h*k3);
+    b += nv.h*(k1 + 2.0*k2 + 2.0*k3 + k4)/6.0;
+  }
+  bprof.push_back(nv.bf);
+  Real bmid = 0.5*(1.0 + nv.bf);
+  std::size_t l = 0;
+  while (l < bprof.size() && bprof[l] < bmid) {l++;}
+  nv.x0 = -nv.h*static_cast<Real>(l);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn DualArray1D<Real> CopyProfile()
+//! \brief Copies C-shock profile to device
+
+DualArray1D<Real> CopyProfile() {
+  int n = static_cast<int>(bprof.size());
+  DualArray1D<Real> prof("cshock_prof", n);
+  for (int l=0; l<n; ++l) {
+    prof.h_view(l) = bprof[l];
+  }
+  prof.template modify<HostMemSpace>();
+  prof.template sync<DevExeSpace>();
+  return prof;
+}
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::NonIdealMHD()
+//! \brief Sets initial conditions for Hall whistler wave and ambipolar C-shock tests
+
+void ProblemGenerator::NonIdealMHD(ParameterInput *pin, const bool restart) {
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pmhd == nullptr || pmbp->pmhd->presist == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Non-ideal MHD tests require <mhd> block with Hall and/or ambipolar "
+              << "coefficients" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  pgen_final_func = NonIdealMHDErrors;
+  Resistivity *presist = pmbp->pmhd->presist;
+  EOS_Data &eos = pmbp->pmhd->peos->eos_data;
+  std::string test = pin->GetOrAddString("problem", "test", "whistler");
+  nv.d0 = pin->GetOrAddReal("problem", "d0", 1.0);
+  nv.p0 = pin->GetOrAddReal("problem", "p0", 1.0);
+  Real rhoi = presist->ion_coeff*std::pow(nv.d0, presist->ion_index);
+
+  if (test.compare("whistler") == 0) {
+    nv.cshock = false;
+    nv.b0 = pin->GetOrAddReal("problem", "b0", 1.0);
+    nv.amp = pin->GetOrAddReal("problem", "amp", 0.1);
+    Real lambda = pmy_mesh_->mesh_size.x1max - pmy_mesh_->mesh_size.x1min;
+    nv.k = 2.0*M_PI/lambda;
+    Real eta = presist->q_hall*nv.b0/rhoi;
+    Real whk2 = 0.5*eta*SQR(nv.k);
+    nv.omega = whk2 + std::sqrt(SQR(whk2) + SQR(nv.k)*SQR(nv.b0)/nv.d0);
+    nv.vamp = nv.k*nv.b0*nv.amp/(nv.omega*nv.d0);
+  } else if (test.compare("cshock") == 0) {
+    nv.cshock = true;
+    if (eos.is_ideal || presist->q_ambi <= 0.0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "C-shock test requires isothermal EOS and "
+                << "ambipolar_coeff > 0" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    nv.mach = pin->GetOrAddReal("problem", "mach", 50.0);
+    nv.mach_a = pin->GetOrAddReal("problem", "mach_a", 5.0);
+    if (1.0/SQR(nv.mach) + 1.0/SQR(nv.mach_a) >= 1.0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "C-shock test requires super-fast inflow" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    nv.v0 = nv.mach*eos.iso_cs;
+    nv.b0 = nv.v0*std::sqrt(nv.d0)/nv.mach_a;
+    Real l_a = presist->q_ambi*SQR(nv.b0)/(nv.v0*rhoi*nv.d0);
+    CShockProfile(l_a, presist->ion_index);
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Non-ideal MHD test '" << test << "' not recognized; choose 'whistler' "
+              << "or 'cshock'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (restart) return;
+
+  // capture variables for the kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  int nmb1 = pmbp->nmb_thispack - 1;
+  auto &u0 = pmbp->pmhd->u0;
+  auto &b0 = pmbp->pmhd->b0;
+  auto &size = pmbp->pmb->mb_size;
+  bool is_ideal = eos.is_ideal;
+  Real gm1 = eos.gamma - 1.0;
+  auto nv_ = nv;
+  DualArray1D<Real> prof;
+  int nprof = 0;
+  if (nv.cshock) {
+    prof = CopyProfile();
+    nprof = static_cast<int>(bprof.size());
+  }
+  DvceArray1D<Real> prof_ = prof.d_view;
+
+  par_for("pgen_nonideal", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real x1v = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real dens, v1, v2, v3, b1, b2, b3;
+    if (nv_.cshock) {
+      Real b = CShockB(x1v, prof_, nprof, nv_);
+      dens = nv_.d0*CShockD(b, nv_.mach, nv_.mach_a);
+      v1 = nv_.v0*nv_.d0/dens;
+      v2 = 0.0;
+      v3 = 0.0;
+      b1 = 0.0;
+      b2 = nv_.b0*b;
+      b3 = 0.0;
+    } else {
+      Real phi = nv_.k*x1v;
+      dens = nv_.d0;
+      v1 = 0.0;
+      v2 = -nv_.vamp*cos(phi);
+      v3 = nv_.vamp*sin(phi);
+      b1 = nv_.b0;
+      b2 = nv_.amp*cos(phi);
+      b3 = -nv_.amp*sin(phi);
+    }
+    u0(m,IDN,k,j,i) = dens;
+    u0(m,IM1,k,j,i) = dens*v1;
+    u0(m,IM2,k,j,i) = dens*v2;
+    u0(m,IM3,k,j,i) = dens*v3;
+    if (is_ideal) {
+      u0(m,IEN,k,j,i) = nv_.p0/gm1 + 0.5*dens*(v1*v1 + v2*v2 + v3*v3) +
+                        0.5*(b1*b1 + b2*b2 + b3*b3);
+    }
+
+    // field is uniform in transverse directions, so face values are cell-center values
+    b0.x1f(m,k,j,i) = b1;
+    b0.x2f(m,k,j,i) = b2;
+    b0.x3f(m,k,j,i) = b3;
+    if (i==ie) {b0.x1f(m,k,j,i+1) = b1;}
+    if (j==je) {b0.x2f(m,k,j+1,i) = b2;}
+    if (k==ke) {b0.x3f(m,k+1,j,i) = b3;}
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void NonIdealMHDErrors()
+//! \brief Computes L1 error in the transverse velocity and field of the whistler wave,
+//! compared to the exact solution at the current time, or in the density and field of
+//! the C-shock compared to the analytic profile, and writes it to file.  Also reports the
+//! number of RKL2 stages used for ambipolar diffusion in the last half step (if any).
+
+void NonIdealMHDErrors(ParameterInput *pin, Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &w0 = pm->pmb_pack->pmhd->w0;
+  auto &bcc0 = pm->pmb_pack->pmhd->bcc0;
+  Resistivity *presist = pm->pmb_pack->pmhd->presist;
+  auto nv_ = nv;
+  Real t = pm->time;
+  DualArray1D<Real> prof;
+  int nprof = 0;
+  if (nv.cshock) {
+    prof = CopyProfile();
+    nprof = static_cast<int>(bprof.size());
+  }
+  DvceArray1D<Real> prof_ = prof.d_view;
+
+  Real l1_err = 0.0;
+  Kokkos::parallel_reduce("nonideal_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum_err) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    if (nv_.cshock) {
+      Real b = CShockB(x, prof_, nprof, nv_);
+      Real d = CShockD(b, nv_.mach, nv_.mach_a);
+      sum_err += vol*(fabs(bcc0(m,IBY,k,j,i)/nv_.b0 - b) +
+                      fabs(w0(m,IDN,k,j,i)/nv_.d0 - d));
+    } else {
+      Real phi = nv_.k*x - nv_.omega*t;
+      sum_err += vol*(fabs(w0(m,IVY,k,j,i) + nv_.vamp*cos(phi)) +
+                      fabs(w0(m,IVZ,k,j,i) - nv_.vamp*sin(phi)) +
+                      fabs(bcc0(m,IBY,k,j,i) - nv_.amp*cos(phi)) +
+                      fabs(bcc0(m,IBZ,k,j,i) + nv_.amp*sin(phi)));
+    }
+  }, Kokkos::Sum<Real>(l1_err));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &l1_err, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  // normalize by volume of mesh, and by amplitude of wave or jump across shock
+  auto &ms = pm->mesh_size;
+  l1_err /= (ms.x1max - ms.x1min)*(ms.x2max - ms.x2min)*(ms.x3max - ms.x3min);
+  if (nv.cshock) {
+    l1_err /= (nv.bf - 1.0);
+  } else {
+    l1_err /= (nv.amp + nv.vamp);
+  }
+  int nsub = presist->ambi_nstages;
+
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Nx1  Ncycle  Substeps  L1-Error\n");
+    }
+    std::fprintf(pfile, "%04d  %05d  %03d  %e\n", pm->mesh_indcs.nx1, pm->ncycle, nsub,
+                 l1_err);
+    std::fclose(pfile);
+  }
+  return;
+}
@@ -0,0 +1,236 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file rad_relaxation.cpp
+//! \brief Built-in problem generator for the thermal relaxation of gas and (gray or
+//! multigroup) radiation in a uniform, periodic medium.  Same initial conditions as the
+//! user pgen in pgen/rad_relax.cpp, with all of the radiation in the lowest group.
+//! This file also contains a function called in Driver::Finalize() that writes the
+//! fraction of radiation energy in each group, the Planck fraction of each group at the
+//! final gas temperature, and the change in total energy.
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <string>     // c_str()
+#include <vector>
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "hydro/hydro.hpp"
+#include "driver/driver.hpp"
+#include "radiation/radiation.hpp"
+#include "radiation/radiation_opacities.hpp"
+#include "pgen/pgen.hpp"
+
+// function to compute spectrum and energy conservation at end of run
+void RadiationRelaxationErrors(ParameterInput *pin, Mesh *pm);
+
+namespace {
+Real etot0;  // total (gas plus radiation) energy at start of run
+
+//----------------------------------------------------------------------------------------
+//! \fn void RelaxationSums()
+//! \brief sums radiation energy in each group, total energy, and gas temperature over
+//! all active cells of the Mesh
+
+void RelaxationSums(Mesh *pm, std::vector<Real> &erad_g, Real &etot, Real &tgas) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  radiation::Radiation *prad = pmbp->prad;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pmbp->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  int nang = prad->prgeo->nangles;
+  int nfreq = prad->nfreq;
+  auto &i0 = prad->i0;
+  auto &u0 = pmbp->phydro->u0;
+  auto &w0 = pmbp->phydro->w0;
+  auto &solid_angles = prad->prgeo->solid_angles;
+  Real gm1 = pmbp->phydro->peos->eos_data.gamma - 1.0;
+
+  erad_g.assign(nfreq, 0.0);
+  for (int g=0; g<nfreq; ++g) {
+    Real sum_e = 0.0;
+    Kokkos::parallel_reduce("relax_erad",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &sum) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      for (int a=0; a<nang; ++a) {
+        sum += i0(m,g*nang+a,k,j,i)*solid_angles.d_view(a);
+      }
+    }, Kokkos::Sum<Real>(sum_e));
+    erad_g[g] = sum_e;
+  }
+  Real sum_egas = 0.0, sum_tgas = 0.0;
+  Kokkos::parallel_reduce("relax_egas",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum_u, Real &sum_t) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    sum_u += u0(m,IEN,k,j,i);
+    sum_t += gm1*w0(m,IEN,k,j,i)/w0(m,IDN,k,j,i);
+  }, Kokkos::Sum<Real>(sum_egas), Kokkos::Sum<Real>(sum_tgas));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, erad_g.data(), nfreq, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &sum_egas, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &sum_tgas, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  // all cells are identical, so return mean gas temperature and mean energies
+  Real ncells = static_cast<Real>(pm->nmb_total)*nkji;
+  etot = sum_egas;
+  for (int g=0; g<nfreq; ++g) {
+    erad_g[g] /= ncells;
+    etot += erad_g[g]*ncells;
+  }
+  etot /= ncells;
+  tgas = sum_tgas/ncells;
+  return;
+}
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::RadiationRelaxation()
+//! \brief Sets initial conditions for GR radiation relaxation test
+
+void ProblemGenerator::RadiationRelaxation(ParameterInput *pin, const bool restart) {
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->prad == nullptr || pmbp->phydro == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Radiation relaxation test requires <radiation> and <hydro> blocks "
+              << "in input file" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  pgen_final_func = RadiationRelaxationErrors;
+
+  if (restart) {
+    std::vector<Real> erad_g;
+    Real tgas;
+    RelaxationSums(pmy_mesh_, erad_g, etot0, tgas);
+    return;
+  }
+
+  // capture variables for kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int nmb1 = (pmbp->nmb_thispack-1);
+  int nang1 = (pmbp->prad->prgeo->nangles-1);
+
+  // get problem parameters
+  Real erad = pin->GetReal("problem", "erad");
+  Real temp = pin->GetReal("problem", "temp");
+  Real v1 = pin->GetOrAddReal("problem", "v1", 0.0);
+  Real lf = 1.0/sqrt(1.0-(SQR(v1)));
+
+  // set primitive variables
+  auto &w0 = pmbp->phydro->w0;
+  par_for("pgen_relax1",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    w0(m,IDN,k,j,i) = 1.0;
+    w0(m,IVX,k,j,i) = lf*v1;
+    w0(m,IVY,k,j,i) = 0.0;
+    w0(m,IVZ,k,j,i) = 0.0;
+    w0(m,IEN,k,j,i) = temp;  // assumes that gm1=1
+  });
+
+  // Convert primitives to conserved
+  auto &u0 = pmbp->phydro->u0;
+  pmbp->phydro->peos->PrimToCons(w0, u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
+
+  auto &norm_to_tet_ = pmbp->prad->norm_to_tet;
+  auto &nh_c_ = pmbp->prad->nh_c;
+  auto &tet_c_ = pmbp->prad->tet_c;
+  auto &tetcov_c_ = pmbp->prad->tetcov_c;
+
+  // isotropic intensity in fluid frame, all in lowest group (n = angle index)
+  auto &i0 = pmbp->prad->i0;
+  par_for("pgen_relax2",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real uu1 = w0(m,IVX,k,j,i);
+    Real uu2 = w0(m,IVY,k,j,i);
+    Real uu3 = w0(m,IVZ,k,j,i);
+    Real uu0 = sqrt(1.0 + SQR(uu1) + SQR(uu2) + SQR(uu3));
+
+    Real u_tet_[4];
+    for (int d=0; d<4; ++d) {
+      u_tet_[d] = (norm_to_tet_(m,d,0,k,j,i)*uu0 + norm_to_tet_(m,d,1,k,j,i)*uu1 +
+                   norm_to_tet_(m,d,2,k,j,i)*uu2 + norm_to_tet_(m,d,3,k,j,i)*uu3);
+    }
+
+    for (int n=0; n<=nang1; ++n) {
+      Real un_t =  (u_tet_[1]*nh_c_.d_view(n,1) + u_tet_[2]*nh_c_.d_view(n,2) +
+                    u_tet_[3]*nh_c_.d_view(n,3));
+      Real n0_f =  u_tet_[0]*nh_c_.d_view(n,0) - un_t;
+      Real ii_f =  erad/(4.0*M_PI);
+      Real n0 = tet_c_(m,0,0,k,j,i); Real n_0 = 0.0;
+      for (int d=0; d<4; ++d) {  n_0 += tetcov_c_(m,d,0,k,j,i)*nh_c_.d_view(n,d);  }
+      i0(m,n,k,j,i) = n0*n_0*ii_f/SQR(SQR(n0_f));
+    }
+  });
+
+  std::vector<Real> erad_g;
+  Real tgas;
+  RelaxationSums(pmy_mesh_, erad_g, etot0, tgas);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RadiationRelaxationErrors()
+//! \brief Writes gas temperature, relative change in total energy, and for each group
+//! the fraction of radiation energy and the Planck fraction at the gas temperature.
+
+void RadiationRelaxationErrors(ParameterInput *pin, Mesh *pm) {
+  radiation::Radiation *prad = pm->pmb_pack->prad;
+  int nfreq = prad->nfreq;
+  std::vector<Real> erad_g;
+  Real etot, tgas;
+  RelaxationSums(pm, erad_g, etot, tgas);
+  Real erad = 0.0;
+  for (int g=0; g<nfreq; ++g) {erad += erad_g[g];}
+
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Error output file could not be opened" <<std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    std::fprintf(pfile, "# Tgas  Erad  aT^4  dEtot/Etot\n");
+    std::fprintf(pfile, "%e  %e  %e  %e\n", tgas, fabs(erad),
+                 prad->arad*SQR(SQR(tgas)), (etot - etot0)/fabs(etot0));
+    std::fprintf(pfile, "# group  nu_min  nu_max  Erad_g/Erad  Planck_fraction\n");
+    for (int g=0; g<nfreq; ++g) {
+      Real nul = prad->nu_f.h_view(g), nuh = prad->nu_f.h_view(g+1);
+      Real planck = (nfreq > 1)? (PlanckIntegral(nuh/tgas) - PlanckIntegral(nul/tgas))
+                                : 1.0;
+      std::fprintf(pfile, "%d  %e  %e  %e  %e\n", g, nul, nuh, erad_g[g]/erad, planck);
+    }
+    std::fclose(pfile);
+  }
+  return;
+}
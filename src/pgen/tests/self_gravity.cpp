@@ -0,0 +1,442 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file self_gravity.cpp
+//! \brief problem generators for tests of self-gravity:
+//!   (1) jeans: growth of a Jeans-unstable linear perturbation in an isothermal gas in a
+//!       periodic domain.  Measured growth of the density perturbation is compared to
+//!       delta(t) = amp cosh(gamma t), with gamma^2 = four_pi_G d0 - (cs k)^2.
+//!   (2) uniform_sphere: potential of a uniform-density sphere with isolated boundary
+//!       conditions (run with evolution = static), compared with the analytic solution.
+//!   (3) disk_slab: potential of a slab |z| < h with a sinusoidal density perturbation in
+//!       x1 and x2, with disk boundary conditions (run with evolution = static), compared
+//!       with the analytic solution.
+//! This file also contains functions to compute errors, called in Driver::Finalize().
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <string>     // c_str()
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "gravity/gravity.hpp"
+#include "multigrid/multigrid.hpp"
+
+// Prototypes for functions to compute errors in solution at end of run
+void JeansErrors(ParameterInput *pin, Mesh *pm);
+void UniformSphereErrors(ParameterInput *pin, Mesh *pm);
+void DiskSlabErrors(ParameterInput *pin, Mesh *pm);
+
+// Anonymous namespace used to prevent name collisions outside of this file
+namespace {
+struct SelfGravityVariables {
+  Real d0, amp, cs, k, gamma;   // Jeans instability
+  Real radius, d_amb;           // uniform sphere
+  Real height, k1, k2;          // disk slab
+};
+
+SelfGravityVariables sgv;
+
+//----------------------------------------------------------------------------------------
+//! \fn FILE *OpenErrorFile()
+//! \brief Opens <basename>-errs.dat in append mode, or creates it and writes header
+
+FILE *OpenErrorFile(ParameterInput *pin, const char *header) {
+  std::string fname;
+  fname.assign(pin->GetString("job","basename"));
+  fname.append("-errs.dat");
+  FILE *pfile;
+  // The file exists -- reopen the file in append mode
+  if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+    if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Error output file could not be opened" <<std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  // The file does not exist -- open the file in write mode and add headers
+  } else {
+    if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Error output file could not be opened" <<std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    std::fprintf(pfile, "%s\n", header);
+  }
+  return pfile;
+}
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::JeansInstability()
+//! \brief Sinusoidal density perturbation in x1 in an isothermal gas at rest.
+
+void ProblemGenerator::JeansInstability(ParameterInput *pin, const bool restart) {
+  pgen_final_func = JeansErrors;
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->phydro == nullptr || pmbp->pgrav == nullptr ||
+      pmbp->phydro->peos->eos_data.is_ideal) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Jeans instability test requires <hydro> with isothermal EOS and "
+              << "<gravity> blocks" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  auto &msize = pmy_mesh_->mesh_size;
+  sgv.d0 = pin->GetOrAddReal("problem", "d0", 1.0);
+  sgv.amp = pin->GetOrAddReal("problem", "amp", 1.0e-4);
+  sgv.cs = pmbp->phydro->peos->eos_data.iso_cs;
+  sgv.k = 2.0*M_PI/(msize.x1max - msize.x1min);
+  Real gamma2 = pmbp->pgrav->four_pi_G*sgv.d0 - SQR(sgv.cs*sgv.k);
+  if (gamma2 <= 0.0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Perturbation is Jeans stable; increase <gravity>/four_pi_G"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  sgv.gamma = std::sqrt(gamma2);
+
+  // capture variables for the kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  auto &u0 = pmbp->phydro->u0;
+  Real d0_ = sgv.d0, amp_ = sgv.amp, k_ = sgv.k;
+  par_for("pgen_jeans", DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m,int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    int nx1 = indcs.nx1;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max);
+    u0(m,IDN,k,j,i) = d0_*(1.0 + amp_*cos(k_*x1v));
+    u0(m,IM1,k,j,i) = 0.0;
+    u0(m,IM2,k,j,i) = 0.0;
+    u0(m,IM3,k,j,i) = 0.0;
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void JeansErrors()
+//! \brief Projects density onto the initial perturbation, and writes measured and exact
+//! amplitude and growth rate to file.
+
+void JeansErrors(ParameterInput *pin, Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &u0 = pm->pmb_pack->phydro->u0;
+  Real d0_ = sgv.d0, k_ = sgv.k;
+  Real proj = 0.0;
+  Kokkos::parallel_reduce("jeans_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, Real &sum) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    sum += vol*(u0(m,IDN,k,j,i)/d0_ - 1.0)*cos(k_*x1v);
+  }, Kokkos::Sum<Real>(proj));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &proj, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  auto &msize = pm->mesh_size;
+  Real vol = (msize.x1max - msize.x1min)*(msize.x2max - msize.x2min)*
+             (msize.x3max - msize.x3min);
+  Real amp_num = 2.0*proj/vol;
+  Real amp_exact = sgv.amp*std::cosh(sgv.gamma*pm->time);
+  Real rel_err = std::abs(amp_num - amp_exact)/amp_exact;
+  Real gamma_num = (amp_num > sgv.amp)? std::acosh(amp_num/sgv.amp)/pm->time : 0.0;
+
+  if (global_variable::my_rank == 0) {
+    FILE *pfile = OpenErrorFile(pin, "# Nx1  Ncycle  time  amp  amp_exact  rel_err  "
+                                     "gamma  gamma_exact");
+    std::fprintf(pfile, "%04d  %05d  %e  %e  %e  %e  %e  %e\n",
+                 pm->mesh_indcs.nx1, pm->ncycle, pm->time, amp_num, amp_exact, rel_err,
+                 gamma_num, sgv.gamma);
+    std::fclose(pfile);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::UniformSphere()
+//! \brief Uniform density sphere of radius R centered on the origin.  Density in cells
+//! cut by the surface is set by the volume fraction inside the sphere, sampled on a
+//! sub-grid, so that the total mass is close to that of the exact sphere.
+
+void ProblemGenerator::UniformSphere(ParameterInput *pin, const bool restart) {
+  pgen_final_func = UniformSphereErrors;
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pgrav == nullptr || pmbp->pgrav->bc != gravity::GravityBC::isolated) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Uniform sphere test requires <gravity> block with bc = isolated"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  sgv.d0 = pin->GetOrAddReal("problem", "d0", 1.0);
+  sgv.radius = pin->GetOrAddReal("problem", "radius", 0.5);
+  sgv.d_amb = pin->GetOrAddReal("problem", "d_amb", 1.0e-8);
+
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  auto &u0 = (pmbp->phydro != nullptr)? pmbp->phydro->u0 : pmbp->pmhd->u0;
+  EOS_Data &eos = (pmbp->phydro != nullptr)? pmbp->phydro->peos->eos_data :
+                                              pmbp->pmhd->peos->eos_data;
+  Real d0_ = sgv.d0, r0 = sgv.radius, d_amb = sgv.d_amb;
+  const int nsub = 8;
+  par_for("pgen_sphere", DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m,int k, int j, int i) {
+    Real dx = size.d_view(m).dx1, dy = size.d_view(m).dx2, dz = size.d_view(m).dx3;
+    Real x0 = size.d_view(m).x1min + (i - is)*dx;
+    Real y0 = size.d_view(m).x2min + (j - js)*dy;
+    Real z0 = size.d_view(m).x3min + (k - ks)*dz;
+    int nin = 0;
+    for (int kk=0; kk<nsub; ++kk) {
+      for (int jj=0; jj<nsub; ++jj) {
+        for (int ii=0; ii<nsub; ++ii) {
+          Real x = x0 + (ii + 0.5)*dx/nsub;
+          Real y = y0 + (jj + 0.5)*dy/nsub;
+          Real z = z0 + (kk + 0.5)*dz/nsub;
+          if (x*x + y*y + z*z < r0*r0) {nin++;}
+        }
+      }
+    }
+    Real frac = static_cast<Real>(nin)/static_cast<Real>(nsub*nsub*nsub);
+    u0(m,IDN,k,j,i) = d_amb + d0_*frac;
+    u0(m,IM1,k,j,i) = 0.0;
+    u0(m,IM2,k,j,i) = 0.0;
+    u0(m,IM3,k,j,i) = 0.0;
+    if (eos.is_ideal) {
+      u0(m,IEN,k,j,i) = 1.0/(eos.gamma - 1.0);
+    }
+  });
+  if (pmbp->pmhd != nullptr) {
+    Kokkos::deep_copy(pmbp->pmhd->b0.x1f, 0.0);
+    Kokkos::deep_copy(pmbp->pmhd->b0.x2f, 0.0);
+    Kokkos::deep_copy(pmbp->pmhd->b0.x3f, 0.0);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void UniformSphereErrors()
+//! \brief Computes L1 and L-infinity errors in potential relative to analytic solution
+//!   phi = -2 pi G d0 (R^2 - r^2/3) for r < R,  phi = -G M / r for r > R
+//! normalized by the L1 norm and maximum of the analytic solution, and writes to file.
+
+void UniformSphereErrors(ParameterInput *pin, Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &phi = pm->pmb_pack->pgrav->phi;
+  Real grav_const = pm->pmb_pack->pgrav->four_pi_G/(4.0*M_PI);
+  Real r0 = sgv.radius;
+  Real mass = 4.0*M_PI*sgv.d0*r0*r0*r0/3.0;
+  Real phi_c = 2.0*M_PI*grav_const*sgv.d0;
+
+  array_sum::GlobalSum sum_this_rank;
+  Real linfty_err = 0.0;
+  Kokkos::parallel_reduce("sphere_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum, Real &max_err) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real y = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real z = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real r2 = x*x + y*y + z*z;
+    Real phi_a = (r2 < r0*r0)? -phi_c*(r0*r0 - r2/3.0) : -grav_const*mass/sqrt(r2);
+    Real err = fabs(phi(m,0,k,j,i) - phi_a);
+    array_sum::GlobalSum evars;
+    evars.the_array[0] = vol*err;
+    evars.the_array[1] = vol*fabs(phi_a);
+    mb_sum += evars;
+    max_err = fmax(max_err, err);
+  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_rank), Kokkos::Max<Real>(linfty_err));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, sum_this_rank.the_array, 2, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &linfty_err, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  Real l1_err = sum_this_rank.the_array[0]/sum_this_rank.the_array[1];
+  linfty_err /= phi_c*r0*r0;   // normalize by magnitude of central potential
+
+  if (global_variable::my_rank == 0) {
+    FILE *pfile = OpenErrorFile(pin, "# Nx1  Nx2  Nx3  Ncycles  Residual  L1  L-infty");
+    std::fprintf(pfile, "%04d  %04d  %04d  %03d  %e  %e  %e\n",
+                 pm->mesh_indcs.nx1, pm->mesh_indcs.nx2, pm->mesh_indcs.nx3,
+                 pm->pmb_pack->pgrav->pmg->ncycles, pm->pmb_pack->pgrav->pmg->residual,
+                 l1_err, linfty_err);
+    std::fclose(pfile);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::DiskSlab()
+//! \brief Slab of density d0 (1 + amp cos(k1 x + k2 y)) for |z| < h, with wavenumbers
+//! k1 = 2 pi n1/Lx1 and k2 = 2 pi n2/Lx2.  Density in cells cut by the surfaces of the
+//! slab is set by the fraction of the cell inside the slab.
+
+void ProblemGenerator::DiskSlab(ParameterInput *pin, const bool restart) {
+  pgen_final_func = DiskSlabErrors;
+  if (restart) return;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->pgrav == nullptr || pmbp->pgrav->bc != gravity::GravityBC::disk) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Disk slab test requires <gravity> block with bc = disk" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  auto &msize = pmy_mesh_->mesh_size;
+  sgv.d0 = pin->GetOrAddReal("problem", "d0", 1.0);
+  sgv.amp = pin->GetOrAddReal("problem", "amp", 0.5);
+  sgv.height = pin->GetOrAddReal("problem", "height", 0.125);
+  sgv.d_amb = pin->GetOrAddReal("problem", "d_amb", 1.0e-8);
+  sgv.k1 = 2.0*M_PI*pin->GetOrAddInteger("problem", "n1", 1)/(msize.x1max - msize.x1min);
+  sgv.k2 = 2.0*M_PI*pin->GetOrAddInteger("problem", "n2", 1)/(msize.x2max - msize.x2min);
+
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  auto &u0 = (pmbp->phydro != nullptr)? pmbp->phydro->u0 : pmbp->pmhd->u0;
+  EOS_Data &eos = (pmbp->phydro != nullptr)? pmbp->phydro->peos->eos_data :
+                                              pmbp->pmhd->peos->eos_data;
+  Real d0_ = sgv.d0, amp_ = sgv.amp, h = sgv.height, d_amb = sgv.d_amb;
+  Real k1_ = sgv.k1, k2_ = sgv.k2;
+  par_for("pgen_slab", DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m,int k, int j, int i) {
+    Real dz = size.d_view(m).dx3;
+    Real x = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real y = CellCenterX(j-js, indcs.nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real z0 = size.d_view(m).x3min + (k - ks)*dz;
+    Real frac = fmax(fmin(z0 + dz, h) - fmax(z0, -h), 0.0)/dz;
+    u0(m,IDN,k,j,i) = d_amb + d0_*(1.0 + amp_*cos(k1_*x + k2_*y))*frac;
+    u0(m,IM1,k,j,i) = 0.0;
+    u0(m,IM2,k,j,i) = 0.0;
+    u0(m,IM3,k,j,i) = 0.0;
+    if (eos.is_ideal) {
+      u0(m,IEN,k,j,i) = 1.0/(eos.gamma - 1.0);
+    }
+  });
+  if (pmbp->pmhd != nullptr) {
+    Kokkos::deep_copy(pmbp->pmhd->b0.x1f, 0.0);
+    Kokkos::deep_copy(pmbp->pmhd->b0.x2f, 0.0);
+    Kokkos::deep_copy(pmbp->pmhd->b0.x3f, 0.0);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void DiskSlabErrors()
+//! \brief Computes L1 and L-infinity errors in potential relative to analytic solution
+//! phi = phi_0(z) + cos(k1 x + k2 y) phi_k(z), with k = sqrt(k1^2 + k2^2) and
+//!   phi_0 = 2 pi G d0 (z^2 + h^2),                          phi_0 = 4 pi G d0 h |z|
+//!   phi_k = -4 pi G d0 amp (1 - exp(-k h) cosh(k z))/k^2,   for |z| < h
+//!   phi_k = -4 pi G d0 amp sinh(k h) exp(-k |z|)/k^2,       for |z| > h
+//! in which the constant in phi_0 matches the potential of the sheet set at the x3 faces.
+//! Errors are normalized by the L1 norm and maximum of the perturbation cos() phi_k, so
+//! that they measure the error in the modes set by the boundary conditions, and are
+//! written to file.
+
+void DiskSlabErrors(ParameterInput *pin, Mesh *pm) {
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
+  const int nkji = nx3*nx2*nx1;
+  const int nji  = nx2*nx1;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &phi = pm->pmb_pack->pgrav->phi;
+  Real fpg = pm->pmb_pack->pgrav->four_pi_G;
+  Real d0_ = sgv.d0, h = sgv.height, k1_ = sgv.k1, k2_ = sgv.k2;
+  Real kmag = std::sqrt(SQR(sgv.k1) + SQR(sgv.k2));
+  Real phi_k = fpg*sgv.d0*sgv.amp/SQR(kmag);
+
+  array_sum::GlobalSum sum_this_rank;
+  Real linfty_err = 0.0;
+  Kokkos::parallel_reduce("slab_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum, Real &max_err) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/nx1;
+    int i = (idx - m*nkji - k*nji - j*nx1) + is;
+    k += ks;
+    j += js;
+    Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    Real x = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real y = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real z = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real phi_0, phi_pert;
+    if (fabs(z) < h) {
+      phi_0 = 0.5*fpg*d0_*(z*z + h*h);
+      phi_pert = -phi_k*(1.0 - exp(-kmag*h)*cosh(kmag*z));
+    } else {
+      phi_0 = fpg*d0_*h*fabs(z);
+      phi_pert = -phi_k*sinh(kmag*h)*exp(-kmag*fabs(z));
+    }
+    phi_pert *= cos(k1_*x + k2_*y);
+    Real err = fabs(phi(m,0,k,j,i) - phi_0 - phi_pert);
+    array_sum::GlobalSum evars;
+    evars.the_array[0] = vol*err;
+    evars.the_array[1] = vol*fabs(phi_pert);
+    mb_sum += evars;
+    max_err = fmax(max_err, err);
+  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_rank), Kokkos::Max<Real>(linfty_err));
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, sum_this_rank.the_array, 2, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &linfty_err, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  Real l1_err = sum_this_rank.the_array[0]/sum_this_rank.the_array[1];
+  linfty_err /= phi_k*(1.0 - std::exp(-kmag*h));  // normalize by perturbation at z=0
+
+  if (global_variable::my_rank == 0) {
+    FILE *pfile = OpenErrorFile(pin, "# Nx1  Nx2  Nx3  Ncycles  Residual  L1  L-infty");
+    std::fprintf(pfile, "%04d  %04d  %04d  %03d  %e  %e  %e\n",
+                 pm->mesh_indcs.nx1, pm->mesh_indcs.nx2, pm->mesh_indcs.nx3,
+                 pm->pmb_pack->pgrav->pmg->ncycles, pm->pmb_pack->pgrav->pmg->residual,
+                 l1_err, linfty_err);
+    std::fclose(pfile);
+  }
+  return;
+}
@@ -0,0 +1,286 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file tracers.cpp
+//! \brief Problem generator for tests of tracer particles.  A sinusoidal density profile
+//! in x1 is advected by a uniform velocity in pressure equilibrium in a periodic domain.
+//!   lagrangian_tracer: tracers start at a fixed offset within each cell.  After an
+//!     integer number of crossing times in every direction they should return to the same
+//!     offset; the L1 and maximum distances from it are computed.
+//!   lagrangian_mc: tracers are placed at cell centers with probability proportional to
+//!     the cell mass.  The distribution of tracers in x1 is compared with that of the
+//!     fluid mass.
+//! This file also contains a function to compute errors, called in Driver::Finalize().
+
+// C++ headers
+#include <cmath>      // sqrt()
+#include <cstdio>     // fopen(), fprintf(), freopen()
+#include <iostream>   // endl
+#include <string>     // c_str()
+
+#include <Kokkos_Random.hpp>
+
+// Athena++ headers
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "mesh/mesh.hpp"
+#include "eos/eos.hpp"
+#include "hydro/hydro.hpp"
+#include "particles/particles.hpp"
+#include "pgen/pgen.hpp"
+
+// Prototype for function to compute errors in solution at end of run
+void TracerErrors(ParameterInput *pin, Mesh *pm);
+
+// Anonymous namespace used to prevent name collisions outside of this file
+namespace {
+struct TracerVariables {
+  Real d0, amp, vx, vy, vz;
+  Real offx, offy, offz;    // offset of lagrangian_tracer within cells (fraction of dx)
+};
+
+TracerVariables tv;
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn ProblemGenerator::Tracers()
+//! \brief Sinusoidal density profile advected by uniform flow, with tracer particles
+
+void ProblemGenerator::Tracers(ParameterInput *pin, const bool restart) {
+  pgen_final_func = TracerErrors;
+
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  if (pmbp->phydro == nullptr || pmbp->ppart == nullptr ||
+      pmbp->ppart->particle_type != ParticleType::tracer) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Tracer test requires <hydro> and <particles> blocks, with "
+              << "particle_type = tracer" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  tv.d0 = pin->GetOrAddReal("problem", "d0", 1.0);
+  tv.amp = pin->GetOrAddReal("problem", "amp", 0.5);
+  tv.vx = pin->GetOrAddReal("problem", "vx", 1.0);
+  tv.vy = pin->GetOrAddReal("problem", "vy", 0.5);
+  tv.vz = pin->GetOrAddReal("problem", "vz", 0.0);
+  tv.offx = 0.25;
+  tv.offy = 0.75;
+  tv.offz = 0.5;
+  // particles and their time step are restored from restart file
+  if (restart) return;
+  Real p0 = pin->GetOrAddReal("problem", "p0", 1.0);
+
+  // capture variables for the kernel
+  auto &indcs = pmy_mesh_->mb_indcs;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  auto &size = pmbp->pmb->mb_size;
+  auto &msize = pmy_mesh_->mesh_size;
+  auto &u0 = pmbp->phydro->u0;
+  EOS_Data &eos = pmbp->phydro->peos->eos_data;
+  Real gm1 = eos.gamma - 1.0;
+  Real kx = 2.0*M_PI/(msize.x1max - msize.x1min);
+  auto tv_ = tv;
+
+  // Initialize Hydro variables -------------------------------
+  par_for("pgen_tracer1", DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m,int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    int nx1 = indcs.nx1;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max);
+    Real dens = tv_.d0*(1.0 + tv_.amp*sin(kx*x1v));
+    u0(m,IDN,k,j,i) = dens;
+    u0(m,IM1,k,j,i) = dens*tv_.vx;
+    u0(m,IM2,k,j,i) = dens*tv_.vy;
+    u0(m,IM3,k,j,i) = dens*tv_.vz;
+    if (eos.is_ideal) {
+      u0(m,IEN,k,j,i) = p0/gm1 + 0.5*dens*(SQR(tv_.vx) + SQR(tv_.vy) + SQR(tv_.vz));
+    }
+  });
+
+  // Initialize tracers -------------------------------
+  auto &pr = pmbp->ppart->prtcl_rdata;
+  auto &pi = pmbp->ppart->prtcl_idata;
+  int npart = pmbp->ppart->nprtcl_thispack;
+  auto gids = pmbp->gids;
+  int nmb = pmbp->nmb_thispack;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int ncells = nx1*nx2*nx3;
+  bool three_d = pmy_mesh_->three_d;
+
+  if (pmbp->ppart->pusher == ParticlesPusher::lagrangian_tracer) {
+    // tracers fill cells in order, at fixed offset within each cell
+    par_for("pgen_tracer2",DevExeSpace(),0,(npart-1),
+    KOKKOS_LAMBDA(const int p) {
+      int c = p % (nmb*ncells);
+      int m = c/ncells;
+      int k = (c - m*ncells)/(nx2*nx1);
+      int j = (c - m*ncells - k*nx2*nx1)/nx1;
+      int i = c - m*ncells - k*nx2*nx1 - j*nx1;
+      pi(PGID,p) = gids + m;
+      pr(IPX,p) = size.d_view(m).x1min + (i + tv_.offx)*size.d_view(m).dx1;
+      pr(IPY,p) = size.d_view(m).x2min + (j + tv_.offy)*size.d_view(m).dx2;
+      pr(IPZ,p) = (three_d)? size.d_view(m).x3min + (k + tv_.offz)*size.d_view(m).dx3 :
+                             0.5*(size.d_view(m).x3min + size.d_view(m).x3max);
+      pr(IPVX,p) = tv_.vx;
+      pr(IPVY,p) = tv_.vy;
+      pr(IPVZ,p) = tv_.vz;
+    });
+  } else {
+    // tracers at cell centers, with probability proportional to cell mass (rejection)
+    Kokkos::Random_XorShift64_Pool<> rand_pool64(gids + 1);
+    Real dmax = tv.d0*(1.0 + fabs(tv.amp));
+    par_for("pgen_tracer3",DevExeSpace(),0,(npart-1),
+    KOKKOS_LAMBDA(const int p) {
+      auto rand_gen = rand_pool64.get_state();
+      int m, i, j, k;
+      while (true) {
+        m = static_cast<int>(rand_gen.drand()*nmb);
+        i = static_cast<int>(rand_gen.drand()*nx1);
+        j = static_cast<int>(rand_gen.drand()*nx2);
+        k = static_cast<int>(rand_gen.drand()*nx3);
+        m = (m < nmb)? m : nmb - 1;
+        i = (i < nx1)? i : nx1 - 1;
+        j = (j < nx2)? j : nx2 - 1;
+        k = (k < nx3)? k : nx3 - 1;
+        if (rand_gen.drand()*dmax < u0(m,IDN,k+ks,j+js,i+is)) break;
+      }
+      rand_pool64.free_state(rand_gen);
+      pi(PGID,p) = gids + m;
+      pr(IPX,p) = size.d_view(m).x1min + (i + 0.5)*size.d_view(m).dx1;
+      pr(IPY,p) = size.d_view(m).x2min + (j + 0.5)*size.d_view(m).dx2;
+      pr(IPZ,p) = size.d_view(m).x3min + (k + 0.5)*size.d_view(m).dx3;
+      pr(IPVX,p) = 0.0;
+      pr(IPVY,p) = 0.0;
+      pr(IPVZ,p) = 0.0;
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TracerErrors()
+//! \brief For lagrangian_tracer, computes L1 and maximum distance of tracers from their
+//! initial offset within cells (in units of dx1).  For lagrangian_mc, computes the L1
+//! difference between the fractions of tracers and of fluid mass in each column of cells
+//! in x1.  Results are written to file.
+
+void TracerErrors(ParameterInput *pin, Mesh *pm) {
+  MeshBlockPack *pmbp = pm->pmb_pack;
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, nx1 = indcs.nx1;
+  int js = indcs.js, nx2 = indcs.nx2;
+  int ks = indcs.ks, nx3 = indcs.nx3;
+  auto &size = pmbp->pmb->mb_size;
+  auto &msize = pm->mesh_size;
+  auto &pr = pmbp->ppart->prtcl_rdata;
+  int npart = pmbp->ppart->nprtcl_thispack;
+  bool multi_d = pm->multi_d;
+  bool three_d = pm->three_d;
+  Real x1min = msize.x1min, x2min = msize.x2min, x3min = msize.x3min;
+  Real dx1 = (msize.x1max - msize.x1min)/static_cast<Real>(pm->mesh_indcs.nx1);
+  Real dx2 = (msize.x2max - msize.x2min)/static_cast<Real>(pm->mesh_indcs.nx2);
+  Real dx3 = (msize.x3max - msize.x3min)/static_cast<Real>(pm->mesh_indcs.nx3);
+  auto tv_ = tv;
+
+  Real err1 = 0.0, err2 = 0.0;
+  if (pmbp->ppart->pusher == ParticlesPusher::lagrangian_tracer) {
+    // distance from initial offset within cells, assuming uniform Mesh
+    Real linf = 0.0;
+    Kokkos::parallel_reduce("tracer_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, npart),
+    KOKKOS_LAMBDA(const int &p, Real &sum, Real &max_err) {
+      Real ex = (pr(IPX,p) - x1min)/dx1 - tv_.offx;
+      ex -= round(ex);
+      Real ey = 0.0, ez = 0.0;
+      if (multi_d) {
+        ey = (pr(IPY,p) - x2min)/dx2 - tv_.offy;
+        ey -= round(ey);
+      }
+      if (three_d) {
+        ez = (pr(IPZ,p) - x3min)/dx3 - tv_.offz;
+        ez -= round(ez);
+      }
+      Real err = sqrt(ex*ex + ey*ey + ez*ez);
+      sum += err;
+      max_err = fmax(max_err, err);
+    }, Kokkos::Sum<Real>(err1), Kokkos::Max<Real>(linf));
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &err1, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &linf, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    err1 /= static_cast<Real>(pm->nprtcl_total);
+    err2 = linf;
+  } else {
+    // histograms of tracers and of fluid mass in x1, assuming uniform Mesh
+    int ncol = pm->mesh_indcs.nx1;
+    DvceArray1D<Real> ntrac("ntrac", ncol), mass("mass", ncol);
+    par_for("tracer_hist",DevExeSpace(),0,(npart-1),
+    KOKKOS_LAMBDA(const int p) {
+      int c = static_cast<int>(floor((pr(IPX,p) - x1min)/dx1));
+      c = (c < 0)? 0 : ((c >= ncol)? ncol - 1 : c);
+      Kokkos::atomic_add(&ntrac(c), 1.0);
+    });
+    auto &u0 = pmbp->phydro->u0;
+    par_for("mass_hist",DevExeSpace(),0,(pmbp->nmb_thispack-1),ks,ks+nx3-1,js,js+nx2-1,
+            is,is+nx1-1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+      int c = static_cast<int>(floor((x1v - x1min)/dx1));
+      c = (c < 0)? 0 : ((c >= ncol)? ncol - 1 : c);
+      Real vol = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+      Kokkos::atomic_add(&mass(c), u0(m,IDN,k,j,i)*vol);
+    });
+    auto ntrac_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), ntrac);
+    auto mass_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), mass);
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, ntrac_h.data(), ncol, MPI_ATHENA_REAL, MPI_SUM,
+                  MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, mass_h.data(), ncol, MPI_ATHENA_REAL, MPI_SUM,
+                  MPI_COMM_WORLD);
+#endif
+    Real ntot = 0.0, mtot = 0.0;
+    for (int c=0; c<ncol; ++c) {
+      ntot += ntrac_h(c);
+      mtot += mass_h(c);
+    }
+    // err1: tracers vs fluid mass, err2: uniform distribution vs fluid mass (reference)
+    for (int c=0; c<ncol; ++c) {
+      err1 += fabs(ntrac_h(c)/ntot - mass_h(c)/mtot);
+      err2 += fabs(1.0/static_cast<Real>(ncol) - mass_h(c)/mtot);
+    }
+  }
+
+  if (global_variable::my_rank == 0) {
+    std::string fname;
+    fname.assign(pin->GetString("job","basename"));
+    fname.append("-errs.dat");
+    FILE *pfile;
+    // The file exists -- reopen the file in append mode
+    if ((pfile = std::fopen(fname.c_str(), "r")) != nullptr) {
+      if ((pfile = std::freopen(fname.c_str(), "a", pfile)) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    // The file does not exist -- open the file in write mode and add headers
+    } else {
+      if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Error output file could not be opened" <<std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::fprintf(pfile, "# Pusher  Nx1  Nx2  Nx3  Ntracers  Ncycle  Err1  Err2\n");
+    }
+    int mc = (pmbp->ppart->pusher == ParticlesPusher::lagrangian_mc)? 1 : 0;
+    std::fprintf(pfile, "%d  %04d  %04d  %04d  %08d  %05d  %e  %e\n", mc,
+                 pm->mesh_indcs.nx1, pm->mesh_indcs.nx2, pm->mesh_indcs.nx3,
+                 pm->nprtcl_total, pm->ncycle, err1, err2);
+    std::fclose(pfile);
+  }
+  return;
+}
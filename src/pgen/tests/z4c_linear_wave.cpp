@@ -4,7 +4,9 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file z4c_linear_wave.cpp
-//! \brief z4c linear (gravitational) wave test
+//! \brief z4c linear (gravitational) wave test.  With an <mhd> block, a uniform
+//! atmosphere at rest is evolved with dynamical GRMHD on the wave spacetime (used to
+//! test the Cowling approximation, <z4c>/cowling).
 
 
 // C/C++ headers
@@ -23,6 +25,9 @@
 #include "coordinates/cell_locations.hpp"
 #include "mesh/mesh.hpp"
 #include "z4c/z4c.hpp"
+#include "coordinates/adm.hpp"
+#include "mhd/mhd.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
 #include "driver/driver.hpp"
 #include "pgen/pgen.hpp"
 
@@ -150,6 +155,31 @@ void ProblemGenerator::Z4cLinearWave(ParameterInput *pin, const bool restart) {
         u1(m,pz4c->I_Z4C_GAMY,k,j,i) = 0;
         u1(m,pz4c->I_Z4C_GAMZ,k,j,i) = 0;
       });
+
+  // uniform atmosphere at rest without magnetic fields, conserved variables computed
+  // with ADM metric of wave
+  if (set_initial_conditions && pmbp->pdyngr != nullptr) {
+    pz4c->Z4cToADM(pmbp);
+    Real dens = pin->GetOrAddReal("problem", "dens", 1.0e-10);
+    Real pgas = pin->GetOrAddReal("problem", "pgas", 1.0e-12);
+    auto &w0_ = pmbp->pmhd->w0;
+    auto &b0 = pmbp->pmhd->b0;
+    auto &bcc_ = pmbp->pmhd->bcc0;
+    par_for("pgen_linwave_mhd", DevExeSpace(), 0, (pmbp->nmb_thispack - 1),
+    ks, ke, js, je, is, ie, KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      w0_(m,IDN,k,j,i) = dens;
+      w0_(m,IPR,k,j,i) = pgas;
+      w0_(m,IVX,k,j,i) = 0.0;
+      w0_(m,IVY,k,j,i) = 0.0;
+      w0_(m,IVZ,k,j,i) = 0.0;
+      b0.x1f(m,k,j,i) = b0.x2f(m,k,j,i) = b0.x3f(m,k,j,i) = 0.0;
+      bcc_(m,IBX,k,j,i) = bcc_(m,IBY,k,j,i) = bcc_(m,IBZ,k,j,i) = 0.0;
+      if (i==ie) {b0.x1f(m,k,j,i+1) = 0.0;}
+      if (j==je) {b0.x2f(m,k,j+1,i) = 0.0;}
+      if (k==ke) {b0.x3f(m,k+1,j,i) = 0.0;}
+    });
+    pmbp->pdyngr->PrimToConInit(is, ie, js, je, ks, ke);
+  }
   return;
 }
 void Z4cLinearWaveErrors(ParameterInput *pin, Mesh *pm) {
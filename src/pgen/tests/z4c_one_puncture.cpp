@@ -0,0 +1,126 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file z4c_one_puncture.cpp
+//! \brief Built-in problem generator for a single (non-spinning) puncture, used by the
+//! apparent horizon finder regression test.  The user pgen in pgen/z4c_one_puncture.cpp
+//! calls this function, so that there is only one copy of the initial data.
+
+#include <cmath>
+#include <iostream>   // endl
+
+#include "athena.hpp"
+#include "parameter_input.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "z4c/z4c.hpp"
+#include "z4c/z4c_amr.hpp"
+#include "coordinates/adm.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "pgen/pgen.hpp"
+
+namespace {
+void ADMOnePuncture(MeshBlockPack *pmbp, ParameterInput *pin);
+void OnePunctureRefinement(MeshBlockPack* pmbp);
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProblemGenerator::Z4cOnePuncture()
+//! \brief Sets initial conditions for single puncture at (punc_center_x1,x2,x3)
+
+void ProblemGenerator::Z4cOnePuncture(ParameterInput *pin, const bool restart) {
+  user_ref_func = OnePunctureRefinement;
+  if (restart) return;
+  MeshBlockPack *pmbp = pmy_mesh_->pmb_pack;
+  auto &indcs = pmy_mesh_->mb_indcs;
+
+  if (pmbp->pz4c == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "One Puncture test can only be run in Z4c, but no <z4c> block "
+              << "in input file" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  ADMOnePuncture(pmbp, pin);
+  pmbp->pz4c->GaugePreCollapsedLapse(pmbp, pin);
+  switch (indcs.ng) {
+    case 2: pmbp->pz4c->ADMToZ4c<2>(pmbp, pin);
+            break;
+    case 3: pmbp->pz4c->ADMToZ4c<3>(pmbp, pin);
+            break;
+    case 4: pmbp->pz4c->ADMToZ4c<4>(pmbp, pin);
+            break;
+  }
+  pmbp->pz4c->Z4cToADM(pmbp);
+  switch (indcs.ng) {
+    case 2: pmbp->pz4c->ADMConstraints<2>(pmbp);
+            break;
+    case 3: pmbp->pz4c->ADMConstraints<3>(pmbp);
+            break;
+    case 4: pmbp->pz4c->ADMConstraints<4>(pmbp);
+            break;
+  }
+  return;
+}
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void ADMOnePuncture(MeshBlockPack *pmbp, ParameterInput *pin)
+//! \brief Initialize ADM vars to single puncture (no spin) in isotropic coordinates
+
+void ADMOnePuncture(MeshBlockPack *pmbp, ParameterInput *pin) {
+  // capture variables for the kernel
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  auto &size = pmbp->pmb->mb_size;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  int isg = is-indcs.ng; int ieg = ie+indcs.ng;
+  int jsg = js-indcs.ng; int jeg = je+indcs.ng;
+  int ksg = ks-indcs.ng; int keg = ke+indcs.ng;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int nmb = pmbp->nmb_thispack;
+  Real mass = pin->GetOrAddReal("problem", "punc_ADM_mass", 1.);
+  Real center_x1 = pin->GetOrAddReal("problem", "punc_center_x1", 0.);
+  Real center_x2 = pin->GetOrAddReal("problem", "punc_center_x2", 0.);
+  Real center_x3 = pin->GetOrAddReal("problem", "punc_center_x3", 0.);
+
+  adm::ADM::ADM_vars &adm = pmbp->padm->adm;
+
+  par_for("pgen one puncture", DevExeSpace(),0,nmb-1,ksg,keg,jsg,jeg,isg,ieg,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, nx1, x1min, x1max) - center_x1;
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real x2v = CellCenterX(j-js, nx2, x2min, x2max) - center_x2;
+
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, nx3, x3min, x3max) - center_x3;
+
+    Real r = sqrt(SQR(x1v) + SQR(x2v) + SQR(x3v));
+
+    // conformally flat metric, extrinsic curvature is zero (Views initialized to zero)
+    adm.psi4(m,k,j,i) = pow(1.0 + 0.5*mass/r, 4);
+    for (int a=0; a<3; ++a) {
+      for (int b=a; b<3; ++b) {
+        adm.g_dd(m,a,b,k,j,i) = (a == b ? adm.psi4(m,k,j,i) : 0.0);
+      }
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void OnePunctureRefinement(MeshBlockPack* pmbp)
+//! \brief refinement condition from Z4c AMR criteria
+
+void OnePunctureRefinement(MeshBlockPack* pmbp) {
+  pmbp->pz4c->pamr->Refine(pmbp);
+}
+} // namespace
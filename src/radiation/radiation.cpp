@@ -20,6 +20,8 @@
 #include "coordinates/coordinates.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "units/units.hpp"
+#include "utils/memory_usage.hpp"
+#include "utils/first_touch.hpp"
 #include "radiation/radiation.hpp"
 
 namespace radiation {
@@ -32,6 +34,12 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     i1("i1",1,1,1,1,1),
     iflx("iflx",1,1,1,1,1),
     divfa("divfa",1,1,1,1,1),
+    nu_f("nu_f",1),
+    dlnu("dlnu",1),
+    kappa_a_g("kappa_a_g",1),
+    kappa_s_g("kappa_s_g",1),
+    lnu_dot("lnu_dot",1,1,1,1,1),
+    divfnu("divfnu",1,1,1,1,1),
     nh_c("nh_c",1,1),
     nh_f("nh_f",1,1,1),
     tet_c("tet_c",1,1,1,1,1,1),
@@ -116,6 +124,66 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   n_0_floor = pin->GetOrAddReal("radiation","n_0_floor",0.1);
   prgeo = new GeodesicGrid(nlevel, rotate_geo, angular_fluxes);
 
+  // Setup frequency groups.  Interior group edges are logarithmically spaced between
+  // nu_min and nu_max, first and last groups extend to zero and infinite frequency.
+  nfreq = pin->GetOrAddInteger("radiation","nfreq",1);
+  if (nfreq < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation>/nfreq must be >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  nfrang = nfreq*(prgeo->nangles);
+  Kokkos::realloc(nu_f, nfreq+1);
+  Kokkos::realloc(dlnu, nfreq);
+  nu_f.h_view(0) = 0.0;
+  nu_f.h_view(nfreq) = (FLT_MAX);
+  for (int g=0; g<nfreq; ++g) {dlnu.h_view(g) = 1.0;}
+  if (nfreq > 1) {
+    if ((rad_source && is_compton_enabled) || beam_source) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Compton and beam source terms require gray radiation "
+        << "(<radiation>/nfreq=1)" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    Real nu_min = pin->GetReal("radiation","nu_min");
+    Real nu_max = pin->GetOrAddReal("radiation","nu_max",nu_min);
+    if (nu_min <= 0.0 || (nfreq > 2 && nu_max <= nu_min)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Multigroup radiation requires 0 < nu_min < nu_max" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    // with two groups, width of (open) groups in ln(nu) used for frequency shifts is ln2
+    Real dl = (nfreq > 2)? log(nu_max/nu_min)/static_cast<Real>(nfreq-2) : log(2.0);
+    for (int g=1; g<nfreq; ++g) {
+      nu_f.h_view(g) = nu_min*exp(static_cast<Real>(g-1)*dl);
+    }
+    for (int g=0; g<nfreq; ++g) {dlnu.h_view(g) = dl;}
+  }
+  nu_f.template modify<HostMemSpace>();
+  nu_f.template sync<DevExeSpace>();
+  dlnu.template modify<HostMemSpace>();
+  dlnu.template sync<DevExeSpace>();
+
+  // group opacities default to gray values
+  if (rad_source) {
+    Kokkos::realloc(kappa_a_g, nfreq);
+    Kokkos::realloc(kappa_s_g, nfreq);
+    for (int g=0; g<nfreq; ++g) {
+      Real ka = (power_opacity)? 0.0 : kappa_a;
+      kappa_a_g.h_view(g) = ka;
+      kappa_s_g.h_view(g) = kappa_s;
+      if (nfreq > 1) {
+        std::string gs = std::to_string(g);
+        kappa_a_g.h_view(g) = pin->GetOrAddReal("radiation","kappa_a_"+gs,ka);
+        kappa_s_g.h_view(g) = pin->GetOrAddReal("radiation","kappa_s_"+gs,kappa_s);
+      }
+    }
+    kappa_a_g.template modify<HostMemSpace>();
+    kappa_a_g.template sync<DevExeSpace>();
+    kappa_s_g.template modify<HostMemSpace>();
+    kappa_s_g.template sync<DevExeSpace>();
+  }
+
   int nmb = ppack->nmb_thispack;
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   {
@@ -135,6 +203,13 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   }
   }
   SetOrthonormalTetrad();
+  if (nfreq > 1) {
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(lnu_dot,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+    SetFrequencyShifts();
+  }
 
   // (3) read time-evolution option [already error checked in driver constructor]
   // Then initialize memory and algorithms for reconstruction and Riemann solvers
@@ -145,7 +220,7 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
   int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-  Kokkos::realloc(i0,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+  ReallocFirstTouch(i0,nmb,nfrang,ncells3,ncells2,ncells1);
   }
 
   // allocate memory for conserved variables on coarse mesh
@@ -154,12 +229,20 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     int nccells1 = indcs.cnx1 + 2*(indcs.ng);
     int nccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
     int nccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(coarse_i0,nmb,prgeo->nangles,nccells3,nccells2,nccells1);
+    Kokkos::realloc(coarse_i0,nmb,nfrang,nccells3,nccells2,nccells1);
   }
 
   // allocate boundary buffers for conserved (cell-centered) variables
+  int nghost = MeshBoundaryValues::GhostDepth(ppack, pin, "radiation");
   pbval_i = new MeshBoundaryValuesCC(ppack, pin, false);
-  pbval_i->InitializeBuffers(prgeo->nangles);
+  pbval_i->InitializeBuffers(nfrang, nghost);
+
+  // register arrays and boundary buffers for memory accounting
+  memory_usage::TrackArrays("Radiation", nh_c, nh_f, tet_c, tetcov_c, tet_d1_x1f,
+                            tet_d2_x2f, tet_d3_x3f, na, norm_to_tet, i0, coarse_i0, i1,
+                            iflx, divfa, beam_mask, nu_f, dlnu, kappa_a_g, kappa_s_g,
+                            lnu_dot, divfnu);
+  memory_usage::Track("Radiation", [this]() {return pbval_i->MemoryUsage();});
 
   // for time-evolving problems, continue to construct methods, allocate arrays
   if (evolution_t.compare("stationary") != 0) {
@@ -169,14 +252,21 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
       recon_method = ReconstructionMethod::dc;
     } else if (xorder.compare("plm") == 0) {
       recon_method = ReconstructionMethod::plm;
+      // check that nghost > 1
+      if (nghost < 2) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << xorder << " reconstruction requires at least 2 ghost zones, "
+          << "but <radiation>/nghost=" << nghost << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
     } else if (xorder.compare("ppm4") == 0 ||
                xorder.compare("ppmx") == 0 ||
                xorder.compare("wenoz") == 0) {
       // check that nghost > 2
-      if (indcs.ng < 3) {
+      if (nghost < 3) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << xorder << " reconstruction requires at least 3 ghost zones, "
-          << "but <mesh>/nghost=" << indcs.ng << std::endl;
+          << "but <radiation>/nghost=" << nghost << std::endl;
         std::exit(EXIT_FAILURE);
       }
       if (xorder.compare("ppm4") == 0) {
@@ -198,12 +288,15 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(i1,      nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x1f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x2f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x3f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+    ReallocFirstTouch(i1,      nmb,nfrang,ncells3,ncells2,ncells1);
+    ReallocFirstTouch(iflx.x1f,nmb,nfrang,ncells3,ncells2,ncells1);
+    ReallocFirstTouch(iflx.x2f,nmb,nfrang,ncells3,ncells2,ncells1);
+    ReallocFirstTouch(iflx.x3f,nmb,nfrang,ncells3,ncells2,ncells1);
     if (angular_fluxes) {
-      Kokkos::realloc(divfa,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+      Kokkos::realloc(divfa,nmb,nfrang,ncells3,ncells2,ncells1);
+    }
+    if (nfreq > 1) {
+      Kokkos::realloc(divfnu,nmb,nfrang,ncells3,ncells2,ncells1);
     }
     if (beam_source) {
       Kokkos::realloc(beam_mask,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
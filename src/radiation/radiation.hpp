@@ -112,6 +112,20 @@ class Radiation {
   Real n_0_floor;                     // floor on n_0
   GeodesicGrid *prgeo = nullptr;      // pointer to radiation angular mesh
 
+  // Frequency groups.  Intensities of all groups are stored in second index of i0 as
+  // n = g*nangles + angle, so that loops over angles and groups collapse into a single
+  // index and the innermost (x1) loop remains unit stride.  Gray when nfreq=1.
+  int nfreq;                          // number of frequency groups
+  int nfrang;                         // number of intensities per cell (nfreq*nangles)
+  DualArray1D<Real> nu_f;             // group edges (h nu/k in temperature units)
+  DualArray1D<Real> dlnu;             // widths of groups in ln(nu)
+  DualArray1D<Real> kappa_a_g;        // absorption coefficient of each group
+  DualArray1D<Real> kappa_s_g;        // scattering coefficient of each group
+  DvceArray5D<Real> lnu_dot;          // rate of gravitational frequency shift d(ln nu)/dt
+  DvceArray5D<Real> divfnu;           // frequency-space flux divergence
+  void SetFrequencyShifts();
+  void AddMultigroupSourceTerm(const Real dt);
+
   // Tetrad arrays and functions
   DualArray2D<Real> nh_c;             // normal vector computed at face center
   DualArray3D<Real> nh_f;             // normal vector computed at face edges
@@ -29,7 +29,8 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   int &is = indcs.is, &ie = indcs.ie;
   int &js = indcs.js, &je = indcs.je;
   int &ks = indcs.ks, &ke = indcs.ke;
-  int nang1 = prgeo->nangles - 1;
+  int nang = prgeo->nangles;
+  int nfrang1 = nfrang - 1;
   int nmb1 = pmy_pack->nmb_thispack - 1;
 
   const auto &recon_method_ = recon_method;
@@ -43,11 +44,12 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
 
   auto &t1d1 = tet_d1_x1f;
   auto &flx1 = iflx.x1f;
-  par_for("rflux_x1",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie+1,
+  par_for("rflux_x1",DevExeSpace(),0,nmb1,0,nfrang1,ks,ke,js,je,is,ie+1,
   KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    int a = n%nang;  // angle index
     // calculate n^1 (hence determining upwinding direction)
-    Real n1 = t1d1(m,0,k,j,i)*nh_c_.d_view(n,0) + t1d1(m,1,k,j,i)*nh_c_.d_view(n,1)
-            + t1d1(m,2,k,j,i)*nh_c_.d_view(n,2) + t1d1(m,3,k,j,i)*nh_c_.d_view(n,3);
+    Real n1 = t1d1(m,0,k,j,i)*nh_c_.d_view(a,0) + t1d1(m,1,k,j,i)*nh_c_.d_view(a,1)
+            + t1d1(m,2,k,j,i)*nh_c_.d_view(a,2) + t1d1(m,3,k,j,i)*nh_c_.d_view(a,3);
 
     // convert to primitive n_0 I
     Real iim1, iicc, iim2, iip1, iim3, iip2;
@@ -99,11 +101,12 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->multi_d) {
     auto &t2d2 = tet_d2_x2f;
     auto &flx2 = iflx.x2f;
-    par_for("rflux_x2",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je+1,is,ie,
+    par_for("rflux_x2",DevExeSpace(),0,nmb1,0,nfrang1,ks,ke,js,je+1,is,ie,
     KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      int a = n%nang;  // angle index
       // calculate n^2 (hence determining upwinding direction)
-      Real n2 = t2d2(m,0,k,j,i)*nh_c_.d_view(n,0) + t2d2(m,1,k,j,i)*nh_c_.d_view(n,1)
-              + t2d2(m,2,k,j,i)*nh_c_.d_view(n,2) + t2d2(m,3,k,j,i)*nh_c_.d_view(n,3);
+      Real n2 = t2d2(m,0,k,j,i)*nh_c_.d_view(a,0) + t2d2(m,1,k,j,i)*nh_c_.d_view(a,1)
+              + t2d2(m,2,k,j,i)*nh_c_.d_view(a,2) + t2d2(m,3,k,j,i)*nh_c_.d_view(a,3);
 
       // convert to primitive n_0 I
       Real iim1, iicc, iim2, iip1, iim3, iip2;
@@ -156,11 +159,12 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->three_d) {
     auto &t3d3 = tet_d3_x3f;
     auto &flx3 = iflx.x3f;
-    par_for("rflux_x3",DevExeSpace(),0,nmb1,0,nang1,ks,ke+1,js,je,is,ie,
+    par_for("rflux_x3",DevExeSpace(),0,nmb1,0,nfrang1,ks,ke+1,js,je,is,ie,
     KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      int a = n%nang;  // angle index
       // calculate n^3 (hence determining upwinding direction)
-      Real n3 = t3d3(m,0,k,j,i)*nh_c_.d_view(n,0) + t3d3(m,1,k,j,i)*nh_c_.d_view(n,1)
-              + t3d3(m,2,k,j,i)*nh_c_.d_view(n,2) + t3d3(m,3,k,j,i)*nh_c_.d_view(n,3);
+      Real n3 = t3d3(m,0,k,j,i)*nh_c_.d_view(a,0) + t3d3(m,1,k,j,i)*nh_c_.d_view(a,1)
+              + t3d3(m,2,k,j,i)*nh_c_.d_view(a,2) + t3d3(m,3,k,j,i)*nh_c_.d_view(a,3);
 
       // convert to primitive n_0 I
       Real iim1, iicc, iim2, iip1, iim3, iip2;
@@ -219,19 +223,49 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
     auto &na_ = na;
     auto &divfa_ = divfa;
 
-    par_for("rflux_angular",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
+    par_for("rflux_angular",DevExeSpace(),0,nmb1,0,nfrang1,ks,ke,js,je,is,ie,
     KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      int a = n%nang;  // angle index
+      int n_g = n - a; // index of first angle in this frequency group
       divfa_(m,n,k,j,i) = 0.0;
-      for (int nb=0; nb<numn.d_view(n); ++nb) {
-        Real flx_edge = na_(m,n,k,j,i,nb) *
-                        ((na_(m,n,k,j,i,nb) < 0.0) ?
-                         i0_(m,indn.d_view(n,nb),k,j,i)/tet_c_(m,0,0,k,j,i) :
+      for (int nb=0; nb<numn.d_view(a); ++nb) {
+        Real flx_edge = na_(m,a,k,j,i,nb) *
+                        ((na_(m,a,k,j,i,nb) < 0.0) ?
+                         i0_(m,n_g+indn.d_view(a,nb),k,j,i)/tet_c_(m,0,0,k,j,i) :
                          i0_(m,n,k,j,i)/tet_c_(m,0,0,k,j,i));
-        divfa_(m,n,k,j,i) += (arcl.d_view(n,nb)*flx_edge/solid_angles_.d_view(n));
+        divfa_(m,n,k,j,i) += (arcl.d_view(a,nb)*flx_edge/solid_angles_.d_view(a));
       }
     });
   }
 
+  //--------------------------------------------------------------------------------------
+  // Frequency fluxes: upwind transfer of intensity between neighboring groups due to
+  // gravitational frequency shifts, assuming intensity is uniform in ln(nu) within a
+  // group.  Total intensity summed over groups is unchanged.
+
+  if (nfreq > 1) {
+    int nfreq_ = nfreq;
+    auto &lnu_dot_ = lnu_dot;
+    auto &dlnu_ = dlnu;
+    auto &divfnu_ = divfnu;
+    par_for("rflux_freq",DevExeSpace(),0,nmb1,0,nfrang1,ks,ke,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      int g = n/nang;  // frequency group index
+      int a = n - g*nang;
+      Real rate = lnu_dot_(m,a,k,j,i);
+      Real flx_lo = 0.0, flx_hi = 0.0;
+      if (g > 0) {
+        flx_lo = (rate > 0.0) ? rate*i0_(m,n-nang,k,j,i)/dlnu_.d_view(g-1) :
+                                rate*i0_(m,n,k,j,i)/dlnu_.d_view(g);
+      }
+      if (g < nfreq_-1) {
+        flx_hi = (rate > 0.0) ? rate*i0_(m,n,k,j,i)/dlnu_.d_view(g) :
+                                rate*i0_(m,n+nang,k,j,i)/dlnu_.d_view(g+1);
+      }
+      divfnu_(m,n,k,j,i) = flx_hi - flx_lo;
+    });
+  }
+
   return TaskStatus::complete;
 }
 
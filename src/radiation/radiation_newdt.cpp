@@ -106,6 +106,28 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->three_d) { dtnew = std::min(dtnew, dt3); }
   if (angular_fluxes_) { dtnew = std::min(dtnew, dta); }
 
+  // limit on frequency shifts between groups
+  if (nfreq > 1) {
+    Real dtf = std::numeric_limits<float>::max();
+    Real dlnu_min = dlnu.h_view(0);
+    for (int g=1; g<nfreq; ++g) {dlnu_min = std::min(dlnu_min, dlnu.h_view(g));}
+    auto &lnu_dot_ = lnu_dot;
+    Kokkos::parallel_reduce("RadFreqNudt",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &min_dtf) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      for (int n=0; n<=nang1; ++n) {
+        Real rate = fabs(lnu_dot_(m,n,k,j,i));
+        if (rate > 0.0) { min_dtf = fmin(dlnu_min/rate, min_dtf); }
+      }
+    }, Kokkos::Min<Real>(dtf));
+    dtnew = std::min(dtnew, dtf);
+  }
+
   return TaskStatus::complete;
 }
 } // namespace radiation
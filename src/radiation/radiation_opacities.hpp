@@ -45,4 +45,31 @@ void OpacityFunction(// density and density scale
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Real PlanckIntegral
+//! \brief fraction of frequency-integrated Planck function a_r T^4 with h nu/(k T) < x,
+//! i.e. (15/pi^4) int_0^x t^3/(e^t - 1) dt.  Uses series expansion in x for x < 1.5, and
+//! in exp(-x) otherwise (accurate to better than 1e-7).
+
+KOKKOS_INLINE_FUNCTION
+Real PlanckIntegral(const Real x) {
+  const Real norm = 15.0/(SQR(SQR(M_PI)));
+  if (x <= 0.0) {
+    return 0.0;
+  } else if (x < 1.5) {
+    Real x2 = x*x;
+    Real x3 = x2*x;
+    return norm*x3*(1.0/3.0 - x/8.0 + x2/60.0 - x2*x2/5040.0 + x2*x2*x2/272160.0
+                    - x2*x2*x2*x2/13305600.0);
+  } else if (x > 100.0) {
+    return 1.0;
+  }
+  Real sum = 0.0;
+  for (int k=1; k<=10; ++k) {
+    Real rk = 1.0/static_cast<Real>(k);
+    sum += exp(-k*x)*rk*(x*x*x + 3.0*x*x*rk + 6.0*x*rk*rk + 6.0*rk*rk*rk);
+  }
+  return 1.0 - norm*sum;
+}
+
 #endif // RADIATION_RADIATION_OPACITIES_HPP_
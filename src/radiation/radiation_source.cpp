@@ -26,6 +26,48 @@ namespace radiation {
 KOKKOS_INLINE_FUNCTION
 bool FourthPolyRoot(const Real coef4, const Real tconst, Real &root);
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn Real CovariantN0()
+//! \brief covariant time component n_0 of tetrad-frame direction n at cell (k,j,i)
+
+KOKKOS_INLINE_FUNCTION
+Real CovariantN0(const DvceArray6D<Real> &tc, const DualArray2D<Real> &nh_c,
+                 const int m, const int n, const int k, const int j, const int i) {
+  return tc(m,0,0,k,j,i)*nh_c.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c.d_view(n,1)
+       + tc(m,2,0,k,j,i)*nh_c.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c.d_view(n,3);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ShiftGroups()
+//! \brief Shifts spectrum of intensities with angle index a by s in ln(nu), in place.
+//! Intensity is assumed uniform in ln(nu) within each group, so that a fraction s/dlnu
+//! of each group moves into its neighbor.  Open-ended first and last groups retain
+//! intensity shifted beyond the frequency grid, so the sum over groups is conserved.
+
+KOKKOS_INLINE_FUNCTION
+void ShiftGroups(const DvceArray5D<Real> &i0, const DualArray1D<Real> &dlnu,
+                 const int nfreq, const int nang, const int m, const int a,
+                 const int k, const int j, const int i, const Real s) {
+  if (s > 0.0) {
+    // move up in frequency, from highest group down so each group is shifted once
+    for (int g=nfreq-1; g>0; --g) {
+      Real dmove = fmin(s/dlnu.d_view(g-1), 1.0)*i0(m,(g-1)*nang+a,k,j,i);
+      i0(m,g*nang+a,k,j,i) += dmove;
+      i0(m,(g-1)*nang+a,k,j,i) -= dmove;
+    }
+  } else if (s < 0.0) {
+    // move down in frequency, starting from lowest group
+    for (int g=0; g<nfreq-1; ++g) {
+      Real dmove = fmin(-s/dlnu.d_view(g+1), 1.0)*i0(m,(g+1)*nang+a,k,j,i);
+      i0(m,g*nang+a,k,j,i) += dmove;
+      i0(m,(g+1)*nang+a,k,j,i) -= dmove;
+    }
+  }
+  return;
+}
+} // end anonymous namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage)
 // \brief Add implicit radiation source term.  Based off of @c-white and @yanfeij's gr_rad
@@ -120,6 +162,12 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     }
   }
 
+  // frequency-dependent source terms computed separately
+  if (nfreq > 1) {
+    AddMultigroupSourceTerm(dt_);
+    return TaskStatus::complete;
+  }
+
   // compute implicit source term
   par_for("radiation_source",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
   KOKKOS_LAMBDA(int m, int k, int j, int i) {
@@ -392,6 +440,278 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::AddMultigroupSourceTerm()
+//! \brief Implicit absorption, emission, and (elastic) scattering for multigroup
+//! radiation, generalizing the gray update in AddRadiationSourceTerm().  Intensities are
+//! first remapped to fluid-frame frequency groups (a Doppler shift by ln(n0_cm) in
+//! ln(nu) for each angle), then updated using group opacities and Planck fractions of
+//! each group evaluated at the old gas temperature, which leaves a single quartic for
+//! the new gas temperature.  Intensities are finally remapped back to tetrad-frame
+//! groups, and the change in moments is applied to the fluid.  Fluid primitives are
+//! assumed to be up to date.
+
+void Radiation::AddMultigroupSourceTerm(const Real dt_) {
+  // Extract indices, size data, hydro/mhd/units flags, and coupling flags
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nang = prgeo->nangles;
+  int nang1 = nang - 1;
+  int nfreq_ = nfreq;
+  auto &size = pmy_pack->pmb->mb_size;
+  bool &is_hydro_enabled_ = is_hydro_enabled;
+  bool &are_units_enabled_ = are_units_enabled;
+  bool &affect_fluid_ = affect_fluid;
+
+  // Extract coordinate/excision data
+  auto &coord = pmy_pack->pcoord->coord_data;
+  bool &flat = coord.is_minkowski;
+  Real &spin = coord.bh_spin;
+  bool &excise = pmy_pack->pcoord->coord_data.bh_excise;
+  auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
+  Real &n_0_floor_ = n_0_floor;
+
+  // Extract radiation constant and units
+  Real &arad_ = arad;
+  Real density_scale_ = 1.0, temperature_scale_ = 1.0, length_scale_ = 1.0;
+  Real mean_mol_weight_ = 1.0;
+  Real rosseland_coef_ = 1.0, planck_minus_rosseland_coef_ = 0.0;
+  if (are_units_enabled_) {
+    density_scale_ = pmy_pack->punit->density_cgs();
+    temperature_scale_ = pmy_pack->punit->temperature_cgs();
+    length_scale_ = pmy_pack->punit->length_cgs();
+    mean_mol_weight_ = pmy_pack->punit->mu();
+    rosseland_coef_ = pmy_pack->punit->rosseland_coef_cgs;
+    planck_minus_rosseland_coef_ = pmy_pack->punit->planck_minus_rosseland_coef_cgs;
+  }
+
+  // Extract adiabatic index and fluid quantities
+  Real gm1;
+  DvceArray5D<Real> u0_, w0_;
+  if (is_hydro_enabled_) {
+    gm1 = pmy_pack->phydro->peos->eos_data.gamma - 1.0;
+    u0_ = pmy_pack->phydro->u0;
+    w0_ = pmy_pack->phydro->w0;
+  } else {
+    gm1 = pmy_pack->pmhd->peos->eos_data.gamma - 1.0;
+    u0_ = pmy_pack->pmhd->u0;
+    w0_ = pmy_pack->pmhd->w0;
+  }
+
+  // Extract radiation, radiation frame, angular mesh, and frequency group data
+  auto &i0_ = i0;
+  bool &power_opacity_ = power_opacity;
+  auto &kappa_a_g_ = kappa_a_g;
+  auto &kappa_s_g_ = kappa_s_g;
+  auto &nu_f_ = nu_f;
+  auto &dlnu_ = dlnu;
+  auto &nh_c_ = nh_c;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &norm_to_tet_ = norm_to_tet;
+  auto &solid_angles_ = prgeo->solid_angles;
+
+  par_for("radiation_source_mg",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real &x1min = size.d_view(m).x1min;
+    Real &x1max = size.d_view(m).x1max;
+    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+    Real &x2min = size.d_view(m).x2min;
+    Real &x2max = size.d_view(m).x2max;
+    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+    Real &x3min = size.d_view(m).x3min;
+    Real &x3max = size.d_view(m).x3max;
+    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+    // compute metric and inverse
+    Real glower[4][4], gupper[4][4];
+    ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+    Real alpha = sqrt(-1.0/gupper[0][0]);
+
+    // fluid state
+    Real &wdn = w0_(m,IDN,k,j,i);
+    Real &wvx = w0_(m,IVX,k,j,i);
+    Real &wvy = w0_(m,IVY,k,j,i);
+    Real &wvz = w0_(m,IVZ,k,j,i);
+    Real &wen = w0_(m,IEN,k,j,i);
+
+    // derived quantities
+    Real pgas = gm1*wen;
+    Real tgas = pgas/wdn;
+    Real q = glower[1][1]*wvx*wvx + 2.0*glower[1][2]*wvx*wvy + 2.0*glower[1][3]*wvx*wvz
+           + glower[2][2]*wvy*wvy + 2.0*glower[2][3]*wvy*wvz
+           + glower[3][3]*wvz*wvz;
+    Real gamma = sqrt(1.0 + q);
+    Real u0 = gamma/alpha;
+
+    // compute fluid velocity in tetrad frame
+    Real u_tet[4];
+    for (int d=0; d<4; ++d) {
+      u_tet[d] = (norm_to_tet_(m,d,0,k,j,i)*gamma + norm_to_tet_(m,d,1,k,j,i)*wvx +
+                  norm_to_tet_(m,d,2,k,j,i)*wvy   + norm_to_tet_(m,d,3,k,j,i)*wvz);
+    }
+
+    // coordinate component n^0
+    Real n0 = tt(m,0,0,k,j,i);
+
+    // compute moments before coupling, then remap intensities to fluid-frame groups
+    Real m_old[4] = {0.0};
+    Real wght_sum = 0.0;
+    for (int a=0; a<=nang1; ++a) {
+      Real n_0 = CovariantN0(tc, nh_c_, m, a, k, j, i);
+      Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,1,k,j,i)*nh_c_.d_view(a,1)
+               + tc(m,2,1,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,1,k,j,i)*nh_c_.d_view(a,3);
+      Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,2,k,j,i)*nh_c_.d_view(a,1)
+               + tc(m,2,2,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,2,k,j,i)*nh_c_.d_view(a,3);
+      Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,3,k,j,i)*nh_c_.d_view(a,1)
+               + tc(m,2,3,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,3,k,j,i)*nh_c_.d_view(a,3);
+      for (int g=0; g<nfreq_; ++g) {
+        Real &ii = i0_(m,g*nang+a,k,j,i);
+        m_old[0] += (    ii    *solid_angles_.d_view(a));
+        m_old[1] += (n_1*ii/n_0*solid_angles_.d_view(a));
+        m_old[2] += (n_2*ii/n_0*solid_angles_.d_view(a));
+        m_old[3] += (n_3*ii/n_0*solid_angles_.d_view(a));
+      }
+      Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                    u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+      wght_sum += solid_angles_.d_view(a)/SQR(n0_cm);
+      ShiftGroups(i0_, dlnu_, nfreq_, nang, m, a, k, j, i, log(n0_cm));
+    }
+
+    // Calculate polynomial coefficients, summed over groups.  Planck fraction of each
+    // group is evaluated at old gas temperature.
+    Real coef[2] = {-tgas, 0.0};
+    for (int g=0; g<nfreq_; ++g) {
+      Real sigma_a, sigma_s, sigma_p;
+      OpacityFunction(wdn, density_scale_, tgas, temperature_scale_, length_scale_, gm1,
+                      mean_mol_weight_, power_opacity_, rosseland_coef_,
+                      planck_minus_rosseland_coef_, kappa_a_g_.d_view(g),
+                      kappa_s_g_.d_view(g), 0.0, sigma_a, sigma_s, sigma_p);
+      Real dtcsiga = dt_*sigma_a;
+      Real dtcsigs = dt_*sigma_s;
+      Real frac = PlanckIntegral(nu_f_.d_view(g+1)/tgas)
+                - PlanckIntegral(nu_f_.d_view(g)/tgas);
+      Real suma1 = 0.0, suma2 = 0.0;
+      for (int a=0; a<=nang1; ++a) {
+        Real n_0 = CovariantN0(tc, nh_c_, m, a, k, j, i);
+        Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                      u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+        Real omega_cm = solid_angles_.d_view(a)/SQR(n0_cm);
+        Real intensity_cm = 4.0*M_PI*(i0_(m,g*nang+a,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+        Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+        suma1 += omega_cm*n0_cm*vncsigma;
+        suma2 += intensity_cm*omega_cm*n0*vncsigma;
+      }
+      suma1 /= wght_sum;
+      suma2 /= wght_sum;
+      Real suma3 = suma1*dtcsigs;
+      suma1 *= dtcsiga;
+      coef[1] += (dtcsiga/u0)*frac*(1.0 - suma1/(1.0 - suma3))*arad_*gm1/wdn;
+      coef[0] -= (dtcsiga/u0)*suma2*gm1/(wdn*(1.0 - suma3));
+    }
+
+    // Calculate new gas temperature
+    Real tgasnew = tgas;
+    bool badcell = false;
+    if (fabs(coef[1]) > 1.0e-20) {
+      bool flag = FourthPolyRoot(coef[1], coef[0], tgasnew);
+      if (!(flag) || !(isfinite(tgasnew))) {
+        badcell = true;
+        tgasnew = tgas;
+      }
+    } else {
+      tgasnew = -coef[0];
+    }
+
+    // Update the specific intensity of each group in fluid frame
+    if (!(badcell)) {
+      Real emission = arad_*SQR(SQR(tgasnew));
+      for (int g=0; g<nfreq_; ++g) {
+        Real sigma_a, sigma_s, sigma_p;
+        OpacityFunction(wdn, density_scale_, tgas, temperature_scale_, length_scale_,
+                        gm1, mean_mol_weight_, power_opacity_, rosseland_coef_,
+                        planck_minus_rosseland_coef_, kappa_a_g_.d_view(g),
+                        kappa_s_g_.d_view(g), 0.0, sigma_a, sigma_s, sigma_p);
+        Real dtcsiga = dt_*sigma_a;
+        Real dtcsigs = dt_*sigma_s;
+        Real emission_g = emission*(PlanckIntegral(nu_f_.d_view(g+1)/tgas)
+                                  - PlanckIntegral(nu_f_.d_view(g)/tgas));
+        Real suma1 = 0.0, suma2 = 0.0;
+        for (int a=0; a<=nang1; ++a) {
+          Real n_0 = CovariantN0(tc, nh_c_, m, a, k, j, i);
+          Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                        u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+          Real omega_cm = solid_angles_.d_view(a)/SQR(n0_cm);
+          Real intensity_cm = 4.0*M_PI*(i0_(m,g*nang+a,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+          Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+          suma1 += omega_cm*n0_cm*vncsigma;
+          suma2 += intensity_cm*omega_cm*n0*vncsigma;
+        }
+        suma1 /= wght_sum;
+        suma2 /= wght_sum;
+        Real suma3 = suma1*dtcsigs;
+        suma1 *= dtcsiga;
+        Real jr_cm = (suma1*emission_g + suma2)/(1.0 - suma3);
+        for (int a=0; a<=nang1; ++a) {
+          Real n_0 = CovariantN0(tc, nh_c_, m, a, k, j, i);
+          Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                        u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+          Real &ii = i0_(m,g*nang+a,k,j,i);
+          Real intensity_cm = 4.0*M_PI*(ii/(n0*n_0))*SQR(SQR(n0_cm));
+          Real vncsigma2 = n0_cm/(n0 + (dtcsiga + dtcsigs)*n0_cm);
+          Real di_cm = (dtcsigs*jr_cm + dtcsiga*emission_g
+                        - (dtcsigs + dtcsiga)*intensity_cm)*vncsigma2;
+          ii = n0*n_0*fmax(ii/(n0*n_0) + di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+        }
+      }
+    }
+
+    // remap intensities back to tetrad-frame groups and compute moments after coupling
+    Real m_new[4] = {0.0};
+    for (int a=0; a<=nang1; ++a) {
+      Real n0_cm = (u_tet[0]*nh_c_.d_view(a,0) - u_tet[1]*nh_c_.d_view(a,1) -
+                    u_tet[2]*nh_c_.d_view(a,2) - u_tet[3]*nh_c_.d_view(a,3));
+      ShiftGroups(i0_, dlnu_, nfreq_, nang, m, a, k, j, i, -log(n0_cm));
+      Real n_0 = CovariantN0(tc, nh_c_, m, a, k, j, i);
+      Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,1,k,j,i)*nh_c_.d_view(a,1)
+               + tc(m,2,1,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,1,k,j,i)*nh_c_.d_view(a,3);
+      Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,2,k,j,i)*nh_c_.d_view(a,1)
+               + tc(m,2,2,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,2,k,j,i)*nh_c_.d_view(a,3);
+      Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,3,k,j,i)*nh_c_.d_view(a,1)
+               + tc(m,2,3,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,3,k,j,i)*nh_c_.d_view(a,3);
+      for (int g=0; g<nfreq_; ++g) {
+        Real &ii = i0_(m,g*nang+a,k,j,i);
+        m_new[0] += (    ii    *solid_angles_.d_view(a));
+        m_new[1] += (n_1*ii/n_0*solid_angles_.d_view(a));
+        m_new[2] += (n_2*ii/n_0*solid_angles_.d_view(a));
+        m_new[3] += (n_3*ii/n_0*solid_angles_.d_view(a));
+        // handle excision after moments are computed, so that excised radiation is not
+        // deposited in the fluid (see notes in AddRadiationSourceTerm)
+        if (excise) {
+          if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { ii = 0.0; }
+        }
+      }
+    }
+
+    // update conserved fluid variables.  In badcells intensities are only remapped to
+    // fluid-frame groups and back, which need not be exact inverses, so any change in the
+    // radiation moments is still returned to the fluid
+    if (affect_fluid_) {
+      u0_(m,IEN,k,j,i) += (m_old[0] - m_new[0]);
+      u0_(m,IM1,k,j,i) += (m_old[1] - m_new[1]);
+      u0_(m,IM2,k,j,i) += (m_old[2] - m_new[2]);
+      u0_(m,IM3,k,j,i) += (m_old[3] - m_new[3]);
+    }
+  });
+
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  bool FourthPolyRoot
 //  \brief Exact solution for fourth order polynomial of
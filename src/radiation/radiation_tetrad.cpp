@@ -277,4 +277,74 @@ void Radiation::SetOrthonormalTetrad() {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::SetFrequencyShifts()
+//! \brief Computes rate of change of ln(nu) of photons travelling in each angle, as
+//! measured in the tetrad frame.  In a stationary spacetime p_t is conserved along rays,
+//! so nu = p_t/n_0 and d(ln nu)/dt = -(n^i/n^0) d_i ln|n_0|, with the derivative taken
+//! at fixed tetrad-frame direction.  Zero in Minkowski space and in excised cells.
+
+void Radiation::SetFrequencyShifts() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nang1 = prgeo->nangles - 1;
+  auto &size = pmy_pack->pmb->mb_size;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  auto &excise = pmy_pack->pcoord->coord_data.bh_excise;
+  auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
+  Real &n_0_floor_ = n_0_floor;
+
+  auto &nh_c_ = nh_c;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &lnu_dot_ = lnu_dot;
+  par_for("lnu_dot",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    lnu_dot_(m,n,k,j,i) = 0.0;
+    if (excise) {
+      if (rad_mask_(m,k,j,i)) return;
+    }
+    // find smallest |n_0| over stencil, skip cells where n_0 approaches zero
+    Real n_0 = 0.0, n_0m[3] = {0.0}, n_0p[3] = {0.0};
+    for (int d=0; d<4; ++d) {
+      n_0 += tc(m,d,0,k,j,i)*nh_c_.d_view(n,d);
+      n_0m[0] += tc(m,d,0,k,j,i-1)*nh_c_.d_view(n,d);
+      n_0p[0] += tc(m,d,0,k,j,i+1)*nh_c_.d_view(n,d);
+      if (multi_d) {
+        n_0m[1] += tc(m,d,0,k,j-1,i)*nh_c_.d_view(n,d);
+        n_0p[1] += tc(m,d,0,k,j+1,i)*nh_c_.d_view(n,d);
+      }
+      if (three_d) {
+        n_0m[2] += tc(m,d,0,k-1,j,i)*nh_c_.d_view(n,d);
+        n_0p[2] += tc(m,d,0,k+1,j,i)*nh_c_.d_view(n,d);
+      }
+    }
+    if (!(multi_d)) {n_0m[1] = n_0; n_0p[1] = n_0;}
+    if (!(three_d)) {n_0m[2] = n_0; n_0p[2] = n_0;}
+    Real n_0min = fabs(n_0);
+    for (int d=0; d<3; ++d) {
+      n_0min = fmin(n_0min, fmin(fabs(n_0m[d]), fabs(n_0p[d])));
+    }
+    if (n_0min < n_0_floor_) return;
+
+    // coordinate components of n^mu
+    Real n0 = tt(m,0,0,k,j,i);
+    Real rate = 0.0;
+    Real dx[3] = {size.d_view(m).dx1, size.d_view(m).dx2, size.d_view(m).dx3};
+    for (int d=0; d<3; ++d) {
+      Real nd = tt(m,0,d+1,k,j,i)*nh_c_.d_view(n,0) + tt(m,1,d+1,k,j,i)*nh_c_.d_view(n,1)
+              + tt(m,2,d+1,k,j,i)*nh_c_.d_view(n,2) + tt(m,3,d+1,k,j,i)*nh_c_.d_view(n,3);
+      rate -= (nd/n0)*(log(fabs(n_0p[d])) - log(fabs(n_0m[d])))/(2.0*dx[d]);
+    }
+    lnu_dot_(m,n,k,j,i) = rate;
+  });
+
+  return;
+}
+
 } // namespace radiation
@@ -73,6 +73,9 @@ SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *p
   } else {
     shearing_box = false;
   }
+
+  // (6) self-gravity (potential is computed by Gravity class in MeshBlockPack)
+  self_gravity = pin->DoesBlockExist("gravity");
 }
 
 //----------------------------------------------------------------------------------------
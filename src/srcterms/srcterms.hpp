@@ -11,6 +11,7 @@
 //!  (1) constant (gravitational) acceleration - for RTI
 //!  (2) shearing box in 2D (x-z), for both hydro and MHD
 //!  (3) random forcing to drive turbulence - implemented in TurbulenceDriver class
+//!  (4) self-gravity - potential computed by Gravity class stored in MeshBlockPack
 
 #include <map>
 #include <string>
@@ -39,6 +40,7 @@ class SourceTerms {
   bool rel_cooling;
   bool beam;
   bool shearing_box, shearing_box_r_phi;
+  bool self_gravity;
 
   // new timestep
   Real dtnew;
@@ -72,6 +74,8 @@ class SourceTerms {
                    DvceArray5D<Real> &u0);
   void ShearingBox(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
                    const EOS_Data &eos_data, const Real bdt, DvceArray5D<Real> &u0);
+  void SelfGravity(const DvceArray5D<Real> &w0, const EOS_Data &eos_data, const Real bdt,
+                   DvceArray5D<Real> &u0);
   // in 2D shearing box there is a source term for Ex and Ey
   void SBoxEField(const DvceFaceFld4D<Real> &b0, DvceEdgeFld4D<Real> &efld);
 
@@ -23,6 +23,7 @@
 #include "eos/eos.hpp"
 #include "eos/ideal_c2p_hyd.hpp"
 #include "eos/ideal_c2p_mhd.hpp"
+#include "utils/memory_usage.hpp"
 #include "turb_driver.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -64,6 +65,9 @@ TurbulenceDriver::TurbulenceDriver(MeshBlockPack *pp, ParameterInput *pin) :
   dedt = pin->GetOrAddReal("turb_driving", "dedt", 0.0);
   // correlation time
   tcorr = pin->GetOrAddReal("turb_driving", "tcorr", 0.0);
+  // key of counter-based RNG used to generate amplitudes of modes
+  rkey.seed = pin->GetOrAddInteger("turb_driving", "seed", 1);
+  rkey.count = 0;
 
   Real nlow_sqr = nlow*nlow;
   Real nhigh_sqr = nhigh*nhigh;
@@ -134,6 +138,13 @@ TurbulenceDriver::TurbulenceDriver(MeshBlockPack *pp, ParameterInput *pin) :
   Kokkos::realloc(zcos, nmb, mode_count, ncells3);
   Kokkos::realloc(zsin, nmb, mode_count, ncells3);
 
+  // register arrays for memory accounting
+  memory_usage::TrackArrays("TurbulenceDriver", force, force_tmp, xcos, xsin, ycos, ysin,
+                            zcos, zsin, kx_mode, ky_mode, kz_mode,
+                            xccc, xccs, xcsc, xcss, xscc, xscs, xssc, xsss,
+                            yccc, yccs, ycsc, ycss, yscc, yscs, yssc, ysss,
+                            zccc, zccs, zcsc, zcss, zscc, zscs, zssc, zsss);
+
   Initialize();
 }
 
@@ -168,8 +179,6 @@ void TurbulenceDriver::Initialize() {
     force_(m,n,k,j,i) = 0.0;
   });
 
-  rstate.idum = -1;
-
   auto kx_mode_ = kx_mode;
   auto ky_mode_ = ky_mode;
   auto kz_mode_ = kz_mode;
@@ -282,8 +291,10 @@ void TurbulenceDriver::Initialize() {
 
 void TurbulenceDriver::IncludeInitializeModesTask(std::shared_ptr<TaskList> tl,
                                                   TaskID start) {
-  auto id_init = tl->AddTask(&TurbulenceDriver::InitializeModes, this, start);
-  auto id_add = tl->AddTask(&TurbulenceDriver::AddForcing, this, id_init);
+  auto id_init = tl->AddTask(&TurbulenceDriver::InitializeModes, this, start,
+                             "TurbulenceDriver::InitializeModes");
+  auto id_add = tl->AddTask(&TurbulenceDriver::AddForcing, this, id_init,
+                            "TurbulenceDriver::AddForcing");
   return;
 }
 
@@ -298,15 +309,18 @@ void TurbulenceDriver::IncludeAddForcingTask(std::shared_ptr<TaskList> tl, TaskI
   if (pmy_pack->pionn == nullptr) {
     if (pmy_pack->phydro != nullptr) {
       auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                              pmy_pack->phydro->id.flux, pmy_pack->phydro->id.rkupdt);
+                              pmy_pack->phydro->id.flux, pmy_pack->phydro->id.rkupdt,
+                              "TurbulenceDriver::AddForcing");
     }
     if (pmy_pack->pmhd != nullptr) {
       auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                              pmy_pack->pmhd->id.flux, pmy_pack->pmhd->id.rkupdt);
+                              pmy_pack->pmhd->id.flux, pmy_pack->pmhd->id.rkupdt,
+                              "TurbulenceDriver::AddForcing");
     }
   } else {
     auto id = tl->InsertTask(&TurbulenceDriver::AddForcing, this,
-                            pmy_pack->pionn->id.n_flux, pmy_pack->pionn->id.n_rkupdt);
+                            pmy_pack->pionn->id.n_flux, pmy_pack->pionn->id.n_rkupdt,
+                            "TurbulenceDriver::AddForcing");
   }
 
   return;
@@ -341,8 +355,6 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
     force_tmp_(m,n,k,j,i) = 0.0;
   });
 
-  int nlow_sqr = SQR(nlow);
-  int nhigh_sqr = SQR(nhigh);
   auto mode_count_ = mode_count;
 
   auto xccc_ = xccc;
@@ -372,293 +384,195 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   auto zssc_ = zssc;
   auto zsss_ = zsss;
 
-  Real dkx, dky, dkz, kx, ky, kz;
-  Real iky, ikz;
+  auto kx_mode_ = kx_mode;
+  auto ky_mode_ = ky_mode;
+  auto kz_mode_ = kz_mode;
+
   Real lx = pm->mesh_size.x1max - pm->mesh_size.x1min;
   Real ly = pm->mesh_size.x2max - pm->mesh_size.x2min;
   Real lz = pm->mesh_size.x3max - pm->mesh_size.x3min;
-  dkx = 2.0*M_PI/lx;
-  dky = 2.0*M_PI/ly;
-  dkz = 2.0*M_PI/lz;
-
-  Real &ex = expo;
-  Real &ex_prp = exp_prp;
-  Real &ex_prl = exp_prl;
-  Real norm, kprl, kprp, kiso;
-
-  int nmode = 0;
-  int nkx, nky, nkz, nsqr;
-  for (nkx = 0; nkx <= nhigh; nkx++) {
-    for (nky = 0; nky <= nhigh; nky++) {
-      for (nkz = 0; nkz <= nhigh; nkz++) {
-        if (nkx == 0 && nky == 0 && nkz == 0) continue;
-        norm = 0.0;
-        nsqr = 0.0;
-        bool flag_prl = true;
-        if (driving_type == 0) {
-          nsqr = SQR(nkx) + SQR(nky) + SQR(nkz);
-        } else if (driving_type == 1) {
-          nsqr = SQR(nkx) + SQR(nky);
-          Real nprlsqr = SQR(nkz);
-          if (nprlsqr >= nlow_sqr && nprlsqr <= nhigh_sqr) {
-            flag_prl = true;
-          } else {
-            flag_prl = false;
-          }
-        }
-        if (nsqr >= nlow_sqr && nsqr <= nhigh_sqr && flag_prl) {
-          kx = dkx*nkx;
-          ky = dky*nky;
-          kz = dkz*nkz;
-
-          // Generate Fourier amplitudes
-          if (driving_type == 0) {
-            kiso = sqrt(SQR(kx) + SQR(ky) + SQR(kz));
-            if (kiso > 1e-16) {
-              norm = 1.0/pow(kiso,(ex+2.0)/2.0);
-            } else {
-              norm = 0.0;
-            }
-            if (nkz != 0) {
-              ikz = 1.0/(dkz*((Real) nkz));
-
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xcss_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xscs_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xsss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              ycsc_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              ycss_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yscs_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-              ysss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-
-              // imcompressibility
-              zccc_.h_view(nmode) =  ikz*( kx*xscs_.h_view(nmode)+ky*ycss_.h_view(nmode));
-              zccs_.h_view(nmode) = -ikz*( kx*xscc_.h_view(nmode)+ky*ycsc_.h_view(nmode));
-              zcsc_.h_view(nmode) =  ikz*( kx*xsss_.h_view(nmode)-ky*yccs_.h_view(nmode));
-              zcss_.h_view(nmode) =  ikz*(-kx*xssc_.h_view(nmode)+ky*yccc_.h_view(nmode));
-              zscc_.h_view(nmode) =  ikz*(-kx*xccs_.h_view(nmode)+ky*ysss_.h_view(nmode));
-              zscs_.h_view(nmode) =  ikz*( kx*xccc_.h_view(nmode)-ky*yssc_.h_view(nmode));
-              zssc_.h_view(nmode) = -ikz*( kx*xcss_.h_view(nmode)+ky*yscs_.h_view(nmode));
-              zsss_.h_view(nmode) =  ikz*( kx*xcsc_.h_view(nmode)+ky*yscc_.h_view(nmode));
-            } else if (nky != 0) {  // kz == 0
-              iky = 1.0/(dky*((Real) nky));
-
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = 0.0;
-              xscs_.h_view(nmode) = 0.0;
-              xcss_.h_view(nmode) = 0.0;
-              xsss_.h_view(nmode) = 0.0;
-
-              zccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              zssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              zccs_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-
-              // incompressibility
-              yccc_.h_view(nmode) =  iky*kx*xssc_.h_view(nmode);
-              ycsc_.h_view(nmode) = -iky*kx*xscc_.h_view(nmode);
-              yscc_.h_view(nmode) = -iky*kx*xcsc_.h_view(nmode);
-              yssc_.h_view(nmode) =  iky*kx*xccc_.h_view(nmode);
-              yccs_.h_view(nmode) = 0.0;
-              ycss_.h_view(nmode) = 0.0;
-              yscs_.h_view(nmode) = 0.0;
-              ysss_.h_view(nmode) = 0.0;
-            } else {  // kz == ky == 0, kx != 0 by initial if statement
-              zccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zscc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zcsc_.h_view(nmode) = 0.0;
-              zssc_.h_view(nmode) = 0.0;
-              zccs_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              ycsc_.h_view(nmode) = 0.0;
-              yssc_.h_view(nmode) = 0.0;
-              yccs_.h_view(nmode) = 0.0;
-              ycss_.h_view(nmode) = 0.0;
-              yscs_.h_view(nmode) = 0.0;
-              ysss_.h_view(nmode) = 0.0;
-
-              // incompressibility
-              xccc_.h_view(nmode) = 0.0;
-              xscc_.h_view(nmode) = 0.0;
-              xcsc_.h_view(nmode) = 0.0;
-              xssc_.h_view(nmode) = 0.0;
-              xccs_.h_view(nmode) = 0.0;
-              xscs_.h_view(nmode) = 0.0;
-              xcss_.h_view(nmode) = 0.0;
-              xsss_.h_view(nmode) = 0.0;
-            }
-          } else if (driving_type == 1) {
-            kprl = sqrt(SQR(kx));
-            kprp = sqrt(SQR(ky) + SQR(kz));
-            if (kprl > 1e-16 && kprp > 1e-16) {
-              norm = 1.0/pow(kprp,(ex_prp+1.0)/2.0)/pow(kprl,ex_prl/2.0);
-            } else {
-              norm = 0.0;
-            }
-
-            if (nky != 0) {
-              iky = 1.0/(dky*((Real) nky));
-
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcss_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xscs_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xsss_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-
-              // incompressibility
-              yccc_.h_view(nmode) =  iky*(kx*xssc_.h_view(nmode));
-              yccs_.h_view(nmode) =  iky*(kx*xsss_.h_view(nmode));
-              ycsc_.h_view(nmode) = -iky*(kx*xscc_.h_view(nmode));
-              ycss_.h_view(nmode) = -iky*(kx*xscs_.h_view(nmode));
-              yscc_.h_view(nmode) = -iky*(kx*xcsc_.h_view(nmode));
-              yscs_.h_view(nmode) = -iky*(kx*xcss_.h_view(nmode));
-              yssc_.h_view(nmode) =  iky*(kx*xccc_.h_view(nmode));
-              ysss_.h_view(nmode) =  iky*(kx*xccs_.h_view(nmode));
-
-              zccc_.h_view(nmode) = 0.0;
-              zccs_.h_view(nmode) = 0.0;
-              zcsc_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscc_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zssc_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-            } else {  // ky == 0
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              ycsc_.h_view(nmode) = 0.0;
-              yssc_.h_view(nmode) = 0.0;
-              yccs_.h_view(nmode) = 0.0;
-              ycss_.h_view(nmode) = 0.0;
-              yscs_.h_view(nmode) = 0.0;
-              ysss_.h_view(nmode) = 0.0;
-
-              // incompressibility
-              xccc_.h_view(nmode) = 0.0;
-              xscc_.h_view(nmode) = 0.0;
-              xcsc_.h_view(nmode) = 0.0;
-              xssc_.h_view(nmode) = 0.0;
-              xccs_.h_view(nmode) = 0.0;
-              xscs_.h_view(nmode) = 0.0;
-              xcss_.h_view(nmode) = 0.0;
-              xsss_.h_view(nmode) = 0.0;
-
-              zccc_.h_view(nmode) = 0.0;
-              zscc_.h_view(nmode) = 0.0;
-              zcsc_.h_view(nmode) = 0.0;
-              zssc_.h_view(nmode) = 0.0;
-              zccs_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-            }
-          }
-          // normalization
-          xccc_.h_view(nmode) *= norm;
-          xscc_.h_view(nmode) *= norm;
-          xcsc_.h_view(nmode) *= norm;
-          xssc_.h_view(nmode) *= norm;
-          xccs_.h_view(nmode) *= norm;
-          xscs_.h_view(nmode) *= norm;
-          xcss_.h_view(nmode) *= norm;
-          xsss_.h_view(nmode) *= norm;
-          yccc_.h_view(nmode) *= norm;
-          yscc_.h_view(nmode) *= norm;
-          ycsc_.h_view(nmode) *= norm;
-          yssc_.h_view(nmode) *= norm;
-          yccs_.h_view(nmode) *= norm;
-          yscs_.h_view(nmode) *= norm;
-          ycss_.h_view(nmode) *= norm;
-          ysss_.h_view(nmode) *= norm;
-          zccc_.h_view(nmode) *= norm;
-          zscc_.h_view(nmode) *= norm;
-          zcsc_.h_view(nmode) *= norm;
-          zssc_.h_view(nmode) *= norm;
-          zccs_.h_view(nmode) *= norm;
-          zscs_.h_view(nmode) *= norm;
-          zcss_.h_view(nmode) *= norm;
-          zsss_.h_view(nmode) *= norm;
-
-          nmode++;
-        }
+  Real dkx = 2.0*M_PI/lx;
+  Real dky = 2.0*M_PI/ly;
+  Real dkz = 2.0*M_PI/lz;
+
+  Real ex = expo;
+  Real ex_prp = exp_prp;
+  Real ex_prl = exp_prl;
+  int dtype = driving_type;
+
+  // Generate Fourier amplitudes of all modes in parallel.  Each mode n draws 24 deviates
+  // with counter (rkey.count, 24*n + amplitude index), so amplitudes are independent of
+  // the order in which modes are computed, and of the number of ranks or threads.
+  int64_t seed = rkey.seed;
+  int64_t count = rkey.count;
+  rkey.count++;
+  par_for("turb_amplitudes", DevExeSpace(), 0, mode_count_-1,
+  KOKKOS_LAMBDA(int n) {
+    Real kx = kx_mode_.d_view(n);
+    Real ky = ky_mode_.d_view(n);
+    Real kz = kz_mode_.d_view(n);
+    int nkx = static_cast<int>(round(kx/dkx));
+    int nky = static_cast<int>(round(ky/dky));
+    int nkz = static_cast<int>(round(kz/dkz));
+
+    // deviates for amplitudes in order x(ccc,ccs,csc,css,scc,scs,ssc,sss), then y, z
+    Real g[24];
+    for (int s=0; s<24; ++s) {
+      g[s] = RanGaussianCtr(seed, count, 24*static_cast<int64_t>(n) + s);
+    }
+    Real xccc = 0.0, xccs = 0.0, xcsc = 0.0, xcss = 0.0;
+    Real xscc = 0.0, xscs = 0.0, xssc = 0.0, xsss = 0.0;
+    Real yccc = 0.0, yccs = 0.0, ycsc = 0.0, ycss = 0.0;
+    Real yscc = 0.0, yscs = 0.0, yssc = 0.0, ysss = 0.0;
+    Real zccc = 0.0, zccs = 0.0, zcsc = 0.0, zcss = 0.0;
+    Real zscc = 0.0, zscs = 0.0, zssc = 0.0, zsss = 0.0;
+    Real norm = 0.0;
+
+    if (dtype == 0) {
+      Real kiso = sqrt(SQR(kx) + SQR(ky) + SQR(kz));
+      if (kiso > 1e-16) {
+        norm = 1.0/pow(kiso,(ex+2.0)/2.0);
+      }
+      if (nkz != 0) {
+        Real ikz = 1.0/(dkz*static_cast<Real>(nkz));
+
+        xccc = g[0];
+        xccs = g[1];
+        xcsc = (nky==0)           ? 0.0 : g[2];
+        xcss = (nky==0)           ? 0.0 : g[3];
+        xscc = (nkx==0)           ? 0.0 : g[4];
+        xscs = (nkx==0)           ? 0.0 : g[5];
+        xssc = (nkx==0 || nky==0) ? 0.0 : g[6];
+        xsss = (nkx==0 || nky==0) ? 0.0 : g[7];
+
+        yccc = g[8];
+        yccs = g[9];
+        ycsc = (nky==0)           ? 0.0 : g[10];
+        ycss = (nky==0)           ? 0.0 : g[11];
+        yscc = (nkx==0)           ? 0.0 : g[12];
+        yscs = (nkx==0)           ? 0.0 : g[13];
+        yssc = (nkx==0 || nky==0) ? 0.0 : g[14];
+        ysss = (nkx==0 || nky==0) ? 0.0 : g[15];
+
+        // imcompressibility
+        zccc =  ikz*( kx*xscs + ky*ycss);
+        zccs = -ikz*( kx*xscc + ky*ycsc);
+        zcsc =  ikz*( kx*xsss - ky*yccs);
+        zcss =  ikz*(-kx*xssc + ky*yccc);
+        zscc =  ikz*(-kx*xccs + ky*ysss);
+        zscs =  ikz*( kx*xccc - ky*yssc);
+        zssc = -ikz*( kx*xcss + ky*yscs);
+        zsss =  ikz*( kx*xcsc + ky*yscc);
+      } else if (nky != 0) {  // kz == 0
+        Real iky = 1.0/(dky*static_cast<Real>(nky));
+
+        xccc = g[0];
+        xcsc = g[2];
+        xscc = (nkx==0) ? 0.0 : g[4];
+        xssc = (nkx==0) ? 0.0 : g[6];
+
+        zccc = g[16];
+        zcsc = g[18];
+        zscc = (nkx==0) ? 0.0 : g[20];
+        zssc = (nkx==0) ? 0.0 : g[22];
+
+        // incompressibility
+        yccc =  iky*kx*xssc;
+        ycsc = -iky*kx*xscc;
+        yscc = -iky*kx*xcsc;
+        yssc =  iky*kx*xccc;
+      } else {  // kz == ky == 0, kx != 0 by selection of modes
+        zccc = g[16];
+        zscc = g[20];
+        yccc = g[8];
+        yscc = g[12];
+      }
+    } else if (dtype == 1) {
+      Real kprl = sqrt(SQR(kx));
+      Real kprp = sqrt(SQR(ky) + SQR(kz));
+      if (kprl > 1e-16 && kprp > 1e-16) {
+        norm = 1.0/pow(kprp,(ex_prp+1.0)/2.0)/pow(kprl,ex_prl/2.0);
+      }
+      if (nky != 0) {
+        Real iky = 1.0/(dky*static_cast<Real>(nky));
+
+        xccc = g[0];
+        xccs = g[1];
+        xcsc = g[2];
+        xcss = g[3];
+        xscc = (nkx==0) ? 0.0 : g[4];
+        xscs = (nkx==0) ? 0.0 : g[5];
+        xssc = (nkx==0) ? 0.0 : g[6];
+        xsss = (nkx==0) ? 0.0 : g[7];
+
+        // incompressibility
+        yccc =  iky*(kx*xssc);
+        yccs =  iky*(kx*xsss);
+        ycsc = -iky*(kx*xscc);
+        ycss = -iky*(kx*xscs);
+        yscc = -iky*(kx*xcsc);
+        yscs = -iky*(kx*xcss);
+        yssc =  iky*(kx*xccc);
+        ysss =  iky*(kx*xccs);
+      } else {  // ky == 0
+        yccc = g[8];
+        yscc = g[12];
       }
     }
-  }
 
-  xccc_.template modify<HostMemSpace>();
-  xccc_.template sync<DevExeSpace>();
-  xccs_.template modify<HostMemSpace>();
-  xccs_.template sync<DevExeSpace>();
-  xcsc_.template modify<HostMemSpace>();
-  xcsc_.template sync<DevExeSpace>();
-  xcss_.template modify<HostMemSpace>();
-  xcss_.template sync<DevExeSpace>();
-  xscc_.template modify<HostMemSpace>();
-  xscc_.template sync<DevExeSpace>();
-  xscs_.template modify<HostMemSpace>();
-  xscs_.template sync<DevExeSpace>();
-  xssc_.template modify<HostMemSpace>();
-  xssc_.template sync<DevExeSpace>();
-  xsss_.template modify<HostMemSpace>();
-  xsss_.template sync<DevExeSpace>();
-
-  yccc_.template modify<HostMemSpace>();
-  yccc_.template sync<DevExeSpace>();
-  yccs_.template modify<HostMemSpace>();
-  yccs_.template sync<DevExeSpace>();
-  ycsc_.template modify<HostMemSpace>();
-  ycsc_.template sync<DevExeSpace>();
-  ycss_.template modify<HostMemSpace>();
-  ycss_.template sync<DevExeSpace>();
-  yscc_.template modify<HostMemSpace>();
-  yscc_.template sync<DevExeSpace>();
-  yscs_.template modify<HostMemSpace>();
-  yscs_.template sync<DevExeSpace>();
-  yssc_.template modify<HostMemSpace>();
-  yssc_.template sync<DevExeSpace>();
-  ysss_.template modify<HostMemSpace>();
-  ysss_.template sync<DevExeSpace>();
-
-  zccc_.template modify<HostMemSpace>();
-  zccc_.template sync<DevExeSpace>();
-  zccs_.template modify<HostMemSpace>();
-  zccs_.template sync<DevExeSpace>();
-  zcsc_.template modify<HostMemSpace>();
-  zcsc_.template sync<DevExeSpace>();
-  zcss_.template modify<HostMemSpace>();
-  zcss_.template sync<DevExeSpace>();
-  zscc_.template modify<HostMemSpace>();
-  zscc_.template sync<DevExeSpace>();
-  zscs_.template modify<HostMemSpace>();
-  zscs_.template sync<DevExeSpace>();
-  zssc_.template modify<HostMemSpace>();
-  zssc_.template sync<DevExeSpace>();
-  zsss_.template modify<HostMemSpace>();
-  zsss_.template sync<DevExeSpace>();
+    // normalization
+    xccc_.d_view(n) = norm*xccc;
+    xccs_.d_view(n) = norm*xccs;
+    xcsc_.d_view(n) = norm*xcsc;
+    xcss_.d_view(n) = norm*xcss;
+    xscc_.d_view(n) = norm*xscc;
+    xscs_.d_view(n) = norm*xscs;
+    xssc_.d_view(n) = norm*xssc;
+    xsss_.d_view(n) = norm*xsss;
+    yccc_.d_view(n) = norm*yccc;
+    yccs_.d_view(n) = norm*yccs;
+    ycsc_.d_view(n) = norm*ycsc;
+    ycss_.d_view(n) = norm*ycss;
+    yscc_.d_view(n) = norm*yscc;
+    yscs_.d_view(n) = norm*yscs;
+    yssc_.d_view(n) = norm*yssc;
+    ysss_.d_view(n) = norm*ysss;
+    zccc_.d_view(n) = norm*zccc;
+    zccs_.d_view(n) = norm*zccs;
+    zcsc_.d_view(n) = norm*zcsc;
+    zcss_.d_view(n) = norm*zcss;
+    zscc_.d_view(n) = norm*zscc;
+    zscs_.d_view(n) = norm*zscs;
+    zssc_.d_view(n) = norm*zssc;
+    zsss_.d_view(n) = norm*zsss;
+  });
+
+  xccc_.template modify<DevExeSpace>();
+  xccs_.template modify<DevExeSpace>();
+  xcsc_.template modify<DevExeSpace>();
+  xcss_.template modify<DevExeSpace>();
+  xscc_.template modify<DevExeSpace>();
+  xscs_.template modify<DevExeSpace>();
+  xssc_.template modify<DevExeSpace>();
+  xsss_.template modify<DevExeSpace>();
+
+  yccc_.template modify<DevExeSpace>();
+  yccs_.template modify<DevExeSpace>();
+  ycsc_.template modify<DevExeSpace>();
+  ycss_.template modify<DevExeSpace>();
+  yscc_.template modify<DevExeSpace>();
+  yscs_.template modify<DevExeSpace>();
+  yssc_.template modify<DevExeSpace>();
+  ysss_.template modify<DevExeSpace>();
+
+  zccc_.template modify<DevExeSpace>();
+  zccs_.template modify<DevExeSpace>();
+  zcsc_.template modify<DevExeSpace>();
+  zcss_.template modify<DevExeSpace>();
+  zscc_.template modify<DevExeSpace>();
+  zscs_.template modify<DevExeSpace>();
+  zssc_.template modify<DevExeSpace>();
+  zsss_.template modify<DevExeSpace>();
 
   auto xcos_ = xcos;
   auto xsin_ = xsin;
@@ -25,7 +25,7 @@ class TurbulenceDriver {
   ~TurbulenceDriver();
 
   DvceArray5D<Real> force, force_tmp;  // arrays used for turb forcing
-  RNG_State rstate;                    // random state
+  RNG_Key rkey;                        // key state of counter-based RNG
 
   DualArray1D<Real> xccc, xccs, xcsc, xcss, xscc, xscs, xssc, xsss;
   DualArray1D<Real> yccc, yccs, ycsc, ycss, yscc, yscs, yssc, ysss;
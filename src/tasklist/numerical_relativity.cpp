@@ -12,13 +12,83 @@
 #include <vector>
 
 #include "numerical_relativity.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
 #include "z4c/z4c.hpp"
+#include "coordinates/adm.hpp"
+#include "coordinates/superposed_ks.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
 
 namespace numrel {
 
 NumericalRelativity::NumericalRelativity(MeshBlockPack *ppack, ParameterInput *pin) {
   pmy_pack = ppack;
+  cowling = false;
+  recouple_interval = 0;
+  recouple_ncycles = 0;
+  if (pin->DoesBlockExist("z4c")) {
+    cowling = pin->GetOrAddBoolean("z4c", "cowling", false);
+  }
+  if (cowling) {
+    if (ppack->pdyngr == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<z4c>/cowling requires an <mhd> block to evolve "
+                << "matter with dynamical GRMHD" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    recouple_interval = pin->GetOrAddInteger("z4c", "cowling_recouple_interval", 0);
+    recouple_ncycles = pin->GetOrAddInteger("z4c", "cowling_recouple_ncycles", 1);
+    if (recouple_interval > 0 &&
+        (recouple_ncycles < 1 || recouple_ncycles > recouple_interval)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<z4c>/cowling_recouple_ncycles must be between 1 and "
+                << "cowling_recouple_interval" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (global_variable::my_rank == 0) {
+      std::cout << "Cowling approximation: metric frozen";
+      if (recouple_interval > 0) {
+        std::cout << ", refreshed by " << recouple_ncycles << " coupled cycle(s) every "
+                  << recouple_interval << " cycles";
+      }
+      std::cout << std::endl;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool NumericalRelativity::MetricEvolving()
+//! \brief Returns false if metric is frozen in the current cycle.  The cycle number is
+//! only incremented between cycles, so this is the same for every stage of a cycle.
+
+bool NumericalRelativity::MetricEvolving() {
+  if (!(cowling)) {
+    return true;
+  }
+  if (recouple_interval <= 0) {
+    return false;
+  }
+  return ((pmy_pack->pmesh->ncycle % recouple_interval) < recouple_ncycles);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn NumericalRelativity::FreezeMetric()
+//! \brief In the Cowling approximation, wraps tasks that evolve the metric or couple the
+//! matter to it so that they do nothing while the metric is frozen.  Excision masks are
+//! still updated, since they are needed by new MeshBlocks created by AMR.
+
+std::function<TaskStatus(Driver*, int)> NumericalRelativity::FreezeMetric(TaskName name,
+    std::function<TaskStatus(Driver*, int)> func) {
+  if (!(cowling) || name == Z4c_Excise ||
+      (NeedsPhysics(name) != Phys_Z4c && name != MHD_SetTmunu)) {
+    return func;
+  }
+  return [this, func](Driver *d, int s) mutable -> TaskStatus {
+    if (!(MetricEvolving())) {
+      return TaskStatus::complete;
+    }
+    return func(d, s);
+  };
 }
 
 std::vector<QueuedTask>& NumericalRelativity::SelectQueue(TaskLocation loc) {
@@ -42,6 +112,8 @@ PhysicsDependency NumericalRelativity::NeedsPhysics(TaskName task) {
     return Phys_MHD;
   } else if (task < Z4c_NTASKS) {
     return Phys_Z4c;
+  } else if (task < ADM_NTASKS) {
+    return Phys_ADM;
   } else {
     return Phys_None;
   }
@@ -55,6 +127,8 @@ bool NumericalRelativity::DependencyAvailable(PhysicsDependency dep) {
       return pmy_pack->pdyngr != nullptr;
     case Phys_Z4c:
       return pmy_pack->pz4c != nullptr;
+    case Phys_ADM:
+      return pmy_pack->padm != nullptr && pmy_pack->padm->psks != nullptr;
     default:
       std::cout << "NumericalRelativity: Unknown dependency\n";
   }
@@ -119,7 +193,7 @@ bool NumericalRelativity::AssembleNumericalRelativityTasks(
       TaskID dep(0);
       if (DependenciesMet(task, queue, dep) && !task.added) {
         task.added = true;
-        task.id = list->AddTask(task.func_, dep);
+        task.id = list->AddTask(task.func_, dep, task.name_string);
         cycle_added++;
         added++;
         /*std::cout << "Successfully added " << task.name_string << " to task list!\n"
@@ -161,6 +235,9 @@ void NumericalRelativity::AssembleNumericalRelativityTasks(
   if (pmy_pack->pz4c != nullptr) {
     pmy_pack->pz4c->QueueZ4cTasks();
   }
+  if (pmy_pack->padm != nullptr && pmy_pack->padm->psks != nullptr) {
+    pmy_pack->padm->psks->QueueSuperposedKSTasks();
+  }
 
   bool success = AssembleNumericalRelativityTasks(tl["before_stagen"], start_queue);
   if (!success) {
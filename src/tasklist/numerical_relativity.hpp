@@ -7,6 +7,13 @@
 //========================================================================================
 //! \file numerical_relativity.hpp
 //  \brief NumericalRelativity handles the creation of a TaskList for NR modules.
+//
+//  With <z4c>/cowling = true the metric is frozen (Cowling approximation): all Z4c tasks
+//  and the update of the matter source terms (MHD_SetTmunu) are skipped, so only the
+//  matter is evolved on the ADM fields set by the initial data or read from a restart.
+//  If <z4c>/cowling_recouple_interval = N > 0, the metric is refreshed by evolving the
+//  fully coupled system for the first <z4c>/cowling_recouple_ncycles (default 1) cycles
+//  of every N cycles.
 
 #include <vector>
 #include <map>
@@ -82,13 +89,19 @@ enum TaskName {
   Z4c_ClearRW,
   Z4c_Wave,
   Z4c_PT,
-  Z4c_NTASKS
+  Z4c_AHF,
+  Z4c_NTASKS,
+
+  ADM_CheckMetric,
+  ADM_SetMetric,
+  ADM_NTASKS
 };
 
 enum PhysicsDependency {
   Phys_None,
   Phys_MHD,
-  Phys_Z4c
+  Phys_Z4c,
+  Phys_ADM
 };
 
 enum TaskLocation {
@@ -130,7 +143,8 @@ class NumericalRelativity {
     // Add a new task to the queue.
     //std::cout << "Queuing " << name_string << "...\n";
     SelectQueue(loc).push_back(QueuedTask(name, name_string, false, TaskID(),
-      dependencies, [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);}));
+      dependencies, FreezeMetric(name,
+      [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);})));
   }
 
   // Queue a task to be added to the task list. Filter for dependencies.
@@ -151,20 +165,28 @@ class NumericalRelativity {
     //std::cout << "Queuing " << name_string << "...\n";
     auto& queue = SelectQueue(loc);
     SelectQueue(loc).push_back(QueuedTask(name, name_string, false, TaskID(),
-      dependencies,
-      [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);}));
+      dependencies, FreezeMetric(name,
+      [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);})));
   }
 
   void AssembleNumericalRelativityTasks(
          std::map<std::string, std::shared_ptr<TaskList>>& tl);
 
+  // true if the metric is evolved in the current cycle
+  bool MetricEvolving();
+
  private:
   MeshBlockPack *pmy_pack;
+  bool cowling;               // evolve matter on a frozen metric
+  int recouple_interval;      // cycles between refreshes of frozen metric (0 = never)
+  int recouple_ncycles;       // number of coupled cycles in each refresh
   std::vector<QueuedTask> start_queue;
   std::vector<QueuedTask> run_queue;
   std::vector<QueuedTask> end_queue;
 
   std::vector<QueuedTask>& SelectQueue(TaskLocation loc);
+  std::function<TaskStatus(Driver*, int)> FreezeMetric(TaskName name,
+         std::function<TaskStatus(Driver*, int)> func);
   PhysicsDependency NeedsPhysics(TaskName task);
   bool DependencyAvailable(PhysicsDependency dep);
 
@@ -0,0 +1,69 @@
+#ifndef UTILS_FIRST_TOUCH_HPP_
+#define UTILS_FIRST_TOUCH_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file first_touch.hpp
+//  \brief NUMA-aware allocation of large arrays for OpenMP builds.
+//
+// On multi-socket nodes the operating system places each page of memory on the NUMA
+// domain of the thread that first writes to it.  Kokkos::realloc() zeroes new Views
+// with a memset issued from a single thread, so that all of a large array ends up on one
+// socket and threads on the other socket(s) run at a fraction of the memory bandwidth.
+// ReallocFirstTouch() instead allocates without initialization, and then zeroes the
+// array with the same decomposition used by the compute kernels: arrays indexed
+// (m,n,k,j,i) or (m,k,j,i) are touched with par_for_outer() over (m,k,j), looping over
+// the variable index n and over i inside each team, as in the Riemann solvers and the
+// reconstruction.  Each page is therefore placed on the socket of the thread that later
+// updates the same k/j rows, even when there are fewer MeshBlocks than threads.  Arrays
+// of other ranks (e.g. boundary buffers) are touched with a flat RangePolicy.
+//
+// For non-OpenMP builds this is identical to Kokkos::realloc().
+
+#include <cstdint>
+
+#include "athena.hpp"
+
+template <class View, class... Args>
+void ReallocFirstTouch(View &a, const Args... n) {
+#if OPENMP_PARALLEL_ENABLED
+  Kokkos::realloc(Kokkos::WithoutInitializing, a, n...);
+  if constexpr (View::rank == 5) {
+    const int nmb = a.extent_int(0), nvar = a.extent_int(1);
+    const int nk = a.extent_int(2), nj = a.extent_int(3), ni = a.extent_int(4);
+    par_for_outer("first_touch", DevExeSpace(), 0, 0, 0, (nmb-1), 0, (nk-1), 0, (nj-1),
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      for (int v=0; v<nvar; ++v) {
+        par_for_inner(member, 0, (ni-1), [&](const int i) {
+          a(m,v,k,j,i) = 0;
+        });
+      }
+    });
+  } else if constexpr (View::rank == 4) {
+    const int nmb = a.extent_int(0);
+    const int nk = a.extent_int(1), nj = a.extent_int(2), ni = a.extent_int(3);
+    par_for_outer("first_touch", DevExeSpace(), 0, 0, 0, (nmb-1), 0, (nk-1), 0, (nj-1),
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      par_for_inner(member, 0, (ni-1), [&](const int i) {
+        a(m,k,j,i) = 0;
+      });
+    });
+  } else {
+    auto data = a.data();
+    // number of elements can exceed INT_MAX for the largest arrays
+    const std::int64_t nelem = static_cast<std::int64_t>(a.span());
+    Kokkos::parallel_for("first_touch",
+    Kokkos::RangePolicy<DevExeSpace, Kokkos::IndexType<std::int64_t>>(0, nelem),
+    KOKKOS_LAMBDA(const std::int64_t &idx) {
+      data[idx] = 0;
+    });
+  }
+  Kokkos::fence();
+#else
+  Kokkos::realloc(a, n...);
+#endif
+}
+
+#endif // UTILS_FIRST_TOUCH_HPP_
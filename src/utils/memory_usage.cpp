@@ -0,0 +1,171 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_usage.cpp
+//  \brief implementation of accounting of memory used by arrays in each physics module
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/memory_usage.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace memory_usage {
+
+namespace {
+struct Entry {
+  int module;                            // index into names_
+  std::function<std::size_t()> nbytes;   // returns bytes currently used by arrays
+};
+
+bool enabled_ = false;
+double budget_ = 0.0;                    // in GB, no limit if <= 0
+std::vector<Entry> entries_;
+std::vector<std::string> names_;         // module names, in order first registered
+std::vector<std::size_t> current_;       // bytes used by each module at last Sample()
+std::vector<std::size_t> high_water_;    // max bytes used by each module at any Sample()
+std::size_t total_high_water_ = 0;       // max total bytes used at any Sample()
+
+const double bytes_per_mb = 1024.0*1024.0;
+const double bytes_per_gb = 1024.0*1024.0*1024.0;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_usage::Track()
+//! \brief Registers function returning number of bytes currently used by 'module'.
+//! A module can register any number of such functions.
+
+void Track(const std::string &module, std::function<std::size_t()> nbytes) {
+  auto it = std::find(names_.begin(), names_.end(), module);
+  int n = static_cast<int>(it - names_.begin());
+  if (it == names_.end()) {
+    names_.push_back(module);
+    current_.push_back(0);
+    high_water_.push_back(0);
+  }
+  entries_.push_back({n, nbytes});
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_usage::Clear()
+//! \brief Removes all registered arrays, called when objects owning them are deleted.
+
+void Clear() {
+  entries_.clear();
+  names_.clear();
+  current_.clear();
+  high_water_.clear();
+  total_high_water_ = 0;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_usage::Sample()
+//! \brief Updates memory currently used by each module, and high-water marks.  Called
+//! at startup and after each regrid with AMR.
+
+void Sample() {
+  if (!enabled_) {return;}
+  std::fill(current_.begin(), current_.end(), 0);
+  for (auto &e : entries_) {
+    current_[e.module] += e.nbytes();
+  }
+  std::size_t total = 0;
+  for (std::size_t n=0; n<names_.size(); ++n) {
+    high_water_[n] = std::max(high_water_[n], current_[n]);
+    total += current_[n];
+  }
+  total_high_water_ = std::max(total_high_water_, total);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_usage::Initialize()
+//! \brief Reads parameters in <memory> block.  Memory usage is only reported if the block
+//! exists in the input file.
+
+void Initialize(ParameterInput *pin) {
+  enabled_ = pin->DoesBlockExist("memory");
+  if (enabled_) {
+    budget_ = pin->GetOrAddReal("memory", "budget", 0.0);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void memory_usage::Report()
+//! \brief Prints memory used by each module (total and per MeshBlock) and its high-water
+//! mark, all maximized over ranks.  Per-MeshBlock values are computed using number of
+//! MeshBlocks for which arrays are allocated, max(nmb_thispack, nmb_maxperrank).  When
+//! called at startup, terminates run if total memory exceeds <memory>/budget on any
+//! rank.  Must be called by all ranks.
+
+void Report(Mesh *pm, bool startup) {
+  if (!enabled_) {return;}
+  Sample();
+
+  // collect values on this rank into one array, so they can be reduced together
+  int nmod = static_cast<int>(names_.size());
+  int nmb = std::max(pm->pmb_pack->nmb_thispack, pm->nmb_maxperrank);
+  std::vector<double> vals(3*(nmod+1), 0.0);
+  for (int n=0; n<nmod; ++n) {
+    vals[3*n    ] = static_cast<double>(current_[n]);
+    vals[3*n + 1] = static_cast<double>(current_[n])/static_cast<double>(nmb);
+    vals[3*n + 2] = static_cast<double>(high_water_[n]);
+    vals[3*nmod    ] += vals[3*n];
+    vals[3*nmod + 1] += vals[3*n + 1];
+  }
+  vals[3*nmod + 2] = static_cast<double>(total_high_water_);
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, vals.data(), 3*(nmod+1), MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+#endif
+
+  if (global_variable::my_rank == 0) {
+    int width = 8;
+    for (auto &name : names_) {width = std::max(width, static_cast<int>(name.size()));}
+    width += 2;
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize prec = std::cout.precision();
+    std::cout << std::endl << "Memory used by modules (MB, max over ranks, arrays "
+              << "allocated for " << nmb << " MeshBlocks on rank 0)" << std::endl;
+    std::cout << std::left << std::setw(width) << "module" << std::right
+              << std::setw(14) << "total" << std::setw(14) << "per_MeshBlock"
+              << std::setw(14) << "high_water" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (int n=0; n<=nmod; ++n) {
+      std::cout << std::left << std::setw(width) << ((n < nmod)? names_[n] : "total")
+                << std::right << std::setw(14) << vals[3*n]/bytes_per_mb
+                << std::setw(14) << vals[3*n + 1]/bytes_per_mb
+                << std::setw(14) << vals[3*n + 2]/bytes_per_mb << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(prec);
+  }
+
+  // pre-flight check that memory used by all modules fits within budget
+  if (startup && budget_ > 0.0 && vals[3*nmod] > budget_*bytes_per_gb) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Memory used by modules = "
+                << vals[3*nmod]/bytes_per_gb << " GB exceeds <memory>/budget = "
+                << budget_ << " GB on at least one rank." << std::endl
+                << "Use more ranks, or reduce <mesh_refinement>/max_nmb_per_rank or "
+                << "size of MeshBlocks" << std::endl;
+    }
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+} // namespace memory_usage
@@ -0,0 +1,75 @@
+#ifndef UTILS_MEMORY_USAGE_HPP_
+#define UTILS_MEMORY_USAGE_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_usage.hpp
+//  \brief accounting of memory used by arrays in each physics module
+//
+// Each module registers its arrays (once, in its constructor) with the name of the
+// module using memory_usage::TrackArrays(), or registers a function returning the number
+// of bytes it uses with memory_usage::Track().  Since references to the arrays are
+// stored, any later reallocation (e.g. with AMR) is automatically accounted for.  The
+// memory used by each module is reported if the input file contains a <memory> block:
+//   budget = X   maximum memory (in GB) per rank used by all modules.  The run is
+//                terminated after the physics modules are constructed, before any work is
+//                done, if it is exceeded.
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "athena.hpp"
+
+class Mesh;
+class ParameterInput;
+
+namespace memory_usage {
+
+//----------------------------------------------------------------------------------------
+// Bytes of memory used by various types of arrays.  Host mirrors of DualViews are only
+// counted when they are stored separately from the device data.
+
+template <class View>
+std::size_t Bytes(const View &a) {
+  return a.span()*sizeof(typename View::value_type);
+}
+template <class... P>
+std::size_t Bytes(const Kokkos::DualView<P...> &a) {
+  std::size_t nbytes = Bytes(a.d_view);
+  const void *hdata = a.h_view.data(), *ddata = a.d_view.data();
+  if (hdata != ddata) {nbytes += Bytes(a.h_view);}
+  return nbytes;
+}
+template <typename T>
+std::size_t Bytes(const DvceFaceFld4D<T> &a) {
+  return Bytes(a.x1f) + Bytes(a.x2f) + Bytes(a.x3f);
+}
+template <typename T>
+std::size_t Bytes(const DvceFaceFld5D<T> &a) {
+  return Bytes(a.x1f) + Bytes(a.x2f) + Bytes(a.x3f);
+}
+template <typename T>
+std::size_t Bytes(const DvceEdgeFld4D<T> &a) {
+  return Bytes(a.x1e) + Bytes(a.x2e) + Bytes(a.x3e);
+}
+
+void Track(const std::string &module, std::function<std::size_t()> nbytes);
+
+// Registers any number of arrays owned by 'module'.  Arrays must outlive the registry,
+// i.e. be members of objects deleted only in ~MeshBlockPack() (which calls Clear()).
+template <class... Arrays>
+void TrackArrays(const std::string &module, const Arrays&... arrays) {
+  Track(module, [&arrays...]() -> std::size_t {return (Bytes(arrays) + ... + 0);});
+}
+
+void Clear();
+void Sample();
+void Initialize(ParameterInput *pin);
+void Report(Mesh *pm, bool startup);
+
+} // namespace memory_usage
+
+#endif // UTILS_MEMORY_USAGE_HPP_
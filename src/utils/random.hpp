@@ -8,6 +8,8 @@
 //! \file random.cpp
 //  \brief Random number generators (that can be included in Kokkos parallel for regions)
 
+#include <cstdint>
+
 #include "athena.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -33,6 +35,13 @@ typedef struct RNG_State {
   double gset;
 } RNG_State;
 
+// Complete state of counter-based generator (see Philox4x32 below): the key, and the
+// number of sets of deviates drawn so far, used as part of the counter
+typedef struct RNG_Key {
+  int64_t seed;
+  int64_t count;
+} RNG_Key;
+
 #define IMR1 2147483563
 #define IMR2 2147483399
 #define AM (1.0/IMR1)
@@ -189,4 +198,50 @@ static Real RanGaussian(int64_t *idum) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Philox4x32
+//! \brief Counter-based generator Philox4x32-10 of Salmon et al. (2011, Proc. SC'11).
+//!
+//! Replaces the 128-bit counter ctr with four random 32-bit integers that are a pure
+//! function of the counter and 64-bit key.  Since there is no state carried between
+//! calls, any number of threads can draw deviates independently, and the result does
+//! not depend on the order in which they are drawn.
+
+KOKKOS_INLINE_FUNCTION
+void Philox4x32(uint32_t ctr[4], const uint64_t key) {
+  uint32_t k0 = static_cast<uint32_t>(key);
+  uint32_t k1 = static_cast<uint32_t>(key >> 32);
+  for (int r=0; r<10; ++r) {
+    uint64_t p0 = static_cast<uint64_t>(0xD2511F53u)*ctr[0];
+    uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u)*ctr[2];
+    uint32_t c1 = ctr[1], c3 = ctr[3];
+    ctr[0] = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    ctr[1] = static_cast<uint32_t>(p1);
+    ctr[2] = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    ctr[3] = static_cast<uint32_t>(p0);
+    k0 += 0x9E3779B9u;  // Weyl sequence bumps of key between rounds
+    k1 += 0xBB67AE85u;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn RanGaussianCtr
+//! \brief Gaussian deviate with zero mean and unit variance that is a pure function of
+//! (seed, c0, c1), using Philox4x32 and the Box-Muller transform.  For example c0 can
+//! be the step number and c1 the index of the element the deviate is drawn for.
+
+KOKKOS_INLINE_FUNCTION
+Real RanGaussianCtr(const int64_t seed, const int64_t c0, const int64_t c1) {
+  uint64_t u0 = static_cast<uint64_t>(c0), u1 = static_cast<uint64_t>(c1);
+  uint32_t ctr[4] = {static_cast<uint32_t>(u0), static_cast<uint32_t>(u0 >> 32),
+                     static_cast<uint32_t>(u1), static_cast<uint32_t>(u1 >> 32)};
+  Philox4x32(ctr, static_cast<uint64_t>(seed));
+  // two uniform deviates in (0,1] with 53 random bits each
+  uint64_t x0 = (static_cast<uint64_t>(ctr[0]) << 32) | ctr[1];
+  uint64_t x1 = (static_cast<uint64_t>(ctr[2]) << 32) | ctr[3];
+  double r1 = (static_cast<double>(x0 >> 11) + 1.0)*(1.0/9007199254740992.0);
+  double r2 = static_cast<double>(x1 >> 11)*(1.0/9007199254740992.0);
+  return static_cast<Real>(sqrt(-2.0*log(r1))*cos(2.0*M_PI*r2));
+}
+
 #endif // UTILS_RANDOM_HPP_
@@ -0,0 +1,61 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file signal_handler.cpp
+//  \brief implementation of functions in the signal_handler namespace
+
+#include <csignal>
+
+#include "athena.hpp"
+#include "utils/signal_handler.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace signal_handler {
+
+namespace {
+// number of the last signal caught on this rank (0 if none); the only data that may be
+// safely written from within a signal handler
+volatile std::sig_atomic_t signal_caught = 0;
+
+//----------------------------------------------------------------------------------------
+//! \fn void Handler()
+//! \brief Records signal and restores the default action, so that a second signal of
+//! the same type kills the run
+
+extern "C" void Handler(int sig) {
+  signal_caught = sig;
+  std::signal(sig, SIG_DFL);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void signal_handler::Install()
+//! \brief Installs handlers for SIGTERM and SIGUSR1
+
+void Install() {
+  std::signal(SIGTERM, Handler);
+#ifdef SIGUSR1
+  std::signal(SIGUSR1, Handler);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int signal_handler::Check()
+//! \brief Returns number of signal caught on any rank (or 0 if none).  Collective over
+//! all ranks, so must be called by every rank at the same point in the cycle.
+
+int Check() {
+  int sig = static_cast<int>(signal_caught);
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &sig, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  return sig;
+}
+
+} // namespace signal_handler
@@ -0,0 +1,26 @@
+#ifndef UTILS_SIGNAL_HANDLER_HPP_
+#define UTILS_SIGNAL_HANDLER_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file signal_handler.hpp
+//  \brief graceful termination of runs on SIGTERM or SIGUSR1
+//
+// Batch schedulers usually send SIGTERM (or a user signal requested in the job script,
+// commonly SIGUSR1) some time before killing a job.  The handlers installed by
+// signal_handler::Install() only record that a signal was caught.  The Driver calls the
+// collective function signal_handler::Check() at the end of every cycle, so that all MPI
+// ranks agree to stop at the same cycle boundary, after which the final outputs
+// (including any restart file) are written in Driver::Finalize().  A second signal of
+// the same type terminates the run immediately.
+
+namespace signal_handler {
+
+void Install();
+int Check();
+
+} // namespace signal_handler
+
+#endif // UTILS_SIGNAL_HANDLER_HPP_
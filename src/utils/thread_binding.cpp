@@ -0,0 +1,132 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file thread_binding.cpp
+//! \brief reports the binding of OpenMP threads to cores and NUMA domains at startup.
+//!
+//! Arrays are placed on the NUMA domain of the threads that first touch them (see
+//! utils/first_touch.hpp), so this is only effective if threads are pinned (e.g. with
+//! OMP_PROC_BIND=close and OMP_PLACES=cores) and do not migrate between sockets.  Each
+//! MPI rank owns a single MeshBlockPack, and MeshBlocks are NOT assigned to sockets
+//! within a rank, so runs should use (at least) one MPI rank per socket.  This function
+//! only reports the binding and warns if it is violated; it does not change it.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "utils/utils.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+#if OPENMP_PARALLEL_ENABLED
+#include <omp.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn int NUMANode(int cpu)
+//! \brief returns NUMA node of logical cpu from sysfs (Linux only), or -1 if unknown
+
+int NUMANode(int cpu) {
+#if defined(__linux__)
+  std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+  DIR *dir = opendir(path.c_str());
+  if (dir == nullptr) {return -1;}
+  int node = -1;
+  for (struct dirent *ent = readdir(dir); ent != nullptr; ent = readdir(dir)) {
+    int n;
+    if (std::sscanf(ent->d_name, "node%d", &n) == 1) {
+      node = n;
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+#else
+  return -1;
+#endif
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void ReportThreadBinding()
+//! \brief prints cores and NUMA nodes used by threads of each MPI rank (OpenMP builds
+//! only), and warns if threads are not pinned or if a rank spans several NUMA domains.
+
+void ReportThreadBinding() {
+#if OPENMP_PARALLEL_ENABLED
+  int nthreads = omp_get_max_threads();
+  std::vector<int> cpu(nthreads, -1);
+#pragma omp parallel num_threads(nthreads)
+  {
+#if defined(__linux__)
+    cpu[omp_get_thread_num()] = sched_getcpu();
+#endif
+  }
+
+  std::set<int> cores, nodes;
+  std::stringstream list;
+  for (int t=0; t<nthreads; ++t) {
+    list << " " << cpu[t];
+    cores.insert(cpu[t]);
+    nodes.insert(NUMANode(cpu[t]));
+  }
+  list << ", NUMA nodes";
+  for (auto n : nodes) {list << " " << n;}
+
+  // warnings are printed before the (possibly very long) list of cores
+  std::stringstream msg;
+  msg << "rank " << global_variable::my_rank << ":";
+  if (static_cast<int>(cores.size()) < nthreads) {
+    msg << " (WARNING: threads share cores)";
+  }
+  if (nodes.size() > 1) {
+    msg << " (WARNING: rank spans NUMA domains, use one MPI rank per socket)";
+  }
+  msg << " " << nthreads << " threads on cores" << list.str();
+
+  // gather messages of all ranks on rank 0, in buffers sized by the longest message
+  std::string line = msg.str();
+  int len = static_cast<int>(line.size()) + 1;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &len, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  line.resize(len - 1, ' ');
+  std::vector<char> all(static_cast<std::size_t>(global_variable::nranks)*len, '\0');
+#if MPI_PARALLEL_ENABLED
+  MPI_Gather(line.c_str(), len, MPI_CHAR, all.data(), len, MPI_CHAR, 0, MPI_COMM_WORLD);
+#else
+  std::copy(line.c_str(), line.c_str() + len, all.begin());
+#endif
+
+  if (global_variable::my_rank == 0) {
+    std::cout << std::endl << "Thread binding:" << std::endl;
+    const char *bind = std::getenv("OMP_PROC_BIND");
+    if (bind == nullptr || std::string(bind) == "false") {
+      std::cout << "WARNING: OMP_PROC_BIND is not set, threads may migrate between "
+                << "NUMA domains after first touch of arrays" << std::endl;
+    }
+    for (int r=0; r<global_variable::nranks; ++r) {
+      std::string s(&all[static_cast<std::size_t>(r)*len]);
+      s.erase(s.find_last_not_of(' ') + 1);
+      std::cout << s << std::endl;
+    }
+  }
+#endif
+  return;
+}
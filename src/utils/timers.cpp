@@ -0,0 +1,284 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file timers.cpp
+//  \brief implementation of hierarchical wall-clock timers.  Regions are stored as a
+//  tree, with index 0 an unnamed root.  Report() gathers the timers from all ranks and
+//  prints min/mean/max over ranks for each region on rank 0.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "utils/timers.hpp"
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+namespace timers {
+
+bool enabled = false;
+
+namespace {
+// data for one timed region in the tree on this rank
+struct Region {
+  std::string name;
+  int parent, depth;
+  std::vector<int> children;            // in order regions were first started
+  std::map<std::string, int> child_id;  // lookup of children by name
+  double incl = 0.0, excl = 0.0;
+  std::int64_t ncalls = 0;
+};
+
+// data for an open region
+struct Frame {
+  int region;
+  double start;
+  double child_time;
+};
+
+// data for one region in table, merged over all ranks
+struct MergedRegion {
+  std::string name;
+  int depth;
+  std::vector<int> children;
+  int nranks = 0;
+  std::int64_t ncalls = 0;
+  double incl_min = 0.0, incl_sum = 0.0, incl_max = 0.0;
+  double excl_min = 0.0, excl_sum = 0.0, excl_max = 0.0;
+};
+
+bool precise_ = false;
+Kokkos::Timer clock_;
+std::vector<Region> regions_(1);
+std::vector<Frame> stack_;
+
+//----------------------------------------------------------------------------------------
+// Appends "path\tincl\texcl\tncalls\n" for region n and all its children to 'out'
+
+void Serialize(int n, const std::string &parent_path, std::ostringstream &out) {
+  for (int c : regions_[n].children) {
+    const Region &r = regions_[c];
+    std::string path = parent_path.empty() ? r.name : (parent_path + "/" + r.name);
+    out << path << "\t" << r.incl << "\t" << r.excl << "\t" << r.ncalls << "\n";
+    Serialize(c, path, out);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// Prints row of table for merged region n and all its children
+
+void PrintRows(const std::vector<MergedRegion> &merged, int n, int width, double total) {
+  int nranks = global_variable::nranks;
+  for (int c : merged[n].children) {
+    const MergedRegion &r = merged[c];
+    // regions not started on every rank have min of zero on those ranks
+    double incl_min = (r.nranks == nranks)? r.incl_min : 0.0;
+    double excl_min = (r.nranks == nranks)? r.excl_min : 0.0;
+    double incl_mean = r.incl_sum/static_cast<double>(nranks);
+    std::string label = std::string(2*(r.depth - 1), ' ') + r.name;
+    std::cout << std::left << std::setw(width) << label << std::right
+              << std::setw(10) << r.ncalls << std::scientific << std::setprecision(3)
+              << std::setw(11) << incl_min << std::setw(11) << incl_mean
+              << std::setw(11) << r.incl_max << std::setw(11) << excl_min
+              << std::setw(11) << r.excl_sum/static_cast<double>(nranks)
+              << std::setw(11) << r.excl_max << std::fixed << std::setprecision(1)
+              << std::setw(8) << ((total > 0.0)? 100.0*incl_mean/total : 0.0)
+              << std::endl;
+    PrintRows(merged, c, width, total);
+  }
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void timers::Initialize()
+//! \brief Turns timers on/off, and sets whether device is fenced at each Start/Stop.
+
+void Initialize(bool enable, bool precise) {
+  enabled = enable;
+  precise_ = precise;
+  Reset();
+  clock_.reset();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void timers::Reset()
+//! \brief Zeros accumulated times of all regions.  The tree of regions is kept.
+
+void Reset() {
+  for (auto &r : regions_) {
+    r.incl = 0.0;
+    r.excl = 0.0;
+    r.ncalls = 0;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void timers::StartRegion()
+//! \brief Opens region with given name as a child of the currently open region. Should
+//! be called through timers::Start(), which returns immediately if timers are disabled.
+
+void StartRegion(const std::string &name) {
+  if (precise_) {Kokkos::fence();}
+  int parent = stack_.empty()? 0 : stack_.back().region;
+  int id;
+  auto it = regions_[parent].child_id.find(name);
+  if (it != regions_[parent].child_id.end()) {
+    id = it->second;
+  } else {
+    id = static_cast<int>(regions_.size());
+    Region r;
+    r.name = name;
+    r.parent = parent;
+    r.depth = regions_[parent].depth + 1;
+    regions_.push_back(r);
+    regions_[parent].children.push_back(id);
+    regions_[parent].child_id[name] = id;
+  }
+  Kokkos::Profiling::pushRegion(name);
+  stack_.push_back({id, clock_.seconds(), 0.0});
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void timers::StopRegion()
+//! \brief Closes the currently open region, adding elapsed time to its inclusive time,
+//! and elapsed time less that spent in nested regions to its exclusive time.
+
+void StopRegion() {
+  if (stack_.empty()) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "timers::Stop() called with no open timer region"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (precise_) {Kokkos::fence();}
+  Frame f = stack_.back();
+  stack_.pop_back();
+  double dt = clock_.seconds() - f.start;
+  Region &r = regions_[f.region];
+  r.incl += dt;
+  r.excl += dt - f.child_time;
+  r.ncalls++;
+  if (!stack_.empty()) {stack_.back().child_time += dt;}
+  Kokkos::Profiling::popRegion();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void timers::Report()
+//! \brief Collects timers from all ranks and prints table of min/mean/max over ranks of
+//! inclusive and exclusive times of each region.  Must be called by all ranks.  The
+//! last column gives the mean inclusive time as a percentage of the sum over top-level
+//! regions.
+
+void Report() {
+  if (!enabled) {return;}
+
+  std::ostringstream out;
+  out << std::setprecision(17);
+  Serialize(0, "", out);
+  std::string sendbuf = out.str();
+
+  // gather text from all ranks onto rank 0
+  std::string recvbuf;
+  std::vector<int> counts(global_variable::nranks, 0);
+#if MPI_PARALLEL_ENABLED
+  int count = static_cast<int>(sendbuf.size());
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<int> displs(global_variable::nranks, 0);
+  for (int n=1; n<global_variable::nranks; ++n) {displs[n] = displs[n-1] + counts[n-1];}
+  if (global_variable::my_rank == 0) {
+    recvbuf.resize(displs[global_variable::nranks-1] + counts[global_variable::nranks-1]);
+  }
+  MPI_Gatherv(sendbuf.data(), count, MPI_CHAR, &recvbuf[0], counts.data(),
+              displs.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+#else
+  recvbuf = sendbuf;
+  counts[0] = static_cast<int>(sendbuf.size());
+#endif
+  if (global_variable::my_rank != 0) {return;}
+
+  // merge regions from all ranks into one tree, in order first seen on any rank
+  std::vector<MergedRegion> merged(1);
+  merged[0].depth = 0;
+  std::map<std::string, int> merged_id;
+  std::size_t pos = 0;
+  for (int n=0; n<global_variable::nranks; ++n) {
+    std::istringstream in(recvbuf.substr(pos, counts[n]));
+    pos += counts[n];
+    std::string line;
+    while (std::getline(in, line)) {
+      std::istringstream fields(line);
+      std::string path;
+      double incl, excl;
+      std::int64_t ncalls;
+      std::getline(fields, path, '\t');
+      fields >> incl >> excl >> ncalls;
+      int id;
+      auto it = merged_id.find(path);
+      if (it != merged_id.end()) {
+        id = it->second;
+      } else {
+        // parents always precede children, so parent is already in merged tree
+        std::size_t slash = path.rfind('/');
+        int parent = (slash == std::string::npos)? 0 : merged_id[path.substr(0, slash)];
+        id = static_cast<int>(merged.size());
+        MergedRegion r;
+        r.name = (slash == std::string::npos)? path : path.substr(slash + 1);
+        r.depth = merged[parent].depth + 1;
+        merged.push_back(r);
+        merged[parent].children.push_back(id);
+        merged_id[path] = id;
+      }
+      MergedRegion &r = merged[id];
+      if (r.nranks == 0) {
+        r.incl_min = incl;
+        r.excl_min = excl;
+      }
+      r.nranks++;
+      r.ncalls = std::max(r.ncalls, ncalls);
+      r.incl_min = std::min(r.incl_min, incl);
+      r.incl_max = std::max(r.incl_max, incl);
+      r.incl_sum += incl;
+      r.excl_min = std::min(r.excl_min, excl);
+      r.excl_max = std::max(r.excl_max, excl);
+      r.excl_sum += excl;
+    }
+  }
+
+  int width = 6;
+  for (auto &r : merged) {
+    width = std::max(width, 2*(r.depth - 1) + static_cast<int>(r.name.size()));
+  }
+  width += 2;
+  double total = 0.0;
+  for (int c : merged[0].children) {total += merged[c].incl_sum;}
+  total /= static_cast<double>(global_variable::nranks);
+
+  std::ios_base::fmtflags flags = std::cout.flags();
+  std::streamsize prec = std::cout.precision();
+  std::cout << std::endl << "Timer regions (wall-clock seconds, min/mean/max over "
+            << global_variable::nranks << " ranks" << (precise_? ", fenced" : "") << ")"
+            << std::endl;
+  std::cout << std::left << std::setw(width) << "region" << std::right
+            << std::setw(10) << "calls" << std::setw(11) << "incl_min"
+            << std::setw(11) << "incl_mean" << std::setw(11) << "incl_max"
+            << std::setw(11) << "excl_min" << std::setw(11) << "excl_mean"
+            << std::setw(11) << "excl_max" << std::setw(8) << "%incl" << std::endl;
+  PrintRows(merged, 0, width, total);
+  std::cout << std::endl;
+  std::cout.flags(flags);
+  std::cout.precision(prec);
+}
+
+} // namespace timers
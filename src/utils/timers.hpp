@@ -0,0 +1,40 @@
+#ifndef UTILS_TIMERS_HPP_
+#define UTILS_TIMERS_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file timers.hpp
+//  \brief hierarchical wall-clock timers for the Driver, TaskLists and outputs
+//
+// Timed regions are opened and closed with timers::Start(name) and timers::Stop(), which
+// must be properly nested.  Each region is identified by its name AND its parent, so
+// the same task called from different TaskLists is accumulated separately.  Both the
+// inclusive time (including all nested regions) and exclusive time (excluding nested
+// regions) are accumulated.  Timers are disabled by default, in which case Start/Stop
+// return immediately.  They are controlled by parameters in the <timers> input block:
+//   enable = true   turns on timers
+//   precise = true  calls Kokkos::fence() at the start and end of every region, so that
+//                   asynchronous device kernels are charged to the region launching them
+//   dcycle = N      writes table of timers every N cycles (in addition to at the end)
+
+#include <string>
+
+namespace timers {
+
+// flag tested inline so that Start/Stop cost nothing when timers are disabled
+extern bool enabled;
+
+void Initialize(bool enable, bool precise);
+void Reset();
+void StartRegion(const std::string &name);
+void StopRegion();
+void Report();
+
+inline void Start(const std::string &name) {if (enabled) {StartRegion(name);}}
+inline void Stop() {if (enabled) {StopRegion();}}
+
+} // namespace timers
+
+#endif // UTILS_TIMERS_HPP_
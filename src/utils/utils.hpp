@@ -12,6 +12,7 @@
 #include <string>
 
 void ShowConfig();
+void ReportThreadBinding();
 void ChangeRunDir(const std::string dir);
 int CreateMPITag(int lid, int buff_id, int phys_id);
 
@@ -55,6 +55,10 @@ class CompactObjectTracker {
   inline Real GetRadius() const {
     return radius;
   }
+  //! Set radius (e.g. from an apparent horizon)
+  inline void SetRadius(Real r) {
+    radius = r;
+  }
 
  private:
   bool owns_compact_object;
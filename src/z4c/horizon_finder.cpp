@@ -0,0 +1,559 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file horizon_finder.cpp
+//  \brief implementation of the apparent horizon finder
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <string>
+#include <vector>
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/adm.hpp"
+#include "coordinates/coordinates.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "z4c/compact_object_tracker.hpp"
+#include "z4c/z4c.hpp"
+#include "z4c/horizon_finder.hpp"
+
+namespace {
+// number of quantities computed at each angle: expansion, norm of grad(F), area element,
+// three components of spin integrand, and flag set to 1 on the rank owning the angle
+constexpr int nvals = 7;
+// maximum number of points in 1D interpolation stencil (2*ng, with ng <= 4)
+constexpr int max_stencil = 8;
+
+//----------------------------------------------------------------------------------------
+// Lagrange interpolation weights, and their derivatives, at x for np equally spaced nodes
+// starting at x0
+
+KOKKOS_INLINE_FUNCTION
+void LagrangeWeights(const Real x, const Real x0, const Real dx, const int np,
+                     Real w[max_stencil], Real dw[max_stencil]) {
+  for (int i=0; i<np; ++i) {
+    Real xi = x0 + i*dx;
+    w[i] = 1.0;
+    dw[i] = 0.0;
+    for (int j=0; j<np; ++j) {
+      if (j != i) {
+        Real xj = x0 + j*dx;
+        dw[i] = dw[i]*(x - xj)/(xi - xj) + w[i]/(xi - xj);
+        w[i] *= (x - xj)/(xi - xj);
+      }
+    }
+  }
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \brief HorizonFinder constructor
+
+HorizonFinder::HorizonFinder(MeshBlockPack *pmbp, ParameterInput *pin, int n):
+    found{false},
+    center{0.0, 0.0, 0.0},
+    area{NAN}, mass_irr{NAN}, mass{NAN}, spin{NAN, NAN, NAN}, chi{NAN},
+    centroid{NAN, NAN, NAN}, rmean{NAN}, rmin{NAN}, rmax{NAN},
+    nhorizon{n},
+    niter{0},
+    grid(pin->GetOrAddInteger("horizon_finder", "nlev", 8), true, false),
+    ylm("ahf_ylm",1,1,1),
+    surf("ahf_surf",1,1),
+    vals("ahf_vals",1,1),
+    pmesh{pmbp->pmesh} {
+  std::string nstr = "h_" + std::to_string(n) + "_";
+  lmax = pin->GetOrAddInteger("horizon_finder", "lmax", 8);
+  nlm = (lmax + 1)*(lmax + 1);
+  max_iter = pin->GetOrAddInteger("horizon_finder", "max_iterations", 200);
+  tol = pin->GetOrAddReal("horizon_finder", "tolerance", 1.0e-8);
+  flow_alpha = pin->GetOrAddReal("horizon_finder", "flow_alpha", 1.0);
+  flow_beta = pin->GetOrAddReal("horizon_finder", "flow_beta", 0.5);
+  dt = pin->GetOrAddReal("horizon_finder", "dt", 0.0);
+  next_time = pmesh->time;
+
+  center[0] = pin->GetOrAddReal("horizon_finder", nstr + "x", 0.0);
+  center[1] = pin->GetOrAddReal("horizon_finder", nstr + "y", 0.0);
+  center[2] = pin->GetOrAddReal("horizon_finder", nstr + "z", 0.0);
+  r0 = pin->GetOrAddReal("horizon_finder", nstr + "r0", 1.0);
+  tracker = pin->GetOrAddInteger("horizon_finder", nstr + "tracker", -1);
+  set_tracker_radius = pin->GetOrAddBoolean("horizon_finder",
+                                            nstr + "set_tracker_radius", false);
+  radius_factor = pin->GetOrAddReal("horizon_finder", nstr + "radius_factor", 2.0);
+  set_excision = pin->GetOrAddBoolean("horizon_finder", nstr + "set_excision", false);
+  excision_factor = pin->GetOrAddReal("horizon_finder", nstr + "excision_factor", 0.8);
+
+  if (lmax < 1 || flow_alpha <= 0.0 || r0 <= 0.0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<horizon_finder> requires lmax >= 1, flow_alpha > 0 and "
+              << nstr << "r0 > 0" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (pmesh->mb_indcs.nx3 <= 1 || 2*pmesh->mb_indcs.ng > max_stencil) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Horizon finder only works in 3D with nghost <= "
+              << max_stencil/2 << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // initial guess is a coordinate sphere
+  a_lm.assign(nlm, 0.0);
+  a_lm[0] = r0*std::sqrt(4.0*M_PI);
+
+  Kokkos::realloc(ylm, grid.nangles, nlm, 6);
+  Kokkos::realloc(surf, grid.nangles, 6);
+  Kokkos::realloc(vals, grid.nangles, nvals);
+  SetSphericalHarmonics();
+
+  if (0 == global_variable::my_rank) {
+    std::string ofname = pin->GetString("job", "basename") + ".horizon_"
+                       + std::to_string(n) + ".txt";
+    ofile.open(ofname.c_str());
+    ofile << "# Apparent horizon " << n << std::endl;
+    ofile << "# 1:iter 2:time 3:found 4:niter 5:area 6:m_irr 7:mass 8:Sx 9:Sy 10:Sz "
+          << "11:chi 12:x 13:y 14:z 15:r_mean 16:r_min 17:r_max\n";
+    ofile << std::flush;
+    ofile << std::setprecision(19);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+HorizonFinder::~HorizonFinder() { }
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::SetSphericalHarmonics()
+//! \brief Stores real spherical harmonics Y_lm, with mode index k = l*(l+1) + m, and
+//! their first and second derivatives in theta and phi at each angle of geodesic grid:
+//! ylm(n,k,0:5) = (Y, dY/dth, dY/dph, d2Y/dth2, d2Y/dthdph, d2Y/dph2).  Associated
+//! Legendre functions are computed with the standard recurrence in l.
+
+void HorizonFinder::SetSphericalHarmonics() {
+  std::vector<Real> plm((lmax + 1)*(lmax + 1));
+  for (int n=0; n<grid.nangles; ++n) {
+    Real theta = grid.polar_pos.h_view(n,0);
+    Real phi = grid.polar_pos.h_view(n,1);
+    Real x = std::cos(theta), sth = std::sin(theta);
+
+    // P_l^m(cos(theta)) stored at l*(lmax+1) + m
+    for (int m=0; m<=lmax; ++m) {
+      Real pmm = 1.0;
+      for (int i=1; i<=m; ++i) {pmm *= -(2*i - 1)*sth;}
+      plm[m*(lmax+1) + m] = pmm;
+      if (m < lmax) {plm[(m+1)*(lmax+1) + m] = x*(2*m + 1)*pmm;}
+      for (int l=m+2; l<=lmax; ++l) {
+        plm[l*(lmax+1) + m] = (x*(2*l - 1)*plm[(l-1)*(lmax+1) + m]
+                               - (l + m - 1)*plm[(l-2)*(lmax+1) + m])/(l - m);
+      }
+    }
+
+    for (int l=0; l<=lmax; ++l) {
+      for (int m=-l; m<=l; ++m) {
+        int am = std::abs(m);
+        int k = l*(l + 1) + m;
+        // normalization sqrt((2l+1)/(4pi) (l-m)!/(l+m)!), times sqrt(2) for m != 0
+        Real norm = (2*l + 1)/(4.0*M_PI);
+        for (int i=l-am+1; i<=l+am; ++i) {norm /= static_cast<Real>(i);}
+        norm = std::sqrt((m == 0)? norm : 2.0*norm);
+        Real p = plm[l*(lmax+1) + am];
+        Real pl1 = (l - 1 >= am)? plm[(l-1)*(lmax+1) + am] : 0.0;
+        Real dp = (l*x*p - (l + am)*pl1)/sth;
+        Real ddp = -x*dp/sth - (l*(l + 1) - am*am/(sth*sth))*p;
+        Real f, df, ddf;
+        if (m >= 0) {
+          f = std::cos(am*phi);
+          df = -am*std::sin(am*phi);
+        } else {
+          f = std::sin(am*phi);
+          df = am*std::cos(am*phi);
+        }
+        ddf = -am*am*f;
+        ylm(n,k,0) = norm*p*f;
+        ylm(n,k,1) = norm*dp*f;
+        ylm(n,k,2) = norm*p*df;
+        ylm(n,k,3) = norm*ddp*f;
+        ylm(n,k,4) = norm*dp*df;
+        ylm(n,k,5) = norm*p*ddf;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::EvaluateSurface()
+//! \brief Computes h and its angular derivatives at each angle from the coefficients,
+//! and the min/mean/max radius of the surface.
+
+void HorizonFinder::EvaluateSurface() {
+  rmin = std::numeric_limits<Real>::max();
+  rmax = 0.0;
+  for (int n=0; n<grid.nangles; ++n) {
+    for (int d=0; d<6; ++d) {
+      Real sum = 0.0;
+      for (int k=0; k<nlm; ++k) {sum += a_lm[k]*ylm(n,k,d);}
+      surf.h_view(n,d) = sum;
+    }
+    rmin = std::min(rmin, surf.h_view(n,0));
+    rmax = std::max(rmax, surf.h_view(n,0));
+  }
+  rmean = a_lm[0]/std::sqrt(4.0*M_PI);
+
+  // sync dual arrays
+  surf.template modify<HostMemSpace>();
+  surf.template sync<DevExeSpace>();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool HorizonFinder::ComputeExpansion()
+//! \brief Interpolates ADM metric, its first derivatives, and extrinsic curvature to
+//! each point of the surface, and computes there the expansion of outgoing null normals
+//!   Theta = (g^ij - s^i s^j)(d_i d_j F - Gamma^k_ij d_k F)/|dF| + K_ij s^i s^j - K
+//! for F = r - h(theta,phi), along with the area element and the integrand of the spin.
+//! Derivatives of the metric are those of the Lagrange interpolating polynomial.  The
+//! results are summed over ranks; returns false if any point is not on the Mesh.
+
+bool HorizonFinder::ComputeExpansion(MeshBlockPack *pmbp) {
+  auto &indcs = pmbp->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int np = 2*indcs.ng;
+  int nmb = pmbp->nmb_thispack;
+  int nang1 = grid.nangles - 1;
+  auto &size = pmbp->pmb->mb_size;
+  auto &u_adm = pmbp->padm->u_adm;
+  auto &polar = grid.polar_pos;
+  auto &hsurf = surf;
+  auto &hvals = vals;
+  Real c0 = center[0], c1 = center[1], c2 = center[2];
+
+  par_for("ahf_expansion", DevExeSpace(), 0, nang1,
+  KOKKOS_LAMBDA(const int n) {
+    for (int q=0; q<nvals; ++q) {hvals.d_view(n,q) = 0.0;}
+    Real th = polar.d_view(n,0), ph = polar.d_view(n,1);
+    Real sth = sin(th), cth = cos(th), sph = sin(ph), cph = cos(ph);
+    Real h = hsurf.d_view(n,0);
+    Real ht = hsurf.d_view(n,1), hp = hsurf.d_view(n,2);
+    Real htt = hsurf.d_view(n,3), htp = hsurf.d_view(n,4), hpp = hsurf.d_view(n,5);
+    Real nr[3] = {sth*cph, sth*sph, cth};
+    Real xr[3] = {h*nr[0], h*nr[1], h*nr[2]};
+    Real x[3] = {c0 + xr[0], c1 + xr[1], c2 + xr[2]};
+
+    // find MeshBlock containing point, if any on this rank
+    int m = -1;
+    for (int mm=0; mm<nmb; ++mm) {
+      if (x[0] >= size.d_view(mm).x1min && x[0] < size.d_view(mm).x1max &&
+          x[1] >= size.d_view(mm).x2min && x[1] < size.d_view(mm).x2max &&
+          x[2] >= size.d_view(mm).x3min && x[2] < size.d_view(mm).x3max) {
+        m = mm;
+        break;
+      }
+    }
+    if (m < 0) return;
+
+    // 1D Lagrange weights centered on point in each direction
+    Real xmin[3] = {size.d_view(m).x1min, size.d_view(m).x2min, size.d_view(m).x3min};
+    Real dx[3] = {size.d_view(m).dx1, size.d_view(m).dx2, size.d_view(m).dx3};
+    int i0[3];
+    Real w[3][max_stencil], dw[3][max_stencil];
+    for (int d=0; d<3; ++d) {
+      i0[d] = static_cast<int>(floor((x[d] - (xmin[d] + 0.5*dx[d]))/dx[d])) - np/2 + 1;
+      LagrangeWeights(x[d], xmin[d] + (i0[d] + 0.5)*dx[d], dx[d], np, w[d], dw[d]);
+    }
+
+    // interpolate g_ij, d_k g_ij and K_ij (symmetric tensors stored as xx,xy,xz,yy,yz,zz)
+    Real g[6] = {0.0}, dg[3][6] = {{0.0}}, kdd[6] = {0.0};
+    for (int k=0; k<np; ++k) {
+      for (int j=0; j<np; ++j) {
+        for (int i=0; i<np; ++i) {
+          Real w0 = w[0][i]*w[1][j]*w[2][k];
+          Real w1 = dw[0][i]*w[1][j]*w[2][k];
+          Real w2 = w[0][i]*dw[1][j]*w[2][k];
+          Real w3 = w[0][i]*w[1][j]*dw[2][k];
+          int kk = ks + i0[2] + k, jj = js + i0[1] + j, ii = is + i0[0] + i;
+          for (int q=0; q<6; ++q) {
+            Real gq = u_adm(m,adm::ADM::I_ADM_GXX+q,kk,jj,ii);
+            g[q] += w0*gq;
+            dg[0][q] += w1*gq;
+            dg[1][q] += w2*gq;
+            dg[2][q] += w3*gq;
+            kdd[q] += w0*u_adm(m,adm::ADM::I_ADM_KXX+q,kk,jj,ii);
+          }
+        }
+      }
+    }
+    const int sym[3][3] = {{0,1,2},{1,3,4},{2,4,5}};
+    Real detg = adm::SpatialDet(g[0], g[1], g[2], g[3], g[4], g[5]);
+    Real gu[6];
+    adm::SpatialInv(1.0/detg, g[0], g[1], g[2], g[3], g[4], g[5],
+                    &gu[0], &gu[1], &gu[2], &gu[3], &gu[4], &gu[5]);
+
+    // first and second Cartesian derivatives of theta and phi
+    Real r2 = h*h, rho = h*sth, rho2 = rho*rho;
+    Real dth[3] = {cth*cph/h, cth*sph/h, -sth/h};
+    Real dph[3] = {-sph/rho, cph/rho, 0.0};
+    Real ddth[3][3], ddph[3][3];
+    for (int a=0; a<2; ++a) {
+      for (int b=0; b<2; ++b) {
+        ddth[a][b] = ((a == b)? xr[2]/(r2*rho) : 0.0)
+                   - xr[a]*xr[b]*xr[2]*(2.0/(r2*r2*rho) + 1.0/(r2*rho*rho2));
+      }
+      ddth[a][2] = xr[a]*(rho2 - xr[2]*xr[2])/(r2*r2*rho);
+      ddth[2][a] = ddth[a][2];
+    }
+    ddth[2][2] = 2.0*rho*xr[2]/(r2*r2);
+    ddph[0][0] = 2.0*xr[0]*xr[1]/(rho2*rho2);
+    ddph[1][1] = -ddph[0][0];
+    ddph[0][1] = (xr[1]*xr[1] - xr[0]*xr[0])/(rho2*rho2);
+    ddph[1][0] = ddph[0][1];
+    ddph[0][2] = 0.0; ddph[1][2] = 0.0; ddph[2][0] = 0.0; ddph[2][1] = 0.0;
+    ddph[2][2] = 0.0;
+
+    // first and second derivatives of level set function F = r - h(theta,phi)
+    Real df[3], ddf[3][3];
+    for (int a=0; a<3; ++a) {
+      df[a] = nr[a] - ht*dth[a] - hp*dph[a];
+      for (int b=0; b<3; ++b) {
+        ddf[a][b] = (((a == b)? 1.0 : 0.0) - nr[a]*nr[b])/h
+                  - htt*dth[a]*dth[b] - htp*(dth[a]*dph[b] + dph[a]*dth[b])
+                  - hpp*dph[a]*dph[b] - ht*ddth[a][b] - hp*ddph[a][b];
+      }
+    }
+
+    // unit normal s^i and expansion
+    Real du[3], lam2 = 0.0;
+    for (int a=0; a<3; ++a) {
+      du[a] = 0.0;
+      for (int b=0; b<3; ++b) {du[a] += gu[sym[a][b]]*df[b];}
+      lam2 += du[a]*df[a];
+    }
+    if (!(lam2 > 0.0)) return;
+    Real lam = sqrt(lam2);
+    Real su[3] = {du[0]/lam, du[1]/lam, du[2]/lam};
+    Real expansion = 0.0;
+    for (int a=0; a<3; ++a) {
+      for (int b=0; b<3; ++b) {
+        Real gamma = 0.0;
+        for (int c=0; c<3; ++c) {
+          gamma += 0.5*du[c]*(dg[a][sym[c][b]] + dg[b][sym[c][a]] - dg[c][sym[a][b]]);
+        }
+        expansion += (gu[sym[a][b]] - su[a]*su[b])*(ddf[a][b] - gamma)/lam
+                   + (su[a]*su[b] - gu[sym[a][b]])*kdd[sym[a][b]];
+      }
+    }
+
+    // area element per unit solid angle, sqrt(det q)/sin(theta)
+    Real et[3] = {ht*nr[0] + h*cth*cph, ht*nr[1] + h*cth*sph, ht*nr[2] - h*sth};
+    Real ep[3] = {hp*nr[0] - h*sth*sph, hp*nr[1] + h*sth*cph, hp*nr[2]};
+    Real qtt = 0.0, qtp = 0.0, qpp = 0.0;
+    for (int a=0; a<3; ++a) {
+      for (int b=0; b<3; ++b) {
+        qtt += g[sym[a][b]]*et[a]*et[b];
+        qtp += g[sym[a][b]]*et[a]*ep[b];
+        qpp += g[sym[a][b]]*ep[a]*ep[b];
+      }
+    }
+    Real da = sqrt(fmax(qtt*qpp - qtp*qtp, 0.0))/sth;
+
+    // integrand of spin, phi_(i)^a s^b K_ab, with flat rotational generators about center
+    Real ks_d[3];
+    for (int a=0; a<3; ++a) {
+      ks_d[a] = 0.0;
+      for (int b=0; b<3; ++b) {ks_d[a] += kdd[sym[a][b]]*su[b];}
+    }
+    hvals.d_view(n,0) = expansion;
+    hvals.d_view(n,1) = lam;
+    hvals.d_view(n,2) = da;
+    hvals.d_view(n,3) = (xr[1]*ks_d[2] - xr[2]*ks_d[1])*da;
+    hvals.d_view(n,4) = (xr[2]*ks_d[0] - xr[0]*ks_d[2])*da;
+    hvals.d_view(n,5) = (xr[0]*ks_d[1] - xr[1]*ks_d[0])*da;
+    hvals.d_view(n,6) = 1.0;
+  });
+
+  // sync dual arrays, and sum over ranks (each angle is owned by exactly one rank)
+  vals.template modify<DevExeSpace>();
+  vals.template sync<HostMemSpace>();
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, vals.h_view.data(), grid.nangles*nvals, MPI_ATHENA_REAL,
+                MPI_SUM, MPI_COMM_WORLD);
+#endif
+  for (int n=0; n<grid.nangles; ++n) {
+    if (vals.h_view(n,6) < 0.5) {return false;}
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::Search()
+//! \brief Fast-flow iteration (Gundlach 1998, Alcubierre et al. 2000)
+//!   a_lm <- a_lm - A/(1 + B l(l+1)) (rho Theta)_lm,
+//! with A = alpha/(lmax(lmax+1)) + beta, B = beta/alpha and rho = h^2/(2|dF|), which
+//! reduces to a Newton step for spheres in conformally flat data.  Iteration stops when
+//! the rms change in h is less than tol times the mean radius.  Physical quantities are
+//! then computed on the final surface.
+
+void HorizonFinder::Search(MeshBlockPack *pmbp) {
+  if (tracker >= static_cast<int>(pmbp->pz4c->ptracker.size())) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<horizon_finder>/h_" << nhorizon << "_tracker = "
+              << tracker << " but only " << pmbp->pz4c->ptracker.size()
+              << " compact objects are tracked" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (tracker >= 0) {
+    auto it = pmbp->pz4c->ptracker.begin();
+    std::advance(it, tracker);
+    for (int a=0; a<3; ++a) {center[a] = it->GetPos(a);}
+  }
+  // restart from initial guess if last search failed
+  if (!found) {
+    a_lm.assign(nlm, 0.0);
+    a_lm[0] = r0*std::sqrt(4.0*M_PI);
+  }
+
+  Real flow_a = flow_alpha/(lmax*(lmax + 1)) + flow_beta;
+  Real flow_b = flow_beta/flow_alpha;
+  bool converged = false;
+  found = false;
+  for (niter=0; niter<=max_iter; ++niter) {
+    EvaluateSurface();
+    if (rmin <= 0.0 || !ComputeExpansion(pmbp)) {break;}
+    if (converged) {
+      found = true;
+      break;
+    }
+    if (niter == max_iter) {break;}
+
+    Real dh2 = 0.0;
+    for (int k=0; k<nlm; ++k) {
+      int l = static_cast<int>(std::sqrt(static_cast<Real>(k)) + 1.0e-6);
+      Real proj = 0.0;
+      for (int n=0; n<grid.nangles; ++n) {
+        Real rho = 0.5*SQR(surf.h_view(n,0))/vals.h_view(n,1);
+        proj += grid.solid_angles.h_view(n)*rho*vals.h_view(n,0)*ylm(n,k,0);
+      }
+      Real da = -flow_a/(1.0 + flow_b*l*(l + 1))*proj;
+      a_lm[k] += da;
+      dh2 += da*da;
+    }
+    converged = (std::sqrt(dh2/(4.0*M_PI)) < tol*rmean);
+  }
+
+  if (!found) {
+    area = NAN; mass_irr = NAN; mass = NAN; chi = NAN;
+    for (int a=0; a<3; ++a) {
+      spin[a] = NAN;
+      centroid[a] = NAN;
+    }
+    if (0 == global_variable::my_rank) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Apparent horizon " << nhorizon << " not found at time "
+                << pmesh->time << std::endl;
+    }
+    return;
+  }
+
+  // integrate area, spin, and centroid over surface
+  area = 0.0;
+  Real xc[3] = {0.0, 0.0, 0.0}, s[3] = {0.0, 0.0, 0.0};
+  for (int n=0; n<grid.nangles; ++n) {
+    Real dw = grid.solid_angles.h_view(n);
+    Real th = grid.polar_pos.h_view(n,0), ph = grid.polar_pos.h_view(n,1);
+    Real h = surf.h_view(n,0);
+    Real nr[3] = {std::sin(th)*std::cos(ph), std::sin(th)*std::sin(ph), std::cos(th)};
+    area += dw*vals.h_view(n,2);
+    for (int a=0; a<3; ++a) {
+      xc[a] += dw*vals.h_view(n,2)*(center[a] + h*nr[a]);
+      s[a] += dw*vals.h_view(n,3+a);
+    }
+  }
+  for (int a=0; a<3; ++a) {
+    centroid[a] = xc[a]/area;
+    spin[a] = s[a]/(8.0*M_PI);
+  }
+  Real s2 = SQR(spin[0]) + SQR(spin[1]) + SQR(spin[2]);
+  mass_irr = std::sqrt(area/(16.0*M_PI));
+  mass = std::sqrt(SQR(mass_irr) + s2/(4.0*SQR(mass_irr)));
+  chi = std::sqrt(s2)/SQR(mass);
+
+  // center next search on centroid, unless following a tracker
+  if (tracker < 0) {
+    for (int a=0; a<3; ++a) {center[a] = centroid[a];}
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::UpdateExcision()
+//! \brief Sets excision radii from the horizon and recomputes the excision masks
+
+void HorizonFinder::UpdateExcision(MeshBlockPack *pmbp) {
+  auto &pcoord = pmbp->pcoord;
+  if (!(pcoord->is_general_relativistic || pcoord->is_dynamical_relativistic) ||
+      !pcoord->coord_data.bh_excise ||
+      pcoord->coord_data.excision_scheme != ExcisionScheme::fixed) {
+    return;
+  }
+  pcoord->coord_data.rexcise = excision_factor*rmin;
+  pcoord->coord_data.flux_excise_r = rmin;
+  Kokkos::deep_copy(pcoord->excision_floor, false);
+  Kokkos::deep_copy(pcoord->excision_flux, false);
+  pcoord->SetExcisionMasks(pcoord->excision_floor, pcoord->excision_flux);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::FindHorizon()
+//! \brief Searches for the horizon every dt in time, writes the result, and updates the
+//! tracker radius and excision if requested.  Must be called by all ranks.
+
+void HorizonFinder::FindHorizon(MeshBlockPack *pmbp) {
+  if (pmesh->time < next_time) {return;}
+  if (dt > 0.0) {
+    while (next_time <= pmesh->time) {next_time += dt;}
+  }
+
+  Search(pmbp);
+  WriteHorizon();
+
+  if (found) {
+    if (set_tracker_radius && tracker >= 0) {
+      auto it = pmbp->pz4c->ptracker.begin();
+      std::advance(it, tracker);
+      it->SetRadius(radius_factor*rmax);
+    }
+    if (set_excision) {
+      UpdateExcision(pmbp);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+void HorizonFinder::WriteHorizon() {
+  if (0 == global_variable::my_rank) {
+    ofile << pmesh->ncycle << " "
+          << pmesh->time << " "
+          << (found? 1 : 0) << " "
+          << niter << " "
+          << area << " "
+          << mass_irr << " "
+          << mass << " "
+          << spin[0] << " "
+          << spin[1] << " "
+          << spin[2] << " "
+          << chi << " "
+          << centroid[0] << " "
+          << centroid[1] << " "
+          << centroid[2] << " "
+          << rmean << " "
+          << rmin << " "
+          << rmax << std::endl << std::flush;
+  }
+}
@@ -0,0 +1,98 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+
+#ifndef Z4C_HORIZON_FINDER_HPP_
+#define Z4C_HORIZON_FINDER_HPP_
+//! \file horizon_finder.hpp
+//  \brief apparent horizon finder using the fast-flow algorithm of Gundlach (1998),
+//  PRD 57, 863, on a geodesic grid.  Each surface is r = h(theta,phi) about a center,
+//  with h expanded in real spherical harmonics up to l = lmax.  ADM variables and their
+//  first derivatives are interpolated to the surface with Lagrange polynomials in a
+//  single device kernel over all angles, the expansion is computed there and summed
+//  over ranks, and the spectral coefficients of h are updated on the host.
+//
+//  Input parameters in the <horizon_finder> block:
+//    nhorizons        number of horizons to search for (default 0)
+//    nlev             level of geodesic grid, nangles = 10*nlev^2 + 2 (default 8)
+//    lmax             maximum l of expansion of h (default 8)
+//    dt               time between searches (default 0: every cycle)
+//    max_iterations   maximum number of flow iterations per search (default 200)
+//    tolerance        convergence criterion on rms change in h / mean radius (1e-8)
+//    flow_alpha       alpha and beta parameters of fast flow (default 1.0, 0.5)
+//    flow_beta
+//    h_N_x, h_N_y, h_N_z  initial center of horizon N (default 0)
+//    h_N_r0           initial (coordinate) radius of horizon N (default 1)
+//    h_N_tracker      index of CompactObjectTracker whose position is used as the
+//                     center of horizon N (default -1: center follows the centroid)
+//    h_N_set_tracker_radius  set radius of that tracker (used for AMR) to
+//                     h_N_radius_factor times max radius of horizon (default false)
+//    h_N_set_excision set <coord>/rexcise to h_N_excision_factor times min radius of
+//                     horizon, and flux_excise_r to its min radius, then recompute the
+//                     (fixed) excision masks (default false).  The masks are centered on
+//                     the origin, so this is only sensible for a single horizon.
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+
+// Forward declarations
+class Mesh;
+class MeshBlockPack;
+class ParameterInput;
+
+//! \class HorizonFinder
+//! \brief Finds a single apparent horizon and writes its properties to file
+class HorizonFinder {
+ public:
+  HorizonFinder(MeshBlockPack *pmbp, ParameterInput *pin, int n);
+  ~HorizonFinder();
+
+  //! Search for the horizon if the time since the last search exceeds dt
+  void FindHorizon(MeshBlockPack *pmbp);
+  //! Write data to file
+  void WriteHorizon();
+
+  bool found;          // true if last search converged
+  Real center[3];      // center of expansion of h
+  Real area;           // area of horizon
+  Real mass_irr;       // irreducible mass sqrt(A/16 pi)
+  Real mass;           // Christodoulou mass
+  Real spin[3];        // coordinate spin vector
+  Real chi;            // dimensionless spin |S|/M^2
+  Real centroid[3];    // area-weighted centroid of horizon
+  Real rmean, rmin, rmax;  // mean, min and max coordinate radius of horizon
+
+ private:
+  int nhorizon;        // index of this horizon
+  int lmax, nlm;       // max l and number of (l,m) modes of h
+  int max_iter;        // max number of flow iterations per search
+  int niter;           // number of iterations used in last search
+  Real tol;            // convergence tolerance
+  Real flow_alpha, flow_beta;
+  Real r0;             // initial guess of radius
+  Real dt, next_time;  // cadence and time of next search
+  int tracker;         // index of CompactObjectTracker to follow, or -1
+  bool set_tracker_radius, set_excision;
+  Real radius_factor, excision_factor;
+  std::vector<Real> a_lm;      // spectral coefficients of h
+  GeodesicGrid grid;           // angles and solid angles of surface
+  HostArray3D<Real> ylm;       // Y_lm and angular derivatives at each angle
+  DualArray2D<Real> surf;      // h and angular derivatives at each angle
+  DualArray2D<Real> vals;      // expansion etc. computed at each angle
+  Mesh const *pmesh;
+  std::ofstream ofile;
+
+  void SetSphericalHarmonics();
+  void EvaluateSurface();
+  bool ComputeExpansion(MeshBlockPack *pmbp);
+  void Search(MeshBlockPack *pmbp);
+  void UpdateExcision(MeshBlockPack *pmbp);
+};
+
+#endif // Z4C_HORIZON_FINDER_HPP_
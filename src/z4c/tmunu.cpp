@@ -12,6 +12,7 @@
 #include "parameter_input.hpp"
 #include "z4c/tmunu.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/memory_usage.hpp"
 
 char const * const Tmunu::Tmunu_names[Tmunu::N_Tmunu] = {
   "tmunu_Sxx", "tmunu_Sxy", "tmunu_Sxz", "tmunu_Syy", "tmunu_Syz", "tmunu_Szz",
@@ -33,6 +34,9 @@ Tmunu::Tmunu(MeshBlockPack *ppack, ParameterInput *pin):
   tmunu.S_dd.InitWithShallowSlice(u_tmunu, I_Tmunu_Sxx, I_Tmunu_Szz);
   tmunu.E.InitWithShallowSlice(u_tmunu, I_Tmunu_E);
   tmunu.S_d.InitWithShallowSlice(u_tmunu, I_Tmunu_Sx, I_Tmunu_Sz);
+
+  // register arrays for memory accounting
+  memory_usage::TrackArrays("Tmunu", u_tmunu);
 }
 
 Tmunu::~Tmunu() {}
@@ -21,6 +21,8 @@
 #include "mesh/mesh.hpp"
 #include "bvals/bvals.hpp"
 #include "z4c/compact_object_tracker.hpp"
+#include "z4c/horizon_finder.hpp"
+#include "utils/memory_usage.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
 #include "coordinates/adm.hpp"
@@ -166,6 +168,13 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   pbval_weyl->InitializeBuffers((2));
   Kokkos::Profiling::popRegion();
 
+  // register arrays and boundary buffers for memory accounting
+  memory_usage::TrackArrays("Z4c", u_con, u_mat, u0, u1, u_rhs, coarse_u0, u_weyl,
+                            coarse_u_weyl);
+  memory_usage::Track("Z4c", [this]() {
+    return pbval_u->MemoryUsage() + pbval_weyl->MemoryUsage();
+  });
+
   // wave extraction spheres
   // TODO(@hzhu): Read radii from input file
   auto &grids = spherical_grids;
@@ -192,6 +201,14 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
       break;
     }
   }
+
+  // Construct the apparent horizon finders
+  if (pin->DoesBlockExist("horizon_finder")) {
+    int nhorizons = pin->GetOrAddInteger("horizon_finder", "nhorizons", 0);
+    for (int nh = 0; nh < nhorizons; ++nh) {
+      phorizon.emplace_back(pmy_pack, pin, nh);
+    }
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -26,6 +26,7 @@
 class Coordinates;
 class Driver;
 class CompactObjectTracker;
+class HorizonFinder;
 
 //----------------------------------------------------------------------------------------
 //! \struct Z4cTaskIDs
@@ -245,6 +246,7 @@ class Z4c {
   TaskStatus RestrictU(Driver *d, int stage);
   TaskStatus RestrictWeyl(Driver *d, int stage);
   TaskStatus TrackCompactObjects(Driver *d, int stage);
+  TaskStatus FindHorizons(Driver *d, int stage);
   TaskStatus CalcWeylScalar(Driver *d, int stage);
   TaskStatus CalcWaveForm(Driver *d, int stage);
 
@@ -263,6 +265,7 @@ class Z4c {
 
   Z4c_AMR *pamr;
   std::list<CompactObjectTracker> ptracker;
+  std::list<HorizonFinder> phorizon;
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Z4c
@@ -130,7 +130,6 @@ TaskStatus Z4c::Z4cBoundaryRHS(Driver *pdriver, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   auto &size = pmy_pack->pmb->mb_size;
 
-  int nmb = pmy_pack->nmb_thispack;
   int is = indcs.is;
   int ie = indcs.ie;
   int js = indcs.js;
@@ -142,118 +141,143 @@ TaskStatus Z4c::Z4cBoundaryRHS(Driver *pdriver, int stage) {
   auto &rhs_ = rhs;
   bool &user_Sbc = opt.user_Sbc;
 
-  // We only need to apply this condition for outflow boundaries
-  if (pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::outflow
+  // We only need to apply this condition for outflow boundaries, and only loop over
+  // compact lists of MeshBlocks with physical boundaries at inner, then outer faces
+  auto &bcs_list = pmy_pack->pmb->bcs_list;
+  auto &nbcs = pmy_pack->pmb->nbcs_list;
+  int nin, nl;
+  nin = nbcs[BoundaryFace::inner_x1];
+  nl = nin + nbcs[BoundaryFace::outer_x1];
+  if ((pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::outflow
       || pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::diode
       || pm->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::user
       || pm->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::outflow
       || pm->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::user) {
-    par_for("z4crhs_bc_x1", DevExeSpace(), 0, (nmb-1), ks, ke, js, je,
-    KOKKOS_LAMBDA(int m, int k, int j) {
-      // Inner boundary
-      switch(mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, is);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
+      || pm->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::user) && nl > 0) {
+    par_for("z4crhs_bc_x1", DevExeSpace(), 0, (nl-1), ks, ke, js, je,
+    KOKKOS_LAMBDA(int l, int k, int j) {
+      if (l < nin) {
+        int m = bcs_list.d_view(BoundaryFace::inner_x1,l);
+        // Inner boundary
+        switch(mb_bcs.d_view(m,BoundaryFace::inner_x1)) {
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
               Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, is);
-            }
-          break;
-        default:
-          break;
-      }
-      // Outer boundary
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, ie);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
+            break;
+          case BoundaryFlag::user:
+              if (user_Sbc) {
+                Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, is);
+              }
+            break;
+          default:
+            break;
+        }
+      } else {
+        int m = bcs_list.d_view(BoundaryFace::outer_x1,l-nin);
+        // Outer boundary
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x1)) {
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
               Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, ie);
-            }
-          break;
-        default:
-          break;
+            break;
+          case BoundaryFlag::user:
+              if (user_Sbc) {
+                Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, j, ie);
+              }
+            break;
+          default:
+            break;
+        }
       }
     });
   }
-  if (pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::outflow
+  nin = nbcs[BoundaryFace::inner_x2];
+  nl = nin + nbcs[BoundaryFace::outer_x2];
+  if ((pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::outflow
       || pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::diode
       || pm->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::user
       || pm->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::outflow
       || pm->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::user) {
-    par_for("z4crhs_bc_x2", DevExeSpace(), 0, (nmb-1), ks, ke, is, ie,
-    KOKKOS_LAMBDA(int m, int k, int i) {
-      // Inner boundary
-      switch(mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, js, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
+      || pm->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::user) && nl > 0) {
+    par_for("z4crhs_bc_x2", DevExeSpace(), 0, (nl-1), ks, ke, is, ie,
+    KOKKOS_LAMBDA(int l, int k, int i) {
+      if (l < nin) {
+        int m = bcs_list.d_view(BoundaryFace::inner_x2,l);
+        // Inner boundary
+        switch(mb_bcs.d_view(m,BoundaryFace::inner_x2)) {
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
               Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, js, i);
-            }
-          break;
-        default:
-          break;
-      }
-      // Outer boundary
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, je, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
+            break;
+          case BoundaryFlag::user:
+              if (user_Sbc) {
+                Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, js, i);
+              }
+            break;
+          default:
+            break;
+        }
+      } else {
+        int m = bcs_list.d_view(BoundaryFace::outer_x2,l-nin);
+        // Outer boundary
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x2)) {
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
               Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, je, i);
-            }
-          break;
-        default:
-          break;
+            break;
+          case BoundaryFlag::user:
+              if (user_Sbc) {
+                Z4cSommerfeld(z4c_, rhs_, indcs, size, m, k, je, i);
+              }
+            break;
+          default:
+            break;
+        }
       }
     });
   }
-  if (pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::outflow
+  nin = nbcs[BoundaryFace::inner_x3];
+  nl = nin + nbcs[BoundaryFace::outer_x3];
+  if ((pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::outflow
       || pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::diode
       || pm->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::user
       || pm->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::outflow
       || pm->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::diode
-      || pm->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::user) {
-    par_for("z4crhs_bc_x3", DevExeSpace(), 0, (nmb-1), js, je, is, ie,
-    KOKKOS_LAMBDA(int m, int j, int i) {
-      // Inner boundary
-      switch(mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ks, j, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
+      || pm->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::user) && nl > 0) {
+    par_for("z4crhs_bc_x3", DevExeSpace(), 0, (nl-1), js, je, is, ie,
+    KOKKOS_LAMBDA(int l, int j, int i) {
+      if (l < nin) {
+        int m = bcs_list.d_view(BoundaryFace::inner_x3,l);
+        // Inner boundary
+        switch(mb_bcs.d_view(m,BoundaryFace::inner_x3)) {
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
               Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ks, j, i);
-            }
-          break;
-        default:
-          break;
-      }
-      // Outer boundary
-      switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
-        case BoundaryFlag::diode:
-        case BoundaryFlag::outflow:
-            Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ke, j, i);
-          break;
-        case BoundaryFlag::user:
-            if (user_Sbc) {
+            break;
+          case BoundaryFlag::user:
+              if (user_Sbc) {
+                Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ks, j, i);
+              }
+            break;
+          default:
+            break;
+        }
+      } else {
+        int m = bcs_list.d_view(BoundaryFace::outer_x3,l-nin);
+        // Outer boundary
+        switch (mb_bcs.d_view(m,BoundaryFace::outer_x3)) {
+          case BoundaryFlag::diode:
+          case BoundaryFlag::outflow:
               Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ke, j, i);
-            }
-          break;
-        default:
-          break;
+            break;
+          case BoundaryFlag::user:
+              if (user_Sbc) {
+                Z4cSommerfeld(z4c_, rhs_, indcs, size, m, ke, j, i);
+              }
+            break;
+          default:
+            break;
+        }
       }
     });
   }
@@ -19,6 +19,7 @@
 #include "mesh/mesh.hpp"
 #include "bvals/bvals.hpp"
 #include "z4c/compact_object_tracker.hpp"
+#include "z4c/horizon_finder.hpp"
 #include "z4c/z4c.hpp"
 #include "tasklist/numerical_relativity.hpp"
 
@@ -95,6 +96,7 @@ void Z4c::QueueZ4cTasks() {
   pnr->QueueTask(&Z4c::CalcWaveForm, this, Z4c_Wave, "Z4c_Wave", Task_End,
                  {Z4c_ClearRW});
   pnr->QueueTask(&Z4c::TrackCompactObjects, this, Z4c_PT, "Z4c_PT", Task_End, {Z4c_Wave});
+  pnr->QueueTask(&Z4c::FindHorizons, this, Z4c_AHF, "Z4c_AHF", Task_End, {Z4c_PT});
 }
 
 //----------------------------------------------------------------------------------------
@@ -289,6 +291,20 @@ TaskStatus Z4c::TrackCompactObjects(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  void Z4c::FindHorizons
+//! \brief searches for apparent horizons at the end of each step (at cadence set in
+//! <horizon_finder> block)
+
+TaskStatus Z4c::FindHorizons(Driver *pdrive, int stage) {
+  if (stage == pdrive->nexp_stages) {
+    for (auto & ph : phorizon) {
+      ph.FindHorizon(pmy_pack);
+    }
+  }
+  return TaskStatus::complete;
+}
+
 
 //----------------------------------------------------------------------------------------
 //! \fn  void Z4c::CalcWeylScalar_
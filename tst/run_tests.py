@@ -5,6 +5,10 @@
 # Usage: From this directory, call this script with python:
 #        python run_tests.py
 
+#        Performance regression mode (optional):
+#        python run_tests.py --perf_record <tests>   # write perf_baseline.json
+#        python run_tests.py --perf <tests>          # compare against baseline
+
 # Notes:
 #   - Requires Python 3+.
 #   - This file should not be modified when adding new scripts.
@@ -26,6 +30,7 @@ sys.dont_write_bytecode = True
 
 # AthenaK modules
 import scripts.utils.athena as athena  # noqa
+import scripts.utils.perf as perf  # noqa
 
 # AthenaK logger
 logger = logging.getLogger('athena')
@@ -60,6 +65,16 @@ def main(**kwargs):
     # Remove duplicate test entries while preserving the original order
     test_names = list(OrderedDict.fromkeys(test_names))
 
+    # Performance mode: parse zone-cycles/cpu_second of every run of each test
+    perf_mode = kwargs.pop('perf')
+    perf_record = kwargs.pop('perf_record')
+    perf_baseline = kwargs.pop('perf_baseline')
+    perf_tol = kwargs.pop('perf_tol')
+    perf_phase_tol = kwargs.pop('perf_phase_tol')
+    perf_min_time = kwargs.pop('perf_min_time')
+    perf.enabled = perf_mode or perf_record
+    perf_results = OrderedDict()
+
     # Run tests
     current_dir = os.getcwd()
     test_times = []
@@ -114,7 +129,15 @@ def main(**kwargs):
                     logger.error("Exception occurred", exc_info=True)
                     test_errors.append('analyze()')
                     raise TestError(name_full.replace('.', '/') + '.py')
+                if perf.enabled:
+                    perf_results[name] = perf.pop_records()
+                    if perf_mode and not perf_record:
+                        baseline = perf.load_baseline(perf_baseline)
+                        result = perf.compare(name, baseline, perf_results[name],
+                                              perf_tol, perf_phase_tol,
+                                              perf_min_time) and result
             except TestError as err:
+                perf.pop_records()  # discard timings of failed tests
                 test_results.append(False)
                 logger.error('---> Error in ' + str(err))
                 # do not measure runtime for failed/incomplete tests
@@ -131,6 +154,14 @@ def main(**kwargs):
     finally:
         os.system('rm -rf {0}/build'.format(current_dir))
 
+    # Write performance baseline of all tests that passed
+    if perf_record:
+        passed = OrderedDict((name, recs) for name, recs in perf_results.items()
+                             if test_results[test_names.index(name)])
+        perf.save_baseline(perf_baseline, passed)
+        logger.info('Performance baseline for {0} tests written to {1}'.format(
+            len(passed), perf_baseline))
+
     # Report test results
     logger.info('\nResults:')
     for name, result, error, time in zip(test_names, test_results, test_errors,
@@ -207,6 +238,36 @@ if __name__ == '__main__':
                         default=None,
                         help='set filename of logfile')
 
+    parser.add_argument('--perf',
+                        action='store_true',
+                        help='compare zone-cycles/cpu_second and per-phase '
+                        'timings of each test against baseline file')
+
+    parser.add_argument('--perf_record',
+                        action='store_true',
+                        help='record performance of each test in baseline file')
+
+    parser.add_argument('--perf_baseline',
+                        type=str,
+                        default='perf_baseline.json',
+                        help='set filename of performance baseline')
+
+    parser.add_argument('--perf_tol',
+                        type=float,
+                        default=0.1,
+                        help='allowed fractional slowdown of each test')
+
+    parser.add_argument('--perf_phase_tol',
+                        type=float,
+                        default=0.25,
+                        help='allowed fractional slowdown of each phase of a test')
+
+    parser.add_argument('--perf_min_time',
+                        type=float,
+                        default=0.5,
+                        help='phases faster than this in baseline [s] are not '
+                        'checked individually')
+
     args = parser.parse_args()
     log_init(args)
 
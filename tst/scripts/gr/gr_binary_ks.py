@@ -0,0 +1,76 @@
+# Regression test of superposed Kerr-Schild binary spacetime
+#
+# Runs a static atmosphere in the spacetime of (1) a spinning hole with a companion of
+# negligible mass far outside the domain, with two steps of the finite differences used
+# for K_ij, and (2) an equal-mass binary on a circular orbit.  In (1) the metric must
+# match the single Kerr-Schild hole of cartesian_ks.hpp, and K_ij must converge to its
+# analytic value at second order in the step.  In both cases the excised cells must be
+# centered on the holes (errors computed by the executable are stored in the temporary
+# file binary_ks-errs.dat).
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_dx = 0.25  # cell size in input file
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    # (1) single hole limit, m2 -> 0 at large separation so that hole 1 is at rest
+    for h in (1.0e-3, 2.0e-3):
+        arguments = ['time/nlim=4',
+                     'adm/bh_mass1=1.0',
+                     'adm/bh_mass2=1.0e-8',
+                     'adm/bh_spin1=0.6',
+                     'adm/bh_separation=100.0',
+                     'adm/fd_step=' + repr(h)]
+        athena.run('tests/binary_ks.athinput', arguments)
+    # (2) equal-mass binary, holes move by several cells
+    athena.run('tests/binary_ks.athinput', [])
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    # columns: 0-2:Nx 3:Ncycle 4:time 5:metric_err 6:K_err
+    #          7:nexcise1 8:cen1_err 9:moved1 10:nexcise2 11:cen2_err 12:moved2
+    data = athena_read.error_dat('build/src/binary_ks-errs.dat')
+    if data.shape[0] != 3:
+        logger.warning('Expected 3 rows of errors, found {0:d}'.format(data.shape[0]))
+        return False
+    single, single_h2, binary = data[0], data[1], data[2]
+
+    if single[5] > 1.0e-8:
+        logger.warning('Metric differs from single Kerr-Schild hole by {0:g}'
+                       .format(single[5]))
+        analyze_status = False
+    if single[6] > 1.0e-5:
+        logger.warning('Finite-difference K_ij differs from analytic value by {0:g}'
+                       .format(single[6]))
+        analyze_status = False
+    if single_h2[6]/single[6] < 3.0:
+        logger.warning('Error of K_ij not second order in finite-difference step, '
+                       'ratio {0:g}'.format(single_h2[6]/single[6]))
+        analyze_status = False
+    if single[7] < 1.0 or single[8] > 0.5*_dx:
+        logger.warning('Excised region of single hole ({0:g} cells) not centered on '
+                       'hole, error {1:g}'.format(single[7], single[8]))
+        analyze_status = False
+
+    for n in range(2):
+        nexcise, cen_err, moved = binary[7 + 3*n:10 + 3*n]
+        if moved < 2.0*_dx:
+            logger.warning('Hole {0:d} only moved {1:g}'.format(n + 1, moved))
+            analyze_status = False
+        if nexcise < 1.0 or cen_err > 0.5*_dx:
+            logger.warning('Excised region of hole {0:d} ({1:g} cells) does not track '
+                           'orbit, error {2:g}'.format(n + 1, nexcise, cen_err))
+            analyze_status = False
+    return analyze_status
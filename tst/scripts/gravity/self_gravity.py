@@ -0,0 +1,117 @@
+# Regression test of self-gravity with the multigrid Poisson solver
+#
+# (1) Runs the Jeans instability in 1D with periodic boundaries at two resolutions, and
+#     checks that the amplitude of the unstable mode and its growth rate agree with
+#     linear theory (stored in the temporary file jeans-errs.dat).
+# (2) Computes the potential of a uniform-density sphere with isolated (multipole)
+#     boundary conditions at two resolutions, and checks that the errors relative to the
+#     analytic solution are small and decrease with resolution (stored in the temporary
+#     file uniform_sphere-errs.dat).
+# (3) Computes the potential of a slab with a sinusoidal density perturbation with disk
+#     boundary conditions (periodic in x1 and x2) at two resolutions, and checks that the
+#     errors relative to the analytic solution are small and converge at second order,
+#     which requires the Fourier modes of the potential at the x3 faces to be correct
+#     (stored in the temporary file disk_slab-errs.dat).
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for res in (32, 64):
+        arguments = ['job/basename=jeans',
+                     'mesh/nx1=' + repr(res),
+                     'meshblock/nx1=' + repr(res//4),
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0']
+        athena.run('tests/jeans.athinput', arguments)
+    for res in (32, 64):
+        arguments = ['job/basename=uniform_sphere',
+                     'mesh/nx1=' + repr(res),
+                     'mesh/nx2=' + repr(res),
+                     'mesh/nx3=' + repr(res),
+                     'output1/dt=-1.0']
+        athena.run('tests/uniform_sphere.athinput', arguments)
+    for res in (32, 64):
+        arguments = ['job/basename=disk_slab',
+                     'mesh/nx1=' + repr(res),
+                     'mesh/nx2=' + repr(res),
+                     'mesh/nx3=' + repr(res//2),
+                     'output1/dt=-1.0']
+        athena.run('tests/disk_slab.athinput', arguments)
+
+
+# Read rows of an error file, skipping comments
+def read_errors(filename):
+    rows = []
+    with open(filename, 'r') as f:
+        for line in f:
+            if not line.startswith('#'):
+                rows.append([float(x) for x in line.split()])
+    return rows
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    # columns: 0:nx1 1:ncycle 2:time 3:amp 4:amp_exact 5:rel_err 6:gamma 7:gamma_exact
+    rows = read_errors('build/src/jeans-errs.dat')
+    if len(rows) != 2:
+        logger.warning('Jeans instability errors not written for both resolutions')
+        return False
+    for row in rows:
+        if row[5] > 2.0e-2:
+            logger.warning('Jeans mode amplitude error {0:g} too large at nx1={1:d}'
+                           .format(row[5], int(row[0])))
+            analyze_status = False
+        if abs(row[6] - row[7]) > 2.0e-2*row[7]:
+            logger.warning('Jeans growth rate {0:g} differs from {1:g} by more than 2%'
+                           .format(row[6], row[7]))
+            analyze_status = False
+    if rows[1][5] > rows[0][5]:
+        logger.warning('Jeans mode amplitude error not decreasing with resolution')
+        analyze_status = False
+
+    # columns: 0-2:nx 3:ncycles 4:residual 5:L1 6:L-infty
+    rows = read_errors('build/src/uniform_sphere-errs.dat')
+    if len(rows) != 2:
+        logger.warning('Uniform sphere errors not written for both resolutions')
+        return False
+    for row in rows:
+        if row[4] > 1.0e-8:
+            logger.warning('Multigrid not converged at nx1={0:d}, residual {1:g}'
+                           .format(int(row[0]), row[4]))
+            analyze_status = False
+        if row[5] > 1.0e-2 or row[6] > 5.0e-2:
+            logger.warning('Uniform sphere potential errors L1={0:g}, Linf={1:g} too '
+                           'large at nx1={2:d}'.format(row[5], row[6], int(row[0])))
+            analyze_status = False
+    if rows[1][5] > rows[0][5]:
+        logger.warning('Uniform sphere L1 error not decreasing with resolution')
+        analyze_status = False
+
+    # columns: 0-2:nx 3:ncycles 4:residual 5:L1 6:L-infty
+    rows = read_errors('build/src/disk_slab-errs.dat')
+    if len(rows) != 2:
+        logger.warning('Disk slab errors not written for both resolutions')
+        return False
+    for row in rows:
+        if row[4] > 1.0e-8:
+            logger.warning('Multigrid not converged at nx1={0:d}, residual {1:g}'
+                           .format(int(row[0]), row[4]))
+            analyze_status = False
+        if row[5] > 5.0e-2 or row[6] > 5.0e-2:
+            logger.warning('Disk slab potential errors L1={0:g}, Linf={1:g} too '
+                           'large at nx1={2:d}'.format(row[5], row[6], int(row[0])))
+            analyze_status = False
+    if rows[1][5] > rows[0][5]/3.0:
+        logger.warning('Disk slab L1 error {0:g} not second order, {1:g} at lower '
+                       'resolution'.format(rows[1][5], rows[0][5]))
+        analyze_status = False
+    return analyze_status
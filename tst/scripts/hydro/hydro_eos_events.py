@@ -0,0 +1,61 @@
+# Regression test of maps of C2P failures and floors
+#
+# Initializes a 1D hydro linear wave with a density floor above the density everywhere,
+# so the floor is applied in every cell by the first C2P (which also covers ghost
+# zones), and writes the event map including ghost zones.  Every active cell must
+# record the same number of density floors, and no events may be recorded in ghost
+# zones.
+
+# Modules
+import logging
+import numpy as np
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_nx1 = 64
+_nmbx1 = 16
+_ng = 2
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=eos_events',
+                 'time/nlim=0',
+                 'mesh/nghost=' + repr(_ng),
+                 'mesh/nx1=' + repr(_nx1), 'mesh/nx2=1', 'mesh/nx3=1',
+                 'meshblock/nx1=' + repr(_nmbx1), 'meshblock/nx2=1', 'meshblock/nx3=1',
+                 'hydro/dfloor=2.0',
+                 'hydro/event_map=true',
+                 'output1/variable=hydro_events',
+                 'output1/ghost_zones=true',
+                 'output1/dt=10.0',
+                 'output2/dt=-1.0',
+                 'output3/dt=-1.0']
+    athena.run('tests/linear_wave_hydro.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    # columns: 0:gid 1:i 2:x1v 3:dfloor 4:efloor 5:tfloor 6:vceil 7:fail
+    data = np.loadtxt('build/src/tab/eos_events.hydro_events.00001.tab', ndmin=2)
+    if data.shape[0] != (_nx1//_nmbx1)*(_nmbx1 + 2*_ng):
+        logger.warning('Unexpected number of cells {0:d} in event map'
+                       .format(data.shape[0]))
+        return False
+    active = (data[:, 1] >= _ng) & (data[:, 1] < _ng + _nmbx1)
+    dfloor = data[active, 3]
+    if np.min(dfloor) < 1.0 or np.max(dfloor) != np.min(dfloor):
+        logger.warning('Density floors in active cells range from {0:g} to {1:g}, '
+                       'should be equal and >= 1'.format(np.min(dfloor), np.max(dfloor)))
+        analyze_status = False
+    nghost_events = np.sum(data[~active, 3:])
+    if nghost_events != 0.0:
+        logger.warning('{0:g} events recorded in ghost zones'.format(nghost_events))
+        analyze_status = False
+    nother = np.sum(data[active, 4:])
+    if nother != 0.0:
+        logger.warning('{0:g} unexpected events recorded in active cells'.format(nother))
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,57 @@
+# Regression test of anisotropic thermal conduction in MHD (ring test)
+#
+# Runs the ring test with the explicit and RKL2 super time-stepping integrators, and
+# checks that no new temperature extrema appear, that little heat leaks across field
+# lines, that heat spreads along the ring, and that both integrators agree (stored in the
+# temporary file conduction_ring-errs.dat).
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for integrator in ('explicit', 'rkl2'):
+        arguments = ['mhd/cond_integrator=' + integrator,
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0']
+        athena.run('tests/conduction_ring.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    # columns: 0:nx1 1:nx2 2:ncycle 3:sts_stages 4:tmin 5:tmax 6:leak 7:spread
+    rows = []
+    with open('build/src/conduction_ring-errs.dat', 'r') as f:
+        for line in f:
+            if not line.startswith('#'):
+                rows.append([float(x) for x in line.split()])
+    if len(rows) != 2:
+        logger.warning('Ring test diagnostics not written for both integrators')
+        return False
+    for row, name in zip(rows, ('explicit', 'rkl2')):
+        if row[4] < 9.99 or row[5] > 12.0:
+            logger.warning('New temperature extrema Tmin={0:g}, Tmax={1:g} with {2}'
+                           .format(row[4], row[5], name))
+            analyze_status = False
+        if row[6] > 0.1:
+            logger.warning('Heat leaked across field lines {0:g} too large with {1}'
+                           .format(row[6], name))
+            analyze_status = False
+        if row[7] < 0.3:
+            logger.warning('Heat spread along ring {0:g} too small with {1}'
+                           .format(row[7], name))
+            analyze_status = False
+    if rows[1][3] < 2 or rows[1][2] >= rows[0][2]:
+        logger.warning('RKL2 did not take fewer, longer time steps than explicit')
+        analyze_status = False
+    if abs(rows[1][7] - rows[0][7]) > 0.05 or abs(rows[1][6] - rows[0][6]) > 0.02:
+        logger.warning('RKL2 and explicit solutions differ')
+        analyze_status = False
+    return analyze_status
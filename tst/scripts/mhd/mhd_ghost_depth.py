@@ -0,0 +1,56 @@
+# Regression test of boundary exchange with fewer ghost zones than allocated
+#
+# Runs an MHD linear wave in 3D, with and without SMR, on a Mesh with 4 ghost zones of
+# which only <mhd>/nghost=2 are exchanged, and on a Mesh with 2 ghost zones.  Since
+# PLM only uses 2 ghost zones the solutions must be identical, which is checked by
+# comparing the L1 errors (stored in the temporary file ghost_mhd-errs.dat).
+
+# Modules
+import logging
+import numpy as np
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_inputs = ['tests/linear_wave_mhd.athinput', 'tests/linear_wave_mhd_smr.athinput']
+_ghost = [['mesh/nghost=2'], ['mesh/nghost=4', 'mhd/nghost=2']]
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=ghost_mhd',
+                 'time/tlim=1.0',
+                 'mesh/nx1=32', 'mesh/nx2=16', 'mesh/nx3=16',
+                 'meshblock/nx1=8', 'meshblock/nx2=8', 'meshblock/nx3=8',
+                 'mhd/reconstruct=plm',
+                 'problem/amp=1.0e-6',
+                 'output1/dt=-1.0',
+                 'output2/dt=-1.0',
+                 'output3/dt=-1.0',
+                 'output4/dt=-1.0',
+                 'output5/dt=-1.0']
+    for input_file in _inputs:
+        for ghost in _ghost:
+            athena.run(input_file, arguments + ghost)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    # columns: 0-2:Nx 3:Ncycle 4:RMS-L1 5:L-infty 6...:L1 of each variable
+    data = athena_read.error_dat('build/src/ghost_mhd-errs.dat')
+    if data.shape[0] != 2*len(_inputs):
+        logger.warning('Expected {0:d} rows of errors, found {1:d}'
+                       .format(2*len(_inputs), data.shape[0]))
+        return False
+    for n, input_file in enumerate(_inputs):
+        if not np.array_equal(data[2*n], data[2*n + 1]):
+            logger.warning('Errors of {0:s} with <mhd>/nghost=2 on Mesh with 4 ghost '
+                           'zones {1} differ from errors with 2 ghost zones {2}'
+                           .format(input_file, data[2*n + 1], data[2*n]))
+            analyze_status = False
+    return analyze_status
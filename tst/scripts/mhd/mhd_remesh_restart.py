@@ -0,0 +1,67 @@
+# Regression test of restarts onto a different Mesh
+#
+# Runs an MHD linear wave for half a period and writes a restart file, which is then
+# restarted onto (1) smaller MeshBlocks, (2) a root grid with twice the resolution, and
+# (3) the same grid with an added SMR region.  Each restart stops with an error if the
+# change in conserved totals or max |div(B)| dx/|B| after remeshing exceeds
+# <mesh>/remesh_tolerance, and the L1 errors after one period (stored in the temporary
+# file rmsh-errs.dat) are compared with those of a restart onto the same Mesh.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_rst = ['-r', 'rst/rmsh.00001.rst']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=rmsh',
+                 'mesh/remesh_tolerance=1.0e-10']
+    # first half period written to restart file, then reference restart onto same Mesh
+    athena.run('tests/remesh_restart_mhd.athinput', arguments + ['time/tlim=0.5'])
+    athena.run('tests/remesh_restart_mhd.athinput', _rst + arguments)
+    # (1) smaller MeshBlocks
+    athena.run('tests/remesh_restart_mhd.athinput', _rst + arguments +
+               ['meshblock/nx1=8', 'meshblock/nx2=8', 'meshblock/nx3=8'])
+    # (2) root grid refined by one level
+    athena.run('tests/remesh_restart_mhd.athinput', _rst + arguments +
+               ['mesh/nx1=64', 'mesh/nx2=32', 'mesh/nx3=32'])
+    # (3) added SMR region
+    athena.run('tests/remesh_restart_mhd.athinput', _rst + arguments +
+               ['mesh/restart_remesh=true', 'mesh_refinement/refinement=static'])
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    # columns: 0-2:Nx 3:Ncycle 4:RMS-L1 5:L-infty ...
+    data = athena_read.error_dat('build/src/rmsh-errs.dat')
+    if data.shape[0] != 5:
+        logger.warning('Expected 5 rows of errors, found {0:d}'.format(data.shape[0]))
+        return False
+    err_ref = data[1][4]
+    err_mb, err_root, err_smr = data[2][4], data[3][4], data[4][4]
+
+    # regrouping cells into smaller MeshBlocks does not change the solution
+    if abs(err_mb - err_ref) > 1.0e-6*err_ref:
+        logger.warning('Error with smaller MeshBlocks {0:g} differs from error with '
+                       'restart onto same Mesh {1:g}'.format(err_mb, err_ref))
+        analyze_status = False
+    # finer root grid for second half period must reduce the error
+    if err_root > err_ref or int(data[3][0]) != 64:
+        logger.warning('Error with refined root grid {0:g} not smaller than error '
+                       'with restart onto same Mesh {1:g}'.format(err_root, err_ref))
+        analyze_status = False
+    # SMR region must not degrade the solution significantly
+    if err_smr > 1.5*err_ref:
+        logger.warning('Error with added SMR {0:g} too large compared to error with '
+                       'restart onto same Mesh {1:g}'.format(err_smr, err_ref))
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,56 @@
+# Regression test of surface flux output
+#
+# Computes fluxes through three spherical shells in a uniform magnetized flow on a Mesh
+# of many MeshBlocks, with the largest shell touching the outer boundaries of the Mesh.
+# The mass and energy fluxes must vanish, and the magnetic flux 0.5*|B_r| integrated
+# over each shell must equal pi |B| r^2.  Since the field is uniform, the integrals
+# scaled by r^2 must be identical on every shell, which fails if any point is dropped
+# or counted twice by the MeshBlocks (or ranks) that share it.
+
+# Modules
+import logging
+import numpy as np
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_radii = [0.3, 0.65, 1.0]
+_bmag = np.sqrt(1.0 + 2.0 + 0.25)  # |B| of background state of linear_wave pgen
+_vflow = 0.5
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    athena.run('tests/surface_flux.athinput', [])
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    # columns: 0:time, then mdot, edot, phi on each shell
+    data = np.loadtxt('build/src/sflux.flux.flx', ndmin=2)
+    row = data[-1]
+    phi_scaled = []
+    for s, r in enumerate(_radii):
+        mdot, edot, phi = row[1 + 3*s:4 + 3*s]
+        area = 4.0*np.pi*r**2
+        if abs(mdot) > 1.0e-10*_vflow*area:
+            logger.warning('Mass flux {0:g} through shell r={1:g} not zero'
+                           .format(mdot, r))
+            analyze_status = False
+        if abs(edot) > 1.0e-10*_vflow*area:
+            logger.warning('Energy flux {0:g} through shell r={1:g} not zero'
+                           .format(edot, r))
+            analyze_status = False
+        phi_exact = np.pi*_bmag*r**2
+        if abs(phi - phi_exact) > 1.0e-2*phi_exact:
+            logger.warning('Magnetic flux {0:g} through shell r={1:g} differs from '
+                           'exact value {2:g}'.format(phi, r, phi_exact))
+            analyze_status = False
+        phi_scaled.append(phi/r**2)
+    spread = (max(phi_scaled) - min(phi_scaled))/max(phi_scaled)
+    if spread > 1.0e-10:
+        logger.warning('Magnetic flux scaled by r^2 differs between shells by {0:g}, '
+                       'points are missing or counted twice'.format(spread))
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,70 @@
+# Regression test of the Hall effect and ambipolar diffusion in MHD
+#
+# Runs the Hall whistler wave at two resolutions and checks that the
+# L1 error relative to the exact solution is small and converges, then runs the ambipolar
+# C-shock with the explicit and RKL2 integrators and checks both against the analytic
+# profile (errors stored in the temporary files hall_whistler-errs.dat and
+# ambipolar_cshock-errs.dat).
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for nx1 in (32, 64):
+        arguments = ['mesh/nx1=' + repr(nx1),
+                     'meshblock/nx1=' + repr(nx1),
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0']
+        athena.run('tests/hall_whistler.athinput', arguments)
+    for integrator in ('explicit', 'rkl2'):
+        arguments = ['mhd/ambipolar_integrator=' + integrator,
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0']
+        athena.run('tests/ambipolar_cshock.athinput', arguments)
+
+
+# Read rows of errors file
+def read_errors(filename):
+    rows = []
+    with open(filename, 'r') as f:
+        for line in f:
+            if not line.startswith('#'):
+                rows.append([float(x) for x in line.split()])
+    return rows
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    # columns: 0:nx1 1:ncycle 2:substeps 3:l1_err
+    rows = read_errors('build/src/hall_whistler-errs.dat')
+    if len(rows) != 2:
+        logger.warning('Whistler errors not written for both resolutions')
+        return False
+    if rows[1][3] > 0.05:
+        logger.warning('Whistler error {0:g} too large'.format(rows[1][3]))
+        analyze_status = False
+    if rows[0][3]/rows[1][3] < 2.5:
+        logger.warning('Whistler error converging at ratio {0:g}, expected about 4'
+                       .format(rows[0][3]/rows[1][3]))
+        analyze_status = False
+
+    rows = read_errors('build/src/ambipolar_cshock-errs.dat')
+    if len(rows) != 2:
+        logger.warning('C-shock errors not written for both integrators')
+        return False
+    for row, name in zip(rows, ('explicit', 'rkl2')):
+        if row[3] > 0.05:
+            logger.warning('C-shock error {0:g} too large with {1}'.format(row[3], name))
+            analyze_status = False
+    if rows[1][2] < 2 or rows[1][1] >= rows[0][1]:
+        logger.warning('RKL2 did not take fewer, longer time steps than explicit')
+        analyze_status = False
+    return analyze_status
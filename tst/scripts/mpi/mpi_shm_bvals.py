@@ -0,0 +1,54 @@
+# Regression test of boundary exchange through MPI-3 shared memory windows
+#
+# Runs the 2D MHD linear wave with AMR on 4 ranks of one node, exchanging boundary
+# buffers between ranks with MPI and with <mesh>/shared_memory_bvals=true.  Both paths
+# must give bit-identical results, which is checked by comparing the binary data of the
+# final restart files (everything after the copy of the input parameters, which differ).
+# Requires AthenaK to be built with MPI, e.g.
+#   python3 run_tests.py mpi --cmake=-DAthena_ENABLE_MPI=ON
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_nproc = 4
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for shm in ('false', 'true'):
+        arguments = ['job/basename=shm_' + shm,
+                     'mesh/shared_memory_bvals=' + shm,
+                     'time/tlim=1.0',
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0',
+                     'output3/file_type=rst',
+                     'output3/dt=10.0',
+                     'output4/dt=-1.0']
+        athena.mpirun(_nproc, 'tests/linear_wave_mhd_amr.athinput', arguments)
+
+
+# Strip copy of input parameters from restart file
+def restart_data(filename):
+    with open(filename, 'rb') as f:
+        data = f.read()
+    marker = b'<par_end>\n'
+    return data[data.index(marker) + len(marker):]
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    data_mpi = restart_data('build/src/rst/shm_false.00001.rst')
+    data_shm = restart_data('build/src/rst/shm_true.00001.rst')
+    if len(data_mpi) != len(data_shm):
+        logger.warning('Restart files differ in size ({0:d} and {1:d} bytes), Mesh '
+                       'refined differently'.format(len(data_mpi), len(data_shm)))
+        return False
+    if data_mpi != data_shm:
+        nbytes = sum(a != b for a, b in zip(data_mpi, data_shm))
+        logger.warning('{0:d} bytes of restart data differ between shared memory '
+                       'and MPI boundary exchange'.format(nbytes))
+        return False
+    return True
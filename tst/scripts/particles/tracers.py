@@ -0,0 +1,56 @@
+# Regression test of tracer particles
+#
+# (1) Velocity-interpolated tracers in a uniform 2D flow are advected for an integer
+#     number of crossing times, and must return to their initial offset within cells.
+# (2) Monte Carlo tracers, initially distributed in proportion to the cell mass, must
+#     follow the mass distribution of a sinusoidal density profile advected for one
+#     crossing time.
+# Errors are stored in the temporary file tracers-errs.dat.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['particles/pusher=lagrangian_tracer',
+                 'output1/dt=-1.0']
+    athena.run('tests/tracers.athinput', arguments)
+    arguments = ['particles/pusher=lagrangian_mc',
+                 'particles/ppc=16.0',
+                 'time/tlim=1.0',
+                 'output1/dt=-1.0']
+    athena.run('tests/tracers.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    # columns: 0:pusher 1-3:nx 4:ntracers 5:ncycle 6:err1 7:err2
+    rows = []
+    with open('build/src/tracers-errs.dat', 'r') as f:
+        for line in f:
+            if not line.startswith('#'):
+                rows.append([float(x) for x in line.split()])
+    if len(rows) != 2:
+        logger.warning('Tracer errors not written for both pushers')
+        return False
+
+    # velocity-interpolated tracers: L1 and maximum error in units of dx
+    if rows[0][6] > 1.0e-3 or rows[0][7] > 1.0e-2:
+        logger.warning('Tracer advection errors L1={0:g}, Linf={1:g} too large'
+                       .format(rows[0][6], rows[0][7]))
+        analyze_status = False
+
+    # Monte Carlo tracers: difference from mass distribution must be close to sampling
+    # noise, and much smaller than difference of uniform distribution from mass
+    if rows[1][6] > 0.06 or rows[1][7] < 0.2:
+        logger.warning('Monte Carlo tracers do not follow mass: err={0:g}, ref={1:g}'
+                       .format(rows[1][6], rows[1][7]))
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,49 @@
+# Regression test of gray M1 radiation in the diffusion limit
+#
+# Runs the diffusion of a Gaussian pulse in an optically thick scattering medium at two
+# resolutions, and checks that the L1 error relative to the analytic solution of the
+# diffusion equation (stored in the temporary file m1_diffusion-errs.dat) is small and
+# decreases with resolution.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for nx1 in (128, 256):
+        arguments = ['mesh/nx1=' + repr(nx1),
+                     'meshblock/nx1=' + repr(nx1//4),
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0']
+        athena.run('tests/m1_diffusion.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    # columns: 0:nx1 1:ncycle 2:l1_err 3:emax 4:emax_exact
+    rows = []
+    with open('build/src/m1_diffusion-errs.dat', 'r') as f:
+        for line in f:
+            if not line.startswith('#'):
+                rows.append([float(x) for x in line.split()])
+    if len(rows) != 2:
+        logger.warning('M1 diffusion errors not written for both resolutions')
+        return False
+    if rows[1][2] > 5.0e-3:
+        logger.warning('M1 diffusion error {0:g} too large'.format(rows[1][2]))
+        analyze_status = False
+    if rows[1][2] >= rows[0][2]:
+        logger.warning('M1 diffusion error not decreasing with resolution')
+        analyze_status = False
+    if abs(rows[1][3] - rows[1][4]) > 0.02*rows[1][4]:
+        logger.warning('M1 peak energy density {0:g} differs from exact {1:g}'
+                       .format(rows[1][3], rows[1][4]))
+        analyze_status = False
+    return analyze_status
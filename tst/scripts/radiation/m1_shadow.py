@@ -0,0 +1,55 @@
+# Regression test of gray M1 radiation in the free-streaming limit
+#
+# Runs a plane-parallel beam entering through the inner x1 face (1) through empty space
+# and (2) past an opaque cloud.  Once the beam has crossed the domain, the energy
+# density and flux away from the cloud must equal those of the beam, and the core of
+# the shadow behind the cloud must be dark in (2) but not in (1).  The L1 error of the
+# beam and mean energy density in the shadow (in units of the beam) are stored in the
+# temporary file m1_shadow-errs.dat.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['time/tlim=2.5',
+                 'mesh/nx1=128', 'mesh/nx2=64',
+                 'meshblock/nx1=32', 'meshblock/nx2=32',
+                 'output1/dt=-1.0',
+                 'output2/dt=-1.0']
+    # (1) beam without cloud, (2) shadow
+    athena.run('radiation/m1_shadow.athinput', arguments + ['problem/kappa_cloud=0.0'])
+    athena.run('radiation/m1_shadow.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+    # columns: 0:nx1 1:nx2 2:ncycle 3:beam_l1_err 4:e_shadow
+    data = athena_read.error_dat('build/src/m1_shadow-errs.dat')
+    if data.shape[0] != 2:
+        logger.warning('Expected 2 rows of errors, found {0:d}'.format(data.shape[0]))
+        return False
+    beam, shadow = data[0], data[1]
+
+    if beam[3] > 1.0e-3 or abs(beam[4] - 1.0) > 1.0e-3:
+        logger.warning('Beam not propagated correctly, L1 error {0:g}, energy density '
+                       '{1:g} behind (transparent) cloud'.format(beam[3], beam[4]))
+        analyze_status = False
+    if shadow[3] > 5.0e-2:
+        logger.warning('Beam next to cloud disturbed, L1 error {0:g}'.format(shadow[3]))
+        analyze_status = False
+    if shadow[4] > 0.1:
+        logger.warning('Energy density {0:g} in shadow of cloud too large'
+                       .format(shadow[4]))
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,51 @@
+# Regression test of thermal relaxation with multigroup radiation
+#
+# Runs the relaxation of gas and radiation (initially all in the lowest frequency group)
+# in a uniform medium, and checks that the radiation relaxes to a Planck spectrum at the
+# final gas temperature (with E_rad = a_r T^4), and that total energy is conserved.
+# Results are written by the executable to the temporary file relax_mg-errs.dat.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=relax_mg',
+                 'output1/dt=-1.0']
+    athena.run('radiation/relax_multigroup.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    rows = []
+    with open('build/src/relax_mg-errs.dat', 'r') as f:
+        for line in f:
+            if not line.startswith('#'):
+                rows.append([float(x) for x in line.split()])
+    if len(rows) < 2:
+        logger.warning('Relaxation results not written')
+        return False
+    analyze_status = True
+
+    # first row: 0:Tgas 1:Erad 2:aT^4 3:dEtot/Etot
+    tgas, erad, at4, de = rows[0]
+    if abs(de) > 1.0e-10:
+        logger.warning('Total energy changed by fraction {0:g}'.format(de))
+        analyze_status = False
+    if abs(erad - at4) > 1.0e-2*at4:
+        logger.warning('Radiation energy {0:g} not in equilibrium with gas '
+                       'temperature {1:g} (aT^4 = {2:g})'.format(erad, tgas, at4))
+        analyze_status = False
+
+    # other rows: 0:group 1:nu_min 2:nu_max 3:Erad_g/Erad 4:Planck fraction
+    for row in rows[1:]:
+        if abs(row[3] - row[4]) > 1.0e-2:
+            logger.warning('Energy fraction {0:g} of group {1:d} differs from Planck '
+                           'fraction {2:g}'.format(row[3], int(row[0]), row[4]))
+            analyze_status = False
+    return analyze_status
@@ -6,6 +6,7 @@ import os
 import subprocess
 from timeit import default_timer as timer
 from .log_pipe import LogPipe
+from . import perf
 
 # Global variables
 athena_rel_path = '../'
@@ -51,13 +52,18 @@ def run(input_filename, arguments):
         try:
             cmd = run_command + arguments
             logging.getLogger('athena.run').debug('Executing: '+' '.join(cmd))
+            t0 = timer()
             subprocess.check_call(cmd, stdout=out_log)
+            wall_time = timer() - t0
         except subprocess.CalledProcessError as err:
             raise AthenaError('Return code {0} from command \'{1}\''
                               .format(err.returncode, ' '.join(err.cmd)))
     finally:
         out_log.close()
         os.chdir(current_dir)
+    if perf.enabled:
+        out_log.join()  # wait for all output to be read before parsing it
+        perf.record(input_filename, arguments, out_log.lines, wall_time)
 
 
 # Function for running AthenaK with MPI
@@ -69,12 +75,14 @@ def mpirun(nproc, input_filename, arguments):
     try:
         input_filename_full = '../../' + athena_rel_path + \
                               'inputs/' + input_filename
-        run_command = ['mpiexec -n', str(nproc), './athena', '-i',
+        run_command = ['mpiexec', '-n', str(nproc), './athena', '-i',
                        input_filename_full]
         try:
             cmd = run_command + arguments
             logging.getLogger('athena.run').debug('Executing: '+' '.join(cmd))
+            t0 = timer()
             subprocess.check_call(cmd, stdout=out_log)
+            wall_time = timer() - t0
         except subprocess.CalledProcessError as err:
             raise AthenaError('Return code {0} from command \'{1}\''
                               .format(err.returncode, ' '.join(err.cmd)))
@@ -82,6 +90,10 @@ def mpirun(nproc, input_filename, arguments):
     finally:
         out_log.close()
         os.chdir(current_dir)
+    if perf.enabled:
+        out_log.join()  # wait for all output to be read before parsing it
+        perf.record(input_filename, ['np=' + str(nproc)] + arguments,
+                    out_log.lines, wall_time)
 
 
 # General exception class for these functions
@@ -15,6 +15,7 @@ class LogPipe(threading.Thread):
         self.logger = logging.getLogger(logger)
         self.daemon = False
         self.level = level
+        self.lines = []  # copy of every line, e.g. for parsing performance data
         self.fdRead, self.fdWrite = os.pipe()
         self.pipeReader = os.fdopen(self.fdRead)
         self.start()
@@ -26,6 +27,7 @@ class LogPipe(threading.Thread):
     # Run the thread, logging everything.
     def run(self):
         for line in iter(self.pipeReader.readline, ''):
+            self.lines.append(line.strip('\n'))
             self.logger.log(self.level, line.strip('\n'))
         self.pipeReader.close()
 
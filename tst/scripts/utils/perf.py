@@ -0,0 +1,152 @@
+# Functions for recording and comparing performance of AthenaK during testing
+#
+# When enabled (by run_tests.py --perf), every call to athena.run() or athena.mpirun()
+# parses the zone-cycles/cpu_second and cpu time printed by Driver::Finalize() and
+# stores them, keyed by the input file and command line arguments of the run.  Each
+# such run is one "phase" of a test.  If the run was made with a <timers> block in the
+# input file, the mean inclusive time of each timer region in the last table printed is
+# also stored, so that regressions can be attributed to individual regions.  Records of
+# a whole test are either written to a baseline file, or compared against one with a
+# given tolerance.
+
+# Modules
+import json
+import logging
+import os
+import re
+
+# Global variables
+enabled = False  # set to True by run_tests.py to parse output of each run
+records = []     # performance records of runs made since last call to pop_records()
+
+_zcps_re = re.compile(r'zone-cycles/cpu_second\s*=\s*(\S+)')
+_cpu_re = re.compile(r'cpu time used\s*=\s*(\S+)')
+_timers_re = re.compile(r'^Timer regions')
+
+
+# Parse output of one run and store performance record
+def record(input_filename, arguments, lines, wall_time):
+    rec = {'key': ' '.join([input_filename] + list(arguments)),
+           'zcps': None,
+           'cpu_time': None,
+           'wall_time': wall_time,
+           'regions': parse_timers(lines)}
+    for line in lines:
+        match = _zcps_re.search(line)
+        if match:
+            rec['zcps'] = float(match.group(1))
+        match = _cpu_re.search(line)
+        if match:
+            rec['cpu_time'] = float(match.group(1))
+    records.append(rec)
+
+
+# Parse last table of timer regions printed by timers::Report().  Returns dictionary of
+# mean inclusive time keyed by path of region, e.g. 'Cycle/stagen/Hydro::Fluxes'.
+# Nesting of regions is given by indentation of two spaces per level.
+def parse_timers(lines):
+    regions = {}
+    path = []
+    in_table = False
+    for line in lines:
+        if _timers_re.match(line):
+            regions = {}
+            path = []
+            in_table = True
+            continue
+        if not in_table:
+            continue
+        fields = line.split()
+        if len(fields) == 0:  # table ends with blank line
+            in_table = False
+        elif len(fields) == 9 and fields[0] != 'region':
+            depth = (len(line) - len(line.lstrip(' '))) // 2
+            path = path[:depth] + [fields[0]]
+            regions['/'.join(path)] = float(fields[3])
+    return regions
+
+
+# Return all records stored since last call, and clear list
+def pop_records():
+    global records
+    ret = records
+    records = []
+    return ret
+
+
+# Aggregate zone-cycles/cpu_second over all runs in a test
+def total_zcps(recs):
+    zone_cycles = 0.0
+    cpu_time = 0.0
+    for rec in recs:
+        if rec['zcps'] is not None and rec['cpu_time'] is not None:
+            zone_cycles += rec['zcps'] * rec['cpu_time']
+            cpu_time += rec['cpu_time']
+    return zone_cycles / cpu_time if cpu_time > 0.0 else None
+
+
+# Read baseline file (returns empty dictionary if file does not exist)
+def load_baseline(filename):
+    if not os.path.isfile(filename):
+        return {}
+    with open(filename, 'r') as f:
+        return json.load(f)
+
+
+# Write baseline file, keeping entries for tests not run this time
+def save_baseline(filename, results):
+    baseline = load_baseline(filename)
+    for name, recs in results.items():
+        baseline[name] = {'zcps': total_zcps(recs), 'runs': recs}
+    with open(filename, 'w') as f:
+        json.dump(baseline, f, indent=2, sort_keys=True)
+
+
+# Compare records of one test against baseline.  Returns False if the test as a whole
+# or any phase taking longer than min_time is slower than allowed by the tolerances,
+# in which case a per-phase breakdown is written to the log.
+def compare(name, baseline, recs, tol, phase_tol, min_time):
+    logger = logging.getLogger('athena.perf.' + name)
+    if name not in baseline:
+        logger.warning('No performance baseline for test {0}'.format(name))
+        return True
+    base = baseline[name]
+    zcps = total_zcps(recs)
+    if base['zcps'] is None or zcps is None:
+        logger.warning('No zone-cycles/cpu_second found for test {0}'.format(name))
+        return True
+
+    status = True
+    slowdown = base['zcps'] / zcps - 1.0
+    if slowdown > tol:
+        status = False
+    breakdown = []
+    base_runs = {run['key']: run for run in base['runs']}
+    for rec in recs:
+        if rec['key'] not in base_runs:
+            continue
+        brec = base_runs[rec['key']]
+        phases = [('total', brec['cpu_time'], rec['cpu_time'])]
+        for region, btime in sorted(brec['regions'].items()):
+            phases.append((region, btime, rec['regions'].get(region)))
+        for phase, btime, time in phases:
+            if btime is None or time is None or btime <= 0.0:
+                continue
+            ratio = time / btime - 1.0
+            flag = ''
+            if btime >= min_time and ratio > phase_tol:
+                flag = '  <-- SLOWER'
+                status = False
+            breakdown.append('    {0:<12.4g} {1:<12.4g} {2:+8.1%}  {3}: {4}{5}'.format(
+                btime, time, ratio, rec['key'], phase, flag))
+
+    msg = 'zone-cycles/cpu_second {0:.4g} (baseline {1:.4g}, change {2:+.1%})'
+    msg = msg.format(zcps, base['zcps'], -slowdown / (1.0 + slowdown))
+    if status:
+        logger.info(msg)
+    else:
+        logger.warning('Performance regression in test {0}: '.format(name) + msg)
+        logger.warning('    baseline[s]  current[s]   change   phase')
+        for line in breakdown:
+            logger.warning(line)
+    return status
@@ -0,0 +1,79 @@
+# Regression test of dynamical GRMHD in the Cowling approximation
+#
+# Evolves a uniform atmosphere on the spacetime of a gravitational wave with the Z4c
+# metric frozen (<z4c>/cowling=true), and writes the ADM variables every cycle.  With
+# the metric always frozen the ADM variables must be identical in every cycle.  With
+# <z4c>/cowling_recouple_interval=N they must change in, and only in, the coupled
+# cycles (those with ncycle % N < cowling_recouple_ncycles).
+
+# Modules
+import glob
+import logging
+import numpy as np
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_interval = 4
+_ncoupled = 1
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    athena.run('tests/cowling_z4c.athinput', ['job/basename=cowl_frozen'])
+    athena.run('tests/cowling_z4c.athinput',
+               ['job/basename=cowl_recouple',
+                'z4c/cowling_recouple_interval=' + repr(_interval),
+                'z4c/cowling_recouple_ncycles=' + repr(_ncoupled)])
+
+
+# Returns list of (cycle, ADM variables) in each tab file of run
+def read_adm(basename):
+    data = []
+    for fname in sorted(glob.glob('build/src/tab/' + basename + '.adm.*.tab')):
+        tab = athena_read.tab(fname)
+        adm = [tab[key] for key in sorted(tab) if key.startswith('adm_')]
+        data.append((tab['cycle'], np.array(adm)))
+    return data
+
+
+# Returns list of (cycle, changed) for each cycle between outputs
+def adm_changes(basename):
+    data = read_adm(basename)
+    changes = []
+    for (c0, adm0), (c1, adm1) in zip(data[:-1], data[1:]):
+        if c1 == c0 + 1:
+            changes.append((c0, not np.array_equal(adm0, adm1)))
+    return changes
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    changes = adm_changes('cowl_frozen')
+    if len(changes) < 2*_interval:
+        logger.warning('Only {0:d} cycles of ADM variables found'.format(len(changes)))
+        return False
+    for cycle, changed in changes:
+        if changed:
+            logger.warning('ADM variables changed in cycle {0:d} with frozen metric'
+                           .format(cycle))
+            analyze_status = False
+
+    changes = adm_changes('cowl_recouple')
+    if len(changes) < 2*_interval:
+        logger.warning('Only {0:d} cycles of ADM variables found'.format(len(changes)))
+        return False
+    for cycle, changed in changes:
+        coupled = (cycle % _interval) < _ncoupled
+        if changed != coupled:
+            logger.warning('ADM variables {0:s}changed in {1:s} cycle {2:d}'
+                           .format('' if changed else 'un',
+                                   'coupled' if coupled else 'frozen', cycle))
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,50 @@
+# Regression test of apparent horizon finder
+#
+# Runs one cycle of a single (non-spinning) puncture with the horizon finder, and checks
+# that the horizon is found with the analytic irreducible mass M_irr = M = 1 and zero
+# spin.  The horizon is at coordinate radius M/2 in isotropic coordinates.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=z4c_ahf']
+    athena.run('z4c/onepuncture/z4c_onepuncture_ahf.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    rows = []
+    with open('build/src/z4c_ahf.horizon_0.txt', 'r') as f:
+        for line in f:
+            if not line.startswith('#'):
+                rows.append([float(x) for x in line.split()])
+    if len(rows) == 0:
+        logger.warning('No horizon data written')
+        return False
+
+    # columns: 3:found 6:m_irr 11:chi 15:r_mean
+    found, m_irr, chi, r_mean = rows[-1][2], rows[-1][5], rows[-1][10], rows[-1][14]
+    analyze_status = True
+    if found < 0.5:
+        logger.warning('Apparent horizon not found')
+        return False
+    if abs(m_irr - 1.0) > 2.0e-2:
+        logger.warning('Irreducible mass {0:g} differs from 1 by more than 2%'
+                       .format(m_irr))
+        analyze_status = False
+    if abs(r_mean - 0.5) > 5.0e-2:
+        logger.warning('Mean coordinate radius {0:g} differs from 0.5 by more than '
+                       '10%'.format(r_mean))
+        analyze_status = False
+    if chi > 1.0e-2:
+        logger.warning('Dimensionless spin {0:g} of non-spinning puncture too large'
+                       .format(chi))
+        analyze_status = False
+    return analyze_status
@@ -425,6 +425,53 @@ def read_coarsened_binary(filename):
     return filedata
 
 
+def read_uniform_grid(filename):
+    """
+    Reads a ugrid file (data resampled to a uniform grid) from filename to dictionary.
+
+    args:
+      filename - string
+          filename of ugrid file to read
+
+    returns:
+      filedata - dict
+          dictionary with 'time', 'cycle', 'level', 'var_names', 'Nx1', 'Nx2',
+          'Nx3', 'x1min', ..., 'x3max' of the (sub-box of the) grid, and 'data',
+          a dict of arrays with shape [Nx3, Nx2, Nx1] for each variable
+    """
+
+    filedata = {}
+    header = {}
+    with open(filename, "rb") as fp:
+        code_header = fp.readline().split()
+        if len(code_header) < 1 or code_header[0] != b"Athena":
+            raise TypeError("unknown file format")
+        while True:
+            line = fp.readline().decode("utf-8").strip()
+            if line == "end of header":
+                break
+            if line.startswith("variables:"):
+                filedata["var_names"] = line.split()[1:]
+                continue
+            for item in line.split():
+                if "=" in item:
+                    key, val = item.split("=")
+                    header[key] = val
+        nx1, nx2, nx3 = int(header["nx1"]), int(header["nx2"]), int(header["nx3"])
+        raw = np.fromfile(fp, dtype=np.float32)
+
+    nvars = len(filedata["var_names"])
+    raw = raw[: nvars * nx1 * nx2 * nx3].reshape(nvars, nx3, nx2, nx1)
+    filedata["time"] = float(header["time"])
+    filedata["cycle"] = int(header["cycle"])
+    filedata["level"] = int(header["level"])
+    filedata["Nx1"], filedata["Nx2"], filedata["Nx3"] = nx1, nx2, nx3
+    for key in ["x1min", "x1max", "x2min", "x2max", "x3min", "x3max"]:
+        filedata[key] = float(header[key])
+    filedata["data"] = {v: raw[n] for n, v in enumerate(filedata["var_names"])}
+    return filedata
+
+
 def write_athdf(filename, fdata, varsize_bytes=4, locsize_bytes=8):
     """
     Writes an athdf (hdf5) file from a loaded python filedata object.